@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -9,6 +9,13 @@
 
 #include "region_defs.h"
 #include "tfm_plat_otp.h"
+#ifdef TFM_BL1_2_OTP_BURST_READ
+#include "crypto.h"
+
+#ifndef TFM_BL1_2_OTP_BURST_SIZE
+#define TFM_BL1_2_OTP_BURST_SIZE 0x400
+#endif /* TFM_BL1_2_OTP_BURST_SIZE */
+#endif /* TFM_BL1_2_OTP_BURST_READ */
 
 fih_int bl1_read_bl1_2_image(uint8_t *image)
 {
@@ -28,3 +35,61 @@ fih_int bl1_read_bl1_2_image(uint8_t *image)
 
     FIH_RET(fih_rc);
 }
+
+#ifdef TFM_BL1_2_OTP_BURST_READ
+fih_int bl1_read_bl1_2_image_and_hash(uint8_t *image, uint8_t *hash)
+{
+    fih_int fih_rc;
+    enum tfm_plat_err_t plat_err;
+    uint32_t bl1_2_len;
+    uint32_t offset;
+    uint32_t burst_len;
+
+    plat_err = tfm_plat_otp_read(PLAT_OTP_ID_BL1_2_IMAGE_LEN, sizeof(bl1_2_len),
+                                 (uint8_t *)&bl1_2_len);
+    fih_rc = fih_int_encode_zero_equality(plat_err);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(fih_rc);
+    }
+
+    if (bl1_2_len > BL1_2_CODE_SIZE) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    FIH_CALL(bl1_sha256_init, fih_rc);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(fih_rc);
+    }
+
+    /* Each burst is hashed while it is still hot, before the next is read */
+    for (offset = 0; offset < bl1_2_len; offset += burst_len) {
+        burst_len = bl1_2_len - offset;
+        if (burst_len > TFM_BL1_2_OTP_BURST_SIZE) {
+            burst_len = TFM_BL1_2_OTP_BURST_SIZE;
+        }
+
+        plat_err = tfm_plat_otp_read_burst(PLAT_OTP_ID_BL1_2_IMAGE, offset,
+                                           burst_len, image + offset);
+        fih_rc = fih_int_encode_zero_equality(plat_err);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            FIH_RET(fih_rc);
+        }
+
+        FIH_CALL(bl1_sha256_update, fih_rc, image + offset, burst_len);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            FIH_RET(fih_rc);
+        }
+    }
+
+    /* The hash covers the whole code region, as the one stored in OTP */
+    FIH_CALL(bl1_sha256_update, fih_rc, image + bl1_2_len,
+                                BL1_2_CODE_SIZE - bl1_2_len);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(fih_rc);
+    }
+
+    FIH_CALL(bl1_sha256_finish, fih_rc, hash);
+
+    FIH_RET(fih_rc);
+}
+#endif /* TFM_BL1_2_OTP_BURST_READ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -17,6 +17,13 @@ extern "C" {
 
 fih_int bl1_read_bl1_2_image(uint8_t *image);
 
+#ifdef TFM_BL1_2_OTP_BURST_READ
+/* Reads the BL1_2 image from OTP in bursts, and hashes each burst as soon as
+ * it is read. The hash covers BL1_2_CODE_SIZE bytes from the image address.
+ */
+fih_int bl1_read_bl1_2_image_and_hash(uint8_t *image, uint8_t *hash);
+#endif /* TFM_BL1_2_OTP_BURST_READ */
+
 #ifdef __cplusplus
 }
 #endif
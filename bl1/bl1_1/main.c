@@ -19,6 +19,7 @@
 #include "util.h"
 #include "image.h"
 #include "fih.h"
+#include "tfm_boot_timeline.h"
 
 /* Disable both semihosting code and argv usage for main */
 #if defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
@@ -63,11 +64,16 @@ fih_int validate_image_at_addr(const uint8_t *image)
     uint8_t stored_bl1_2_hash[BL1_2_HASH_SIZE];
     fih_int fih_rc = FIH_FAILURE;
 
+#ifdef TFM_BL1_2_OTP_BURST_READ
+    /* computed_bl1_2_hash was filled while the image was read */
+    (void)image;
+#else
     FIH_CALL(bl1_sha256_compute, fih_rc, image, BL1_2_CODE_SIZE,
                                          computed_bl1_2_hash);
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
         FIH_RET(FIH_FAILURE);
     }
+#endif /* TFM_BL1_2_OTP_BURST_READ */
 
     plat_err = tfm_plat_otp_read(PLAT_OTP_ID_BL1_2_IMAGE_HASH, BL1_2_HASH_SIZE,
                                  stored_bl1_2_hash);
@@ -91,6 +97,11 @@ int main(void)
     fih_int fih_rc = FIH_FAILURE;
     fih_int recovery_succeeded = FIH_FAILURE;
 
+    /* BL1_1 is the first boot stage, so it starts a new boot timeline */
+    BOOT_TIMELINE_RESET();
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_1,
+                         BOOT_TIMELINE_EVENT_STAGE_START, 0);
+
     fih_rc = fih_int_encode_zero_equality(boot_platform_init());
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
         FIH_PANIC;
@@ -110,6 +121,8 @@ int main(void)
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
         FIH_PANIC;
     }
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_1,
+                         BOOT_TIMELINE_EVENT_PLATFORM_INIT_DONE, 0);
 
 #ifdef TEST_BL1_1
     run_bl1_1_testsuite();
@@ -120,9 +133,17 @@ int main(void)
         FIH_PANIC;
     }
 
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_1,
+                         BOOT_TIMELINE_EVENT_IMAGE_LOAD_START, 0);
     do {
         /* Copy BL1_2 from OTP into SRAM*/
+#ifdef TFM_BL1_2_OTP_BURST_READ
+        /* The image is hashed while it is read */
+        FIH_CALL(bl1_read_bl1_2_image_and_hash, fih_rc,
+                 (uint8_t *)BL1_2_CODE_START, computed_bl1_2_hash);
+#else
         FIH_CALL(bl1_read_bl1_2_image, fih_rc, (uint8_t *)BL1_2_CODE_START);
+#endif /* TFM_BL1_2_OTP_BURST_READ */
         if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
             FIH_PANIC;
         }
@@ -138,6 +159,8 @@ int main(void)
             }
         }
     } while (fih_not_eq(fih_rc, FIH_SUCCESS));
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_1,
+                         BOOT_TIMELINE_EVENT_IMAGE_LOAD_DONE, 0);
 
     fih_rc = fih_int_encode_zero_equality(boot_platform_post_load(0));
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
@@ -148,6 +171,9 @@ int main(void)
     collect_boot_measurement();
 #endif /* TFM_MEASURED_BOOT_API */
 
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_1,
+                         BOOT_TIMELINE_EVENT_STAGE_END, 0);
+
     BL1_LOG("[INF] Jumping to BL1_2\r\n");
     /* Jump to BL1_2 */
     boot_platform_quit((struct boot_arm_vector_table *)BL1_2_CODE_START);
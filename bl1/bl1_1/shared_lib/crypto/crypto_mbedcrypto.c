@@ -62,6 +62,49 @@ int32_t bl1_derive_key(enum tfm_bl1_key_id_t input_key, const uint8_t *label,
     return rc;
 }
 
+static mbedtls_sha256_context sha256_ctx;
+
+fih_int bl1_sha256_init(void)
+{
+    int rc;
+
+    if (!mbedtls_is_initialised) {
+        mbedtls_init(mbedtls_memory_buf, sizeof(mbedtls_memory_buf));
+        mbedtls_is_initialised = 1;
+    }
+
+    mbedtls_sha256_init(&sha256_ctx);
+
+    rc = mbedtls_sha256_starts(&sha256_ctx, 0);
+    if (rc) {
+        mbedtls_sha256_free(&sha256_ctx);
+    }
+
+    FIH_RET(fih_int_encode_zero_equality(rc));
+}
+
+fih_int bl1_sha256_update(uint8_t *data, size_t data_length)
+{
+    int rc;
+
+    rc = mbedtls_sha256_update(&sha256_ctx, data, data_length);
+    if (rc) {
+        mbedtls_sha256_free(&sha256_ctx);
+    }
+
+    FIH_RET(fih_int_encode_zero_equality(rc));
+}
+
+fih_int bl1_sha256_finish(uint8_t *hash)
+{
+    int rc;
+
+    rc = mbedtls_sha256_finish(&sha256_ctx, hash);
+    mbedtls_sha256_free(&sha256_ctx);
+
+    FIH_RET(fih_int_encode_zero_equality(rc));
+}
+
 int32_t bl1_sha256_compute(const uint8_t *data,
                            size_t data_length,
                            uint8_t *hash)
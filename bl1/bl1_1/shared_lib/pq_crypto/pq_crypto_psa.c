@@ -5,12 +5,53 @@
  *
  */
 
+#include <stdbool.h>
+#include <string.h>
+
 #include "pq_crypto.h"
 #include "crypto.h"
 #include "mbedtls/lms.h"
 #include "otp.h"
 #include "psa/crypto.h"
 
+/*
+ * The LMS and LM-OTS hashes, thousands of them for a verification, are made
+ * of a few fields of a few bytes, each passed in a separate update. They are
+ * gathered in a buffer, so that a hash which fits in it is computed in a
+ * single call of the hash backend. With an accelerator, the cost of a
+ * hash that short is mostly the setup of each call rather than the data.
+ */
+#define PQ_HASH_BUF_SIZE    (64)
+
+static struct {
+    uint32_t buf[PQ_HASH_BUF_SIZE / sizeof(uint32_t)];
+    size_t len;
+    bool started;   /* The backend has been passed part of the input */
+} hash_buf;
+
+static psa_status_t hash_buf_flush(void)
+{
+    fih_int fih_rc;
+
+    if (!hash_buf.started) {
+        fih_rc = bl1_sha256_init();
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            return fih_int_decode(fih_rc);
+        }
+        hash_buf.started = true;
+    }
+
+    if (hash_buf.len != 0) {
+        fih_rc = bl1_sha256_update((uint8_t *)hash_buf.buf, hash_buf.len);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            return fih_int_decode(fih_rc);
+        }
+        hash_buf.len = 0;
+    }
+
+    return PSA_SUCCESS;
+}
+
 psa_status_t psa_hash_setup(
     psa_hash_operation_t *operation,
     psa_algorithm_t alg)
@@ -18,7 +59,10 @@ psa_status_t psa_hash_setup(
     (void)operation;
     (void)alg;
 
-    return fih_int_decode(bl1_sha256_init());
+    hash_buf.len = 0;
+    hash_buf.started = false;
+
+    return PSA_SUCCESS;
 }
 
 psa_status_t psa_hash_update(
@@ -26,8 +70,27 @@ psa_status_t psa_hash_update(
     const uint8_t *input,
     size_t input_length)
 {
+    psa_status_t status;
+
     (void)operation;
 
+    if (input_length <= sizeof(hash_buf.buf) - hash_buf.len) {
+        memcpy((uint8_t *)hash_buf.buf + hash_buf.len, input, input_length);
+        hash_buf.len += input_length;
+        return PSA_SUCCESS;
+    }
+
+    status = hash_buf_flush();
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    if (input_length <= sizeof(hash_buf.buf)) {
+        memcpy(hash_buf.buf, input, input_length);
+        hash_buf.len = input_length;
+        return PSA_SUCCESS;
+    }
+
     return fih_int_decode(bl1_sha256_update((unsigned char *)input, input_length));
 }
 
@@ -37,10 +100,23 @@ psa_status_t psa_hash_finish(
     size_t hash_size,
     size_t *hash_length)
 {
+    psa_status_t status;
+
     (void)operation;
     (void)hash_size;
 
     *hash_length = 32;
+
+    if (!hash_buf.started) {
+        return fih_int_decode(bl1_sha256_compute((uint8_t *)hash_buf.buf,
+                                                 hash_buf.len, hash));
+    }
+
+    status = hash_buf_flush();
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
     return fih_int_decode(bl1_sha256_finish(hash));
 }
 
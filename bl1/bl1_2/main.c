@@ -21,6 +21,9 @@
 #include "pq_crypto.h"
 #include "tfm_plat_nv_counters.h"
 #include "tfm_plat_otp.h"
+#include "tfm_boot_timeline.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 /* Disable both semihosting code and argv usage for main */
@@ -29,9 +32,25 @@ __asm("  .global __ARM_use_no_argv\n");
 #endif
 
 #if defined(TFM_MEASURED_BOOT_API) || !defined(TFM_BL1_PQ_CRYPTO)
-static uint8_t computed_bl2_hash[BL2_HASH_SIZE];
+#define BL1_2_COMPUTE_BL2_HASH
+
+/* The BL2 image is decrypted in chunks of this size, and each chunk is hashed
+ * as soon as it has been decrypted, so that the image doesn't need to be read
+ * once more to compute its hash. Must be a multiple of the AES block size.
+ */
+#ifndef BL1_2_DECRYPT_CHUNK_SIZE
+#define BL1_2_DECRYPT_CHUNK_SIZE 0x1000
 #endif
 
+#if (BL1_2_DECRYPT_CHUNK_SIZE % 16) != 0
+#error "BL1_2_DECRYPT_CHUNK_SIZE must be a multiple of the AES block size"
+#endif
+
+static uint8_t computed_bl2_hash[BL2_HASH_SIZE];
+/* Set when computed_bl2_hash holds the hash of the image at BL2_IMAGE_START */
+static bool computed_bl2_hash_is_valid;
+#endif /* TFM_MEASURED_BOOT_API || !TFM_BL1_PQ_CRYPTO */
+
 #ifdef TFM_MEASURED_BOOT_API
 #if (BL2_HASH_SIZE == 32)
 #define BL2_HASH_ALG  PSA_ALG_SHA_256
@@ -117,15 +136,20 @@ static fih_int is_image_signature_valid(struct bl1_2_image_t *img)
 {
     fih_int fih_rc = FIH_FAILURE;
 
-    /* Calculate the image hash for measured boot and/or a hash-locked image */
-#if defined(TFM_MEASURED_BOOT_API) || !defined(TFM_BL1_PQ_CRYPTO)
-    FIH_CALL(bl1_sha256_compute, fih_rc, (uint8_t *)&img->protected_values,
-                                         sizeof(img->protected_values),
-                                         computed_bl2_hash);
-    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
-        FIH_RET(fih_rc);
+    /* Calculate the image hash for measured boot and/or a hash-locked image,
+     * unless it has already been computed while the image was decrypted.
+     */
+#ifdef BL1_2_COMPUTE_BL2_HASH
+    if (!computed_bl2_hash_is_valid ||
+        img != (struct bl1_2_image_t *)BL2_IMAGE_START) {
+        FIH_CALL(bl1_sha256_compute, fih_rc, (uint8_t *)&img->protected_values,
+                                             sizeof(img->protected_values),
+                                             computed_bl2_hash);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            FIH_RET(fih_rc);
+        }
     }
-#endif
+#endif /* BL1_2_COMPUTE_BL2_HASH */
 
 #ifdef TFM_BL1_PQ_CRYPTO
     FIH_CALL(pq_crypto_verify, fih_rc, TFM_BL1_KEY_ROTPK_0,
@@ -171,6 +195,94 @@ fih_int validate_image_at_addr(struct bl1_2_image_t *image)
     FIH_RET(FIH_SUCCESS);
 }
 
+#ifdef BL1_2_COMPUTE_BL2_HASH
+/* Sets the CTR counter to the IV, incremented by a number of AES blocks */
+static void ctr_counter_advance(uint8_t *counter, const uint8_t *iv,
+                                uint32_t block_num)
+{
+    uint32_t sum;
+    size_t idx;
+
+    memcpy(counter, iv, CTR_IV_LEN);
+
+    for (idx = CTR_IV_LEN; idx > 0 && block_num != 0; idx--) {
+        sum = counter[idx - 1] + (block_num & 0xFF);
+        counter[idx - 1] = (uint8_t)sum;
+        block_num = (block_num >> 8) + (sum >> 8);
+    }
+}
+
+static int decrypt_and_hash_image(const uint8_t *key_buf,
+                                  struct bl1_2_image_t *image_to_decrypt,
+                                  struct bl1_2_image_t *image_after_decrypt)
+{
+    uint32_t counter[CTR_IV_LEN / sizeof(uint32_t)];
+    const uint8_t *ciphertext =
+        (const uint8_t *)&image_to_decrypt->protected_values.encrypted_data;
+    uint8_t *plaintext =
+        (uint8_t *)&image_after_decrypt->protected_values.encrypted_data;
+    const size_t total_len =
+        sizeof(image_after_decrypt->protected_values.encrypted_data);
+    size_t offset;
+    size_t chunk_len;
+    fih_int fih_rc;
+    int rc = 0;
+
+    fih_rc = bl1_sha256_init();
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        return 1;
+    }
+
+    /* The unencrypted part of the protected values has already been copied */
+    fih_rc = bl1_sha256_update((uint8_t *)&image_after_decrypt->protected_values,
+                               offsetof(struct bl1_2_image_t,
+                                        protected_values.encrypted_data) -
+                               offsetof(struct bl1_2_image_t, protected_values));
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        rc = 1;
+        goto out;
+    }
+
+    for (offset = 0; offset < total_len; offset += chunk_len) {
+        chunk_len = total_len - offset;
+        if (chunk_len > BL1_2_DECRYPT_CHUNK_SIZE) {
+            chunk_len = BL1_2_DECRYPT_CHUNK_SIZE;
+        }
+
+        ctr_counter_advance((uint8_t *)counter,
+                            image_after_decrypt->header.ctr_iv,
+                            offset / 16);
+
+        rc = bl1_aes_256_ctr_decrypt(TFM_BL1_KEY_USER, key_buf,
+                                     (uint8_t *)counter,
+                                     ciphertext + offset, chunk_len,
+                                     plaintext + offset);
+        if (rc) {
+            goto out;
+        }
+
+        fih_rc = bl1_sha256_update(plaintext + offset, chunk_len);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            rc = 1;
+            goto out;
+        }
+    }
+
+out:
+    /* Always finish the hash so that the hash engine is released */
+    fih_rc = bl1_sha256_finish(computed_bl2_hash);
+    if (rc == 0 && fih_eq(fih_rc, FIH_SUCCESS)) {
+        computed_bl2_hash_is_valid = true;
+    } else if (rc == 0) {
+        rc = 1;
+    }
+
+    memset(counter, 0, sizeof(counter));
+
+    return rc;
+}
+#endif /* BL1_2_COMPUTE_BL2_HASH */
+
 fih_int copy_and_decrypt_image(uint32_t image_id)
 {
     int rc;
@@ -180,6 +292,10 @@ fih_int copy_and_decrypt_image(uint32_t image_id)
     uint8_t key_buf[32];
     uint8_t label[] = "BL2_DECRYPTION_KEY";
 
+#ifdef BL1_2_COMPUTE_BL2_HASH
+    computed_bl2_hash_is_valid = false;
+#endif /* BL1_2_COMPUTE_BL2_HASH */
+
 #ifdef TFM_BL1_MEMORY_MAPPED_FLASH
     /* If we have memory-mapped flash, we can do the decrypt directly from the
      * flash and output to the SRAM. This is significantly faster if the AES
@@ -220,11 +336,15 @@ fih_int copy_and_decrypt_image(uint32_t image_id)
         FIH_RET(fih_int_encode_zero_equality(rc));
     }
 
+#ifdef BL1_2_COMPUTE_BL2_HASH
+    rc = decrypt_and_hash_image(key_buf, image_to_decrypt, image_after_decrypt);
+#else
     rc = bl1_aes_256_ctr_decrypt(TFM_BL1_KEY_USER, key_buf,
                                  image_after_decrypt->header.ctr_iv,
                                  (uint8_t *)&image_to_decrypt->protected_values.encrypted_data,
                                  sizeof(image_after_decrypt->protected_values.encrypted_data),
                                  (uint8_t *)&image_after_decrypt->protected_values.encrypted_data);
+#endif /* BL1_2_COMPUTE_BL2_HASH */
     if (rc) {
         FIH_RET(fih_int_encode_zero_equality(rc));
     }
@@ -268,6 +388,9 @@ int main(void)
     fih_int fih_rc = FIH_FAILURE;
     fih_int recovery_succeeded = FIH_FAILURE;
 
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_2,
+                         BOOT_TIMELINE_EVENT_STAGE_START, 0);
+
     fih_rc = fih_int_encode_zero_equality(boot_platform_init());
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
         FIH_PANIC;
@@ -278,6 +401,8 @@ int main(void)
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
         FIH_PANIC;
     }
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_2,
+                         BOOT_TIMELINE_EVENT_PLATFORM_INIT_DONE, 0);
 
 #ifdef TEST_BL1_2
     run_bl1_2_testsuite();
@@ -288,6 +413,8 @@ int main(void)
         FIH_PANIC;
     }
 
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_2,
+                         BOOT_TIMELINE_EVENT_IMAGE_LOAD_START, 0);
     do {
         BL1_LOG("[INF] Attempting to boot image 0\r\n");
         FIH_CALL(validate_image, fih_rc, 0);
@@ -304,6 +431,8 @@ int main(void)
             }
         }
     } while (fih_not_eq(fih_rc, FIH_SUCCESS));
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_2,
+                         BOOT_TIMELINE_EVENT_IMAGE_LOAD_DONE, 0);
 
     fih_rc = fih_int_encode_zero_equality(boot_platform_post_load(0));
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
@@ -317,6 +446,9 @@ int main(void)
     collect_boot_measurement((const struct bl1_2_image_t *)BL2_IMAGE_START);
 #endif /* TFM_MEASURED_BOOT_API */
 
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL1_2,
+                         BOOT_TIMELINE_EVENT_STAGE_END, 0);
+
     BL1_LOG("[INF] Jumping to BL2\r\n");
     boot_platform_quit((struct boot_arm_vector_table *)BL2_CODE_START);
 
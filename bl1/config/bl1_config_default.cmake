@@ -25,6 +25,7 @@ set(TFM_BL1_IMAGE_SECURITY_COUNTER_BL2  1           CACHE STRING    "Security co
 
 set(TFM_BL1_2_IN_OTP                    TRUE        CACHE BOOL      "Whether BL1_2 is stored in OTP")
 set(TFM_BL1_2_IN_FLASH                  FALSE       CACHE BOOL      "Whether BL1_2 is stored in FLASH")
+set(TFM_BL1_2_OTP_BURST_READ            OFF         CACHE BOOL      "Whether BL1_1 reads BL1_2 from OTP in bursts and hashes each burst as it is read. Requires tfm_plat_otp_read_burst()")
 
 set(BL1_HEADER_SIZE                     0x800       CACHE STRING    "BL1 Header size")
 set(BL1_TRAILER_SIZE                    0x000       CACHE STRING    "BL1 Trailer size")
@@ -31,6 +31,10 @@
 #include "uart_stdout.h"
 #include "tfm_plat_otp.h"
 #include "tfm_plat_provisioning.h"
+#include "tfm_boot_timeline.h"
+#ifdef MCUBOOT_VALIDATION_CACHE
+#include "boot_validation_cache.h"
+#endif /* MCUBOOT_VALIDATION_CACHE */
 #ifdef TEST_BL2
 #include "mcuboot_suites.h"
 #endif /* TEST_BL2 */
@@ -102,6 +106,13 @@ int main(void)
     enum tfm_plat_err_t plat_err;
     int32_t image_id;
 
+#if !defined(BL1) || !defined(PLATFORM_DEFAULT_BL1)
+    /* BL2 is the first boot stage which records the boot timeline */
+    BOOT_TIMELINE_RESET();
+#endif
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL2,
+                         BOOT_TIMELINE_EVENT_STAGE_START, 0);
+
     /* Initialise the mbedtls static memory allocator so that mbedtls allocates
      * memory from the provided static buffer instead of from the heap.
      */
@@ -164,6 +175,9 @@ int main(void)
     (void)run_mcuboot_testsuite();
 #endif /* TEST_BL2 */
 
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL2,
+                         BOOT_TIMELINE_EVENT_PLATFORM_INIT_DONE, 0);
+
     /* Images are loaded in reverse order so that the last image loaded is the
      * TF-M image, which means the response is filled correctly.
      */
@@ -177,6 +191,8 @@ int main(void)
             FIH_PANIC;
         }
 
+        BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL2,
+                             BOOT_TIMELINE_EVENT_IMAGE_LOAD_START, image_id);
         do {
             /* Primary goal to zeroize the 'rsp' is to avoid to accidentally load
              * the NS image in case of a fault injection attack. However, it is
@@ -195,6 +211,12 @@ int main(void)
                 }
             }
         } while FIH_NOT_EQ(fih_rc, FIH_SUCCESS);
+        BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL2,
+                             BOOT_TIMELINE_EVENT_IMAGE_LOAD_DONE, image_id);
+
+#ifdef MCUBOOT_VALIDATION_CACHE
+        boot_validation_cache_commit(image_id);
+#endif /* MCUBOOT_VALIDATION_CACHE */
 
         if (boot_platform_post_load(image_id)) {
             BOOT_LOG_ERR("Post-load step for image %d failed", image_id);
@@ -204,6 +226,8 @@ int main(void)
 
     BOOT_LOG_INF("Bootloader chainload address offset: 0x%x",
                  rsp.br_image_off);
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_BL2,
+                         BOOT_TIMELINE_EVENT_STAGE_END, 0);
     BOOT_LOG_INF("Jumping to the first image slot");
     do_boot(&rsp);
 
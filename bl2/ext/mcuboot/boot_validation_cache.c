@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Skips the validation of the images in the primary slots which have not
+ * changed since their last full validation, through the image access hooks of
+ * MCUboot.
+ *
+ * After a full validation, the image is summarised by a digest of its header,
+ * its TLVs, which hold the image hash and signature, samples of its code and
+ * the end of its trailer. The digest is kept by the platform in storage which
+ * only BL2 can access. On the next boots, the validation is skipped if the
+ * digest of the slot matches the record. Any update of the slot invalidates
+ * the record first, so the first boot after an update is fully validated.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "mcuboot_config/mcuboot_config.h"
+#include "mbedtls/sha256.h"
+#include "bootutil/bootutil.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil/image.h"
+#include "bootutil/fault_injection_hardening.h"
+#include "bootutil/boot_hooks.h"
+#include "flash_map_backend/flash_map_backend.h"
+#include "sysflash/sysflash.h"
+#include "boot_hal.h"
+#include "boot_validation_cache.h"
+
+/* Number and size of the samples of the image code in the digest */
+#ifndef BOOT_VALIDATION_CACHE_SAMPLES
+#define BOOT_VALIDATION_CACHE_SAMPLES       16
+#endif
+#define BOOT_VALIDATION_CACHE_SAMPLE_SIZE   64
+
+/* The end of the trailer holds the magic and the flags of the slot */
+#define BOOT_VALIDATION_CACHE_TRAILER_SIZE  (16 + 4 * MCUBOOT_BOOT_MAX_ALIGN)
+
+#define PRIMARY_SLOT                        0
+
+/* Images which were fully validated in this boot */
+static bool validated[MCUBOOT_IMAGE_NUMBER];
+
+static int digest_update(mbedtls_sha256_context *ctx,
+                         const struct flash_area *fap,
+                         uint32_t off, uint32_t len)
+{
+    uint8_t buf[BOOT_VALIDATION_CACHE_SAMPLE_SIZE];
+    uint32_t n;
+
+    while (len > 0) {
+        n = (len < sizeof(buf)) ? len : sizeof(buf);
+        if (flash_area_read(fap, off, buf, n) != 0) {
+            return -1;
+        }
+        if (mbedtls_sha256_update(ctx, buf, n) != 0) {
+            return -1;
+        }
+        off += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+static int slot_digest(const struct flash_area *fap,
+                       struct boot_validation_record *record)
+{
+    mbedtls_sha256_context ctx;
+    struct image_header hdr;
+    struct image_tlv_info info;
+    uint32_t body_end, tlv_end, off, i;
+    uint32_t trailer_off = flash_area_get_size(fap) -
+                           BOOT_VALIDATION_CACHE_TRAILER_SIZE;
+    int rc = -1;
+
+    if ((flash_area_read(fap, 0, &hdr, sizeof(hdr)) != 0) ||
+        (hdr.ih_magic != IMAGE_MAGIC)) {
+        return -1;
+    }
+
+    body_end = (uint32_t)hdr.ih_hdr_size + hdr.ih_img_size;
+    if ((body_end < hdr.ih_img_size) ||
+        (body_end + hdr.ih_protect_tlv_size + sizeof(info) > trailer_off) ||
+        (flash_area_read(fap, body_end + hdr.ih_protect_tlv_size, &info,
+                         sizeof(info)) != 0) ||
+        (info.it_magic != IMAGE_TLV_INFO_MAGIC)) {
+        return -1;
+    }
+    tlv_end = body_end + hdr.ih_protect_tlv_size + info.it_tlv_tot;
+    if (tlv_end > trailer_off) {
+        return -1;
+    }
+
+    mbedtls_sha256_init(&ctx);
+    if (mbedtls_sha256_starts(&ctx, 0) != 0) {
+        goto out;
+    }
+
+    /* Header, then the protected and unprotected TLVs */
+    if ((digest_update(&ctx, fap, 0, hdr.ih_hdr_size) != 0) ||
+        (digest_update(&ctx, fap, body_end, tlv_end - body_end) != 0)) {
+        goto out;
+    }
+
+    /* Samples spread evenly over the image code */
+    if (hdr.ih_img_size > BOOT_VALIDATION_CACHE_SAMPLE_SIZE) {
+        for (i = 0; i < BOOT_VALIDATION_CACHE_SAMPLES; i++) {
+            off = (uint32_t)(((uint64_t)(hdr.ih_img_size -
+                                         BOOT_VALIDATION_CACHE_SAMPLE_SIZE) *
+                              i) / (BOOT_VALIDATION_CACHE_SAMPLES - 1));
+            if (digest_update(&ctx, fap, hdr.ih_hdr_size + off,
+                              BOOT_VALIDATION_CACHE_SAMPLE_SIZE) != 0) {
+                goto out;
+            }
+        }
+    } else if (digest_update(&ctx, fap, hdr.ih_hdr_size,
+                             hdr.ih_img_size) != 0) {
+        goto out;
+    }
+
+    if ((digest_update(&ctx, fap, trailer_off,
+                       BOOT_VALIDATION_CACHE_TRAILER_SIZE) != 0) ||
+        (mbedtls_sha256_finish(&ctx, record->digest) != 0)) {
+        goto out;
+    }
+
+    record->magic = BOOT_VALIDATION_RECORD_MAGIC;
+    record->image_off = fap->fa_off;
+    record->image_size = tlv_end;
+    rc = 0;
+
+out:
+    mbedtls_sha256_free(&ctx);
+    return rc;
+}
+
+/* Compares the records without exiting early on the first difference */
+static bool record_equal(const struct boot_validation_record *a,
+                         const struct boot_validation_record *b)
+{
+    uint8_t diff = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(a->digest); i++) {
+        diff |= a->digest[i] ^ b->digest[i];
+    }
+
+    return (diff == 0) && (a->magic == b->magic) &&
+           (a->image_off == b->image_off) && (a->image_size == b->image_size);
+}
+
+fih_ret boot_image_check_hook(int img_index, int slot)
+{
+    struct boot_validation_record stored, current;
+    const struct flash_area *fap;
+    bool hit = false;
+
+    if ((slot != PRIMARY_SLOT) || (img_index < 0) ||
+        (img_index >= MCUBOOT_IMAGE_NUMBER)) {
+        FIH_RET(FIH_BOOT_HOOK_REGULAR);
+    }
+
+    validated[img_index] = false;
+
+    if ((boot_platform_read_validation_record(img_index, &stored) == 0) &&
+        (flash_area_open(FLASH_AREA_IMAGE_PRIMARY(img_index), &fap) == 0)) {
+        hit = (slot_digest(fap, &current) == 0) &&
+              record_equal(&stored, &current);
+        flash_area_close(fap);
+    }
+
+    if (hit) {
+        BOOT_LOG_INF("Image %d unchanged since its last validation",
+                     img_index);
+        FIH_RET(FIH_SUCCESS);
+    }
+
+    /* Record the image once MCUboot has validated it. */
+    validated[img_index] = true;
+    FIH_RET(FIH_BOOT_HOOK_REGULAR);
+}
+
+void boot_validation_cache_commit(uint32_t image_id)
+{
+    struct boot_validation_record record;
+    const struct flash_area *fap;
+    int rc;
+
+    if ((image_id >= MCUBOOT_IMAGE_NUMBER) || !validated[image_id]) {
+        return;
+    }
+    validated[image_id] = false;
+
+    if (flash_area_open(FLASH_AREA_IMAGE_PRIMARY(image_id), &fap) != 0) {
+        return;
+    }
+    rc = slot_digest(fap, &record);
+    flash_area_close(fap);
+
+    if ((rc != 0) ||
+        (boot_platform_write_validation_record(image_id, &record) != 0)) {
+        BOOT_LOG_WRN("Validation of image %d not recorded", image_id);
+    }
+}
+
+int boot_perform_update_hook(int img_index, struct image_header *img_head,
+                             const struct flash_area *area)
+{
+    (void)img_head;
+    (void)area;
+
+    /* The primary slot is about to change, the image is validated again. */
+    if ((img_index >= 0) && (img_index < MCUBOOT_IMAGE_NUMBER)) {
+        (void)boot_platform_write_validation_record(img_index, NULL);
+    }
+
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_read_image_header_hook(int img_index, int slot,
+                                struct image_header *img_head)
+{
+    (void)img_index;
+    (void)slot;
+    (void)img_head;
+
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_copy_region_post_hook(int img_index, const struct flash_area *area,
+                               size_t size)
+{
+    (void)img_index;
+    (void)area;
+    (void)size;
+
+    return 0;
+}
+
+int boot_read_swap_state_primary_slot_hook(int image_index,
+                                           struct boot_swap_state *state)
+{
+    (void)image_index;
+    (void)state;
+
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_img_install_stat_hook(int image_index, int slot,
+                               int *img_install_stat)
+{
+    (void)image_index;
+    (void)slot;
+    (void)img_install_stat;
+
+    return BOOT_HOOK_REGULAR;
+}
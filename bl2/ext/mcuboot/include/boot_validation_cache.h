@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __BOOT_VALIDATION_CACHE_H__
+#define __BOOT_VALIDATION_CACHE_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Records the image in the primary slot as validated, if MCUboot fully
+ *        validated it. Called once the image has been loaded successfully.
+ *
+ * \param[in] image_id  The ID of the image.
+ */
+void boot_validation_cache_commit(uint32_t image_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOT_VALIDATION_CACHE_H__ */
@@ -39,6 +39,9 @@ set(MCUBOOT_DIRECT_XIP_REVERT           ON          CACHE BOOL      "Enable the
 set(MCUBOOT_HW_ROLLBACK_PROT            ON          CACHE BOOL      "Enable security counter validation against non-volatile HW counters")
 set(MCUBOOT_ENC_IMAGES                  OFF         CACHE BOOL      "Enable encrypted image upgrade support")
 set(MCUBOOT_BOOTSTRAP                   OFF         CACHE BOOL      "Support initial state with empty primary slot and images installed from secondary slots")
+set(MCUBOOT_VALIDATION_CACHE            OFF         CACHE BOOL      "Skip the validation of the primary images unchanged since their last validation")
+set(MCUBOOT_FLASH_READ_AHEAD_SIZE       0           CACHE STRING    "Size in bytes of the buffer the small flash reads are served from, 0 to disable")
+set(MCUBOOT_ERASE_SKIP_BLANK            OFF         CACHE BOOL      "Skip the erase of the flash sectors which are already blank")
 set(MCUBOOT_ENCRYPT_RSA                 OFF         CACHE BOOL      "Use RSA for encrypted image upgrade support")
 set(MCUBOOT_FIH_PROFILE                 OFF         CACHE STRING    "Fault injection hardening profile [OFF, LOW, MEDIUM, HIGH]")
 set(MCUBOOT_USE_PSA_CRYPTO              OFF         CACHE BOOL      "Enable the cryptographic abstraction layer to use PSA Crypto APIs")
@@ -6,6 +6,7 @@
  */
 
 #include <stdbool.h>
+#include <string.h>
 #include "target.h"
 #include "flash_map/flash_map.h"
 #include "flash_map_backend/flash_map_backend.h"
@@ -43,6 +44,34 @@ static const uint32_t data_width_byte[] = {
     sizeof(uint32_t),
 };
 
+#if MCUBOOT_FLASH_READ_AHEAD_SIZE
+#if (MCUBOOT_FLASH_READ_AHEAD_SIZE % 4) != 0
+#error "MCUBOOT_FLASH_READ_AHEAD_SIZE must be a multiple of 4"
+#endif
+
+/*
+ * The reads smaller than the buffer, such as the chunks the images are hashed
+ * in and their TLVs, are served from the flash read in one burst from the
+ * first of them. On external flash, each read costs a command and an address
+ * phase, which take as long as the transfer of a small chunk.
+ */
+static struct {
+    uint8_t device_id;  /* Flash device of the data */
+    uint32_t addr;      /* Address of the data on the device */
+    uint32_t len;       /* Bytes of data, 0 when empty */
+    uint32_t data[MCUBOOT_FLASH_READ_AHEAD_SIZE / sizeof(uint32_t)];
+} read_ahead;
+
+#define READ_AHEAD_INVALIDATE() (read_ahead.len = 0)
+#else
+#define READ_AHEAD_INVALIDATE()
+#endif /* MCUBOOT_FLASH_READ_AHEAD_SIZE */
+
+#ifdef MCUBOOT_ERASE_SKIP_BLANK
+/* Size in bytes of the chunks the sectors are checked blank in */
+#define BLANK_CHECK_CHUNK_SIZE 64
+#endif /* MCUBOOT_ERASE_SKIP_BLANK */
+
 /*
  * Check the target address in the flash_area_xxx operation.
  */
@@ -106,12 +135,12 @@ void flash_area_close(const struct flash_area *area)
 }
 
 /*
- * Read/write/erase. Offset is relative from beginning of flash area.
- * `off` and `len` can be any alignment.
+ * Reads `len` bytes of flash memory at `off` to the buffer at `dst` from the
+ * flash driver. `off` and `len` can be any alignment.
  * Return 0 on success, other value on failure.
  */
-int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
-                    uint32_t len)
+static int flash_read(const struct flash_area *area, uint32_t off, void *dst,
+                      uint32_t len)
 {
     uint32_t remaining_len, read_length;
     uint32_t aligned_off;
@@ -218,6 +247,52 @@ int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
     }
 }
 
+/*
+ * Read/write/erase. Offset is relative from beginning of flash area.
+ * `off` and `len` can be any alignment.
+ * Return 0 on success, other value on failure.
+ */
+int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
+                    uint32_t len)
+{
+#if MCUBOOT_FLASH_READ_AHEAD_SIZE
+    uint32_t addr, fill_len;
+
+    if (!is_range_valid(area, off, len)) {
+        return -1;
+    }
+
+    if (len >= sizeof(read_ahead.data)) {
+        return flash_read(area, off, dst, len);
+    }
+
+    addr = area->fa_off + off;
+    if ((read_ahead.len == 0) || (read_ahead.device_id != area->fa_device_id) ||
+        (addr < read_ahead.addr) ||
+        (addr - read_ahead.addr > read_ahead.len - len)) {
+        /* Read ahead up to the end of the area */
+        fill_len = area->fa_size - off;
+        if (fill_len > sizeof(read_ahead.data)) {
+            fill_len = sizeof(read_ahead.data);
+        }
+
+        READ_AHEAD_INVALIDATE();
+        if (flash_read(area, off, read_ahead.data, fill_len) != 0) {
+            return -1;
+        }
+        read_ahead.device_id = area->fa_device_id;
+        read_ahead.addr = addr;
+        read_ahead.len = fill_len;
+    }
+
+    memcpy(dst, (uint8_t *)read_ahead.data + (addr - read_ahead.addr), len);
+
+    return 0;
+#else
+    return flash_read(area, off, dst, len);
+#endif /* MCUBOOT_FLASH_READ_AHEAD_SIZE */
+}
+
 /* Writes `len` bytes of flash memory at `off` from the buffer at `src`.
  * `off` and `len` can be any alignment.
  */
@@ -258,6 +333,8 @@ int flash_area_write(const struct flash_area *area, uint32_t off,
 
     BOOT_LOG_DBG("write area=%d, off=%#x, len=%#x", area->fa_id, off, len);
 
+    READ_AHEAD_INVALIDATE();
+
     /* Align the target address. The area->fa_off should already be aligned. */
     aligned_off = FLOOR_ALIGN(off, FLASH_PROGRAM_UNIT);
     add_padding_size = off - aligned_off;
@@ -270,7 +347,7 @@ int flash_area_write(const struct flash_area *area, uint32_t off,
 
     if (FLASH_PROGRAM_UNIT) {
         /* Read the bytes from aligned_off to off. */
-        if (flash_area_read(area, aligned_off, add_padding, add_padding_size)) {
+        if (flash_read(area, aligned_off, add_padding, add_padding_size)) {
             return -1;
         }
     }
@@ -283,8 +360,7 @@ int flash_area_write(const struct flash_area *area, uint32_t off,
     }
 
     /* Read the bytes from (off + len) to (off + aligned_len). */
-    if (flash_area_read(area, off + len, len_padding,
-                        len_padding_size)) {
+    if (flash_read(area, off + len, len_padding, len_padding_size)) {
         return -1;
     }
 
@@ -377,6 +453,37 @@ int flash_area_write(const struct flash_area *area, uint32_t off,
     return 0;
 }
 
+#ifdef MCUBOOT_ERASE_SKIP_BLANK
+/*
+ * Check whether the `len` bytes at `off` all have the erased value. A swap
+ * erases the scratch area, the trailers and the destination of each sector
+ * moved, many of which are still blank, and a sector erase takes tens of
+ * milliseconds on most flash where reading it back takes well under one.
+ */
+static bool is_blank(const struct flash_area *area, uint32_t off, uint32_t len,
+                     uint8_t erased_val)
+{
+    uint32_t buf[BLANK_CHECK_CHUNK_SIZE / sizeof(uint32_t)];
+    uint32_t chunk_len, i;
+
+    while (len > 0) {
+        chunk_len = len < sizeof(buf) ? len : sizeof(buf);
+        if (flash_read(area, off, buf, chunk_len) != 0) {
+            return false;
+        }
+        for (i = 0; i < chunk_len; i++) {
+            if (((uint8_t *)buf)[i] != erased_val) {
+                return false;
+            }
+        }
+        off += chunk_len;
+        len -= chunk_len;
+    }
+
+    return true;
+}
+#endif /* MCUBOOT_ERASE_SKIP_BLANK */
+
 int flash_area_erase(const struct flash_area *area, uint32_t off, uint32_t len)
 {
     ARM_FLASH_INFO *flash_info;
@@ -385,6 +492,8 @@ int flash_area_erase(const struct flash_area *area, uint32_t off, uint32_t len)
 
     BOOT_LOG_DBG("erase area=%d, off=%#x, len=%#x", area->fa_id, off, len);
 
+    READ_AHEAD_INVALIDATE();
+
     if (!is_range_valid(area, off, len)) {
         return -1;
     }
@@ -394,7 +503,14 @@ int flash_area_erase(const struct flash_area *area, uint32_t off, uint32_t len)
     if (flash_info->sector_info == NULL) {
         /* Uniform sector layout */
         while (deleted_len < len) {
+#ifdef MCUBOOT_ERASE_SKIP_BLANK
+            if (!is_blank(area, off, flash_info->sector_size,
+                          flash_info->erased_value)) {
+                rc = DRV_FLASH_AREA(area)->EraseSector(area->fa_off + off);
+            }
+#else
             rc = DRV_FLASH_AREA(area)->EraseSector(area->fa_off + off);
+#endif /* MCUBOOT_ERASE_SKIP_BLANK */
             if (rc != 0) {
                 break;
             }
@@ -117,6 +117,11 @@ if(TFM_PARTITION_PLATFORM)
             DESTINATION ${INSTALL_INTERFACE_INC_DIR})
 endif()
 
+if(TFM_PARTITION_NPU)
+    install(FILES       ${INTERFACE_INC_DIR}/tfm_npu_api.h
+            DESTINATION ${INSTALL_INTERFACE_INC_DIR})
+endif()
+
 if(TFM_PARTITION_FIRMWARE_UPDATE)
     install(FILES       ${INTERFACE_INC_DIR}/psa/update.h
                         ${CMAKE_BINARY_DIR}/generated/interface/include/psa/fwu_config.h
@@ -178,6 +183,11 @@ if(TFM_PARTITION_PLATFORM)
             DESTINATION ${INSTALL_INTERFACE_SRC_DIR})
 endif()
 
+if(TFM_PARTITION_NPU)
+    install(FILES       ${INTERFACE_SRC_DIR}/tfm_npu_api.c
+            DESTINATION ${INSTALL_INTERFACE_SRC_DIR})
+endif()
+
 ##################### Export image signing information #########################
 
 if(BL2 AND PLATFORM_DEFAULT_IMAGE_SIGNING)
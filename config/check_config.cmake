@@ -12,14 +12,19 @@ set (VALID_ISOLATION_LEVELS 1 2 3)
 tfm_invalid_config(NOT TFM_ISOLATION_LEVEL IN_LIST VALID_ISOLATION_LEVELS)
 tfm_invalid_config(TFM_ISOLATION_LEVEL EQUAL 3 AND NOT PLATFORM_HAS_ISOLATION_L3_SUPPORT)
 tfm_invalid_config(TFM_ISOLATION_LEVEL GREATER 1 AND PSA_FRAMEWORK_HAS_MM_IOVEC)
+tfm_invalid_config(TFM_CONFIG_FWU_MAX_BULK_WRITE_SIZE GREATER 0 AND NOT PSA_FRAMEWORK_HAS_MM_IOVEC)
+tfm_invalid_config(TFM_CONFIG_FWU_MAX_BULK_WRITE_SIZE GREATER 0 AND TFM_CONFIG_FWU_MAX_BULK_WRITE_SIZE LESS TFM_CONFIG_FWU_MAX_WRITE_SIZE)
 
 tfm_invalid_config(TFM_MULTI_CORE_TOPOLOGY AND TFM_NS_MANAGE_NSID)
 tfm_invalid_config(TFM_PLAT_SPECIFIC_MULTI_CORE_COMM AND NOT TFM_MULTI_CORE_TOPOLOGY)
 tfm_invalid_config(TFM_ISOLATION_LEVEL EQUAL 3 AND CONFIG_TFM_STACK_WATERMARKS)
+tfm_invalid_config(TFM_SP_LOG_DEFERRED AND NOT CONFIG_TFM_SPM_BACKEND_IPC)
+tfm_invalid_config(TFM_SPM_LOG_TOKENIZED AND C_COMPILER_ID:IAR)
 
 ########################## BL1 #################################################
 
 tfm_invalid_config(TFM_BL1_2_IN_OTP AND TFM_BL1_2_IN_FLASH)
+tfm_invalid_config(TFM_BL1_2_OTP_BURST_READ AND NOT TFM_BL1_2_IN_OTP)
 
 ########################## BL2 #################################################
 
@@ -28,6 +33,7 @@ tfm_invalid_config(BL2 AND (NOT MCUBOOT_UPGRADE_STRATEGY IN_LIST MCUBOOT_STRATEG
 
 # Maximum number of MCUBoot images supported by TF-M NV counters and ROTPKs
 tfm_invalid_config(MCUBOOT_IMAGE_NUMBER GREATER 9)
+tfm_invalid_config(MCUBOOT_VALIDATION_CACHE AND (MCUBOOT_UPGRADE_STRATEGY STREQUAL "DIRECT_XIP" OR MCUBOOT_UPGRADE_STRATEGY STREQUAL "RAM_LOAD"))
 
 tfm_invalid_config(MCUBOOT_SIGNATURE_TYPE STREQUAL "EC-P256" AND NOT MCUBOOT_USE_PSA_CRYPTO)
 tfm_invalid_config(MCUBOOT_SIGNATURE_TYPE STREQUAL "EC-P384" AND NOT MCUBOOT_USE_PSA_CRYPTO)
@@ -55,6 +61,7 @@ tfm_invalid_config(NOT TFM_CODE_SHARING STREQUAL "OFF" AND NOT C_COMPILER_ID:IAR
 ########################## Platform ############################################
 
 tfm_invalid_config(OTP_NV_COUNTERS_RAM_EMULATION AND NOT (PLATFORM_DEFAULT_OTP OR PLATFORM_DEFAULT_NV_COUNTERS))
+tfm_invalid_config(NV_COUNTERS_RAM_SHADOW AND NOT PLATFORM_DEFAULT_NV_COUNTERS)
 tfm_invalid_config(PLATFORM_DEFAULT_NV_COUNTERS AND  NOT PLATFORM_DEFAULT_OTP_WRITEABLE)
 tfm_invalid_config(TFM_DUMMY_PROVISIONING AND (PLATFORM_DEFAULT_OTP AND NOT PLATFORM_DEFAULT_OTP_WRITEABLE))
 tfm_invalid_config(TFM_NS_NV_COUNTER_AMOUNT GREATER 3)
@@ -71,6 +78,41 @@ tfm_invalid_config(TFM_PARTITION_FIRMWARE_UPDATE AND NOT MCUBOOT_DATA_SHARING)
 # PS only uses the platform partition when PS_ROLLBACK_PROTECTION is ON, but
 # the dependency in the manifest file means the dependency is unconditional
 tfm_invalid_config(TFM_PARTITION_PROTECTED_STORAGE AND NOT TFM_PARTITION_PLATFORM)
+# PS runs the ITS filesystem code in its own context, which is only safe when
+# the partitions can't preempt each other
+tfm_invalid_config(PS_ITS_DIRECT_ACCESS AND NOT CONFIG_TFM_SPM_BACKEND_SFN)
+tfm_invalid_config(PS_ITS_DIRECT_ACCESS AND NOT TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
+
+################### Internal Trusted Storage Partition #########################
+
+tfm_invalid_config(ITS_FLASH_IRQ_WAIT_ENABLED AND NOT PLATFORM_HAS_ITS_FLASH_IRQ_SUPPORT)
+tfm_invalid_config(ITS_FLASH_IRQ_WAIT_ENABLED AND NOT TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
+# The flash interrupt is a signal of the ITS partition, which PS can't wait for
+tfm_invalid_config(ITS_FLASH_IRQ_WAIT_ENABLED AND PS_ITS_DIRECT_ACCESS)
+
+########################## Crypto Partition ####################################
+
+tfm_invalid_config(CC312_IRQ_WAIT_ENABLED AND NOT PLATFORM_HAS_CC312_IRQ_SUPPORT)
+tfm_invalid_config(CC312_IRQ_WAIT_ENABLED AND NOT (CRYPTO_HW_ACCELERATOR AND TFM_PARTITION_CRYPTO))
+tfm_invalid_config(CC312_RSA_KEY_CACHE_ENTRIES GREATER 0 AND NOT (CRYPTO_HW_ACCELERATOR AND TFM_PARTITION_CRYPTO AND CRYPTO_HW_ACCELERATOR_TYPE STREQUAL "cc312"))
+tfm_invalid_config(CC3XX_ECDSA_PRECOMPUTE_SLOTS GREATER 0 AND NOT (CRYPTO_HW_ACCELERATOR AND TFM_PARTITION_CRYPTO AND CRYPTO_HW_ACCELERATOR_TYPE STREQUAL "cc312"))
+tfm_invalid_config(STM_CRYPTO_DMA_ENABLED AND NOT PLATFORM_HAS_STM_CRYPTO_DMA_SUPPORT)
+tfm_invalid_config(STM_CRYPTO_DMA_ENABLED AND NOT (CRYPTO_HW_ACCELERATOR AND TFM_PARTITION_CRYPTO))
+
+############################ NPU Partition #####################################
+
+tfm_invalid_config(TFM_PARTITION_NPU AND NOT PLATFORM_HAS_NPU_SUPPORT)
+tfm_invalid_config(TFM_PARTITION_NPU AND NOT TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
+# The tensors are given to the NPU in place and the partition waits for the
+# interrupt of the NPU, which needs a thread
+tfm_invalid_config(TFM_PARTITION_NPU AND NOT PSA_FRAMEWORK_HAS_MM_IOVEC)
+tfm_invalid_config(TFM_PARTITION_NPU AND NOT CONFIG_TFM_SPM_BACKEND_IPC)
+
+######################## Secure Timer Partition ################################
+
+tfm_invalid_config(TFM_PARTITION_SECURE_TIMER AND NOT PLATFORM_HAS_SECURE_TIMER_SUPPORT)
+# The partition waits for the interrupt of the timer, which needs a thread
+tfm_invalid_config(TFM_PARTITION_SECURE_TIMER AND NOT CONFIG_TFM_SPM_BACKEND_IPC)
 
 ########################## FIH #################################################
 
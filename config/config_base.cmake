@@ -64,6 +64,8 @@ set(TFM_ISOLATION_LEVEL                 1           CACHE STRING    "Isolation l
 set(PSA_FRAMEWORK_HAS_MM_IOVEC          OFF         CACHE BOOL      "Enable MM-IOVEC")
 set(TFM_PROFILE                         ""          CACHE STRING    "Profile to use")
 set(TFM_FIH_PROFILE                     OFF         CACHE STRING    "Fault injection hardening profile [OFF, LOW, MEDIUM, HIGH]")
+set(TFM_FIH_DELAY_RESEED_INTERVAL       0           CACHE STRING    "Number of FIH random delays generated by a PRNG between two seeds from the RNG. 0 takes every delay from the RNG")
+set(TFM_FIH_RUNTIME_DELAY               ON          CACHE BOOL      "Insert the random FIH delays of the HIGH profile on the SPM runtime paths (IPC, scheduling, interrupts). The boot is not affected")
 set(CONFIG_TFM_SPM_BACKEND              "SFN"       CACHE STRING    "The SPM backend [IPC, SFN]")
 
 # An NSPE client_id is provided by the NSPE OS via the SPM or directly by the SPM.
@@ -77,6 +79,11 @@ set(TFM_MANIFEST_LIST                   ${CMAKE_SOURCE_DIR}/tools/tfm_manifest_l
 set(TFM_CODE_SHARING                    OFF         CACHE PATH      "Enable code sharing between MCUboot and secure firmware")
 set(CONFIG_TFM_BOOT_STORE_MEASUREMENTS  ON          CACHE BOOL      "Store measurement values from all the boot stages. Used for initial attestation token.")
 set(CONFIG_TFM_BOOT_STORE_ENCODED_MEASUREMENTS  ON  CACHE BOOL      "Enable storing of encoded measurements in boot.")
+set(TFM_BOOT_TIMELINE                   OFF         CACHE BOOL      "Record timestamps of the boot stages and SPM init in the platform boot timeline region")
+set(TFM_SPM_TRACE                       OFF         CACHE BOOL      "Record timestamped SPM events into a RAM ring for performance analysis")
+set(TFM_SP_LOG_DEFERRED                 OFF         CACHE BOOL      "Buffer the Secure Partition log in SPM RAM and write it to the log device from the idle partition")
+set(TFM_SPM_LOG_TOKENIZED               OFF         CACHE BOOL      "Output the constant messages of the SPM log as tokens decoded by tools/tfm_log_token.py")
+set(TFM_MEMORY_REPORT                   OFF         CACHE BOOL      "Write the sections, padding and largest objects of tfm_s to tfm_s_memory.txt with tools/tfm_memory_report.py")
 
 set(TFM_PXN_ENABLE                      OFF         CACHE BOOL      "Use Privileged execute never (PXN)")
 
@@ -93,14 +100,23 @@ set(CONFIG_TFM_STACK_WATERMARKS         OFF         CACHE BOOL      "Whether to
 ############################ Platform ##########################################
 
 set(NUM_MAILBOX_QUEUE_SLOT              1           CACHE BOOL      "Number of mailbox queue slots")
+set(NUM_MAILBOX_PEERS                   1           CACHE STRING    "Number of NSPE cores served by the SPE mailbox, each with its own queue")
+set(MAILBOX_CACHE_LINE_SIZE             0           CACHE STRING    "Data cache line size of the cores sharing the mailbox queue, 0 if the cores are coherent")
+set(MAILBOX_EVENT_POLL_SPIN             0           CACHE STRING    "Number of idle WFE wake-ups SPE polls the mailbox for before waiting for its interrupt, on platforms whose cores share an event line. 0 to disable")
 set(TFM_PLAT_SPECIFIC_MULTI_CORE_COMM   OFF         CACHE BOOL      "Whether to use a platform specific inter-core communication instead of mailbox in dual-cpu topology")
 
 set(DEBUG_AUTHENTICATION                CHIP_DEFAULT CACHE STRING   "Debug authentication setting. [CHIP_DEFAULT, NONE, NS_ONLY, FULL")
 set(SECURE_UART1                        OFF         CACHE BOOL      "Enable secure UART1")
 
 set(CRYPTO_HW_ACCELERATOR               OFF         CACHE BOOL      "Whether to enable the crypto hardware accelerator on supported platforms")
+set(CC312_IRQ_WAIT_ENABLED              OFF         CACHE BOOL      "Whether the crypto partition waits for the interrupt of the CryptoCell-312 instead of polling it, on supported platforms")
+set(CC312_RSA_KEY_CACHE_ENTRIES         0           CACHE STRING    "Number of parsed RSA private keys of persistent keys the CryptoCell-312 PSA driver keeps across operations, 0 to disable")
+set(CC3XX_ECDSA_PRECOMPUTE_SLOTS        0           CACHE STRING    "Number of ECDSA ephemeral keys the crypto partition can compute ahead of the signatures with the cc312-rom driver, 0 to disable")
+set(STM_CRYPTO_DMA_ENABLED              OFF         CACHE BOOL      "Whether the STM accelerator feeds the CRYP and HASH peripherals with the GPDMA for large inputs, on supported platforms")
+set(STM_CRYPTO_DMA_THRESHOLD            256         CACHE STRING    "Input size in bytes from which the STM accelerator feeds the CRYP and HASH peripherals with the GPDMA")
 
 set(OTP_NV_COUNTERS_RAM_EMULATION       OFF         CACHE BOOL      "Enable OTP/NV_COUNTERS emulation in RAM. Has no effect on non-default implementations of the OTP and NV_COUNTERS")
+set(NV_COUNTERS_RAM_SHADOW              OFF         CACHE BOOL      "Keep an integrity checked RAM copy of the NV counters, written through on update. Has no effect on non-default implementations of the NV_COUNTERS")
 set(TFM_NS_NV_COUNTER_AMOUNT            0           CACHE STRING    "How many NS NV counters are enabled")
 
 set(PLATFORM_DEFAULT_BL1                ON          CACHE STRING    "Whether to use default BL1 or platform-specific one")
@@ -130,9 +146,11 @@ set(BL2_TRAILER_SIZE                    0x000       CACHE STRING    "BL2 Trailer
 set(TFM_PARTITION_PROTECTED_STORAGE     OFF         CACHE BOOL      "Enable Protected Storage partition")
 set(PS_ENCRYPTION                       ON          CACHE BOOL      "Enable encryption for Protected Storage partition")
 set(PS_CRYPTO_AEAD_ALG                  PSA_ALG_GCM CACHE STRING    "The AEAD algorithm to use for authenticated encryption in Protected Storage")
+set(PS_ITS_DIRECT_ACCESS                OFF         CACHE BOOL      "Call the ITS filesystem code directly from Protected Storage, without a message to the ITS partition. SFN model only")
 
 set(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE OFF      CACHE BOOL      "Enable Internal Trusted Storage partition")
 set(ITS_ENCRYPTION                   OFF         CACHE BOOL      "Enable authenticated encryption of ITS files using platform specific APIs")
+set(ITS_FLASH_IRQ_WAIT_ENABLED       OFF         CACHE BOOL      "Whether the ITS partition waits for the interrupt of the flash controller when the flash driver completes the operations asynchronously, on supported platforms")
 
 set(TFM_PARTITION_CRYPTO                OFF         CACHE BOOL      "Enable Crypto partition")
 set(CRYPTO_TFM_BUILTIN_KEYS_DRIVER      ON          CACHE BOOL      "Whether to allow crypto service to store builtin keys. Without this, ALL builtin keys must be stored in a platform-specific location")
@@ -145,6 +163,10 @@ set(PSA_INITIAL_ATTEST_MAX_TOKEN_SIZE   0x250       CACHE STRING    "The maximum
 
 set(TFM_PARTITION_PLATFORM              OFF         CACHE BOOL      "Enable Platform partition")
 
+set(TFM_PARTITION_NPU                   OFF         CACHE BOOL      "Enable NPU partition")
+
+set(TFM_PARTITION_SECURE_TIMER          OFF         CACHE BOOL      "Enable Secure Timer partition")
+
 ############################ Mbedcrypto configurations #########################
 
 set(MBEDCRYPTO_BUILD_TYPE               "${CMAKE_BUILD_TYPE}" CACHE STRING "Build type of Mbed Crypto library")
@@ -43,11 +43,46 @@
 #define CRYPTO_ENGINE_BUF_SIZE                 0x2080
 #endif
 
+/* Use the size class heap instead of the Mbed TLS buffer allocator */
+#ifndef CRYPTO_ENGINE_HEAP_POOLS
+#define CRYPTO_ENGINE_HEAP_POOLS               0
+#endif
+
+/* Number of size classes of the heap, doubling from 16 bytes */
+#ifndef CRYPTO_ENGINE_HEAP_BIN_NUM
+#define CRYPTO_ENGINE_HEAP_BIN_NUM             6
+#endif
+
 /* The max number of concurrent operations that can be active (allocated) at any time in Crypto */
 #ifndef CRYPTO_CONC_OPER_NUM
 #define CRYPTO_CONC_OPER_NUM                   8
 #endif
 
+/* The number of cipher operation contexts in a dedicated pool, 0 to use the shared contexts */
+#ifndef CRYPTO_CONC_CIPHER_OPER_NUM
+#define CRYPTO_CONC_CIPHER_OPER_NUM            0
+#endif
+
+/* The number of MAC operation contexts in a dedicated pool, 0 to use the shared contexts */
+#ifndef CRYPTO_CONC_MAC_OPER_NUM
+#define CRYPTO_CONC_MAC_OPER_NUM               0
+#endif
+
+/* The number of hash operation contexts in a dedicated pool, 0 to use the shared contexts */
+#ifndef CRYPTO_CONC_HASH_OPER_NUM
+#define CRYPTO_CONC_HASH_OPER_NUM              0
+#endif
+
+/* The number of key derivation operation contexts in a dedicated pool, 0 to use the shared contexts */
+#ifndef CRYPTO_CONC_KEY_DERIVATION_OPER_NUM
+#define CRYPTO_CONC_KEY_DERIVATION_OPER_NUM    0
+#endif
+
+/* The number of AEAD operation contexts in a dedicated pool, 0 to use the shared contexts */
+#ifndef CRYPTO_CONC_AEAD_OPER_NUM
+#define CRYPTO_CONC_AEAD_OPER_NUM              0
+#endif
+
 /* Enable PSA Crypto random number generator module */
 #ifndef CRYPTO_RNG_MODULE_ENABLED
 #define CRYPTO_RNG_MODULE_ENABLED              1
@@ -93,16 +128,66 @@
 #define CRYPTO_KEY_DERIVATION_MODULE_ENABLED   1
 #endif
 
+/* Evict the least recently used persistent key when the key slots are full */
+#ifndef CRYPTO_KEY_SLOT_LRU_ENABLED
+#define CRYPTO_KEY_SLOT_LRU_ENABLED            0
+#endif
+
+/* Number of keys of secure partitions shared with other secure partitions */
+#ifndef CRYPTO_KEY_SHARE_ENTRIES
+#define CRYPTO_KEY_SHARE_ENTRIES               0
+#endif
+
+/* Number of subkeys derived from the builtin keys cached by the builtin key loader */
+#ifndef CRYPTO_BUILTIN_KEY_CACHE_ENTRIES
+#define CRYPTO_BUILTIN_KEY_CACHE_ENTRIES       0
+#endif
+
+/* Load each builtin key on its first use instead of at initialisation */
+#ifndef CRYPTO_BUILTIN_KEY_LAZY_LOAD
+#define CRYPTO_BUILTIN_KEY_LAZY_LOAD           0
+#endif
+
+/* Enable the batch module, running several PSA Crypto operations per request */
+#ifndef CRYPTO_BATCH_MODULE_ENABLED
+#define CRYPTO_BATCH_MODULE_ENABLED            0
+#endif
+
+/* Number of function and algorithm pairs whose requests are timed, 0 to disable */
+#ifndef CRYPTO_STATS_ENTRIES
+#define CRYPTO_STATS_ENTRIES                   0
+#endif
+
 /* Default size of the internal scratch buffer used for PSA FF IOVec allocations */
 #ifndef CRYPTO_IOVEC_BUFFER_SIZE
 #define CRYPTO_IOVEC_BUFFER_SIZE               5120
 #endif
 
+/* Number of internal scratch buffers, each one used by one request at a time */
+#ifndef CRYPTO_IOVEC_BUFFER_NUM
+#define CRYPTO_IOVEC_BUFFER_NUM                1
+#endif
+
+/* Size of the stack buffer of the small one-shot requests, 0 to disable */
+#ifndef CRYPTO_ONESHOT_BUFFER_SIZE
+#define CRYPTO_ONESHOT_BUFFER_SIZE             0
+#endif
+
+/* Size of the pool of random bytes generated ahead of the requests, 0 to disable */
+#ifndef CRYPTO_RNG_POOL_SIZE
+#define CRYPTO_RNG_POOL_SIZE                   0
+#endif
+
 /* Use stored NV seed to provide entropy */
 #ifndef CRYPTO_NV_SEED
 #define CRYPTO_NV_SEED                         1
 #endif
 
+/* Use the precomputed fixed-base tables of the curve generators in ECC */
+#ifndef CRYPTO_ECP_FIXED_POINT_OPTIM
+#define CRYPTO_ECP_FIXED_POINT_OPTIM           1
+#endif
+
 /*
  * Only enable multi-part operations in Hash, MAC, AEAD and symmetric ciphers,
  * to optimize memory footprint in resource-constrained devices.
@@ -128,6 +213,36 @@
 #define FWU_STACK_SIZE                         0x600
 #endif
 
+/* Hash the image from flash when it is queried, and only check it at reboot */
+#ifndef FWU_HASH_ON_WRITE
+#define FWU_HASH_ON_WRITE                      0
+#endif
+
+/* Erase the whole staging area when an update starts */
+#ifndef FWU_ERASE_AHEAD_SIZE
+#define FWU_ERASE_AHEAD_SIZE                   0
+#endif
+
+/* Only accept full images, not delta patches */
+#ifndef FWU_DELTA_UPDATE
+#define FWU_DELTA_UPDATE                       0
+#endif
+
+/* Size of the buffer of the image rebuilt from a delta patch */
+#ifndef FWU_DELTA_BUF_SIZE
+#define FWU_DELTA_BUF_SIZE                     256
+#endif
+
+/* Only accept uncompressed images */
+#ifndef FWU_LZ4_UPDATE
+#define FWU_LZ4_UPDATE                         0
+#endif
+
+/* Size of the buffer of the image decompressed from an LZ4 image */
+#ifndef FWU_LZ4_BUF_SIZE
+#define FWU_LZ4_BUF_SIZE                       256
+#endif
+
 /* Attest Partition Configs */
 
 /* Include optional claims in initial attestation token */
@@ -140,6 +255,21 @@
 #define ATTEST_INCLUDE_COSE_KEY_ID             0
 #endif
 
+/* Size of the buffer holding the pre-encoded constant claims, 0 to disable */
+#ifndef ATTEST_TOKEN_TEMPLATE_SIZE
+#define ATTEST_TOKEN_TEMPLATE_SIZE             0
+#endif
+
+/* Enable requests creating one token per challenge for several challenges */
+#ifndef ATTEST_GET_TOKENS_ENABLED
+#define ATTEST_GET_TOKENS_ENABLED              0
+#endif
+
+/* Compute the tag of the symmetric tokens with a single MAC request */
+#ifndef ATTEST_MAC0_ONESHOT_ENABLED
+#define ATTEST_MAC0_ONESHOT_ENABLED            0
+#endif
+
 /* The stack size of the Initial Attestation Secure Partition */
 #ifndef ATTEST_STACK_SIZE
 #define ATTEST_STACK_SIZE                      0x700
@@ -169,6 +299,66 @@
 #define ITS_VALIDATE_METADATA_FROM_FLASH       1
 #endif
 
+/* Keep an index of file IDs in RAM to avoid scanning file metadata in flash */
+#ifndef ITS_RAM_FILE_INDEX
+#define ITS_RAM_FILE_INDEX                     0
+#endif
+
+/* Number of metadata delta records logged before the metadata blocks are swapped (0 disables the log) */
+#ifndef ITS_METADATA_LOG_RECORDS
+#define ITS_METADATA_LOG_RECORDS               0
+#endif
+
+/* The maximum size of the files stored in their metadata, 0 to disable */
+#ifndef ITS_INLINE_FILE_SIZE
+#define ITS_INLINE_FILE_SIZE                   0
+#endif
+
+/* Number of client shards of the ITS filesystem, each with its own flash area */
+#ifndef ITS_NUM_SHARDS
+#define ITS_NUM_SHARDS                         0
+#endif
+
+/* Keep the ITS area in a RAM cache written back to flash on a policy */
+#ifndef ITS_FLASH_CACHE
+#define ITS_FLASH_CACHE                        0
+#endif
+
+/* Number of block updates which trigger a write-back of the cache, 0 for none */
+#ifndef ITS_FLASH_CACHE_FLUSH_UPDATES
+#define ITS_FLASH_CACHE_FLUSH_UPDATES          16
+#endif
+
+/* Only mark deleted files and reclaim their space later, in bounded steps */
+#ifndef ITS_DEFERRED_COMPACTION
+#define ITS_DEFERRED_COMPACTION                0
+#endif
+
+/* Enable the multi-asset transaction API */
+#ifndef ITS_TRANSACTIONS
+#define ITS_TRANSACTIONS                       0
+#endif
+
+/* Count the erases of each data block and level the wear of the data blocks */
+#ifndef ITS_WEAR_LEVELLING
+#define ITS_WEAR_LEVELLING                     0
+#endif
+
+/* The erase count difference which triggers the relocation of a static block */
+#ifndef ITS_WEAR_LEVELLING_THRESHOLD
+#define ITS_WEAR_LEVELLING_THRESHOLD           64
+#endif
+
+/* Count the flash operations issued by the filesystem */
+#ifndef ITS_FLASH_STATS
+#define ITS_FLASH_STATS                        0
+#endif
+
+/* Get or set several assets in one call */
+#ifndef ITS_MULTI_ASSET
+#define ITS_MULTI_ASSET                        0
+#endif
+
 /* The maximum asset size to be stored in the Internal Trusted Storage */
 #ifndef ITS_MAX_ASSET_SIZE
 #define ITS_MAX_ASSET_SIZE                     512
@@ -202,6 +392,11 @@
 #define TFM_ITS_ENC_NONCE_LENGTH               12
 #endif
 
+/* Size of the chunks ITS files are encrypted in, 0 to encrypt them in one go */
+#ifndef ITS_ENCRYPTION_CHUNK_SIZE
+#define ITS_ENCRYPTION_CHUNK_SIZE              0
+#endif
+
 /* PS Partition Configs */
 
 /* Create flash FS if it doesn't exist for Protected Storage partition */
@@ -219,6 +414,11 @@
 #define PS_ROLLBACK_PROTECTION                 1
 #endif
 
+/* Number of object table saves per increment of the PS NV counters */
+#ifndef PS_ROLLBACK_EPOCH_SAVES
+#define PS_ROLLBACK_EPOCH_SAVES                1
+#endif
+
 /* Validate filesystem metadata every time it is read from flash */
 #ifndef PS_VALIDATE_METADATA_FROM_FLASH
 #define PS_VALIDATE_METADATA_FROM_FLASH        1
@@ -234,6 +434,46 @@
 #define PS_NUM_ASSETS                          10
 #endif
 
+/* Index the object table in RAM to find objects and free entries faster */
+#ifndef PS_OBJ_TABLE_INDEX
+#define PS_OBJ_TABLE_INDEX                     0
+#endif
+
+/* Number of object table entries per separately digested segment, 0 for none */
+#ifndef PS_OBJ_TABLE_SEGMENT_ENTRIES
+#define PS_OBJ_TABLE_SEGMENT_ENTRIES           0
+#endif
+
+/* Size of the chunks PS objects are encrypted in, 0 to encrypt them in one go */
+#ifndef PS_ENCRYPTION_CHUNK_SIZE
+#define PS_ENCRYPTION_CHUNK_SIZE               0
+#endif
+
+/* Number of decrypted objects cached in RAM for reads, 0 to disable the cache */
+#ifndef PS_OBJ_CACHE_ENTRIES
+#define PS_OBJ_CACHE_ENTRIES                   0
+#endif
+
+/* The maximum size of the objects kept in the read cache */
+#ifndef PS_OBJ_CACHE_MAX_SIZE
+#define PS_OBJ_CACHE_MAX_SIZE                  256
+#endif
+
+/* The maximum size of the objects packed in a shared container, 0 to disable */
+#ifndef PS_PACKED_OBJECT_MAX_SIZE
+#define PS_PACKED_OBJECT_MAX_SIZE              0
+#endif
+
+/* The maximum number of objects in the container of the packed objects */
+#ifndef PS_PACKED_OBJECT_NUM
+#define PS_PACKED_OBJECT_NUM                   32
+#endif
+
+/* Number of derived PS keys kept for reuse, 0 to derive a key for each use */
+#ifndef PS_CRYPTO_KEY_CACHE_ENTRIES
+#define PS_CRYPTO_KEY_CACHE_ENTRIES            0
+#endif
+
 /* The stack size of the Protected Storage Secure Partition */
 #ifndef PS_STACK_SIZE
 #define PS_STACK_SIZE                          0x700
@@ -246,6 +486,30 @@
 #define NS_AGENT_MAILBOX_STACK_SIZE            0x800
 #endif
 
+/* NPU Partition Configs */
+
+/* Size of the secure arena of the command stream, weights and scratch */
+#ifndef NPU_ARENA_SIZE
+#define NPU_ARENA_SIZE                         0x8000
+#endif
+
+/* The stack size of the NPU Secure Partition */
+#ifndef NPU_STACK_SIZE
+#define NPU_STACK_SIZE                         0x600
+#endif
+
+/* Secure Timer Partition Configs */
+
+/* Number of timers of all the Secure Partitions */
+#ifndef SECURE_TIMER_NUM
+#define SECURE_TIMER_NUM                       16
+#endif
+
+/* The stack size of the Secure Timer Secure Partition */
+#ifndef SECURE_TIMER_STACK_SIZE
+#define SECURE_TIMER_STACK_SIZE                0x400
+#endif
+
 /* SPM Configs */
 
 #ifdef CONFIG_TFM_CONNECTION_POOL_ENABLE
@@ -255,16 +519,121 @@
 #endif
 #endif
 
+/* Stateless calls of the SFN backend take a new connection from the stack each time */
+#ifndef CONFIG_TFM_SFN_CONN_CACHE_NUM
+#define CONFIG_TFM_SFN_CONN_CACHE_NUM           0
+#endif
+
+/* Disable dedicated connection slabs for services setting connection_pool_size */
+#ifndef CONFIG_TFM_CONNECTION_SLABS
+#define CONFIG_TFM_CONNECTION_SLABS             0
+#endif
+
 /* Disable the doorbell APIs */
 #ifndef CONFIG_TFM_DOORBELL_API
 #define CONFIG_TFM_DOORBELL_API                 0
 #endif
 
+/* psa_read() and psa_write() always copy with the CPU */
+#ifndef CONFIG_TFM_SPM_DMA_COPY_THRESHOLD
+#define CONFIG_TFM_SPM_DMA_COPY_THRESHOLD       0
+#endif
+
+/* Disable the data cache maintenance APIs of partitions */
+#ifndef CONFIG_TFM_CACHE_MAINTENANCE_API
+#define CONFIG_TFM_CACHE_MAINTENANCE_API        0
+#endif
+
 /* Do not run the scheduler after handling a secure interrupt if the NSPE was pre-empted */
 #ifndef CONFIG_TFM_SCHEDULE_WHEN_NS_INTERRUPTED
 #define CONFIG_TFM_SCHEDULE_WHEN_NS_INTERRUPTED 0
 #endif
 
+/* Disable priority inheritance of partitions from the clients they serve */
+#ifndef CONFIG_TFM_PRIORITY_INHERITANCE
+#define CONFIG_TFM_PRIORITY_INHERITANCE         0
+#endif
+
+/* Every partition thread has a dedicated stack */
+#ifndef CONFIG_TFM_SPM_SHARED_STACKS
+#define CONFIG_TFM_SPM_SHARED_STACKS            0
+#endif
+
+/* Always pick the first runnable thread among the ones with the same priority */
+#ifndef CONFIG_TFM_THRD_ROUND_ROBIN
+#define CONFIG_TFM_THRD_ROUND_ROBIN             0
+#endif
+
+/* The idle partition executes WFI without asking the platform for a low power state */
+#ifndef CONFIG_TFM_IDLE_LOW_POWER
+#define CONFIG_TFM_IDLE_LOW_POWER               0
+#endif
+
+/* Disable the runtime statistics of partitions and services */
+#ifndef CONFIG_TFM_PARTITION_STATS
+#define CONFIG_TFM_PARTITION_STATS              0
+#endif
+
+/* Do not count PMU events per partition in the runtime statistics */
+#ifndef CONFIG_TFM_PARTITION_PMU
+#define CONFIG_TFM_PARTITION_PMU                0
+#endif
+
+/* Do not check the replies of the services against their latency budgets */
+#ifndef CONFIG_TFM_SERVICE_LATENCY_BUDGET
+#define CONFIG_TFM_SERVICE_LATENCY_BUDGET       0
+#endif
+
+/* Do not record the latency breakdown of sampled calls */
+#ifndef CONFIG_TFM_CALL_LATENCY
+#define CONFIG_TFM_CALL_LATENCY                 0
+#endif
+
+/* Sample one call in 16 to each service for the latency breakdown */
+#ifndef CONFIG_TFM_CALL_LATENCY_SAMPLE_SHIFT
+#define CONFIG_TFM_CALL_LATENCY_SAMPLE_SHIFT    4
+#endif
+
+/* PMU events counted per partition: L1 D-cache refills */
+#ifndef CONFIG_TFM_PMU_EVENT_0
+#define CONFIG_TFM_PMU_EVENT_0                  0x0003
+#endif
+
+/* L1 I-cache refills */
+#ifndef CONFIG_TFM_PMU_EVENT_1
+#define CONFIG_TFM_PMU_EVENT_1                  0x0001
+#endif
+
+/* Backend stall cycles */
+#ifndef CONFIG_TFM_PMU_EVENT_2
+#define CONFIG_TFM_PMU_EVENT_2                  0x0024
+#endif
+
+/* Mispredicted branches */
+#ifndef CONFIG_TFM_PMU_EVENT_3
+#define CONFIG_TFM_PMU_EVENT_3                  0x0010
+#endif
+
+/* Run the SPM IPC hot path from flash, not from the platform code RAM */
+#ifndef CONFIG_TFM_SPM_RAM_CODE
+#define CONFIG_TFM_SPM_RAM_CODE                 0
+#endif
+
+/* Run all the PSA APIs in thread mode SPM */
+#ifndef CONFIG_TFM_SVC_HANDLER_MODE_API
+#define CONFIG_TFM_SVC_HANDLER_MODE_API         0
+#endif
+
+/* Longest psa_read() and psa_write() copy run in the SVC handler */
+#ifndef CONFIG_TFM_SVC_HANDLER_MODE_COPY_MAX
+#define CONFIG_TFM_SVC_HANDLER_MODE_COPY_MAX    64
+#endif
+
+/* Longest first input vector of psa_call() passed inline, 0 to disable */
+#ifndef CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX
+#define CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX    0
+#endif
+
 /* Mask Non-Secure interrupts when executing in secure state. */
 #ifndef CONFIG_TFM_SECURE_THREAD_MASK_NS_INTERRUPT
 #define CONFIG_TFM_SECURE_THREAD_MASK_NS_INTERRUPT 0
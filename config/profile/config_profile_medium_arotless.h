@@ -100,6 +100,11 @@
 #define CRYPTO_NV_SEED                         1
 #endif
 
+/* Use the precomputed fixed-base tables of the curve generators in ECC */
+#ifndef CRYPTO_ECP_FIXED_POINT_OPTIM
+#define CRYPTO_ECP_FIXED_POINT_OPTIM           0
+#endif
+
 /*
  * Only enable multi-part operations in Hash, MAC, AEAD and symmetric ciphers,
  * to optimize memory footprint in resource-constrained devices.
@@ -14,6 +14,7 @@ endif()
 set(TFM_PARTITION_FIRMWARE_UPDATE         OFF         CACHE BOOL      "Enable firmware update partition")
 set(TFM_FWU_BOOTLOADER_LIB                "mcuboot"   CACHE STRING    "Bootloader configure file for Firmware Update partition")
 set(TFM_CONFIG_FWU_MAX_WRITE_SIZE         1024        CACHE STRING    "The maximum permitted size for block in psa_fwu_write, in bytes.")
+set(TFM_CONFIG_FWU_MAX_BULK_WRITE_SIZE    0           CACHE STRING    "The maximum permitted size for block in psa_fwu_write when the block is mapped with MM-IOVEC, in bytes. 0 to use TFM_CONFIG_FWU_MAX_WRITE_SIZE.")
 set(TFM_CONFIG_FWU_MAX_MANIFEST_SIZE      0           CACHE STRING    "The maximum permitted size for manifest in psa_fwu_start(), in bytes.")
 set(FWU_DEVICE_CONFIG_FILE                ""          CACHE STRING    "The device configuration file for Firmware Update partition")
 if (DEFINED MCUBOOT_UPGRADE_STRATEGY)
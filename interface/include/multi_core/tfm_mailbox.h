@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2022-2024 Cypress Semiconductor Corporation (an Infineon company)
  * or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
  *
@@ -35,6 +35,14 @@ extern "C" {
 #define MAILBOX_PSA_CALL                    (0x4)
 #define MAILBOX_PSA_CLOSE                   (0x5)
 
+/*
+ * Priority classes of mailbox messages. SPE mailbox dispatches the pending
+ * messages of a higher class first and notifies their replies at once.
+ */
+#define MAILBOX_PRIO_NORMAL                 (0)
+#define MAILBOX_PRIO_HIGH                   (1)
+#define MAILBOX_PRIO_NUM                    (2)
+
 /* Return code of mailbox APIs */
 #define MAILBOX_SUCCESS                     (0)
 #define MAILBOX_QUEUE_FULL                  (INT32_MIN + 1)
@@ -88,6 +96,7 @@ struct mailbox_msg_t {
                                             * non-secure task when NSPE OS
                                             * enforces non-secure task isolation
                                             */
+    uint32_t                    priority;  /* Priority class of the call */
 };
 
 /*
@@ -98,41 +107,86 @@ struct mailbox_reply_t {
     int32_t    return_val;
 };
 
+/*
+ * Size of an object shared by NSPE and SPE, rounded up to whole cache lines
+ * when the cores are not coherent, so that each core cleans and invalidates
+ * only the lines of the objects it accesses.
+ */
+#if MAILBOX_CACHE_LINE_SIZE > 0
+#define MAILBOX_CACHE_LINES_SIZE(size)                          \
+            (((size) + MAILBOX_CACHE_LINE_SIZE - 1) &           \
+             ~(size_t)(MAILBOX_CACHE_LINE_SIZE - 1))
+#else
+#define MAILBOX_CACHE_LINES_SIZE(size)      (size)
+#endif
+
 /*
  * A single slot structure in NSPE mailbox queue.
  * This structure is an ABI between SPE and NSPE mailbox instances.
  * So, it must not include data that are not used by SPE like information about NS threads
  * or that depends on NSPE build settings.
- * TODO: It's good to align each slot structure according to the cache row,
- * so it will be easier to clean and invalidate slot during transfer between cores.
+ * The message, written by NSPE, and the reply, written by SPE, sit in lines
+ * of their own, so that the cores never write to the same cache line.
  */
 struct mailbox_slot_t {
-    struct mailbox_msg_t   msg;
-    struct mailbox_reply_t reply;
+    union {
+        struct mailbox_msg_t   msg;
+        uint8_t                msg_lines[MAILBOX_CACHE_LINES_SIZE(
+                                             sizeof(struct mailbox_msg_t))];
+    };
+    union {
+        struct mailbox_reply_t reply;
+        uint8_t                reply_lines[MAILBOX_CACHE_LINES_SIZE(
+                                             sizeof(struct mailbox_reply_t))];
+    };
 };
 
 typedef uint32_t   mailbox_queue_status_t;
 
+/*
+ * Maximum number of slots NSPE can allocate, limited by the number of bits in
+ * mailbox_queue_status_t. It is independent of NUM_MAILBOX_QUEUE_SLOT, which
+ * only sets how many requests SPE processes at the same time.
+ */
+#define MAILBOX_MAX_NS_SLOT_COUNT   (sizeof(mailbox_queue_status_t) * 8)
+
 /*
  * NSPE mailbox status shared between TF-M and mailbox client.
  * This structure is separated from slots to allow flexible allocation of slots.
  * So, it's safe to change number of slots on non-secure side without rebuild of TF-M.
- * TODO: It's good to align structure according to the cache row,
- * so it will be easier to clean and invalidate slot during transfer between cores.
+ * Each status word sits in lines of its own.
  */
 struct mailbox_status_t {
-    mailbox_queue_status_t   pend_slots;        /* Bitmask of slots pending
+    union {
+        mailbox_queue_status_t pend_slots;      /* Bitmask of slots pending
                                                  * for SPE handling
                                                  */
-    mailbox_queue_status_t   replied_slots;     /* Bitmask of active slots
+        uint8_t                pend_lines[MAILBOX_CACHE_LINES_SIZE(
+                                             sizeof(mailbox_queue_status_t))];
+    };
+    union {
+        mailbox_queue_status_t replied_slots;   /* Bitmask of active slots
                                                  * containing PSA client call
                                                  * return result
                                                  */
+        uint8_t                replied_lines[MAILBOX_CACHE_LINES_SIZE(
+                                             sizeof(mailbox_queue_status_t))];
+    };
+    union {
+        uint32_t               spe_polling;     /* Set by SPE while it polls
+                                                 * for requests with WFE
+                                                 */
+        uint8_t                polling_lines[MAILBOX_CACHE_LINES_SIZE(
+                                             sizeof(uint32_t))];
+    };
 };
 
 /* Data used to send information to mailbox partition about mailbox queue allocated by non-secure image */
 struct mailbox_init_t {
-    /* Shared data with fixed size */
+    /*
+     * Shared data with fixed size. The status and the slots start on a cache
+     * line boundary if MAILBOX_CACHE_LINE_SIZE is not 0.
+     */
     struct mailbox_status_t *status;
 
     /* Number of slots allocated by NS. */
@@ -140,6 +194,13 @@ struct mailbox_init_t {
 
     /* Pointer to struct mailbox_slot_t[slot_count] allocated by NS */
     struct mailbox_slot_t *slots;
+
+    /*
+     * Optional buffer pool allocated by NS for client call payloads.
+     * SPE validates it once during initialization. The size is 0 if unused.
+     */
+    void *shm_base;
+    uint32_t shm_size;
 };
 
 #ifdef __cplusplus
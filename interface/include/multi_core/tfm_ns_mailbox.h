@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2024 Cypress Semiconductor Corporation (an Infineon company)
  * or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
  *
@@ -17,6 +17,34 @@
 
 #include "tfm_mailbox.h"
 
+/*
+ * Empty slots are claimed and released with exclusive accesses on the empty
+ * status word, without taking the NS mailbox spin lock, on architectures
+ * supporting them. The others take the spin lock.
+ */
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__) || \
+    defined(__ARM_ARCH_7A__)
+#define NS_MAILBOX_SLOT_LOCK_FREE           1
+#include "cmsis_compiler.h"
+#else
+#define NS_MAILBOX_SLOT_LOCK_FREE           0
+#endif
+
+/*
+ * The status and the slots shared with SPE start on a cache line boundary on
+ * non-coherent systems, so that their lines are not shared with other data.
+ */
+#if (MAILBOX_CACHE_LINE_SIZE > 0) || (MAILBOX_EVENT_POLL_SPIN > 0)
+#include "cmsis_compiler.h"
+#endif
+
+#if MAILBOX_CACHE_LINE_SIZE > 0
+#define NS_MAILBOX_CACHE_ALIGNED            __ALIGNED(MAILBOX_CACHE_LINE_SIZE)
+#else
+#define NS_MAILBOX_CACHE_ALIGNED
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,6 +53,23 @@ extern "C" {
 #pragma message("Note: NUM_MAILBOX_QUEUE_SLOT is set to more than 1 in NS bare metal environment")
 #endif
 
+/*
+ * With NS OS support, the maximum number of polls of the reply before the
+ * client thread blocks. The window is learnt per service from the latency of
+ * its previous calls. 0 blocks at once.
+ */
+#ifndef TFM_MULTI_CORE_NS_OS_WAIT_SPIN
+#define TFM_MULTI_CORE_NS_OS_WAIT_SPIN      0
+#endif
+
+/*
+ * A ticket identifying a PSA client call submitted without waiting. It is only
+ * valid for the task which submitted the call, until the call completes.
+ */
+typedef int32_t    mailbox_ticket_t;
+
+#define MAILBOX_TICKET_NULL                 ((mailbox_ticket_t)0)
+
 /*
  * A single slot structure in NSPE mailbox queue for NS side only.
  * This information is needed to handle mailbox requests/responses on NS side.
@@ -32,6 +77,9 @@ extern "C" {
  */
 struct ns_mailbox_slot_t {
     const void *owner;                      /* Handle of owner task. */
+    uint16_t   generation;                  /* Number of calls submitted in
+                                             * the slot, part of their ticket.
+                                             */
     int32_t    *reply;                      /* Address of reply value belonging
                                              * to owner task.
                                              */
@@ -45,13 +93,18 @@ struct ns_mailbox_slot_t {
                                              * or should be woken up, after the
                                              * reply is received.
                                              */
+#if TFM_MULTI_CORE_NS_OS_WAIT_SPIN > 0
+    uint8_t     spin_hist;                  /* Latency history of the service
+                                             * called.
+                                             */
+#endif
 #endif
 };
 
 /* NSPE mailbox queue */
 struct ns_mailbox_queue_t {
-    struct mailbox_status_t status;
-    struct mailbox_slot_t slots[NUM_MAILBOX_QUEUE_SLOT];
+    struct mailbox_status_t status NS_MAILBOX_CACHE_ALIGNED;
+    struct mailbox_slot_t slots[NUM_MAILBOX_QUEUE_SLOT] NS_MAILBOX_CACHE_ALIGNED;
 
     /* Following data are not shared with secure */
     struct ns_mailbox_slot_t slots_ns[NUM_MAILBOX_QUEUE_SLOT];
@@ -72,6 +125,11 @@ struct ns_mailbox_queue_t {
 #endif
 
     bool                     is_full;           /* Queue if full */
+
+    void                     *shm_base;         /* Optional buffer pool
+                                                 * shared with SPE
+                                                 */
+    uint32_t                 shm_size;          /* Size of buffer pool */
 };
 
 /**
@@ -85,6 +143,22 @@ struct ns_mailbox_queue_t {
  */
 int32_t tfm_ns_mailbox_init(struct ns_mailbox_queue_t *queue);
 
+/**
+ * \brief Register a buffer pool for PSA client call payloads
+ *
+ * \param[in] base              The base address of the buffer pool.
+ * \param[in] size              The size of the buffer pool in bytes.
+ *
+ * \retval MAILBOX_SUCCESS      Operation succeeded.
+ * \retval Other return code    Operation failed with an error code.
+ *
+ * \note It must be called before \ref tfm_ns_mailbox_init. SPE validates the
+ *       pool once during mailbox initialization. Afterwards, invecs and
+ *       outvecs located inside the pool pass the SPE memory access check
+ *       without looking up the memory layout on every call.
+ */
+int32_t tfm_ns_mailbox_register_shm_pool(void *base, uint32_t size);
+
 /**
  * \brief Send PSA client call to SPE via mailbox. Wait and fetch PSA client
  *        call result.
@@ -104,6 +178,112 @@ int32_t tfm_ns_mailbox_client_call(uint32_t call_type,
                                    int32_t client_id,
                                    int32_t *reply);
 
+#ifndef TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD
+/**
+ * \brief Send PSA client call to SPE via mailbox without waiting for the
+ *        result.
+ *
+ * \param[in] call_type         PSA client call type
+ * \param[in] params            Parameters used for PSA client call
+ * \param[in] client_id         Optional client ID of non-secure caller.
+ *                              It is required to identify the non-secure caller
+ *                              when NSPE OS enforces non-secure task isolation.
+ * \param[in] priority          The priority class of the call,
+ *                              \ref MAILBOX_PRIO_NORMAL or
+ *                              \ref MAILBOX_PRIO_HIGH.
+ * \param[out] ticket           The ticket to complete the PSA client call with
+ *                              \ref tfm_ns_mailbox_client_call_poll or
+ *                              \ref tfm_ns_mailbox_client_call_wait.
+ *
+ * \retval MAILBOX_SUCCESS      The PSA client call is sent successfully.
+ * \retval Other return code    Operation failed with an error code.
+ *
+ * \note The vectors referred by \p params must stay valid until the call is
+ *       completed. The call must be completed by the task which submitted it,
+ *       since the reply wakes up the submitting task.
+ */
+int32_t tfm_ns_mailbox_client_call_submit(uint32_t call_type,
+                                     const struct psa_client_params_t *params,
+                                     int32_t client_id,
+                                     uint32_t priority,
+                                     mailbox_ticket_t *ticket);
+
+/**
+ * \brief Check whether a submitted PSA client call is completed and fetch
+ *        PSA client call result if so.
+ *
+ * \param[in] ticket            The ticket returned on submission.
+ * \param[out] reply            The buffer written with PSA client call result.
+ *
+ * \retval MAILBOX_SUCCESS        The PSA client call is completed.
+ * \retval MAILBOX_NO_PEND_EVENT  The PSA client call is not replied yet.
+ * \retval Other return code      Operation failed with an error code.
+ */
+int32_t tfm_ns_mailbox_client_call_poll(mailbox_ticket_t ticket,
+                                        int32_t *reply);
+
+/**
+ * \brief Wait for a submitted PSA client call and fetch PSA client call
+ *        result.
+ *
+ * \param[in] ticket            The ticket returned on submission.
+ * \param[out] reply            The buffer written with PSA client call result.
+ *
+ * \retval MAILBOX_SUCCESS      The PSA client call is completed successfully.
+ * \retval Other return code    Operation failed with an error code.
+ */
+int32_t tfm_ns_mailbox_client_call_wait(mailbox_ticket_t ticket,
+                                        int32_t *reply);
+
+/**
+ * \brief Submit a psa_call() without waiting for the result.
+ *
+ * \param[in] handle            The parameter of psa_call()
+ * \param[in] type              The parameter of psa_call()
+ * \param[in] in_vec            The parameter of psa_call()
+ * \param[in] in_len            The parameter of psa_call()
+ * \param[in] out_vec           The parameter of psa_call()
+ * \param[in] out_len           The parameter of psa_call()
+ * \param[in] priority          The priority class of the call,
+ *                              \ref MAILBOX_PRIO_NORMAL or
+ *                              \ref MAILBOX_PRIO_HIGH.
+ * \param[out] ticket           The ticket to complete the call with
+ *                              \ref tfm_ns_psa_call_poll or
+ *                              \ref tfm_ns_psa_call_wait.
+ *
+ * \retval PSA_SUCCESS          The call is submitted.
+ * \retval Other return code    The call is not submitted.
+ *
+ * \note \p in_vec, \p out_vec and the buffers they refer to must stay valid
+ *       until the call is completed.
+ */
+psa_status_t tfm_ns_psa_call_submit(psa_handle_t handle, int32_t type,
+                                    const psa_invec *in_vec, size_t in_len,
+                                    psa_outvec *out_vec, size_t out_len,
+                                    uint32_t priority,
+                                    mailbox_ticket_t *ticket);
+
+/**
+ * \brief Check whether a submitted psa_call() is completed.
+ *
+ * \param[in] ticket            The ticket returned on submission.
+ * \param[out] status           The return value of psa_call() if completed.
+ *
+ * \retval true                 The call is completed.
+ * \retval false                The call is still ongoing.
+ */
+bool tfm_ns_psa_call_poll(mailbox_ticket_t ticket, psa_status_t *status);
+
+/**
+ * \brief Wait for a submitted psa_call() to complete.
+ *
+ * \param[in] ticket            The ticket returned on submission.
+ *
+ * \return The return value of psa_call().
+ */
+psa_status_t tfm_ns_psa_call_wait(mailbox_ticket_t ticket);
+#endif /* TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD */
+
 #ifdef TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD
 /**
  * \brief Handling PSA client calls in a dedicated NS mailbox thread.
@@ -168,6 +348,31 @@ void tfm_ns_mailbox_hal_enter_critical_isr(void);
  */
 void tfm_ns_mailbox_hal_exit_critical_isr(void);
 
+#if MAILBOX_CACHE_LINE_SIZE > 0
+/**
+ * \brief Clean the data cache lines of a part of the NSPE mailbox queue written
+ *        by NSPE, so that SPE can read it.
+ *
+ * \param[in] addr              The base address, aligned to a cache line.
+ * \param[in] size              The size, a multiple of the cache line size.
+ *
+ * \note The lines are written to memory when it returns.
+ */
+void tfm_ns_mailbox_hal_cache_clean(const void *addr, size_t size);
+
+/**
+ * \brief Invalidate the data cache lines of a part of the NSPE mailbox queue
+ *        before NSPE reads what SPE wrote to it.
+ *
+ * \param[in] addr              The base address, aligned to a cache line.
+ * \param[in] size              The size, a multiple of the cache line size.
+ */
+void tfm_ns_mailbox_hal_cache_invalidate(void *addr, size_t size);
+#else
+#define tfm_ns_mailbox_hal_cache_clean(addr, size)          do {} while (0)
+#define tfm_ns_mailbox_hal_cache_invalidate(addr, size)     do {} while (0)
+#endif
+
 #ifdef TFM_MULTI_CORE_NS_OS
 /**
  * \brief Initialize the multi-core lock for synchronizing PSA client call(s)
@@ -299,7 +504,12 @@ void tfm_ns_mailbox_os_spin_lock(void);
  */
 void tfm_ns_mailbox_os_spin_unlock(void);
 #else /* TFM_MULTI_CORE_NS_OS */
+#if MAILBOX_EVENT_POLL_SPIN > 0
+/* SPE sends an event with each reply notification */
+#define tfm_ns_mailbox_os_wait_reply()         __WFE()
+#else
 #define tfm_ns_mailbox_os_wait_reply()         do {} while (0)
+#endif
 
 #define tfm_ns_mailbox_os_wake_task_isr(task)  do {} while (0)
 
@@ -338,28 +548,99 @@ static inline int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
 #endif /* TFM_MULTI_CORE_NS_OS */
 
 /* The following inline functions configure non-secure mailbox queue status */
-static inline void clear_queue_slot_empty(struct ns_mailbox_queue_t *queue_ptr,
-                                          uint8_t idx)
+
+/*
+ * Claims the lowest empty slot.
+ * Returns NUM_MAILBOX_QUEUE_SLOT if no slot is empty.
+ */
+static inline uint8_t claim_queue_slot_empty(
+                                           struct ns_mailbox_queue_t *queue_ptr)
 {
-    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        queue_ptr->empty_slots &= ~(1UL << idx);
+    uint8_t idx;
+    mailbox_queue_status_t status;
+#if NS_MAILBOX_SLOT_LOCK_FREE == 1
+    volatile uint32_t *p_empty = (volatile uint32_t *)&queue_ptr->empty_slots;
+
+    do {
+        status = __LDREXW(p_empty);
+        if (!status) {
+            __CLREX();
+            return NUM_MAILBOX_QUEUE_SLOT;
+        }
+
+        for (idx = 0; !(status & (1UL << idx)); idx++) {
+        }
+    } while (__STREXW(status & ~(1UL << idx), p_empty) != 0);
+
+    /* The slot is not accessed before it is claimed */
+    __DMB();
+#else
+    tfm_ns_mailbox_os_spin_lock();
+
+    status = queue_ptr->empty_slots;
+    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
+        if (status & (1UL << idx)) {
+            queue_ptr->empty_slots &= ~(1UL << idx);
+            break;
+        }
     }
+
+    tfm_ns_mailbox_os_spin_unlock();
+#endif
+
+    return idx;
 }
 
+/*
+ * Releases the slots in mask. Without NS_MAILBOX_SLOT_LOCK_FREE, the caller
+ * holds the spin lock, or runs in the mailbox interrupt.
+ */
+static inline void set_queue_slots_empty(struct ns_mailbox_queue_t *queue_ptr,
+                                         mailbox_queue_status_t mask)
+{
+#if NS_MAILBOX_SLOT_LOCK_FREE == 1
+    volatile uint32_t *p_empty = (volatile uint32_t *)&queue_ptr->empty_slots;
+
+    /* Accesses to the slots complete before they are released */
+    __DMB();
+
+    do {
+    } while (__STREXW(__LDREXW(p_empty) | mask, p_empty) != 0);
+#else
+    queue_ptr->empty_slots |= mask;
+#endif
+}
+
+/*
+ * The status words are updated in the critical section of the mailbox, in
+ * which they are neither read nor written by SPE.
+ */
 static inline void set_queue_slot_pend(struct ns_mailbox_queue_t *queue_ptr,
                                        uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
+        tfm_ns_mailbox_hal_cache_invalidate(queue_ptr->status.pend_lines,
+                                        sizeof(queue_ptr->status.pend_lines));
         queue_ptr->status.pend_slots |= (1UL << idx);
+        tfm_ns_mailbox_hal_cache_clean(queue_ptr->status.pend_lines,
+                                       sizeof(queue_ptr->status.pend_lines));
     }
 }
 
 static inline mailbox_queue_status_t clear_queue_slot_all_replied(
                                            struct ns_mailbox_queue_t *queue_ptr)
 {
-    mailbox_queue_status_t status = queue_ptr->status.replied_slots;
+    mailbox_queue_status_t status;
+
+    tfm_ns_mailbox_hal_cache_invalidate(queue_ptr->status.replied_lines,
+                                     sizeof(queue_ptr->status.replied_lines));
+    status = queue_ptr->status.replied_slots;
+    if (status) {
+        queue_ptr->status.replied_slots = 0;
+        tfm_ns_mailbox_hal_cache_clean(queue_ptr->status.replied_lines,
+                                     sizeof(queue_ptr->status.replied_lines));
+    }
 
-    queue_ptr->status.replied_slots = 0;
     return status;
 }
 
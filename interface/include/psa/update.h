@@ -200,6 +200,20 @@ psa_status_t psa_fwu_start(psa_fwu_component_t component,
  */
 #define PSA_FWU_MAX_WRITE_SIZE TFM_CONFIG_FWU_MAX_WRITE_SIZE
 
+/**
+ * @brief The maximum permitted size for block in psa_fwu_write(), in bytes,
+ *        when the block is programmed in place from the buffer of the client.
+ *        This is an implementation extension for bulk transfers, which is
+ *        PSA_FWU_MAX_WRITE_SIZE unless TFM_CONFIG_FWU_MAX_BULK_WRITE_SIZE is
+ *        set.
+ */
+#if defined(TFM_CONFIG_FWU_MAX_BULK_WRITE_SIZE) && \
+    (TFM_CONFIG_FWU_MAX_BULK_WRITE_SIZE > 0)
+#define TFM_FWU_MAX_BULK_WRITE_SIZE TFM_CONFIG_FWU_MAX_BULK_WRITE_SIZE
+#else
+#define TFM_FWU_MAX_BULK_WRITE_SIZE PSA_FWU_MAX_WRITE_SIZE
+#endif
+
 /**
  * @brief Write a firmware image, or part of a firmware image, to its staging
  *        area.
@@ -8,6 +8,10 @@
 #ifndef __TFM_ATTEST_DEFS_H__
 #define __TFM_ATTEST_DEFS_H__
 
+#include <stddef.h>
+#include <stdint.h>
+#include "psa/error.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,6 +19,35 @@ extern "C" {
 /* Initial Attestation message types that distinguish Attest services. */
 #define TFM_ATTEST_GET_TOKEN       1001
 #define TFM_ATTEST_GET_TOKEN_SIZE  1002
+#define TFM_ATTEST_GET_TOKENS      1003
+
+/* The maximum number of challenges of a TFM_ATTEST_GET_TOKENS request */
+#define TFM_ATTEST_GET_TOKENS_MAX_CHALLENGES  8
+
+/**
+ * \brief Gets one initial attestation token per challenge in a single request
+ *        to the Initial Attestation service. The service must be built with
+ *        ATTEST_GET_TOKENS_ENABLED.
+ *
+ * \param[in]  auth_challenges  The challenges, one after the other
+ * \param[in]  challenge_size   Size of each challenge: 32, 48 or 64 bytes
+ * \param[in]  challenge_count  Number of challenges, at most
+ *                              \ref TFM_ATTEST_GET_TOKENS_MAX_CHALLENGES
+ * \param[out] token_buf        Buffer where the tokens are written, one after
+ *                              the other, in the order of the challenges
+ * \param[in]  token_buf_size   Size of token_buf
+ * \param[out] token_sizes      Array of challenge_count sizes, one per token
+ *
+ * \return PSA_SUCCESS if all the tokens are created, an error code as
+ *         specified for psa_initial_attest_get_token() otherwise
+ */
+psa_status_t
+tfm_initial_attest_get_tokens(const uint8_t *auth_challenges,
+                              size_t         challenge_size,
+                              size_t         challenge_count,
+                              uint8_t       *token_buf,
+                              size_t         token_buf_size,
+                              size_t        *token_sizes);
 
 #ifdef __cplusplus
 }
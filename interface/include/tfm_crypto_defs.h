@@ -62,10 +62,67 @@ struct tfm_crypto_pack_iovec {
     };
 };
 
+/**
+ * \brief The range of the key IDs given out by tfm_crypto_key_share(), in the
+ *        vendor range just below the builtin keys
+ */
+#define TFM_CRYPTO_SHARED_KEY_ID_MIN (0x7ffe0000u)
+#define TFM_CRYPTO_SHARED_KEY_ID_MAX (0x7ffeffffu)
+
+/**
+ * \brief The maximum number of input vectors of an operation in a batch
+ *        request, not counting its \ref tfm_crypto_pack_iovec
+ */
+#define TFM_CRYPTO_BATCH_MAX_IN_VEC (3u)
+
+/**
+ * \brief The maximum number of output vectors of an operation in a batch
+ *        request
+ */
+#define TFM_CRYPTO_BATCH_MAX_OUT_VEC (4u)
+
+/**
+ * \brief Aligns the length of an input or output of an operation in a batch
+ *        request to obtain the offset of the next one in the same buffer
+ */
+#define TFM_CRYPTO_BATCH_ALIGN(len) (((len) + 3u) & ~3u)
+
+/**
+ * \brief Structure describing one operation of a batch request. The inputs and
+ *        outputs of the operations are laid out in order in the input and
+ *        output buffers of the batch request, each one starting at an offset
+ *        aligned with \ref TFM_CRYPTO_BATCH_ALIGN
+ */
+struct tfm_crypto_batch_op {
+    struct tfm_crypto_pack_iovec iov;   /*!< Parameters of the operation, as
+                                         *   in a request for a single one
+                                         */
+    uint32_t in_len[TFM_CRYPTO_BATCH_MAX_IN_VEC];   /*!< Length of each input
+                                                     *   after iov, 0 if unused
+                                                     */
+    uint32_t out_len[TFM_CRYPTO_BATCH_MAX_OUT_VEC]; /*!< Size of each output,
+                                                     *   0 if unused
+                                                     */
+};
+
+/**
+ * \brief Structure holding the result of one operation of a batch request
+ */
+struct tfm_crypto_batch_result {
+    psa_status_t status;        /*!< Status returned by the operation,
+                                 *   PSA_ERROR_BAD_STATE if it has not been
+                                 *   executed
+                                 */
+    uint32_t out_len[TFM_CRYPTO_BATCH_MAX_OUT_VEC]; /*!< Length written to
+                                                     *   each output
+                                                     */
+};
+
 /**
  * \brief Type associated to the group of a function encoding. There can be
- *        nine groups (Random, Key management, Hash, MAC, Cipher, AEAD,
- *        Asym sign, Asym encrypt, Key derivation).
+ *        ten groups (Random, Key management, Hash, MAC, Cipher, AEAD,
+ *        Asym sign, Asym encrypt, Key derivation,
+ *        Batch).
  */
 enum tfm_crypto_group_id_t {
     TFM_CRYPTO_GROUP_ID_RANDOM          = UINT8_C(1),
@@ -76,7 +133,8 @@ enum tfm_crypto_group_id_t {
     TFM_CRYPTO_GROUP_ID_AEAD            = UINT8_C(6),
     TFM_CRYPTO_GROUP_ID_ASYM_SIGN       = UINT8_C(7),
     TFM_CRYPTO_GROUP_ID_ASYM_ENCRYPT    = UINT8_C(8),
-    TFM_CRYPTO_GROUP_ID_KEY_DERIVATION  = UINT8_C(9)
+    TFM_CRYPTO_GROUP_ID_KEY_DERIVATION  = UINT8_C(9),
+    TFM_CRYPTO_GROUP_ID_BATCH           = UINT8_C(10)
 };
 
 /* Set of X macros describing each of the available PSA Crypto APIs */
@@ -93,7 +151,9 @@ enum tfm_crypto_group_id_t {
     X(TFM_CRYPTO_EXPORT_PUBLIC_KEY)                \
     X(TFM_CRYPTO_PURGE_KEY)                        \
     X(TFM_CRYPTO_COPY_KEY)                         \
-    X(TFM_CRYPTO_GENERATE_KEY)
+    X(TFM_CRYPTO_GENERATE_KEY)                     \
+    X(TFM_CRYPTO_SHARE_KEY)                        \
+    X(TFM_CRYPTO_UNSHARE_KEY)
 
 #define HASH_FUNCS                                 \
     X(TFM_CRYPTO_HASH_COMPUTE)                     \
@@ -103,7 +163,8 @@ enum tfm_crypto_group_id_t {
     X(TFM_CRYPTO_HASH_CLONE)                       \
     X(TFM_CRYPTO_HASH_FINISH)                      \
     X(TFM_CRYPTO_HASH_VERIFY)                      \
-    X(TFM_CRYPTO_HASH_ABORT)
+    X(TFM_CRYPTO_HASH_ABORT)                       \
+    X(TFM_CRYPTO_HASH_FINISH_SNAPSHOT)
 
 #define MAC_FUNCS                                  \
     X(TFM_CRYPTO_MAC_COMPUTE)                      \
@@ -163,6 +224,9 @@ enum tfm_crypto_group_id_t {
     X(TFM_CRYPTO_KEY_DERIVATION_OUTPUT_KEY)        \
     X(TFM_CRYPTO_KEY_DERIVATION_ABORT)
 
+#define BATCH_FUNCS                                \
+    X(TFM_CRYPTO_BATCH)
+
 #define BASE__VALUE(x) ((uint16_t)((((uint16_t)(x)) << 8) & 0xFF00))
 
 /**
@@ -197,6 +261,8 @@ enum tfm_crypto_func_sid_t {
     ASYM_ENCRYPT_FUNCS
     BASE__KEY_DERIVATION = BASE__VALUE(TFM_CRYPTO_GROUP_ID_KEY_DERIVATION) - 1,
     KEY_DERIVATION_FUNCS
+    BASE__BATCH          = BASE__VALUE(TFM_CRYPTO_GROUP_ID_BATCH) - 1,
+    BATCH_FUNCS
 #undef X
 };
 
@@ -207,6 +273,156 @@ enum tfm_crypto_func_sid_t {
 #define TFM_CRYPTO_GET_GROUP_ID(_function_id) \
     ((enum tfm_crypto_group_id_t)(((uint16_t)(_function_id) >> 8) & 0xFF))
 
+/**
+ * \brief Message type of the requests to log and clear the timing statistics
+ *        of the crypto service, when it is built with CRYPTO_STATS_ENTRIES
+ */
+#define TFM_CRYPTO_STATS_LOG (1)
+
+/**
+ * \brief Message type of the requests to wipe the random bytes generated ahead
+ *        of the requests by the crypto service, when it is built with
+ *        CRYPTO_RNG_POOL_SIZE
+ */
+#define TFM_CRYPTO_RNG_POOL_CLEAR (2)
+
+/**
+ * \brief Message type of the requests to compute the ephemeral key of an ECDSA
+ *        signature ahead of the signature, when the crypto service is built
+ *        with CC3XX_ECDSA_PRECOMPUTE_SLOTS
+ */
+#define TFM_CRYPTO_SIGN_PRECOMPUTE (3)
+
+/**
+ * \brief Runs a batch of PSA Crypto operations in a single request to the
+ *        crypto service. The operations are executed in order, and the batch
+ *        stops at the first operation which fails.
+ *
+ * \param[in]  ops          Array of operations to execute
+ * \param[in]  op_count     Number of operations in ops
+ * \param[in]  in_buf       Inputs of all the operations, as described by ops
+ * \param[in]  in_buf_len   Length of in_buf
+ * \param[out] results      Array of op_count results, one per operation
+ * \param[out] out_buf      Outputs of all the operations, as described by ops
+ * \param[in]  out_buf_len  Size of out_buf
+ *
+ * \note Operations which produce a handle return it in out_buf, hence a later
+ *       operation of the same batch can't use it.
+ *
+ * \return PSA_SUCCESS if all the operations succeeded, the status of the
+ *         first operation which failed otherwise, or an error of the batch
+ *         request itself
+ */
+psa_status_t tfm_crypto_batch_call(const struct tfm_crypto_batch_op ops[],
+                                   size_t op_count,
+                                   const void *in_buf,
+                                   size_t in_buf_len,
+                                   struct tfm_crypto_batch_result results[],
+                                   void *out_buf,
+                                   size_t out_buf_len);
+
+/**
+ * \brief Prints the timing statistics of the crypto service over its partition
+ *        log, then clears them. For each function and algorithm, they give the
+ *        number of requests, the bytes passed in their inputs, the cycles spent
+ *        in the PSA Crypto implementation and the cycles spent in the crypto
+ *        partition. The difference with the duration of the requests measured
+ *        by the caller is the cost of the IPC.
+ *
+ * \note Multi-part operations pass their algorithm to the setup functions
+ *       only, so the other steps are accounted with algorithm 0.
+ *
+ * \return PSA_SUCCESS, or PSA_ERROR_NOT_SUPPORTED if the crypto service is
+ *         built without CRYPTO_STATS_ENTRIES
+ */
+psa_status_t tfm_crypto_stats_log(void);
+
+/**
+ * \brief Wipes the random bytes that the crypto service generated ahead of
+ *        the random requests. A secure partition which detects a security
+ *        event, such as a tamper alarm or a change of lifecycle state, calls it
+ *        so that no random byte generated before the event is given out after.
+ *
+ * \return PSA_SUCCESS, PSA_ERROR_NOT_PERMITTED if called from the
+ *         non-secure side
+ */
+psa_status_t tfm_crypto_random_pool_clear(void);
+
+/**
+ * \brief Computes the ephemeral key pair (k, [k]G) of one ECDSA signature on a
+ *        curve ahead of the signature, and keeps it in the crypto service.
+ *        The next psa_sign_hash() or psa_sign_message() on this curve uses it
+ *        instead of doing the point multiplication, and erases it. A secure
+ *        partition, such as the one which signs the attestation tokens, calls
+ *        it from a low priority context or the idle hook of the platform until
+ *        it returns PSA_ERROR_INSUFFICIENT_MEMORY. The keys are also erased by
+ *        tfm_crypto_random_pool_clear().
+ *
+ * \param[in] curve  ECC family of the curve, as PSA_KEY_TYPE_ECC_GET_FAMILY()
+ * \param[in] bits   Size in bits of the keys of the curve
+ *
+ * \return PSA_SUCCESS if a key was computed, PSA_ERROR_INSUFFICIENT_MEMORY if
+ *         all the slots already hold a key, PSA_ERROR_NOT_PERMITTED if called
+ *         from the non-secure side, PSA_ERROR_NOT_SUPPORTED if the curve or
+ *         the precomputation is not supported
+ */
+psa_status_t tfm_crypto_sign_precompute(psa_ecc_family_t curve, size_t bits);
+
+/**
+ * \brief Computes the hash of the data passed so far to a hash operation and
+ *        leaves the operation active, so that more data can be added to it.
+ *        It has the result of a psa_hash_clone() followed by psa_hash_finish()
+ *        on the clone, without allocating a second operation context in the
+ *        crypto service and in a single request.
+ *
+ * \param[in]  operation    Active hash operation
+ * \param[out] hash         Buffer where the hash is to be written
+ * \param[in]  hash_size    Size of the hash buffer in bytes
+ * \param[out] hash_length  On success, the number of bytes of the hash
+ *
+ * \return PSA_SUCCESS, or an error as returned by psa_hash_finish(). The
+ *         operation is left unchanged in both cases.
+ */
+psa_status_t tfm_crypto_hash_finish_snapshot(const psa_hash_operation_t *operation,
+                                             uint8_t *hash,
+                                             size_t hash_size,
+                                             size_t *hash_length);
+
+/**
+ * \brief Lets another secure partition use a key of the caller, without
+ *        copying it. The other partition passes the returned key ID to the
+ *        PSA Crypto functions which use the key, within the usage policy of
+ *        the key. It can also get the attributes of the key and export its
+ *        public part, but it can't export, copy, destroy or share the key.
+ *        The access ends when the caller calls tfm_crypto_key_unshare() or
+ *        destroys the key.
+ *
+ * \param[in]  key           Key of the caller
+ * \param[in]  partition_id  ID of the secure partition given access
+ * \param[out] shared_key    Key ID to be used by that partition
+ *
+ * \return PSA_SUCCESS, PSA_ERROR_NOT_PERMITTED if the caller or the other
+ *         partition is not a secure partition, PSA_ERROR_INSUFFICIENT_MEMORY
+ *         if all the CRYPTO_KEY_SHARE_ENTRIES are in use, or an error as
+ *         returned by psa_get_key_attributes() for the key
+ */
+psa_status_t tfm_crypto_key_share(psa_key_id_t key,
+                                  int32_t partition_id,
+                                  psa_key_id_t *shared_key);
+
+/**
+ * \brief Ends the access of a secure partition to a key of the caller, given
+ *        by tfm_crypto_key_share(). The operations that partition has already
+ *        set up with the key are not aborted.
+ *
+ * \param[in] key           Key of the caller
+ * \param[in] partition_id  ID of the secure partition
+ *
+ * \return PSA_SUCCESS, or PSA_ERROR_DOES_NOT_EXIST if the key is not shared
+ *         with that partition
+ */
+psa_status_t tfm_crypto_key_unshare(psa_key_id_t key, int32_t partition_id);
+
 #ifdef __cplusplus
 }
 #endif
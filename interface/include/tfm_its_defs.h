@@ -8,6 +8,12 @@
 #ifndef __TFM_ITS_DEFS_H__
 #define __TFM_ITS_DEFS_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/error.h"
+#include "psa/storage_common.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,6 +26,201 @@ extern "C" {
 #define TFM_ITS_GET                1002
 #define TFM_ITS_GET_INFO           1003
 #define TFM_ITS_REMOVE             1004
+#define TFM_ITS_COMPACT            1005
+#define TFM_ITS_TRANSACTION_BEGIN  1006
+#define TFM_ITS_TRANSACTION_COMMIT 1007
+#define TFM_ITS_TRANSACTION_ABORT  1008
+#define TFM_ITS_GET_ERASE_COUNT    1009
+#define TFM_ITS_GET_FLASH_STATS    1010
+#define TFM_ITS_GET_MULTI          1011
+#define TFM_ITS_SET_MULTI          1012
+#define TFM_ITS_CACHE_FLUSH        1013
+
+/**
+ * \brief Flash operations issued by the ITS filesystem since the service was
+ *        initialised. bytes_programmed divided by bytes_written gives the write
+ *        amplification of the filesystem.
+ */
+struct tfm_its_flash_stats_t {
+    uint32_t reads;            /* Number of flash read operations */
+    uint32_t bytes_read;       /* Number of bytes read from flash */
+    uint32_t programs;         /* Number of flash program operations */
+    uint32_t bytes_programmed; /* Number of bytes programmed in flash */
+    uint32_t erases;           /* Number of flash block erases */
+    uint32_t bytes_written;    /* Number of asset data bytes written */
+};
+
+/**
+ * \brief An asset read by tfm_its_get_multi(), as in psa_its_get().
+ */
+struct tfm_its_get_desc_t {
+    psa_storage_uid_t uid;          /* The UID of the asset */
+    size_t data_offset;             /* Offset of the data to read */
+    size_t data_size;               /* Maximum number of bytes to read */
+};
+
+/**
+ * \brief An asset written by tfm_its_set_multi(), as in psa_its_set().
+ */
+struct tfm_its_set_desc_t {
+    psa_storage_uid_t uid;                   /* The UID of the asset */
+    size_t data_length;                      /* Size of the asset data */
+    psa_storage_create_flags_t create_flags; /* Flags of the asset */
+};
+
+/**
+ * \brief Reclaims the storage space of one removed or replaced asset, when
+ *        the ITS service is built with ITS_DEFERRED_COMPACTION. It is meant to
+ *        be called repeatedly from a low priority context, for example an idle
+ *        hook, until it returns PSA_ERROR_DOES_NOT_EXIST.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS               The space of one asset has been reclaimed
+ * \retval PSA_ERROR_DOES_NOT_EXIST  There is no space left to reclaim
+ * \retval PSA_ERROR_NOT_SUPPORTED   The service does not defer compaction
+ * \retval PSA_ERROR_STORAGE_FAILURE The operation failed because the physical
+ *                                   storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_compact_step(void);
+
+/**
+ * \brief Begins a transaction, when the ITS service is built with
+ *        ITS_TRANSACTIONS. The psa_its_set() and psa_its_remove() calls of the
+ *        caller are applied together by tfm_its_transaction_commit(), while
+ *        psa_its_get() and psa_its_get_info() keep returning the committed
+ *        assets. Only one transaction can be open at a time.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS               The transaction has been opened
+ * \retval PSA_ERROR_BAD_STATE       A transaction is already open
+ * \retval PSA_ERROR_NOT_SUPPORTED   The service does not support transactions
+ */
+psa_status_t tfm_its_transaction_begin(void);
+
+/**
+ * \brief Commits the caller's transaction. Either all of its changes are
+ *        stored, or none of them, even across a power failure.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS               The transaction has been committed
+ * \retval PSA_ERROR_BAD_STATE       The caller has no open transaction
+ * \retval PSA_ERROR_NOT_SUPPORTED   The service does not support transactions
+ * \retval PSA_ERROR_STORAGE_FAILURE The operation failed because the physical
+ *                                   storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_transaction_commit(void);
+
+/**
+ * \brief Aborts the caller's transaction, discarding all of its changes.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS               The transaction has been aborted
+ * \retval PSA_ERROR_BAD_STATE       The caller has no open transaction
+ * \retval PSA_ERROR_NOT_SUPPORTED   The service does not support transactions
+ * \retval PSA_ERROR_STORAGE_FAILURE The operation failed because the physical
+ *                                   storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_transaction_abort(void);
+
+/**
+ * \brief Gets the number of times a flash block of the ITS area has been
+ *        erased, when the ITS service is built with ITS_WEAR_LEVELLING. It is
+ *        meant for diagnostics, the blocks being numbered from 0 until the
+ *        call returns PSA_ERROR_INVALID_ARGUMENT.
+ *
+ * \param[in]  block_id     Index of the flash block in the ITS area
+ * \param[out] erase_count  Number of times the block has been erased
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                The erase count has been read
+ * \retval PSA_ERROR_INVALID_ARGUMENT The block does not exist
+ * \retval PSA_ERROR_NOT_SUPPORTED    The service does not count the erases,
+ *                                    or the block is a metadata block, whose
+ *                                    erases are not counted
+ */
+psa_status_t tfm_its_get_erase_count(uint32_t block_id, uint32_t *erase_count);
+
+/**
+ * \brief Gets the flash operations issued by the ITS filesystem of the caller,
+ *        when the ITS service is built with ITS_FLASH_STATS. It is meant for
+ *        benchmarking the storage, the Protected Storage partition getting the
+ *        counters of the PS area and the other clients those of the ITS area.
+ *
+ * \param[out] stats  Flash operation counters
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                The counters have been read
+ * \retval PSA_ERROR_NOT_SUPPORTED    The service does not count the flash
+ *                                    operations
+ */
+psa_status_t tfm_its_get_flash_stats(struct tfm_its_flash_stats_t *stats);
+
+/**
+ * \brief Reads several assets in one call, when the ITS service is built with
+ *        ITS_MULTI_ASSET. The data of each asset is written to p_data right
+ *        after the data of the previous one, and its length to
+ *        p_data_length. The assets are read in order until the first failure.
+ *
+ * \param[in]  desc           The assets to read
+ * \param[in]  count          Number of descriptors in desc
+ * \param[out] p_data         Buffer of at least the sum of the data_size of
+ *                            the descriptors
+ * \param[out] p_data_length  Length of the data read for each descriptor
+ *
+ * \return A status indicating the success/failure of the operation, as
+ *         psa_its_get() returns for the first asset which failed
+ *
+ * \retval PSA_SUCCESS               All the assets have been read
+ * \retval PSA_ERROR_NOT_SUPPORTED   The service does not support multi-asset
+ *                                   calls
+ */
+psa_status_t tfm_its_get_multi(const struct tfm_its_get_desc_t *desc,
+                               size_t count, void *p_data,
+                               size_t *p_data_length);
+
+/**
+ * \brief Writes several assets in one call, when the ITS service is built
+ *        with ITS_MULTI_ASSET. The data of each asset follows the data of the
+ *        previous one in p_data. The assets are written in order until the
+ *        first failure, the assets before it staying written.
+ *
+ * \param[in] desc    The assets to write
+ * \param[in] count   Number of descriptors in desc
+ * \param[in] p_data  The data of the assets, of the sum of the data_length
+ *                    of the descriptors
+ *
+ * \return A status indicating the success/failure of the operation, as
+ *         psa_its_set() returns for the first asset which failed
+ *
+ * \retval PSA_SUCCESS               All the assets have been written
+ * \retval PSA_ERROR_NOT_SUPPORTED   The service does not support multi-asset
+ *                                   calls
+ */
+psa_status_t tfm_its_set_multi(const struct tfm_its_set_desc_t *desc,
+                               size_t count, const void *p_data);
+
+/**
+ * \brief Writes the assets held in the RAM cache of the ITS area back to
+ *        flash, when the ITS service is built with ITS_FLASH_CACHE. It is
+ *        meant for the flush policies of the system, for example from a
+ *        periodic timer or on a power-fail warning, the service itself only
+ *        writing back after ITS_FLASH_CACHE_FLUSH_UPDATES block updates, or
+ *        when the consistency of the filesystem in flash requires it.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS               The cache has been written back
+ * \retval PSA_ERROR_NOT_SUPPORTED   The service has no cache
+ * \retval PSA_ERROR_STORAGE_FAILURE The operation failed because the physical
+ *                                   storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_cache_flush(void);
 
 #ifdef __cplusplus
 }
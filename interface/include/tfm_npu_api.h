@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_NPU_API_H__
+#define __TFM_NPU_API_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "psa/client.h"
+#include "psa/storage_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief TFM secure partition NPU API version
+ */
+#define TFM_NPU_API_VERSION_MAJOR (0)
+#define TFM_NPU_API_VERSION_MINOR (1)
+
+#define TFM_NPU_API_ID_RUN             (1001)
+#define TFM_NPU_API_ID_INSTALL_MODEL   (1002)
+
+/**
+ * \brief Magic of the model header, "NPUM"
+ */
+#define TFM_NPU_MODEL_MAGIC            (0x4D55504EU)
+
+/**
+ * \brief Maximum number of base address regions of a command stream
+ */
+#define TFM_NPU_MODEL_REGION_MAX       (8)
+
+/*
+ * Kinds of the base address regions of a command stream.
+ *
+ * WEIGHTS   The data of the region follows the command stream in the model.
+ * SCRATCH   The region is allocated in secure memory for each inference.
+ * INPUT     The input tensor of the caller, at most one region.
+ * OUTPUT    The output tensor of the caller, at most one region.
+ */
+#define TFM_NPU_REGION_WEIGHTS         (0U)
+#define TFM_NPU_REGION_SCRATCH         (1U)
+#define TFM_NPU_REGION_INPUT           (2U)
+#define TFM_NPU_REGION_OUTPUT          (3U)
+
+/**
+ * \brief Base address region of a command stream
+ */
+struct tfm_npu_region_t {
+    uint32_t type;      /* TFM_NPU_REGION_* */
+    uint32_t size;      /* Size of the region in bytes */
+};
+
+/**
+ * \brief Header of a model, followed by the command stream and the data of the
+ *        WEIGHTS regions in the order of the region table. The region at index
+ *        n of the table is the base address region n of the command stream.
+ */
+struct tfm_npu_model_header_t {
+    uint32_t magic;             /* TFM_NPU_MODEL_MAGIC */
+    uint32_t cmd_size;          /* Size of the command stream in bytes */
+    uint32_t region_count;      /* Number of entries used in regions */
+    struct tfm_npu_region_t regions[TFM_NPU_MODEL_REGION_MAX];
+};
+
+/**
+ * \brief Stores a model in the storage of the NPU partition. Only secure
+ *        partitions can install models. The model is run from secure memory
+ *        and its command stream is trusted, it must come from a trusted
+ *        source.
+ *
+ * \param[in] uid         The identifier of the model
+ * \param[in] model       The model, starting with a tfm_npu_model_header_t
+ * \param[in] model_size  The size of the model in bytes
+ *
+ * \return PSA_SUCCESS if the model is stored, or an error as returned by the
+ *         Internal Trusted Storage service.
+ */
+psa_status_t tfm_npu_install_model(psa_storage_uid_t uid,
+                                   const void *model, size_t model_size);
+
+/**
+ * \brief Runs an inference of an installed model. With MM-IOVEC, the NPU
+ *        reads the input tensor and writes the output tensor in the buffers
+ *        of the caller.
+ *
+ * \param[in]  uid          The identifier of the model
+ * \param[in]  input        The input tensor
+ * \param[in]  input_size   The size of the input tensor, at least the size of
+ *                          the INPUT region of the model
+ * \param[out] output       The output tensor
+ * \param[in]  output_size  The size of the output tensor, at least the size
+ *                          of the OUTPUT region of the model
+ *
+ * \return PSA_SUCCESS if the inference completed.
+ *         PSA_ERROR_DOES_NOT_EXIST if the model is not installed.
+ *         PSA_ERROR_INVALID_ARGUMENT if a tensor is too small.
+ *         PSA_ERROR_INSUFFICIENT_MEMORY if the model does not fit the arena.
+ *         PSA_ERROR_HARDWARE_FAILURE if the NPU reported an error.
+ */
+psa_status_t tfm_npu_run(psa_storage_uid_t uid,
+                         const void *input, size_t input_size,
+                         void *output, size_t output_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_NPU_API_H__ */
@@ -21,12 +21,19 @@ extern "C" {
  * \brief TFM secure partition platform API version
  */
 #define TFM_PLATFORM_API_VERSION_MAJOR (0)
-#define TFM_PLATFORM_API_VERSION_MINOR (3)
+#define TFM_PLATFORM_API_VERSION_MINOR (4)
 
 #define TFM_PLATFORM_API_ID_NV_READ       (1010)
 #define TFM_PLATFORM_API_ID_NV_INCREMENT  (1011)
 #define TFM_PLATFORM_API_ID_SYSTEM_RESET  (1012)
 #define TFM_PLATFORM_API_ID_IOCTL         (1013)
+#define TFM_PLATFORM_API_ID_NV_READ_MULTI       (1014)
+#define TFM_PLATFORM_API_ID_NV_INCREMENT_MULTI  (1015)
+
+/**
+ * \brief Maximum number of NV counters accessed in one call
+ */
+#define TFM_PLATFORM_NV_COUNTER_BATCH_MAX (8)
 
 /*!
  * \enum tfm_platform_err_t
@@ -93,6 +100,41 @@ enum tfm_platform_err_t
 tfm_platform_nv_counter_read(uint32_t counter_id,
                              uint32_t size, uint8_t *val);
 
+/*!
+ * \brief Increments several non-volatile (NV) counters in one call
+ *
+ * \param[in]  counter_ids  NV counter IDs.
+ * \param[in]  counts       Number of increments of each counter.
+ * \param[in]  num          Number of counters, at most
+ *                          \ref TFM_PLATFORM_NV_COUNTER_BATCH_MAX.
+ *
+ * \note The permissions of all the counters are checked before any of them
+ *       is incremented. If an increment fails, the counters before it in the
+ *       array have been incremented.
+ *
+ * \return  TFM_PLATFORM_ERR_SUCCESS if the counters are incremented correctly.
+ *          Otherwise, it returns TFM_PLATFORM_ERR_SYSTEM_ERROR.
+ */
+enum tfm_platform_err_t
+tfm_platform_nv_counter_increment_multi(const uint32_t *counter_ids,
+                                        const uint32_t *counts,
+                                        uint32_t num);
+
+/*!
+ * \brief Reads several non-volatile (NV) counters in one call
+ *
+ * \param[in]  counter_ids  NV counter IDs.
+ * \param[out] vals         Values of the counters, in the order of the IDs.
+ * \param[in]  num          Number of counters, at most
+ *                          \ref TFM_PLATFORM_NV_COUNTER_BATCH_MAX.
+ *
+ * \return  TFM_PLATFORM_ERR_SUCCESS if the values are read correctly.
+ *          Otherwise, it returns TFM_PLATFORM_ERR_SYSTEM_ERROR.
+ */
+enum tfm_platform_err_t
+tfm_platform_nv_counter_read_multi(const uint32_t *counter_ids,
+                                   uint32_t *vals, uint32_t num);
+
 #ifdef __cplusplus
 }
 #endif
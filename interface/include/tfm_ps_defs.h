@@ -8,6 +8,8 @@
 #ifndef __TFM_PS_DEFS_H__
 #define __TFM_PS_DEFS_H__
 
+#include "psa/error.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -21,6 +23,24 @@ extern "C" {
 #define TFM_PS_GET_INFO           1003
 #define TFM_PS_REMOVE             1004
 #define TFM_PS_GET_SUPPORT        1005
+#define TFM_PS_CLOSE_EPOCH        1006
+
+/**
+ * \brief Closes the rollback protection epoch of the PS object table, when
+ *        the PS service is built with PS_ROLLBACK_EPOCH_SAVES greater than 1.
+ *        The object table is then saved with a new NV counter value, so that
+ *        none of the tables saved in the epoch can be replayed. It is meant
+ *        for a power-fail warning handler, the service itself only starting
+ *        a new epoch every PS_ROLLBACK_EPOCH_SAVES saves.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS               The epoch has been closed
+ * \retval PSA_ERROR_NOT_SUPPORTED   The service has no epochs
+ * \retval PSA_ERROR_STORAGE_FAILURE The operation failed because the physical
+ *                                   storage has failed (Fatal error)
+ */
+psa_status_t tfm_ps_close_epoch(void);
 
 #ifdef __cplusplus
 }
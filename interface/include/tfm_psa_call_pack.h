@@ -8,6 +8,7 @@
 #ifndef __TFM_PSA_CALL_PACK_H__
 #define __TFM_PSA_CALL_PACK_H__
 
+#include <stddef.h>
 #include "psa/client.h"
 
 #ifdef __cplusplus
@@ -15,13 +16,15 @@ extern "C" {
 #endif
 
 /*
- *  31           30-28   27    26-24  23-20   19     18-16   15-0
- * +------------+-----+------+-------+-----+-------+-------+------+
- * | NS vector  |     | NS   | invec |     | NS    | outvec| type |
- * | descriptor | Res | invec| number| Res | outvec| number|      |
- * +------------+-----+------+-------+-----+-------+-------+------+
+ *  31           30     29-28   27    26-24  23-20   19     18-16   15-0
+ * +------------+-------+-----+------+-------+-----+-------+-------+------+
+ * | NS vector  | Inline|     | NS   | invec |     | NS    | outvec| type |
+ * | descriptor | invec | Res | invec| number| Res | outvec| number|      |
+ * +------------+-------+-----+------+-------+-----+-------+-------+------+
  *
  * Res: Reserved.
+ * Inline invec: The payload of the first input vector is right before the
+ *               input vector descriptors, see struct tfm_psa_call_inline_t.
  */
 #define TYPE_MASK            0xFFFFUL
 
@@ -43,6 +46,9 @@ extern "C" {
 #define NS_OUTVEC_OFFSET     19
 #define NS_OUTVEC_BIT        (1UL << NS_OUTVEC_OFFSET)
 
+#define INLINE_INVEC_OFFSET  30
+#define INLINE_INVEC_BIT     (1UL << INLINE_INVEC_OFFSET)
+
 #define PARAM_PACK(type, in_len, out_len)                            \
           ((((uint32_t)(type)) & TYPE_MASK)                        | \
            ((((uint32_t)(in_len)) << IN_LEN_OFFSET) & IN_LEN_MASK) | \
@@ -65,9 +71,28 @@ extern "C" {
 #define PARAM_SET_NS_OUTVEC(ctrl_param) ((ctrl_param) | NS_OUTVEC_BIT)
 #define PARAM_IS_NS_OUTVEC(ctrl_param)  ((ctrl_param) & NS_OUTVEC_BIT)
 
+#define PARAM_SET_INLINE_INVEC(ctrl_param) ((ctrl_param) | INLINE_INVEC_BIT)
+#define PARAM_IS_INLINE_INVEC(ctrl_param)  ((ctrl_param) & INLINE_INVEC_BIT)
+
 #define PARAM_HAS_IOVEC(ctrl_param)                                  \
           ((ctrl_param) != (uint32_t)PARAM_UNPACK_TYPE(ctrl_param))
 
+#if defined(CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX) && \
+    (CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX > 0)
+/*
+ * Input vectors of a call with an inline input vector. The payload of the
+ * first input vector is copied before the descriptors, so that the SPM checks
+ * them with one memory check instead of checking the payload on its own.
+ */
+struct tfm_psa_call_inline_t {
+    uint8_t data[CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX];
+    psa_invec in_vec[PSA_MAX_IOVEC];
+};
+
+/* Offset of the inline payload from the input vector descriptors */
+#define TFM_PSA_CALL_INLINE_OFFSET   offsetof(struct tfm_psa_call_inline_t, in_vec)
+#endif
+
 psa_status_t tfm_psa_call_pack(psa_handle_t handle,
                                uint32_t ctrl_param,
                                const psa_invec *in_vec,
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_SECURE_TIMER_API_H__
+#define __TFM_SECURE_TIMER_API_H__
+
+#include <stdint.h>
+#include "psa/client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief TFM secure partition Secure Timer API version
+ */
+#define TFM_SECURE_TIMER_API_VERSION_MAJOR (0)
+#define TFM_SECURE_TIMER_API_VERSION_MINOR (1)
+
+#define TFM_SECURE_TIMER_API_ID_START          (1001)
+#define TFM_SECURE_TIMER_API_ID_CANCEL         (1002)
+#define TFM_SECURE_TIMER_API_ID_GET_EXPIRED    (1003)
+
+/**
+ * \brief Number of timers of each Secure Partition, identified by 0 to 31
+ */
+#define TFM_SECURE_TIMER_ID_NUM                (32U)
+
+/**
+ * \brief Starts a timer of the calling Secure Partition, or restarts it if it
+ *        is running or expired. When it expires, the Secure Timer partition
+ *        asserts the PSA_DOORBELL signal of the caller, which then gets its
+ *        expired timers with tfm_secure_timer_get_expired().
+ *
+ * \param[in] timer_id    The timer, less than TFM_SECURE_TIMER_ID_NUM
+ * \param[in] ticks       The timeout in ticks of the secure timer of the
+ *                        platform, one tick at least
+ *
+ * \return PSA_SUCCESS if the timer is started.
+ *         PSA_ERROR_INVALID_ARGUMENT if the timer or the timeout is invalid.
+ *         PSA_ERROR_INSUFFICIENT_MEMORY if all the timers are in use.
+ */
+psa_status_t tfm_secure_timer_start(uint32_t timer_id, uint32_t ticks);
+
+/**
+ * \brief Stops a timer of the calling Secure Partition. Nothing is done if it
+ *        is not running.
+ *
+ * \param[in] timer_id    The timer, less than TFM_SECURE_TIMER_ID_NUM
+ *
+ * \return PSA_SUCCESS if the timer is stopped.
+ *         PSA_ERROR_INVALID_ARGUMENT if the timer is invalid.
+ */
+psa_status_t tfm_secure_timer_cancel(uint32_t timer_id);
+
+/**
+ * \brief Gets the timers of the calling Secure Partition which expired since
+ *        the last call, and frees them.
+ *
+ * \param[out] expired    Bitmap of the expired timers, bit n for timer n
+ *
+ * \return PSA_SUCCESS if the bitmap is written.
+ */
+psa_status_t tfm_secure_timer_get_expired(uint32_t *expired);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_SECURE_TIMER_API_H__ */
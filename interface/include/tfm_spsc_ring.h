@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Single producer, single consumer ring in memory shared by a producer and its
+ * consumer, for streaming data without a PSA call for each element. The
+ * producer only needs to notify the consumer, with psa_notify() when it is a
+ * Secure Partition, when an element is pushed into an empty ring. The consumer
+ * pops until the ring is empty before waiting for the next notification.
+ */
+
+#ifndef __TFM_SPSC_RING_H__
+#define __TFM_SPSC_RING_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "cmsis_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Size of a ring holding 'count' elements of 'elem_size' bytes */
+#define TFM_SPSC_RING_SIZE(elem_size, count)                           \
+          (sizeof(struct tfm_spsc_ring_t) + ((elem_size) * (count)))
+
+struct tfm_spsc_ring_t {
+    volatile uint32_t head;     /* Elements pushed, written by the producer */
+    volatile uint32_t tail;     /* Elements popped, written by the consumer */
+    uint32_t elem_size;         /* Size of an element in bytes              */
+    uint32_t mask;              /* Number of elements minus 1               */
+    uint8_t data[];             /* Elements                                 */
+};
+
+/**
+ * \brief Initializes an empty ring, before it is shared.
+ *
+ * \param[out] ring       The ring, of TFM_SPSC_RING_SIZE(elem_size, count)
+ *                        bytes.
+ * \param[in]  elem_size  Size of an element in bytes.
+ * \param[in]  count      Number of elements, which is a power of 2.
+ *
+ * \retval true           The ring is initialized.
+ * \retval false          The count is not a power of 2.
+ */
+static inline bool tfm_spsc_ring_init(struct tfm_spsc_ring_t *ring,
+                                      uint32_t elem_size, uint32_t count)
+{
+    if ((count == 0) || ((count & (count - 1)) != 0)) {
+        return false;
+    }
+
+    ring->head = 0;
+    ring->tail = 0;
+    ring->elem_size = elem_size;
+    ring->mask = count - 1;
+
+    return true;
+}
+
+/**
+ * \brief Pushes an element, by the producer.
+ *
+ * \param[in,out] ring       The ring.
+ * \param[in]     elem       The element, of the element size of the ring.
+ * \param[out]    notify     Set to true when the consumer may have found the
+ *                           ring empty and has to be notified, else false.
+ *
+ * \retval true              The element is pushed.
+ * \retval false             The ring is full.
+ */
+static inline bool tfm_spsc_ring_push(struct tfm_spsc_ring_t *ring,
+                                      const void *elem, bool *notify)
+{
+    uint32_t head = ring->head;
+
+    *notify = false;
+
+    if (head - ring->tail > ring->mask) {
+        return false;
+    }
+
+    memcpy(&ring->data[(head & ring->mask) * ring->elem_size], elem,
+           ring->elem_size);
+
+    /* The element is written before it is published */
+    __DMB();
+    ring->head = head + 1;
+
+    /*
+     * The consumer checks the head after updating the tail, so if it has
+     * popped every element before this one, it may have missed this one.
+     */
+    __DMB();
+    *notify = (ring->tail == head);
+
+    return true;
+}
+
+/**
+ * \brief Pops an element, by the consumer.
+ *
+ * \param[in,out] ring       The ring.
+ * \param[out]    elem       Buffer of the element size of the ring.
+ *
+ * \retval true              An element is popped.
+ * \retval false             The ring is empty, the consumer waits for the
+ *                           next notification.
+ */
+static inline bool tfm_spsc_ring_pop(struct tfm_spsc_ring_t *ring, void *elem)
+{
+    uint32_t tail = ring->tail;
+
+    /* The tail is written before the head is checked, see the producer */
+    __DMB();
+    if (ring->head == tail) {
+        return false;
+    }
+
+    /* The element is read after it is published */
+    __DMB();
+    memcpy(elem, &ring->data[(tail & ring->mask) * ring->elem_size],
+           ring->elem_size);
+
+    /* The element is read before its space is given back */
+    __DMB();
+    ring->tail = tail + 1;
+
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_SPSC_RING_H__ */
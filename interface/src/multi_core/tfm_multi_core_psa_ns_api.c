@@ -116,6 +116,63 @@ psa_status_t psa_call(psa_handle_t handle, int32_t type,
     return status;
 }
 
+#ifndef TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD
+psa_status_t tfm_ns_psa_call_submit(psa_handle_t handle, int32_t type,
+                                    const psa_invec *in_vec, size_t in_len,
+                                    psa_outvec *out_vec, size_t out_len,
+                                    uint32_t priority,
+                                    mailbox_ticket_t *ticket)
+{
+    struct psa_client_params_t params;
+    int32_t ret;
+
+    params.psa_call_params.handle = handle;
+    params.psa_call_params.type = type;
+    params.psa_call_params.in_vec = in_vec;
+    params.psa_call_params.in_len = in_len;
+    params.psa_call_params.out_vec = out_vec;
+    params.psa_call_params.out_len = out_len;
+
+    ret = tfm_ns_mailbox_client_call_submit(MAILBOX_PSA_CALL, &params,
+                                            NON_SECURE_CLIENT_ID, priority,
+                                            ticket);
+    if (ret != MAILBOX_SUCCESS) {
+        return PSA_INTER_CORE_COMM_ERR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+bool tfm_ns_psa_call_poll(mailbox_ticket_t ticket, psa_status_t *status)
+{
+    int32_t ret;
+
+    ret = tfm_ns_mailbox_client_call_poll(ticket, (int32_t *)status);
+    if (ret == MAILBOX_NO_PEND_EVENT) {
+        return false;
+    }
+
+    if (ret != MAILBOX_SUCCESS) {
+        *status = PSA_INTER_CORE_COMM_ERR;
+    }
+
+    return true;
+}
+
+psa_status_t tfm_ns_psa_call_wait(mailbox_ticket_t ticket)
+{
+    psa_status_t status;
+    int32_t ret;
+
+    ret = tfm_ns_mailbox_client_call_wait(ticket, (int32_t *)&status);
+    if (ret != MAILBOX_SUCCESS) {
+        status = PSA_INTER_CORE_COMM_ERR;
+    }
+
+    return status;
+}
+#endif /* TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD */
+
 void psa_close(psa_handle_t handle)
 {
     struct psa_client_params_t params;
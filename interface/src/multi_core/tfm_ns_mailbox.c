@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2024 Cypress Semiconductor Corporation (an Infineon company)
  * or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
  *
@@ -17,14 +17,51 @@
 /* The pointer to NSPE mailbox queue */
 static struct ns_mailbox_queue_t *mailbox_queue_ptr = NULL;
 
-static int32_t mailbox_wait_reply(uint8_t idx);
+/* Buffer pool registered before NSPE mailbox initialization */
+static void *shm_pool_base = NULL;
+static uint32_t shm_pool_size = 0;
+
+#if defined(TFM_MULTI_CORE_NS_OS) && (TFM_MULTI_CORE_NS_OS_WAIT_SPIN > 0)
+/*
+ * Polls a reply took to arrive, averaged per service. The services are hashed
+ * into the table by SID, or by handle and type for psa_call(), which stands
+ * for the service and its operation.
+ */
+#define SPIN_HIST_SIZE          16
+/* Polls tried on a call to a service which last blocked, to keep learning */
+#define SPIN_MIN                8
+
+static uint32_t spin_hist[SPIN_HIST_SIZE];
 
-static inline void set_queue_slot_empty(uint8_t idx)
+static uint8_t spin_hist_index(uint32_t call_type,
+                               const struct psa_client_params_t *params)
 {
-    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        mailbox_queue_ptr->empty_slots |= (1UL << idx);
+    uint32_t key;
+
+    switch (call_type) {
+    case MAILBOX_PSA_VERSION:
+        key = params->psa_version_params.sid;
+        break;
+    case MAILBOX_PSA_CONNECT:
+        key = params->psa_connect_params.sid;
+        break;
+    case MAILBOX_PSA_CALL:
+        key = (uint32_t)params->psa_call_params.handle ^
+              ((uint32_t)params->psa_call_params.type << 8);
+        break;
+    default:
+        key = call_type;
+        break;
     }
+
+    key ^= key >> 16;
+    key ^= key >> 8;
+
+    return (uint8_t)(key % SPIN_HIST_SIZE);
 }
+#endif
+
+static int32_t mailbox_wait_reply(uint8_t idx);
 
 static inline void set_queue_slot_woken(uint8_t idx)
 {
@@ -52,47 +89,60 @@ static inline void clear_queue_slot_woken(uint8_t idx)
 #ifndef TFM_MULTI_CORE_NS_OS
 static inline void clear_queue_slot_replied(uint8_t idx)
 {
+    struct mailbox_status_t *status = &mailbox_queue_ptr->status;
+
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        mailbox_queue_ptr->status.replied_slots &= ~(1UL << idx);
+        status->replied_slots &= ~(1UL << idx);
+        tfm_ns_mailbox_hal_cache_clean(status->replied_lines,
+                                       sizeof(status->replied_lines));
     }
 }
 
 static inline bool is_queue_slot_replied(uint8_t idx)
 {
+    struct mailbox_status_t *status = &mailbox_queue_ptr->status;
+
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        return mailbox_queue_ptr->status.replied_slots & (1UL << idx);
+        tfm_ns_mailbox_hal_cache_invalidate(status->replied_lines,
+                                            sizeof(status->replied_lines));
+        return status->replied_slots & (1UL << idx);
     }
 
     return false;
 }
 #endif /* !defined TFM_MULTI_CORE_NS_OS */
 
-static uint8_t acquire_empty_slot(struct ns_mailbox_queue_t *queue)
+#if MAILBOX_EVENT_POLL_SPIN > 0
+/*
+ * SPE polls for requests with WFE for a while after a burst. An event wakes it
+ * up then, without the mailbox interrupt.
+ */
+static void mailbox_notify_peer(void)
 {
-    uint8_t idx;
-    mailbox_queue_status_t status;
-
-    tfm_ns_mailbox_os_spin_lock();
-    status = queue->empty_slots;
-    tfm_ns_mailbox_os_spin_unlock();
-
-    if (!status) {
-        /* No empty slot */
-        return NUM_MAILBOX_QUEUE_SLOT;
-    }
-
-    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
-        if (status & (1 << idx)) {
-            break;
-        }
+    struct mailbox_status_t *status = &mailbox_queue_ptr->status;
+
+    /* The pending status is written before the polling flag is read */
+    __DMB();
+
+    tfm_ns_mailbox_hal_cache_invalidate(status->polling_lines,
+                                        sizeof(status->polling_lines));
+    if (status->spe_polling) {
+        __DSB();
+        __SEV();
+    } else {
+        tfm_ns_mailbox_hal_notify_peer();
     }
-
-    tfm_ns_mailbox_os_spin_lock();
-    clear_queue_slot_empty(queue, idx);
-    tfm_ns_mailbox_os_spin_unlock();
-
-    return idx;
 }
+#else
+#define mailbox_notify_peer()           tfm_ns_mailbox_hal_notify_peer()
+#endif
+
+/*
+ * A ticket holds the slot index plus 1 in its low bits and the generation of
+ * the slot above, so that it stops matching the slot once the call completes.
+ */
+#define TICKET_SLOT_BITS                8U
+#define TICKET_SLOT_MASK                ((1UL << TICKET_SLOT_BITS) - 1)
 
 static void set_msg_owner(uint8_t idx, const void *owner)
 {
@@ -104,13 +154,14 @@ static void set_msg_owner(uint8_t idx, const void *owner)
 static int32_t mailbox_tx_client_req(uint32_t call_type,
                                      const struct psa_client_params_t *params,
                                      int32_t client_id,
+                                     uint32_t priority,
                                      uint8_t *slot_idx)
 {
     uint8_t idx;
     struct mailbox_msg_t *msg_ptr;
     const void *task_handle;
 
-    idx = acquire_empty_slot(mailbox_queue_ptr);
+    idx = claim_queue_slot_empty(mailbox_queue_ptr);
     if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
         return MAILBOX_QUEUE_FULL;
     }
@@ -125,6 +176,11 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
     msg_ptr->call_type = call_type;
     memcpy(&msg_ptr->params, params, sizeof(msg_ptr->params));
     msg_ptr->client_id = client_id;
+    msg_ptr->priority = priority;
+
+    /* Only the lines of the message are cleaned, before it is pending */
+    tfm_ns_mailbox_hal_cache_clean(mailbox_queue_ptr->slots[idx].msg_lines,
+                            sizeof(mailbox_queue_ptr->slots[idx].msg_lines));
 
     /*
      * Fetch the current task handle. The task will be woken up according the
@@ -132,12 +188,18 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
      */
     task_handle = tfm_ns_mailbox_os_get_task_handle();
     set_msg_owner(idx, task_handle);
+    mailbox_queue_ptr->slots_ns[idx].generation++;
+
+#if defined(TFM_MULTI_CORE_NS_OS) && (TFM_MULTI_CORE_NS_OS_WAIT_SPIN > 0)
+    mailbox_queue_ptr->slots_ns[idx].spin_hist = spin_hist_index(call_type,
+                                                                 params);
+#endif
 
     tfm_ns_mailbox_hal_enter_critical();
     set_queue_slot_pend(mailbox_queue_ptr, idx);
     tfm_ns_mailbox_hal_exit_critical();
 
-    tfm_ns_mailbox_hal_notify_peer();
+    mailbox_notify_peer();
 
     *slot_idx = idx;
 
@@ -146,19 +208,27 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
 
 static int32_t mailbox_rx_client_reply(uint8_t idx, int32_t *reply)
 {
-    *reply = mailbox_queue_ptr->slots[idx].reply.return_val;
+    struct mailbox_slot_t *slot = &mailbox_queue_ptr->slots[idx];
+
+    tfm_ns_mailbox_hal_cache_invalidate(slot->reply_lines,
+                                        sizeof(slot->reply_lines));
+    *reply = slot->reply.return_val;
 
     /* Clear up the owner field */
     set_msg_owner(idx, NULL);
 
+#if NS_MAILBOX_SLOT_LOCK_FREE == 0
     tfm_ns_mailbox_os_spin_lock();
+#endif
     clear_queue_slot_woken(idx);
     /*
      * Make sure that the empty flag is set after all the other status flags are
      * re-initialized.
      */
-    set_queue_slot_empty(idx);
+    set_queue_slots_empty(mailbox_queue_ptr, 1UL << idx);
+#if NS_MAILBOX_SLOT_LOCK_FREE == 0
     tfm_ns_mailbox_os_spin_unlock();
+#endif
 
     return MAILBOX_SUCCESS;
 }
@@ -168,42 +238,65 @@ int32_t tfm_ns_mailbox_client_call(uint32_t call_type,
                                    int32_t client_id,
                                    int32_t *reply)
 {
-    uint8_t slot_idx = NUM_MAILBOX_QUEUE_SLOT;
+    mailbox_ticket_t ticket;
     int32_t reply_buf = 0x0;
     int32_t ret;
 
+    if (!reply) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    ret = tfm_ns_mailbox_client_call_submit(call_type, params, client_id,
+                                            MAILBOX_PRIO_NORMAL, &ticket);
+    if (ret != MAILBOX_SUCCESS) {
+        return ret;
+    }
+
+    ret = tfm_ns_mailbox_client_call_wait(ticket, &reply_buf);
+    if (ret == MAILBOX_SUCCESS) {
+        *reply = reply_buf;
+    }
+
+    return ret;
+}
+
+int32_t tfm_ns_mailbox_client_call_submit(uint32_t call_type,
+                                     const struct psa_client_params_t *params,
+                                     int32_t client_id,
+                                     uint32_t priority,
+                                     mailbox_ticket_t *ticket)
+{
+    uint8_t slot_idx = NUM_MAILBOX_QUEUE_SLOT;
+    int32_t ret;
+
     if (!mailbox_queue_ptr) {
         return MAILBOX_INIT_ERROR;
     }
 
-    if (!params || !reply) {
+    if (!params || !ticket || (priority >= MAILBOX_PRIO_NUM)) {
         return MAILBOX_INVAL_PARAMS;
     }
 
+    /* The lock is held until the call is completed via the ticket */
     if (tfm_ns_mailbox_os_lock_acquire() != MAILBOX_SUCCESS) {
         return MAILBOX_QUEUE_FULL;
     }
 
     /* It requires SVCall if NS mailbox is put in privileged mode. */
-    ret = mailbox_tx_client_req(call_type, params, client_id, &slot_idx);
+    ret = mailbox_tx_client_req(call_type, params, client_id, priority,
+                                &slot_idx);
     if (ret != MAILBOX_SUCCESS) {
-        goto exit;
-    }
-
-    mailbox_wait_reply(slot_idx);
-
-    /* It requires SVCall if NS mailbox is put in privileged mode. */
-    ret = mailbox_rx_client_reply(slot_idx, &reply_buf);
-    if (ret == MAILBOX_SUCCESS) {
-        *reply = reply_buf;
+        if (tfm_ns_mailbox_os_lock_release() != MAILBOX_SUCCESS) {
+            return MAILBOX_GENERIC_ERROR;
+        }
+        return ret;
     }
 
-exit:
-    if (tfm_ns_mailbox_os_lock_release() != MAILBOX_SUCCESS) {
-        return MAILBOX_GENERIC_ERROR;
-    }
+    *ticket = (mailbox_ticket_t)
+              (((uint32_t)mailbox_queue_ptr->slots_ns[slot_idx].generation
+                << TICKET_SLOT_BITS) | (slot_idx + 1U));
 
-    return ret;
+    return MAILBOX_SUCCESS;
 }
 
 #ifdef TFM_MULTI_CORE_NS_OS
@@ -283,10 +376,52 @@ static inline bool mailbox_wait_reply_signal(uint8_t idx)
 }
 #endif /* TFM_MULTI_CORE_NS_OS */
 
+#if defined(TFM_MULTI_CORE_NS_OS) && (TFM_MULTI_CORE_NS_OS_WAIT_SPIN > 0)
+/*
+ * Polls the reply for up to twice the average latency of the service, so that
+ * a short call is not delayed by blocking and waking up the thread. A service
+ * whose call did not complete in the window has its average lowered, so that
+ * long calls soon block at once.
+ */
+static bool mailbox_spin_reply(uint8_t idx)
+{
+    uint32_t *avg = &spin_hist[mailbox_queue_ptr->slots_ns[idx].spin_hist];
+    uint32_t window = 2 * *avg + SPIN_MIN;
+    uint32_t i;
+
+    if (window > TFM_MULTI_CORE_NS_OS_WAIT_SPIN) {
+        window = TFM_MULTI_CORE_NS_OS_WAIT_SPIN;
+    }
+
+    for (i = 0; i < window; i++) {
+        if (*(volatile bool *)&mailbox_queue_ptr->slots_ns[idx].is_woken &&
+            mailbox_wait_reply_signal(idx)) {
+            /* Moving average of 1/4 weight */
+            *avg = *avg - (*avg / 4) + (i / 4);
+            return true;
+        }
+    }
+
+    *avg -= *avg / 4;
+
+    return false;
+}
+#endif
+
 static int32_t mailbox_wait_reply(uint8_t idx)
 {
     bool is_replied;
 
+#if defined(TFM_MULTI_CORE_NS_OS) && (TFM_MULTI_CORE_NS_OS_WAIT_SPIN > 0)
+    /*
+     * The wake-up sent to the thread when the reply arrived during the spin
+     * is consumed as a spurious one by the next wait.
+     */
+    if (mailbox_spin_reply(idx)) {
+        return MAILBOX_SUCCESS;
+    }
+#endif
+
     while (1) {
         tfm_ns_mailbox_os_wait_reply();
 
@@ -310,6 +445,114 @@ static int32_t mailbox_wait_reply(uint8_t idx)
     return MAILBOX_SUCCESS;
 }
 
+static int32_t get_ticket_slot_idx(mailbox_ticket_t ticket, uint8_t *idx)
+{
+    uint32_t slot = (uint32_t)ticket & TICKET_SLOT_MASK;
+    const struct ns_mailbox_slot_t *slot_ns;
+
+    if ((ticket <= MAILBOX_TICKET_NULL) || (slot == 0) ||
+        (slot > NUM_MAILBOX_QUEUE_SLOT)) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    *idx = (uint8_t)(slot - 1);
+    slot_ns = &mailbox_queue_ptr->slots_ns[*idx];
+
+    /*
+     * The slot must still be owned by the call of the ticket, submitted by
+     * the calling task.
+     */
+    if ((mailbox_queue_ptr->empty_slots & (1UL << *idx)) ||
+        (slot_ns->generation !=
+         ((uint32_t)ticket >> TICKET_SLOT_BITS)) ||
+        (slot_ns->owner != tfm_ns_mailbox_os_get_task_handle())) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+
+static int32_t mailbox_complete_client_call(uint8_t idx, int32_t *reply)
+{
+    int32_t ret;
+
+    /* It requires SVCall if NS mailbox is put in privileged mode. */
+    ret = mailbox_rx_client_reply(idx, reply);
+
+    if (tfm_ns_mailbox_os_lock_release() != MAILBOX_SUCCESS) {
+        return MAILBOX_GENERIC_ERROR;
+    }
+
+    return ret;
+}
+
+int32_t tfm_ns_mailbox_client_call_poll(mailbox_ticket_t ticket,
+                                        int32_t *reply)
+{
+    uint8_t idx;
+    int32_t ret;
+
+    if (!mailbox_queue_ptr) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    if (!reply) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    ret = get_ticket_slot_idx(ticket, &idx);
+    if (ret != MAILBOX_SUCCESS) {
+        return ret;
+    }
+
+    if (!mailbox_wait_reply_signal(idx)) {
+        return MAILBOX_NO_PEND_EVENT;
+    }
+
+    return mailbox_complete_client_call(idx, reply);
+}
+
+int32_t tfm_ns_mailbox_client_call_wait(mailbox_ticket_t ticket,
+                                        int32_t *reply)
+{
+    uint8_t idx;
+    int32_t ret;
+
+    if (!mailbox_queue_ptr) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    if (!reply) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    ret = get_ticket_slot_idx(ticket, &idx);
+    if (ret != MAILBOX_SUCCESS) {
+        return ret;
+    }
+
+    mailbox_wait_reply(idx);
+
+    return mailbox_complete_client_call(idx, reply);
+}
+
+int32_t tfm_ns_mailbox_register_shm_pool(void *base, uint32_t size)
+{
+    /* The pool is passed to SPE only once, during initialization */
+    if (mailbox_queue_ptr) {
+        return MAILBOX_GENERIC_ERROR;
+    }
+
+    if (!base || !size) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    shm_pool_base = base;
+    shm_pool_size = size;
+
+    return MAILBOX_SUCCESS;
+}
+
 int32_t tfm_ns_mailbox_init(struct ns_mailbox_queue_t *queue)
 {
     int32_t ret;
@@ -324,6 +567,10 @@ int32_t tfm_ns_mailbox_init(struct ns_mailbox_queue_t *queue)
      */
 
     memset(queue, 0, sizeof(*queue));
+    tfm_ns_mailbox_hal_cache_clean(&queue->status, sizeof(queue->status));
+
+    queue->shm_base = shm_pool_base;
+    queue->shm_size = shm_pool_size;
 
     /* Initialize empty bitmask */
     queue->empty_slots =
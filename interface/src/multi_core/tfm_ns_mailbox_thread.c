@@ -52,11 +52,6 @@ static const void *ns_mailbox_thread_handle = NULL;
 /* The pointer to NSPE mailbox queue */
 static struct ns_mailbox_queue_t *mailbox_queue_ptr = NULL;
 
-static inline void set_queue_slot_all_empty(mailbox_queue_status_t completed)
-{
-    mailbox_queue_ptr->empty_slots |= completed;
-}
-
 static inline void set_queue_slot_woken(uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
@@ -67,15 +62,11 @@ static inline void set_queue_slot_woken(uint8_t idx)
 static uint8_t acquire_empty_slot(struct ns_mailbox_queue_t *queue)
 {
     uint8_t idx;
-    mailbox_queue_status_t status;
 
     while (1) {
-        tfm_ns_mailbox_os_spin_lock();
-        status = queue->empty_slots;
-        tfm_ns_mailbox_os_spin_unlock();
-
-        if (status) {
-            break;
+        idx = claim_queue_slot_empty(queue);
+        if (idx < NUM_MAILBOX_QUEUE_SLOT) {
+            return idx;
         }
 
         /* No empty slot */
@@ -87,18 +78,6 @@ static uint8_t acquire_empty_slot(struct ns_mailbox_queue_t *queue)
         tfm_ns_mailbox_os_wait_reply();
         queue->is_full = false;
     }
-
-    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
-        if (status & (1 << idx)) {
-            break;
-        }
-    }
-
-    tfm_ns_mailbox_os_spin_lock();
-    clear_queue_slot_empty(queue, idx);
-    tfm_ns_mailbox_os_spin_unlock();
-
-    return idx;
 }
 
 static int32_t mailbox_tx_client_call_msg(const struct ns_mailbox_req_t *req,
@@ -122,6 +101,7 @@ static int32_t mailbox_tx_client_call_msg(const struct ns_mailbox_req_t *req,
     msg_ptr->call_type = req->call_type;
     memcpy(&msg_ptr->params, req->params_ptr, sizeof(msg_ptr->params));
     msg_ptr->client_id = req->client_id;
+    msg_ptr->priority = MAILBOX_PRIO_NORMAL;
 
     /* Prepare the reply structure */
     reply_ptr = &mailbox_queue_ptr->queue[idx].reply;
@@ -289,7 +269,7 @@ int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
         }
     }
 
-    set_queue_slot_all_empty(complete_slots);
+    set_queue_slots_empty(mailbox_queue_ptr, complete_slots);
 
     /*
      * Wake up the NS mailbox thread in case it is waiting for
@@ -20,6 +20,14 @@
 
 /**
  * \brief the ns_lock ID
+ *
+ * \note A single lock is shared by all the NS threads, even if they hold
+ *       different NS client contexts or target different partitions. SPE
+ *       handles one NS secure call at a time: the call is not complete until
+ *       the NS agent thread is scheduled back, and a second call entering SPE
+ *       meanwhile would run on behalf of whichever secure thread was
+ *       preempted. Per thread NS client contexts only identify the caller,
+ *       they do not allow secure calls to overlap.
  */
 static void *ns_lock_handle = NULL;
 
@@ -37,6 +37,34 @@ psa_initial_attest_get_token(const uint8_t *auth_challenge,
     return status;
 }
 
+psa_status_t
+tfm_initial_attest_get_tokens(const uint8_t *auth_challenges,
+                              size_t         challenge_size,
+                              size_t         challenge_count,
+                              uint8_t       *token_buf,
+                              size_t         token_buf_size,
+                              size_t        *token_sizes)
+{
+    if (challenge_size > PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64 ||
+        challenge_count == 0 ||
+        challenge_count > TFM_ATTEST_GET_TOKENS_MAX_CHALLENGES) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    psa_invec in_vec[] = {
+        {&challenge_size, sizeof(challenge_size)},
+        {auth_challenges, challenge_size * challenge_count}
+    };
+    psa_outvec out_vec[] = {
+        {token_buf, token_buf_size},
+        {token_sizes, challenge_count * sizeof(size_t)}
+    };
+
+    return psa_call(TFM_ATTESTATION_SERVICE_HANDLE, TFM_ATTEST_GET_TOKENS,
+                    in_vec, IOVEC_LEN(in_vec),
+                    out_vec, IOVEC_LEN(out_vec));
+}
+
 psa_status_t
 psa_initial_attest_get_token_size(size_t  challenge_size,
                                   size_t *token_size)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -55,6 +55,164 @@
 #define TFM_CRYPTO_API(ret, fun) ret fun
 #endif /* CONFIG_TFM_CRYPTO_API_RENAME */
 
+/*!
+ * \def CONFIG_TFM_CRYPTO_API_COALESCE_UPDATES
+ *
+ * \brief By setting this to 1, the updates of multipart hash and MAC
+ *        operations shorter than CONFIG_TFM_CRYPTO_API_COALESCE_SIZE bytes are
+ *        gathered in a client side buffer, and sent to the Crypto service in a
+ *        single request when the buffer is full, or before any other request on
+ *        the operation. Clients which feed many small chunks, such as TLS
+ *        record or CBOR encoding, save a secure call for each chunk.
+ *        CONFIG_TFM_CRYPTO_API_COALESCE_SLOTS operations are buffered at once,
+ *        the updates of the others are sent as they come.
+ *
+ * \note  An error of a buffered update is returned by the call which sends it,
+ *        the next update, finish, verify or clone of the operation. The
+ *        buffers are shared by all the threads of the client without locking,
+ *        so the calls to the multipart hash and MAC APIs must be serialized by
+ *        the client when it is enabled.
+ *
+ * \note  This config option is not available through the TF-M configuration as
+ *        it's for NS applications and system integrators to enable.
+ */
+
+#if CONFIG_TFM_CRYPTO_API_COALESCE_UPDATES == 1
+#ifndef CONFIG_TFM_CRYPTO_API_COALESCE_SIZE
+#define CONFIG_TFM_CRYPTO_API_COALESCE_SIZE  256
+#endif
+
+#ifndef CONFIG_TFM_CRYPTO_API_COALESCE_SLOTS
+#define CONFIG_TFM_CRYPTO_API_COALESCE_SLOTS 2
+#endif
+
+struct update_buf_t {
+    uint32_t op_handle;   /* Handle of the operation, 0 if the slot is free */
+    uint16_t function_id; /* Update function of the operation */
+    size_t len;           /* Number of bytes buffered */
+    uint8_t data[CONFIG_TFM_CRYPTO_API_COALESCE_SIZE];
+};
+
+static struct update_buf_t update_bufs[CONFIG_TFM_CRYPTO_API_COALESCE_SLOTS];
+#endif /* CONFIG_TFM_CRYPTO_API_COALESCE_UPDATES == 1 */
+
+static psa_status_t update_dispatch(uint16_t function_id, uint32_t op_handle,
+                                    const uint8_t *input, size_t input_length)
+{
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = function_id,
+        .op_handle = op_handle,
+    };
+
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+        {.base = input, .len = input_length},
+    };
+
+    return API_DISPATCH_NO_OUTVEC(in_vec);
+}
+
+#if CONFIG_TFM_CRYPTO_API_COALESCE_UPDATES == 1
+static struct update_buf_t *update_buf_find(uint32_t op_handle)
+{
+    uint32_t i;
+
+    for (i = 0; i < CONFIG_TFM_CRYPTO_API_COALESCE_SLOTS; i++) {
+        if (update_bufs[i].op_handle == op_handle) {
+            return &update_bufs[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Sends the buffered input of an operation, and frees its slot */
+static psa_status_t update_flush(uint32_t op_handle)
+{
+    struct update_buf_t *buf;
+    psa_status_t status = PSA_SUCCESS;
+
+    if (op_handle == 0) {
+        return PSA_SUCCESS;
+    }
+
+    buf = update_buf_find(op_handle);
+    if (buf == NULL) {
+        return PSA_SUCCESS;
+    }
+
+    if (buf->len != 0) {
+        status = update_dispatch(buf->function_id, op_handle,
+                                 buf->data, buf->len);
+    }
+
+    buf->op_handle = 0;
+    buf->len = 0;
+
+    return status;
+}
+
+/* Drops the buffered input of an aborted operation */
+static void update_discard(uint32_t op_handle)
+{
+    struct update_buf_t *buf;
+
+    if (op_handle == 0) {
+        return;
+    }
+
+    buf = update_buf_find(op_handle);
+    if (buf != NULL) {
+        buf->op_handle = 0;
+        buf->len = 0;
+    }
+}
+
+static psa_status_t update_coalesce(uint16_t function_id, uint32_t op_handle,
+                                    const uint8_t *input, size_t input_length)
+{
+    struct update_buf_t *buf = NULL;
+    psa_status_t status;
+
+    /* Invalid handles are left to the service to report */
+    if (op_handle == 0) {
+        return update_dispatch(function_id, op_handle, input, input_length);
+    }
+
+    buf = update_buf_find(op_handle);
+    if ((buf != NULL) &&
+        (input_length > CONFIG_TFM_CRYPTO_API_COALESCE_SIZE - buf->len)) {
+        status = update_flush(op_handle);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+        buf = NULL;
+    }
+
+    if ((buf == NULL) && (input_length < CONFIG_TFM_CRYPTO_API_COALESCE_SIZE)) {
+        buf = update_buf_find(0);
+        if (buf != NULL) {
+            buf->op_handle = op_handle;
+            buf->function_id = function_id;
+        }
+    }
+
+    if (buf == NULL) {
+        return update_dispatch(function_id, op_handle, input, input_length);
+    }
+
+    memcpy(buf->data + buf->len, input, input_length);
+    buf->len += input_length;
+
+    return PSA_SUCCESS;
+}
+#else
+#define update_flush(op_handle)   PSA_SUCCESS
+#define update_discard(op_handle)
+#define update_coalesce(function_id, op_handle, input, input_length) \
+    update_dispatch(function_id, op_handle, input, input_length)
+#endif /* CONFIG_TFM_CRYPTO_API_COALESCE_UPDATES == 1 */
+
 TFM_CRYPTO_API(psa_status_t, psa_crypto_init)(void)
 {
     /* Service init is performed during TFM boot up,
@@ -226,6 +384,42 @@ TFM_CRYPTO_API(psa_status_t, psa_copy_key)(psa_key_id_t source_key,
     return API_DISPATCH(in_vec, out_vec);
 }
 
+psa_status_t tfm_crypto_key_share(psa_key_id_t key,
+                                  int32_t partition_id,
+                                  psa_key_id_t *shared_key)
+{
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_SHARE_KEY_SID,
+        .key_id = key,
+    };
+
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+        {.base = &partition_id, .len = sizeof(int32_t)},
+    };
+
+    psa_outvec out_vec[] = {
+        {.base = shared_key, .len = sizeof(psa_key_id_t)},
+    };
+
+    return API_DISPATCH(in_vec, out_vec);
+}
+
+psa_status_t tfm_crypto_key_unshare(psa_key_id_t key, int32_t partition_id)
+{
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_UNSHARE_KEY_SID,
+        .key_id = key,
+    };
+
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+        {.base = &partition_id, .len = sizeof(int32_t)},
+    };
+
+    return API_DISPATCH_NO_OUTVEC(in_vec);
+}
+
 TFM_CRYPTO_API(psa_status_t, psa_cipher_generate_iv)(psa_cipher_operation_t *operation,
                                                      unsigned char *iv,
                                                      size_t iv_size,
@@ -404,17 +598,8 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_update)(psa_hash_operation_t *operation,
                                               const uint8_t *input,
                                               size_t input_length)
 {
-    struct tfm_crypto_pack_iovec iov = {
-        .function_id = TFM_CRYPTO_HASH_UPDATE_SID,
-        .op_handle = operation->handle,
-    };
-
-    psa_invec in_vec[] = {
-        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
-        {.base = input, .len = input_length},
-    };
-
-    return API_DISPATCH_NO_OUTVEC(in_vec);
+    return update_coalesce(TFM_CRYPTO_HASH_UPDATE_SID, operation->handle,
+                           input, input_length);
 }
 
 TFM_CRYPTO_API(psa_status_t, psa_hash_finish)(psa_hash_operation_t *operation,
@@ -436,6 +621,12 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_finish)(psa_hash_operation_t *operation,
         {.base = hash, .len = hash_size},
     };
 
+    status = update_flush(operation->handle);
+    if (status != PSA_SUCCESS) {
+        *hash_length = 0;
+        return status;
+    }
+
     status = API_DISPATCH(in_vec, out_vec);
 
     *hash_length = out_vec[1].len;
@@ -447,6 +638,7 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_verify)(psa_hash_operation_t *operation,
                                               const uint8_t *hash,
                                               size_t hash_length)
 {
+    psa_status_t status;
     struct tfm_crypto_pack_iovec iov = {
         .function_id = TFM_CRYPTO_HASH_VERIFY_SID,
         .op_handle = operation->handle,
@@ -460,6 +652,11 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_verify)(psa_hash_operation_t *operation,
         {.base = &(operation->handle), .len = sizeof(uint32_t)},
     };
 
+    status = update_flush(operation->handle);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
     return API_DISPATCH(in_vec, out_vec);
 }
 
@@ -477,12 +674,15 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_abort)(psa_hash_operation_t *operation)
         {.base = &(operation->handle), .len = sizeof(uint32_t)},
     };
 
+    update_discard(operation->handle);
+
     return API_DISPATCH(in_vec, out_vec);
 }
 
 TFM_CRYPTO_API(psa_status_t, psa_hash_clone)(const psa_hash_operation_t *source_operation,
                                              psa_hash_operation_t *target_operation)
 {
+    psa_status_t status;
     struct tfm_crypto_pack_iovec iov = {
         .function_id = TFM_CRYPTO_HASH_CLONE_SID,
         .op_handle = source_operation->handle,
@@ -502,9 +702,46 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_clone)(const psa_hash_operation_t *source_
          .len = sizeof(target_operation->handle)},
     };
 
+    /* The clone starts from all the input given to the source */
+    status = update_flush(source_operation->handle);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
     return API_DISPATCH(in_vec, out_vec);
 }
 
+psa_status_t tfm_crypto_hash_finish_snapshot(const psa_hash_operation_t *operation,
+                                             uint8_t *hash,
+                                             size_t hash_size,
+                                             size_t *hash_length)
+{
+    psa_status_t status;
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_HASH_FINISH_SNAPSHOT_SID,
+        .op_handle = operation->handle,
+    };
+
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+    };
+    psa_outvec out_vec[] = {
+        {.base = hash, .len = hash_size},
+    };
+
+    status = update_flush(operation->handle);
+    if (status != PSA_SUCCESS) {
+        *hash_length = 0;
+        return status;
+    }
+
+    status = API_DISPATCH(in_vec, out_vec);
+
+    *hash_length = out_vec[0].len;
+
+    return status;
+}
+
 TFM_CRYPTO_API(psa_status_t, psa_hash_compute)(psa_algorithm_t alg,
                                                const uint8_t *input,
                                                size_t input_length,
@@ -600,17 +837,8 @@ TFM_CRYPTO_API(psa_status_t, psa_mac_update)(psa_mac_operation_t *operation,
                                              const uint8_t *input,
                                              size_t input_length)
 {
-    struct tfm_crypto_pack_iovec iov = {
-        .function_id = TFM_CRYPTO_MAC_UPDATE_SID,
-        .op_handle = operation->handle,
-    };
-
-    psa_invec in_vec[] = {
-        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
-        {.base = input, .len = input_length},
-    };
-
-    return API_DISPATCH_NO_OUTVEC(in_vec);
+    return update_coalesce(TFM_CRYPTO_MAC_UPDATE_SID, operation->handle,
+                           input, input_length);
 }
 
 TFM_CRYPTO_API(psa_status_t, psa_mac_sign_finish)(psa_mac_operation_t *operation,
@@ -632,6 +860,12 @@ TFM_CRYPTO_API(psa_status_t, psa_mac_sign_finish)(psa_mac_operation_t *operation
         {.base = mac, .len = mac_size},
     };
 
+    status = update_flush(operation->handle);
+    if (status != PSA_SUCCESS) {
+        *mac_length = 0;
+        return status;
+    }
+
     status = API_DISPATCH(in_vec, out_vec);
 
     *mac_length = out_vec[1].len;
@@ -643,6 +877,7 @@ TFM_CRYPTO_API(psa_status_t, psa_mac_verify_finish)(psa_mac_operation_t *operati
                                                     const uint8_t *mac,
                                                     size_t mac_length)
 {
+    psa_status_t status;
     struct tfm_crypto_pack_iovec iov = {
         .function_id = TFM_CRYPTO_MAC_VERIFY_FINISH_SID,
         .op_handle = operation->handle,
@@ -656,6 +891,11 @@ TFM_CRYPTO_API(psa_status_t, psa_mac_verify_finish)(psa_mac_operation_t *operati
         {.base = &(operation->handle), .len = sizeof(uint32_t)},
     };
 
+    status = update_flush(operation->handle);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
     return API_DISPATCH(in_vec, out_vec);
 }
 
@@ -673,6 +913,8 @@ TFM_CRYPTO_API(psa_status_t, psa_mac_abort)(psa_mac_operation_t *operation)
         {.base = &(operation->handle), .len = sizeof(uint32_t)},
     };
 
+    update_discard(operation->handle);
+
     return API_DISPATCH(in_vec, out_vec);
 }
 
@@ -1690,3 +1932,51 @@ TFM_CRYPTO_API(void, psa_reset_key_attributes)(
 {
     memset(attributes, 0, sizeof(*attributes));
 }
+
+psa_status_t tfm_crypto_batch_call(const struct tfm_crypto_batch_op ops[],
+                                   size_t op_count,
+                                   const void *in_buf,
+                                   size_t in_buf_len,
+                                   struct tfm_crypto_batch_result results[],
+                                   void *out_buf,
+                                   size_t out_buf_len)
+{
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_BATCH_SID,
+    };
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+        {.base = ops, .len = op_count * sizeof(struct tfm_crypto_batch_op)},
+        {.base = in_buf, .len = in_buf_len},
+    };
+    psa_outvec out_vec[] = {
+        {.base = results,
+         .len = op_count * sizeof(struct tfm_crypto_batch_result)},
+        {.base = out_buf, .len = out_buf_len},
+    };
+
+    return API_DISPATCH(in_vec, out_vec);
+}
+
+psa_status_t tfm_crypto_stats_log(void)
+{
+    return psa_call(TFM_CRYPTO_HANDLE, TFM_CRYPTO_STATS_LOG,
+                    NULL, 0, NULL, 0);
+}
+
+psa_status_t tfm_crypto_random_pool_clear(void)
+{
+    return psa_call(TFM_CRYPTO_HANDLE, TFM_CRYPTO_RNG_POOL_CLEAR,
+                    NULL, 0, NULL, 0);
+}
+
+psa_status_t tfm_crypto_sign_precompute(psa_ecc_family_t curve, size_t bits)
+{
+    psa_invec in_vec[] = {
+        {.base = &curve, .len = sizeof(curve)},
+        {.base = &bits, .len = sizeof(bits)},
+    };
+
+    return psa_call(TFM_CRYPTO_HANDLE, TFM_CRYPTO_SIGN_PRECOMPUTE,
+                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
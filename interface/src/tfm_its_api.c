@@ -91,3 +91,111 @@ psa_status_t psa_its_remove(psa_storage_uid_t uid)
 
     return status;
 }
+
+psa_status_t tfm_its_compact_step(void)
+{
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_COMPACT, NULL, 0, NULL, 0);
+}
+
+psa_status_t tfm_its_transaction_begin(void)
+{
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_TRANSACTION_BEGIN, NULL, 0, NULL, 0);
+}
+
+psa_status_t tfm_its_transaction_commit(void)
+{
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_TRANSACTION_COMMIT, NULL, 0, NULL, 0);
+}
+
+psa_status_t tfm_its_transaction_abort(void)
+{
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_TRANSACTION_ABORT, NULL, 0, NULL, 0);
+}
+
+psa_status_t tfm_its_get_erase_count(uint32_t block_id, uint32_t *erase_count)
+{
+    psa_invec in_vec[] = {
+        { .base = &block_id, .len = sizeof(block_id) }
+    };
+
+    psa_outvec out_vec[] = {
+        { .base = erase_count, .len = sizeof(*erase_count) }
+    };
+
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_GET_ERASE_COUNT, in_vec, IOVEC_LEN(in_vec),
+                    out_vec, IOVEC_LEN(out_vec));
+}
+
+psa_status_t tfm_its_get_flash_stats(struct tfm_its_flash_stats_t *stats)
+{
+    psa_outvec out_vec[] = {
+        { .base = stats, .len = sizeof(*stats) }
+    };
+
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_GET_FLASH_STATS, NULL, 0,
+                    out_vec, IOVEC_LEN(out_vec));
+}
+
+psa_status_t tfm_its_get_multi(const struct tfm_its_get_desc_t *desc,
+                               size_t count, void *p_data,
+                               size_t *p_data_length)
+{
+    size_t data_size = 0;
+    size_t i;
+
+    if ((desc == NULL) || (p_data_length == NULL)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < count; i++) {
+        data_size += desc[i].data_size;
+    }
+
+    psa_invec in_vec[] = {
+        { .base = desc, .len = count * sizeof(*desc) }
+    };
+
+    psa_outvec out_vec[] = {
+        { .base = p_data, .len = data_size },
+        { .base = p_data_length, .len = count * sizeof(*p_data_length) }
+    };
+
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_GET_MULTI, in_vec, IOVEC_LEN(in_vec),
+                    out_vec, IOVEC_LEN(out_vec));
+}
+
+psa_status_t tfm_its_set_multi(const struct tfm_its_set_desc_t *desc,
+                               size_t count, const void *p_data)
+{
+    size_t data_length = 0;
+    size_t i;
+
+    if (desc == NULL) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < count; i++) {
+        data_length += desc[i].data_length;
+    }
+
+    psa_invec in_vec[] = {
+        { .base = desc, .len = count * sizeof(*desc) },
+        { .base = p_data, .len = data_length }
+    };
+
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_SET_MULTI, in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
+
+psa_status_t tfm_its_cache_flush(void)
+{
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_CACHE_FLUSH, NULL, 0, NULL, 0);
+}
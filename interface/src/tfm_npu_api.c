@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "tfm_npu_api.h"
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+
+psa_status_t tfm_npu_install_model(psa_storage_uid_t uid,
+                                   const void *model, size_t model_size)
+{
+    psa_invec in_vec[] = {
+        { .base = &uid, .len = sizeof(uid) },
+        { .base = model, .len = model_size },
+    };
+
+    return psa_call(TFM_NPU_SERVICE_HANDLE, TFM_NPU_API_ID_INSTALL_MODEL,
+                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
+
+psa_status_t tfm_npu_run(psa_storage_uid_t uid,
+                         const void *input, size_t input_size,
+                         void *output, size_t output_size)
+{
+    psa_invec in_vec[] = {
+        { .base = &uid, .len = sizeof(uid) },
+        { .base = input, .len = input_size },
+    };
+    psa_outvec out_vec[] = {
+        { .base = output, .len = output_size },
+    };
+
+    return psa_call(TFM_NPU_SERVICE_HANDLE, TFM_NPU_API_ID_RUN,
+                    in_vec, IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
+}
@@ -107,3 +107,53 @@ tfm_platform_nv_counter_read(uint32_t counter_id,
         return (enum tfm_platform_err_t)status;
     }
 }
+
+enum tfm_platform_err_t
+tfm_platform_nv_counter_increment_multi(const uint32_t *counter_ids,
+                                        const uint32_t *counts,
+                                        uint32_t num)
+{
+    psa_status_t status = PSA_ERROR_CONNECTION_REFUSED;
+    struct psa_invec in_vec[2];
+
+    in_vec[0].base = counter_ids;
+    in_vec[0].len = num * sizeof(uint32_t);
+
+    in_vec[1].base = counts;
+    in_vec[1].len = num * sizeof(uint32_t);
+
+    status = psa_call(TFM_PLATFORM_SERVICE_HANDLE,
+                      TFM_PLATFORM_API_ID_NV_INCREMENT_MULTI,
+                      in_vec, 2, (psa_outvec *)NULL, 0);
+
+    if (status < PSA_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    } else {
+        return (enum tfm_platform_err_t)status;
+    }
+}
+
+enum tfm_platform_err_t
+tfm_platform_nv_counter_read_multi(const uint32_t *counter_ids,
+                                   uint32_t *vals, uint32_t num)
+{
+    psa_status_t status = PSA_ERROR_CONNECTION_REFUSED;
+    struct psa_invec in_vec[1];
+    struct psa_outvec out_vec[1];
+
+    in_vec[0].base = counter_ids;
+    in_vec[0].len = num * sizeof(uint32_t);
+
+    out_vec[0].base = vals;
+    out_vec[0].len = num * sizeof(uint32_t);
+
+    status = psa_call(TFM_PLATFORM_SERVICE_HANDLE,
+                      TFM_PLATFORM_API_ID_NV_READ_MULTI,
+                      in_vec, 1, out_vec, 1);
+
+    if (status < PSA_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    } else {
+        return (enum tfm_platform_err_t)status;
+    }
+}
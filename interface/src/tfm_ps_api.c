@@ -131,3 +131,9 @@ uint32_t psa_ps_get_support(void)
 
     return support_flags;
 }
+
+psa_status_t tfm_ps_close_epoch(void)
+{
+    return psa_call(TFM_PROTECTED_STORAGE_SERVICE_HANDLE, TFM_PS_CLOSE_EPOCH,
+                    NULL, 0, NULL, 0);
+}
@@ -6,6 +6,8 @@
  */
 
 #include <stdint.h>
+#include <string.h>
+#include "config_tfm.h"
 #include "psa/client.h"
 #include "psa/service.h"
 #include "tfm_psa_call_pack.h"
@@ -24,6 +26,21 @@ psa_status_t psa_call(psa_handle_t handle,
         psa_panic();
     }
 
+#if CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX > 0
+    if ((in_len > 0) && (in_vec[0].len > 0) &&
+        (in_vec[0].len <= CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX)) {
+        struct tfm_psa_call_inline_t inline_vecs;
+
+        memcpy(inline_vecs.data, in_vec[0].base, in_vec[0].len);
+        memcpy(inline_vecs.in_vec, in_vec, in_len * sizeof(psa_invec));
+
+        return tfm_psa_call_pack(handle,
+                                 PARAM_SET_INLINE_INVEC(
+                                        PARAM_PACK(type, in_len, out_len)),
+                                 inline_vecs.in_vec, out_vec);
+    }
+#endif
+
     return tfm_psa_call_pack(handle, PARAM_PACK(type, in_len, out_len),
                              in_vec, out_vec);
 }
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "tfm_secure_timer_api.h"
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+
+psa_status_t tfm_secure_timer_start(uint32_t timer_id, uint32_t ticks)
+{
+    psa_invec in_vec[] = {
+        { .base = &timer_id, .len = sizeof(timer_id) },
+        { .base = &ticks, .len = sizeof(ticks) },
+    };
+
+    return psa_call(TFM_SECURE_TIMER_SERVICE_HANDLE,
+                    TFM_SECURE_TIMER_API_ID_START,
+                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
+
+psa_status_t tfm_secure_timer_cancel(uint32_t timer_id)
+{
+    psa_invec in_vec[] = {
+        { .base = &timer_id, .len = sizeof(timer_id) },
+    };
+
+    return psa_call(TFM_SECURE_TIMER_SERVICE_HANDLE,
+                    TFM_SECURE_TIMER_API_ID_CANCEL,
+                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
+
+psa_status_t tfm_secure_timer_get_expired(uint32_t *expired)
+{
+    psa_outvec out_vec[] = {
+        { .base = expired, .len = sizeof(*expired) },
+    };
+
+    return psa_call(TFM_SECURE_TIMER_SERVICE_HANDLE,
+                    TFM_SECURE_TIMER_API_ID_GET_EXPIRED,
+                    NULL, 0, out_vec, IOVEC_LEN(out_vec));
+}
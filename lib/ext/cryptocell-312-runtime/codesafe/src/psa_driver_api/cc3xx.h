@@ -69,6 +69,16 @@
  *  default as it requires around 0.5 KB of flash.
  */
 #define CC3XX_CONFIG_ENABLE_AEAD_AES_CACHED_MODE
+
+/*!
+ *  Number of RSA private keys of persistent PSA keys kept parsed, with their
+ *  CRT parameters and Barrett tags, across the sign and decrypt operations.
+ *  An entry is matched on the SHA-256 digest of the whole private key buffer
+ *  and the least recently used one is replaced. Each entry takes the size of
+ *  a CCRsaUserPrivKey_t and of a digest. It's set to 0 by default, which
+ *  disables the cache.
+ */
+#define CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES 0
 #endif /* __DOXYGEN_ONLY__ */
 
 #include "cc3xx_psa_init.h"
@@ -21,4 +21,8 @@
 #define CC3XX_CONFIG_ENABLE_AEAD_ONE_SHOT_USE_MULTIPART
 //#define CC3XX_CONFIG_ENABLE_AEAD_AES_CACHED_MODE
 
+#ifndef CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES
+#define CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES 0
+#endif
+
 #endif /* CC3XX_PSA_API_CONFIG_H */
@@ -90,6 +90,12 @@ psa_status_t cc3xx_rsa_psa_priv_to_cc_priv(const uint8_t *psa_priv_key_buffer,
  *        process translates it to CC format, i.e. the type specified by the
  *        low-level driver, i.e. \ref CCRsaUserPubKey_t
  */
+psa_status_t cc3xx_rsa_psa_priv_to_cc_priv_cached(
+    const psa_key_attributes_t *attributes,
+    const uint8_t *psa_priv_key_buffer,
+    size_t psa_priv_key_buffer_size,
+    CCRsaUserPrivKey_t *UserPrivKey_ptr);
+void cc3xx_rsa_key_cache_clear(void);
 psa_status_t cc3xx_rsa_psa_priv_to_cc_pub(const uint8_t *psa_priv_key_buffer,
                                           size_t psa_priv_key_buffer_size,
                                           CCRsaUserPubKey_t *UserPubKey_ptr);
@@ -16,6 +16,7 @@
 #include "cc3xx_internal_asn1_util.h"
 
 #include "cc3xx_psa_api_config.h"
+#include "cc3xx_psa_hash.h"
 
 #include "cc_common.h"
 #include "cc_rnd_error.h"
@@ -37,6 +38,9 @@
 /* To be able to include the PSA style configuration */
 #include "mbedtls/build_info.h"
 
+#include <stdbool.h>
+#include <string.h>
+
 /*  This function checks if the first byte of a pointer is zero and
  *  skips it when it is. We need this when we convert a PSA RSA key
  *  to the CryptoCell internal type because the PSA key will use the
@@ -342,6 +346,114 @@ end:
     return cc3xx_rsa_cc_error_to_psa_error(cc_err);
 }
 
+#if CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES
+/*  An RSA private key of a persistent PSA key, with its CRT parameters and
+ *  Barrett tags as built by CC_RsaPrivKeyCrtBuild(). The key is identified
+ *  by the SHA-256 digest of its whole PSA private key buffer, so that an
+ *  entry is only used for the exact key it was built from. Matching on the
+ *  public parts only would hand the built private key to anyone importing a
+ *  key with the same modulus.
+ */
+struct cc3xx_rsa_key_cache_entry_t {
+    bool valid;
+    uint32_t last_use;
+    uint8_t digest[PSA_HASH_LENGTH(PSA_ALG_SHA_256)];
+    CCRsaUserPrivKey_t key;
+};
+
+static struct cc3xx_rsa_key_cache_entry_t
+    rsa_key_cache[CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES];
+static uint32_t rsa_key_cache_clock;
+
+/*  Compares two digests in a time independent of their content */
+static bool rsa_key_digest_equal(const uint8_t *a, const uint8_t *b)
+{
+    uint8_t diff = 0;
+    size_t i;
+
+    for (i = 0; i < PSA_HASH_LENGTH(PSA_ALG_SHA_256); i++) {
+        diff |= a[i] ^ b[i];
+    }
+
+    return diff == 0;
+}
+#endif /* CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES */
+
+psa_status_t cc3xx_rsa_psa_priv_to_cc_priv_cached(
+    const psa_key_attributes_t *attributes,
+    const uint8_t *psa_priv_key_buffer,
+    size_t psa_priv_key_buffer_size,
+    CCRsaUserPrivKey_t *UserPrivKey_ptr)
+{
+#if CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES
+    struct cc3xx_rsa_key_cache_entry_t *entry = &rsa_key_cache[0];
+    uint8_t digest[PSA_HASH_LENGTH(PSA_ALG_SHA_256)];
+    size_t digest_len;
+    psa_status_t status;
+    size_t idx;
+
+    /* The volatile keys are used for a few operations only */
+    if (PSA_KEY_LIFETIME_IS_VOLATILE(psa_get_key_lifetime(attributes)) ||
+        (cc3xx_hash_compute(PSA_ALG_SHA_256, psa_priv_key_buffer,
+                            psa_priv_key_buffer_size, digest, sizeof(digest),
+                            &digest_len) != PSA_SUCCESS) ||
+        (digest_len != sizeof(digest))) {
+        return cc3xx_rsa_psa_priv_to_cc_priv(psa_priv_key_buffer,
+                                             psa_priv_key_buffer_size,
+                                             UserPrivKey_ptr);
+    }
+
+    for (idx = 0; idx < CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES; idx++) {
+        if (rsa_key_cache[idx].valid &&
+            rsa_key_digest_equal(rsa_key_cache[idx].digest, digest)) {
+            CC_PalMemCopy(UserPrivKey_ptr, &rsa_key_cache[idx].key,
+                          sizeof(CCRsaUserPrivKey_t));
+            rsa_key_cache[idx].last_use = ++rsa_key_cache_clock;
+            return PSA_SUCCESS;
+        }
+    }
+
+    status = cc3xx_rsa_psa_priv_to_cc_priv(psa_priv_key_buffer,
+                                           psa_priv_key_buffer_size,
+                                           UserPrivKey_ptr);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* A free entry, or the least recently used one */
+    for (idx = 0; idx < CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES; idx++) {
+        if (!rsa_key_cache[idx].valid) {
+            entry = &rsa_key_cache[idx];
+            break;
+        }
+        if ((rsa_key_cache_clock - rsa_key_cache[idx].last_use) >
+            (rsa_key_cache_clock - entry->last_use)) {
+            entry = &rsa_key_cache[idx];
+        }
+    }
+
+    CC_PalMemCopy(entry->digest, digest, sizeof(digest));
+    CC_PalMemCopy(&entry->key, UserPrivKey_ptr, sizeof(CCRsaUserPrivKey_t));
+    entry->last_use = ++rsa_key_cache_clock;
+    entry->valid = true;
+
+    return PSA_SUCCESS;
+#else
+    (void)attributes;
+
+    return cc3xx_rsa_psa_priv_to_cc_priv(psa_priv_key_buffer,
+                                         psa_priv_key_buffer_size,
+                                         UserPrivKey_ptr);
+#endif /* CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES */
+}
+
+void cc3xx_rsa_key_cache_clear(void)
+{
+#if CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES
+    CC_PalMemSetZero(rsa_key_cache, sizeof(rsa_key_cache));
+#endif /* CC3XX_CONFIG_RSA_KEY_CACHE_ENTRIES */
+}
+
 psa_status_t cc3xx_rsa_psa_priv_to_psa_publ(uint8_t *priv_key_buffer,
                                             size_t priv_key_buffer_size,
                                             uint8_t *publ_key_buffer,
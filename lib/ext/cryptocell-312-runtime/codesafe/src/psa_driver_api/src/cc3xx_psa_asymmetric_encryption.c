@@ -165,8 +165,9 @@ static psa_status_t cc3xx_internal_rsa_decrypt(
         goto cleanup;
     }
 
-    status = cc3xx_rsa_psa_priv_to_cc_priv(key_buffer, key_buffer_size,
-                                          pUserPrivKey);
+    status = cc3xx_rsa_psa_priv_to_cc_priv_cached(attributes, key_buffer,
+                                                  key_buffer_size,
+                                                  pUserPrivKey);
     if (status != PSA_SUCCESS) {
         error = CC_FAIL;
         goto cleanup;
@@ -359,8 +359,8 @@ static psa_status_t cc3xx_internal_rsa_sign(
         return PSA_ERROR_INSUFFICIENT_MEMORY;
     }
 
-    err = cc3xx_rsa_psa_priv_to_cc_priv(key_buffer, key_length,
-                                           user_priv_key_ptr);
+    err = cc3xx_rsa_psa_priv_to_cc_priv_cached(attributes, key_buffer,
+                                               key_length, user_priv_key_ptr);
     if (err != PSA_SUCCESS) {
         cc_err = CC_FAIL;
         goto cleanup;
@@ -92,6 +92,18 @@ extern "C" {
 #error "Invalid FIH Profile configuration"
 #endif /* TFM_FIH_PROFILE */
 
+/*
+ * The random delays only affect the code of the compilation unit they are
+ * inserted in. A compilation unit on a hot runtime path can define
+ * FIH_MODULE_NO_DELAY before including this file to drop them, while the other
+ * measures of the profile are kept. The other measures can not be changed per
+ * compilation unit, as the fih_int type and the CFI counter are shared by all
+ * the callers and callees.
+ */
+#if defined(FIH_ENABLE_DELAY) && defined(FIH_MODULE_NO_DELAY)
+#undef FIH_ENABLE_DELAY
+#endif
+
 #define FIH_TRUE              0xC35A
 #define FIH_FALSE             0x0
 
@@ -15,6 +15,14 @@
 #include "tfm_fih_rng.h"
 #endif
 
+/*
+ * Number of random delays generated by the PRNG between two seeds from the
+ * RNG. 0 takes every random delay from the RNG.
+ */
+#ifndef FIH_DELAY_RESEED_INTERVAL
+#define FIH_DELAY_RESEED_INTERVAL    0
+#endif
+
 #ifdef TFM_FIH_PROFILE_ON
 fih_int FIH_SUCCESS = FIH_INT_INIT(FIH_POSITIVE_VALUE);
 fih_int FIH_FAILURE = FIH_INT_INIT(FIH_NEGATIVE_VALUE);
@@ -86,6 +94,35 @@ void fih_panic_loop(void)
 #endif /* FIH_ENABLE_GLOBAL_FAIL */
 
 #ifdef FIH_ENABLE_DELAY
+#if FIH_DELAY_RESEED_INTERVAL > 0
+/* xorshift32 state, never 0 once seeded */
+static uint32_t fih_delay_state;
+static uint32_t fih_delay_count;
+
+/*
+ * The RNG output is mixed into the state rather than replacing it, so a weak
+ * or skipped RNG read does not reset the sequence.
+ */
+static void fih_delay_reseed(void)
+{
+    uint8_t seed;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(fih_delay_state); i++) {
+        seed = 0xFF;
+        tfm_fih_random_generate(&seed);
+        tfm_fih_random_generate(&seed);
+        fih_delay_state ^= (uint32_t)seed << (8 * i);
+    }
+
+    if (fih_delay_state == 0) {
+        fih_delay_state = FIH_NEGATIVE_VALUE;
+    }
+
+    fih_delay_count = 0;
+}
+#endif /* FIH_DELAY_RESEED_INTERVAL > 0 */
+
 void fih_delay_init(void)
 {
     fih_int ret = FIH_FAILURE;
@@ -105,10 +142,32 @@ void fih_delay_init(void)
         FIH_PANIC;
     }
 #endif /* FIH_ENABLE_DOUBLE_VARS */
+
+#if FIH_DELAY_RESEED_INTERVAL > 0
+    fih_delay_reseed();
+#endif
 }
 
 uint8_t fih_delay_random(void)
 {
+#if FIH_DELAY_RESEED_INTERVAL > 0
+    uint32_t x;
+
+    if ((fih_delay_count >= FIH_DELAY_RESEED_INTERVAL) ||
+        (fih_delay_state == 0)) {
+        fih_delay_reseed();
+    }
+    fih_delay_count++;
+
+    x = fih_delay_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    fih_delay_state = x;
+
+    /* The high bits of xorshift32 are the most random ones */
+    return (uint8_t)(x >> 24);
+#else
     uint8_t rand_value = 0xFF;
 
     /* Repeat random generation to mitigate instruction skip */
@@ -117,5 +176,6 @@ uint8_t fih_delay_random(void)
     tfm_fih_random_generate(&rand_value);
 
     return rand_value;
+#endif /* FIH_DELAY_RESEED_INTERVAL > 0 */
 }
 #endif /* FIH_ENABLE_DELAY */
@@ -460,6 +460,8 @@ cc3xx_err_t cc3xx_lowlevel_aes_init(
     }
 #endif /* CC3XX_CONFIG_DFA_MITIGATIONS_ENABLE */
 
+    cc3xx_lowlevel_engine_release();
+
     /* Get a clean starting state */
     cc3xx_lowlevel_aes_uninit();
 
@@ -561,6 +563,8 @@ cc3xx_err_t cc3xx_lowlevel_aes_set_state(const struct cc3xx_aes_state_t *state)
 {
     cc3xx_err_t err;
 
+    cc3xx_lowlevel_engine_release();
+
 #ifdef CC3XX_CONFIG_DPA_MITIGATIONS_ENABLE
     memcpy(&aes_state, state, sizeof(*state));
     cc3xx_dpa_hardened_word_copy(aes_state.key_buf,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2023, The TrustedFirmware-M Contributors. All rights reserved.
+ * Copyright (c) 2023-2024, The TrustedFirmware-M Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -125,6 +125,8 @@ cc3xx_err_t cc3xx_lowlevel_chacha20_init(
     assert(mode == CC3XX_CHACHA_MODE_CHACHA);
 #endif /* CC3XX_CONFIG_CHACHA_POLY1305_ENABLE */
 
+    cc3xx_lowlevel_engine_release();
+
     cc3xx_lowlevel_chacha20_uninit();
 
     chacha_state.direction = direction;
@@ -191,6 +193,8 @@ void cc3xx_lowlevel_chacha20_get_state(struct cc3xx_chacha_state_t *state)
 
 cc3xx_err_t cc3xx_lowlevel_chacha20_set_state(const struct cc3xx_chacha_state_t *state)
 {
+    cc3xx_lowlevel_engine_release();
+
     memcpy(&chacha_state, state, sizeof(struct cc3xx_chacha_state_t));
     memcpy(&dma_state, &state->dma_state, sizeof(dma_state));
 
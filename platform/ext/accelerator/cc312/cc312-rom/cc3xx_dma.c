@@ -118,6 +118,15 @@ static void process_data(const void* buf, size_t length)
                                       - round_down(remapped_buf, 32));
 #endif /* CC3XX_CONFIG_DMA_CACHE_FLUSH_ENABLE */
 
+#ifdef CC3XX_CONFIG_DMA_WFE_WAIT_ENABLE
+    /* Let the CC interrupt becoming pending wake the core from WFE. The IRQ
+     * does not need to be enabled in the NVIC, but it must not already be
+     * pending or there would be no transition to generate the event.
+     */
+    NVIC_ClearPendingIRQ(CC3XX_CONFIG_DMA_WFE_WAIT_IRQN);
+    SCB->SCR |= SCB_SCR_SEVONPEND_Msk;
+#endif /* CC3XX_CONFIG_DMA_WFE_WAIT_ENABLE */
+
     /* Set the data source */
     P_CC3XX->din.src_lli_word0 = remapped_buf;
     /* Writing the length triggers the DMA */
@@ -127,20 +136,29 @@ static void process_data(const void* buf, size_t length)
      * asserted)
      */
     while (!(P_CC3XX->host_rgf.host_rgf_irr & 0x800U)) {
-#ifdef CC3XX_CONFIG_DMA_WFI_WAIT_ENABLE
+#if defined(CC3XX_CONFIG_DMA_WFE_WAIT_ENABLE)
+        __WFE();
+#elif defined(CC3XX_CONFIG_DMA_WFI_WAIT_ENABLE)
         __asm("WFI");
-#endif /* CC3XX_CONFIG_WFI_WAIT_ENABLE */
+#endif /* CC3XX_CONFIG_DMA_WFE_WAIT_ENABLE */
     }
 
     /* Reset the SYM_DMA_COMPLETED interrupt */
     P_CC3XX->host_rgf.host_rgf_icr = 0x800U;
 
+#ifdef CC3XX_CONFIG_DMA_WFE_WAIT_ENABLE
+    SCB->SCR &= ~SCB_SCR_SEVONPEND_Msk;
+    NVIC_ClearPendingIRQ(CC3XX_CONFIG_DMA_WFE_WAIT_IRQN);
+#endif /* CC3XX_CONFIG_DMA_WFE_WAIT_ENABLE */
+
     /* Disable the DMA clock */
     P_CC3XX->misc.dma_clk_enable = 0x0U;
 }
 
 void cc3xx_lowlevel_dma_copy_data(void* dest, const void* src, size_t length)
 {
+    cc3xx_lowlevel_engine_release();
+
     /* Set to PASSTHROUGH engine */
     cc3xx_lowlevel_set_engine(CC3XX_ENGINE_NONE);
 
@@ -181,7 +199,7 @@ cc3xx_err_t cc3xx_lowlevel_dma_buffered_input_data(const void* buf, size_t lengt
             data_to_process_length =
                 length < block_buf_size_free ? length : block_buf_size_free;
             memcpy(dma_state.block_buf + dma_state.block_buf_size_in_use, buf,
-                   block_buf_size_free);
+                   data_to_process_length);
             dma_state.block_buf_size_in_use += data_to_process_length;
             buf += data_to_process_length;
             length -= data_to_process_length;
@@ -9,8 +9,11 @@
 #include "cc3xx_ecdsa.h"
 
 #include "cc3xx_ec.h"
+#include "cc3xx_ec_curve_data.h"
 #include "cc3xx_config.h"
+#include "cc3xx_stdlib.h"
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
@@ -270,6 +273,144 @@ out:
 #endif /* CC3XX_CONFIG_ECDSA_VERIFY_ENABLE */
 
 #ifdef CC3XX_CONFIG_ECDSA_SIGN_ENABLE
+/* Sets k to a random value within the group order and r to the x coordinate of
+ * [k]G reduced modulo N, drawing again until r is not 0.
+ */
+static cc3xx_err_t ecdsa_generate_ephemeral(cc3xx_ec_curve_t *curve,
+                                            cc3xx_pka_reg_id_t k_reg,
+                                            cc3xx_pka_reg_id_t r_reg,
+                                            cc3xx_ec_point_affine *temp_point)
+{
+    cc3xx_err_t err;
+
+    do {
+        err = cc3xx_lowlevel_pka_set_to_random_within_modulus(k_reg);
+        if (err != CC3XX_ERR_SUCCESS) {
+            return err;
+        }
+
+        cc3xx_lowlevel_ec_multipy_point_by_scalar(curve, &curve->generator, k_reg,
+                                         temp_point);
+        cc3xx_lowlevel_pka_copy(temp_point->x, r_reg);
+        cc3xx_lowlevel_pka_reduce(r_reg);
+    } while (!cc3xx_lowlevel_pka_greater_than_si(r_reg, 0));
+
+    return CC3XX_ERR_SUCCESS;
+}
+
+#if defined(CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS) && (CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS > 0)
+/* An ephemeral key computed ahead of a signature. Each one is used once, then
+ * erased.
+ */
+struct ecdsa_precomputed_t {
+    bool valid;
+    cc3xx_ec_curve_id_t curve_id;
+    uint32_t k[CC3XX_EC_MAX_POINT_SIZE / sizeof(uint32_t)];
+    uint32_t r[CC3XX_EC_MAX_POINT_SIZE / sizeof(uint32_t)];
+};
+
+static struct ecdsa_precomputed_t ecdsa_precomputed[CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS];
+
+static void ecdsa_precomputed_erase(struct ecdsa_precomputed_t *slot)
+{
+    cc3xx_secure_erase_buffer(slot->k, sizeof(slot->k) / sizeof(uint32_t));
+    cc3xx_secure_erase_buffer(slot->r, sizeof(slot->r) / sizeof(uint32_t));
+    slot->valid = false;
+}
+
+/* Loads a precomputed (k, r) pair of the curve into the registers, and erases
+ * it so that it can't be used for a second signature.
+ */
+static bool ecdsa_precomputed_take(cc3xx_ec_curve_id_t curve_id,
+                                   cc3xx_ec_curve_t *curve,
+                                   cc3xx_pka_reg_id_t k_reg,
+                                   cc3xx_pka_reg_id_t r_reg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS; idx++) {
+        if (ecdsa_precomputed[idx].valid &&
+            ecdsa_precomputed[idx].curve_id == curve_id) {
+            cc3xx_lowlevel_pka_write_reg(k_reg, ecdsa_precomputed[idx].k,
+                                         curve->modulus_size);
+            cc3xx_lowlevel_pka_write_reg(r_reg, ecdsa_precomputed[idx].r,
+                                         curve->modulus_size);
+            ecdsa_precomputed_erase(&ecdsa_precomputed[idx]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+cc3xx_err_t cc3xx_lowlevel_ecdsa_precompute(cc3xx_ec_curve_id_t curve_id)
+{
+    cc3xx_ec_curve_t curve;
+    cc3xx_ec_point_affine temp_point;
+    cc3xx_pka_reg_id_t k_reg;
+    cc3xx_pka_reg_id_t r_reg;
+    struct ecdsa_precomputed_t *slot = NULL;
+    size_t idx;
+    cc3xx_err_t err;
+
+    for (idx = 0; idx < CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS; idx++) {
+        if (!ecdsa_precomputed[idx].valid) {
+            slot = &ecdsa_precomputed[idx];
+            break;
+        }
+    }
+
+    /* Not an error, the caller stops filling the slots */
+    if (slot == NULL) {
+        return CC3XX_ERR_BUFFER_OVERFLOW;
+    }
+
+    /* This sets up various curve parameters into PKA registers */
+    err = cc3xx_lowlevel_ec_init(curve_id, &curve);
+    if (err != CC3XX_ERR_SUCCESS) {
+        goto out;
+    }
+
+    if (curve.modulus_size > sizeof(slot->k)) {
+        FATAL_ERR(err = CC3XX_ERR_EC_CURVE_NOT_SUPPORTED);
+        goto out;
+    }
+
+    k_reg = cc3xx_lowlevel_pka_allocate_reg();
+    r_reg = cc3xx_lowlevel_pka_allocate_reg();
+
+    temp_point = cc3xx_lowlevel_ec_allocate_point();
+
+    err = ecdsa_generate_ephemeral(&curve, k_reg, r_reg, &temp_point);
+    if (err != CC3XX_ERR_SUCCESS) {
+        goto out;
+    }
+
+    cc3xx_lowlevel_pka_read_reg(k_reg, slot->k, curve.modulus_size);
+    cc3xx_lowlevel_pka_read_reg(r_reg, slot->r, curve.modulus_size);
+    slot->curve_id = curve_id;
+    slot->valid = true;
+
+    /* Destroy K */
+    cc3xx_lowlevel_pka_set_to_random(k_reg, curve.modulus_size * 8);
+
+out:
+    /* This frees all the PKA registers as it will deinit the PKA engine */
+    cc3xx_lowlevel_ec_uninit();
+
+    return err;
+}
+
+void cc3xx_lowlevel_ecdsa_precompute_clear(void)
+{
+    size_t idx;
+
+    for (idx = 0; idx < CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS; idx++) {
+        ecdsa_precomputed_erase(&ecdsa_precomputed[idx]);
+    }
+}
+#endif /* CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS > 0 */
+
 cc3xx_err_t cc3xx_lowlevel_ecdsa_sign(cc3xx_ec_curve_id_t curve_id,
                                       const uint32_t *private_key, size_t private_key_len,
                                       const uint32_t *hash, size_t hash_len,
@@ -348,18 +489,15 @@ cc3xx_err_t cc3xx_lowlevel_ecdsa_sign(cc3xx_ec_curve_id_t curve_id,
     cc3xx_lowlevel_pka_reduce(hash_reg);
 
     do {
-        err = cc3xx_lowlevel_pka_set_to_random_within_modulus(k_reg);
-        if (err != CC3XX_ERR_SUCCESS) {
-            goto out;
-        }
-
-        cc3xx_lowlevel_ec_multipy_point_by_scalar(&curve, &curve.generator, k_reg,
-                                         &temp_point);
-        cc3xx_lowlevel_pka_copy(temp_point.x, sig_r_reg);
-        cc3xx_lowlevel_pka_reduce(sig_r_reg);
-
-        if (!cc3xx_lowlevel_pka_greater_than_si(sig_r_reg, 0)) {
-            continue;
+#if defined(CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS) && (CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS > 0)
+        /* A precomputed pair saves the point multiplication */
+        if (!ecdsa_precomputed_take(curve_id, &curve, k_reg, sig_r_reg))
+#endif
+        {
+            err = ecdsa_generate_ephemeral(&curve, k_reg, sig_r_reg, &temp_point);
+            if (err != CC3XX_ERR_SUCCESS) {
+                goto out;
+            }
         }
 
         cc3xx_lowlevel_pka_mod_mul(sig_r_reg, private_key_reg, temp_reg);
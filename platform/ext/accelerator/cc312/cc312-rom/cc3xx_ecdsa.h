@@ -90,6 +90,29 @@ cc3xx_err_t cc3xx_lowlevel_ecdsa_sign(cc3xx_ec_curve_id_t curve_id,
                                       const uint32_t *hash, size_t hash_len,
                                       uint32_t *sig_r, size_t sig_r_len, size_t *sig_r_size,
                                       uint32_t *sig_s, size_t sig_s_len, size_t *sig_s_size);
+
+/**
+ * @brief                        Precompute the ephemeral key of one ECDSA
+ *                               signature on a curve, and keep it in a slot
+ *                               of the driver. The next signature on this
+ *                               curve uses it instead of computing one, and
+ *                               erases it. Only available when
+ *                               CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS is not 0.
+ *
+ * @param[in]  curve_id          The ID of the curve of the signature.
+ *
+ * @return                       CC3XX_ERR_SUCCESS if a slot was filled,
+ *                               CC3XX_ERR_BUFFER_OVERFLOW if all the slots
+ *                               are already filled, another cc3xx_err_t on
+ *                               error.
+ */
+cc3xx_err_t cc3xx_lowlevel_ecdsa_precompute(cc3xx_ec_curve_id_t curve_id);
+
+/**
+ * @brief                        Erase all the precomputed ephemeral keys.
+ */
+void cc3xx_lowlevel_ecdsa_precompute_clear(void);
+
 /**
  * @brief                        Verify an ECDSA signature
  *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2023, The TrustedFirmware-M Contributors. All rights reserved.
+ * Copyright (c) 2021-2024, The TrustedFirmware-M Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,6 +8,8 @@
 #include "cc3xx_engine_state.h"
 #include "cc3xx_dev.h"
 
+#include <stddef.h>
+
 enum cc3xx_engine_t cc3xx_engine_in_use = CC3XX_ENGINE_NONE;
 
 void cc3xx_lowlevel_set_engine(enum cc3xx_engine_t engine)
@@ -24,3 +26,32 @@ void cc3xx_lowlevel_set_engine(enum cc3xx_engine_t engine)
     /* Wait for the crypto engine to be ready */
     while (P_CC3XX->cc_ctl.crypto_busy) {}
 }
+
+#ifdef CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE
+static void *engine_owner;
+static cc3xx_engine_save_t engine_owner_save;
+
+void cc3xx_lowlevel_engine_set_owner(void *owner, cc3xx_engine_save_t save)
+{
+    engine_owner = owner;
+    engine_owner_save = save;
+}
+
+void *cc3xx_lowlevel_engine_get_owner(void)
+{
+    return engine_owner;
+}
+
+void cc3xx_lowlevel_engine_release(void)
+{
+    void *owner = engine_owner;
+
+    if (owner == NULL) {
+        return;
+    }
+
+    /* Cleared first, as saving the state uninitializes the engine */
+    engine_owner = NULL;
+    engine_owner_save(owner);
+}
+#endif /* CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
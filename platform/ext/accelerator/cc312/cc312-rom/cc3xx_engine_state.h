@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2023, The TrustedFirmware-M Contributors. All rights reserved.
+ * Copyright (c) 2021-2024, The TrustedFirmware-M Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -9,6 +9,7 @@
 #define CC3XX_ENGINE_STATE_H
 
 #include "cc3xx_error.h"
+#include "cc3xx_config.h"
 
 #include <stdbool.h>
 
@@ -36,6 +37,42 @@ extern enum cc3xx_engine_t cc3xx_engine_in_use;
  */
 void cc3xx_lowlevel_set_engine(enum cc3xx_engine_t engine);
 
+#ifdef CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE
+/**
+ * @brief Saves the state of the operation owning the engine into the operation,
+ *        and uninitializes the engine
+ *
+ * @param owner The operation owning the engine
+ */
+typedef void (*cc3xx_engine_save_t)(void *owner);
+
+/**
+ * @brief Records the operation whose state is left loaded in the engine
+ *        between its calls, to be saved only when another user needs the
+ *        engine
+ *
+ * @param owner The operation owning the engine, NULL if none
+ * @param save  The function saving the state of the operation
+ */
+void cc3xx_lowlevel_engine_set_owner(void *owner, cc3xx_engine_save_t save);
+
+/**
+ * @brief Gets the operation owning the engine
+ *
+ * @return The operation owning the engine, NULL if none
+ */
+void *cc3xx_lowlevel_engine_get_owner(void);
+
+/**
+ * @brief Saves the state of the operation owning the engine, if any, so that
+ *        the engine can be initialized for another use. It is called by all
+ *        the functions which initialize the engine or load a state into it
+ */
+void cc3xx_lowlevel_engine_release(void);
+#else
+#define cc3xx_lowlevel_engine_release()
+#endif /* CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
+
 #ifdef __cplusplus
 }
 #endif
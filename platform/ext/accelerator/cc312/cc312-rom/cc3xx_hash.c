@@ -83,6 +83,8 @@ static void init_without_iv_set(cc3xx_hash_alg_t alg)
 
 cc3xx_err_t cc3xx_lowlevel_hash_init(cc3xx_hash_alg_t alg)
 {
+    cc3xx_lowlevel_engine_release();
+
     cc3xx_lowlevel_hash_uninit();
 
     const uint32_t *iv;
@@ -159,6 +161,8 @@ void cc3xx_lowlevel_hash_get_state(struct cc3xx_hash_state_t *state)
 
 void cc3xx_lowlevel_hash_set_state(const struct cc3xx_hash_state_t *state)
 {
+    cc3xx_lowlevel_engine_release();
+
     init_without_iv_set(state->alg);
     size_t hash_h_len = state->alg != CC3XX_HASH_ALG_SHA1 ? SHA256_OUTPUT_SIZE
                                                           : SHA1_OUTPUT_SIZE;
@@ -17,12 +17,48 @@
 #include "cc3xx_crypto_primitives_private.h"
 #include "cc3xx_stdlib.h"
 #include "cc3xx_misc.h"
+#include "cc3xx_engine_state.h"
 
 /* ToDo: This needs to be sorted out at TF-M level
  * To be able to include the PSA style configuration
  */
 #include "mbedtls/build_info.h"
 
+#ifdef CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE
+/* The state of the last operation updated is left in the engine, and is only
+ * saved back into the operation when another operation, or another user of the
+ * engine, needs it. Interleaved operations pay for a switch only when the
+ * engine actually changes hands.
+ */
+static void hash_save(void *owner)
+{
+    cc3xx_hash_operation_t *operation = owner;
+
+    cc3xx_lowlevel_hash_get_state(&operation->ctx);
+    cc3xx_lowlevel_hash_uninit();
+}
+
+static void hash_acquire(cc3xx_hash_operation_t *operation)
+{
+    if (cc3xx_lowlevel_engine_get_owner() == operation) {
+        return;
+    }
+
+    /* Saves the state of the current owner first, if any */
+    cc3xx_lowlevel_hash_set_state(&operation->ctx);
+    cc3xx_lowlevel_engine_set_owner(operation, hash_save);
+}
+
+/* Drops the state left in the engine, for an operation which ends */
+static void hash_drop(const cc3xx_hash_operation_t *operation)
+{
+    if (cc3xx_lowlevel_engine_get_owner() == operation) {
+        cc3xx_lowlevel_engine_set_owner(NULL, NULL);
+        cc3xx_lowlevel_hash_uninit();
+    }
+}
+#endif /* CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
+
 /** @defgroup psa_hash PSA driver entry points for hashing
  *
  *  Entry points for hashing operations as described by the PSA Cryptoprocessor
@@ -83,6 +119,13 @@ psa_status_t cc3xx_hash_clone(const cc3xx_hash_operation_t *source_operation,
 
     memcpy(target_operation, source_operation, sizeof(cc3xx_hash_operation_t));
 
+#ifdef CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE
+    /* The up to date state of the source is in the engine, which it keeps */
+    if (cc3xx_lowlevel_engine_get_owner() == source_operation) {
+        cc3xx_lowlevel_hash_get_state(&target_operation->ctx);
+    }
+#endif /* CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
+
     return PSA_SUCCESS;
 }
 
@@ -103,6 +146,16 @@ psa_status_t cc3xx_hash_update(cc3xx_hash_operation_t *operation,
     /* if len not zero, but pointer is NULL */
     CC3XX_ASSERT(input != NULL);
 
+#ifdef CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE
+    hash_acquire(operation);
+
+    err = cc3xx_lowlevel_hash_update(input, input_length);
+
+    if (err != CC3XX_ERR_SUCCESS) {
+        hash_drop(operation);
+        return cc3xx_to_psa_err(err);
+    }
+#else
     cc3xx_lowlevel_hash_set_state(&operation->ctx);
 
     err = cc3xx_lowlevel_hash_update(input, input_length);
@@ -114,6 +167,7 @@ psa_status_t cc3xx_hash_update(cc3xx_hash_operation_t *operation,
     cc3xx_lowlevel_hash_get_state(&operation->ctx);
 
     cc3xx_lowlevel_hash_uninit();
+#endif /* CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
 
     return PSA_SUCCESS;
 }
@@ -125,7 +179,11 @@ psa_status_t cc3xx_hash_finish(cc3xx_hash_operation_t *operation,
     CC3XX_ASSERT(operation != NULL);
     CC3XX_ASSERT(hash_length != NULL);
 
+#ifdef CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE
+    hash_acquire(operation);
+#else
     cc3xx_lowlevel_hash_set_state(&operation->ctx);
+#endif /* CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
 
     switch (operation->ctx.alg) {
     case CC3XX_HASH_ALG_SHA1:
@@ -144,11 +202,20 @@ psa_status_t cc3xx_hash_finish(cc3xx_hash_operation_t *operation,
 
     cc3xx_lowlevel_hash_finish((uint32_t *)hash, hash_size);
 
+#ifdef CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE
+    /* The engine has been uninitialized by the finish */
+    cc3xx_lowlevel_engine_set_owner(NULL, NULL);
+#endif /* CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
+
     return PSA_SUCCESS;
 }
 
 psa_status_t cc3xx_hash_abort(cc3xx_hash_operation_t *operation)
 {
+#ifdef CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE
+    hash_drop(operation);
+#endif /* CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
+
     cc3xx_secure_erase_buffer((uint32_t *)operation, sizeof(cc3xx_hash_operation_t) / sizeof(uint32_t));
     return PSA_SUCCESS;
 }
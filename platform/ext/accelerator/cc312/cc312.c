@@ -22,6 +22,9 @@
 #include "dx_crys_kernel.h"
 
 #include "region_defs.h"
+#ifdef CRYPTO_HW_RSA_KEY_CACHE
+#include "cc3xx_internal_rsa_util.h"
+#endif
 
 #define CC312_NULL_CONTEXT "NO SALT!"
 
@@ -136,6 +139,13 @@ int crypto_hw_accelerator_huk_derive_key(const uint8_t *label,
                                             key, key_size);
 }
 
+#ifdef CRYPTO_HW_RSA_KEY_CACHE
+void crypto_hw_accelerator_rsa_key_cache_clear(void)
+{
+    cc3xx_rsa_key_cache_clear();
+}
+#endif /* CRYPTO_HW_RSA_KEY_CACHE */
+
 int crypto_hw_apply_debug_permissions(uint8_t *permissions_mask, uint32_t len)
 {
     int ret_val = -1;
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Interrupt control of the CC-312 PAL for the crypto partition. It replaces the
+ * busy wait of the no_os PAL: the partition waits for the interrupt of the
+ * CC-312 with psa_wait(), so that the other partitions can run while the
+ * engine is processing a job.
+ */
+
+#include <stdint.h>
+
+#include "cc_pal_types.h"
+#include "cc_pal_interrupt_ctrl_plat.h"
+#include "cc_regs.h"
+#include "dx_host.h"
+#include "cc_hal.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_crypto.h"
+
+CCError_t CC_PalInitIrq(void)
+{
+    return CC_SUCCESS;
+}
+
+void CC_PalFinishIrq(void)
+{
+}
+
+/*!
+ * Waits for the interrupt of the CC-312 until one of the IRR signals in \p data
+ * is raised. Only these signals and the bus error are unmasked while waiting.
+ *
+ * @param[in] data  - IRR signals to wait for
+ * \return  CCError_t   - CC_OK upon success
+ */
+CCError_t CC_PalWaitInterrupt(uint32_t data)
+{
+    uint32_t irr = 0;
+    uint32_t imr;
+    uint32_t wait_mask = data;
+    CCError_t error = CC_OK;
+
+    /* IRR and IMR bit map is the same */
+    CC_REG_FLD_SET(HOST_RGF, HOST_IRR, AHB_ERR_INT, wait_mask, 1);
+    imr = CC_HAL_READ_REGISTER(CC_REG_OFFSET(HOST_RGF, HOST_IMR));
+    CC_HalMaskInterrupt(imr & ~wait_mask);
+
+    psa_irq_enable(CC312_SIGNAL);
+
+    while (1) {
+        (void)psa_wait(CC312_SIGNAL, PSA_BLOCK);
+
+        irr = CC_HAL_READ_REGISTER(CC_REG_OFFSET(HOST_RGF, HOST_IRR));
+        if (irr & wait_mask) {
+            break;
+        }
+
+        /* Raised by a signal which was already unmasked, wait again */
+        psa_eoi(CC312_SIGNAL);
+    }
+
+    /* check APB bus error from HOST */
+    if (CC_REG_FLD_GET(0, HOST_IRR, AHB_ERR_INT, irr) == CC_TRUE) {
+        error = CC_FAIL;
+        /*set data for clearing bus error*/
+        CC_REG_FLD_SET(HOST_RGF, HOST_ICR, AXI_ERR_CLEAR, data, 1);
+    }
+
+    /* clear interrupt, IRR and ICR bit map is the same */
+    CC_HAL_WRITE_REGISTER(CC_REG_OFFSET(HOST_RGF, HOST_ICR), data);
+    CC_HalMaskInterrupt(imr);
+
+    psa_eoi(CC312_SIGNAL);
+    (void)psa_irq_disable(CC312_SIGNAL);
+
+    return error;
+}
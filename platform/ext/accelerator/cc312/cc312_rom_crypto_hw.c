@@ -11,6 +11,10 @@
 #include "region_defs.h"
 #include "cc3xx_init.h"
 #include "device_definition.h"
+#ifdef CRYPTO_HW_ECDSA_PRECOMPUTE
+#include "cc3xx_ecdsa.h"
+#include "cc3xx_misc.h"
+#endif
 
 int crypto_hw_accelerator_init(void)
 {
@@ -22,6 +26,31 @@ int crypto_hw_accelerator_finish(void)
     return cc3xx_lowlevel_uninit();
 }
 
+#ifdef CRYPTO_HW_ECDSA_PRECOMPUTE
+int crypto_hw_accelerator_ecdsa_precompute(uint8_t ecc_family,
+                                           size_t key_bits)
+{
+    cc3xx_ec_curve_id_t curve_id = cc3xx_to_curve_id(ecc_family, key_bits);
+    cc3xx_err_t err;
+
+    if (CC3XX_IS_CURVE_ID_INVALID(curve_id)) {
+        return -1;
+    }
+
+    err = cc3xx_lowlevel_ecdsa_precompute(curve_id);
+    if (err == CC3XX_ERR_BUFFER_OVERFLOW) {
+        return 1;
+    }
+
+    return (err == CC3XX_ERR_SUCCESS) ? 0 : -1;
+}
+
+void crypto_hw_accelerator_ecdsa_precompute_clear(void)
+{
+    cc3xx_lowlevel_ecdsa_precompute_clear();
+}
+#endif /* CRYPTO_HW_ECDSA_PRECOMPUTE */
+
 int fih_delay_init(void)
 {
     return 0;
@@ -48,6 +48,32 @@ int crypto_hw_accelerator_huk_derive_key(const uint8_t *label,
                                          size_t context_size,
                                          uint8_t *key,
                                          size_t key_size);
+/**
+ * \brief Computes the ephemeral key of one ECDSA signature ahead of the
+ *        signature, when the accelerator is built with CRYPTO_HW_ECDSA_PRECOMPUTE.
+ *        The next signature on the curve uses it once.
+ *
+ * \param[in]  ecc_family    PSA ECC family of the curve
+ * \param[in]  key_bits      Size in bits of the keys of the curve
+ *
+ * \return 0 on success, 1 if all the ephemeral keys are already computed,
+ *         another non-zero value otherwise
+ */
+int crypto_hw_accelerator_ecdsa_precompute(uint8_t ecc_family,
+                                           size_t key_bits);
+
+/**
+ * \brief Erases the ephemeral keys computed by
+ *        crypto_hw_accelerator_ecdsa_precompute() which have not been used
+ */
+void crypto_hw_accelerator_ecdsa_precompute_clear(void);
+
+/**
+ * \brief Erases the RSA private keys kept parsed by the accelerator driver,
+ *        when it is built with CRYPTO_HW_RSA_KEY_CACHE
+ */
+void crypto_hw_accelerator_rsa_key_cache_clear(void);
+
 /**
  * \brief Apply permissions on debug signals
  *
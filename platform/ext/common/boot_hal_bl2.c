@@ -353,6 +353,27 @@ __WEAK int boot_store_measurement(
 }
 #endif /* TFM_MEASURED_BOOT_API */
 
+__WEAK int boot_platform_read_validation_record(
+                                        uint32_t image_id,
+                                        struct boot_validation_record *record)
+{
+    (void)image_id;
+    (void)record;
+
+    /* No protected storage, the images are always fully validated */
+    return 1;
+}
+
+__WEAK int boot_platform_write_validation_record(
+                                  uint32_t image_id,
+                                  const struct boot_validation_record *record)
+{
+    (void)image_id;
+    (void)record;
+
+    return 1;
+}
+
 __WEAK int boot_initiate_recovery_mode(uint32_t image_id)
 {
     (void)image_id;
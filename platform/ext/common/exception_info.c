@@ -212,6 +212,65 @@ void tfm_exception_info_get_context(struct exception_info_t *ctx)
     memcpy(ctx, &exception_info, sizeof(exception_info));
 }
 
+__WEAK struct exception_info_ring_t *tfm_plat_get_exception_info_ring(
+                                                                uint32_t *num)
+{
+    *num = 0;
+
+    return NULL;
+}
+
+static void store_retained(const struct exception_info_t *ctx)
+{
+    struct exception_info_ring_t *ring;
+    uint32_t num;
+
+    ring = tfm_plat_get_exception_info_ring(&num);
+    if ((ring == NULL) || (num == 0)) {
+        return;
+    }
+
+    if (ring->magic != EXCEPTION_INFO_RING_MAGIC) {
+        ring->count = 0;
+        ring->magic = EXCEPTION_INFO_RING_MAGIC;
+    }
+
+    memcpy(&ring->entries[ring->count % num], ctx, sizeof(*ctx));
+    ring->count++;
+
+    /* The context is in memory before it is printed or the system resets */
+    __DSB();
+}
+
+bool tfm_exception_info_get_retained(uint32_t idx,
+                                     struct exception_info_t *ctx)
+{
+    struct exception_info_ring_t *ring;
+    uint32_t num;
+
+    ring = tfm_plat_get_exception_info_ring(&num);
+    if ((ring == NULL) || (ring->magic != EXCEPTION_INFO_RING_MAGIC) ||
+        (idx >= ring->count) || (idx >= num)) {
+        return false;
+    }
+
+    memcpy(ctx, &ring->entries[(ring->count - 1 - idx) % num], sizeof(*ctx));
+
+    return true;
+}
+
+void tfm_exception_info_clear_retained(void)
+{
+    struct exception_info_ring_t *ring;
+    uint32_t num;
+
+    ring = tfm_plat_get_exception_info_ring(&num);
+    if (ring != NULL) {
+        ring->count = 0;
+        ring->magic = EXCEPTION_INFO_RING_MAGIC;
+    }
+}
+
 void store_and_dump_context(uint32_t MSP_in, uint32_t PSP_in, uint32_t LR_in,
                             uint32_t *callee_saved)
 {
@@ -246,5 +305,7 @@ void store_and_dump_context(uint32_t MSP_in, uint32_t PSP_in, uint32_t LR_in,
 #endif
 #endif
 
+    store_retained(ctx);
+
     dump_error(ctx);
 }
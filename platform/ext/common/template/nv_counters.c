@@ -27,6 +27,26 @@
 #define OTP_COUNTER_MAX_SIZE    128u
 #define NV_COUNTER_SIZE         4
 
+#ifdef NV_COUNTERS_RAM_SHADOW
+/* Marks a shadow entry loaded from the backing store */
+#define NV_COUNTER_SHADOW_VALID 0x5A3CC3A5u
+
+/*
+ * RAM copy of a counter, loaded on its first read and written through on every
+ * update. The value is stored with its complement so that a corrupted or
+ * glitched entry is never returned, it is reloaded from the backing store
+ * instead.
+ */
+struct nv_counter_shadow_t {
+    uint32_t valid;
+    uint32_t value;
+    uint32_t value_inv;
+};
+
+static volatile struct nv_counter_shadow_t
+                                    nv_counter_shadow[PLAT_NV_COUNTER_MAX];
+#endif /* NV_COUNTERS_RAM_SHADOW */
+
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
 enum flash_nv_counter_id_t {
     FLASH_NV_COUNTER_ID_PS_0 = 0,
@@ -107,8 +127,8 @@ static enum tfm_plat_err_t read_nv_counter_flash(enum flash_nv_counter_id_t coun
 }
 #endif /* TFM_PARTITION_PROTECTED_STORAGE */
 
-enum tfm_plat_err_t tfm_plat_read_nv_counter(enum tfm_nv_counter_t counter_id,
-                                             uint32_t size, uint8_t *val)
+static enum tfm_plat_err_t read_nv_counter(enum tfm_nv_counter_t counter_id,
+                                           uint32_t size, uint8_t *val)
 {
     if (size != NV_COUNTER_SIZE) {
         return TFM_PLAT_ERR_SYSTEM_ERR;
@@ -158,6 +178,55 @@ enum tfm_plat_err_t tfm_plat_read_nv_counter(enum tfm_nv_counter_t counter_id,
     }
 }
 
+#ifdef NV_COUNTERS_RAM_SHADOW
+static void shadow_update(enum tfm_nv_counter_t counter_id, uint32_t value)
+{
+    nv_counter_shadow[counter_id].valid = 0;
+    nv_counter_shadow[counter_id].value = value;
+    nv_counter_shadow[counter_id].value_inv = ~value;
+    nv_counter_shadow[counter_id].valid = NV_COUNTER_SHADOW_VALID;
+}
+
+static void shadow_invalidate(enum tfm_nv_counter_t counter_id)
+{
+    nv_counter_shadow[counter_id].valid = 0;
+}
+#endif /* NV_COUNTERS_RAM_SHADOW */
+
+enum tfm_plat_err_t tfm_plat_read_nv_counter(enum tfm_nv_counter_t counter_id,
+                                             uint32_t size, uint8_t *val)
+{
+#ifdef NV_COUNTERS_RAM_SHADOW
+    enum tfm_plat_err_t err;
+    uint32_t value;
+
+    if ((size != NV_COUNTER_SIZE) || (counter_id >= PLAT_NV_COUNTER_MAX)) {
+        return read_nv_counter(counter_id, size, val);
+    }
+
+    if (nv_counter_shadow[counter_id].valid == NV_COUNTER_SHADOW_VALID) {
+        value = nv_counter_shadow[counter_id].value;
+        if ((value ^ nv_counter_shadow[counter_id].value_inv) == UINT32_MAX) {
+            memcpy(val, &value, NV_COUNTER_SIZE);
+            return TFM_PLAT_ERR_SUCCESS;
+        }
+    }
+
+    err = read_nv_counter(counter_id, size, (uint8_t *)&value);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        shadow_invalidate(counter_id);
+        return err;
+    }
+    shadow_update(counter_id, value);
+
+    memcpy(val, &value, NV_COUNTER_SIZE);
+
+    return TFM_PLAT_ERR_SUCCESS;
+#else
+    return read_nv_counter(counter_id, size, val);
+#endif /* NV_COUNTERS_RAM_SHADOW */
+}
+
 #if defined(BL2) || defined(BL1)
 static enum tfm_plat_err_t set_nv_counter_otp(enum tfm_otp_element_id_t id,
                                               uint32_t value)
@@ -289,15 +358,21 @@ enum tfm_plat_err_t tfm_plat_set_nv_counter(enum tfm_nv_counter_t counter_id,
     default:
         return TFM_PLAT_ERR_UNSUPPORTED;
     }
+
+#ifdef NV_COUNTERS_RAM_SHADOW
+    /* The backing store is read again below, whatever the write result. */
+    shadow_invalidate(counter_id);
+#endif
+
     if (err != TFM_PLAT_ERR_SUCCESS) {
         return err;
     }
 
     /* Check that the NV counter write hasn't failed (in case the driver doesn't
-     * have a check.
+     * have a check. The backing store is read, not the RAM shadow.
      */
-    err = tfm_plat_read_nv_counter(counter_id, sizeof(new_value),
-                                   (uint8_t *)&new_value);
+    err = read_nv_counter(counter_id, sizeof(new_value),
+                          (uint8_t *)&new_value);
     if (err != TFM_PLAT_ERR_SUCCESS) {
         return err;
     }
@@ -306,6 +381,10 @@ enum tfm_plat_err_t tfm_plat_set_nv_counter(enum tfm_nv_counter_t counter_id,
         return TFM_PLAT_ERR_SYSTEM_ERR;
     }
 
+#ifdef NV_COUNTERS_RAM_SHADOW
+    shadow_update(counter_id, new_value);
+#endif
+
     return TFM_PLAT_ERR_SUCCESS;
 }
 
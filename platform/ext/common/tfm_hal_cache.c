@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tfm_hal_cache.h"
+#include "tfm_hal_device_header.h"
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define CACHE_LINE_MASK     ((uintptr_t)__SCB_DCACHE_LINE_SIZE - 1U)
+#endif
+
+/* The CMSIS functions take the size as a signed integer */
+static bool cache_range_is_valid(uintptr_t addr, size_t size)
+{
+    return (size <= (size_t)INT32_MAX) && (addr + size >= addr);
+}
+
+__WEAK enum tfm_hal_status_t tfm_hal_cache_clean(uintptr_t addr, size_t size)
+{
+    if (!cache_range_is_valid(addr, size)) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    if ((size != 0U) && ((SCB->CCR & SCB_CCR_DC_Msk) != 0U)) {
+        SCB_CleanDCache_by_Addr((volatile void *)addr, (int32_t)size);
+    }
+#endif
+
+    return TFM_HAL_SUCCESS;
+}
+
+__WEAK enum tfm_hal_status_t tfm_hal_cache_invalidate(uintptr_t addr,
+                                                      size_t size)
+{
+    if (!cache_range_is_valid(addr, size)) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    if (((addr | size) & CACHE_LINE_MASK) != 0U) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    if ((size != 0U) && ((SCB->CCR & SCB_CCR_DC_Msk) != 0U)) {
+        SCB_InvalidateDCache_by_Addr((volatile void *)addr, (int32_t)size);
+    }
+#endif
+
+    return TFM_HAL_SUCCESS;
+}
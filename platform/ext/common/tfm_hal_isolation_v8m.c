@@ -36,6 +36,73 @@
 #define HANDLE_ATTR_NS_POS              0U
 #define HANDLE_ATTR_NS_MASK             (0x1UL << HANDLE_ATTR_NS_POS)
 
+#ifndef TFM_HAL_MEMORY_CHECK_CACHE_SIZE
+/* Number of validated secure memory ranges remembered by the memory check */
+#define TFM_HAL_MEMORY_CHECK_CACHE_SIZE 4
+#endif
+
+#if TFM_HAL_MEMORY_CHECK_CACHE_SIZE > 0
+/*
+ * Secure memory ranges which passed tfm_hal_memory_check(). The result of the
+ * check only depends on the boundary, the access flags and the SAU and secure
+ * MPU configuration, which is only changed at initialization in this file
+ * and invalidates the cache. Ranges accessed through the non-secure MPU are
+ * never cached, as the NSPE can reconfigure it at any time.
+ */
+struct mem_check_cache_entry_t {
+    uintptr_t boundary;
+    uintptr_t base;
+    size_t size;
+    int flags;                  /* Zero for an unused entry */
+};
+
+static struct mem_check_cache_entry_t
+                             mem_check_cache[TFM_HAL_MEMORY_CHECK_CACHE_SIZE];
+static uint32_t mem_check_cache_next = 0;
+
+static void mem_check_cache_invalidate(void)
+{
+    memset(mem_check_cache, 0, sizeof(mem_check_cache));
+    mem_check_cache_next = 0;
+}
+
+static bool mem_check_cache_lookup(uintptr_t boundary, uintptr_t base,
+                                   size_t size, int flags)
+{
+    const struct mem_check_cache_entry_t *p_entry;
+    uint32_t i;
+
+    for (i = 0; i < TFM_HAL_MEMORY_CHECK_CACHE_SIZE; i++) {
+        p_entry = &mem_check_cache[i];
+        if ((p_entry->flags == flags) && (p_entry->boundary == boundary) &&
+            (base >= p_entry->base) &&
+            (size <= p_entry->size) &&
+            (base - p_entry->base <= p_entry->size - size)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void mem_check_cache_insert(uintptr_t boundary, uintptr_t base,
+                                   size_t size, int flags)
+{
+    struct mem_check_cache_entry_t *p_entry =
+                                        &mem_check_cache[mem_check_cache_next];
+
+    /* Mark the entry unused while it is updated */
+    p_entry->flags = 0;
+    p_entry->boundary = boundary;
+    p_entry->base = base;
+    p_entry->size = size;
+    p_entry->flags = flags;
+
+    mem_check_cache_next = (mem_check_cache_next + 1) %
+                           TFM_HAL_MEMORY_CHECK_CACHE_SIZE;
+}
+#endif /* TFM_HAL_MEMORY_CHECK_CACHE_SIZE > 0 */
+
 #ifdef CONFIG_TFM_ENABLE_MEMORY_PROTECT
 static uint32_t n_configured_regions = 0;
 
@@ -190,6 +257,10 @@ const ARM_MPU_Region_t mpu_region_attributes[] = {
 };
     ARM_MPU_Region_t localcfg;
 #endif /* CONFIG_TFM_ENABLE_MEMORY_PROTECT */
+#if TFM_HAL_MEMORY_CHECK_CACHE_SIZE > 0
+    mem_check_cache_invalidate();
+#endif
+
     /* Set up isolation boundaries between SPE and NSPE */
     sau_and_idau_cfg();
     if (mpc_init_cfg() != TFM_PLAT_ERR_SUCCESS) {
@@ -290,6 +361,7 @@ enum tfm_hal_status_t tfm_hal_bind_boundary(
 #if TFM_ISOLATION_LEVEL == 2
     ARM_MPU_Region_t local_mpu_region;
     uint32_t mpu_region_num;
+    uint8_t mem_attr_idx;
 #endif
     if (!p_ldinf || !p_boundary) {
         return TFM_HAL_ERROR_GENERIC;
@@ -372,14 +444,19 @@ enum tfm_hal_status_t tfm_hal_bind_boundary(
                                                  ARM_MPU_READ_WRITE,
                                                  ARM_MPU_UNPRIVILEGED,
                                                  ARM_MPU_EXECUTE_NEVER);
-            /* Attr2 contains required attribute set for device regions */
+            /*
+             * Attr2 contains required attribute set for device regions, Attr1
+             * the write-back one for the memories the manifest declares
+             * cacheable, such as DMA buffers.
+             */
+            mem_attr_idx = (p_asset[i].attr & ASSET_ATTR_CACHEABLE) ? 1 : 2;
             #ifdef TFM_PXN_ENABLE
             local_mpu_region.RLAR = ARM_MPU_RLAR_PXN(plat_data_ptr->periph_limit,
                                                      ARM_MPU_PRIVILEGE_EXECUTE_NEVER,
-                                                     2);
+                                                     mem_attr_idx);
             #else
             local_mpu_region.RLAR = ARM_MPU_RLAR(plat_data_ptr->periph_limit,
-                                                 2);
+                                                 mem_attr_idx);
             #endif
 
             /* Configure device mpu region */
@@ -389,6 +466,10 @@ enum tfm_hal_status_t tfm_hal_bind_boundary(
 
             n_configured_regions++;
 
+#if TFM_HAL_MEMORY_CHECK_CACHE_SIZE > 0
+            mem_check_cache_invalidate();
+#endif
+
             /* Enable MPU with the new region added */
             ARM_MPU_Enable(MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_HFNMIENA_Msk);
         }
@@ -461,11 +542,24 @@ enum tfm_hal_status_t tfm_hal_memory_check(uintptr_t boundary, uintptr_t base,
         flags |= CMSE_NONSECURE;
     }
 
-    if (cmse_check_address_range((void *)base, size, flags) != NULL) {
+#if TFM_HAL_MEMORY_CHECK_CACHE_SIZE > 0
+    if (!(flags & CMSE_NONSECURE) &&
+        mem_check_cache_lookup(boundary, base, size, flags)) {
         return TFM_HAL_SUCCESS;
-    } else {
+    }
+#endif
+
+    if (cmse_check_address_range((void *)base, size, flags) == NULL) {
         return TFM_HAL_ERROR_MEM_FAULT;
     }
+
+#if TFM_HAL_MEMORY_CHECK_CACHE_SIZE > 0
+    if (!(flags & CMSE_NONSECURE)) {
+        mem_check_cache_insert(boundary, base, size, flags);
+    }
+#endif
+
+    return TFM_HAL_SUCCESS;
 }
 
 bool tfm_hal_boundary_need_switch(uintptr_t boundary_from,
@@ -42,3 +42,33 @@ tfm_hal_its_fs_info(struct tfm_hal_its_fs_info_t *fs_info)
 
     return TFM_HAL_SUCCESS;
 }
+
+__WEAK enum tfm_hal_status_t
+tfm_hal_its_shard_fs_info(uint32_t shard, struct tfm_hal_its_fs_info_t *fs_info)
+{
+    if (!fs_info || (shard == 0)) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+#ifdef TFM_HAL_ITS_SHARD_FLASH_AREA_ADDR
+    /* The shards are consecutive areas of TFM_HAL_ITS_SHARD_FLASH_AREA_SIZE
+     * bytes, starting from TFM_HAL_ITS_SHARD_FLASH_AREA_ADDR.
+     */
+    fs_info->flash_area_addr = TFM_HAL_ITS_SHARD_FLASH_AREA_ADDR
+                               + ((shard - 1) * TFM_HAL_ITS_SHARD_FLASH_AREA_SIZE);
+    fs_info->flash_area_size = TFM_HAL_ITS_SHARD_FLASH_AREA_SIZE;
+    fs_info->sectors_per_block = TFM_HAL_ITS_SECTORS_PER_BLOCK;
+
+    return TFM_HAL_SUCCESS;
+#else
+    return TFM_HAL_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+__WEAK uint32_t tfm_hal_its_client_shard(int32_t client_id)
+{
+    /* The non-secure clients get the first shard, the partitions keep the ITS
+     * area.
+     */
+    return (client_id < 0) ? 1 : 0;
+}
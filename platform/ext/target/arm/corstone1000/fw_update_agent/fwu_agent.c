@@ -5,6 +5,7 @@
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include "fwu_agent.h"
@@ -707,10 +708,46 @@ static int get_image_info_in_bank(struct efi_guid* guid, uint32_t* image_bank_of
     return IMAGE_NOT_RECOGNIZED;
 }
 
-static enum fwu_agent_error_t erase_bank(uint32_t bank_offset)
+/* Size of the reads which check whether a sector is erased */
+#define BLANK_CHECK_CHUNK_SIZE  256
+
+static bool sector_is_blank(uint32_t sector_offset)
+{
+    uint32_t buf[BLANK_CHECK_CHUNK_SIZE / sizeof(uint32_t)];
+    uint8_t erased_value = FWU_METADATA_FLASH_DEV.GetInfo()->erased_value;
+    const uint8_t *p = (const uint8_t *)buf;
+    uint32_t off;
+    int ret;
+
+    for (off = 0; off < FWU_METADATA_FLASH_SECTOR_SIZE; off += sizeof(buf)) {
+        ret = FWU_METADATA_FLASH_DEV.ReadData(sector_offset + off, buf,
+                                              sizeof(buf));
+        if (ret < 0 || ret != sizeof(buf)) {
+            return false;
+        }
+        for (int i = 0; i < sizeof(buf); i++) {
+            if (p[i] != erased_value) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Erases the sectors of the bank which the image is written to, and the rest
+ * of the bank unless it is already erased. The tail of the bank is usually
+ * left erased by the previous update, and reading it is much faster than
+ * erasing it again.
+ */
+static enum fwu_agent_error_t erase_bank(uint32_t bank_offset,
+                                         uint32_t image_size)
 {
     int ret;
     uint32_t sectors;
+    uint32_t image_sectors;
+    uint32_t sector_offset;
 
     FWU_LOG_MSG("%s: enter\n\r", __func__);
 
@@ -723,13 +760,19 @@ static enum fwu_agent_error_t erase_bank(uint32_t bank_offset)
     }
 
     sectors = BANK_PARTITION_SIZE / FWU_METADATA_FLASH_SECTOR_SIZE;
+    image_sectors = (image_size + FWU_METADATA_FLASH_SECTOR_SIZE - 1) /
+                    FWU_METADATA_FLASH_SECTOR_SIZE;
 
     FWU_LOG_MSG("%s: erasing sectors = %u, from offset = %u\n\r", __func__,
                      sectors, bank_offset);
 
     for (int i = 0; i < sectors; i++) {
-        ret = FWU_METADATA_FLASH_DEV.EraseSector(
-                bank_offset + (i * FWU_METADATA_FLASH_SECTOR_SIZE));
+        sector_offset = bank_offset + (i * FWU_METADATA_FLASH_SECTOR_SIZE);
+        if ((i >= image_sectors) && sector_is_blank(sector_offset)) {
+            continue;
+        }
+
+        ret = FWU_METADATA_FLASH_DEV.EraseSector(sector_offset);
         if (ret != ARM_DRIVER_OK) {
             return FWU_AGENT_ERROR;
         }
@@ -778,7 +821,7 @@ static enum fwu_agent_error_t flash_full_capsule(
         return FWU_AGENT_ERROR;
     }
 
-    if (erase_bank(bank_offset)) {
+    if (erase_bank(bank_offset, size)) {
         return FWU_AGENT_ERROR;
     }
 
@@ -30,6 +30,9 @@ typedef struct {
     uintptr_t base;
     uint32_t file_pos;
     uint32_t size;
+    /* Blocks held by the buffer of the device, valid while cache_len != 0 */
+    int cache_lba;
+    size_t cache_len;
 } block_dev_state_t;
 
 #define is_power_of_2(x) (((x) != 0U) && (((x) & ((x)-1U)) == 0U))
@@ -141,6 +144,8 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
     cur->base = region->offset;
     cur->size = region->length;
     cur->file_pos = 0;
+    /* The flash may have been written without this layer since the last use */
+    cur->cache_len = 0;
 
     entity->info = (uintptr_t)cur;
     return 0;
@@ -238,6 +243,11 @@ static int block_seek(io_entity_t *entity, int mode, size_t offset) {
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * The buffer is also a read cache. On a miss, it is filled from the first
+ * block to read, which reads ahead of the request, so the small sequential
+ * reads of the GPT and FIP entries are served from the buffer rather than by
+ * one flash command each.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
                       size_t *length_read) {
@@ -261,6 +271,9 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
      */
     size_t padding;
 
+    /* offset in the buffer of the block containing file_pos */
+    size_t buf_off;
+
     assert(entity->info != (uintptr_t)NULL);
     cur = (block_dev_state_t *)entity->info;
     ops = &(cur->dev_spec->ops);
@@ -291,24 +304,23 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
          */
         lba = (cur->file_pos + cur->base) / block_size;
 
-        if ((skip + left) > buf->length) {
-            /*
-             * The underlying read buffer is too small to
-             * read all the required data - limit to just
-             * fill the buffer, and then read again.
-             */
-            request = buf->length;
+        if ((cur->cache_len != 0U) && (lba >= cur->cache_lba) &&
+            ((size_t)(lba - cur->cache_lba) * block_size + skip <
+             cur->cache_len)) {
+            /* The block is in the buffer already */
+            buf_off = (size_t)(lba - cur->cache_lba) * block_size;
+            request = cur->cache_len - buf_off;
         } else {
-            /*
-             * The underlying read buffer is big enough to
-             * read all the required data. Calculate the
-             * number of bytes to read to align with the
-             * block size.
-             */
-            request = skip + left;
-            request = (request + (block_size - 1U)) & ~(block_size - 1U);
+            /* Fill the whole buffer, reading ahead of the request */
+            buf_off = 0U;
+            request = ops->read(lba, buf->offset, buf->length);
+            if (request > buf->length) {
+                cur->cache_len = 0U;
+                return -EIO;
+            }
+            cur->cache_lba = lba;
+            cur->cache_len = request;
         }
-        request = ops->read(lba, buf->offset, request);
 
         if (request <= skip) {
             /*
@@ -328,7 +340,8 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
         padding = (nbytes > left) ? nbytes - left : 0U;
         nbytes -= padding;
 
-        memcpy((void *)(buffer + count), (void *)(buf->offset + skip), nbytes);
+        memcpy((void *)(buffer + count), (void *)(buf->offset + buf_off + skip),
+               nbytes);
 
         cur->file_pos += nbytes;
         count += nbytes;
@@ -374,6 +387,9 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
     assert((length <= cur->size) && (length > 0U) && (ops->read != 0) &&
            (ops->write != 0));
 
+    /* The buffer is used to stage the writes */
+    cur->cache_len = 0;
+
     /*
      * We don't know the number of bytes that we are going
      * to write in every iteration, because it will depend
@@ -435,9 +435,16 @@ static void otp_write_unchecked(struct lcm_dev_t *dev, uint32_t offset,
     uint32_t idx;
     struct _lcm_reg_map_t *p_lcm = (struct _lcm_reg_map_t *)dev->cfg->base;
 
-    /* Perform the actual write */
+    /* Perform the actual write. Programming an OTP word takes much longer
+     * than reading it, so the words which already hold their value, such as
+     * the zero words of a field or the words written before an interrupted
+     * provisioning, are not programmed again.
+     */
     for (idx = 0; idx < len / sizeof(uint32_t); idx++) {
-        p_lcm->raw_otp[(offset / sizeof(uint32_t)) + idx] = p_buf_word[idx];
+        if (p_lcm->raw_otp[(offset / sizeof(uint32_t)) + idx] !=
+            p_buf_word[idx]) {
+            p_lcm->raw_otp[(offset / sizeof(uint32_t)) + idx] = p_buf_word[idx];
+        }
     }
 }
 
@@ -889,22 +896,14 @@ enum lcm_error_t lcm_otp_write(struct lcm_dev_t *dev, uint32_t offset, uint32_t
 }
 
 
-/* Armclang attempts to inline this function, which causes huge code size
- * increases. It is marked as __attribute__((noinline)) explicitly to prevent
- * this.
- */
-__attribute__((noinline))
-enum lcm_error_t lcm_otp_read(struct lcm_dev_t *dev, uint32_t offset,
-                              uint32_t len, uint8_t *buf)
+static enum lcm_error_t check_otp_read_args(struct lcm_dev_t *dev,
+                                            uint32_t offset, uint32_t len,
+                                            uint8_t *buf)
 {
     enum lcm_error_t err;
-    struct _lcm_reg_map_t *p_lcm = (struct _lcm_reg_map_t *)dev->cfg->base;
-    uint32_t *p_buf_word = (uint32_t *)buf;
-    uint32_t validation_word;
     uint32_t otp_size;
-    uint32_t idx;
 
-    if (!is_pointer_word_aligned(p_buf_word)) {
+    if (!is_pointer_word_aligned((uint32_t *)buf)) {
         FATAL_ERR(LCM_ERROR_INVALID_ALIGNMENT);
         return LCM_ERROR_INVALID_ALIGNMENT;
     }
@@ -929,6 +928,28 @@ enum lcm_error_t lcm_otp_read(struct lcm_dev_t *dev, uint32_t offset,
         return LCM_ERROR_INVALID_OFFSET;
     }
 
+    return LCM_ERROR_NONE;
+}
+
+/* Armclang attempts to inline this function, which causes huge code size
+ * increases. It is marked as __attribute__((noinline)) explicitly to prevent
+ * this.
+ */
+__attribute__((noinline))
+enum lcm_error_t lcm_otp_read(struct lcm_dev_t *dev, uint32_t offset,
+                              uint32_t len, uint8_t *buf)
+{
+    enum lcm_error_t err;
+    struct _lcm_reg_map_t *p_lcm = (struct _lcm_reg_map_t *)dev->cfg->base;
+    uint32_t *p_buf_word = (uint32_t *)buf;
+    uint32_t validation_word;
+    uint32_t idx;
+
+    err = check_otp_read_args(dev, offset, len, buf);
+    if (err != LCM_ERROR_NONE) {
+        return err;
+    }
+
     for (idx = 0; idx < len / sizeof(uint32_t); idx++) {
         p_buf_word[idx] = p_lcm->raw_otp[(offset / sizeof(uint32_t)) + idx];
 
@@ -950,6 +971,46 @@ enum lcm_error_t lcm_otp_read(struct lcm_dev_t *dev, uint32_t offset,
     return LCM_ERROR_NONE;
 }
 
+__attribute__((noinline))
+enum lcm_error_t lcm_otp_read_burst(struct lcm_dev_t *dev, uint32_t offset,
+                                    uint32_t len, uint8_t *buf)
+{
+    enum lcm_error_t err;
+    struct _lcm_reg_map_t *p_lcm = (struct _lcm_reg_map_t *)dev->cfg->base;
+    uint32_t *p_buf_word = (uint32_t *)buf;
+    const volatile uint32_t *p_otp_word;
+    uint32_t idx;
+
+    err = check_otp_read_args(dev, offset, len, buf);
+    if (err != LCM_ERROR_NONE) {
+        return err;
+    }
+
+    p_otp_word = &p_lcm->raw_otp[offset / sizeof(uint32_t)];
+
+    /* Sequential reads, without a delay between the words */
+    for (idx = 0; idx < len / sizeof(uint32_t); idx++) {
+        p_buf_word[idx] = p_otp_word[idx];
+    }
+
+    /* The double read verify of the user area is a second pass over the
+     * block, after a single random delay.
+     */
+    if (offset >= sizeof(struct lcm_otp_layout_t)) {
+#ifdef KMU_S
+        kmu_random_delay(&KMU_DEV_S, KMU_DELAY_LIMIT_32_CYCLES);
+#endif /* KMU_S */
+        for (idx = 0; idx < len / sizeof(uint32_t); idx++) {
+            if (p_otp_word[idx] != p_buf_word[idx]) {
+                FATAL_ERR(LCM_ERROR_READ_VERIFY_FAIL);
+                return LCM_ERROR_READ_VERIFY_FAIL;
+            }
+        }
+    }
+
+    return LCM_ERROR_NONE;
+}
+
 enum lcm_error_t lcm_dcu_get_enabled(struct lcm_dev_t *dev, uint8_t *val)
 {
     struct _lcm_reg_map_t *p_lcm = (struct _lcm_reg_map_t *)dev->cfg->base;
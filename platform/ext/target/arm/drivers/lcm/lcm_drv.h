@@ -272,6 +272,28 @@ enum lcm_error_t lcm_otp_write(struct lcm_dev_t *dev, uint32_t offset, uint32_t
 enum lcm_error_t lcm_otp_read(struct lcm_dev_t *dev, uint32_t offset, uint32_t len,
                               uint8_t *buf);
 
+/**
+ * \brief This function reads a large region of the OTP managed by the LCM in a
+ *        single burst.
+ *
+ * \param[in] dev       The LCM device structure.
+ * \param[in] offset    The offset into the OTP to read. Must be 4 byte aligned
+ * \param[in] len       The length of the OTP region to read. Must be 4 byte
+ *                      aligned.
+ * \param[out] buf      The buffer that will be filled with the OTP content.
+ *                      Must be 4 byte aligned and of a multiple of 4 bytes in
+ *                      length.
+ *
+ * \note Unlike \ref lcm_otp_read, the words are read back to back and the
+ *       software double read verify of the user area is a second pass over
+ *       the whole region, after a single random delay. It is meant for large
+ *       fields, such as images, whose content is authenticated by the caller.
+ *
+ * \return Returns error code as specified in \ref lcm_error_t
+ */
+enum lcm_error_t lcm_otp_read_burst(struct lcm_dev_t *dev, uint32_t offset,
+                                    uint32_t len, uint8_t *buf);
+
 /**
  * \brief This function gets the state of the Debug Control Unit.
  *
@@ -5,8 +5,13 @@
  *
  */
 
+#include <string.h>
+#include "array.h"
+#include "config_tfm.h"
 #include "platform/include/tfm_platform_system.h"
 #include "tfm_hal_device_header.h"
+#include "tfm_spm_call_latency.h"
+#include "tfm_spm_trace.h"
 
 void tfm_platform_hal_system_reset(void)
 {
@@ -14,10 +19,95 @@ void tfm_platform_hal_system_reset(void)
     NVIC_SystemReset();
 }
 
+#ifdef TFM_SPM_TRACE
+/*
+ * Input:  the sequence number of the first event to read (uint32_t).
+ * Output: the sequence number to read from next time (uint32_t), followed by
+ *         the events read.
+ */
+static enum tfm_platform_err_t spm_trace_ioctl_read(psa_invec *in_vec,
+                                                    psa_outvec *out_vec)
+{
+    struct spm_trace_event_t events[4];
+    uint8_t *p_out;
+    size_t space, num;
+    uint32_t seq;
+
+    if ((in_vec == NULL) || (in_vec->len != sizeof(seq)) ||
+        (out_vec == NULL) || (out_vec->len < sizeof(seq))) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    (void)memcpy(&seq, in_vec->base, sizeof(seq));
+
+    /* The output buffer may not be aligned for the events, copy by chunks. */
+    p_out = (uint8_t *)out_vec->base + sizeof(seq);
+    space = (out_vec->len - sizeof(seq)) / sizeof(events[0]);
+    while (space > 0) {
+        num = spm_trace_read(seq, events,
+                             space < ARRAY_SIZE(events) ?
+                                            space : ARRAY_SIZE(events),
+                             &seq);
+        if (num == 0) {
+            break;
+        }
+        (void)memcpy(p_out, events, num * sizeof(events[0]));
+        p_out += num * sizeof(events[0]);
+        space -= num;
+    }
+
+    (void)memcpy(out_vec->base, &seq, sizeof(seq));
+    out_vec->len = (size_t)(p_out - (uint8_t *)out_vec->base);
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+#endif /* TFM_SPM_TRACE */
+
+#if CONFIG_TFM_CALL_LATENCY == 1
+/*
+ * Input:  the SID of the service (uint32_t).
+ * Output: the call latency histograms of the service.
+ */
+static enum tfm_platform_err_t spm_call_latency_ioctl_read(psa_invec *in_vec,
+                                                           psa_outvec *out_vec)
+{
+    struct spm_call_latency_t latency;
+    uint32_t sid;
+
+    if ((in_vec == NULL) || (in_vec->len != sizeof(sid)) ||
+        (out_vec == NULL) || (out_vec->len < sizeof(latency))) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    (void)memcpy(&sid, in_vec->base, sizeof(sid));
+
+    if (spm_get_call_latency(sid, &latency) != PSA_SUCCESS) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    /* The output buffer may not be aligned for the histograms */
+    (void)memcpy(out_vec->base, &latency, sizeof(latency));
+    out_vec->len = sizeof(latency);
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+#endif /* CONFIG_TFM_CALL_LATENCY == 1 */
+
 enum tfm_platform_err_t tfm_platform_hal_ioctl(tfm_platform_ioctl_req_t request,
                                                psa_invec  *in_vec,
                                                psa_outvec *out_vec)
 {
+#ifdef TFM_SPM_TRACE
+    if (request == SPM_TRACE_IOCTL_REQ_READ) {
+        return spm_trace_ioctl_read(in_vec, out_vec);
+    }
+#endif
+#if CONFIG_TFM_CALL_LATENCY == 1
+    if (request == SPM_CALL_LATENCY_IOCTL_REQ_READ) {
+        return spm_call_latency_ioctl_read(in_vec, out_vec);
+    }
+#endif
+
     (void)request;
     (void)in_vec;
     (void)out_vec;
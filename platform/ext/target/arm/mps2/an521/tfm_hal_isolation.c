@@ -52,6 +52,18 @@ REGION_DECLARE(Image$$, TFM_SP_META_PTR_END, $$ZI$$Limit);
 #define MIN_NR_PRIVATE_DATA_REGION    1
 
 static uint32_t idx_boundary_handle = 0;
+
+/*
+ * The static regions of the SPM and of the privileged partitions stay loaded,
+ * so only the partition specific regions, from n_configured_regions onwards,
+ * change on a boundary switch. Keep track of what is loaded into them, so that
+ * the MPU is only reprogrammed when switching to an unprivileged partition
+ * other than the last one, and then only for the regions which differ.
+ */
+static bool loaded_boundary_valid = false;
+static uintptr_t loaded_boundary;
+static uint32_t loaded_region_mask = 0;
+static struct mpu_armv8m_region_cfg_t loaded_region_cfg[MPU_REGION_NUM];
 REGION_DECLARE(Image$$, PT_RO_START, $$Base);
 REGION_DECLARE(Image$$, PT_RO_END, $$Base);
 REGION_DECLARE(Image$$, PT_PRIV_RWZI_START, $$Base);
@@ -162,6 +174,53 @@ const struct mpu_armv8m_region_cfg_t region_cfg[] = {
 #endif /* TFM_ISOLATION_LEVEL == 3 */
 #endif /* CONFIG_TFM_ENABLE_MEMORY_PROTECT */
 
+#if defined(CONFIG_TFM_ENABLE_MEMORY_PROTECT) && (TFM_ISOLATION_LEVEL == 3)
+/* Programs a partition specific MPU region, unless it is already loaded. */
+static FIH_RET_TYPE(enum mpu_armv8m_error_t) load_partition_region(
+                                    struct mpu_armv8m_region_cfg_t *p_cfg)
+{
+    fih_int fih_rc = FIH_FAILURE;
+    uint32_t region_nr = p_cfg->region_nr;
+
+    if ((loaded_region_mask & (1UL << region_nr)) &&
+        (memcmp(&loaded_region_cfg[region_nr], p_cfg, sizeof(*p_cfg)) == 0)) {
+        FIH_RET(fih_int_encode(MPU_ARMV8M_OK));
+    }
+
+    loaded_region_mask &= ~(1UL << region_nr);
+
+    FIH_CALL(mpu_armv8m_region_enable, fih_rc, &dev_mpu_s, p_cfg);
+    if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
+        FIH_RET(fih_rc);
+    }
+
+    memcpy(&loaded_region_cfg[region_nr], p_cfg, sizeof(*p_cfg));
+    loaded_region_mask |= 1UL << region_nr;
+
+    FIH_RET(fih_int_encode(MPU_ARMV8M_OK));
+}
+
+/* Disables a partition specific MPU region, unless it is already disabled. */
+static FIH_RET_TYPE(enum mpu_armv8m_error_t) unload_partition_region(
+                                                          uint32_t region_nr)
+{
+    fih_int fih_rc = FIH_FAILURE;
+
+    if (!(loaded_region_mask & (1UL << region_nr))) {
+        FIH_RET(fih_int_encode(MPU_ARMV8M_OK));
+    }
+
+    FIH_CALL(mpu_armv8m_region_disable, fih_rc, &dev_mpu_s, region_nr);
+    if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
+        FIH_RET(fih_rc);
+    }
+
+    loaded_region_mask &= ~(1UL << region_nr);
+
+    FIH_RET(fih_int_encode(MPU_ARMV8M_OK));
+}
+#endif /* CONFIG_TFM_ENABLE_MEMORY_PROTECT && TFM_ISOLATION_LEVEL == 3 */
+
 #ifdef TFM_FIH_PROFILE_ON
 #ifdef CONFIG_TFM_ENABLE_MEMORY_PROTECT
 static fih_int fih_verify_mpu_armv8m_region_enabled(
@@ -554,6 +613,12 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
         FIH_RET(fih_int_encode(TFM_HAL_SUCCESS));
     }
 
+    /* The regions of this partition are still loaded */
+    if (loaded_boundary_valid && (loaded_boundary == boundary)) {
+        FIH_RET(fih_int_encode(TFM_HAL_SUCCESS));
+    }
+    loaded_boundary_valid = false;
+
     /* Setup runtime memory first */
     localcfg.attr_exec = MPU_ARMV8M_XN_EXEC_NEVER;
     localcfg.attr_sh = MPU_ARMV8M_SH_NONE;
@@ -571,7 +636,7 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
         localcfg.region_base = rt_mem[i].mem.start;
         localcfg.region_limit = rt_mem[i].mem.limit - 1;
 
-        FIH_CALL(mpu_armv8m_region_enable, fih_rc, &dev_mpu_s, &localcfg);
+        FIH_CALL(load_partition_region, fih_rc, &localcfg);
         if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
             FIH_RET(fih_int_encode(TFM_HAL_ERROR_GENERIC));
         }
@@ -597,7 +662,7 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
         localcfg.region_base = plat_data_ptr->periph_start;
         localcfg.region_limit = plat_data_ptr->periph_limit;
 
-        FIH_CALL(mpu_armv8m_region_enable, fih_rc, &dev_mpu_s, &localcfg);
+        FIH_CALL(load_partition_region, fih_rc, &localcfg);
         if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
             FIH_RET(fih_int_encode(TFM_HAL_ERROR_GENERIC));
         }
@@ -609,11 +674,14 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
 
     /* Disable unused regions */
     while (i < MPU_REGION_NUM) {
-        FIH_CALL(mpu_armv8m_region_disable, fih_rc, &dev_mpu_s, i++);
+        FIH_CALL(unload_partition_region, fih_rc, i++);
         if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
             FIH_RET(fih_int_encode(TFM_HAL_ERROR_GENERIC));
         }
     }
+
+    loaded_boundary = boundary;
+    loaded_boundary_valid = true;
 #endif /* TFM_ISOLATION_LEVEL == 3 */
     FIH_RET(fih_int_encode(TFM_HAL_SUCCESS));
 }
@@ -99,6 +99,7 @@ target_sources(platform_s
         ${ETHOS_DRIVER_PATH}/src/ethosu_device_u55_u65.c
         $<$<OR:$<BOOL:${TFM_PARTITION_SLIH_TEST}>,$<BOOL:${TFM_PARTITION_FLIH_TEST}>>:${CORSTONE310_COMMON_DIR}/plat_test.c>
         $<$<BOOL:${TFM_PARTITION_PLATFORM}>:${CORSTONE310_COMMON_DIR}/services/src/tfm_platform_system.c>
+        $<$<BOOL:${TFM_PARTITION_NPU}>:${CORSTONE310_COMMON_DIR}/tfm_hal_npu.c>
 )
 
 target_sources(tfm_sprt
@@ -217,6 +218,7 @@ target_sources(tfm_spm
         ${PLATFORM_DIR}/ext/common/tfm_hal_isolation_v8m.c
         ${CMAKE_CURRENT_SOURCE_DIR}/dma_init.c
         $<$<OR:$<BOOL:${CONFIG_TFM_FLIH_API}>,$<BOOL:${CONFIG_TFM_SLIH_API}>>:${PLATFORM_DIR}/ext/common/tfm_interrupts.c>
+        $<$<BOOL:${TFM_PARTITION_NPU}>:${CORSTONE310_COMMON_DIR}/npu_interrupts.c>
 )
 
 # If this is not added to the tfm_s it will not correctly override the weak
@@ -31,3 +31,4 @@ set(TFM_MULTI_CORE_TOPOLOGY           OFF)
 set(ETHOSU_ARCH                       "U55")
 set(ETHOS_DRIVER_PATH                 "DOWNLOAD"  CACHE PATH      "Path to Ethos-U Core Driver (or DOWNLOAD to fetch automatically")
 set(ETHOSU_LOG_SEVERITY               "-1"        CACHE STRING    "Ethos-U Core Driver log severity")
+set(PLATFORM_HAS_NPU_SUPPORT          ON)
@@ -567,8 +567,14 @@ struct mpc_sie_dev_t MPC_DDR4_DEV_S = {
     &(MPC_DDR4_DEV_CFG_S),
     &(MPC_DDR4_DEV_DATA_S)};
 
+/* The NPU partition owns the NPU, which then runs secure command streams */
 struct ethosu_device NPU0_S = {
     .reg = (struct NPU_REG *)NPU0_APB_BASE_S,
+#ifdef TFM_PARTITION_NPU
+    .secure = 1,
+    .privileged = 1,
+#else
     .secure = 0,
     .privileged = 0,
+#endif
 };
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "tfm_hal_device_header.h"
+#include "spm.h"
+#include "tfm_hal_interrupt.h"
+#include "tfm_peripherals_def.h"
+#include "interrupt.h"
+#include "load/interrupt_defs.h"
+
+static struct irq_t npu_irq = {0};
+
+void NPU0_Handler(void)
+{
+    spm_handle_interrupt(npu_irq.p_pt, npu_irq.p_ildi);
+}
+
+enum tfm_hal_status_t tfm_npu_irq_init(void *p_pt,
+                                       const struct irq_load_info_t *p_ildi)
+{
+    npu_irq.p_ildi = p_ildi;
+    npu_irq.p_pt = p_pt;
+
+    NVIC_SetPriority(TFM_NPU_IRQ, DEFAULT_IRQ_PRIORITY);
+    NVIC_ClearTargetState(TFM_NPU_IRQ);
+    NVIC_DisableIRQ(TFM_NPU_IRQ);
+
+    return TFM_HAL_SUCCESS;
+}
@@ -113,6 +113,13 @@ struct platform_data_t tfm_peripheral_timer0 = {
         SYSTEM_TIMER0_PERIPH_PPC0_POS_MASK
 };
 
+struct platform_data_t tfm_peripheral_npu0 = {
+        NPU0_APB_BASE_S,
+        NPU0_APB_BASE_S + 0xFFF,
+        PPC_SP_DO_NOT_CONFIGURE,
+        -1
+};
+
 static ARM_DRIVER_PPC_CORSTONE310 *const ppc_bank_drivers[] = {
         &Driver_MAIN0_PPC_CORSTONE310,
         &Driver_MAIN_EXP0_PPC_CORSTONE310,
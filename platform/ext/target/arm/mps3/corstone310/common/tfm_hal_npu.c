@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tfm_hal_device_header.h"
+#include "tfm_hal_npu.h"
+#include "ethosu_device.h"
+#include "platform_s_device_definition.h"
+
+/* Base pointers of the Ethos-U55 */
+#define NPU_BASEP_MAX       8
+
+/*
+ * The regions of the running command stream, its outputs are invalidated in
+ * the data cache once it ends. The NPU masters the same memory map as the
+ * CPU, so the addresses are used as they are.
+ */
+static struct {
+    bool busy;
+    uint32_t num;
+    uint32_t out_mask;
+    uintptr_t addr[NPU_BASEP_MAX];
+    size_t size[NPU_BASEP_MAX];
+} npu_job;
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define NPU_DCACHE_LINE_MASK    ((uintptr_t)__SCB_DCACHE_LINE_SIZE - 1U)
+
+/*
+ * Discards the lines of an output region from the data cache. The lines it
+ * shares with other data at its edges are cleaned first, so that the dirty
+ * data of the CPU there is not lost.
+ */
+static void npu_invalidate_output(uintptr_t addr, size_t size)
+{
+    uintptr_t end = addr + size;
+    uintptr_t head = addr & ~NPU_DCACHE_LINE_MASK;
+    uintptr_t tail = end & ~NPU_DCACHE_LINE_MASK;
+
+    if (size == 0) {
+        return;
+    }
+
+    if (head != addr) {
+        SCB_CleanInvalidateDCache_by_Addr((void *)head,
+                                          (int32_t)__SCB_DCACHE_LINE_SIZE);
+        head += __SCB_DCACHE_LINE_SIZE;
+    }
+    if ((tail != end) && (tail >= head)) {
+        SCB_CleanInvalidateDCache_by_Addr((void *)tail,
+                                          (int32_t)__SCB_DCACHE_LINE_SIZE);
+    }
+    if (tail > head) {
+        SCB_InvalidateDCache_by_Addr((void *)head, (int32_t)(tail - head));
+    }
+}
+#endif
+
+enum tfm_hal_status_t tfm_hal_npu_init(void)
+{
+    /* The NPU was reset in its secure state by the platform init */
+    if (!ethosu_dev_verify_access_state(&NPU0_S)) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    return TFM_HAL_SUCCESS;
+}
+
+enum tfm_hal_status_t tfm_hal_npu_start(const void *cmd, size_t cmd_size,
+                                        void *const base_addr[],
+                                        const size_t base_size[],
+                                        uint32_t num, uint32_t out_mask)
+{
+    uint64_t npu_addr[NPU_BASEP_MAX];
+    uint32_t i;
+
+    if (num > NPU_BASEP_MAX) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+    if (npu_job.busy) {
+        return TFM_HAL_ERROR_BAD_STATE;
+    }
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_CleanDCache_by_Addr((void *)cmd, (int32_t)cmd_size);
+#endif
+    for (i = 0; i < num; i++) {
+        npu_addr[i] = (uintptr_t)base_addr[i];
+        npu_job.addr[i] = (uintptr_t)base_addr[i];
+        npu_job.size[i] = base_size[i];
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+        /* The NPU may read any region, and the outputs must not be evicted
+         * over the NPU writes.
+         */
+        SCB_CleanDCache_by_Addr(base_addr[i], (int32_t)base_size[i]);
+#endif
+    }
+    npu_job.num = num;
+    npu_job.out_mask = out_mask;
+    npu_job.busy = true;
+
+    ethosu_dev_run_command_stream(&NPU0_S, (const uint8_t *)cmd,
+                                  (uint32_t)cmd_size, npu_addr, (int)num);
+
+    return TFM_HAL_SUCCESS;
+}
+
+enum tfm_hal_status_t tfm_hal_npu_finish(void)
+{
+    bool done;
+    uint32_t i;
+
+    done = ethosu_dev_handle_interrupt(&NPU0_S);
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    for (i = 0; i < npu_job.num; i++) {
+        if ((npu_job.out_mask & (1UL << i)) != 0U) {
+            npu_invalidate_output(npu_job.addr[i], npu_job.size[i]);
+        }
+    }
+#else
+    (void)i;
+#endif
+    npu_job.busy = false;
+
+    if (!done) {
+        /* A fault stops the NPU until it is reset */
+        (void)ethosu_dev_soft_reset(&NPU0_S);
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    return TFM_HAL_SUCCESS;
+}
@@ -13,6 +13,7 @@
 const uintptr_t partition_named_mmio_list[] = {
     (uintptr_t)TFM_PERIPHERAL_TIMER0,
     (uintptr_t)TFM_PERIPHERAL_STD_UART,
+    (uintptr_t)TFM_PERIPHERAL_NPU0,
 #ifdef PSA_API_TEST_IPC
     (uintptr_t)FF_TEST_UART_REGION,
     (uintptr_t)FF_TEST_WATCHDOG_REGION,
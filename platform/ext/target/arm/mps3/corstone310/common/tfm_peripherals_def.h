@@ -24,6 +24,7 @@ extern "C" {
 
 #define TFM_TIMER0_IRQ           (TIMER0_IRQn)
 #define TFM_TIMER1_IRQ           (TIMER1_IRQn)
+#define TFM_NPU_IRQ              (NPU0_IRQn)
 
 #define TFM_FPU_S_TEST_IRQ       (UART0_Combined_IRQn)
 #define TFM_FPU_NS_TEST_IRQ      (UART1_Combined_IRQn)
@@ -32,9 +33,11 @@ extern "C" {
 
 extern struct platform_data_t tfm_peripheral_std_uart;
 extern struct platform_data_t tfm_peripheral_timer0;
+extern struct platform_data_t tfm_peripheral_npu0;
 
 #define TFM_PERIPHERAL_STD_UART  (&tfm_peripheral_std_uart)
 #define TFM_PERIPHERAL_TIMER0    (&tfm_peripheral_timer0)
+#define TFM_PERIPHERAL_NPU0      (&tfm_peripheral_npu0)
 
 #ifdef CORSTONE310_FVP
 #define TFM_DMA0_CH0_IRQ         (DMA_CHANNEL_0_IRQn)
@@ -650,6 +650,37 @@ enum tfm_plat_err_t tfm_plat_otp_read(enum tfm_otp_element_id_t id,
     }
 }
 
+enum tfm_plat_err_t tfm_plat_otp_read_burst(enum tfm_otp_element_id_t id,
+                                            size_t offset, size_t out_len,
+                                            uint8_t *out)
+{
+    enum tfm_plat_err_t err;
+    size_t size;
+
+    /* Only the BL1_2 image is large enough to benefit from bursts */
+    if (id != PLAT_OTP_ID_BL1_2_IMAGE) {
+        return TFM_PLAT_ERR_UNSUPPORTED;
+    }
+
+    err = otp_read(USER_AREA_OFFSET(cm_locked.bl1_2_image_len),
+                   USER_AREA_SIZE(cm_locked.bl1_2_image_len),
+                   sizeof(size), (uint8_t *)&size);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+
+    if (offset > size || out_len > size - offset) {
+        return TFM_PLAT_ERR_INVALID_INPUT;
+    }
+
+    if (lcm_otp_read_burst(&LCM_DEV_S, OTP_TOTAL_SIZE - size + offset,
+                           out_len, out) != LCM_ERROR_NONE) {
+        return TFM_PLAT_ERR_SYSTEM_ERR;
+    }
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
 static enum tfm_plat_err_t otp_write_lcs(size_t in_len, const uint8_t *in)
 {
     enum tfm_plat_err_t err;
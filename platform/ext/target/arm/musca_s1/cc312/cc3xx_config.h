@@ -73,6 +73,14 @@
 #define CC3XX_CONFIG_DMA_REMAP_REGION_AM 4
 #endif /* CC3XX_CONFIG_DMA_REMAP_REGION_AM */
 
+/* Whether the state of the last multipart hash operation updated through the
+ * PSA driver is left in the engine between its calls, and only saved back when
+ * another operation or another user of the engine needs it. The operations
+ * must all run in the same context, as the one taking the engine writes the
+ * state of the owner back into its operation.
+ */
+/* #define CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
+
 /* Whether RNG is enabled */
 #define CC3XX_CONFIG_RNG_ENABLE
 
@@ -37,6 +37,30 @@ enum tfm_hal_status_t tfm_timer0_irq_init(void *p_pt,
     return TFM_HAL_SUCCESS;
 }
 
+#ifdef CC312_IRQ_WAIT_ENABLED
+
+static struct irq_t cc312_irq = {0};
+
+void TFM_CC312_IRQ_Handler(void)
+{
+    spm_handle_interrupt(cc312_irq.p_pt, cc312_irq.p_ildi);
+}
+
+enum tfm_hal_status_t tfm_cc312_irq_init(void *p_pt,
+                                         const struct irq_load_info_t *p_ildi)
+{
+    cc312_irq.p_ildi = p_ildi;
+    cc312_irq.p_pt = p_pt;
+
+    NVIC_SetPriority(TFM_CC312_IRQ, DEFAULT_IRQ_PRIORITY);
+    NVIC_ClearTargetState(TFM_CC312_IRQ);
+    NVIC_DisableIRQ(TFM_CC312_IRQ);
+
+    return TFM_HAL_SUCCESS;
+}
+
+#endif
+
 #ifdef PSA_API_TEST_IPC
 
 static struct irq_t ff_test_uart_irq;
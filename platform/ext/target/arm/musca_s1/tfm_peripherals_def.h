@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -23,6 +23,8 @@ extern "C" {
 
 #define TFM_TIMER0_IRQ           (TIMER0_IRQn)
 #define TFM_TIMER1_IRQ           (TIMER1_IRQn)
+#define TFM_CC312_IRQ            (CRYPTOCELL_IRQn)
+#define TFM_CC312_IRQ_Handler    CRYPTOCELL_Handler
 #define FF_TEST_UART_IRQ         (UART1_Tx_IRQn)
 #define FF_TEST_UART_IRQ_Handler UARTTX1_Handler
 #define TFM_FPU_S_TEST_IRQ       (TFM_FPU_S_TEST_IRQn)
@@ -7,6 +7,7 @@
 
 #include "crypto.h"
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -19,6 +20,14 @@
 
 #define KEY_DERIVATION_MAX_BUF_SIZE 128
 
+/* The hash and AES operations share the CC3XX engine and DMA state. If an AES
+ * operation is run while a staged SHA-256 is in progress, the hash state is
+ * saved beforehand and restored afterwards, so that decrypted data can be
+ * hashed as it is produced.
+ */
+static bool sha256_in_progress;
+static struct cc3xx_hash_state_t sha256_saved_state;
+
 fih_int bl1_sha256_init(void)
 {
     fih_int fih_rc = FIH_FAILURE;
@@ -27,6 +36,7 @@ fih_int bl1_sha256_init(void)
     if(fih_not_eq(fih_rc, FIH_SUCCESS)) {
         FIH_RET(FIH_FAILURE);
     }
+    sha256_in_progress = true;
 
     return FIH_SUCCESS;
 }
@@ -36,6 +46,7 @@ fih_int bl1_sha256_finish(uint8_t *hash)
     uint32_t tmp_buf[32 / sizeof(uint32_t)];
 
     cc3xx_lowlevel_hash_finish(tmp_buf, 32);
+    sha256_in_progress = false;
 
     memcpy(hash, tmp_buf, sizeof(tmp_buf));
 
@@ -145,6 +156,10 @@ int32_t bl1_aes_256_ctr_decrypt(enum tfm_bl1_key_id_t key_id,
         input_key = (uint8_t *)key_material;
     }
 
+    if (sha256_in_progress) {
+        cc3xx_lowlevel_hash_get_state(&sha256_saved_state);
+    }
+
     err = cc3xx_lowlevel_aes_init(CC3XX_AES_DIRECTION_DECRYPT, CC3XX_AES_MODE_CTR,
                                   kmu_key_slot, (uint32_t *)input_key,
                                   CC3XX_AES_KEYSIZE_256, (uint32_t *)counter, 16);
@@ -156,6 +171,10 @@ int32_t bl1_aes_256_ctr_decrypt(enum tfm_bl1_key_id_t key_id,
     cc3xx_lowlevel_aes_update(ciphertext, ciphertext_length);
     cc3xx_lowlevel_aes_finish(NULL, NULL);
 
+    if (sha256_in_progress) {
+        cc3xx_lowlevel_hash_set_state(&sha256_saved_state);
+    }
+
     return 0;
 }
 
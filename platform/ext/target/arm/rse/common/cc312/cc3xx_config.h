@@ -68,11 +68,28 @@
  */
 /* #define CC3XX_CONFIG_DMA_WFI_WAIT_ENABLE */
 
+/* Whether CC will WFE, woken by its interrupt becoming pending, instead of
+ * busy-wait looping while waiting for DMA operations to complete. The IRQ does
+ * not need to be enabled, so no handler is required.
+ */
+#define CC3XX_CONFIG_DMA_WFE_WAIT_ENABLE
+#ifndef CC3XX_CONFIG_DMA_WFE_WAIT_IRQN
+#define CC3XX_CONFIG_DMA_WFE_WAIT_IRQN Crypto_Engine_S_IRQn
+#endif /* CC3XX_CONFIG_DMA_WFE_WAIT_IRQN */
+
 /* How many DMA remap regions are available */
 #ifndef CC3XX_CONFIG_DMA_REMAP_REGION_AM
 #define CC3XX_CONFIG_DMA_REMAP_REGION_AM 4
 #endif /* CC3XX_CONFIG_DMA_REMAP_REGION_AM */
 
+/* Whether the state of the last multipart hash operation updated through the
+ * PSA driver is left in the engine between its calls, and only saved back when
+ * another operation or another user of the engine needs it. The operations
+ * must all run in the same context, as the one taking the engine writes the
+ * state of the owner back into its operation.
+ */
+/* #define CC3XX_CONFIG_ENGINE_LAZY_SWITCH_ENABLE */
+
 /* Whether RNG is enabled */
 #define CC3XX_CONFIG_RNG_ENABLE
 
@@ -175,6 +192,13 @@
 #define CC3XX_CONFIG_ECDSA_VERIFY_ENABLE
 #define CC3XX_CONFIG_ECDSA_KEYGEN_ENABLE
 
+/* How many ECDSA ephemeral keys can be computed ahead of the signatures, with
+ * cc3xx_lowlevel_ecdsa_precompute(). 0 disables it.
+ */
+#ifndef CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS
+#define CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS 0
+#endif /* CC3XX_CONFIG_ECDSA_PRECOMPUTE_SLOTS */
+
 /* Whether DPA mitigations are enabled. Has a code-size and performance cost */
 #define CC3XX_CONFIG_DPA_MITIGATIONS_ENABLE
 
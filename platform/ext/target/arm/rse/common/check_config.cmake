@@ -19,6 +19,16 @@ tfm_invalid_config(RSE_USE_ROM_LIB_FROM_SRAM AND NOT RSE_SUPPORT_ROM_LIB_RELOCAT
 tfm_invalid_config(NOT BL1)
 tfm_invalid_config(NOT BL2)
 
+# The SIC is only used with XIP, and its PMON is started by the warm-up
+tfm_invalid_config(RSE_SIC_WARMUP AND NOT RSE_XIP)
+tfm_invalid_config(RSE_SIC_PMON AND NOT RSE_SIC_WARMUP)
+tfm_invalid_config(RSE_SIC_PMON AND NOT TFM_PARTITION_PLATFORM)
+
+# At least one request in flight, and a per-sender limit within the total
+tfm_invalid_config(RSE_COMMS_MAX_CONCURRENT_REQ LESS 1)
+tfm_invalid_config(RSE_COMMS_MAX_CONCURRENT_REQ_PER_SENDER GREATER RSE_COMMS_MAX_CONCURRENT_REQ)
+tfm_invalid_config(RSE_COMMS_RX_BATCH LESS 1)
+
 ########################## Attestation #########################################
 
 get_property(TFM_ATTESTATION_SCHEME_LIST CACHE TFM_ATTESTATION_SCHEME PROPERTY STRINGS)
@@ -14,6 +14,9 @@ if (RSE_XIP)
     set(MCUBOOT_NS_IMAGE_FLASH_AREA_NUM     11         CACHE STRING   "ID of the flash area containing the primary Non-Secure image")
 endif()
 
+set(RSE_SIC_WARMUP                      OFF        CACHE BOOL     "Whether to authenticate the SIC pages of the hot runtime code at boot")
+set(RSE_SIC_PMON                        OFF        CACHE BOOL     "Whether to count the SIC page hits and misses, read with a platform IOCTL. For profiling only")
+
 set(RSE_USE_HOST_UART                   ON         CACHE BOOL     "Whether RSE should setup to use the UART from the host system")
 set(RSE_HAS_EXPANSION_PERIPHERALS       OFF        CACHE BOOL     "Whether RSE has sub-platform specific peripherals in the expansion layer")
 
@@ -120,6 +123,10 @@ set(TFM_MULTI_CORE_TOPOLOGY             ON)
 
 set(PLAT_MHU_VERSION                    2          CACHE STRING  "Supported MHU version by platform")
 
+set(RSE_COMMS_MAX_CONCURRENT_REQ        2          CACHE STRING  "Maximum number of RSE comms requests in flight from all the senders")
+set(RSE_COMMS_MAX_CONCURRENT_REQ_PER_SENDER 0      CACHE STRING  "Maximum number of RSE comms requests in flight from one MHU sender, 0 for no limit other than RSE_COMMS_MAX_CONCURRENT_REQ")
+set(RSE_COMMS_EMBED_THRESHOLD           ""         CACHE STRING  "Largest RSE comms payload sent with the embed protocol rather than the pointer access protocol. Empty for the maximum embed payload size")
+set(RSE_COMMS_RX_BATCH                  1          CACHE STRING  "Maximum number of RSE comms messages received per MHU interrupt, when the sender has already sent them")
 set(RSE_AMOUNT                          1          CACHE STRING  "Amount of RSEes in the system")
 
 set(BL1_SHARED_SYMBOLS_PATH             ${CMAKE_CURRENT_LIST_DIR}/bl1/bl1_1_shared_symbols.txt CACHE FILEPATH "Path to list of symbols that BL1_1 that can be referenced from BL1_2")
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2023-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -50,6 +50,11 @@
 #define MIN_REGION_SIZE (sizeof(struct region_descriptor) + \
                          MIN_ALIGNED_STRUCT_SIZE)
 
+/* Number of structures whose location is kept in the RAM index */
+#ifndef SDS_INDEX_SIZE
+#define SDS_INDEX_SIZE           16
+#endif
+
 /* Header containing Shared Data Structure metadata */
 struct structure_header {
     /*
@@ -122,6 +127,21 @@ static struct sds_region region_config = {.host_addr = PLAT_RSE_AP_SDS_BASE,
                                           .size = PLAT_RSE_AP_SDS_SIZE,
                                           .is_init = false};
 
+/* Offset of a structure header within the SDS Memory Region */
+struct sds_index_entry {
+    uint32_t id;
+    size_t   offset;
+};
+
+/*
+ * Index of the first structures of the region, so that a lookup does not walk
+ * the headers in the region. Built on first access, and extended as the
+ * structures are added.
+ */
+static struct sds_index_entry sds_index[SDS_INDEX_SIZE];
+static size_t sds_index_count;
+static bool sds_index_built;
+
 /*
  * Perform some tests to determine whether any of the fields within a Structure
  * Header contain obviously invalid data.
@@ -159,33 +179,43 @@ static bool header_is_valid(const volatile struct region_descriptor *region,
     return true;
 }
 
-static int get_structure_info(uint32_t structure_id,
-                              struct structure_header *header,
-                              uint8_t **structure_base)
+static void sds_index_add(uint32_t structure_id, size_t offset)
 {
-   volatile struct structure_header *current_header;
-   size_t offset, region_size, struct_count, struct_idx;
-   struct region_descriptor *region_desc;
+    if (sds_index_count < SDS_INDEX_SIZE) {
+        sds_index[sds_index_count].id = structure_id;
+        sds_index[sds_index_count].offset = offset;
+        sds_index_count++;
+    }
+}
+
+/*
+ * Walk the structure headers from the one at offset, the struct_idx-th one of
+ * the region, to find one with a matching ID. The headers walked are indexed
+ * while the index is being built.
+ */
+static int walk_structures(uint32_t structure_id, size_t offset,
+                           size_t struct_idx, size_t *found_offset)
+{
+    volatile struct structure_header *current_header;
+    size_t region_size, struct_count;
+    struct region_descriptor *region_desc;
 
     region_desc = (struct region_descriptor *)region_config.mapped_addr;
     region_size = region_desc->region_size;
     struct_count = region_desc->structure_count;
-    offset = sizeof(struct region_descriptor);
 
     /* Iterate over structure headers to find one with a matching ID */
-    for (struct_idx = 0; struct_idx < struct_count; struct_idx++) {
+    for (; struct_idx < struct_count; struct_idx++) {
         current_header =
                 (struct structure_header *)(region_config.mapped_addr + offset);
         if (!header_is_valid(region_desc, current_header)) {
             return -1;
         }
+        if (!sds_index_built) {
+            sds_index_add(current_header->id, offset);
+        }
         if (current_header->id == structure_id) {
-            if (structure_base != NULL) {
-                *structure_base = ((uint8_t *)current_header
-                                     + sizeof(struct structure_header));
-            }
-
-            *header = *current_header;
+            *found_offset = offset;
             return 0;
         }
 
@@ -200,6 +230,70 @@ static int get_structure_info(uint32_t structure_id,
     return -1;
 }
 
+static void sds_index_build(void)
+{
+    size_t offset;
+
+    /* No structure has the ID 0, the walk goes through all of them */
+    sds_index_count = 0;
+    (void)walk_structures(0, sizeof(struct region_descriptor), 0, &offset);
+    sds_index_built = true;
+}
+
+static int get_structure_info(uint32_t structure_id,
+                              struct structure_header *header,
+                              uint8_t **structure_base)
+{
+    volatile struct structure_header *current_header;
+    struct region_descriptor *region_desc;
+    size_t offset, idx, struct_count;
+    int ret = -1;
+
+    region_desc = (struct region_descriptor *)region_config.mapped_addr;
+    struct_count = region_desc->structure_count;
+
+    if (!sds_index_built) {
+        sds_index_build();
+    }
+
+    for (idx = 0; idx < sds_index_count; idx++) {
+        if (sds_index[idx].id == structure_id) {
+            offset = sds_index[idx].offset;
+            ret = 0;
+            break;
+        }
+    }
+
+    /* Only the structures beyond the index are looked up in the region */
+    if ((ret != 0) && (sds_index_count > 0) &&
+        (sds_index_count < struct_count)) {
+        offset = sds_index[sds_index_count - 1].offset;
+        current_header =
+                (struct structure_header *)(region_config.mapped_addr + offset);
+        offset += sizeof(struct structure_header) + current_header->size;
+        ret = walk_structures(structure_id, offset, sds_index_count, &offset);
+    }
+
+    if (ret != 0) {
+        /* Structure with structure_id does not exist yet */
+        return -1;
+    }
+
+    current_header =
+                (struct structure_header *)(region_config.mapped_addr + offset);
+    if (!header_is_valid(region_desc, current_header)) {
+        return -1;
+    }
+
+    if (structure_base != NULL) {
+        *structure_base = ((uint8_t *)current_header
+                             + sizeof(struct structure_header));
+    }
+
+    *header = *current_header;
+    return 0;
+}
+
 /*
  * Search the SDS Memory Region to determine if a structure with the given ID
  * is present.
@@ -293,6 +387,11 @@ sds_struct_add_internal(const struct sds_structure_desc *struct_desc)
     header->size = padded_size;
     header->valid = true; /* Set to always true */
 
+    /* The index holds the first structures of the region, in order */
+    if (sds_index_count == region_desc->structure_count) {
+        sds_index_add(struct_desc->id, region_config.free_mem_offset);
+    }
+
     /* Adjust free memory data with the size of structure_header */
     region_config.free_mem_offset += sizeof(*header);
     region_config.free_mem_size   -= sizeof(*header);
@@ -17,6 +17,7 @@
 #ifndef __MHU_H__
 #define __MHU_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -90,6 +91,16 @@ enum mhu_error_t mhu_send_data(void *mhu_sender_dev,
  */
 enum mhu_error_t mhu_wait_data(void *mhu_receiver_dev);
 
+/**
+ * \brief Checks whether a message is waiting in the MHU, without waiting.
+ *
+ * \param[in]  mhu_receiver_dev  Pointer to the receiver MHU.
+ * \param[out] pending           true if mhu_receive_data() can be called.
+ *
+ * \return Returns mhu_error_t error code.
+ */
+enum mhu_error_t mhu_is_data_pending(void *mhu_receiver_dev, bool *pending);
+
 /**
  * \brief Receives data from MHU.
  *
@@ -284,6 +284,26 @@ enum mhu_error_t mhu_wait_data(void *mhu_receiver_dev)
     return error_mapping_to_mhu_error_t(err);
 }
 
+enum mhu_error_t mhu_is_data_pending(void *mhu_receiver_dev, bool *pending)
+{
+    enum mhu_v2_x_error_t err;
+    struct mhu_v2_x_dev_t *dev = mhu_receiver_dev;
+    uint32_t val;
+
+    if (dev == NULL || pending == NULL) {
+        return MHU_ERR_INVALID_ARG;
+    }
+
+    /* Using the last channel for notifications */
+    err = mhu_v2_x_channel_receive(dev,
+                                   mhu_v2_x_get_num_channel_implemented(dev) - 1,
+                                   &val);
+
+    *pending = (err == MHU_V_2_X_ERR_NONE) && (val == MHU_NOTIFY_VALUE);
+
+    return error_mapping_to_mhu_error_t(err);
+}
+
 enum mhu_error_t mhu_receive_data(void *mhu_receiver_dev,
                                   uint8_t *receive_buffer,
                                   size_t *size)
@@ -381,6 +381,34 @@ enum mhu_error_t mhu_wait_data(void *mhu_receiver_dev)
     return error_mapping_to_mhu_error_t(mhu_v3_err);
 }
 
+enum mhu_error_t mhu_is_data_pending(void *mhu_receiver_dev, bool *pending)
+{
+    struct mhu_v3_x_dev_t *dev = mhu_receiver_dev;
+    enum mhu_v3_x_error_t mhu_v3_err;
+    uint8_t num_channels;
+    uint32_t read_val;
+
+    if (dev == NULL || pending == NULL) {
+        return MHU_ERR_INVALID_ARG;
+    }
+
+    *pending = false;
+
+    mhu_v3_err = mhu_v3_x_get_num_channel_implemented(dev, MHU_V3_X_CHANNEL_TYPE_DBCH,
+                                               &num_channels);
+    if (mhu_v3_err != MHU_V_3_X_ERR_NONE) {
+        return error_mapping_to_mhu_error_t(mhu_v3_err);
+    }
+
+    mhu_v3_err = mhu_v3_x_doorbell_read(dev, num_channels - 1, &read_val);
+    if (mhu_v3_err != MHU_V_3_X_ERR_NONE) {
+        return error_mapping_to_mhu_error_t(mhu_v3_err);
+    }
+
+    *pending = (read_val == MHU_NOTIFY_VALUE);
+
+    return MHU_ERR_NONE;
+}
 
 enum mhu_error_t mhu_receive_data(void *mhu_receiver_dev,
                                   uint8_t *receive_buffer, size_t *size)
@@ -616,7 +616,7 @@ enum sic_error_t sic_pmon_enable(struct sic_dev_t *dev,
     /* Set the PMON_TIMER field */
     p_sic->pmcr &= ~(0xFFFFFFu << 8);
     if (timer_enable) {
-        p_sic->pmcr |= (counting_mode & 0xFFFFFFu) << 8;
+        p_sic->pmcr |= (timer_val & 0xFFFFFFu) << 8;
     }
 
     /* Set the PMON_ENABLE field */
@@ -752,6 +752,36 @@ enum tfm_plat_err_t tfm_plat_otp_init(void)
     return check_keys_for_tampering(lcs);
 }
 
+static enum tfm_plat_err_t get_bl1_2_image_region(uint32_t *bl1_2_offset,
+                                                  size_t *bl1_2_size)
+{
+    enum tfm_plat_err_t err;
+#ifdef RSE_HAS_MANUFACTURING_DATA
+    uint32_t manufacturing_data_size;
+#endif /* RSE_HAS_MANUFACTURING_DATA */
+
+    err = otp_read(USER_AREA_OFFSET(cm_locked.bl1_2_image_len),
+                   USER_AREA_SIZE(cm_locked.bl1_2_image_len),
+                   sizeof(*bl1_2_size), (uint8_t *)bl1_2_size);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+
+#ifdef RSE_HAS_MANUFACTURING_DATA
+    err = otp_read(USER_AREA_OFFSET(manufacturing_data.header.size),
+                   USER_AREA_SIZE(manufacturing_data.header.size),
+                   sizeof(manufacturing_data_size), (uint8_t *)&manufacturing_data_size);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+    *bl1_2_offset = USER_AREA_OFFSET(manufacturing_data.header) - manufacturing_data_size - *bl1_2_size;
+#else
+    *bl1_2_offset = USER_AREA_OFFSET(dma_initial_command_sequence) - *bl1_2_size;
+#endif
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
 #define PLAT_OTP_ID_BL2_ROTPK_MAX PLAT_OTP_ID_BL2_ROTPK_0 + MCUBOOT_IMAGE_NUMBER
 #define PLAT_OTP_ID_NV_COUNTER_BL2_MAX \
     PLAT_OTP_ID_NV_COUNTER_BL2_0 + MCUBOOT_IMAGE_NUMBER
@@ -786,24 +816,10 @@ enum tfm_plat_err_t tfm_plat_otp_read(enum tfm_otp_element_id_t id,
         return otp_read_encrypted(otp_offsets[id], otp_sizes[id], out_len, out,
                                   OTP_ROM_ENCRYPTION_KEY);
     case PLAT_OTP_ID_BL1_2_IMAGE:
-        err = otp_read(USER_AREA_OFFSET(cm_locked.bl1_2_image_len),
-                       USER_AREA_SIZE(cm_locked.bl1_2_image_len),
-                       sizeof(bl1_2_size), (uint8_t *)&bl1_2_size);
-        if (err != TFM_PLAT_ERR_SUCCESS) {
-            return err;
-        }
-
-#ifdef RSE_HAS_MANUFACTURING_DATA
-        err = otp_read(USER_AREA_OFFSET(manufacturing_data.header.size),
-                       USER_AREA_SIZE(manufacturing_data.header.size),
-                       sizeof(manufacturing_data_size), (uint8_t *)&manufacturing_data_size);
+        err = get_bl1_2_image_region(&bl1_2_offset, &bl1_2_size);
         if (err != TFM_PLAT_ERR_SUCCESS) {
             return err;
         }
-        bl1_2_offset = USER_AREA_OFFSET(manufacturing_data.header) - manufacturing_data_size - bl1_2_size;
-#else
-        bl1_2_offset = USER_AREA_OFFSET(dma_initial_command_sequence) - bl1_2_size;
-#endif
 
         return otp_read(bl1_2_offset,
                         bl1_2_size,
@@ -829,6 +845,47 @@ enum tfm_plat_err_t tfm_plat_otp_read(enum tfm_otp_element_id_t id,
     }
 }
 
+enum tfm_plat_err_t tfm_plat_otp_read_burst(enum tfm_otp_element_id_t id,
+                                            size_t offset, size_t out_len,
+                                            uint8_t *out)
+{
+    enum tfm_plat_err_t err;
+    size_t bl1_2_size;
+    uint32_t bl1_2_offset;
+
+    /* Only the BL1_2 image is large enough to benefit from bursts */
+    if (id != PLAT_OTP_ID_BL1_2_IMAGE) {
+        return TFM_PLAT_ERR_UNSUPPORTED;
+    }
+
+    err = get_bl1_2_image_region(&bl1_2_offset, &bl1_2_size);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+
+    if (offset > bl1_2_size || out_len > bl1_2_size - offset) {
+        return TFM_PLAT_ERR_INVALID_INPUT;
+    }
+
+    if (out_len == 0) {
+        return TFM_PLAT_ERR_SUCCESS;
+    }
+
+#ifdef RSE_BRINGUP_OTP_EMULATION
+    err = check_if_otp_is_emulated(bl1_2_offset + offset, out_len);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+#endif /* RSE_BRINGUP_OTP_EMULATION */
+
+    if (lcm_otp_read_burst(&LCM_DEV_S, bl1_2_offset + offset, out_len,
+                           out) != LCM_ERROR_NONE) {
+        return TFM_PLAT_ERR_SYSTEM_ERR;
+    }
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
 static enum tfm_plat_err_t otp_write_lcs(size_t in_len, const uint8_t *in)
 {
     enum tfm_plat_err_t err;
@@ -211,15 +211,26 @@
 #error FLASH_BL2_PARTITION_SIZE + BL2_DATA_SIZE + 2 * FLASH_SIC_TABLE_SIZE is too large to fit in RSE SRAM
 #endif
 
+/* The boot timeline is kept at the end of the DTCM, after the BL1 data */
+#ifdef TFM_BOOT_TIMELINE
+#define BOOT_TIMELINE_SIZE (0x400)
+#else
+#define BOOT_TIMELINE_SIZE (0x0)
+#endif /* TFM_BOOT_TIMELINE */
+
 /* BL1 data is in DTCM */
 #define BL1_1_DATA_START  (BOOT_TFM_SHARED_DATA_BASE + BOOT_TFM_SHARED_DATA_SIZE)
-#define BL1_1_DATA_SIZE   ((DTCM_SIZE - BOOT_TFM_SHARED_DATA_SIZE) / 2)
+#define BL1_1_DATA_SIZE   ((DTCM_SIZE - BOOT_TFM_SHARED_DATA_SIZE - \
+                            BOOT_TIMELINE_SIZE) / 2)
 #define BL1_1_DATA_LIMIT  (BL1_1_DATA_START + BL1_1_DATA_SIZE - 1)
 
 #define BL1_2_DATA_START  (BL1_1_DATA_START + BL1_1_DATA_SIZE)
-#define BL1_2_DATA_SIZE   ((DTCM_SIZE - BOOT_TFM_SHARED_DATA_SIZE) / 2)
+#define BL1_2_DATA_SIZE   ((DTCM_SIZE - BOOT_TFM_SHARED_DATA_SIZE - \
+                            BOOT_TIMELINE_SIZE) / 2)
 #define BL1_2_DATA_LIMIT  (BL1_2_DATA_START + BL1_2_DATA_SIZE - 1)
 
+#define BOOT_TIMELINE_BASE (BL1_2_DATA_START + BL1_2_DATA_SIZE)
+
 /* XIP data goes after the BL2 image */
 #define BL2_XIP_TABLES_START (BL2_IMAGE_START + FLASH_BL2_PARTITION_SIZE)
 #define BL2_XIP_TABLES_SIZE  (FLASH_SIC_TABLE_SIZE * 2)
@@ -6,6 +6,9 @@
  */
 
 #include "rse_comms_atu.h"
+
+#include <stdbool.h>
+
 #include "atu_rse_drv.h"
 #include "tfm_spm_log.h"
 #include "device_definition.h"
@@ -17,10 +20,16 @@ struct comms_atu_region_params_t {
     uint32_t size;
     uint8_t region;
     uint32_t ref_count;
+    bool mapped;
+    uint32_t last_use;
 };
 
-/* ATU config */
+/* ATU config. A region stays mapped once it has no reference, so that the next
+ * requests for the same host buffers reuse it. It is only remapped when a free
+ * region is needed for another host buffer.
+ */
 static struct comms_atu_region_params_t atu_regions[RSE_COMMS_ATU_REGION_AM] = {0};
+static uint32_t atu_use_count;
 
 static inline uint64_t round_down(uint64_t num, uint64_t boundary)
 {
@@ -49,7 +58,7 @@ static enum tfm_plat_err_t get_region_idx_from_host_buf(uint64_t host_addr,
     for (idx = 0; idx < RSE_COMMS_ATU_REGION_AM; idx++) {
         region = &atu_regions[idx];
 
-        if (atu_regions[idx].ref_count > 0 &&
+        if (region->mapped &&
             host_addr >= region->phys_addr &&
             host_addr + size <= region->phys_addr + region->size) {
             *region_idx = idx;
@@ -78,17 +87,52 @@ enum tfm_plat_err_t comms_atu_get_rse_ptr_from_host_addr(uint8_t region,
     return TFM_PLAT_ERR_SUCCESS;
 }
 
-static int get_free_region_idx(uint32_t *region_idx) {
+static enum tfm_plat_err_t unmap_region(uint32_t region_idx)
+{
+    int32_t atu_err;
+
+    atu_regions[region_idx].mapped = false;
+
+    atu_err = atu_uninitialize_region(&ATU_DEV_S,
+                                      atu_regions[region_idx].region);
+    if (atu_err) {
+        return TFM_PLAT_ERR_SYSTEM_ERR;
+    }
+    SPMLOG_DBGMSGVAL("[COMMS ATU] Deallocating region: ", region_idx);
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+/* Prefer an unmapped region, otherwise the least recently used mapped region
+ * without references, which is unmapped.
+ */
+static enum tfm_plat_err_t get_free_region_idx(uint32_t *region_idx)
+{
     uint32_t idx;
+    uint32_t lru_idx = RSE_COMMS_ATU_REGION_AM;
 
-    for (idx = 0; idx <= RSE_COMMS_ATU_REGION_AM; idx++) {
-        if (atu_regions[idx].ref_count == 0) {
+    for (idx = 0; idx < RSE_COMMS_ATU_REGION_AM; idx++) {
+        if (atu_regions[idx].ref_count != 0) {
+            continue;
+        }
+        if (!atu_regions[idx].mapped) {
             *region_idx = idx;
             return TFM_PLAT_ERR_SUCCESS;
         }
+        if ((lru_idx == RSE_COMMS_ATU_REGION_AM) ||
+            (atu_use_count - atu_regions[idx].last_use >
+             atu_use_count - atu_regions[lru_idx].last_use)) {
+            lru_idx = idx;
+        }
+    }
+
+    if (lru_idx == RSE_COMMS_ATU_REGION_AM) {
+        return TFM_PLAT_ERR_MAX_VALUE;
     }
 
-    return TFM_PLAT_ERR_MAX_VALUE;
+    *region_idx = lru_idx;
+
+    return unmap_region(lru_idx);
 }
 
 static enum tfm_plat_err_t setup_region_for_host_buf(uint64_t host_addr,
@@ -123,6 +167,7 @@ static enum tfm_plat_err_t setup_region_for_host_buf(uint64_t host_addr,
     if (atu_err) {
         return TFM_PLAT_ERR_SYSTEM_ERR;
     }
+    region_params->mapped = true;
 
     SPMLOG_DBGMSGVAL("[COMMS ATU] Mapping new region: ", region_idx);
     SPMLOG_DBGMSGVAL("[COMMS ATU] Region start: ", region_params->phys_addr);
@@ -151,6 +196,7 @@ enum tfm_plat_err_t comms_atu_alloc_region(uint64_t host_addr, uint32_t size,
     }
 
     atu_regions[region_idx].ref_count++;
+    atu_regions[region_idx].last_use = ++atu_use_count;
 
     *region = region_idx;
 
@@ -159,23 +205,13 @@ enum tfm_plat_err_t comms_atu_alloc_region(uint64_t host_addr, uint32_t size,
 
 enum tfm_plat_err_t comms_atu_free_region(uint8_t region)
 {
-    int32_t atu_err;
-    struct comms_atu_region_params_t *region_params;
-
-    if (region >= RSE_COMMS_ATU_REGION_AM) {
+    if ((region >= RSE_COMMS_ATU_REGION_AM) ||
+        (atu_regions[region].ref_count == 0)) {
         return TFM_PLAT_ERR_INVALID_INPUT;
     }
 
+    /* The region stays mapped for the next requests, see get_free_region_idx */
     atu_regions[region].ref_count--;
-    region_params = &atu_regions[region];
-
-    if (atu_regions[region].ref_count == 0) {
-        atu_err = atu_uninitialize_region(&ATU_DEV_S, region_params->region);
-        if (atu_err) {
-            return TFM_PLAT_ERR_SYSTEM_ERR;
-        }
-        SPMLOG_DBGMSGVAL("[COMMS ATU] Deallocating region: ", region);
-    }
 
     return TFM_PLAT_ERR_SUCCESS;
 }
@@ -183,23 +219,12 @@ enum tfm_plat_err_t comms_atu_free_region(uint8_t region)
 enum tfm_plat_err_t comms_atu_free_regions(comms_atu_region_set_t regions)
 {
     uint32_t region_idx;
-    int32_t atu_err;
-    struct comms_atu_region_params_t *region_params;
 
     for (region_idx = 0; region_idx < RSE_COMMS_ATU_REGION_AM; region_idx++) {
-        if ((regions.ref_counts[region_idx]) > 0) {
-            atu_regions[region_idx].ref_count -= regions.ref_counts[region_idx];
-            region_params = &atu_regions[region_idx];
-
-            if (atu_regions[region_idx].ref_count == 0) {
-                atu_err = atu_uninitialize_region(&ATU_DEV_S,
-                                                  region_params->region);
-                if (atu_err) {
-                    return TFM_PLAT_ERR_SYSTEM_ERR;
-                }
-                SPMLOG_DBGMSGVAL("[COMMS ATU] Deallocating region: ", region_idx);
-            }
+        if (regions.ref_counts[region_idx] > atu_regions[region_idx].ref_count) {
+            return TFM_PLAT_ERR_INVALID_INPUT;
         }
+        atu_regions[region_idx].ref_count -= regions.ref_counts[region_idx];
     }
 
     return TFM_PLAT_ERR_SUCCESS;
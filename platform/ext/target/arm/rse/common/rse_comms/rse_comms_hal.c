@@ -16,8 +16,19 @@
 #include "tfm_spm_log.h"
 #include "tfm_pools.h"
 #include "rse_comms_protocol.h"
+#include <stdbool.h>
 #include <string.h>
 
+/* Requests in flight from one MHU sender, 0 for no limit other than the pool */
+#ifndef RSE_COMMS_MAX_CONCURRENT_REQ_PER_SENDER
+#define RSE_COMMS_MAX_CONCURRENT_REQ_PER_SENDER 0
+#endif
+
+/* Messages received per MHU interrupt, if the sender has sent the next ones */
+#ifndef RSE_COMMS_RX_BATCH
+#define RSE_COMMS_RX_BATCH 1
+#endif
+
 /* Declared statically to avoid using huge amounts of stack space. Maybe revisit
  * if functions not being reentrant becomes a problem.
  */
@@ -27,6 +38,57 @@ static __ALIGNED(4) struct serialized_psa_reply_t reply;
 TFM_POOL_DECLARE(req_pool, sizeof(struct client_request_t),
                  RSE_COMMS_MAX_CONCURRENT_REQ);
 
+/* Requests received and not replied to yet. The services reply in any order,
+ * so a reply is matched with its request by the sender and the sequence
+ * number only.
+ */
+static struct client_request_t *in_flight[RSE_COMMS_MAX_CONCURRENT_REQ];
+
+/* Returns false if the sequence number is already in flight for the sender. */
+static bool in_flight_add(struct client_request_t *req, bool *busy)
+{
+    struct client_request_t **free_slot = NULL;
+    uint32_t sender_reqs = 0;
+    uint32_t i;
+
+    *busy = false;
+
+    for (i = 0; i < RSE_COMMS_MAX_CONCURRENT_REQ; i++) {
+        if (in_flight[i] == NULL) {
+            if (free_slot == NULL) {
+                free_slot = &in_flight[i];
+            }
+        } else if (in_flight[i]->mhu_sender_dev == req->mhu_sender_dev) {
+            if (in_flight[i]->seq_num == req->seq_num) {
+                return false;
+            }
+            sender_reqs++;
+        }
+    }
+
+    if ((free_slot == NULL) ||
+        ((RSE_COMMS_MAX_CONCURRENT_REQ_PER_SENDER > 0) &&
+         (sender_reqs >= RSE_COMMS_MAX_CONCURRENT_REQ_PER_SENDER))) {
+        *busy = true;
+        return true;
+    }
+
+    *free_slot = req;
+
+    return true;
+}
+
+static void in_flight_remove(const struct client_request_t *req)
+{
+    uint32_t i;
+
+    for (i = 0; i < RSE_COMMS_MAX_CONCURRENT_REQ; i++) {
+        if (in_flight[i] == req) {
+            in_flight[i] = NULL;
+        }
+    }
+}
+
 static enum tfm_plat_err_t initialize_mhu(void)
 {
     enum mhu_error_t err;
@@ -63,14 +125,15 @@ static enum tfm_plat_err_t initialize_mhu(void)
     return TFM_PLAT_ERR_SUCCESS;
 }
 
-enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
-                                               void *mhu_sender_dev,
-                                               uint32_t source)
+static enum tfm_plat_err_t receive_msg(void *mhu_receiver_dev,
+                                       void *mhu_sender_dev,
+                                       uint32_t source)
 {
     enum mhu_error_t mhu_err;
     enum tfm_plat_err_t err;
     size_t msg_len = sizeof(msg);
     size_t reply_size;
+    bool busy;
 
     memset(&msg, 0, sizeof(msg));
     memset(&reply, 0, sizeof(reply));
@@ -112,8 +175,23 @@ enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
         goto out_return_err;
     }
 
+    if (!in_flight_add(req, &busy)) {
+        /* The sender reused a sequence number in flight. An error reply would
+         * be taken for the reply of the first request, drop the message.
+         */
+        SPMLOG_DBGMSGVAL("[COMMS] Sequence number in flight: ", req->seq_num);
+        tfm_pool_free(req_pool, req);
+        return TFM_PLAT_ERR_SYSTEM_ERR;
+    }
+    if (busy) {
+        /* The sender has too many requests in flight */
+        err = TFM_PLAT_ERR_SYSTEM_ERR;
+        goto out_return_err;
+    }
+
     if (queue_enqueue(req) != 0) {
         /* No queue capacity, drop message */
+        in_flight_remove(req);
         err = TFM_PLAT_ERR_SYSTEM_ERR;
         goto out_return_err;
     }
@@ -137,6 +215,31 @@ out_return_err:
     return err;
 }
 
+enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
+                                               void *mhu_sender_dev,
+                                               uint32_t source)
+{
+    enum tfm_plat_err_t err;
+    bool pending;
+    uint32_t i;
+
+    err = receive_msg(mhu_receiver_dev, mhu_sender_dev, source);
+
+    /* Take the messages which the sender has already sent in the same
+     * interrupt, so the mailbox partition is signalled once for all of them.
+     */
+    for (i = 1; (i < RSE_COMMS_RX_BATCH) && (err == TFM_PLAT_ERR_SUCCESS); i++) {
+        if ((mhu_is_data_pending(mhu_receiver_dev, &pending) != MHU_ERR_NONE) ||
+            !pending) {
+            break;
+        }
+
+        err = receive_msg(mhu_receiver_dev, mhu_sender_dev, source);
+    }
+
+    return err;
+}
+
 enum tfm_plat_err_t tfm_multi_core_hal_reply(struct client_request_t *req)
 {
     enum tfm_plat_err_t err;
@@ -170,6 +273,7 @@ enum tfm_plat_err_t tfm_multi_core_hal_reply(struct client_request_t *req)
     SPMLOG_DBGMSG("[COMMS] Sent reply\r\n");
 
 out_free_req:
+    in_flight_remove(req);
     tfm_pool_free(req_pool, req);
 out:
     NVIC_EnableIRQ(MAILBOX_IRQ);
@@ -26,6 +26,8 @@ enum tfm_plat_err_t tfm_multi_core_hal_init(void);
 /**
  * \brief Receive PSA client call request from NSPE.
  *        Implemented by platform specific inter-processor communication driver.
+ *        Up to RSE_COMMS_RX_BATCH requests already waiting in the MHU are
+ *        received in one call.
  *
  * \param[in] mhu_receiver_dev  Pointer to MHU receiver device on which to read
  *                              the message.
@@ -25,6 +25,15 @@
 extern "C" {
 #endif
 
+/* Largest invec or outvec total which is sent with the embed protocol when
+ * both protocols are available. Above it, copying the payload through the MHU
+ * costs more than mapping the host buffers with the ATU, so the pointer access
+ * protocol is used. The crossover depends on the MHU and ATU of the platform.
+ */
+#ifndef RSE_COMMS_EMBED_THRESHOLD
+#define RSE_COMMS_EMBED_THRESHOLD RSE_COMMS_PAYLOAD_MAX_SIZE
+#endif
+
 enum rse_comms_protocol_version_t {
 #ifdef RSE_COMMS_PROTOCOL_EMBED_ENABLED
     RSE_COMMS_PROTOCOL_EMBED = 0,
@@ -121,6 +130,34 @@ enum tfm_plat_err_t rse_protocol_serialize_error(
         struct serialized_rse_comms_header_t *header, psa_status_t error,
         struct serialized_psa_reply_t *reply, size_t *reply_size);
 
+#if defined(RSE_COMMS_PROTOCOL_EMBED_ENABLED) && \
+    defined(RSE_COMMS_PROTOCOL_POINTER_ACCESS_ENABLED)
+/**
+ * \brief Select the protocol of a message from the size of its payload.
+ *
+ * \param[in]  in_size           The total size of the invecs.
+ * \param[in]  out_size          The total size of the outvecs.
+ *
+ * \note   The embed protocol carries the outvecs in the reply, so both sizes
+ *         are compared with the threshold.
+ *
+ * \return The embed protocol if both sizes are no larger than
+ *         RSE_COMMS_EMBED_THRESHOLD and fit in the embed payload, the pointer
+ *         access protocol otherwise.
+ */
+static inline enum rse_comms_protocol_version_t rse_protocol_select_version(
+        size_t in_size, size_t out_size)
+{
+    if ((in_size <= RSE_COMMS_EMBED_THRESHOLD) &&
+        (out_size <= RSE_COMMS_EMBED_THRESHOLD) &&
+        (in_size <= RSE_COMMS_PAYLOAD_MAX_SIZE) &&
+        (out_size <= RSE_COMMS_PAYLOAD_MAX_SIZE)) {
+        return RSE_COMMS_PROTOCOL_EMBED;
+    }
+
+    return RSE_COMMS_PROTOCOL_POINTER_ACCESS;
+}
+#endif
 
 #ifdef __cplusplus
 }
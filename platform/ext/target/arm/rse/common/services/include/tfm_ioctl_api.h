@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_IOCTL_API__
+#define __TFM_IOCTL_API__
+
+#include <stdint.h>
+#include "tfm_platform_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum tfm_platform_ioctl_reqest_types_t {
+    TFM_PLATFORM_IOCTL_SIC_PMON_GET_STATS,
+};
+
+/*!
+ * \struct tfm_sic_pmon_stats_t
+ *
+ * \brief Output of TFM_PLATFORM_IOCTL_SIC_PMON_GET_STATS, the SIC PMON
+ *        counters since boot
+ */
+struct tfm_sic_pmon_stats_t {
+    uint32_t page_hit_counter;   /*!< Accesses to authenticated pages */
+    uint32_t page_miss_counter;  /*!< Accesses which authenticated a page */
+    uint32_t bypass_counter;     /*!< Accesses outside of the SIC region */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_IOCTL_API__ */
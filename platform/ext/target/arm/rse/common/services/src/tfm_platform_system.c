@@ -7,6 +7,11 @@
 
 #include "tfm_platform_system.h"
 #include "tfm_hal_device_header.h"
+#ifdef RSE_SIC_PMON
+#include "tfm_ioctl_api.h"
+#include "device_definition.h"
+#include "sic_drv.h"
+#endif /* RSE_SIC_PMON */
 
 void tfm_platform_hal_system_reset(void)
 {
@@ -14,14 +19,43 @@ void tfm_platform_hal_system_reset(void)
     NVIC_SystemReset();
 }
 
+#ifdef RSE_SIC_PMON
+static enum tfm_platform_err_t sic_pmon_get_stats_ioctl(psa_outvec *out_vec)
+{
+    struct sic_pmon_counters_t counters;
+    struct tfm_sic_pmon_stats_t *stats;
+
+    if ((out_vec == NULL) ||
+        (out_vec->len != sizeof(struct tfm_sic_pmon_stats_t))) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    if (sic_pmon_get_stats(&SIC_DEV_S, &counters) != SIC_ERROR_NONE) {
+        return TFM_PLATFORM_ERR_NOT_SUPPORTED;
+    }
+
+    stats = (struct tfm_sic_pmon_stats_t *)out_vec->base;
+    stats->page_hit_counter = counters.page_hit_counter;
+    stats->page_miss_counter = counters.page_miss_counter;
+    stats->bypass_counter = counters.bypass_counter;
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+#endif /* RSE_SIC_PMON */
+
 enum tfm_platform_err_t tfm_platform_hal_ioctl(tfm_platform_ioctl_req_t request,
                                                psa_invec  *in_vec,
                                                psa_outvec *out_vec)
 {
-    (void)request;
     (void)in_vec;
-    (void)out_vec;
 
-    /* Not needed for this platform */
-    return TFM_PLATFORM_ERR_NOT_SUPPORTED;
+    switch (request) {
+#ifdef RSE_SIC_PMON
+    case TFM_PLATFORM_IOCTL_SIC_PMON_GET_STATS:
+        return sic_pmon_get_stats_ioctl(out_vec);
+#endif /* RSE_SIC_PMON */
+    default:
+        (void)out_vec;
+        return TFM_PLATFORM_ERR_NOT_SUPPORTED;
+    }
 }
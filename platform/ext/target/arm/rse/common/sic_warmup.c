@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "sic_warmup.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include "device_definition.h"
+#include "sic_drv.h"
+
+/* SIC pages authenticated from the start of each hot symbol */
+#ifndef RSE_SIC_WARMUP_PAGES
+#define RSE_SIC_WARMUP_PAGES 2
+#endif
+
+/*
+ * The hot symbols. They are weak references, so the symbols of the components
+ * which are not in the build are NULL and skipped. A platform can replace the
+ * list by defining RSE_SIC_WARMUP_SYMBOLS.
+ */
+#ifndef RSE_SIC_WARMUP_SYMBOLS
+#define RSE_SIC_WARMUP_SYMBOLS(X)               \
+    /* Exception entry and scheduling */        \
+    X(SVC_Handler)                              \
+    X(PendSV_Handler)                           \
+    X(ipc_schedule)                             \
+    /* IPC path of a psa_call() */              \
+    X(tfm_spm_client_psa_call)                  \
+    X(backend_messaging)                        \
+    /* MHU interrupt and FLIH handling */       \
+    X(tfm_multi_core_hal_receive)               \
+    X(spm_handle_interrupt)                     \
+    /* Crypto kernels */                        \
+    X(tfm_crypto_api_dispatcher)                \
+    X(cc3xx_lowlevel_aes_update)                \
+    X(cc3xx_lowlevel_hash_update)               \
+    X(cc3xx_lowlevel_ecdsa_verify)
+#endif
+
+#define SIC_WARMUP_DECLARE(sym) extern void sym(void) __attribute__((weak));
+#define SIC_WARMUP_ENTRY(sym)   sym,
+
+RSE_SIC_WARMUP_SYMBOLS(SIC_WARMUP_DECLARE)
+
+static void (*const hot_symbols[])(void) = {
+    RSE_SIC_WARMUP_SYMBOLS(SIC_WARMUP_ENTRY)
+};
+
+enum tfm_plat_err_t sic_warmup(void)
+{
+    size_t page_size = sic_page_size_get(&SIC_DEV_S);
+    uintptr_t page;
+    uint32_t i, j;
+
+#ifdef RSE_SIC_PMON
+    if (sic_pmon_enable(&SIC_DEV_S, SIC_PMON_COUNT_EVENTS, false, 0) !=
+        SIC_ERROR_NONE) {
+        return TFM_PLAT_ERR_SYSTEM_ERR;
+    }
+#endif /* RSE_SIC_PMON */
+
+    for (i = 0; i < sizeof(hot_symbols) / sizeof(hot_symbols[0]); i++) {
+        if (hot_symbols[i] == NULL) {
+            continue;
+        }
+
+        /* A read of each page makes the SIC fetch and authenticate it */
+        page = (uintptr_t)hot_symbols[i] & ~(page_size - 1);
+        for (j = 0; j < RSE_SIC_WARMUP_PAGES; j++) {
+            (void)*(volatile const uint32_t *)(page + j * page_size);
+        }
+    }
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
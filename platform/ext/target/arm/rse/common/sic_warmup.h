@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SIC_WARMUP_H__
+#define __SIC_WARMUP_H__
+
+#include "tfm_plat_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Authenticates the SIC pages which hold the hot runtime code, so that
+ *        the first calls into it after boot do not miss in the SIC. Also
+ *        starts the SIC PMON counters if RSE_SIC_PMON is defined.
+ *
+ * \retval TFM_PLAT_ERR_SUCCESS  Operation succeeded.
+ * \retval Other return code     Operation failed with an error code.
+ */
+enum tfm_plat_err_t sic_warmup(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIC_WARMUP_H__ */
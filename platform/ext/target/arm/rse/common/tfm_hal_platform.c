@@ -11,6 +11,9 @@
 #include "tfm_peripherals_def.h"
 #include "uart_stdout.h"
 #include "device_definition.h"
+#ifdef RSE_SIC_WARMUP
+#include "sic_warmup.h"
+#endif /* RSE_SIC_WARMUP */
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
 #include "host_base_address.h"
 #endif /* TFM_PARTITION_PROTECTED_STORAGE */
@@ -65,6 +68,13 @@ enum tfm_hal_status_t tfm_hal_platform_init(void)
         return TFM_HAL_ERROR_GENERIC;
     }
 
+#ifdef RSE_SIC_WARMUP
+    plat_err = sic_warmup();
+    if (plat_err != TFM_PLAT_ERR_SUCCESS) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+#endif /* RSE_SIC_WARMUP */
+
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
     /* Initialize PS region */
     err = atu_initialize_region(&ATU_DEV_S,
@@ -165,13 +165,21 @@ int boot_platform_post_load(uint32_t image_id)
 
     if (image_id == RSE_BL2_IMAGE_SCP) {
         memset((void *)HOST_BOOT_IMAGE1_LOAD_BASE_S, 0, HOST_IMAGE_HEADER_SIZE);
-        uint32_t channel_stat = 0;
         struct rse_sysctrl_t *sysctrl =
                                      (struct rse_sysctrl_t *)RSE_SYSCTRL_BASE_S;
 
-        /* Release SCP CPU from wait */
+        /* Release SCP CPU from wait. The SCP BL1 started event is only
+         * collected once the AP image has been loaded, so that the SCP
+         * startup overlaps with the copy, hash and signature verification
+         * of the AP image.
+         */
         sysctrl->gretreg = 0x1;
 
+    } else if (image_id == RSE_BL2_IMAGE_AP) {
+        uint32_t channel_stat = 0;
+
+        memset((void *)HOST_BOOT_IMAGE0_LOAD_BASE_S, 0, HOST_IMAGE_HEADER_SIZE);
+
         /* Wait for SCP to finish its startup */
         BOOT_LOG_INF("Waiting for SCP BL1 started event");
         while (channel_stat == 0) {
@@ -179,8 +187,6 @@ int boot_platform_post_load(uint32_t image_id)
         }
         BOOT_LOG_INF("Got SCP BL1 started event");
 
-    } else if (image_id == RSE_BL2_IMAGE_AP) {
-        memset((void *)HOST_BOOT_IMAGE0_LOAD_BASE_S, 0, HOST_IMAGE_HEADER_SIZE);
         BOOT_LOG_INF("Telling SCP to start AP cores");
         mhu_v2_x_initiate_transfer(&MHU_RSE_TO_SCP_DEV);
         /* Slot 0 is used in the SCP protocol */
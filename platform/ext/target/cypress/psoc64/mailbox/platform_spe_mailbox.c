@@ -62,13 +62,15 @@ int32_t tfm_mailbox_hal_init(struct secure_mailbox_queue_t *s_queue)
      * Necessary sanity check of the address of NPSE mailbox queue should
      * be implemented there.
      */
-    if (ns_init->slot_count > NUM_MAILBOX_QUEUE_SLOT) {
+    if (ns_init->slot_count > MAILBOX_MAX_NS_SLOT_COUNT) {
         return MAILBOX_INIT_ERROR;
     }
 
     s_queue->ns_status = ns_init->status;
     s_queue->ns_slot_count = ns_init->slot_count;
     s_queue->ns_slots = ns_init->slots;
+    s_queue->ns_shm_base = ns_init->shm_base;
+    s_queue->ns_shm_size = ns_init->shm_size;
 
     mailbox_ipc_config();
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2023 Nordic Semiconductor ASA.
+ * Copyright (c) 2023-2024 Nordic Semiconductor ASA.
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -118,38 +119,124 @@ static bool ctx_is_valid(struct tfm_hal_its_auth_crypt_ctx *ctx)
     return !ret;
 }
 
+/* Largest derivation label of the key contexts kept between operations */
+#define KEY_CTX_LABEL_MAX_SIZE 32
+
+/* Number of key contexts kept between operations */
+#ifndef KEY_CTX_NUM
+#define KEY_CTX_NUM 4
+#endif
+
+/* The key contexts of the last derivation labels used. A label stands for a
+ * file, so the key information and the cipher are only set up on the first
+ * access to a file since its context was evicted, the least recently used one
+ * going first. Only the nonce, the additional data and the tag are set for
+ * each operation.
+ */
+struct key_ctx_t {
+    nrf_cc3xx_platform_derived_key_ctx_t ctx;
+    uint8_t label[KEY_CTX_LABEL_MAX_SIZE];
+    size_t label_size;
+    uint32_t last_use;
+    bool valid;
+};
+
+static struct key_ctx_t g_key_ctxs[KEY_CTX_NUM];
+static uint32_t g_key_ctx_use;
+
+static void tfm_hal_its_aead_cleanup(struct key_ctx_t *key_ctx)
+{
+    memset(key_ctx, 0x0, sizeof(*key_ctx));
+}
+
+static bool key_ctx_matches(const struct key_ctx_t *key_ctx,
+                            struct tfm_hal_its_auth_crypt_ctx *ctx)
+{
+    return key_ctx->valid &&
+           ctx->deriv_label_size == key_ctx->label_size &&
+           (ctx->deriv_label_size == 0 ||
+            memcmp(ctx->deriv_label, key_ctx->label,
+                   ctx->deriv_label_size) == 0);
+}
+
+/* Returns the key context of the label, or the one to be set up for it */
+static struct key_ctx_t *key_ctx_lookup(struct tfm_hal_its_auth_crypt_ctx *ctx,
+                                        bool *found)
+{
+    struct key_ctx_t *victim = &g_key_ctxs[0];
+    size_t i;
+
+    for (i = 0; i < KEY_CTX_NUM; i++) {
+        if (key_ctx_matches(&g_key_ctxs[i], ctx)) {
+            *found = true;
+            return &g_key_ctxs[i];
+        }
+
+        if (!g_key_ctxs[i].valid) {
+            victim = &g_key_ctxs[i];
+        } else if (victim->valid &&
+                   (g_key_ctx_use - g_key_ctxs[i].last_use >
+                    g_key_ctx_use - victim->last_use)) {
+            victim = &g_key_ctxs[i];
+        }
+    }
+
+    *found = false;
+    return victim;
+}
+
 static enum tfm_hal_status_t tfm_hal_its_aead_init(
                             struct tfm_hal_its_auth_crypt_ctx *ctx,
-                            nrf_cc3xx_platform_derived_key_ctx_t *platform_ctx,
                             uint8_t *tag,
-                            size_t tag_size)
+                            size_t tag_size,
+                            struct key_ctx_t **key_ctx_out)
 {
 
     int err = NRF_CC3XX_PLATFORM_ERROR_INTERNAL;
+    struct key_ctx_t *key_ctx;
+    bool found;
 
+    key_ctx = key_ctx_lookup(ctx, &found);
+    *key_ctx_out = key_ctx;
 
-    err = nrf_cc3xx_platform_derived_key_init(platform_ctx);
-    if (err != NRF_CC3XX_PLATFORM_SUCCESS) {
-        return TFM_HAL_ERROR_GENERIC;
-    }
+    if (!found) {
+        tfm_hal_its_aead_cleanup(key_ctx);
 
-    err = nrf_cc3xx_platform_derived_key_set_info(platform_ctx,
-                                                  HUK_KMU_SLOT,
-                                                  HUK_KMU_SIZE_BITS,
-                                                  ctx->deriv_label,
-                                                  ctx->deriv_label_size);
-    if (err != NRF_CC3XX_PLATFORM_SUCCESS) {
-        return TFM_HAL_ERROR_INVALID_INPUT;
-    }
+        err = nrf_cc3xx_platform_derived_key_init(&key_ctx->ctx);
+        if (err != NRF_CC3XX_PLATFORM_SUCCESS) {
+            return TFM_HAL_ERROR_GENERIC;
+        }
 
-    err = nrf_cc3xx_platform_derived_key_set_cipher(platform_ctx,
-                                                    ALG_CHACHAPOLY_256_BIT);
+        err = nrf_cc3xx_platform_derived_key_set_info(&key_ctx->ctx,
+                                                      HUK_KMU_SLOT,
+                                                      HUK_KMU_SIZE_BITS,
+                                                      ctx->deriv_label,
+                                                      ctx->deriv_label_size);
+        if (err != NRF_CC3XX_PLATFORM_SUCCESS) {
+            return TFM_HAL_ERROR_INVALID_INPUT;
+        }
 
-    if (err != NRF_CC3XX_PLATFORM_SUCCESS) {
-        return TFM_HAL_ERROR_INVALID_INPUT;
+        err = nrf_cc3xx_platform_derived_key_set_cipher(&key_ctx->ctx,
+                                                        ALG_CHACHAPOLY_256_BIT);
+
+        if (err != NRF_CC3XX_PLATFORM_SUCCESS) {
+            return TFM_HAL_ERROR_INVALID_INPUT;
+        }
+
+        /* Longer labels are not kept, their context is set up every time */
+        if (ctx->deriv_label_size <= sizeof(key_ctx->label)) {
+            if (ctx->deriv_label_size != 0) {
+                memcpy(key_ctx->label, ctx->deriv_label,
+                       ctx->deriv_label_size);
+            }
+            key_ctx->label_size = ctx->deriv_label_size;
+            key_ctx->valid = true;
+        }
     }
 
-    err = nrf_cc3xx_platform_derived_key_set_auth_info(platform_ctx,
+    key_ctx->last_use = ++g_key_ctx_use;
+
+    err = nrf_cc3xx_platform_derived_key_set_auth_info(&key_ctx->ctx,
                                                        ctx->nonce,
                                                        ctx->nonce_size,
                                                        ctx->aad,
@@ -163,16 +250,6 @@ static enum tfm_hal_status_t tfm_hal_its_aead_init(
     return TFM_HAL_SUCCESS;
 }
 
-static void tfm_hal_its_aead_cleanup(
-                            nrf_cc3xx_platform_derived_key_ctx_t *platform_ctx)
-{
-    if(platform_ctx != NULL){
-        memset(platform_ctx,
-                   0x0,
-                   sizeof(nrf_cc3xx_platform_derived_key_ctx_t));
-    }
-}
-
 enum tfm_hal_status_t tfm_hal_its_aead_encrypt(
                                         struct tfm_hal_its_auth_crypt_ctx *ctx,
                                         const uint8_t *plaintext,
@@ -182,9 +259,9 @@ enum tfm_hal_status_t tfm_hal_its_aead_encrypt(
                                         uint8_t *tag,
                                         const size_t tag_size)
 {
-    nrf_cc3xx_platform_derived_key_ctx_t platform_ctx = {0};
     enum tfm_hal_status_t err = TFM_HAL_ERROR_GENERIC;
     int plat_err = NRF_CC3XX_PLATFORM_ERROR_INTERNAL;
+    struct key_ctx_t *key_ctx;
 
     if (!ctx_is_valid(ctx) || tag == NULL) {
         return TFM_HAL_ERROR_INVALID_INPUT;
@@ -195,23 +272,22 @@ enum tfm_hal_status_t tfm_hal_its_aead_encrypt(
     }
 
     err = tfm_hal_its_aead_init(ctx,
-                                &platform_ctx,
                                 tag,
-                                tag_size);
+                                tag_size,
+                                &key_ctx);
     if (err !=  TFM_HAL_SUCCESS) {
-        tfm_hal_its_aead_cleanup(&platform_ctx);
+        tfm_hal_its_aead_cleanup(key_ctx);
         return err;
     }
 
 
-    plat_err = nrf_cc3xx_platform_derived_key_encrypt(&platform_ctx,
+    plat_err = nrf_cc3xx_platform_derived_key_encrypt(&key_ctx->ctx,
                                                       ciphertext,
                                                       plaintext_size,
                                                       plaintext);
 
-    tfm_hal_its_aead_cleanup(&platform_ctx);
-
     if (plat_err != NRF_CC3XX_PLATFORM_SUCCESS) {
+        tfm_hal_its_aead_cleanup(key_ctx);
         return TFM_HAL_ERROR_GENERIC;
     }
 
@@ -227,9 +303,9 @@ enum tfm_hal_status_t tfm_hal_its_aead_decrypt(
                                         uint8_t *plaintext,
                                         const size_t plaintext_size)
 {
-    nrf_cc3xx_platform_derived_key_ctx_t platform_ctx = {0};
     enum tfm_hal_status_t err = TFM_HAL_ERROR_GENERIC;
     int plat_err = NRF_CC3XX_PLATFORM_ERROR_INTERNAL;
+    struct key_ctx_t *key_ctx;
 
     if (!ctx_is_valid(ctx) || tag == NULL) {
         return TFM_HAL_ERROR_INVALID_INPUT;
@@ -240,22 +316,22 @@ enum tfm_hal_status_t tfm_hal_its_aead_decrypt(
     }
 
     err = tfm_hal_its_aead_init(ctx,
-                                &platform_ctx,
                                 tag,
-                                tag_size);
+                                tag_size,
+                                &key_ctx);
     if (err != TFM_HAL_SUCCESS) {
-        tfm_hal_its_aead_cleanup(&platform_ctx);
+        tfm_hal_its_aead_cleanup(key_ctx);
         return err;
     }
 
 
-    plat_err = nrf_cc3xx_platform_derived_key_decrypt(&platform_ctx,
+    plat_err = nrf_cc3xx_platform_derived_key_decrypt(&key_ctx->ctx,
                                                       plaintext,
                                                       ciphertext_size,
                                                       ciphertext);
-    tfm_hal_its_aead_cleanup(&platform_ctx);
 
     if (plat_err != NRF_CC3XX_PLATFORM_SUCCESS) {
+        tfm_hal_its_aead_cleanup(key_ctx);
         return TFM_HAL_ERROR_GENERIC;
     }
 
@@ -32,5 +32,6 @@ set(MCUBOOT_FIH_PROFILE                 LOW         CACHE STRING    "Fault injec
 set(CONFIG_TFM_USE_TRUSTZONE             ON)
 set(TFM_MULTI_CORE_TOPOLOGY              OFF)
 set(PLATFORM_HAS_FIRMWARE_UPDATE_SUPPORT ON)
+set(PLATFORM_HAS_STM_CRYPTO_DMA_SUPPORT  ON)
 set(STSAFEA                             OFF          CACHE BOOL      "Activate ST SAFE SUPPORT")
 set(MCUBOOT_DATA_SHARING                ON)
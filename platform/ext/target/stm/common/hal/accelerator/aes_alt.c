@@ -35,6 +35,9 @@
 #include "mbedtls/platform.h"
 #include "mbedtls/platform_util.h"
 #include "mbedtls/error.h"
+#if defined(STM_CRYPTO_DMA_ENABLED)
+#include "stm_crypto_dma.h"
+#endif
 
 /* Parameter validation macros - mbedtls/platform_util.h has deprecated them */
 #define AES_VALIDATE_RET( cond ) do { } while(0)
@@ -365,6 +368,29 @@ static int st_cbc_restore_context(mbedtls_aes_context *ctx)
     return (0);
 }
 
+/* Large buffers are streamed to the AES instance by the GPDMA, if enabled */
+static HAL_StatusTypeDef st_cbc_crypt(mbedtls_aes_context *ctx,
+                                      int mode,
+                                      size_t length,
+                                      const unsigned char *input,
+                                      unsigned char *output)
+{
+#if defined(STM_CRYPTO_DMA_ENABLED)
+    if ((ctx->hcryp_aes.Instance == AES) &&
+        STM_CRYPTO_DMA_ELIGIBLE(input, length) &&
+        STM_CRYPTO_DMA_ELIGIBLE(output, length)) {
+        return stm_crypto_dma_cryp(&ctx->hcryp_aes, input, length, output,
+                                   mode == MBEDTLS_AES_DECRYPT);
+    }
+#endif
+
+    if (mode == MBEDTLS_AES_DECRYPT) {
+        return HAL_CRYP_Decrypt(&ctx->hcryp_aes, (uint32_t *)input, length, (uint32_t *)output, ST_AES_TIMEOUT);
+    }
+
+    return HAL_CRYP_Encrypt(&ctx->hcryp_aes, (uint32_t *)input, length, (uint32_t *)output, ST_AES_TIMEOUT);
+}
+
 int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
                           int mode,
                           size_t length,
@@ -409,11 +435,11 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
         return (MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED);
     }
 
-    if (mode == MBEDTLS_AES_DECRYPT) {
-        if (HAL_CRYP_Decrypt(&ctx->hcryp_aes, (uint32_t *)input, length, (uint32_t *)output, ST_AES_TIMEOUT) != HAL_OK) {
-            return (MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED);
-        }
+    if (st_cbc_crypt(ctx, mode, length, input, output) != HAL_OK) {
+        return (MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED);
+    }
 
+    if (mode == MBEDTLS_AES_DECRYPT) {
         /* Get IV vector for the next call */
         SWAP_B32_TO_B8(ctx->hcryp_aes.Instance->IVR3,iv,0);
         SWAP_B32_TO_B8(ctx->hcryp_aes.Instance->IVR2,iv,4);
@@ -421,10 +447,6 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
         SWAP_B32_TO_B8(ctx->hcryp_aes.Instance->IVR0,iv,12);
 
     } else {
-        if (HAL_CRYP_Encrypt(&ctx->hcryp_aes, (uint32_t *)input, length, (uint32_t *)output, ST_AES_TIMEOUT) != HAL_OK) {
-            return (MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED);
-        }
-
         /* current output is the IV vector for the next call */
         memcpy(iv, &output[length - 16], 16);
     }
@@ -33,6 +33,9 @@
 #include <string.h>
 #include "mbedtls/platform.h"
 #include "mbedtls/platform_util.h"
+#if defined(STM_CRYPTO_DMA_ENABLED)
+#include "stm_crypto_dma.h"
+#endif
 
 
 /* Private typedef -----------------------------------------------------------*/
@@ -57,6 +60,22 @@ static void mbedtls_zeroize(void *v, size_t n)
     }
 }
 
+/* Large buffers are streamed to the HASH peripheral by the GPDMA, if enabled */
+static HAL_StatusTypeDef st_sha1_accumulate(mbedtls_sha1_context *ctx,
+                                            const unsigned char *input,
+                                            size_t ilen)
+{
+#if defined(STM_CRYPTO_DMA_ENABLED)
+    if (STM_CRYPTO_DMA_ELIGIBLE(input, ilen))
+    {
+        return stm_crypto_dma_hash(&ctx->hhash, input, ilen,
+                                   HASH_ALGOSELECTION_SHA1);
+    }
+#endif
+
+    return HAL_HASH_SHA1_Accmlt(&ctx->hhash, (uint8_t *)input, ilen);
+}
+
 void mbedtls_sha1_init(mbedtls_sha1_context *ctx)
 {
     SHA1_VALIDATE( ctx != NULL );
@@ -161,7 +180,7 @@ int mbedtls_sha1_update_ret(mbedtls_sha1_context *ctx, const unsigned char *inpu
         size_t iter = currentlen / ST_SHA1_BLOCK_SIZE;
         if (iter != 0)
         {
-            if (HAL_HASH_SHA1_Accmlt(&ctx->hhash, (uint8_t *)(input + ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len), (iter * ST_SHA1_BLOCK_SIZE)) != 0)
+            if (st_sha1_accumulate(ctx, input + ST_SHA1_BLOCK_SIZE + ctx->first - ctx->sbuf_len, (iter * ST_SHA1_BLOCK_SIZE)) != 0)
             {
                 return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
             }
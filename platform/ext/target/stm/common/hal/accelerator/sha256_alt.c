@@ -34,6 +34,9 @@
 #include <string.h>
 #include "mbedtls/platform.h"
 #include "mbedtls/platform_util.h"
+#if defined(STM_CRYPTO_DMA_ENABLED)
+#include "stm_crypto_dma.h"
+#endif
 
 
 /* Private typedef -----------------------------------------------------------*/
@@ -58,6 +61,29 @@ static void mbedtls_zeroize(void *v, size_t n)
     }
 }
 
+/* Large buffers are streamed to the HASH peripheral by the GPDMA, if enabled */
+static HAL_StatusTypeDef st_sha256_accumulate(mbedtls_sha256_context *ctx,
+                                              const unsigned char *input,
+                                              size_t ilen)
+{
+#if defined(STM_CRYPTO_DMA_ENABLED)
+    if (STM_CRYPTO_DMA_ELIGIBLE(input, ilen))
+    {
+        return stm_crypto_dma_hash(&ctx->hhash, input, ilen,
+                                   (ctx->MBEDTLS_PRIVATE(is224) == 0) ?
+                                   HASH_ALGOSELECTION_SHA256 :
+                                   HASH_ALGOSELECTION_SHA224);
+    }
+#endif
+
+    if (ctx->MBEDTLS_PRIVATE(is224) == 0)
+    {
+        return HAL_HASHEx_SHA256_Accmlt(&ctx->hhash, (uint8_t *)input, ilen);
+    }
+
+    return HAL_HASHEx_SHA224_Accmlt(&ctx->hhash, (uint8_t *)input, ilen);
+}
+
 void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
 {
     SHA256_VALIDATE( ctx != NULL );
@@ -188,19 +214,9 @@ int mbedtls_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *inpu
         size_t iter = currentlen / ST_SHA256_BLOCK_SIZE;
         if (iter != 0)
         {
-            if (ctx->MBEDTLS_PRIVATE(is224) == 0)
+            if (st_sha256_accumulate(ctx, input + ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len, (iter * ST_SHA256_BLOCK_SIZE)) != 0)
             {
-                if (HAL_HASHEx_SHA256_Accmlt(&ctx->hhash, (uint8_t *)(input + ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len), (iter * ST_SHA256_BLOCK_SIZE)) != 0)
-                {
-                    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-                }
-            }
-            else
-            {
-                if (HAL_HASHEx_SHA224_Accmlt(&ctx->hhash, (uint8_t *)(input + ST_SHA256_BLOCK_SIZE + ctx->first - ctx->sbuf_len), (iter * ST_SHA256_BLOCK_SIZE)) != 0)
-                {
-                    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
-                }
+                return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
             }
         }
 
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * GPDMA streaming of the inputs of the CRYP and HASH peripherals for the crypto
+ * partition. The channels are made secure by the SPM when it initializes their
+ * interrupts, the partition configures them on first use. A single request
+ * is in flight at a time, the partition handles its requests one by one.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "stm_crypto_dma.h"
+#include "tfm_peripherals_def.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_crypto.h"
+
+static DMA_HandleTypeDef hdma_cryp_in;
+static DMA_HandleTypeDef hdma_cryp_out;
+static DMA_HandleTypeDef hdma_hash_in;
+static bool cryp_dma_ready;
+static bool hash_dma_ready;
+
+static HAL_StatusTypeDef dma_channel_init(DMA_HandleTypeDef *hdma,
+                                          DMA_Channel_TypeDef *channel,
+                                          uint32_t request,
+                                          uint32_t direction)
+{
+    bool to_periph = (direction == DMA_MEMORY_TO_PERIPH);
+
+    hdma->Instance = channel;
+    hdma->Init.Request = request;
+    hdma->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    hdma->Init.Direction = direction;
+    hdma->Init.SrcInc = to_periph ? DMA_SINC_INCREMENTED : DMA_SINC_FIXED;
+    hdma->Init.DestInc = to_periph ? DMA_DINC_FIXED : DMA_DINC_INCREMENTED;
+    hdma->Init.SrcDataWidth = DMA_SRC_DATAWIDTH_WORD;
+    hdma->Init.DestDataWidth = DMA_DEST_DATAWIDTH_WORD;
+    hdma->Init.Priority = DMA_HIGH_PRIORITY;
+    hdma->Init.SrcBurstLength = 1;
+    hdma->Init.DestBurstLength = 1;
+    hdma->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 |
+                                       DMA_DEST_ALLOCATED_PORT0;
+    hdma->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+
+    return HAL_DMA_Init(hdma);
+}
+
+/*
+ * Waits for an interrupt of the last channel of a transfer, which is signalled
+ * to the partition, and runs the HAL handlers of the channels. The interrupt
+ * flag of a channel which has no routed interrupt is handled on the way.
+ */
+static void dma_handle_irq(psa_signal_t signal, DMA_HandleTypeDef *first,
+                           DMA_HandleTypeDef *last)
+{
+    (void)psa_wait(signal, PSA_BLOCK);
+
+    if (first != NULL) {
+        HAL_DMA_IRQHandler(first);
+    }
+    HAL_DMA_IRQHandler(last);
+
+    psa_eoi(signal);
+}
+
+HAL_StatusTypeDef stm_crypto_dma_cryp(CRYP_HandleTypeDef *hcryp,
+                                      const uint8_t *input, size_t size,
+                                      uint8_t *output, int decrypt)
+{
+    HAL_StatusTypeDef status;
+
+    if (size > UINT16_MAX) {
+        return HAL_ERROR;
+    }
+
+    if (!cryp_dma_ready) {
+        if ((dma_channel_init(&hdma_cryp_in, STM_CRYP_DMA_IN_CHANNEL,
+                              GPDMA1_REQUEST_AES_IN,
+                              DMA_MEMORY_TO_PERIPH) != HAL_OK) ||
+            (dma_channel_init(&hdma_cryp_out, STM_CRYP_DMA_OUT_CHANNEL,
+                              GPDMA1_REQUEST_AES_OUT,
+                              DMA_PERIPH_TO_MEMORY) != HAL_OK)) {
+            return HAL_ERROR;
+        }
+        cryp_dma_ready = true;
+    }
+
+    /* The channels serve the handle of the current context */
+    __HAL_LINKDMA(hcryp, hdmain, hdma_cryp_in);
+    __HAL_LINKDMA(hcryp, hdmaout, hdma_cryp_out);
+
+    if (decrypt) {
+        status = HAL_CRYP_Decrypt_DMA(hcryp, (uint32_t *)input,
+                                      (uint16_t)size, (uint32_t *)output);
+    } else {
+        status = HAL_CRYP_Encrypt_DMA(hcryp, (uint32_t *)input,
+                                      (uint16_t)size, (uint32_t *)output);
+    }
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    /* The input channel completes before the output one */
+    psa_irq_enable(STM_CRYP_DMA_SIGNAL);
+    while (hcryp->State == HAL_CRYP_STATE_BUSY) {
+        dma_handle_irq(STM_CRYP_DMA_SIGNAL, &hdma_cryp_in, &hdma_cryp_out);
+    }
+    (void)psa_irq_disable(STM_CRYP_DMA_SIGNAL);
+
+    return (hcryp->ErrorCode == HAL_CRYP_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef stm_crypto_dma_hash(HASH_HandleTypeDef *hhash,
+                                      const uint8_t *input, size_t size,
+                                      uint32_t algorithm)
+{
+    HAL_StatusTypeDef status;
+
+    if (!hash_dma_ready) {
+        if (dma_channel_init(&hdma_hash_in, STM_HASH_DMA_CHANNEL,
+                             GPDMA1_REQUEST_HASH_IN,
+                             DMA_MEMORY_TO_PERIPH) != HAL_OK) {
+            return HAL_ERROR;
+        }
+        hash_dma_ready = true;
+    }
+
+    __HAL_LINKDMA(hhash, hdmain, hdma_hash_in);
+
+    /* Multi-buffer mode: the digest is not computed at the end of the DMA */
+    __HAL_HASH_SET_MDMAT();
+
+    status = HASH_Start_DMA(hhash, (uint8_t *)input, size, algorithm);
+    if (status == HAL_OK) {
+        psa_irq_enable(STM_HASH_DMA_SIGNAL);
+        while (hhash->State == HAL_HASH_STATE_BUSY) {
+            dma_handle_irq(STM_HASH_DMA_SIGNAL, NULL, &hdma_hash_in);
+        }
+        (void)psa_irq_disable(STM_HASH_DMA_SIGNAL);
+
+        /* The core processes the last block after the end of the DMA */
+        while (__HAL_HASH_GET_FLAG(HASH_FLAG_BUSY) != RESET) {
+        }
+
+        if (hhash->ErrorCode != HAL_HASH_ERROR_NONE) {
+            status = HAL_ERROR;
+        }
+    }
+
+    __HAL_HASH_RESET_MDMAT();
+
+    return status;
+}
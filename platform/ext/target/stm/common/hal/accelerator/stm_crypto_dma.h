@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef STM_CRYPTO_DMA_H
+#define STM_CRYPTO_DMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stm32hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef STM_CRYPTO_DMA_THRESHOLD
+/* Inputs shorter than this are fed to the peripherals by the CPU */
+#define STM_CRYPTO_DMA_THRESHOLD    256U
+#endif
+
+/* The channels move words, smaller or unaligned buffers are fed by the CPU */
+#define STM_CRYPTO_DMA_ELIGIBLE(addr, size)               \
+    (((size) >= STM_CRYPTO_DMA_THRESHOLD) &&              \
+     (((uintptr_t)(addr) & 0x3U) == 0U))
+
+/**
+ * \brief Encrypts or decrypts \p size bytes with the CRYP peripheral, the
+ *        input and output FIFOs being fed by two GPDMA channels. The crypto
+ *        partition waits for the completion interrupt of the output channel
+ *        with psa_wait().
+ *
+ * \param[in]  hcryp    CRYP handle, configured for the AES instance
+ * \param[in]  input    Input data, word aligned
+ * \param[in]  size     Number of bytes, a multiple of the AES block size
+ * \param[out] output   Output data, word aligned
+ * \param[in]  decrypt  Non-zero to decrypt, zero to encrypt
+ *
+ * \return HAL_OK on success, HAL_ERROR otherwise
+ */
+HAL_StatusTypeDef stm_crypto_dma_cryp(CRYP_HandleTypeDef *hcryp,
+                                      const uint8_t *input, size_t size,
+                                      uint8_t *output, int decrypt);
+
+/**
+ * \brief Accumulates \p size bytes in the HASH peripheral of an on-going
+ *        multi-buffer computation, the input FIFO being fed by a GPDMA
+ *        channel. The digest is not computed, it is read by the
+ *        HAL_HASH*_Accmlt_End() functions. The crypto partition waits for the
+ *        completion interrupt of the channel with psa_wait().
+ *
+ * \param[in] hhash      HASH handle, in the processing phase
+ * \param[in] input      Input data
+ * \param[in] size       Number of bytes, a multiple of the HASH block size
+ * \param[in] algorithm  HASH_ALGOSELECTION_* value of the computation
+ *
+ * \return HAL_OK on success, HAL_ERROR otherwise
+ */
+HAL_StatusTypeDef stm_crypto_dma_hash(HASH_HandleTypeDef *hhash,
+                                      const uint8_t *input, size_t size,
+                                      uint32_t algorithm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM_CRYPTO_DMA_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,10 +10,25 @@
 
 struct platform_data_t;
 
+/*
+ * Quantized default IRQ priority, the value is:
+ * (Number of configurable priority) / 4: (1UL << __NVIC_PRIO_BITS) / 4
+ */
+#define DEFAULT_IRQ_PRIORITY    (1UL << (__NVIC_PRIO_BITS - 2))
+
 
 
 #define TFM_PERIPHERAL_STD_UART     (0)
 #define TFM_PERIPHERAL_TIMER0       (0)
 #define TFM_PERIPHERAL_FPGA_IO      (0)
 
+/* GPDMA channels of the crypto partition, made secure by the SPM */
+#define STM_CRYP_DMA_IN_CHANNEL         GPDMA1_Channel12
+#define STM_CRYP_DMA_OUT_CHANNEL        GPDMA1_Channel13
+#define STM_HASH_DMA_CHANNEL            GPDMA1_Channel14
+#define TFM_STM_CRYP_DMA_IRQ            (GPDMA1_Channel13_IRQn)
+#define TFM_STM_CRYP_DMA_IRQ_Handler    GPDMA1_Channel13_IRQHandler
+#define TFM_STM_HASH_DMA_IRQ            (GPDMA1_Channel14_IRQn)
+#define TFM_STM_HASH_DMA_IRQ_Handler    GPDMA1_Channel14_IRQHandler
+
 #endif /* __TFM_PERIPHERALS_DEF_H__ */
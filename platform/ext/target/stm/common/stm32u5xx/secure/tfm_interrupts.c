@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "tfm_hal_device_header.h"
+#include "stm32u5xx_hal.h"
+#include "spm.h"
+#include "tfm_hal_interrupt.h"
+#include "tfm_peripherals_def.h"
+#include "interrupt.h"
+#include "load/interrupt_defs.h"
+
+#ifdef STM_CRYPTO_DMA_ENABLED
+
+static struct irq_t stm_cryp_dma_irq = {0};
+static struct irq_t stm_hash_dma_irq = {0};
+
+/*
+ * The channels read and write the buffers of the crypto partition, they are
+ * made secure before the partition configures them.
+ */
+static enum tfm_hal_status_t dma_channel_secure(DMA_Channel_TypeDef *channel)
+{
+    DMA_HandleTypeDef hdma = {0};
+
+    __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+    hdma.Instance = channel;
+    if (HAL_DMA_ConfigChannelAttributes(&hdma, DMA_CHANNEL_SEC |
+                                               DMA_CHANNEL_SRC_SEC |
+                                               DMA_CHANNEL_DEST_SEC) != HAL_OK) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    return TFM_HAL_SUCCESS;
+}
+
+void TFM_STM_CRYP_DMA_IRQ_Handler(void)
+{
+    spm_handle_interrupt(stm_cryp_dma_irq.p_pt, stm_cryp_dma_irq.p_ildi);
+}
+
+enum tfm_hal_status_t tfm_stm_cryp_dma_irq_init(void *p_pt,
+                                         const struct irq_load_info_t *p_ildi)
+{
+    stm_cryp_dma_irq.p_ildi = p_ildi;
+    stm_cryp_dma_irq.p_pt = p_pt;
+
+    if ((dma_channel_secure(STM_CRYP_DMA_IN_CHANNEL) != TFM_HAL_SUCCESS) ||
+        (dma_channel_secure(STM_CRYP_DMA_OUT_CHANNEL) != TFM_HAL_SUCCESS)) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    NVIC_SetPriority(TFM_STM_CRYP_DMA_IRQ, DEFAULT_IRQ_PRIORITY);
+    NVIC_ClearTargetState(TFM_STM_CRYP_DMA_IRQ);
+    NVIC_DisableIRQ(TFM_STM_CRYP_DMA_IRQ);
+
+    return TFM_HAL_SUCCESS;
+}
+
+void TFM_STM_HASH_DMA_IRQ_Handler(void)
+{
+    spm_handle_interrupt(stm_hash_dma_irq.p_pt, stm_hash_dma_irq.p_ildi);
+}
+
+enum tfm_hal_status_t tfm_stm_hash_dma_irq_init(void *p_pt,
+                                         const struct irq_load_info_t *p_ildi)
+{
+    stm_hash_dma_irq.p_ildi = p_ildi;
+    stm_hash_dma_irq.p_pt = p_pt;
+
+    if (dma_channel_secure(STM_HASH_DMA_CHANNEL) != TFM_HAL_SUCCESS) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    NVIC_SetPriority(TFM_STM_HASH_DMA_IRQ, DEFAULT_IRQ_PRIORITY);
+    NVIC_ClearTargetState(TFM_STM_HASH_DMA_IRQ);
+    NVIC_DisableIRQ(TFM_STM_HASH_DMA_IRQ);
+
+    return TFM_HAL_SUCCESS;
+}
+
+#endif /* STM_CRYPTO_DMA_ENABLED */
@@ -152,6 +152,49 @@ int boot_store_measurement(uint8_t index,
                            const struct boot_measurement_metadata *metadata,
                            bool lock_measurement);
 
+/**
+ * Record of the last full validation of the image in a primary slot, used by
+ * MCUBOOT_VALIDATION_CACHE to skip the validation of an unchanged image.
+ */
+struct boot_validation_record {
+    uint32_t magic;             /* BOOT_VALIDATION_RECORD_MAGIC */
+    uint32_t image_off;         /* Offset of the slot in the flash device */
+    uint32_t image_size;        /* Size of the image, including the TLVs */
+    uint8_t digest[32];         /* SHA-256 of the header, TLVs, samples of the
+                                 * image and the end of the trailer.
+                                 */
+};
+
+#define BOOT_VALIDATION_RECORD_MAGIC    0x56424331U     /* "VBC1" */
+
+/**
+ * \brief Reads the validation record of an image from storage which only BL2
+ *        can access, such as OTP or storage bound to the lifecycle state.
+ *
+ * \note  The platform must fail this read after a tamper event or a lifecycle
+ *        change, so that the image is fully validated again.
+ *
+ * \param[in]  image_id  The ID of the image.
+ * \param[out] record    The record read.
+ *
+ * \return Returns 0 on success, non-zero if there is no valid record.
+ */
+int boot_platform_read_validation_record(uint32_t image_id,
+                                         struct boot_validation_record *record);
+
+/**
+ * \brief Writes the validation record of an image, or invalidates it if
+ *        record is NULL.
+ *
+ * \param[in] image_id  The ID of the image.
+ * \param[in] record    The record to write, or NULL.
+ *
+ * \return Returns 0 on success, non-zero otherwise.
+ */
+int boot_platform_write_validation_record(
+                                  uint32_t image_id,
+                                  const struct boot_validation_record *record);
+
 /**
  * \brief Run when boot has failed to load any images. Allows for a
  *        platform-specific response.
@@ -8,6 +8,7 @@
 #ifndef __EXCEPTION_INFO_H__
 #define __EXCEPTION_INFO_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #if defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
@@ -58,6 +59,19 @@ struct exception_info_t {
 #endif
 };
 
+/*
+ * Ring of the last exception contexts, in memory which is not cleared by a
+ * reset. It is stored before the context is printed, so that it can be reported
+ * on the next boot when the platform resets on fatal errors.
+ */
+#define EXCEPTION_INFO_RING_MAGIC     0x45584352u
+
+struct exception_info_ring_t {
+    uint32_t magic;             /* Set when the ring is initialized. */
+    uint32_t count;             /* Contexts stored since it was cleared. */
+    struct exception_info_t entries[];
+};
+
 /**
  * \brief Get a pointer to the current exception_info_t context
  *
@@ -66,6 +80,34 @@ struct exception_info_t {
  */
 void tfm_exception_info_get_context(struct exception_info_t *ctx);
 
+/**
+ * \brief Gets the ring of the exception contexts, provided by the platform.
+ *        The default implementation provides none.
+ *
+ * \param[out] num          Number of contexts the ring holds.
+ *
+ * \return  The ring, in memory retained across a reset, or NULL.
+ */
+struct exception_info_ring_t *tfm_plat_get_exception_info_ring(uint32_t *num);
+
+/**
+ * \brief Gets an exception context stored in the ring, for instance to report
+ *        it on the next boot through a platform IOCTL.
+ *
+ * \param[in]  idx          Index of the context, 0 being the last one stored.
+ * \param[out] ctx          The context.
+ *
+ * \retval true             The context is copied.
+ * \retval false            There is no such context.
+ */
+bool tfm_exception_info_get_retained(uint32_t idx,
+                                     struct exception_info_t *ctx);
+
+/**
+ * \brief Clears the ring of the exception contexts, once they are reported.
+ */
+void tfm_exception_info_clear_retained(void);
+
 /* Store context for an exception, then print the info.
  * Call EXCEPTION_INFO() instead of calling this directly.
  */
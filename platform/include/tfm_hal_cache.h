@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_CACHE_H__
+#define __TFM_HAL_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tfm_hal_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief  Writes the dirty data cache lines of a range back to memory, so that
+ *         a DMA master reads what the CPU wrote. Called by SPM in handler
+ *         mode for the tfm_cache_clean() of a partition, after SPM has checked
+ *         the access of the partition to the range. The default implementation
+ *         maintains the L1 data cache of the core, platforms with a system
+ *         cache override it.
+ *
+ * \param[in] addr   start address of the range
+ * \param[in] size   size of the range in bytes
+ *
+ * \return  TFM_HAL_SUCCESS - the range is clean.
+ *          TFM_HAL_ERROR_INVALID_INPUT - the range is not valid.
+ */
+enum tfm_hal_status_t tfm_hal_cache_clean(uintptr_t addr, size_t size);
+
+/**
+ * \brief  Discards the data cache lines of a range, so that the CPU reads what
+ *         a DMA master wrote. Called by SPM in handler mode for the
+ *         tfm_cache_invalidate() of a partition, after SPM has checked the
+ *         write access of the partition to the range. The range is rejected if
+ *         it does not start and end on cache line boundaries, as the lines it
+ *         shares with other data would be discarded too.
+ *
+ * \param[in] addr   start address of the range, cache line aligned
+ * \param[in] size   size of the range in bytes, a multiple of the line size
+ *
+ * \return  TFM_HAL_SUCCESS - the range is invalidated.
+ *          TFM_HAL_ERROR_INVALID_INPUT - the range is not valid or not aligned.
+ */
+enum tfm_hal_status_t tfm_hal_cache_invalidate(uintptr_t addr, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_HAL_CACHE_H__ */
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_DMA_H__
+#define __TFM_HAL_DMA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "tfm_hal_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief  Copies the data of a client vector with a DMA channel owned by the
+ *         SPE. Called by SPM for the psa_read() and psa_write() of at least
+ *         CONFIG_TFM_SPM_DMA_COPY_THRESHOLD bytes, after SPM has checked the
+ *         access of both the client and the partition to the buffers. The
+ *         HAL returns when the copy is complete, and can let the CPU sleep
+ *         until the DMA raises its completion interrupt. It does the cache
+ *         maintenance the buffers need.
+ *
+ * \param[out] dst        the destination buffer
+ * \param[in]  src        the source buffer
+ * \param[in]  size       the number of bytes to copy
+ * \param[in]  ns_client  the client is non-secure, the HAL picks the security
+ *                        attribute of the DMA transactions to its buffer
+ *
+ * \return  TFM_HAL_SUCCESS - the data is copied.
+ *          TFM_HAL_ERROR_NOT_SUPPORTED - the DMA cannot reach the buffers.
+ *          TFM_HAL_ERROR_BAD_STATE - no DMA channel is free.
+ *          On errors, SPM copies the data with the CPU instead.
+ */
+enum tfm_hal_status_t tfm_hal_dma_copy(void *dst, const void *src,
+                                       size_t size, bool ns_client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_HAL_DMA_H__ */
@@ -37,6 +37,15 @@ extern "C" {
 #error "TFM_HAL_ITS_PROGRAM_UNIT must be a power of two"
 #endif
 
+/* Optional. The address at which the ITS flash device is memory mapped for
+ * reads, address 0 of TFM_HAL_ITS_FLASH_DRIVER being mapped to it. When defined,
+ * the filesystem reads the file data in place instead of copying it with
+ * ReadData().
+ */
+#if defined(TFM_HAL_ITS_FLASH_MAP_ADDR) && (TFM_HAL_ITS_PROGRAM_UNIT > 16)
+#error "TFM_HAL_ITS_FLASH_MAP_ADDR is only supported on NOR flash"
+#endif
+
 /**
  * \brief Struct containing information required from the platform at runtime
  *        to configure the ITS filesystem.
@@ -73,6 +82,35 @@ extern ARM_DRIVER_FLASH TFM_HAL_ITS_FLASH_DRIVER;
 enum tfm_hal_status_t
 tfm_hal_its_fs_info(struct tfm_hal_its_fs_info_t *fs_info);
 
+/**
+ * \brief Retrieve the filesystem config of an ITS client shard, when
+ *        ITS_NUM_SHARDS is not 0. The shard is in its own flash area of
+ *        TFM_HAL_ITS_FLASH_DRIVER, which must not overlap the ITS area or the
+ *        areas of the other shards.
+ *
+ * \param [in]  shard    Shard number, from 1 to ITS_NUM_SHARDS
+ * \param [out] fs_info  Filesystem config information
+ *
+ * \return A status code as specified in \ref tfm_hal_status_t
+ *
+ * \retval TFM_HAL_SUCCESS              The operation completed successfully
+ * \retval TFM_HAL_ERROR_INVALID_INPUT  Invalid parameter
+ * \retval TFM_HAL_ERROR_NOT_SUPPORTED  The platform has no area for the shard
+ */
+enum tfm_hal_status_t
+tfm_hal_its_shard_fs_info(uint32_t shard, struct tfm_hal_its_fs_info_t *fs_info);
+
+/**
+ * \brief Get the shard which stores the assets of a client, when
+ *        ITS_NUM_SHARDS is not 0. The mapping must not change across resets.
+ *
+ * \param [in] client_id  Partition ID of a secure client, or negative ID of a
+ *                        non-secure client
+ *
+ * \return The shard number, from 1 to ITS_NUM_SHARDS, or 0 for the ITS area
+ */
+uint32_t tfm_hal_its_client_shard(int32_t client_id);
+
 #ifdef __cplusplus
 }
 #endif
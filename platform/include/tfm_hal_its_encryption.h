@@ -53,6 +53,11 @@ enum tfm_hal_status_t tfm_hal_its_aead_generate_nonce(uint8_t *nonce,
  *          It will start with deriving a key based long-term key-derivation
  *          key and the provided derivation label.
  *          This derived key will then be used to perform the AEAD operation.
+ *          Consecutive operations often use the same derivation label, for
+ *          instance for the reads of a file, so the platform can keep the
+ *          key context of the last labels and only set the nonce and the
+ *          additional data for each operation. The chunks of a file use one
+ *          label each, made of the file ID and the chunk index.
  *          Therefore the following members of the ctx struct must be set:
  *          nonce
  *          nonce_size
@@ -44,6 +44,9 @@ struct secure_mailbox_queue_t {
     uint32_t                     ns_slot_count;
     /* Pointer to struct mailbox_slot_t[slot_count] allocated by NS */
     struct mailbox_slot_t        *ns_slots;
+    /* Optional NS buffer pool for client call payloads */
+    void                         *ns_shm_base;
+    uint32_t                     ns_shm_size;
 };
 
 /**
@@ -75,4 +78,75 @@ void tfm_mailbox_hal_enter_critical(void);
  */
 void tfm_mailbox_hal_exit_critical(void);
 
+#if MAILBOX_CACHE_LINE_SIZE > 0
+/**
+ * \brief Clean the data cache lines of a part of an NSPE mailbox queue written
+ *        by SPE, so that NSPE can read it.
+ *
+ * \param[in] addr              The base address, aligned to a cache line.
+ * \param[in] size              The size, a multiple of the cache line size.
+ *
+ * \note The lines are written to memory when it returns.
+ */
+void tfm_mailbox_hal_cache_clean(const void *addr, size_t size);
+
+/**
+ * \brief Invalidate the data cache lines of a part of an NSPE mailbox queue
+ *        before SPE reads what NSPE wrote to it.
+ *
+ * \param[in] addr              The base address, aligned to a cache line.
+ * \param[in] size              The size, a multiple of the cache line size.
+ */
+void tfm_mailbox_hal_cache_invalidate(void *addr, size_t size);
+#else
+#define tfm_mailbox_hal_cache_clean(addr, size)             do {} while (0)
+#define tfm_mailbox_hal_cache_invalidate(addr, size)        do {} while (0)
+#endif
+
+#if NUM_MAILBOX_PEERS > 1
+/*
+ * With several NSPE cores, each core is a peer with its own mailbox queue, and
+ * the functions below are implemented instead of the ones above. The NS buffer
+ * pool, if any, is shared by all peers and is set in the queue of peer 0.
+ */
+
+/**
+ * \brief Platform specific initialization of the SPE mailbox of a peer.
+ *
+ * \param[in] peer              The index of the peer, less than
+ *                              NUM_MAILBOX_PEERS.
+ * \param[in] s_queue           The base address of the SPE mailbox queue of
+ *                              the peer.
+ *
+ * \retval MAILBOX_SUCCESS      Operation succeeded.
+ * \retval Other return code    Operation failed with an error code.
+ */
+int32_t tfm_mailbox_hal_peer_init(uint32_t peer,
+                                  struct secure_mailbox_queue_t *s_queue);
+
+/**
+ * \brief Notify a peer that PSA client call return results are replied.
+ *
+ * \param[in] peer              The index of the peer.
+ *
+ * \retval MAILBOX_SUCCESS      The notification is successfully sent out.
+ * \retval Other return code    Operation failed with an error code.
+ */
+int32_t tfm_mailbox_hal_peer_notify(uint32_t peer);
+
+/**
+ * \brief Enter critical section of the NSPE mailbox of a peer
+ *
+ * \param[in] peer              The index of the peer.
+ */
+void tfm_mailbox_hal_peer_enter_critical(uint32_t peer);
+
+/**
+ * \brief Exit critical section of the NSPE mailbox of a peer
+ *
+ * \param[in] peer              The index of the peer.
+ */
+void tfm_mailbox_hal_peer_exit_critical(uint32_t peer);
+#endif /* NUM_MAILBOX_PEERS > 1 */
+
 #endif /* __TFM_HAL_MAILBOX_H__ */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_NPU_H__
+#define __TFM_HAL_NPU_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tfm_hal_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief  Prepares the NPU for the NPU partition. Called once from the
+ *         partition before its interrupt is enabled.
+ *
+ * \return  TFM_HAL_SUCCESS - the NPU is ready.
+ *          TFM_HAL_ERROR_GENERIC - the NPU could not be initialised.
+ */
+enum tfm_hal_status_t tfm_hal_npu_init(void);
+
+/**
+ * \brief  Starts a command stream. The buffers are in memory the NPU can
+ *         access, the HAL does the cache maintenance they need and translates
+ *         their addresses to the addresses of the NPU bus. The NPU raises its
+ *         interrupt when the command stream ends.
+ *
+ * \param[in] cmd         the command stream
+ * \param[in] cmd_size    the size of the command stream in bytes
+ * \param[in] base_addr   the base address regions of the command stream
+ * \param[in] base_size   the sizes of the regions in bytes
+ * \param[in] num         the number of regions
+ * \param[in] out_mask    the regions the NPU writes for the CPU to read, bit
+ *                        n set for region n
+ *
+ * \return  TFM_HAL_SUCCESS - the command stream is started.
+ *          TFM_HAL_ERROR_INVALID_INPUT - too many regions for the NPU.
+ *          TFM_HAL_ERROR_BAD_STATE - the NPU is busy.
+ *          TFM_HAL_ERROR_GENERIC - the command stream could not be started.
+ */
+enum tfm_hal_status_t tfm_hal_npu_start(const void *cmd, size_t cmd_size,
+                                        void *const base_addr[],
+                                        const size_t base_size[],
+                                        uint32_t num, uint32_t out_mask);
+
+/**
+ * \brief  Acknowledges the interrupt of the NPU after a command stream
+ *         ended, and makes its outputs visible to the CPU.
+ *
+ * \return  TFM_HAL_SUCCESS - the command stream completed.
+ *          TFM_HAL_ERROR_GENERIC - the NPU reported an error, it is reset.
+ */
+enum tfm_hal_status_t tfm_hal_npu_finish(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_HAL_NPU_H__ */
@@ -73,6 +73,21 @@ uint32_t tfm_hal_get_ns_VTOR(void);
  */
 uint32_t tfm_hal_get_ns_entry_point(void);
 
+/**
+ * \brief Wait for an interrupt in a low power state while the SPE is idle.
+ *
+ * This function is called by the idle partition when no Secure Partition is
+ * runnable and CONFIG_TFM_IDLE_LOW_POWER is enabled. The platform picks the
+ * deepest state it can leave in time for the next wakeup. It returns after any
+ * interrupt woke up the CPU.
+ *
+ * \param[in] p_next_wakeup  Earliest registered wakeup deadline in ticks of
+ *                           the platform timer, NULL if there is none.
+ *
+ * \note A weak default implementation which executes WFI is provided.
+ */
+void tfm_hal_idle_enter(const uint32_t *p_next_wakeup);
+
 #ifdef TFM_PARTITION_NS_AGENT_TZ
 /**
  * \brief Get the initial address of non-secure image main stack
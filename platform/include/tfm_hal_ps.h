@@ -37,6 +37,15 @@ extern "C" {
 #error "TFM_HAL_PS_PROGRAM_UNIT must be a power of two"
 #endif
 
+/* Optional. The address at which the PS flash device is memory mapped for
+ * reads, address 0 of TFM_HAL_PS_FLASH_DRIVER being mapped to it. When defined,
+ * the filesystem reads the file data in place instead of copying it with
+ * ReadData().
+ */
+#if defined(TFM_HAL_PS_FLASH_MAP_ADDR) && (TFM_HAL_PS_PROGRAM_UNIT > 16)
+#error "TFM_HAL_PS_FLASH_MAP_ADDR is only supported on NOR flash"
+#endif
+
 /**
  * \brief Struct containing information required from the platform at runtime
  *        to configure the PS filesystem.
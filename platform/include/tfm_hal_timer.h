@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_TIMER_H__
+#define __TFM_HAL_TIMER_H__
+
+#include <stdint.h>
+#include "tfm_hal_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief  Starts the secure timer of the Secure Timer partition. Called once
+ *         from the partition before its interrupt is enabled.
+ *
+ * \return  TFM_HAL_SUCCESS - the timer is running.
+ *          TFM_HAL_ERROR_GENERIC - the timer could not be initialised.
+ */
+enum tfm_hal_status_t tfm_hal_timer_init(void);
+
+/**
+ * \brief  Gets the counter of the secure timer, in ticks. It counts up and
+ *         wraps around at 2^32 ticks.
+ *
+ * \return  The counter.
+ */
+uint32_t tfm_hal_timer_get_ticks(void);
+
+/**
+ * \brief  Raises the TFM_SECURE_TIMER_IRQ interrupt when the counter reaches a
+ *         value, replacing the previous alarm. The interrupt can also be raised
+ *         if the value is already reached.
+ *
+ * \param[in] ticks       the value of the counter, less than 2^31 ticks after
+ *                        the current one
+ */
+void tfm_hal_timer_set_alarm(uint32_t ticks);
+
+/**
+ * \brief  Cancels the alarm and acknowledges its interrupt.
+ */
+void tfm_hal_timer_clear_alarm(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_HAL_TIMER_H__ */
@@ -121,6 +121,34 @@ enum tfm_plat_err_t tfm_plat_otp_init(void);
 enum tfm_plat_err_t tfm_plat_otp_read(enum tfm_otp_element_id_t id,
                                       size_t out_len, uint8_t *out);
 
+/**
+ * \brief                               Reads a part of a large OTP element in
+ *                                      a single burst.
+ *
+ * \param[in]  id                       ID of the element to read.
+ * \param[in]  offset                   Offset of the part in the element in
+ *                                      bytes.
+ * \param[in]  out_len                  Size of the part in bytes.
+ * \param[out] out                      Buffer to read the part into.
+ *
+ * \note                                This function is only required by
+ *                                      BL1_1 when it is built with
+ *                                      TFM_BL1_2_OTP_BURST_READ. The platform
+ *                                      may skip the read checks it performs
+ *                                      word by word in tfm_plat_otp_read(),
+ *                                      as the content is authenticated by the
+ *                                      caller.
+ *
+ * \retval TFM_PLAT_ERR_SUCCESS         The part is read successfully.
+ * \retval TFM_PLAT_ERR_INVALID_INPUT   The part is outside the element.
+ * \retval TFM_PLAT_ERR_UNSUPPORTED     The given element cannot be read in
+ *                                      bursts on this platform.
+ * \retval TFM_PLAT_ERR_SYSTEM_ERR      An unspecified error occurred.
+ */
+enum tfm_plat_err_t tfm_plat_otp_read_burst(enum tfm_otp_element_id_t id,
+                                            size_t offset, size_t out_len,
+                                            uint8_t *out);
+
 /**
  * \brief                               Writes the specified bytes to the given
  *                                      OTP element.
@@ -13,6 +13,13 @@
 
 #define ADDR_WORD_UNALIGNED(x)        ((x) & 0x3)
 
+/*
+ * Number of words transferred per loop iteration in bulk copy and set.
+ * Grouping the accesses lets the compiler emit multiple-register LDM/STM.
+ */
+#define WORDS_PER_BURST               4
+#define BYTES_PER_BURST               (WORDS_PER_BURST * sizeof(uint32_t))
+
 union composite_addr_t {
     uintptr_t uint_addr;        /* Address as integer value  */
     uint8_t   *p_byte;          /* Address in BYTE pointer   */
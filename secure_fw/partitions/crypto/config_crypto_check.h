@@ -19,4 +19,8 @@
 #error "Invalid config: NOT CRYPTO_NV_SEED AND NOT CRYPTO_HW_ACCELERATOR!"
 #endif
 
+#if (TFM_ISOLATION_LEVEL == 3) && (CRYPTO_STATS_ENTRIES > 0)
+#error "Invalid config: TFM_ISOLATION_LEVEL 3 AND CRYPTO_STATS_ENTRIES!"
+#endif
+
 #endif /* __CONFIG_PARTITION_CRYPTO_H__ */
@@ -29,39 +29,165 @@ enum {
 #define TFM_CRYPTO_INVALID_HANDLE (0x0u)
 
 /**
- * \brief A type describing the context stored in Secure memory by the TF-M Crypto
- *        service to support multipart calls on secure side
+ * \brief A handle encodes the pool of the context in its upper bits, and the
+ *        index of the context in the pool plus one in its lower bits.
  */
-struct tfm_crypto_operation_s {
+#define TFM_CRYPTO_HANDLE_POOL_SHIFT (16u)
+#define TFM_CRYPTO_HANDLE_INDEX_MASK ((1u << TFM_CRYPTO_HANDLE_POOL_SHIFT) - 1u)
+
+/**
+ * \brief The number of pools: the shared pool, then one per operation type
+ */
+#define TFM_CRYPTO_POOL_NUM (TFM_CRYPTO_AEAD_OPERATION + 1)
+
+/**
+ * \brief A type describing the bookkeeping of a context stored in Secure memory
+ */
+struct tfm_crypto_operation_hdr_s {
     uint32_t in_use;                /*!< Indicates if the operation is in use */
     int32_t owner;                  /*!< Indicates an ID of the owner of
                                      *   the context
                                      */
     enum tfm_crypto_operation_type type; /*!< Type of the operation */
+    uint32_t next_free;             /*!< Index plus one of the next free
+                                     *   context of the pool, 0 if none
+                                     */
+};
+
+/**
+ * \brief A type describing the context stored in Secure memory by the TF-M Crypto
+ *        service to support multipart calls on secure side, for the types
+ *        which don't have a dedicated pool
+ */
+struct tfm_crypto_operation_s {
+    struct tfm_crypto_operation_hdr_s hdr; /*!< Bookkeeping of the context */
     union {
+#if !CRYPTO_CONC_CIPHER_OPER_NUM
         psa_cipher_operation_t cipher;    /*!< Cipher operation context */
+#endif
+#if !CRYPTO_CONC_MAC_OPER_NUM
         psa_mac_operation_t mac;          /*!< MAC operation context */
+#endif
+#if !CRYPTO_CONC_HASH_OPER_NUM
         psa_hash_operation_t hash;        /*!< Hash operation context */
+#endif
+#if !CRYPTO_CONC_KEY_DERIVATION_OPER_NUM
         psa_key_derivation_operation_t key_deriv; /*!< Key derivation operation context */
+#endif
+#if !CRYPTO_CONC_AEAD_OPER_NUM
         psa_aead_operation_t aead;        /*!< AEAD operation context */
+#endif
+        uint32_t none;                    /*!< Keeps the union non empty */
     } operation;
 };
 
-static struct tfm_crypto_operation_s operations[CRYPTO_CONC_OPER_NUM] = {{0}};
+/**
+ * \brief Defines a pool of contexts of a single type, sized for that type
+ */
+#define TFM_CRYPTO_TYPED_POOL(name, ctx_type, num)              \
+    static struct {                                             \
+        struct tfm_crypto_operation_hdr_s hdr;                  \
+        ctx_type operation;                                     \
+    } name[num]
+
+#if CRYPTO_CONC_OPER_NUM
+static struct tfm_crypto_operation_s operations[CRYPTO_CONC_OPER_NUM];
+#endif
+#if CRYPTO_CONC_CIPHER_OPER_NUM
+TFM_CRYPTO_TYPED_POOL(cipher_operations, psa_cipher_operation_t,
+                      CRYPTO_CONC_CIPHER_OPER_NUM);
+#endif
+#if CRYPTO_CONC_MAC_OPER_NUM
+TFM_CRYPTO_TYPED_POOL(mac_operations, psa_mac_operation_t,
+                      CRYPTO_CONC_MAC_OPER_NUM);
+#endif
+#if CRYPTO_CONC_HASH_OPER_NUM
+TFM_CRYPTO_TYPED_POOL(hash_operations, psa_hash_operation_t,
+                      CRYPTO_CONC_HASH_OPER_NUM);
+#endif
+#if CRYPTO_CONC_KEY_DERIVATION_OPER_NUM
+TFM_CRYPTO_TYPED_POOL(key_deriv_operations, psa_key_derivation_operation_t,
+                      CRYPTO_CONC_KEY_DERIVATION_OPER_NUM);
+#endif
+#if CRYPTO_CONC_AEAD_OPER_NUM
+TFM_CRYPTO_TYPED_POOL(aead_operations, psa_aead_operation_t,
+                      CRYPTO_CONC_AEAD_OPER_NUM);
+#endif
+
+/**
+ * \brief A type describing a pool of contexts as an array of slots, each one
+ *        made of a header followed by the context
+ */
+struct tfm_crypto_pool_s {
+    uint8_t *slots;         /*!< Slots of the pool, NULL if there is none */
+    size_t slot_size;       /*!< Size of a slot */
+    size_t ctx_offset;      /*!< Offset of the context in a slot */
+    size_t ctx_size;        /*!< Size of the context */
+    uint32_t num;           /*!< Number of slots */
+    uint32_t free_head;     /*!< Index plus one of the first free slot, 0 if
+                             *   the pool is full
+                             */
+    uint32_t in_use;        /*!< Number of slots allocated */
+    uint32_t high_water;    /*!< Largest number of slots allocated so far */
+};
+
+static struct tfm_crypto_pool_s pools[TFM_CRYPTO_POOL_NUM];
+
+/**
+ * \brief Describes the slots of a pool, with \a pool one of the arrays above
+ */
+#define TFM_CRYPTO_POOL_INIT(id, pool)                                         \
+    do {                                                                       \
+        pools[(id)].slots = (uint8_t *)(pool);                                 \
+        pools[(id)].slot_size = sizeof((pool)[0]);                             \
+        pools[(id)].ctx_offset = (size_t)((uint8_t *)&(pool)[0].operation -    \
+                                          (uint8_t *)&(pool)[0]);              \
+        pools[(id)].ctx_size = sizeof((pool)[0].operation);                    \
+        pools[(id)].num = sizeof(pool) / sizeof((pool)[0]);                    \
+    } while (0)
 
 /*
- * \brief Function used to clear the memory associated to a backend context
+ * \brief Function used to retrieve the header of a slot in a pool
  *
- * \param[in] index Numerical index in the database of the backend contexts
+ * \param[in] pool  Pool of the slot
+ * \param[in] index Numerical index of the slot in the pool
  *
- * \return None
+ * \return Pointer to the header of the slot
+ */
+static struct tfm_crypto_operation_hdr_s *slot_hdr(
+                                            const struct tfm_crypto_pool_s *pool,
+                                            uint32_t index)
+{
+    return (struct tfm_crypto_operation_hdr_s *)
+                                    &pool->slots[index * pool->slot_size];
+}
+
+/*
+ * \brief Function used to decode a handle into the header of its slot
+ *
+ * \param[in]  handle Handle of the context
+ * \param[out] pool   Pool of the context
+ * \param[out] index  Numerical index of the context in its pool
  *
+ * \return Pointer to the header of the slot, NULL if the handle is invalid
  */
-static void memset_operation_context(uint32_t index)
+static struct tfm_crypto_operation_hdr_s *handle_to_hdr(
+                                                uint32_t handle,
+                                                struct tfm_crypto_pool_s **pool,
+                                                uint32_t *index)
 {
-    /* Clear the contents of the backend context */
-    (void)memset((uint8_t *)&(operations[index].operation), 0,
-                 sizeof(operations[index].operation));
+    uint32_t pool_id = handle >> TFM_CRYPTO_HANDLE_POOL_SHIFT;
+    uint32_t idx = handle & TFM_CRYPTO_HANDLE_INDEX_MASK;
+
+    if ((pool_id >= TFM_CRYPTO_POOL_NUM) || (idx == 0) ||
+        (idx > pools[pool_id].num)) {
+        return NULL;
+    }
+
+    *pool = &pools[pool_id];
+    *index = idx - 1;
+
+    return slot_hdr(*pool, *index);
 }
 
 /*!
@@ -73,8 +199,44 @@ static void memset_operation_context(uint32_t index)
 /*!@{*/
 psa_status_t tfm_crypto_init_alloc(void)
 {
-    /* Clear the contents of the local contexts */
-    (void)memset(operations, 0, sizeof(operations));
+    uint32_t id, i;
+
+    (void)memset(pools, 0, sizeof(pools));
+
+#if CRYPTO_CONC_OPER_NUM
+    TFM_CRYPTO_POOL_INIT(TFM_CRYPTO_OPERATION_NONE, operations);
+#endif
+#if CRYPTO_CONC_CIPHER_OPER_NUM
+    TFM_CRYPTO_POOL_INIT(TFM_CRYPTO_CIPHER_OPERATION, cipher_operations);
+#endif
+#if CRYPTO_CONC_MAC_OPER_NUM
+    TFM_CRYPTO_POOL_INIT(TFM_CRYPTO_MAC_OPERATION, mac_operations);
+#endif
+#if CRYPTO_CONC_HASH_OPER_NUM
+    TFM_CRYPTO_POOL_INIT(TFM_CRYPTO_HASH_OPERATION, hash_operations);
+#endif
+#if CRYPTO_CONC_KEY_DERIVATION_OPER_NUM
+    TFM_CRYPTO_POOL_INIT(TFM_CRYPTO_KEY_DERIVATION_OPERATION,
+                         key_deriv_operations);
+#endif
+#if CRYPTO_CONC_AEAD_OPER_NUM
+    TFM_CRYPTO_POOL_INIT(TFM_CRYPTO_AEAD_OPERATION, aead_operations);
+#endif
+
+    /* Clear the contents of the local contexts and chain the free slots */
+    for (id = 0; id < TFM_CRYPTO_POOL_NUM; id++) {
+        if (pools[id].num == 0) {
+            continue;
+        }
+
+        (void)memset(pools[id].slots, 0, pools[id].num * pools[id].slot_size);
+        for (i = 0; i < pools[id].num; i++) {
+            slot_hdr(&pools[id], i)->next_free =
+                                        (i + 1 < pools[id].num) ? i + 2 : 0;
+        }
+        pools[id].free_head = 1;
+    }
+
     return PSA_SUCCESS;
 }
 
@@ -82,9 +244,11 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
                                         uint32_t *handle,
                                         void **ctx)
 {
-    uint32_t i = 0;
     int32_t partition_id = 0;
     psa_status_t status;
+    struct tfm_crypto_pool_s *pool;
+    struct tfm_crypto_operation_hdr_s *hdr;
+    uint32_t pool_id, index;
 
     /* Handle must be initialised before calling a setup function */
     if (*handle != TFM_CRYPTO_INVALID_HANDLE) {
@@ -92,7 +256,8 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
     }
 
     /* Init to invalid values */
-    if (ctx == NULL) {
+    if ((ctx == NULL) || (type == TFM_CRYPTO_OPERATION_NONE) ||
+        ((uint32_t)type >= TFM_CRYPTO_POOL_NUM)) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
     *ctx = NULL;
@@ -102,18 +267,31 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
         return status;
     }
 
-    for (i = 0; i < CRYPTO_CONC_OPER_NUM; i++) {
-        if (operations[i].in_use == TFM_CRYPTO_NOT_IN_USE) {
-            operations[i].in_use = TFM_CRYPTO_IN_USE;
-            operations[i].owner = partition_id;
-            operations[i].type = type;
-            *handle = i + 1;
-            *ctx = (void *) &(operations[i].operation);
-            return PSA_SUCCESS;
-        }
+    /* Types without a dedicated pool use the shared one */
+    pool_id = (pools[type].num != 0) ? (uint32_t)type :
+                                       (uint32_t)TFM_CRYPTO_OPERATION_NONE;
+    pool = &pools[pool_id];
+
+    if (pool->free_head == 0) {
+        return PSA_ERROR_NOT_PERMITTED;
     }
 
-    return PSA_ERROR_NOT_PERMITTED;
+    index = pool->free_head - 1;
+    hdr = slot_hdr(pool, index);
+    pool->free_head = hdr->next_free;
+
+    hdr->in_use = TFM_CRYPTO_IN_USE;
+    hdr->owner = partition_id;
+    hdr->type = type;
+    hdr->next_free = 0;
+    pool->in_use++;
+    if (pool->in_use > pool->high_water) {
+        pool->high_water = pool->in_use;
+    }
+    *handle = (pool_id << TFM_CRYPTO_HANDLE_POOL_SHIFT) | (index + 1);
+    *ctx = (void *)((uint8_t *)hdr + pool->ctx_offset);
+
+    return PSA_SUCCESS;
 }
 
 psa_status_t tfm_crypto_operation_release(uint32_t *handle)
@@ -121,12 +299,15 @@ psa_status_t tfm_crypto_operation_release(uint32_t *handle)
     uint32_t h_val = *handle;
     int32_t partition_id = 0;
     psa_status_t status;
+    struct tfm_crypto_pool_s *pool;
+    struct tfm_crypto_operation_hdr_s *hdr;
+    uint32_t index;
 
     /* Handle shall be cleaned up always at first */
     *handle = TFM_CRYPTO_INVALID_HANDLE;
 
-    if ((h_val == TFM_CRYPTO_INVALID_HANDLE) ||
-        (h_val > CRYPTO_CONC_OPER_NUM)) {
+    hdr = handle_to_hdr(h_val, &pool, &index);
+    if (hdr == NULL) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
@@ -135,13 +316,19 @@ psa_status_t tfm_crypto_operation_release(uint32_t *handle)
         return status;
     }
 
-    if ((operations[h_val - 1].in_use == TFM_CRYPTO_IN_USE) &&
-        (operations[h_val - 1].owner == partition_id)) {
+    if ((hdr->in_use == TFM_CRYPTO_IN_USE) &&
+        (hdr->owner == partition_id)) {
+
+        /* Clear the contents of the backend context */
+        (void)memset((uint8_t *)hdr + pool->ctx_offset, 0, pool->ctx_size);
+        hdr->in_use = TFM_CRYPTO_NOT_IN_USE;
+        hdr->type = TFM_CRYPTO_OPERATION_NONE;
+        hdr->owner = 0;
 
-        memset_operation_context(h_val - 1);
-        operations[h_val - 1].in_use = TFM_CRYPTO_NOT_IN_USE;
-        operations[h_val - 1].type = TFM_CRYPTO_OPERATION_NONE;
-        operations[h_val - 1].owner = 0;
+        /* Return the slot to the free list of its pool */
+        hdr->next_free = pool->free_head;
+        pool->free_head = index + 1;
+        pool->in_use--;
 
         return PSA_SUCCESS;
     }
@@ -155,9 +342,12 @@ psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
 {
     int32_t partition_id = 0;
     psa_status_t status;
+    struct tfm_crypto_pool_s *pool;
+    struct tfm_crypto_operation_hdr_s *hdr;
+    uint32_t index;
 
-    if ((handle == TFM_CRYPTO_INVALID_HANDLE) ||
-        (handle > CRYPTO_CONC_OPER_NUM)) {
+    hdr = handle_to_hdr(handle, &pool, &index);
+    if (hdr == NULL) {
         return PSA_ERROR_BAD_STATE;
     }
 
@@ -170,13 +360,22 @@ psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
         return status;
     }
 
-    if ((operations[handle - 1].in_use == TFM_CRYPTO_IN_USE) &&
-        (operations[handle - 1].type == type) &&
-        (operations[handle - 1].owner == partition_id)) {
-        *ctx = (void *) &(operations[handle - 1].operation);
+    if ((hdr->in_use == TFM_CRYPTO_IN_USE) &&
+        (hdr->type == type) &&
+        (hdr->owner == partition_id)) {
+        *ctx = (void *)((uint8_t *)hdr + pool->ctx_offset);
         return PSA_SUCCESS;
     }
 
     return PSA_ERROR_BAD_STATE;
 }
+
+#if CRYPTO_STATS_ENTRIES > 0
+void tfm_crypto_operation_get_stats(enum tfm_crypto_operation_type type,
+                                    uint32_t *num, uint32_t *high_water)
+{
+    *num = pools[type].num;
+    *high_water = pools[type].high_water;
+}
+#endif
 /*!@}*/
@@ -165,6 +165,27 @@ psa_status_t tfm_crypto_hash_interface(psa_invec in_vec[],
         }
     }
     break;
+    case TFM_CRYPTO_HASH_FINISH_SNAPSHOT_SID:
+    {
+        /*
+         * The clone only lives for this request, so it is kept on the stack
+         * instead of taking a context of the operation pool.
+         */
+        psa_hash_operation_t snapshot = PSA_HASH_OPERATION_INIT;
+        uint8_t *hash = out_vec[0].base;
+        size_t hash_size = out_vec[0].len;
+
+        status = psa_hash_clone(operation, &snapshot);
+        if (status == PSA_SUCCESS) {
+            status = psa_hash_finish(&snapshot, hash, hash_size,
+                                     &out_vec[0].len);
+        }
+        if (status != PSA_SUCCESS) {
+            (void)psa_hash_abort(&snapshot);
+            out_vec[0].len = 0;
+        }
+    }
+    break;
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "config_tfm.h"
+#include "crypto_library.h"
+
+#if CRYPTO_ENGINE_HEAP_POOLS
+
+/*
+ * Heap of the crypto backend made of size classes. The blocks of a class are
+ * carved from the start of the heap, and are kept in the free list of their
+ * class when freed, so that allocating and freeing them doesn't search the
+ * heap. The bigger blocks, such as the bignums of RSA, are carved from the end
+ * of the heap and reused first-fit when freed, adjacent free blocks being
+ * merged. A small block falls back to this when its class has no room left.
+ */
+
+/**
+ * \brief Alignment of the blocks, enough for any type used by the backend
+ */
+#define HEAP_ALIGN          (8u)
+#define HEAP_ALIGN_UP(x)    (((x) + (HEAP_ALIGN - 1)) & ~(size_t)(HEAP_ALIGN - 1))
+
+/**
+ * \brief Size of the smallest class, the classes double from it
+ */
+#define HEAP_BIN_MIN        (16u)
+#define HEAP_BIN_SIZE(i)    ((size_t)HEAP_BIN_MIN << (i))
+#define HEAP_BIN_MAX        HEAP_BIN_SIZE(CRYPTO_ENGINE_HEAP_BIN_NUM - 1)
+
+/**
+ * \brief Class of the blocks carved from the end of the heap
+ */
+#define HEAP_NO_BIN         (0xFFFFFFFFu)
+
+/**
+ * \brief Header before each block, its size keeps the blocks aligned
+ */
+struct heap_hdr {
+    uint32_t size;          /* Size of the block after the header */
+    uint32_t bin;           /* Class of the block, or HEAP_NO_BIN */
+};
+
+/**
+ * \brief A free block, in the free list of its class or of the big blocks
+ */
+struct heap_free {
+    struct heap_hdr hdr;
+    struct heap_free *next;
+};
+
+/**
+ * \brief Smallest size of a big block, which holds a free list link when freed
+ */
+#define HEAP_SPAN_MIN \
+    HEAP_ALIGN_UP(sizeof(struct heap_free) - sizeof(struct heap_hdr))
+
+/**
+ * \brief End of a block, which is the start of the next one
+ */
+#define HEAP_BLOCK_END(blk) \
+    ((uint8_t *)((struct heap_hdr *)(blk) + 1) + ((struct heap_hdr *)(blk))->size)
+
+static struct {
+    uint8_t *base;
+    uint8_t *end;
+    uint8_t *low;       /* End of the blocks carved from the start */
+    uint8_t *high;      /* Start of the blocks carved from the end */
+    struct heap_free *bins[CRYPTO_ENGINE_HEAP_BIN_NUM];
+    struct heap_free *spans;    /* Free big blocks, by increasing address */
+    size_t in_use;      /* Bytes of the allocated blocks and their headers */
+    size_t high_water;  /* Largest part of the heap carved so far */
+    uint32_t failed;    /* Allocations which failed */
+} heap;
+
+static void heap_update_high_water(void)
+{
+    size_t carved = (size_t)(heap.low - heap.base) +
+                    (size_t)(heap.end - heap.high);
+
+    if (carved > heap.high_water) {
+        heap.high_water = carved;
+    }
+}
+
+static struct heap_hdr *heap_alloc_bin(uint32_t bin)
+{
+    size_t block_size = sizeof(struct heap_hdr) + HEAP_BIN_SIZE(bin);
+    struct heap_hdr *hdr;
+
+    if (heap.bins[bin] != NULL) {
+        hdr = &heap.bins[bin]->hdr;
+        heap.bins[bin] = heap.bins[bin]->next;
+        return hdr;
+    }
+
+    if (block_size > (size_t)(heap.high - heap.low)) {
+        return NULL;
+    }
+
+    hdr = (struct heap_hdr *)heap.low;
+    hdr->size = (uint32_t)HEAP_BIN_SIZE(bin);
+    hdr->bin = bin;
+    heap.low += block_size;
+
+    return hdr;
+}
+
+/**
+ * \brief Gives the free blocks of the classes at the end of the blocks carved
+ *        from the start back to the free space in the middle. Called when a
+ *        big block doesn't fit, as it searches all the free lists.
+ */
+static bool heap_trim_bins(void)
+{
+    struct heap_free **prev;
+    bool trimmed = false, found;
+    uint32_t bin;
+
+    do {
+        found = false;
+        for (bin = 0; bin < CRYPTO_ENGINE_HEAP_BIN_NUM; bin++) {
+            for (prev = &heap.bins[bin]; *prev != NULL; prev = &(*prev)->next) {
+                if (HEAP_BLOCK_END(*prev) == heap.low) {
+                    heap.low = (uint8_t *)*prev;
+                    *prev = (*prev)->next;
+                    found = true;
+                    trimmed = true;
+                    break;
+                }
+            }
+        }
+    } while (found);
+
+    return trimmed;
+}
+
+static struct heap_hdr *heap_alloc_span(size_t size)
+{
+    struct heap_free **prev = &heap.spans;
+    struct heap_free *span;
+    struct heap_hdr *hdr;
+    size_t block_size = sizeof(struct heap_hdr) + size;
+
+    for (span = heap.spans; span != NULL; prev = &span->next, span = span->next) {
+        if (span->hdr.size < size) {
+            continue;
+        }
+
+        /* Take the end of the span if the rest can still hold a block */
+        if (span->hdr.size - size >= sizeof(struct heap_hdr) + HEAP_SPAN_MIN) {
+            span->hdr.size -= (uint32_t)block_size;
+            hdr = (struct heap_hdr *)HEAP_BLOCK_END(span);
+            hdr->size = (uint32_t)size;
+        } else {
+            *prev = span->next;
+            hdr = &span->hdr;
+        }
+        hdr->bin = HEAP_NO_BIN;
+
+        return hdr;
+    }
+
+    if ((block_size > (size_t)(heap.high - heap.low)) &&
+        (!heap_trim_bins() || (block_size > (size_t)(heap.high - heap.low)))) {
+        return NULL;
+    }
+
+    heap.high -= block_size;
+    hdr = (struct heap_hdr *)heap.high;
+    hdr->size = (uint32_t)size;
+    hdr->bin = HEAP_NO_BIN;
+
+    return hdr;
+}
+
+static void heap_free_span(struct heap_free *blk)
+{
+    struct heap_free **prev = &heap.spans;
+    struct heap_free *before = NULL;
+    struct heap_free *next;
+
+    while ((*prev != NULL) && (*prev < blk)) {
+        before = *prev;
+        prev = &before->next;
+    }
+    next = *prev;
+
+    /* Merge with the next free block */
+    if ((next != NULL) && (HEAP_BLOCK_END(blk) == (uint8_t *)next)) {
+        blk->hdr.size += sizeof(struct heap_hdr) + next->hdr.size;
+        next = next->next;
+    }
+    blk->next = next;
+
+    /* Merge with the previous free block */
+    if ((before != NULL) && (HEAP_BLOCK_END(before) == (uint8_t *)blk)) {
+        before->hdr.size += sizeof(struct heap_hdr) + blk->hdr.size;
+        before->next = blk->next;
+    } else {
+        *prev = blk;
+    }
+
+    /* Give the lowest free block back to the free space in the middle */
+    if ((uint8_t *)heap.spans == heap.high) {
+        blk = heap.spans;
+        heap.spans = blk->next;
+        heap.high = HEAP_BLOCK_END(blk);
+    }
+}
+
+void tfm_crypto_heap_init(uint8_t *buf, size_t size)
+{
+    uint8_t *end = buf + size;
+
+    memset(&heap, 0, sizeof(heap));
+
+    heap.base = (uint8_t *)HEAP_ALIGN_UP((uintptr_t)buf);
+    heap.end = (uint8_t *)((uintptr_t)end & ~(uintptr_t)(HEAP_ALIGN - 1));
+    heap.low = heap.base;
+    heap.high = heap.end;
+}
+
+void *tfm_crypto_heap_calloc(size_t nmemb, size_t size)
+{
+    struct heap_hdr *hdr = NULL;
+    size_t len;
+    uint32_t bin;
+
+    if ((nmemb == 0) || (size == 0) || (size > SIZE_MAX / nmemb)) {
+        return NULL;
+    }
+    len = nmemb * size;
+
+    if (len <= HEAP_BIN_MAX) {
+        for (bin = 0; HEAP_BIN_SIZE(bin) < len; bin++) {
+        }
+        hdr = heap_alloc_bin(bin);
+    }
+
+    if ((hdr == NULL) && (len <= (size_t)(heap.end - heap.base))) {
+        len = (len < HEAP_SPAN_MIN) ? HEAP_SPAN_MIN : HEAP_ALIGN_UP(len);
+        hdr = heap_alloc_span(len);
+    }
+
+    if (hdr == NULL) {
+        heap.failed++;
+        return NULL;
+    }
+
+    heap.in_use += sizeof(struct heap_hdr) + hdr->size;
+    heap_update_high_water();
+
+    memset(hdr + 1, 0, hdr->size);
+
+    return hdr + 1;
+}
+
+void tfm_crypto_heap_free(void *ptr)
+{
+    struct heap_free *blk;
+
+    if (((uint8_t *)ptr < heap.base + sizeof(struct heap_hdr)) ||
+        ((uint8_t *)ptr >= heap.end)) {
+        return;
+    }
+
+    blk = (struct heap_free *)((struct heap_hdr *)ptr - 1);
+    heap.in_use -= sizeof(struct heap_hdr) + blk->hdr.size;
+
+    if (blk->hdr.bin == HEAP_NO_BIN) {
+        heap_free_span(blk);
+    } else if (HEAP_BLOCK_END(blk) == heap.low) {
+        /* The last block carved from the start goes back to the free space */
+        heap.low = (uint8_t *)blk;
+    } else {
+        blk->next = heap.bins[blk->hdr.bin];
+        heap.bins[blk->hdr.bin] = blk;
+    }
+}
+
+void tfm_crypto_heap_get_stats(struct tfm_crypto_heap_stats *stats)
+{
+    const struct heap_free *blk;
+    uint32_t bin;
+
+    stats->size = (uint32_t)(heap.end - heap.base);
+    stats->in_use = (uint32_t)heap.in_use;
+    stats->high_water = (uint32_t)heap.high_water;
+    stats->failed = (uint32_t)heap.failed;
+    stats->largest_free = (uint32_t)(heap.high - heap.low);
+    stats->bin_free = 0;
+
+    for (bin = 0; bin < CRYPTO_ENGINE_HEAP_BIN_NUM; bin++) {
+        for (blk = heap.bins[bin]; blk != NULL; blk = blk->next) {
+            stats->bin_free += sizeof(struct heap_hdr) + blk->hdr.size;
+        }
+    }
+
+    for (blk = heap.spans; blk != NULL; blk = blk->next) {
+        if (blk->hdr.size > stats->largest_free) {
+            stats->largest_free = blk->hdr.size;
+        }
+    }
+}
+
+#endif /* CRYPTO_ENGINE_HEAP_POOLS */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -44,6 +44,34 @@
 #define TFM_CRYPTO_IOVEC_ALIGNMENT (4u)
 
 #if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+/**
+ * \brief The largest iovec parameter that the service accesses as a structure
+ *        rather than as a byte buffer.
+ */
+#define TFM_CRYPTO_IOVEC_BOUNCE_SIZE (sizeof(psa_key_attributes_t))
+
+/**
+ * \brief Whether a mapped iovec is small enough to be accessed as a structure
+ *        and is not aligned to \ref TFM_CRYPTO_IOVEC_ALIGNMENT
+ */
+#define TFM_CRYPTO_IOVEC_NEEDS_BOUNCE(vec)                                  \
+    (((vec).len <= TFM_CRYPTO_IOVEC_BOUNCE_SIZE) &&                         \
+     (((uintptr_t)(vec).base % TFM_CRYPTO_IOVEC_ALIGNMENT) != 0))
+
+/**
+ * \brief Aligned copies of the small iovecs which are mapped at an address not
+ *        aligned to \ref TFM_CRYPTO_IOVEC_ALIGNMENT. Bigger iovecs are always
+ *        used in place, without any copy, as they are byte buffers.
+ */
+static struct {
+    __attribute__((__aligned__(TFM_CRYPTO_IOVEC_ALIGNMENT)))
+    uint8_t in[PSA_MAX_IOVEC][TFM_CRYPTO_IOVEC_BOUNCE_SIZE];
+    __attribute__((__aligned__(TFM_CRYPTO_IOVEC_ALIGNMENT)))
+    uint8_t out[PSA_MAX_IOVEC][TFM_CRYPTO_IOVEC_BOUNCE_SIZE];
+    uint8_t *mapped_out[PSA_MAX_IOVEC]; /* Mapped outvecs which are bounced */
+    uint32_t in_mask;                   /* Bit i set if invec i is bounced */
+} bounce;
+
 static int32_t g_client_id;
 
 static void tfm_crypto_set_caller_id(int32_t id)
@@ -70,6 +98,11 @@ static psa_status_t tfm_crypto_init_iovecs(const psa_msg_t *msg,
         in_vec[i].len = msg->in_size[i];
         if (in_vec[i].len != 0) {
             in_vec[i].base = psa_map_invec(msg->handle, i);
+            if (TFM_CRYPTO_IOVEC_NEEDS_BOUNCE(in_vec[i])) {
+                (void)memcpy(bounce.in[i], in_vec[i].base, in_vec[i].len);
+                in_vec[i].base = bounce.in[i];
+                bounce.in_mask |= (1u << i);
+            }
         } else {
             in_vec[i].base = NULL;
         }
@@ -77,8 +110,13 @@ static psa_status_t tfm_crypto_init_iovecs(const psa_msg_t *msg,
 
     for (i = 0; i < out_len; i++) {
         out_vec[i].len = msg->out_size[i];
+        bounce.mapped_out[i] = NULL;
         if (out_vec[i].len != 0) {
             out_vec[i].base = psa_map_outvec(msg->handle, i);
+            if (TFM_CRYPTO_IOVEC_NEEDS_BOUNCE(out_vec[i])) {
+                bounce.mapped_out[i] = out_vec[i].base;
+                out_vec[i].base = bounce.out[i];
+            }
         } else {
             out_vec[i].base = NULL;
         }
@@ -86,27 +124,151 @@ static psa_status_t tfm_crypto_init_iovecs(const psa_msg_t *msg,
 
     return PSA_SUCCESS;
 }
+
+static void tfm_crypto_complete_iovecs(const psa_msg_t *msg,
+                                       psa_outvec out_vec[],
+                                       size_t out_len)
+{
+    uint32_t i;
+
+    for (i = 0; i < out_len; i++) {
+        if (out_vec[i].base == NULL) {
+            continue;
+        }
+
+        /* Copy back the outputs written to an aligned copy */
+        if (bounce.mapped_out[i] != NULL) {
+            (void)memcpy(bounce.mapped_out[i], out_vec[i].base,
+                         out_vec[i].len);
+            (void)memset(bounce.out[i], 0, TFM_CRYPTO_IOVEC_BOUNCE_SIZE);
+            bounce.mapped_out[i] = NULL;
+        }
+
+        psa_unmap_outvec(msg->handle, i, out_vec[i].len);
+    }
+
+    /* The inputs can hold sensitive material, e.g. key attributes */
+    for (i = 0; i < PSA_MAX_IOVEC; i++) {
+        if ((bounce.in_mask & (1u << i)) != 0) {
+            (void)memset(bounce.in[i], 0, TFM_CRYPTO_IOVEC_BOUNCE_SIZE);
+        }
+    }
+    bounce.in_mask = 0;
+}
 #else /* PSA_FRAMEWORK_HAS_MM_IOVEC == 1 */
 /**
- * \brief Internal scratch used for IOVec allocations
+ * \brief Internal scratch arenas used for IOVec allocations. Each request
+ *        being serviced holds one arena for its whole duration, so a request
+ *        can be serviced while another one is in progress, as long as they
+ *        complete in the reverse order they started.
  *
  */
-static struct tfm_crypto_scratch {
-    __attribute__((__aligned__(TFM_CRYPTO_IOVEC_ALIGNMENT)))
-    uint8_t buf[CRYPTO_IOVEC_BUFFER_SIZE];
+struct tfm_crypto_scratch {
+    uint8_t *buf;
+    uint32_t size;
     uint32_t alloc_index;
     int32_t owner;
-} scratch = {.buf = {0}, .alloc_index = 0};
+    bool in_use;
+    struct tfm_crypto_scratch *prev; /* Arena in use before this one */
+};
+
+static struct tfm_crypto_scratch scratch[CRYPTO_IOVEC_BUFFER_NUM];
+
+static __attribute__((__aligned__(TFM_CRYPTO_IOVEC_ALIGNMENT)))
+uint8_t scratch_buf[CRYPTO_IOVEC_BUFFER_NUM][CRYPTO_IOVEC_BUFFER_SIZE];
+
+/* The arena of the request being serviced, NULL if there is none */
+static struct tfm_crypto_scratch *scratch_cur;
+
+#if CRYPTO_ONESHOT_BUFFER_SIZE > 0
+/**
+ * \brief Arena on the stack of a small one-shot request, used instead of the
+ *        internal scratch arenas so that the request doesn't hold one of them.
+ */
+struct tfm_crypto_oneshot {
+    struct tfm_crypto_scratch arena;
+    __attribute__((__aligned__(TFM_CRYPTO_IOVEC_ALIGNMENT)))
+    uint8_t buf[CRYPTO_ONESHOT_BUFFER_SIZE];
+};
+
+/**
+ * \brief Sets up the arena of a one-shot request if all its iovecs fit in it.
+ *        The arena is taken by the next tfm_crypto_acquire_scratch().
+ */
+static void tfm_crypto_prepare_oneshot(struct tfm_crypto_oneshot *oneshot,
+                                       uint32_t function_id,
+                                       const psa_msg_t *msg)
+{
+    size_t size = 0;
+    uint32_t i;
+
+    switch (function_id) {
+    case TFM_CRYPTO_HASH_COMPUTE_SID:
+    case TFM_CRYPTO_HASH_COMPARE_SID:
+    case TFM_CRYPTO_MAC_COMPUTE_SID:
+    case TFM_CRYPTO_MAC_VERIFY_SID:
+    case TFM_CRYPTO_CIPHER_ENCRYPT_SID:
+    case TFM_CRYPTO_CIPHER_DECRYPT_SID:
+    case TFM_CRYPTO_AEAD_ENCRYPT_SID:
+    case TFM_CRYPTO_AEAD_DECRYPT_SID:
+        break;
+    default:
+        return;
+    }
+
+    for (i = 1; i < PSA_MAX_IOVEC; i++) {
+        size += ALIGN(msg->in_size[i], TFM_CRYPTO_IOVEC_ALIGNMENT);
+    }
+    for (i = 0; i < PSA_MAX_IOVEC; i++) {
+        size += ALIGN(msg->out_size[i], TFM_CRYPTO_IOVEC_ALIGNMENT);
+    }
+    if (size > sizeof(oneshot->buf)) {
+        return;
+    }
+
+    oneshot->arena.buf = oneshot->buf;
+    oneshot->arena.size = sizeof(oneshot->buf);
+    oneshot->arena.alloc_index = 0;
+    oneshot->arena.owner = 0;
+    oneshot->arena.in_use = false;
+    oneshot->arena.prev = scratch_cur;
+    scratch_cur = &oneshot->arena;
+}
+#endif /* CRYPTO_ONESHOT_BUFFER_SIZE > 0 */
+
+static psa_status_t tfm_crypto_acquire_scratch(void)
+{
+    uint32_t i;
+
+    /* The arena of a one-shot request is set up just before */
+    if ((scratch_cur != NULL) && !scratch_cur->in_use) {
+        scratch_cur->in_use = true;
+        return PSA_SUCCESS;
+    }
+
+    for (i = 0; i < CRYPTO_IOVEC_BUFFER_NUM; i++) {
+        if (!scratch[i].in_use) {
+            scratch[i].buf = scratch_buf[i];
+            scratch[i].size = sizeof(scratch_buf[i]);
+            scratch[i].in_use = true;
+            scratch[i].prev = scratch_cur;
+            scratch_cur = &scratch[i];
+            return PSA_SUCCESS;
+        }
+    }
+
+    return PSA_ERROR_INSUFFICIENT_MEMORY;
+}
 
 static psa_status_t tfm_crypto_set_scratch_owner(int32_t id)
 {
-    scratch.owner = id;
+    scratch_cur->owner = id;
     return PSA_SUCCESS;
 }
 
 static psa_status_t tfm_crypto_get_scratch_owner(int32_t *id)
 {
-    *id = scratch.owner;
+    *id = (scratch_cur != NULL) ? scratch_cur->owner : 0;
     return PSA_SUCCESS;
 }
 
@@ -115,24 +277,32 @@ static psa_status_t tfm_crypto_alloc_scratch(size_t requested_size, void **buf)
     /* Ensure alloc_index remains aligned to the required iovec alignment */
     requested_size = ALIGN(requested_size, TFM_CRYPTO_IOVEC_ALIGNMENT);
 
-    if (requested_size > (sizeof(scratch.buf) - scratch.alloc_index)) {
+    if (requested_size > (scratch_cur->size - scratch_cur->alloc_index)) {
         return PSA_ERROR_INSUFFICIENT_MEMORY;
     }
 
     /* Compute the pointer to the allocated space */
-    *buf = (void *)&scratch.buf[scratch.alloc_index];
+    *buf = (void *)&scratch_cur->buf[scratch_cur->alloc_index];
 
     /* Increase the allocated size */
-    scratch.alloc_index += requested_size;
+    scratch_cur->alloc_index += requested_size;
 
     return PSA_SUCCESS;
 }
 
 static void tfm_crypto_clear_scratch(void)
 {
-    scratch.owner = 0;
-    (void)memset(scratch.buf, 0, scratch.alloc_index);
-    scratch.alloc_index = 0;
+    struct tfm_crypto_scratch *arena = scratch_cur;
+
+    /* Only the allocated part of the arena has been used */
+    arena->owner = 0;
+    (void)memset(arena->buf, 0, arena->alloc_index);
+    arena->alloc_index = 0;
+
+    /* Release the arena and go back to the one of the outer request */
+    scratch_cur = arena->prev;
+    arena->prev = NULL;
+    arena->in_use = false;
 }
 
 static void tfm_crypto_set_caller_id(int32_t id)
@@ -156,6 +326,12 @@ static psa_status_t tfm_crypto_init_iovecs(const psa_msg_t *msg,
     void *alloc_buf_ptr = NULL;
     psa_status_t status;
 
+    /* Hold a scratch arena until the request is completed */
+    status = tfm_crypto_acquire_scratch();
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
     /* Alloc/read from the second element as the first is read when parsing */
     for (i = 1; i < in_len; i++) {
         /* Allocate necessary space in the internal scratch */
@@ -185,15 +361,167 @@ static psa_status_t tfm_crypto_init_iovecs(const psa_msg_t *msg,
 
     return PSA_SUCCESS;
 }
+
+static void tfm_crypto_complete_iovecs(const psa_msg_t *msg,
+                                       psa_outvec out_vec[],
+                                       size_t out_len)
+{
+    uint32_t i;
+
+    /* Write into the IPC framework outputs from the scratch */
+    for (i = 0; i < out_len; i++) {
+        psa_write(msg->handle, i, out_vec[i].base, out_vec[i].len);
+    }
+
+    /* Clear the allocated internal scratch before returning */
+    tfm_crypto_clear_scratch();
+}
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC == 1 */
 
+#if CRYPTO_STATS_ENTRIES > 0
+/*
+ * Free running cycle counter used to time the requests. It is the DWT cycle
+ * counter on Armv7-M / Armv8-M Mainline cores, accessible as the crypto
+ * partition is privileged at isolation levels 1 and 2. A platform can provide
+ * another source by defining CRYPTO_STATS_GET_CYCLES().
+ */
+#ifndef CRYPTO_STATS_GET_CYCLES
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+/* Architectural addresses of the debug registers used for the cycle counter */
+#define CRYPTO_STATS_DEMCR      (*(volatile uint32_t *)0xE000EDFCUL)
+#define CRYPTO_STATS_DWT_CTRL   (*(volatile uint32_t *)0xE0001000UL)
+#define CRYPTO_STATS_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004UL)
+
+static inline uint32_t tfm_crypto_stats_get_cycles(void)
+{
+    if (!(CRYPTO_STATS_DWT_CTRL & 0x1UL)) {
+        CRYPTO_STATS_DEMCR |= 0x1UL << 24;
+        CRYPTO_STATS_DWT_CTRL |= 0x1UL;
+    }
+
+    return CRYPTO_STATS_DWT_CYCCNT;
+}
+#define CRYPTO_STATS_GET_CYCLES() tfm_crypto_stats_get_cycles()
+#else
+#define CRYPTO_STATS_GET_CYCLES() 0U
+#endif
+#endif /* !CRYPTO_STATS_GET_CYCLES */
+
+/**
+ * \brief Timing statistics of the requests of one function and algorithm
+ */
+static struct {
+    uint16_t function_id;   /* Function of the requests, 0 if free */
+    psa_algorithm_t alg;    /* Algorithm passed with the requests, if any */
+    uint32_t calls;         /* Number of requests */
+    uint32_t bytes;         /* Bytes passed in the inputs after the first one */
+    uint32_t engine_cycles; /* Cycles spent in the API dispatcher */
+    uint32_t call_cycles;   /* Cycles spent in the partition for the requests */
+} g_stats[CRYPTO_STATS_ENTRIES];
+
+/* Number of requests which did not find a free statistics entry */
+static uint32_t g_stats_dropped;
+
+/**
+ * \brief Accounts one request in the entry of its function and algorithm
+ *
+ * \param[in] iov            Parameters of the request
+ * \param[in] msg            Message of the request
+ * \param[in] engine_cycles  Cycles spent in the API dispatcher
+ * \param[in] call_cycles    Cycles spent in the partition for the request
+ */
+static void tfm_crypto_stats_record(const struct tfm_crypto_pack_iovec *iov,
+                                    const psa_msg_t *msg,
+                                    uint32_t engine_cycles,
+                                    uint32_t call_cycles)
+{
+    uint32_t i;
+
+    for (i = 0; i < CRYPTO_STATS_ENTRIES; i++) {
+        if ((g_stats[i].function_id == iov->function_id &&
+             g_stats[i].alg == iov->alg) || g_stats[i].function_id == 0) {
+            break;
+        }
+    }
+
+    if (i == CRYPTO_STATS_ENTRIES) {
+        g_stats_dropped++;
+        return;
+    }
+
+    g_stats[i].function_id = iov->function_id;
+    g_stats[i].alg = iov->alg;
+    g_stats[i].calls++;
+    for (size_t j = 1; j < PSA_MAX_IOVEC; j++) {
+        g_stats[i].bytes += msg->in_size[j];
+    }
+    g_stats[i].engine_cycles += engine_cycles;
+    g_stats[i].call_cycles += call_cycles;
+}
+
+/**
+ * \brief Prints the timing statistics of the requests over the partition log,
+ *        then clears them
+ */
+static psa_status_t tfm_crypto_stats_report(void)
+{
+    uint32_t i;
+
+    LOG_INFFMT("[INF][Crypto] function alg calls bytes engine_cycles call_cycles\r\n");
+    for (i = 0; i < CRYPTO_STATS_ENTRIES && g_stats[i].function_id != 0; i++) {
+        LOG_INFFMT("[INF][Crypto] 0x%x 0x%x %u %u %u %u\r\n",
+                   g_stats[i].function_id, g_stats[i].alg, g_stats[i].calls,
+                   g_stats[i].bytes, g_stats[i].engine_cycles,
+                   g_stats[i].call_cycles);
+    }
+    LOG_INFFMT("[INF][Crypto] dropped %u\r\n", g_stats_dropped);
+
+    /* Operation context pools, in the order of tfm_crypto_operation_type */
+    for (i = 0; i <= (uint32_t)TFM_CRYPTO_AEAD_OPERATION; i++) {
+        uint32_t num, high_water;
+
+        tfm_crypto_operation_get_stats((enum tfm_crypto_operation_type)i,
+                                       &num, &high_water);
+        if (num != 0) {
+            LOG_INFFMT("[INF][Crypto] operations %u num %u high_water %u\r\n",
+                       i, num, high_water);
+        }
+    }
+
+#if CRYPTO_ENGINE_HEAP_POOLS
+    {
+        struct tfm_crypto_heap_stats heap;
+
+        tfm_crypto_heap_get_stats(&heap);
+        LOG_INFFMT("[INF][Crypto] heap size %u in_use %u high_water %u\r\n",
+                   heap.size, heap.in_use, heap.high_water);
+        LOG_INFFMT("[INF][Crypto] heap bin_free %u largest_free %u failed %u\r\n",
+                   heap.bin_free, heap.largest_free, heap.failed);
+    }
+#endif
+
+    memset(g_stats, 0, sizeof(g_stats));
+    g_stats_dropped = 0;
+
+    return PSA_SUCCESS;
+}
+#endif /* CRYPTO_STATS_ENTRIES > 0 */
+
 static psa_status_t tfm_crypto_call_srv(const psa_msg_t *msg)
 {
     psa_status_t status = PSA_SUCCESS;
-    size_t in_len = PSA_MAX_IOVEC, out_len = PSA_MAX_IOVEC, i;
+    size_t in_len = PSA_MAX_IOVEC, out_len = PSA_MAX_IOVEC;
     psa_invec in_vec[PSA_MAX_IOVEC] = { {NULL, 0} };
     psa_outvec out_vec[PSA_MAX_IOVEC] = { {NULL, 0} };
     struct tfm_crypto_pack_iovec iov = {0};
+#if (PSA_FRAMEWORK_HAS_MM_IOVEC != 1) && (CRYPTO_ONESHOT_BUFFER_SIZE > 0)
+    struct tfm_crypto_oneshot oneshot;
+#endif
+#if CRYPTO_STATS_ENTRIES > 0
+    uint32_t call_start = CRYPTO_STATS_GET_CYCLES();
+    uint32_t engine_start, engine_end;
+#endif
 
     /* Check the number of in_vec filled */
     while ((in_len > 0) && (msg->in_size[in_len - 1] == 0)) {
@@ -218,6 +546,10 @@ static psa_status_t tfm_crypto_call_srv(const psa_msg_t *msg)
     in_vec[0].base = &iov;
     in_vec[0].len = sizeof(struct tfm_crypto_pack_iovec);
 
+#if (PSA_FRAMEWORK_HAS_MM_IOVEC != 1) && (CRYPTO_ONESHOT_BUFFER_SIZE > 0)
+    tfm_crypto_prepare_oneshot(&oneshot, iov.function_id, msg);
+#endif
+
     status = tfm_crypto_init_iovecs(msg, in_vec, in_len, out_vec, out_len);
     if (status != PSA_SUCCESS) {
         return status;
@@ -225,23 +557,22 @@ static psa_status_t tfm_crypto_call_srv(const psa_msg_t *msg)
 
     tfm_crypto_set_caller_id(msg->client_id);
 
+#if CRYPTO_STATS_ENTRIES > 0
+    engine_start = CRYPTO_STATS_GET_CYCLES();
+#endif
+
     /* Call the dispatcher to the functions that implement the PSA Crypto API */
     status = tfm_crypto_api_dispatcher(in_vec, in_len, out_vec, out_len);
 
-#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
-    for (i = 0; i < out_len; i++) {
-        if (out_vec[i].base != NULL) {
-            psa_unmap_outvec(msg->handle, i, out_vec[i].len);
-        }
-    }
-#else
-    /* Write into the IPC framework outputs from the scratch */
-    for (i = 0; i < out_len; i++) {
-        psa_write(msg->handle, i, out_vec[i].base, out_vec[i].len);
-    }
+#if CRYPTO_STATS_ENTRIES > 0
+    engine_end = CRYPTO_STATS_GET_CYCLES();
+#endif
 
-    /* Clear the allocated internal scratch before returning */
-    tfm_crypto_clear_scratch();
+    tfm_crypto_complete_iovecs(msg, out_vec, out_len);
+
+#if CRYPTO_STATS_ENTRIES > 0
+    tfm_crypto_stats_record(&iov, msg, engine_end - engine_start,
+                            CRYPTO_STATS_GET_CYCLES() - call_start);
 #endif
 
     return status;
@@ -317,12 +648,66 @@ psa_status_t tfm_crypto_init(void)
     return PSA_SUCCESS;
 }
 
+#ifdef CRYPTO_HW_ECDSA_PRECOMPUTE
+/**
+ * \brief Computes the ephemeral key of one ECDSA signature ahead of the
+ *        signature, on the curve of a TFM_CRYPTO_SIGN_PRECOMPUTE request
+ *
+ * \param[in] msg  The request, with the ECC family and the key size in bits
+ *                 of the curve in its two input vectors
+ *
+ * \return Return values as described in \ref tfm_crypto_sign_precompute
+ */
+static psa_status_t tfm_crypto_precompute_ephemeral(const psa_msg_t *msg)
+{
+    psa_ecc_family_t curve;
+    size_t bits;
+    int ret;
+
+    if ((msg->in_size[0] != sizeof(curve)) ||
+        (msg->in_size[1] != sizeof(bits))) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    (void)psa_read(msg->handle, 0, &curve, sizeof(curve));
+    (void)psa_read(msg->handle, 1, &bits, sizeof(bits));
+
+    ret = crypto_hw_accelerator_ecdsa_precompute(curve, bits);
+    if (ret == 1) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    return (ret == 0) ? PSA_SUCCESS : PSA_ERROR_NOT_SUPPORTED;
+}
+#endif /* CRYPTO_HW_ECDSA_PRECOMPUTE */
+
 psa_status_t tfm_crypto_sfn(const psa_msg_t *msg)
 {
     /* Process the message type */
     switch (msg->type) {
     case PSA_IPC_CALL:
         return tfm_crypto_call_srv(msg);
+#if CRYPTO_STATS_ENTRIES > 0
+    case TFM_CRYPTO_STATS_LOG:
+        return tfm_crypto_stats_report();
+#endif
+    case TFM_CRYPTO_RNG_POOL_CLEAR:
+        /* Only the secure partitions report the security events */
+        if (msg->client_id < 0) {
+            return PSA_ERROR_NOT_PERMITTED;
+        }
+        tfm_crypto_rng_pool_clear();
+#ifdef CRYPTO_HW_ECDSA_PRECOMPUTE
+        crypto_hw_accelerator_ecdsa_precompute_clear();
+#endif
+        return PSA_SUCCESS;
+#ifdef CRYPTO_HW_ECDSA_PRECOMPUTE
+    case TFM_CRYPTO_SIGN_PRECOMPUTE:
+        if (msg->client_id < 0) {
+            return PSA_ERROR_NOT_PERMITTED;
+        }
+        return tfm_crypto_precompute_ephemeral(msg);
+#endif
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -330,63 +715,172 @@ psa_status_t tfm_crypto_sfn(const psa_msg_t *msg)
     return PSA_ERROR_GENERIC_ERROR;
 }
 
-psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
-                                       size_t in_len,
-                                       psa_outvec out_vec[],
-                                       size_t out_len)
+#if CRYPTO_BATCH_MODULE_ENABLED
+/**
+ * \brief Takes the next input or output of an operation of a batch request
+ *        from a buffer of the batch request.
+ *
+ * \param[in]     buf_len  Length of the buffer
+ * \param[in,out] offset   Offset of the next input or output in the buffer
+ * \param[in]     len      Length of the input or output
+ *
+ * \return Returns true if it fits in the buffer, false otherwise
+ */
+static bool tfm_crypto_batch_take(size_t buf_len, size_t *offset, size_t len)
 {
-    psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
-    const struct tfm_crypto_pack_iovec *iov = in_vec[0].base;
-    int32_t caller_id = 0;
-    struct tfm_crypto_key_id_s encoded_key = TFM_CRYPTO_KEY_ID_S_INIT;
-    bool is_key_required = false;
-    enum tfm_crypto_group_id_t group_id;
+    if (len > (buf_len - *offset)) {
+        return false;
+    }
 
-    if (in_vec[0].len != sizeof(struct tfm_crypto_pack_iovec)) {
+    *offset += len;
+    /* The next one starts aligned, or at the end of the buffer */
+    *offset = TFM_CRYPTO_BATCH_ALIGN(*offset) < buf_len ?
+              TFM_CRYPTO_BATCH_ALIGN(*offset) : buf_len;
+
+    return true;
+}
+
+/**
+ * \brief Executes the operations of a batch request, in order, through the
+ *        API dispatcher. It stops at the first operation which fails.
+ *
+ * \param[in]  in_vec   Array of invec parameters: the batch request
+ *                      descriptor, the array of \ref tfm_crypto_batch_op and
+ *                      the inputs of the operations
+ * \param[out] out_vec  Array of outvec parameters: the array of
+ *                      \ref tfm_crypto_batch_result and the outputs of the
+ *                      operations
+ *
+ * \return Return values as described in \ref psa_status_t
+ */
+static psa_status_t tfm_crypto_batch_interface(psa_invec in_vec[],
+                                               psa_outvec out_vec[])
+{
+    const uint8_t *ops = in_vec[1].base;
+    const uint8_t *in_buf = in_vec[2].base;
+    struct tfm_crypto_batch_result *results = out_vec[0].base;
+    uint8_t *out_buf = out_vec[1].base;
+    size_t op_count = in_vec[1].len / sizeof(struct tfm_crypto_batch_op);
+    size_t in_offset = 0, out_offset = 0;
+    size_t op_in_len, op_out_len, i, j;
+    struct tfm_crypto_batch_op op;
+    psa_invec op_in_vec[PSA_MAX_IOVEC];
+    psa_outvec op_out_vec[PSA_MAX_IOVEC];
+    psa_status_t status = PSA_SUCCESS;
+
+    if ((op_count == 0) ||
+        (in_vec[1].len != op_count * sizeof(struct tfm_crypto_batch_op)) ||
+        (out_vec[0].len < op_count * sizeof(struct tfm_crypto_batch_result))) {
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
 
-    group_id = TFM_CRYPTO_GET_GROUP_ID(iov->function_id);
+    out_vec[0].len = op_count * sizeof(struct tfm_crypto_batch_result);
+    for (i = 0; i < op_count; i++) {
+        (void)memset(&results[i], 0, sizeof(struct tfm_crypto_batch_result));
+        results[i].status = PSA_ERROR_BAD_STATE;
+    }
 
-    is_key_required = !((group_id == TFM_CRYPTO_GROUP_ID_HASH) ||
-                        (group_id == TFM_CRYPTO_GROUP_ID_RANDOM));
+    for (i = 0; (i < op_count) && (status == PSA_SUCCESS); i++) {
+        /* Work on an aligned copy, the descriptors can be in client memory */
+        (void)memcpy(&op, &ops[i * sizeof(op)], sizeof(op));
+
+        if (TFM_CRYPTO_GET_GROUP_ID(op.iov.function_id) ==
+            TFM_CRYPTO_GROUP_ID_BATCH) {
+            results[i].status = PSA_ERROR_PROGRAMMER_ERROR;
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+
+        op_in_vec[0].base = &op.iov;
+        op_in_vec[0].len = sizeof(struct tfm_crypto_pack_iovec);
+        op_in_len = 1;
+        for (j = 0; j < TFM_CRYPTO_BATCH_MAX_IN_VEC; j++) {
+            op_in_vec[j + 1].base = (op.in_len[j] != 0) ?
+                                    &in_buf[in_offset] : NULL;
+            op_in_vec[j + 1].len = op.in_len[j];
+            if (!tfm_crypto_batch_take(in_vec[2].len, &in_offset,
+                                       op.in_len[j])) {
+                status = PSA_ERROR_PROGRAMMER_ERROR;
+            }
+            if (op.in_len[j] != 0) {
+                op_in_len = j + 2;
+            }
+        }
+
+        op_out_len = 0;
+        for (j = 0; j < TFM_CRYPTO_BATCH_MAX_OUT_VEC; j++) {
+            op_out_vec[j].base = (op.out_len[j] != 0) ?
+                                 &out_buf[out_offset] : NULL;
+            op_out_vec[j].len = op.out_len[j];
+            if (!tfm_crypto_batch_take(out_vec[1].len, &out_offset,
+                                       op.out_len[j])) {
+                status = PSA_ERROR_PROGRAMMER_ERROR;
+            }
+            if (op.out_len[j] != 0) {
+                op_out_len = j + 1;
+            }
+        }
 
-    if (is_key_required) {
-        status = tfm_crypto_get_caller_id(&caller_id);
         if (status != PSA_SUCCESS) {
+            results[i].status = status;
             return status;
         }
-        /* The caller_id being set in the owner field is the partition ID
-         * of the calling partition
-         */
-        encoded_key.key_id = iov->key_id;
-        encoded_key.owner = caller_id;
+
+        status = tfm_crypto_api_dispatcher(op_in_vec, op_in_len,
+                                           op_out_vec, op_out_len);
+
+        results[i].status = status;
+        for (j = 0; j < op_out_len; j++) {
+            results[i].out_len[j] = op_out_vec[j].len;
+        }
     }
 
+    return status;
+}
+#endif /* CRYPTO_BATCH_MODULE_ENABLED */
+
+/**
+ * \brief Dispatches a request to the sub-module of its function group
+ *
+ * \param[in]  group_id     Group of the function of the request
+ * \param[in]  in_vec       Array of invec parameters
+ * \param[out] out_vec      Array of outvec parameters
+ * \param[in]  encoded_key  Key encoded with partition_id and key_id
+ *
+ * \return Return values as described in \ref psa_status_t
+ */
+static psa_status_t tfm_crypto_dispatch_group(enum tfm_crypto_group_id_t group_id,
+                                              psa_invec in_vec[],
+                                              psa_outvec out_vec[],
+                                              struct tfm_crypto_key_id_s *encoded_key)
+{
     /* Dispatch to each sub-module based on the Group ID */
     switch (group_id) {
     case TFM_CRYPTO_GROUP_ID_KEY_MANAGEMENT:
         return tfm_crypto_key_management_interface(in_vec, out_vec,
-                                                   &encoded_key);
+                                                   encoded_key);
     case TFM_CRYPTO_GROUP_ID_HASH:
         return tfm_crypto_hash_interface(in_vec, out_vec);
     case TFM_CRYPTO_GROUP_ID_MAC:
-        return tfm_crypto_mac_interface(in_vec, out_vec, &encoded_key);
+        return tfm_crypto_mac_interface(in_vec, out_vec, encoded_key);
     case TFM_CRYPTO_GROUP_ID_CIPHER:
-        return tfm_crypto_cipher_interface(in_vec, out_vec, &encoded_key);
+        return tfm_crypto_cipher_interface(in_vec, out_vec, encoded_key);
     case TFM_CRYPTO_GROUP_ID_AEAD:
-        return tfm_crypto_aead_interface(in_vec, out_vec, &encoded_key);
+        return tfm_crypto_aead_interface(in_vec, out_vec, encoded_key);
     case TFM_CRYPTO_GROUP_ID_ASYM_SIGN:
         return tfm_crypto_asymmetric_sign_interface(in_vec, out_vec,
-                                                    &encoded_key);
+                                                    encoded_key);
     case TFM_CRYPTO_GROUP_ID_ASYM_ENCRYPT:
         return tfm_crypto_asymmetric_encrypt_interface(in_vec, out_vec,
-                                                       &encoded_key);
+                                                       encoded_key);
     case TFM_CRYPTO_GROUP_ID_KEY_DERIVATION:
         return tfm_crypto_key_derivation_interface(in_vec, out_vec,
-                                                   &encoded_key);
+                                                   encoded_key);
     case TFM_CRYPTO_GROUP_ID_RANDOM:
         return tfm_crypto_random_interface(in_vec, out_vec);
+#if CRYPTO_BATCH_MODULE_ENABLED
+    case TFM_CRYPTO_GROUP_ID_BATCH:
+        return tfm_crypto_batch_interface(in_vec, out_vec);
+#endif
     default:
         LOG_ERRFMT("[ERR][Crypto] Unsupported request!\r\n");
         return PSA_ERROR_NOT_SUPPORTED;
@@ -394,3 +888,56 @@ psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
 
     return PSA_ERROR_NOT_SUPPORTED;
 }
+
+psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
+                                       size_t in_len,
+                                       psa_outvec out_vec[],
+                                       size_t out_len)
+{
+    psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
+    const struct tfm_crypto_pack_iovec *iov = in_vec[0].base;
+    int32_t caller_id = 0;
+    struct tfm_crypto_key_id_s encoded_key = TFM_CRYPTO_KEY_ID_S_INIT;
+    bool is_key_required = false;
+    enum tfm_crypto_group_id_t group_id;
+
+    if (in_vec[0].len != sizeof(struct tfm_crypto_pack_iovec)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    group_id = TFM_CRYPTO_GET_GROUP_ID(iov->function_id);
+
+    is_key_required = !((group_id == TFM_CRYPTO_GROUP_ID_HASH) ||
+                        (group_id == TFM_CRYPTO_GROUP_ID_RANDOM));
+
+    if (is_key_required) {
+        status = tfm_crypto_get_caller_id(&caller_id);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+        /* The caller_id being set in the owner field is the partition ID
+         * of the calling partition
+         */
+        encoded_key.key_id = iov->key_id;
+        encoded_key.owner = caller_id;
+#if CRYPTO_KEY_SHARE_ENTRIES > 0
+        status = tfm_crypto_key_share_resolve(&encoded_key, iov->function_id);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+#endif
+#if CRYPTO_KEY_SLOT_LRU_ENABLED
+        tfm_crypto_key_slot_prepare(&encoded_key);
+#endif
+    }
+
+    status = tfm_crypto_dispatch_group(group_id, in_vec, out_vec, &encoded_key);
+
+#if CRYPTO_KEY_SLOT_LRU_ENABLED
+    if (is_key_required) {
+        tfm_crypto_key_slot_update(&encoded_key, iov->function_id, status);
+    }
+#endif
+
+    return status;
+}
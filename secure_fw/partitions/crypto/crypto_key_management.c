@@ -5,6 +5,7 @@
  *
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -16,6 +17,9 @@
 #include "tfm_crypto_defs.h"
 
 #include "crypto_library.h"
+#ifdef CRYPTO_HW_RSA_KEY_CACHE
+#include "crypto_hw.h"
+#endif
 
 /*!
  * \addtogroup tfm_crypto_api_shim_layer
@@ -75,6 +79,17 @@ psa_status_t tfm_crypto_key_management_interface(psa_invec in_vec[],
     case TFM_CRYPTO_DESTROY_KEY_SID:
     {
         status = psa_destroy_key(library_key);
+#if CRYPTO_KEY_SHARE_ENTRIES > 0
+        if (status == PSA_SUCCESS) {
+            tfm_crypto_key_share_revoke(encoded_key);
+        }
+#endif
+#ifdef CRYPTO_HW_RSA_KEY_CACHE
+        /* Don't keep the parsed private key of a destroyed key */
+        if (status == PSA_SUCCESS) {
+            crypto_hw_accelerator_rsa_key_cache_clear();
+        }
+#endif
     }
     break;
     case TFM_CRYPTO_GET_KEY_ATTRIBUTES_SID:
@@ -148,6 +163,32 @@ psa_status_t tfm_crypto_key_management_interface(psa_invec in_vec[],
         *key_handle = CRYPTO_LIBRARY_GET_KEY_ID(library_key);
     }
     break;
+#if CRYPTO_KEY_SHARE_ENTRIES > 0
+    case TFM_CRYPTO_SHARE_KEY_SID:
+    {
+        psa_key_id_t *shared_key = out_vec[0].base;
+
+        if ((in_vec[1].len != sizeof(int32_t)) ||
+            (out_vec[0].len != sizeof(psa_key_id_t))) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+
+        status = tfm_crypto_key_share_add(encoded_key,
+                                          *(const int32_t *)in_vec[1].base,
+                                          shared_key);
+    }
+    break;
+    case TFM_CRYPTO_UNSHARE_KEY_SID:
+    {
+        if (in_vec[1].len != sizeof(int32_t)) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+
+        status = tfm_crypto_key_share_remove(encoded_key,
+                                             *(const int32_t *)in_vec[1].base);
+    }
+    break;
+#endif /* CRYPTO_KEY_SHARE_ENTRIES > 0 */
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -167,3 +208,274 @@ psa_status_t tfm_crypto_key_management_interface(psa_invec in_vec[],
 }
 #endif /* CRYPTO_KEY_MODULE_ENABLED  */
 /*!@}*/
+
+#if CRYPTO_KEY_SLOT_LRU_ENABLED
+/**
+ * \brief A type describing a persistent key tracked in a key slot
+ */
+struct tfm_crypto_key_slot_entry_s {
+    struct tfm_crypto_key_id_s key; /*!< Key, with a key_id of 0 if the entry
+                                     *   is free
+                                     */
+    uint32_t last_use;              /*!< Value of key_slot_clock when the key
+                                     *   was last used
+                                     */
+};
+
+static struct tfm_crypto_key_slot_entry_s key_slots[MBEDTLS_PSA_KEY_SLOT_COUNT];
+static uint32_t key_slot_clock;
+static struct tfm_crypto_key_slot_stats_s key_slot_stats;
+
+static bool is_persistent_key(const struct tfm_crypto_key_id_s *encoded_key)
+{
+    /* Volatile and builtin keys have key IDs in the vendor range */
+    return (encoded_key->key_id >= PSA_KEY_ID_USER_MIN) &&
+           (encoded_key->key_id <= PSA_KEY_ID_USER_MAX);
+}
+
+static struct tfm_crypto_key_slot_entry_s *key_slot_find(
+                                const struct tfm_crypto_key_id_s *encoded_key)
+{
+    uint32_t i;
+
+    for (i = 0; i < MBEDTLS_PSA_KEY_SLOT_COUNT; i++) {
+        if ((key_slots[i].key.key_id == encoded_key->key_id) &&
+            (key_slots[i].key.owner == encoded_key->owner)) {
+            return &key_slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct tfm_crypto_key_slot_entry_s *key_slot_lru(void)
+{
+    struct tfm_crypto_key_slot_entry_s *lru = &key_slots[0];
+    uint32_t i;
+
+    for (i = 0; i < MBEDTLS_PSA_KEY_SLOT_COUNT; i++) {
+        if (key_slots[i].key.key_id == PSA_KEY_ID_NULL) {
+            return &key_slots[i];
+        }
+
+        if ((key_slot_clock - key_slots[i].last_use) >
+            (key_slot_clock - lru->last_use)) {
+            lru = &key_slots[i];
+        }
+    }
+
+    return lru;
+}
+
+void tfm_crypto_key_slot_prepare(const struct tfm_crypto_key_id_s *encoded_key)
+{
+    struct tfm_crypto_key_slot_entry_s *lru;
+    mbedtls_psa_stats_t stats;
+
+    if (!is_persistent_key(encoded_key) ||
+        (key_slot_find(encoded_key) != NULL)) {
+        return;
+    }
+
+    mbedtls_psa_get_stats(&stats);
+    if (stats.MBEDTLS_PRIVATE(empty_slots) != 0) {
+        return;
+    }
+
+    /* Make room by purging the least recently used persistent key, which is
+     * loaded again from storage on its next use
+     */
+    lru = key_slot_lru();
+    if (lru->key.key_id == PSA_KEY_ID_NULL) {
+        return;
+    }
+
+    if (psa_purge_key(tfm_crypto_library_key_id_init(lru->key.owner,
+                                                     lru->key.key_id))
+        == PSA_SUCCESS) {
+        key_slot_stats.evictions++;
+    }
+    (void)memset(lru, 0, sizeof(*lru));
+}
+
+void tfm_crypto_key_slot_update(const struct tfm_crypto_key_id_s *encoded_key,
+                                uint16_t function_id,
+                                psa_status_t status)
+{
+    struct tfm_crypto_key_slot_entry_s *entry;
+
+    if (!is_persistent_key(encoded_key)) {
+        return;
+    }
+
+    entry = key_slot_find(encoded_key);
+
+    if ((function_id == TFM_CRYPTO_DESTROY_KEY_SID) ||
+        (function_id == TFM_CRYPTO_PURGE_KEY_SID) ||
+        (function_id == TFM_CRYPTO_CLOSE_KEY_SID) ||
+        (status == PSA_ERROR_INVALID_HANDLE) ||
+        (status == PSA_ERROR_DOES_NOT_EXIST)) {
+        /* The key is no longer, or has never been, in a key slot */
+        if (entry != NULL) {
+            (void)memset(entry, 0, sizeof(*entry));
+        }
+        return;
+    }
+
+    if (entry != NULL) {
+        key_slot_stats.hits++;
+    } else {
+        key_slot_stats.misses++;
+        entry = key_slot_lru();
+        entry->key = *encoded_key;
+    }
+    entry->last_use = ++key_slot_clock;
+}
+
+void tfm_crypto_key_slot_get_stats(struct tfm_crypto_key_slot_stats_s *stats)
+{
+    *stats = key_slot_stats;
+}
+#endif /* CRYPTO_KEY_SLOT_LRU_ENABLED */
+
+#if CRYPTO_KEY_SHARE_ENTRIES > 0
+/**
+ * \brief A type describing the access of a secure partition to a key of
+ *        another secure partition
+ */
+struct tfm_crypto_key_share_entry_s {
+    struct tfm_crypto_key_id_s key; /*!< Shared key, with a key_id of 0 if the
+                                     *   entry is free
+                                     */
+    int32_t grantee;                /*!< Partition given access to the key */
+    uint8_t generation;             /*!< Changed each time the entry is freed,
+                                     *   so that a revoked shared key ID is not
+                                     *   given out again right away
+                                     */
+};
+
+static struct tfm_crypto_key_share_entry_s key_shares[CRYPTO_KEY_SHARE_ENTRIES];
+
+/* The shared key ID encodes the generation and the index of the entry */
+static psa_key_id_t key_share_id(uint32_t idx)
+{
+    return TFM_CRYPTO_SHARED_KEY_ID_MIN |
+           ((psa_key_id_t)key_shares[idx].generation << 8) | idx;
+}
+
+static void key_share_free(struct tfm_crypto_key_share_entry_s *entry)
+{
+    uint8_t generation = entry->generation + 1;
+
+    (void)memset(entry, 0, sizeof(*entry));
+    entry->generation = generation;
+}
+
+psa_status_t tfm_crypto_key_share_resolve(struct tfm_crypto_key_id_s *encoded_key,
+                                          uint16_t function_id)
+{
+    uint32_t idx = encoded_key->key_id & 0xFFu;
+
+    if ((encoded_key->key_id < TFM_CRYPTO_SHARED_KEY_ID_MIN) ||
+        (encoded_key->key_id > TFM_CRYPTO_SHARED_KEY_ID_MAX)) {
+        return PSA_SUCCESS;
+    }
+
+    if ((idx >= CRYPTO_KEY_SHARE_ENTRIES) ||
+        (key_shares[idx].key.key_id == PSA_KEY_ID_NULL) ||
+        (key_share_id(idx) != encoded_key->key_id) ||
+        (key_shares[idx].grantee != encoded_key->owner)) {
+        return PSA_ERROR_INVALID_HANDLE;
+    }
+
+    /* The key remains under the control of its owner */
+    if ((TFM_CRYPTO_GET_GROUP_ID(function_id) ==
+         TFM_CRYPTO_GROUP_ID_KEY_MANAGEMENT) &&
+        (function_id != TFM_CRYPTO_GET_KEY_ATTRIBUTES_SID) &&
+        (function_id != TFM_CRYPTO_EXPORT_PUBLIC_KEY_SID)) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    *encoded_key = key_shares[idx].key;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_crypto_key_share_add(const struct tfm_crypto_key_id_s *encoded_key,
+                                      int32_t partition_id,
+                                      psa_key_id_t *shared_key)
+{
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+    struct tfm_crypto_key_share_entry_s *entry = NULL;
+    psa_status_t status;
+    uint32_t i;
+
+    /* Only keys of secure partitions are shared, with secure partitions */
+    if ((encoded_key->owner <= 0) || (partition_id <= 0) ||
+        (partition_id == encoded_key->owner)) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    status = psa_get_key_attributes(
+                tfm_crypto_library_key_id_init(encoded_key->owner,
+                                               encoded_key->key_id),
+                &attr);
+    psa_reset_key_attributes(&attr);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    for (i = 0; i < CRYPTO_KEY_SHARE_ENTRIES; i++) {
+        if ((key_shares[i].key.key_id == encoded_key->key_id) &&
+            (key_shares[i].key.owner == encoded_key->owner) &&
+            (key_shares[i].grantee == partition_id)) {
+            *shared_key = key_share_id(i);
+            return PSA_SUCCESS;
+        }
+
+        if ((entry == NULL) &&
+            (key_shares[i].key.key_id == PSA_KEY_ID_NULL)) {
+            entry = &key_shares[i];
+        }
+    }
+
+    if (entry == NULL) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    entry->key = *encoded_key;
+    entry->grantee = partition_id;
+    *shared_key = key_share_id((uint32_t)(entry - key_shares));
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_crypto_key_share_remove(const struct tfm_crypto_key_id_s *encoded_key,
+                                         int32_t partition_id)
+{
+    uint32_t i;
+
+    for (i = 0; i < CRYPTO_KEY_SHARE_ENTRIES; i++) {
+        if ((key_shares[i].key.key_id == encoded_key->key_id) &&
+            (key_shares[i].key.owner == encoded_key->owner) &&
+            (key_shares[i].grantee == partition_id)) {
+            key_share_free(&key_shares[i]);
+            return PSA_SUCCESS;
+        }
+    }
+
+    return PSA_ERROR_DOES_NOT_EXIST;
+}
+
+void tfm_crypto_key_share_revoke(const struct tfm_crypto_key_id_s *encoded_key)
+{
+    uint32_t i;
+
+    for (i = 0; i < CRYPTO_KEY_SHARE_ENTRIES; i++) {
+        if ((key_shares[i].key.key_id == encoded_key->key_id) &&
+            (key_shares[i].key.owner == encoded_key->owner)) {
+            key_share_free(&key_shares[i]);
+        }
+    }
+}
+#endif /* CRYPTO_KEY_SHARE_ENTRIES > 0 */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -79,11 +79,22 @@ char *tfm_crypto_library_get_info(void)
 
 psa_status_t tfm_crypto_core_library_init(void)
 {
+#if CRYPTO_ENGINE_HEAP_POOLS
+    /* Replace the Mbed Crypto memory allocator with the size class heap on
+     * the same static buffer
+     */
+    tfm_crypto_heap_init(mbedtls_mem_buf, CRYPTO_ENGINE_BUF_SIZE);
+    if (mbedtls_platform_set_calloc_free(tfm_crypto_heap_calloc,
+                                         tfm_crypto_heap_free) != 0) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+#else
     /* Initialise the Mbed Crypto memory allocator to use static memory
      * allocation from the provided buffer instead of using the heap
      */
     mbedtls_memory_buffer_alloc_init(mbedtls_mem_buf,
                                      CRYPTO_ENGINE_BUF_SIZE);
+#endif /* CRYPTO_ENGINE_HEAP_POOLS */
 
     /* mbedtls_printf is used to print messages including error information. */
 #if (TFM_PARTITION_LOG_LEVEL >= TFM_PARTITION_LOG_LEVEL_ERROR)
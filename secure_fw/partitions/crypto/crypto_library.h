@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -88,6 +88,56 @@ void tfm_crypto_library_get_library_key_id_set_owner(int32_t owner, psa_key_attr
  */
 psa_status_t tfm_crypto_core_library_init(void);
 
+#if CRYPTO_ENGINE_HEAP_POOLS
+/**
+ * @brief Usage statistics of the heap of the backend library
+ *
+ */
+struct tfm_crypto_heap_stats {
+    uint32_t size;          /*!< Size of the heap */
+    uint32_t in_use;        /*!< Bytes of the blocks allocated, with their headers */
+    uint32_t high_water;    /*!< Largest part of the heap used so far */
+    uint32_t bin_free;      /*!< Bytes of the free blocks kept for reuse by their size class */
+    uint32_t largest_free;  /*!< Largest contiguous free space */
+    uint32_t failed;        /*!< Number of allocations which failed */
+};
+
+/**
+ * @brief Initialises the size class heap of the backend library on a buffer
+ *
+ * @param[in] buf   Buffer of the heap
+ * @param[in] size  Size of the buffer
+ *
+ */
+void tfm_crypto_heap_init(uint8_t *buf, size_t size);
+
+/**
+ * @brief Allocates a zeroed array from the heap, with the prototype of calloc()
+ *
+ * @param[in] nmemb  Number of elements
+ * @param[in] size   Size of an element
+ *
+ * @return The array, or NULL if it doesn't fit in the heap
+ */
+void *tfm_crypto_heap_calloc(size_t nmemb, size_t size);
+
+/**
+ * @brief Frees a block allocated by \ref tfm_crypto_heap_calloc
+ *
+ * @param[in] ptr  The block, NULL is ignored
+ *
+ */
+void tfm_crypto_heap_free(void *ptr);
+
+/**
+ * @brief Gets the usage statistics of the heap
+ *
+ * @param[out] stats  The statistics
+ *
+ */
+void tfm_crypto_heap_get_stats(struct tfm_crypto_heap_stats *stats);
+#endif /* CRYPTO_ENGINE_HEAP_POOLS */
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2021, Nordic Semiconductor ASA.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -8,6 +8,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "config_tfm.h"
 #include "tfm_mbedcrypto_include.h"
@@ -15,6 +16,62 @@
 #include "tfm_crypto_api.h"
 #include "tfm_crypto_defs.h"
 
+#if CRYPTO_RNG_MODULE_ENABLED && (CRYPTO_RNG_POOL_SIZE > 0)
+/*
+ * Random bytes generated ahead of the requests. The pool is filled by a single
+ * call to the RNG of the backend when it runs out, so the small requests are
+ * copied from it and the reseed checks of the DRBG happen once per fill. The
+ * bytes are taken from the end of the pool and wiped once given out, so they
+ * are never given twice.
+ */
+static uint8_t rng_pool[CRYPTO_RNG_POOL_SIZE];
+static size_t rng_pool_avail;
+
+static void rng_pool_take(uint8_t *output, size_t len)
+{
+    rng_pool_avail -= len;
+    memcpy(output, &rng_pool[rng_pool_avail], len);
+    memset(&rng_pool[rng_pool_avail], 0, len);
+}
+
+static psa_status_t rng_pool_generate(uint8_t *output, size_t output_size)
+{
+    psa_status_t status;
+    size_t len;
+
+    if (output_size > sizeof(rng_pool)) {
+        return psa_generate_random(output, output_size);
+    }
+
+    len = (output_size < rng_pool_avail) ? output_size : rng_pool_avail;
+    rng_pool_take(output, len);
+
+    if (len == output_size) {
+        return PSA_SUCCESS;
+    }
+
+    status = psa_generate_random(rng_pool, sizeof(rng_pool));
+    if (status != PSA_SUCCESS) {
+        tfm_crypto_rng_pool_clear();
+        memset(output, 0, output_size);
+        return status;
+    }
+    rng_pool_avail = sizeof(rng_pool);
+
+    rng_pool_take(output + len, output_size - len);
+
+    return PSA_SUCCESS;
+}
+#endif /* CRYPTO_RNG_MODULE_ENABLED && (CRYPTO_RNG_POOL_SIZE > 0) */
+
+void tfm_crypto_rng_pool_clear(void)
+{
+#if CRYPTO_RNG_MODULE_ENABLED && (CRYPTO_RNG_POOL_SIZE > 0)
+    memset(rng_pool, 0, sizeof(rng_pool));
+    rng_pool_avail = 0;
+#endif
+}
+
 /*!
  * \addtogroup tfm_crypto_api_shim_layer
  *
@@ -33,7 +90,11 @@ psa_status_t tfm_crypto_random_interface(psa_invec in_vec[],
     uint8_t *output = out_vec[0].base;
     size_t output_size = out_vec[0].len;
 
+#if CRYPTO_RNG_POOL_SIZE > 0
+    return rng_pool_generate(output, output_size);
+#else
     return psa_generate_random(output, output_size);
 #endif
+#endif
 }
 /*!@}*/
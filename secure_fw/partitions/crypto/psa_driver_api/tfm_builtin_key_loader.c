@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
+#include <stdbool.h>
 #include <string.h>
+#include "config_tfm.h"
 #include "tfm_builtin_key_loader.h"
 #include "tfm_mbedcrypto_include.h"
 #include "psa_manifest/pid.h"
@@ -29,6 +31,9 @@ struct tfm_builtin_key_t {
     size_t key_len;                       /*!< Size of the key material held in the key buffer */
     psa_key_attributes_t attr;            /*!< Key attributes associated to the key */
     uint32_t is_loaded;                   /*!< Boolean indicating whether the slot is being used */
+#if CRYPTO_BUILTIN_KEY_LAZY_LOAD
+    const tfm_plat_builtin_key_descriptor_t *desc; /*!< Descriptor of the key loaded on first use, NULL if the slot is not used */
+#endif /* CRYPTO_BUILTIN_KEY_LAZY_LOAD */
 };
 
 /*!
@@ -37,6 +42,83 @@ struct tfm_builtin_key_t {
  */
 static struct tfm_builtin_key_t g_builtin_key_slots[TFM_BUILTIN_MAX_KEYS] = {0};
 
+#if CRYPTO_BUILTIN_KEY_CACHE_ENTRIES
+/*!
+ * \brief A structure which describes an entry of the cache of derived subkeys
+ */
+struct tfm_builtin_key_cache_entry_t {
+    uint8_t __attribute__((aligned(4))) key[TFM_BUILTIN_MAX_KEY_LEN]; /*!< Derived key material, 4-byte aligned */
+    size_t key_len;                           /*!< Size of the derived key material */
+    const struct tfm_builtin_key_t *key_slot; /*!< Slot the subkey is derived from, NULL if the entry is free */
+    int32_t user;                             /*!< User the subkey is derived for, used as derivation label */
+    uint32_t last_use;                        /*!< Value of g_builtin_key_cache_clock when last used */
+};
+
+/*!
+ * \brief The below array caches the subkeys derived by the driver, in the same secure memory as
+ *        the builtin key slots they are derived from, so that no KDF has to be run again
+ */
+static struct tfm_builtin_key_cache_entry_t g_builtin_key_cache[CRYPTO_BUILTIN_KEY_CACHE_ENTRIES];
+static uint32_t g_builtin_key_cache_clock;
+
+/*!
+ * \brief This function copies a cached subkey to the buffer, if the subkey of this length
+ *        has already been derived from the slot for this user
+ */
+static bool builtin_key_cache_get(
+        const struct tfm_builtin_key_t *key_slot, int32_t user,
+        uint8_t *key_buffer, size_t key_buffer_size, size_t *key_buffer_length)
+{
+    for (size_t idx = 0; idx < NUMBER_OF_ELEMENTS_OF(g_builtin_key_cache); idx++) {
+        struct tfm_builtin_key_cache_entry_t *entry = &g_builtin_key_cache[idx];
+
+        if (entry->key_slot == key_slot && entry->user == user &&
+            entry->key_len == key_buffer_size) {
+            memcpy(key_buffer, entry->key, entry->key_len);
+            *key_buffer_length = entry->key_len;
+            entry->last_use = ++g_builtin_key_cache_clock;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \brief This function caches a derived subkey, in a free entry or in place of the least
+ *        recently used one
+ */
+static void builtin_key_cache_add(
+        const struct tfm_builtin_key_t *key_slot, int32_t user,
+        const uint8_t *key_buffer, size_t key_buffer_length)
+{
+    struct tfm_builtin_key_cache_entry_t *entry = &g_builtin_key_cache[0];
+
+    if (key_buffer_length > TFM_BUILTIN_MAX_KEY_LEN) {
+        return;
+    }
+
+    for (size_t idx = 0; idx < NUMBER_OF_ELEMENTS_OF(g_builtin_key_cache); idx++) {
+        if (g_builtin_key_cache[idx].key_slot == NULL) {
+            entry = &g_builtin_key_cache[idx];
+            break;
+        }
+
+        if ((g_builtin_key_cache_clock - g_builtin_key_cache[idx].last_use) >
+            (g_builtin_key_cache_clock - entry->last_use)) {
+            entry = &g_builtin_key_cache[idx];
+        }
+    }
+
+    memset(entry->key, 0, sizeof(entry->key));
+    memcpy(entry->key, key_buffer, key_buffer_length);
+    entry->key_len = key_buffer_length;
+    entry->key_slot = key_slot;
+    entry->user = user;
+    entry->last_use = ++g_builtin_key_cache_clock;
+}
+#endif /* CRYPTO_BUILTIN_KEY_CACHE_ENTRIES */
+
 /*!
  * \brief This functions returns the slot associated to a key id interrogating the
  *        platform HAL table
@@ -127,6 +209,12 @@ static psa_status_t derive_subkey_into_buffer(
     }
 #endif /* TFM_PARTITION_TEST_PS */
 
+#if CRYPTO_BUILTIN_KEY_CACHE_ENTRIES
+    if (builtin_key_cache_get(key_slot, user, key_buffer, key_buffer_size, key_buffer_length)) {
+        return PSA_SUCCESS;
+    }
+#endif /* CRYPTO_BUILTIN_KEY_CACHE_ENTRIES */
+
     psa_status_t status;
     tfm_crypto_library_key_id_t output_key_id_local = tfm_crypto_library_key_id_init_default();
     tfm_crypto_library_key_id_t builtin_key = psa_get_key_id(&key_slot->attr);
@@ -180,6 +268,10 @@ static psa_status_t derive_subkey_into_buffer(
         goto wrap_up;
     }
 
+#if CRYPTO_BUILTIN_KEY_CACHE_ENTRIES
+    builtin_key_cache_add(key_slot, user, key_buffer, *key_buffer_length);
+#endif /* CRYPTO_BUILTIN_KEY_CACHE_ENTRIES */
+
 wrap_up:
     (void)psa_key_derivation_abort(&deriv_ops);
     (void)psa_destroy_key(input_key_id_local);
@@ -198,6 +290,59 @@ static psa_status_t builtin_key_copy_to_buffer(
     return PSA_SUCCESS;
 }
 
+/*!
+ * \brief This function runs the loader of a key and fills its slot with the key material and
+ *        the metadata retrieved from the platform and desc table
+ */
+static psa_status_t builtin_key_load(const tfm_plat_builtin_key_descriptor_t *desc)
+{
+    /* These properties and key material are filled by the loaders */
+    uint8_t buf[TFM_BUILTIN_MAX_KEY_LEN];
+    size_t key_len;
+    psa_key_bits_t key_bits;
+    psa_algorithm_t algorithm;
+    psa_key_type_t type;
+
+    psa_drv_slot_number_t slot_number = desc->slot_number;
+    /* The owner of a builtin key is set to 0 */
+    tfm_crypto_library_key_id_t key_id = tfm_crypto_library_key_id_init(0, desc->key_id);
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+    enum tfm_plat_err_t plat_err = desc->loader_key_func(
+                                &buf[0], TFM_BUILTIN_MAX_KEY_LEN, &key_len, &key_bits, &algorithm, &type);
+    if (plat_err != TFM_PLAT_ERR_SUCCESS) {
+        return PSA_ERROR_HARDWARE_FAILURE;
+    }
+
+    /* Build the attributes with the metadata retrieved from the platform and desc table */
+    psa_set_key_id(&attr, key_id);
+    psa_set_key_bits(&attr, key_bits);
+    psa_set_key_algorithm(&attr, algorithm);
+    psa_set_key_type(&attr, type);
+    psa_set_key_lifetime(&attr, desc->lifetime);
+
+    /* Populate the internal table of the tfm_builtin_key_loader driver with key and metadata */
+    memcpy(&(g_builtin_key_slots[slot_number].attr), &attr, sizeof(psa_key_attributes_t));
+    memcpy(&(g_builtin_key_slots[slot_number].key), buf, key_len);
+    g_builtin_key_slots[slot_number].key_len = key_len;
+    g_builtin_key_slots[slot_number].is_loaded = 1;
+
+    return PSA_SUCCESS;
+}
+
+#if CRYPTO_BUILTIN_KEY_LAZY_LOAD
+/*!
+ * \brief This function runs the loader of the key of a slot on the first use of the key
+ */
+static psa_status_t builtin_key_load_on_first_use(struct tfm_builtin_key_t *key_slot)
+{
+    if (!key_slot->is_loaded && key_slot->desc != NULL) {
+        return builtin_key_load(key_slot->desc);
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* CRYPTO_BUILTIN_KEY_LAZY_LOAD */
+
 /*!
  * \defgroup tfm_builtin_key_loader
  *
@@ -209,49 +354,41 @@ psa_status_t tfm_builtin_key_loader_init(void)
     const tfm_plat_builtin_key_descriptor_t *desc_table = NULL;
     size_t number_of_keys = tfm_plat_builtin_key_get_desc_table_ptr(&desc_table);
 
-    /* These properties and key material are filled by the loaders */
-    uint8_t buf[TFM_BUILTIN_MAX_KEY_LEN];
-    size_t key_len;
-    psa_key_bits_t key_bits;
-    psa_algorithm_t algorithm;
-    psa_key_type_t type;
+    /* Subkeys derived from previously loaded key material must not be reused */
+    tfm_builtin_key_loader_wipe_cache();
 
     for (size_t key = 0; key < number_of_keys; key++) {
         if (desc_table[key].lifetime != TFM_BUILTIN_KEY_LOADER_LIFETIME) {
             /* If the key is not bound to this driver, just don't load it */
             continue;
         }
-        psa_drv_slot_number_t slot_number = desc_table[key].slot_number;
-        /* The owner of a builtin key is set to 0 */
-        tfm_crypto_library_key_id_t key_id = tfm_crypto_library_key_id_init(0, desc_table[key].key_id);
-        psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
-        enum tfm_plat_err_t plat_err = desc_table[key].loader_key_func(
-                                    &buf[0], TFM_BUILTIN_MAX_KEY_LEN, &key_len, &key_bits, &algorithm, &type);
-        if (plat_err != TFM_PLAT_ERR_SUCCESS) {
-            err = PSA_ERROR_HARDWARE_FAILURE;
+#if CRYPTO_BUILTIN_KEY_LAZY_LOAD
+        /* The key is loaded on its first use, previously loaded key material is discarded */
+        memset(&g_builtin_key_slots[desc_table[key].slot_number], 0, sizeof(struct tfm_builtin_key_t));
+        g_builtin_key_slots[desc_table[key].slot_number].desc = &desc_table[key];
+#else
+        err = builtin_key_load(&desc_table[key]);
+        if (err != PSA_SUCCESS) {
             goto wrap_up;
         }
-
-        /* Build the attributes with the metadata retrieved from the platform and desc table */
-        psa_set_key_id(&attr, key_id);
-        psa_set_key_bits(&attr, key_bits);
-        psa_set_key_algorithm(&attr, algorithm);
-        psa_set_key_type(&attr, type);
-        psa_set_key_lifetime(&attr, desc_table[key].lifetime);
-
-        /* Populate the internal table of the tfm_builtin_key_loader driver with key and metadata */
-        memcpy(&(g_builtin_key_slots[slot_number].attr), &attr, sizeof(psa_key_attributes_t));
-        memcpy(&(g_builtin_key_slots[slot_number].key), buf, key_len);
-        g_builtin_key_slots[slot_number].key_len = key_len;
-        g_builtin_key_slots[slot_number].is_loaded = 1;
+#endif /* CRYPTO_BUILTIN_KEY_LAZY_LOAD */
     }
     /* At this point the discovered keys have been loaded successfully into the driver */
     err = PSA_SUCCESS;
 
+#if !CRYPTO_BUILTIN_KEY_LAZY_LOAD
 wrap_up:
+#endif
     return err;
 }
 
+void tfm_builtin_key_loader_wipe_cache(void)
+{
+#if CRYPTO_BUILTIN_KEY_CACHE_ENTRIES
+    memset(g_builtin_key_cache, 0, sizeof(g_builtin_key_cache));
+#endif /* CRYPTO_BUILTIN_KEY_CACHE_ENTRIES */
+}
+
 psa_status_t tfm_builtin_key_loader_get_key_buffer_size(
         tfm_crypto_library_key_id_t key_id, size_t *len)
 {
@@ -270,6 +407,13 @@ psa_status_t tfm_builtin_key_loader_get_key_buffer_size(
         goto wrap_up;
     }
 
+#if CRYPTO_BUILTIN_KEY_LAZY_LOAD
+    err = builtin_key_load_on_first_use(&g_builtin_key_slots[slot_number]);
+    if (err != PSA_SUCCESS) {
+        goto wrap_up;
+    }
+#endif /* CRYPTO_BUILTIN_KEY_LAZY_LOAD */
+
     *len = g_builtin_key_slots[slot_number].key_len;
     err = PSA_SUCCESS;
 
@@ -292,6 +436,13 @@ psa_status_t tfm_builtin_key_loader_get_builtin_key(
 
     key_slot = &g_builtin_key_slots[slot_number];
 
+#if CRYPTO_BUILTIN_KEY_LAZY_LOAD
+    err = builtin_key_load_on_first_use(key_slot);
+    if (err != PSA_SUCCESS) {
+        goto wrap_up;
+    }
+#endif /* CRYPTO_BUILTIN_KEY_LAZY_LOAD */
+
     /* The request is for a valid slot that has not been loaded*/
     if (!key_slot->is_loaded) {
         err = PSA_ERROR_DOES_NOT_EXIST;
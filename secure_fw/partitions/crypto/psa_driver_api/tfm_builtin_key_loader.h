@@ -61,6 +61,14 @@ enum psa_drv_slot_number_t {
  */
 psa_status_t tfm_builtin_key_loader_init(void);
 
+/**
+ * \brief Wipes the subkeys derived for the users of the builtin keys, which the
+ *        driver caches when CRYPTO_BUILTIN_KEY_CACHE_ENTRIES is not 0. To be
+ *        called by the platform when a lifecycle change alters the key material
+ *        or the policies of the builtin keys. It is also called at initialisation.
+ */
+void tfm_builtin_key_loader_wipe_cache(void);
+
 /**
  * \brief Returns the length of a key from the builtin driver.
  *
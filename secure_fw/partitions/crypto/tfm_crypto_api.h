@@ -93,6 +93,20 @@ psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
                                          uint32_t handle,
                                          void **ctx);
 
+#if CRYPTO_STATS_ENTRIES > 0
+/**
+ * \brief Gets the size of the pool of operation contexts of a type and the
+ *        largest number of its contexts allocated at once so far. The pool of
+ *        TFM_CRYPTO_OPERATION_NONE is the shared one.
+ *
+ * \param[in]  type       Type of the contexts of the pool
+ * \param[out] num        Number of contexts of the pool, 0 if it has none
+ * \param[out] high_water Largest number of contexts allocated at once
+ */
+void tfm_crypto_operation_get_stats(enum tfm_crypto_operation_type type,
+                                    uint32_t *num, uint32_t *high_water);
+#endif
+
 /**
  * \brief This function acts as interface from the framework dispatching
  *        calls to the set of functions that implement the PSA Crypto APIs.
@@ -121,6 +135,95 @@ psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
 psa_status_t tfm_crypto_key_management_interface(psa_invec in_vec[],
                                             psa_outvec out_vec[],
                                             struct tfm_crypto_key_id_s *encoded_key);
+
+#if CRYPTO_KEY_SLOT_LRU_ENABLED
+/**
+ * \brief Usage statistics of the key slots holding persistent keys
+ */
+struct tfm_crypto_key_slot_stats_s {
+    uint32_t hits;      /*!< Uses of a persistent key already in a key slot */
+    uint32_t misses;    /*!< Uses of a persistent key not in a key slot */
+    uint32_t evictions; /*!< Persistent keys purged from their key slot to
+                         *   make room for another key
+                         */
+};
+
+/**
+ * \brief Makes sure a key slot is available for a persistent key about to be
+ *        used, by purging the least recently used persistent key from its key
+ *        slot if they are all occupied
+ *
+ * \param[in] encoded_key Key encoded with partition_id and key_id
+ */
+void tfm_crypto_key_slot_prepare(const struct tfm_crypto_key_id_s *encoded_key);
+
+/**
+ * \brief Records the outcome of a request using a key, to keep track of the
+ *        persistent keys in the key slots
+ *
+ * \param[in] encoded_key Key encoded with partition_id and key_id
+ * \param[in] function_id Function of the request, see tfm_crypto_func_sid_t
+ * \param[in] status      Status returned by the request
+ */
+void tfm_crypto_key_slot_update(const struct tfm_crypto_key_id_s *encoded_key,
+                                uint16_t function_id,
+                                psa_status_t status);
+
+/**
+ * \brief Gets the usage statistics of the key slots
+ *
+ * \param[out] stats Usage statistics
+ */
+void tfm_crypto_key_slot_get_stats(struct tfm_crypto_key_slot_stats_s *stats);
+#endif /* CRYPTO_KEY_SLOT_LRU_ENABLED */
+
+#if CRYPTO_KEY_SHARE_ENTRIES > 0
+/**
+ * \brief Replaces a shared key ID used by a secure partition with the key of
+ *        its owner, if the key is shared with that partition. Other key IDs
+ *        are left unchanged.
+ *
+ * \param[in,out] encoded_key Key encoded with partition_id and key_id
+ * \param[in]     function_id Function of the request, see tfm_crypto_func_sid_t
+ *
+ * \return PSA_SUCCESS, PSA_ERROR_INVALID_HANDLE if the key is not shared with
+ *         the partition, PSA_ERROR_NOT_PERMITTED if the function is reserved
+ *         to the owner of the key
+ */
+psa_status_t tfm_crypto_key_share_resolve(struct tfm_crypto_key_id_s *encoded_key,
+                                          uint16_t function_id);
+
+/**
+ * \brief Gives a secure partition access to a key of another secure partition
+ *
+ * \param[in]  encoded_key  Key encoded with partition_id and key_id
+ * \param[in]  partition_id Partition given access to the key
+ * \param[out] shared_key   Key ID to be used by that partition
+ *
+ * \return Return values as described in \ref psa_status_t
+ */
+psa_status_t tfm_crypto_key_share_add(const struct tfm_crypto_key_id_s *encoded_key,
+                                      int32_t partition_id,
+                                      psa_key_id_t *shared_key);
+
+/**
+ * \brief Ends the access of a secure partition to a key
+ *
+ * \param[in] encoded_key  Key encoded with partition_id and key_id
+ * \param[in] partition_id Partition which had access to the key
+ *
+ * \return Return values as described in \ref psa_status_t
+ */
+psa_status_t tfm_crypto_key_share_remove(const struct tfm_crypto_key_id_s *encoded_key,
+                                         int32_t partition_id);
+
+/**
+ * \brief Ends the access of all the secure partitions to a destroyed key
+ *
+ * \param[in] encoded_key Key encoded with partition_id and key_id
+ */
+void tfm_crypto_key_share_revoke(const struct tfm_crypto_key_id_s *encoded_key);
+#endif /* CRYPTO_KEY_SHARE_ENTRIES > 0 */
 /**
  * \brief This function acts as interface for the MAC module
  *
@@ -206,6 +309,12 @@ psa_status_t tfm_crypto_key_derivation_interface(psa_invec in_vec[],
  */
 psa_status_t tfm_crypto_random_interface(psa_invec in_vec[],
                                          psa_outvec out_vec[]);
+/**
+ * \brief Wipes the random bytes generated ahead of the requests when the
+ *        service is built with CRYPTO_RNG_POOL_SIZE, so that the next request
+ *        generates new ones
+ */
+void tfm_crypto_rng_pool_clear(void);
 /**
  * \brief This function acts as interface for the Hash module
  *
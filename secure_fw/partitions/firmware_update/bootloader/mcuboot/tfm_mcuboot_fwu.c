@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
+#include <stdint.h>
 #include <string.h>
+#include "config_tfm.h"
 #include "psa/crypto.h"
 #include "psa/error.h"
 #include "tfm_sp_log.h"
@@ -14,6 +16,8 @@
 #include "flash_map_backend/flash_map_backend.h"
 #include "sysflash/sysflash.h"
 #include "tfm_bootloader_fwu_abstraction.h"
+#include "fwu_delta.h"
+#include "fwu_lz4.h"
 #include "tfm_boot_status.h"
 #include "service_api.h"
 
@@ -21,6 +25,12 @@
     #error "FWU_COMPONENT_NUMBER mismatch with MCUBOOT_IMAGE_NUMBER"
 #endif
 
+/* The delta patches are applied to the image running from the primary slot. */
+#if (FWU_DELTA_UPDATE == 1) && \
+    (defined(MCUBOOT_DIRECT_XIP) || defined(MCUBOOT_RAM_LOAD))
+    #error "FWU_DELTA_UPDATE is not supported with MCUBOOT_DIRECT_XIP or MCUBOOT_RAM_LOAD"
+#endif
+
 #define MAX_IMAGE_INFO_LENGTH   (MCUBOOT_IMAGE_NUMBER * \
                                 (sizeof(struct image_version) + \
                                  SHARED_DATA_ENTRY_HEADER_SIZE))
@@ -44,9 +54,55 @@ typedef struct tfm_fwu_mcuboot_ctx_s {
 
     /* The size of the downloaded data in the FWU process. */
     size_t loaded_size;
+
+#if FWU_DELTA_UPDATE == 1
+    /* A delta patch is written instead of the image. */
+    bool delta;
+    size_t patch_size;
+#endif
+
+#if FWU_LZ4_UPDATE == 1
+    /* A compressed image is written instead of the image. */
+    bool compressed;
+    size_t compressed_size;
+#endif
+
+#if FWU_ERASE_AHEAD_SIZE > 0
+    /* The staging area is erased from 0 to erased_size, and from trailer_off
+     * to its end.
+     */
+    size_t erased_size;
+    size_t trailer_off;
+#endif
+
+#if FWU_HASH_ON_WRITE == 1
+    /* Hash of the data written so far, valid while it is written in order. */
+    psa_hash_operation_t hash_op;
+    bool hash_in_order;
+    size_t hashed_size;
+    /* Size of the data MCUboot hashes: header, image and protected TLVs. */
+    size_t image_hash_end;
+    /* Hash of the MCUboot image, valid once image_hash_size is not 0. */
+    uint8_t image_hash[PSA_HASH_LENGTH(PSA_ALG_SHA_256)];
+    size_t image_hash_size;
+#endif
 } tfm_fwu_mcuboot_ctx_t;
 
 static tfm_fwu_mcuboot_ctx_t mcuboot_ctx[FWU_COMPONENT_NUMBER];
+
+#if FWU_DELTA_UPDATE == 1
+/* One delta patch is applied at a time, from the primary slot of delta_src. */
+static struct fwu_delta_ctx_t delta_ctx;
+static tfm_fwu_mcuboot_ctx_t *delta_owner;
+static const struct flash_area *delta_src;
+#endif
+
+#if FWU_LZ4_UPDATE == 1
+/* One compressed image is decompressed at a time. */
+static struct fwu_lz4_ctx_t lz4_ctx;
+static tfm_fwu_mcuboot_ctx_t *lz4_owner;
+#endif
+
 static fwu_image_info_data_t __attribute__((aligned(4))) boot_shared_data;
 
 static psa_status_t fwu_bootloader_get_shared_data(void)
@@ -92,6 +148,306 @@ static psa_status_t get_active_image_version(psa_fwu_component_t component,
     return PSA_ERROR_DATA_CORRUPT;
 }
 
+#if FWU_ERASE_AHEAD_SIZE > 0
+static size_t staging_sector_size(const struct flash_area *fap)
+{
+    return DRV_FLASH_AREA(fap)->GetInfo()->sector_size;
+}
+
+/*
+ * Erase only the sectors holding the MCUboot trailer, the sectors for the
+ * image are erased as the data is written.
+ */
+static psa_status_t staging_area_lazy_init(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    const struct flash_area *fap = ctx->fap;
+    size_t sector_size = staging_sector_size(fap);
+    size_t trailer_sz = boot_trailer_sz(flash_area_align(fap));
+
+    if (trailer_sz > fap->fa_size) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    ctx->erased_size = 0;
+    ctx->trailer_off = ((fap->fa_size - trailer_sz) / sector_size) *
+                       sector_size;
+
+    if (flash_area_erase(fap, ctx->trailer_off,
+                         fap->fa_size - ctx->trailer_off) != 0) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/*
+ * Make sure the staging area is erased up to write_end, erasing
+ * FWU_ERASE_AHEAD_SIZE more bytes at once so that most writes do not wait for
+ * an erase.
+ */
+static psa_status_t staging_area_erase_ahead(tfm_fwu_mcuboot_ctx_t *ctx,
+                                             size_t write_end)
+{
+    const struct flash_area *fap = ctx->fap;
+    size_t sector_size = staging_sector_size(fap);
+    size_t erase_end;
+
+    if (write_end <= ctx->erased_size) {
+        return PSA_SUCCESS;
+    }
+
+    erase_end = write_end + FWU_ERASE_AHEAD_SIZE;
+    erase_end = ((erase_end + sector_size - 1) / sector_size) * sector_size;
+    if (erase_end > ctx->trailer_off) {
+        erase_end = ctx->trailer_off;
+    }
+
+    if ((erase_end > ctx->erased_size) &&
+        (flash_area_erase(fap, ctx->erased_size,
+                          erase_end - ctx->erased_size) != 0)) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+    ctx->erased_size = erase_end;
+
+    return PSA_SUCCESS;
+}
+
+/* Erase what the FWU process wrote, the rest of the area is still erased. */
+static int staging_area_erase_used(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    const struct flash_area *fap = ctx->fap;
+
+    if ((ctx->erased_size > 0) &&
+        (flash_area_erase(fap, 0, ctx->erased_size) != 0)) {
+        return -1;
+    }
+
+    return flash_area_erase(fap, ctx->trailer_off,
+                            fap->fa_size - ctx->trailer_off);
+}
+#endif /* FWU_ERASE_AHEAD_SIZE > 0 */
+
+#if FWU_HASH_ON_WRITE == 1
+static void hash_on_write_start(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    ctx->hash_op = psa_hash_operation_init();
+    ctx->hashed_size = 0;
+    ctx->image_hash_end = 0;
+    ctx->image_hash_size = 0;
+    ctx->hash_in_order = (psa_hash_setup(&ctx->hash_op, PSA_ALG_SHA_256) ==
+                          PSA_SUCCESS);
+}
+
+static void hash_on_write_stop(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    if (ctx->hash_in_order) {
+        (void)psa_hash_abort(&ctx->hash_op);
+        ctx->hash_in_order = false;
+    }
+}
+
+/* Finish a copy of the running hash, which keeps being updated. */
+static psa_status_t hash_on_write_snapshot(tfm_fwu_mcuboot_ctx_t *ctx,
+                                           uint8_t *hash, size_t hash_buf_size,
+                                           size_t *hash_size)
+{
+    psa_hash_operation_t op = psa_hash_operation_init();
+    psa_status_t status;
+
+    status = psa_hash_clone(&ctx->hash_op, &op);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    return psa_hash_finish(&op, hash, hash_buf_size, hash_size);
+}
+
+/*
+ * Hash a block which was just written at the end of the data hashed so far.
+ * The end of the range hashed by MCUboot is known once the image header is
+ * written, and the hash of the image is taken when the block crosses it.
+ */
+static void hash_on_write_update(tfm_fwu_mcuboot_ctx_t *ctx,
+                                 size_t block_offset, const uint8_t *block,
+                                 size_t block_size)
+{
+    struct image_header hdr;
+    size_t len;
+
+    if (!ctx->hash_in_order) {
+        return;
+    }
+
+    if (block_offset != ctx->hashed_size) {
+        /* Out of order write, the image is hashed from flash when needed. */
+        hash_on_write_stop(ctx);
+        return;
+    }
+
+    if ((ctx->image_hash_end == 0) &&
+        (ctx->hashed_size + block_size >= sizeof(hdr))) {
+        if ((flash_area_read(ctx->fap, 0, &hdr, sizeof(hdr)) == 0) &&
+            (hdr.ih_magic == IMAGE_MAGIC)) {
+            ctx->image_hash_end = (size_t)hdr.ih_hdr_size + hdr.ih_img_size +
+                                  hdr.ih_protect_tlv_size;
+        } else {
+            ctx->image_hash_end = SIZE_MAX;
+        }
+    }
+
+    while (block_size > 0) {
+        len = block_size;
+        if ((ctx->hashed_size < ctx->image_hash_end) &&
+            (ctx->hashed_size + len > ctx->image_hash_end)) {
+            len = ctx->image_hash_end - ctx->hashed_size;
+        }
+
+        if (psa_hash_update(&ctx->hash_op, block, len) != PSA_SUCCESS) {
+            hash_on_write_stop(ctx);
+            return;
+        }
+        ctx->hashed_size += len;
+        block += len;
+        block_size -= len;
+
+        if ((ctx->hashed_size == ctx->image_hash_end) &&
+            (hash_on_write_snapshot(ctx, ctx->image_hash,
+                                    sizeof(ctx->image_hash),
+                                    &ctx->image_hash_size) != PSA_SUCCESS)) {
+            ctx->image_hash_size = 0;
+        }
+    }
+}
+#endif /* FWU_HASH_ON_WRITE == 1 */
+
+/* Write image data into the staging area of the component. */
+static psa_status_t staging_area_write(tfm_fwu_mcuboot_ctx_t *ctx,
+                                       size_t block_offset,
+                                       const uint8_t *block,
+                                       size_t block_size)
+{
+#if FWU_ERASE_AHEAD_SIZE > 0
+    if ((block_offset > ctx->fap->fa_size) ||
+        (block_size > ctx->fap->fa_size - block_offset)) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+    if (staging_area_erase_ahead(ctx, block_offset + block_size) !=
+        PSA_SUCCESS) {
+        LOG_ERRFMT("TFM FWU: erasing flash failed.\r\n");
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+#endif
+
+    if (flash_area_write(ctx->fap, block_offset, block, block_size) != 0) {
+        LOG_ERRFMT("TFM FWU: write flash failed.\r\n");
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    /* The overflow check has been done in flash_area_write. */
+    ctx->loaded_size += block_size;
+
+#if FWU_HASH_ON_WRITE == 1
+    hash_on_write_update(ctx, block_offset, block, block_size);
+#endif
+
+    return PSA_SUCCESS;
+}
+
+#if FWU_DELTA_UPDATE == 1
+static psa_status_t delta_read_src(void *arg, size_t off, uint8_t *buf,
+                                   size_t len)
+{
+    (void)arg;
+
+    if (flash_area_read(delta_src, off, buf, len) != 0) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t delta_write_dst(void *arg, size_t off, const uint8_t *buf,
+                                    size_t len)
+{
+    return staging_area_write((tfm_fwu_mcuboot_ctx_t *)arg, off, buf, len);
+}
+
+static psa_status_t delta_start(tfm_fwu_mcuboot_ctx_t *ctx,
+                                psa_fwu_component_t component)
+{
+    if ((delta_owner != NULL) && (delta_owner != ctx)) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    if ((delta_src == NULL) &&
+        (flash_area_open(FLASH_AREA_IMAGE_PRIMARY(component),
+                         &delta_src) != 0)) {
+        delta_src = NULL;
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    fwu_delta_init(&delta_ctx, delta_read_src, delta_write_dst, ctx,
+                   delta_src->fa_size, ctx->fap->fa_size);
+    delta_owner = ctx;
+    ctx->delta = true;
+    ctx->patch_size = 0;
+
+    return PSA_SUCCESS;
+}
+
+static void delta_stop(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    if (ctx->delta) {
+        ctx->delta = false;
+        delta_owner = NULL;
+        flash_area_close(delta_src);
+        delta_src = NULL;
+    }
+}
+#endif /* FWU_DELTA_UPDATE == 1 */
+
+#if FWU_LZ4_UPDATE == 1
+static psa_status_t lz4_read_dst(void *arg, size_t off, uint8_t *buf,
+                                 size_t len)
+{
+    if (flash_area_read(((tfm_fwu_mcuboot_ctx_t *)arg)->fap, off, buf,
+                        len) != 0) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t lz4_write_dst(void *arg, size_t off, const uint8_t *buf,
+                                  size_t len)
+{
+    return staging_area_write((tfm_fwu_mcuboot_ctx_t *)arg, off, buf, len);
+}
+
+static psa_status_t lz4_start(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    if ((lz4_owner != NULL) && (lz4_owner != ctx)) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    fwu_lz4_init(&lz4_ctx, lz4_read_dst, lz4_write_dst, ctx,
+                 ctx->fap->fa_size);
+    lz4_owner = ctx;
+    ctx->compressed = true;
+    ctx->compressed_size = 0;
+
+    return PSA_SUCCESS;
+}
+
+static void lz4_stop(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    if (ctx->compressed) {
+        ctx->compressed = false;
+        lz4_owner = NULL;
+    }
+}
+#endif /* FWU_LZ4_UPDATE == 1 */
+
 psa_status_t fwu_bootloader_init(void)
 {
     if (fwu_bootloader_get_shared_data() != PSA_SUCCESS) {
@@ -119,16 +475,38 @@ psa_status_t fwu_bootloader_staging_area_init(psa_fwu_component_t component,
         return PSA_ERROR_STORAGE_FAILURE;
     }
 
+#if FWU_ERASE_AHEAD_SIZE > 0
+    mcuboot_ctx[component].fap = fap;
+
+    if (staging_area_lazy_init(&mcuboot_ctx[component]) != PSA_SUCCESS) {
+        LOG_ERRFMT("TFM FWU: erasing flash failed.\r\n");
+        mcuboot_ctx[component].fap = NULL;
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+#else
     if (flash_area_erase(fap, 0, fap->fa_size) != 0) {
         LOG_ERRFMT("TFM FWU: erasing flash failed.\r\n");
         return PSA_ERROR_GENERIC_ERROR;
     }
 
     mcuboot_ctx[component].fap = fap;
+#endif
 
     /* Reset the loaded_size. */
     mcuboot_ctx[component].loaded_size = 0;
 
+#if FWU_DELTA_UPDATE == 1
+    delta_stop(&mcuboot_ctx[component]);
+#endif
+#if FWU_LZ4_UPDATE == 1
+    lz4_stop(&mcuboot_ctx[component]);
+#endif
+
+#if FWU_HASH_ON_WRITE == 1
+    hash_on_write_stop(&mcuboot_ctx[component]);
+    hash_on_write_start(&mcuboot_ctx[component]);
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -137,26 +515,155 @@ psa_status_t fwu_bootloader_load_image(psa_fwu_component_t component,
                                        const void *block,
                                        size_t block_size)
 {
-    const struct flash_area *fap;
+    tfm_fwu_mcuboot_ctx_t *ctx;
+#if (FWU_DELTA_UPDATE == 1) || (FWU_LZ4_UPDATE == 1)
+    psa_status_t status;
+#endif
 
     if (block == NULL || component >= FWU_COMPONENT_NUMBER) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
     /* The component should already be added into the mcuboot_ctx. */
-    if (mcuboot_ctx[component].fap != NULL) {
-        fap = mcuboot_ctx[component].fap;
-    } else {
+    ctx = &mcuboot_ctx[component];
+    if (ctx->fap == NULL) {
         return PSA_ERROR_BAD_STATE;
     }
 
-    if (flash_area_write(fap, block_offset, block, block_size) != 0) {
-        LOG_ERRFMT("TFM FWU: write flash failed.\r\n");
+#if FWU_DELTA_UPDATE == 1
+    if ((block_offset == 0) && !ctx->delta &&
+        fwu_delta_is_patch(block, block_size)) {
+        status = delta_start(ctx, component);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    if (ctx->delta) {
+        /* The patch is applied as a stream, so it is written in order. */
+        if (block_offset != ctx->patch_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        status = fwu_delta_process(&delta_ctx, block, block_size);
+        if (status == PSA_SUCCESS) {
+            ctx->patch_size += block_size;
+        }
+        return status;
+    }
+#endif
+
+#if FWU_LZ4_UPDATE == 1
+    if ((block_offset == 0) && !ctx->compressed &&
+        fwu_lz4_is_compressed(block, block_size)) {
+        status = lz4_start(ctx);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    if (ctx->compressed) {
+        /* The image is decompressed as a stream, so it is written in order. */
+        if (block_offset != ctx->compressed_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        status = fwu_lz4_process(&lz4_ctx, block, block_size);
+        if (status == PSA_SUCCESS) {
+            ctx->compressed_size += block_size;
+        }
+        return status;
+    }
+#endif
+
+    return staging_area_write(ctx, block_offset, block, block_size);
+}
+
+psa_status_t fwu_bootloader_check_image(psa_fwu_component_t component)
+{
+#if FWU_DELTA_UPDATE == 1
+    if ((component < FWU_COMPONENT_NUMBER) && mcuboot_ctx[component].delta) {
+        if (fwu_delta_finish(&delta_ctx) != PSA_SUCCESS) {
+            LOG_ERRFMT("TFM FWU: incomplete delta patch.\r\n");
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        delta_stop(&mcuboot_ctx[component]);
+    }
+#endif
+
+#if FWU_LZ4_UPDATE == 1
+    if ((component < FWU_COMPONENT_NUMBER) &&
+        mcuboot_ctx[component].compressed) {
+        if (fwu_lz4_finish(&lz4_ctx) != PSA_SUCCESS) {
+            LOG_ERRFMT("TFM FWU: incomplete compressed image.\r\n");
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        lz4_stop(&mcuboot_ctx[component]);
+    }
+#endif
+
+#if FWU_HASH_ON_WRITE == 1
+    tfm_fwu_mcuboot_ctx_t *ctx;
+    struct image_tlv_iter it;
+    struct image_header hdr;
+    uint8_t tlv_hash[PSA_HASH_LENGTH(PSA_ALG_SHA_256)];
+    uint32_t off;
+    uint16_t len;
+    int rc;
+
+    if (component >= FWU_COMPONENT_NUMBER) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    ctx = &mcuboot_ctx[component];
+    if (ctx->fap == NULL) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    /*
+     * Without the hash of an image written in order the check is deferred to
+     * the bootloader.
+     */
+    if (!ctx->hash_in_order || (ctx->image_hash_size == 0)) {
+        return PSA_SUCCESS;
+    }
+
+    if (flash_area_read(ctx->fap, 0, &hdr, sizeof(hdr)) != 0) {
         return PSA_ERROR_STORAGE_FAILURE;
     }
 
-    /* The overflow check has been done in flash_area_write. */
-    mcuboot_ctx[component].loaded_size += block_size;
+    /* MCUboot hashes the decrypted image, which is not available here. */
+    if (IS_ENCRYPTED(&hdr)) {
+        return PSA_SUCCESS;
+    }
+
+    if (bootutil_tlv_iter_begin(&it, &hdr, ctx->fap, IMAGE_TLV_SHA256,
+                                false) != 0) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    rc = bootutil_tlv_iter_next(&it, &off, &len, NULL);
+    if (rc < 0) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    } else if (rc > 0) {
+        /* The image is hashed with another algorithm. */
+        return PSA_SUCCESS;
+    }
+
+    if (len != sizeof(tlv_hash)) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+    if (flash_area_read(ctx->fap, off, tlv_hash, len) != 0) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    /* The signature of the image covers this hash. */
+    if (memcmp(tlv_hash, ctx->image_hash, sizeof(tlv_hash)) != 0) {
+        LOG_ERRFMT("TFM FWU: image hash mismatch.\r\n");
+        return PSA_ERROR_INVALID_SIGNATURE;
+    }
+#else
+    (void)component;
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -202,15 +709,18 @@ psa_status_t fwu_bootloader_install_image(const psa_fwu_component_t *candidates,
     psa_fwu_component_t component;
     const struct flash_area *fap;
     struct image_tlv_iter it;
-    struct image_header hdr;
     int rc;
     uint32_t off;
     uint16_t len;
     struct image_dependency dep;
     struct image_version image_ver = { 0 };
-    const struct flash_area *fap_secondary;
-    struct image_header hdr_secondary;
     bool check_pass = true;
+    /* The headers of the candidates, indexed by component, are read once and
+     * serve both their own dependency check and the checks of the candidates
+     * which depend on them.
+     */
+    struct image_header cand_hdr[FWU_COMPONENT_NUMBER];
+    bool is_candidate[FWU_COMPONENT_NUMBER] = { false };
 #endif
 
     if (candidates == NULL) {
@@ -225,19 +735,26 @@ psa_status_t fwu_bootloader_install_image(const psa_fwu_component_t *candidates,
            (mcuboot_ctx[component].fap == NULL)) {
             return PSA_ERROR_INVALID_ARGUMENT;
         }
-        fap = mcuboot_ctx[component].fap;
         /* Read the image header. */
-        if (flash_area_read(fap, 0, &hdr, sizeof(hdr)) != 0) {
+        if (flash_area_read(mcuboot_ctx[component].fap, 0, &cand_hdr[component],
+                            sizeof(cand_hdr[component])) != 0) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
 
         /* Return PSA_ERROR_DATA_CORRUPT if the image header is invalid. */
-        if (hdr.ih_magic != IMAGE_MAGIC) {
+        if (cand_hdr[component].ih_magic != IMAGE_MAGIC) {
             return PSA_ERROR_DATA_CORRUPT;
         }
+        is_candidate[component] = true;
+    }
+
+    for (cand_index = 0; cand_index < number; cand_index++) {
+        component = candidates[cand_index];
+        fap = mcuboot_ctx[component].fap;
 
         /* Initialize the iterator. */
-        if (bootutil_tlv_iter_begin(&it, &hdr, fap, IMAGE_TLV_DEPENDENCY, true)) {
+        if (bootutil_tlv_iter_begin(&it, &cand_hdr[component], fap,
+                                    IMAGE_TLV_DEPENDENCY, true)) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
         /* Check dependencies. */
@@ -253,11 +770,14 @@ psa_status_t fwu_bootloader_install_image(const psa_fwu_component_t *candidates,
 
             /* A dependency requirement is found. Set check_pass to false. */
             check_pass = false;
+            if (len != sizeof(dep)) {
+                return PSA_ERROR_DATA_CORRUPT;
+            }
             if (flash_area_read(fap, off, &dep, len) != 0) {
                 return PSA_ERROR_STORAGE_FAILURE;
             }
 
-            if (dep.image_id > MCUBOOT_IMAGE_NUMBER) {
+            if (dep.image_id >= MCUBOOT_IMAGE_NUMBER) {
                 return PSA_ERROR_DATA_CORRUPT;
             }
 
@@ -279,38 +799,13 @@ psa_status_t fwu_bootloader_install_image(const psa_fwu_component_t *candidates,
             if (is_version_greater_or_equal(&image_ver,
                                             &dep.image_min_version)) {
                 check_pass = true;
-            } else {
-                /* Check whether the CANDIDATE image can meet this image's dependency
-                 * requirement.
+            } else if (is_candidate[dep.image_id] &&
+                       is_version_greater_or_equal(&cand_hdr[dep.image_id].ih_ver,
+                                                   &dep.image_min_version)) {
+                /* The CANDIDATE image in the secondary slot meets the
+                 * dependency requirement.
                  */
-                for (index_i = 0; index_i < number; index_i++) {
-                    if (candidates[index_i] == dep.image_id)
-                        break;
-                }
-                if ((index_i < number) && (mcuboot_ctx[dep.image_id].fap != NULL)) {
-                    /* The running image cannot meet the dependency requirement. Check
-                     * the dependency image in the secondary slot.
-                     */
-                    fap_secondary = mcuboot_ctx[dep.image_id].fap;
-                    if (flash_area_read(fap_secondary,
-                                        0,
-                                        &hdr_secondary,
-                                        sizeof(hdr_secondary)) != 0) {
-                        return PSA_ERROR_STORAGE_FAILURE;
-                    }
-
-                    /* Check the version of the dependency image in the secondary slot
-                     * only if the image header is good.
-                     */
-                    if (hdr_secondary.ih_magic == IMAGE_MAGIC &&
-                        (is_version_greater_or_equal(&hdr_secondary.ih_ver,
-                                                     &dep.image_min_version))) {
-                        /* The dependency image in the secondary slot meet the
-                         * dependency requirement.
-                         */
-                        check_pass = true;
-                    }
-                }
+                check_pass = true;
             }
 
             /* Return directly if dependency check fails. */
@@ -491,10 +986,23 @@ psa_status_t fwu_bootloader_abort(psa_fwu_component_t component)
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#if FWU_ERASE_AHEAD_SIZE > 0
+    (void)staging_area_erase_used(&mcuboot_ctx[component]);
+#else
     flash_area_erase(fap, 0, fap->fa_size);
+#endif
     flash_area_close(fap);
     mcuboot_ctx[component].fap = NULL;
     mcuboot_ctx[component].loaded_size = 0;
+#if FWU_DELTA_UPDATE == 1
+    delta_stop(&mcuboot_ctx[component]);
+#endif
+#if FWU_LZ4_UPDATE == 1
+    lz4_stop(&mcuboot_ctx[component]);
+#endif
+#if FWU_HASH_ON_WRITE == 1
+    hash_on_write_stop(&mcuboot_ctx[component]);
+#endif
     return PSA_SUCCESS;
 }
 
@@ -558,6 +1066,20 @@ static psa_status_t get_second_image_digest(psa_fwu_component_t component,
     } else {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
+
+#if FWU_HASH_ON_WRITE == 1
+    /* All the data was hashed while written, read it back otherwise. */
+    if (mcuboot_ctx[component].hash_in_order &&
+        (mcuboot_ctx[component].hashed_size == data_size)) {
+        if (hash_on_write_snapshot(&mcuboot_ctx[component], hash,
+                                   sizeof(hash), &hash_size) != PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+        memcpy(info->impl.candidate_digest, hash, hash_size);
+        return PSA_SUCCESS;
+    }
+#endif
+
     if ((flash_area_open(FLASH_AREA_IMAGE_SECONDARY(component),
                             &fap)) != 0) {
         LOG_ERRFMT("TFM FWU: opening flash failed.\r\n");
@@ -650,7 +1172,10 @@ close_return:
 
 psa_status_t fwu_bootloader_clean_component(psa_fwu_component_t component)
 {
+#if FWU_ERASE_AHEAD_SIZE == 0
     const struct flash_area *fap = NULL;
+#endif
+    int rc;
 
     if (component >= FWU_COMPONENT_NUMBER) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -658,11 +1183,25 @@ psa_status_t fwu_bootloader_clean_component(psa_fwu_component_t component)
 
     /* Check if the image is in a FWU process. */
     if (mcuboot_ctx[component].fap != NULL) {
+#if FWU_ERASE_AHEAD_SIZE > 0
+        rc = staging_area_erase_used(&mcuboot_ctx[component]);
+#else
         fap = mcuboot_ctx[component].fap;
-        if (flash_area_erase(fap, 0, fap->fa_size) != 0) {
+        rc = flash_area_erase(fap, 0, fap->fa_size);
+#endif
+        if (rc != 0) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
         mcuboot_ctx[component].fap = NULL;
+#if FWU_HASH_ON_WRITE == 1
+        hash_on_write_stop(&mcuboot_ctx[component]);
+#endif
+#if FWU_DELTA_UPDATE == 1
+        delta_stop(&mcuboot_ctx[component]);
+#endif
+#if FWU_LZ4_UPDATE == 1
+        lz4_stop(&mcuboot_ctx[component]);
+#endif
     } else {
         return PSA_ERROR_DOES_NOT_EXIST;
     }
@@ -79,6 +79,24 @@ psa_status_t fwu_bootloader_load_image(psa_fwu_component_t component,
                                        const void *block,
                                        size_t block_size);
 
+/**
+ * \brief Check the image written into the target component.
+ *
+ * The component is in WRITING state and all the image data has been written.
+ * Check what can be checked before a reboot, for example the hash of the image
+ * computed while it was written, so that a corrupt image is rejected at once.
+ * The checks which cannot be done here are deferred to the installation.
+ *
+ * \param[in] component The identifier of the target component in bootloader.
+ *
+ * \return PSA_SUCCESS                     On success
+ *         PSA_ERROR_INVALID_ARGUMENT      Invalid input parameter
+ *         PSA_ERROR_INVALID_SIGNATURE     The image does not match its hash
+ *         PSA_ERROR_DATA_CORRUPT          The image metadata is corrupt
+ *         PSA_ERROR_STORAGE_FAILURE       The image cannot be read back
+ */
+psa_status_t fwu_bootloader_check_image(psa_fwu_component_t component);
+
 /**
  * \brief Starts the installation of an image.
  *
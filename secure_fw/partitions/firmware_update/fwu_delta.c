@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "fwu_delta.h"
+
+#if FWU_DELTA_UPDATE == 1
+
+/* Parser states */
+#define DELTA_STATE_HEADER      0
+#define DELTA_STATE_OP          1
+#define DELTA_STATE_LEN         2
+#define DELTA_STATE_ADJUST      3
+#define DELTA_STATE_DATA        4
+#define DELTA_STATE_DONE        5
+
+/* A 32-bit varint has at most 5 bytes */
+#define DELTA_VARINT_MAX_SHIFT  28
+
+bool fwu_delta_is_patch(const void *block, size_t block_size)
+{
+    const uint8_t *p = (const uint8_t *)block;
+
+    if (block_size < sizeof(uint32_t)) {
+        return false;
+    }
+
+    return ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+            ((uint32_t)p[3] << 24)) == FWU_DELTA_MAGIC;
+}
+
+void fwu_delta_init(struct fwu_delta_ctx_t *ctx, fwu_delta_read_t read_src,
+                    fwu_delta_write_t write_dst, void *arg, size_t src_size,
+                    size_t dst_max)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->read_src = read_src;
+    ctx->write_dst = write_dst;
+    ctx->arg = arg;
+    ctx->src_size = src_size;
+    ctx->dst_max = dst_max;
+    ctx->state = DELTA_STATE_HEADER;
+}
+
+static psa_status_t delta_flush(struct fwu_delta_ctx_t *ctx)
+{
+    psa_status_t status;
+
+    if (ctx->out_used == 0) {
+        return PSA_SUCCESS;
+    }
+
+    status = ctx->write_dst(ctx->arg, ctx->dst_pos - ctx->out_used,
+                            ctx->out_buf, ctx->out_used);
+    ctx->out_used = 0;
+
+    return status;
+}
+
+/* Number of bytes which can be output before out_buf is flushed. */
+static size_t delta_out_room(const struct fwu_delta_ctx_t *ctx, size_t len)
+{
+    size_t room = sizeof(ctx->out_buf) - ctx->out_used;
+
+    return (len < room) ? len : room;
+}
+
+static psa_status_t delta_out_commit(struct fwu_delta_ctx_t *ctx, size_t n)
+{
+    ctx->out_used += n;
+    ctx->dst_pos += n;
+    ctx->len -= n;
+
+    if (ctx->out_used == sizeof(ctx->out_buf)) {
+        return delta_flush(ctx);
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Copy the whole command from the source, it needs no patch data. */
+static psa_status_t delta_copy(struct fwu_delta_ctx_t *ctx)
+{
+    psa_status_t status;
+    size_t n;
+
+    while (ctx->len > 0) {
+        n = delta_out_room(ctx, ctx->len);
+        status = ctx->read_src(ctx->arg, ctx->src_pos,
+                               &ctx->out_buf[ctx->out_used], n);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+        ctx->src_pos += n;
+
+        status = delta_out_commit(ctx, n);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Output the data of a LITERAL command, returns the bytes consumed. */
+static psa_status_t delta_data(struct fwu_delta_ctx_t *ctx,
+                               const uint8_t *data, size_t size,
+                               size_t *consumed)
+{
+    psa_status_t status;
+    size_t n;
+
+    *consumed = 0;
+    while ((ctx->len > 0) && (*consumed < size)) {
+        n = delta_out_room(ctx, ctx->len);
+        if (n > size - *consumed) {
+            n = size - *consumed;
+        }
+        memcpy(&ctx->out_buf[ctx->out_used], &data[*consumed], n);
+        *consumed += n;
+
+        status = delta_out_commit(ctx, n);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Accumulate a varint byte, returns true once the varint is complete. */
+static bool delta_varint(struct fwu_delta_ctx_t *ctx, uint8_t byte,
+                         psa_status_t *status)
+{
+    if ((ctx->shift == DELTA_VARINT_MAX_SHIFT) && (byte & 0xF0)) {
+        *status = PSA_ERROR_INVALID_ARGUMENT;
+        return false;
+    }
+
+    ctx->value |= (uint32_t)(byte & 0x7F) << ctx->shift;
+    if (byte & 0x80) {
+        ctx->shift += 7;
+        return false;
+    }
+
+    return true;
+}
+
+static psa_status_t delta_command(struct fwu_delta_ctx_t *ctx, uint8_t byte)
+{
+    psa_status_t status = PSA_SUCCESS;
+    int64_t src_pos;
+    int32_t adjust;
+
+    switch (ctx->state) {
+    case DELTA_STATE_HEADER:
+        ctx->value |= (uint32_t)byte << (8 * (ctx->len % 4));
+        ctx->len++;
+        if (ctx->len == sizeof(uint32_t)) {
+            if (ctx->value != FWU_DELTA_MAGIC) {
+                return PSA_ERROR_INVALID_ARGUMENT;
+            }
+            ctx->value = 0;
+        } else if (ctx->len == FWU_DELTA_HEADER_SIZE) {
+            if (ctx->value > ctx->dst_max) {
+                return PSA_ERROR_INSUFFICIENT_STORAGE;
+            }
+            ctx->dst_size = ctx->value;
+            ctx->len = 0;
+            ctx->state = DELTA_STATE_OP;
+        }
+        break;
+    case DELTA_STATE_OP:
+        ctx->op = byte;
+        ctx->value = 0;
+        ctx->shift = 0;
+        if (byte == FWU_DELTA_OP_END) {
+            if (ctx->dst_pos != ctx->dst_size) {
+                return PSA_ERROR_INVALID_ARGUMENT;
+            }
+            ctx->state = DELTA_STATE_DONE;
+            return delta_flush(ctx);
+        } else if ((byte == FWU_DELTA_OP_COPY) ||
+                   (byte == FWU_DELTA_OP_LITERAL)) {
+            ctx->state = DELTA_STATE_LEN;
+        } else {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        break;
+    case DELTA_STATE_LEN:
+        if (!delta_varint(ctx, byte, &status)) {
+            return status;
+        }
+        if (ctx->value > ctx->dst_size - ctx->dst_pos) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        ctx->len = ctx->value;
+        ctx->value = 0;
+        ctx->shift = 0;
+        if (ctx->op == FWU_DELTA_OP_COPY) {
+            ctx->state = DELTA_STATE_ADJUST;
+        } else {
+            ctx->state = (ctx->len > 0) ? DELTA_STATE_DATA : DELTA_STATE_OP;
+        }
+        break;
+    case DELTA_STATE_ADJUST:
+        if (!delta_varint(ctx, byte, &status)) {
+            return status;
+        }
+        /* Zigzag decoding */
+        adjust = (int32_t)(ctx->value >> 1) ^ -(int32_t)(ctx->value & 1);
+        src_pos = (int64_t)ctx->src_pos + adjust;
+        if ((src_pos < 0) || ((uint64_t)src_pos > ctx->src_size) ||
+            (ctx->len > ctx->src_size - (size_t)src_pos)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        ctx->src_pos = (size_t)src_pos;
+        ctx->state = DELTA_STATE_OP;
+        return delta_copy(ctx);
+    default:
+        /* Data after FWU_DELTA_OP_END */
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t fwu_delta_process(struct fwu_delta_ctx_t *ctx,
+                               const uint8_t *data, size_t size)
+{
+    psa_status_t status;
+    size_t consumed;
+
+    while (size > 0) {
+        if (ctx->state == DELTA_STATE_DATA) {
+            status = delta_data(ctx, data, size, &consumed);
+            data += consumed;
+            size -= consumed;
+            if (ctx->len == 0) {
+                ctx->state = DELTA_STATE_OP;
+            }
+        } else {
+            status = delta_command(ctx, *data);
+            data++;
+            size--;
+        }
+
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t fwu_delta_finish(const struct fwu_delta_ctx_t *ctx)
+{
+    return (ctx->state == DELTA_STATE_DONE) ? PSA_SUCCESS :
+                                              PSA_ERROR_INVALID_ARGUMENT;
+}
+
+#endif /* FWU_DELTA_UPDATE == 1 */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __FWU_DELTA_H__
+#define __FWU_DELTA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config_tfm.h"
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A delta patch rebuilds the new image from the active image (the source) and
+ * is written with psa_fwu_write() instead of the new image. It is generated by
+ * tools/fwu_delta.py. All the fields are little endian, the lengths and source
+ * adjustments are LEB128 varints, the adjustments zigzag encoded:
+ *
+ *    ----------------------------------------------------
+ *    | magic(32) = FWU_DELTA_MAGIC | target size(32)    |
+ *    ----------------------------------------------------
+ *    | command | ... | FWU_DELTA_OP_END                 |
+ *    ----------------------------------------------------
+ *
+ * The commands are:
+ *  - FWU_DELTA_OP_COPY len adjust: moves the source position by adjust, then
+ *    copies len bytes of the source.
+ *  - FWU_DELTA_OP_LITERAL len bytes[len]: outputs the bytes.
+ *
+ * The patch is not compressed, so the code which only moved or whose only
+ * changes are the addresses it refers to is encoded as copies separated by
+ * short literals.
+ */
+#define FWU_DELTA_MAGIC         0x544C4544U     /* "DELT" */
+#define FWU_DELTA_HEADER_SIZE   8
+
+#define FWU_DELTA_OP_END        0x00
+#define FWU_DELTA_OP_COPY       0x01
+#define FWU_DELTA_OP_LITERAL    0x02
+
+/* Reads len bytes of the source image at off. */
+typedef psa_status_t (*fwu_delta_read_t)(void *arg, size_t off,
+                                         uint8_t *buf, size_t len);
+/* Writes len bytes of the target image at off. */
+typedef psa_status_t (*fwu_delta_write_t)(void *arg, size_t off,
+                                          const uint8_t *buf, size_t len);
+
+struct fwu_delta_ctx_t {
+    fwu_delta_read_t read_src;
+    fwu_delta_write_t write_dst;
+    void *arg;
+    size_t src_size;        /* Size of the source image               */
+    size_t dst_max;         /* Size of the target area                */
+    size_t dst_size;        /* Size of the target image, from header  */
+    size_t dst_pos;         /* Target bytes output, including out_buf */
+    size_t src_pos;         /* Current source position                */
+    uint32_t state;         /* Parser state                           */
+    uint8_t op;             /* Command being parsed                   */
+    uint8_t shift;          /* Bit position in the varint being read  */
+    uint32_t value;         /* Varint or header field being read      */
+    uint32_t len;           /* Bytes left in the command              */
+    size_t out_used;        /* Bytes in out_buf                       */
+    uint8_t out_buf[FWU_DELTA_BUF_SIZE] __attribute__((aligned(4)));
+};
+
+/**
+ * \brief Checks whether a block written at the start of an image is a delta
+ *        patch.
+ *
+ * \param[in] block       The first bytes written
+ * \param[in] block_size  Size of block
+ *
+ * \return true if the block starts with the delta patch magic.
+ */
+bool fwu_delta_is_patch(const void *block, size_t block_size);
+
+/**
+ * \brief Starts applying a delta patch.
+ *
+ * \param[out] ctx        Patch context
+ * \param[in]  read_src   Reads the source image
+ * \param[in]  write_dst  Writes the target image
+ * \param[in]  arg        Argument of the callbacks
+ * \param[in]  src_size   Size of the source image
+ * \param[in]  dst_max    Size available for the target image
+ */
+void fwu_delta_init(struct fwu_delta_ctx_t *ctx, fwu_delta_read_t read_src,
+                    fwu_delta_write_t write_dst, void *arg, size_t src_size,
+                    size_t dst_max);
+
+/**
+ * \brief Applies the next bytes of a delta patch. The patch can be split at
+ *        any byte.
+ *
+ * \param[in,out] ctx   Patch context
+ * \param[in]     data  Patch bytes
+ * \param[in]     size  Size of data
+ *
+ * \return PSA_SUCCESS                     On success
+ *         PSA_ERROR_INVALID_ARGUMENT      The patch is malformed or does not
+ *                                         apply to the source image
+ *         PSA_ERROR_INSUFFICIENT_STORAGE  The target image is too large
+ *         Other errors of the callbacks
+ */
+psa_status_t fwu_delta_process(struct fwu_delta_ctx_t *ctx,
+                               const uint8_t *data, size_t size);
+
+/**
+ * \brief Checks that the whole patch was applied. The target image is
+ *        completely written once FWU_DELTA_OP_END is processed.
+ *
+ * \param[in] ctx   Patch context
+ *
+ * \return PSA_SUCCESS if the patch ended, PSA_ERROR_INVALID_ARGUMENT otherwise
+ */
+psa_status_t fwu_delta_finish(const struct fwu_delta_ctx_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FWU_DELTA_H__ */
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "fwu_lz4.h"
+
+#if FWU_LZ4_UPDATE == 1
+
+/* Parser states */
+#define LZ4_STATE_HEADER        0
+#define LZ4_STATE_TOKEN         1
+#define LZ4_STATE_LIT_LEN       2
+#define LZ4_STATE_LITERALS      3
+#define LZ4_STATE_OFFSET        4
+#define LZ4_STATE_MATCH_LEN     5
+#define LZ4_STATE_DONE          6
+
+/* Fields of the sequence token */
+#define LZ4_LEN_MASK            0x0F
+#define LZ4_MIN_MATCH           4
+
+bool fwu_lz4_is_compressed(const void *block, size_t block_size)
+{
+    const uint8_t *p = (const uint8_t *)block;
+
+    if (block_size < sizeof(uint32_t)) {
+        return false;
+    }
+
+    return ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+            ((uint32_t)p[3] << 24)) == FWU_LZ4_MAGIC;
+}
+
+void fwu_lz4_init(struct fwu_lz4_ctx_t *ctx, fwu_lz4_read_t read_dst,
+                  fwu_lz4_write_t write_dst, void *arg, size_t dst_max)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->read_dst = read_dst;
+    ctx->write_dst = write_dst;
+    ctx->arg = arg;
+    ctx->dst_max = dst_max;
+    ctx->state = LZ4_STATE_HEADER;
+}
+
+static psa_status_t lz4_flush(struct fwu_lz4_ctx_t *ctx)
+{
+    psa_status_t status;
+
+    if (ctx->out_used == 0) {
+        return PSA_SUCCESS;
+    }
+
+    status = ctx->write_dst(ctx->arg, ctx->dst_pos - ctx->out_used,
+                            ctx->out_buf, ctx->out_used);
+    ctx->out_used = 0;
+
+    return status;
+}
+
+/* Number of bytes which can be output before out_buf is flushed. */
+static size_t lz4_out_room(const struct fwu_lz4_ctx_t *ctx, size_t len)
+{
+    size_t room = sizeof(ctx->out_buf) - ctx->out_used;
+
+    return (len < room) ? len : room;
+}
+
+static psa_status_t lz4_out_commit(struct fwu_lz4_ctx_t *ctx, size_t n)
+{
+    ctx->out_used += n;
+    ctx->dst_pos += n;
+    ctx->len -= n;
+
+    if (ctx->out_used == sizeof(ctx->out_buf)) {
+        return lz4_flush(ctx);
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Moves to the match of the sequence, or ends the block after its literals. */
+static psa_status_t lz4_literals_end(struct fwu_lz4_ctx_t *ctx)
+{
+    if (ctx->dst_pos == ctx->dst_size) {
+        ctx->state = LZ4_STATE_DONE;
+        return lz4_flush(ctx);
+    }
+
+    ctx->value = 0;
+    ctx->count = 0;
+    ctx->state = LZ4_STATE_OFFSET;
+
+    return PSA_SUCCESS;
+}
+
+/*
+ * Copy the whole match, it needs no compressed data. The match is copied in
+ * chunks which do not overlap their source, from out_buf while the source is
+ * still there and from the staging area otherwise.
+ */
+static psa_status_t lz4_match(struct fwu_lz4_ctx_t *ctx)
+{
+    psa_status_t status;
+    size_t buf_base, src, n;
+
+    ctx->state = LZ4_STATE_TOKEN;
+
+    while (ctx->len > 0) {
+        buf_base = ctx->dst_pos - ctx->out_used;
+        src = ctx->dst_pos - ctx->offset;
+        n = lz4_out_room(ctx, (ctx->len < ctx->offset) ? ctx->len :
+                                                         ctx->offset);
+        if (src >= buf_base) {
+            memmove(&ctx->out_buf[ctx->out_used], &ctx->out_buf[src - buf_base],
+                    n);
+        } else {
+            if (n > buf_base - src) {
+                n = buf_base - src;
+            }
+            status = ctx->read_dst(ctx->arg, src, &ctx->out_buf[ctx->out_used],
+                                   n);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+        }
+
+        status = lz4_out_commit(ctx, n);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Output the literals of the sequence, returns the bytes consumed. */
+static psa_status_t lz4_literals(struct fwu_lz4_ctx_t *ctx,
+                                 const uint8_t *data, size_t size,
+                                 size_t *consumed)
+{
+    psa_status_t status;
+    size_t n;
+
+    *consumed = 0;
+    while ((ctx->len > 0) && (*consumed < size)) {
+        n = lz4_out_room(ctx, ctx->len);
+        if (n > size - *consumed) {
+            n = size - *consumed;
+        }
+        memcpy(&ctx->out_buf[ctx->out_used], &data[*consumed], n);
+        *consumed += n;
+
+        status = lz4_out_commit(ctx, n);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    if (ctx->len == 0) {
+        return lz4_literals_end(ctx);
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Add a length byte, returns false if the length exceeds the image. */
+static bool lz4_add_len(struct fwu_lz4_ctx_t *ctx, uint8_t byte)
+{
+    ctx->len += byte;
+
+    return ctx->len <= ctx->dst_size - ctx->dst_pos;
+}
+
+static psa_status_t lz4_sequence(struct fwu_lz4_ctx_t *ctx, uint8_t byte)
+{
+    switch (ctx->state) {
+    case LZ4_STATE_HEADER:
+        ctx->value |= (uint32_t)byte << (8 * (ctx->count % 4));
+        ctx->count++;
+        if (ctx->count == sizeof(uint32_t)) {
+            if (ctx->value != FWU_LZ4_MAGIC) {
+                return PSA_ERROR_INVALID_ARGUMENT;
+            }
+            ctx->value = 0;
+        } else if (ctx->count == FWU_LZ4_HEADER_SIZE) {
+            if (ctx->value > ctx->dst_max) {
+                return PSA_ERROR_INSUFFICIENT_STORAGE;
+            }
+            ctx->dst_size = ctx->value;
+            ctx->state = LZ4_STATE_TOKEN;
+        }
+        break;
+    case LZ4_STATE_TOKEN:
+        ctx->token = byte;
+        ctx->len = 0;
+        if (!lz4_add_len(ctx, byte >> 4)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        if ((byte >> 4) == LZ4_LEN_MASK) {
+            ctx->state = LZ4_STATE_LIT_LEN;
+        } else if (ctx->len > 0) {
+            ctx->state = LZ4_STATE_LITERALS;
+        } else {
+            return lz4_literals_end(ctx);
+        }
+        break;
+    case LZ4_STATE_LIT_LEN:
+        if (!lz4_add_len(ctx, byte)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        if (byte != 0xFF) {
+            ctx->state = LZ4_STATE_LITERALS;
+        }
+        break;
+    case LZ4_STATE_OFFSET:
+        ctx->value |= (uint32_t)byte << (8 * ctx->count);
+        ctx->count++;
+        if (ctx->count < sizeof(uint16_t)) {
+            break;
+        }
+        if ((ctx->value == 0) || (ctx->value > ctx->dst_pos)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        ctx->offset = ctx->value;
+        ctx->len = 0;
+        if (!lz4_add_len(ctx, (ctx->token & LZ4_LEN_MASK) + LZ4_MIN_MATCH)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        if ((ctx->token & LZ4_LEN_MASK) == LZ4_LEN_MASK) {
+            ctx->state = LZ4_STATE_MATCH_LEN;
+            break;
+        }
+        return lz4_match(ctx);
+    case LZ4_STATE_MATCH_LEN:
+        if (!lz4_add_len(ctx, byte)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        if (byte != 0xFF) {
+            return lz4_match(ctx);
+        }
+        break;
+    default:
+        /* Data after the last sequence */
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t fwu_lz4_process(struct fwu_lz4_ctx_t *ctx,
+                             const uint8_t *data, size_t size)
+{
+    psa_status_t status;
+    size_t consumed;
+
+    while (size > 0) {
+        if (ctx->state == LZ4_STATE_LITERALS) {
+            status = lz4_literals(ctx, data, size, &consumed);
+            data += consumed;
+            size -= consumed;
+        } else {
+            status = lz4_sequence(ctx, *data);
+            data++;
+            size--;
+        }
+
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t fwu_lz4_finish(const struct fwu_lz4_ctx_t *ctx)
+{
+    return (ctx->state == LZ4_STATE_DONE) ? PSA_SUCCESS :
+                                            PSA_ERROR_INVALID_ARGUMENT;
+}
+
+#endif /* FWU_LZ4_UPDATE == 1 */
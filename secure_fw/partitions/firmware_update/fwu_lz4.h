@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __FWU_LZ4_H__
+#define __FWU_LZ4_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config_tfm.h"
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A compressed image is written with psa_fwu_write() instead of the image and
+ * is decompressed into the staging area. It is generated by
+ * tools/fwu_compress.py. The header fields are little endian:
+ *
+ *    ----------------------------------------------------
+ *    | magic(32) = FWU_LZ4_MAGIC | image size(32)       |
+ *    ----------------------------------------------------
+ *    | LZ4 block of the image                           |
+ *    ----------------------------------------------------
+ *
+ * The LZ4 block is a sequence of literals and matches, as specified by the
+ * LZ4 block format. The matches refer to the image already decompressed, up
+ * to 64 KB back, which is read back from the staging area, so only
+ * FWU_LZ4_BUF_SIZE bytes of RAM are used.
+ */
+#define FWU_LZ4_MAGIC           0x49345A4CU     /* "LZ4I" */
+#define FWU_LZ4_HEADER_SIZE     8
+
+/* Reads len bytes of the image already decompressed at off. */
+typedef psa_status_t (*fwu_lz4_read_t)(void *arg, size_t off,
+                                       uint8_t *buf, size_t len);
+/* Writes len bytes of the image at off. */
+typedef psa_status_t (*fwu_lz4_write_t)(void *arg, size_t off,
+                                        const uint8_t *buf, size_t len);
+
+struct fwu_lz4_ctx_t {
+    fwu_lz4_read_t read_dst;
+    fwu_lz4_write_t write_dst;
+    void *arg;
+    size_t dst_max;         /* Size of the target area                */
+    size_t dst_size;        /* Size of the image, from header         */
+    size_t dst_pos;         /* Image bytes output, including out_buf  */
+    uint32_t state;         /* Parser state                           */
+    uint8_t token;          /* Token of the sequence being parsed     */
+    uint8_t count;          /* Bytes of the header or offset read     */
+    uint32_t value;         /* Header field or offset being read      */
+    size_t len;             /* Literal or match bytes left            */
+    size_t offset;          /* Distance of the match                  */
+    size_t out_used;        /* Bytes in out_buf                       */
+    uint8_t out_buf[FWU_LZ4_BUF_SIZE] __attribute__((aligned(4)));
+};
+
+/**
+ * \brief Checks whether a block written at the start of an image is a
+ *        compressed image.
+ *
+ * \param[in] block       The first bytes written
+ * \param[in] block_size  Size of block
+ *
+ * \return true if the block starts with the compressed image magic.
+ */
+bool fwu_lz4_is_compressed(const void *block, size_t block_size);
+
+/**
+ * \brief Starts decompressing an image.
+ *
+ * \param[out] ctx        Decompression context
+ * \param[in]  read_dst   Reads back the image already written
+ * \param[in]  write_dst  Writes the image
+ * \param[in]  arg        Argument of the callbacks
+ * \param[in]  dst_max    Size available for the image
+ */
+void fwu_lz4_init(struct fwu_lz4_ctx_t *ctx, fwu_lz4_read_t read_dst,
+                  fwu_lz4_write_t write_dst, void *arg, size_t dst_max);
+
+/**
+ * \brief Decompresses the next bytes of a compressed image. The compressed
+ *        image can be split at any byte.
+ *
+ * \param[in,out] ctx   Decompression context
+ * \param[in]     data  Compressed bytes
+ * \param[in]     size  Size of data
+ *
+ * \return PSA_SUCCESS                     On success
+ *         PSA_ERROR_INVALID_ARGUMENT      The compressed image is malformed
+ *         PSA_ERROR_INSUFFICIENT_STORAGE  The image is too large
+ *         Other errors of the callbacks
+ */
+psa_status_t fwu_lz4_process(struct fwu_lz4_ctx_t *ctx,
+                             const uint8_t *data, size_t size);
+
+/**
+ * \brief Checks that the whole image was decompressed and written.
+ *
+ * \param[in] ctx   Decompression context
+ *
+ * \return PSA_SUCCESS if the image is complete, PSA_ERROR_INVALID_ARGUMENT
+ *         otherwise
+ */
+psa_status_t fwu_lz4_finish(const struct fwu_lz4_ctx_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FWU_LZ4_H__ */
@@ -31,6 +31,15 @@ typedef struct tfm_fwu_ctx_s {
  */
 static tfm_fwu_ctx_t fwu_ctx[FWU_COMPONENT_NUMBER];
 
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+/* The mapped block is programmed in place, so it can be as large as a bulk
+ * transfer.
+ */
+#define FWU_MAX_BLOCK_SIZE  TFM_FWU_MAX_BULK_WRITE_SIZE
+#else
+#define FWU_MAX_BLOCK_SIZE  PSA_FWU_MAX_WRITE_SIZE
+#endif
+
 #if PSA_FRAMEWORK_HAS_MM_IOVEC != 1
 static uint8_t block[TFM_FWU_BUF_SIZE] __aligned(4);
 #endif
@@ -110,7 +119,7 @@ static psa_status_t tfm_fwu_write(const psa_msg_t *msg)
 #endif
 
     /* Check input parameters. */
-    if (msg->in_size[2] > PSA_FWU_MAX_WRITE_SIZE) {
+    if (msg->in_size[2] > FWU_MAX_BLOCK_SIZE) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
     block_size = msg->in_size[2];
@@ -166,6 +175,7 @@ static psa_status_t tfm_fwu_write(const psa_msg_t *msg)
 static psa_status_t tfm_fwu_finish(const psa_msg_t *msg)
 {
     psa_fwu_component_t component;
+    psa_status_t status;
 
     /* Check input parameters. */
     if (msg->in_size[0] != sizeof(component)) {
@@ -182,9 +192,16 @@ static psa_status_t tfm_fwu_finish(const psa_msg_t *msg)
         return PSA_ERROR_BAD_STATE;
     }
 
-    /* Validity, authenticity and integrity of the image is deferred to system
-     * reboot.
+    /* Reject a corrupt image now. Validity, authenticity and integrity checks
+     * which need the bootloader are deferred to system reboot.
      */
+    status = fwu_bootloader_check_image(component);
+    if (status != PSA_SUCCESS) {
+        fwu_ctx[component].component_state = PSA_FWU_FAILED;
+        fwu_ctx[component].error = status;
+        return status;
+    }
+
     fwu_ctx[component].component_state = PSA_FWU_CANDIDATE;
     return PSA_SUCCESS;
 }
@@ -8,9 +8,112 @@
  *
  */
 
+#include <stdbool.h>
+#include <stdint.h>
+#include "config_spm.h"
+#include "critical_section.h"
 #include "tfm_hal_device_header.h"
+#include "tfm_hal_platform.h"
+#include "tfm_idle.h"
 #include "fih.h"
 #include "psa/service.h"
+#ifdef TFM_SP_LOG_DEFERRED
+#include "svc_num.h"
+#endif
+
+#if CONFIG_TFM_IDLE_LOW_POWER == 1
+static uint32_t wakeup_deadlines[TFM_IDLE_WAKEUP_SRC_NUM];
+static uint32_t wakeup_valid_mask;
+
+void tfm_idle_set_wakeup(uint32_t source, uint32_t deadline)
+{
+    struct critical_section_t cs_idle = CRITICAL_SECTION_STATIC_INIT;
+
+    if (source >= TFM_IDLE_WAKEUP_SRC_NUM) {
+        return;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_idle);
+    wakeup_deadlines[source] = deadline;
+    wakeup_valid_mask |= 1UL << source;
+    CRITICAL_SECTION_LEAVE(cs_idle);
+}
+
+void tfm_idle_clear_wakeup(uint32_t source)
+{
+    struct critical_section_t cs_idle = CRITICAL_SECTION_STATIC_INIT;
+
+    if (source >= TFM_IDLE_WAKEUP_SRC_NUM) {
+        return;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_idle);
+    wakeup_valid_mask &= ~(1UL << source);
+    CRITICAL_SECTION_LEAVE(cs_idle);
+}
+
+/* Get the earliest registered deadline, return false if there is none. */
+static bool get_next_wakeup(uint32_t *p_next_wakeup)
+{
+    struct critical_section_t cs_idle = CRITICAL_SECTION_STATIC_INIT;
+    bool found = false;
+    uint32_t i;
+
+    CRITICAL_SECTION_ENTER(cs_idle);
+    for (i = 0; i < TFM_IDLE_WAKEUP_SRC_NUM; i++) {
+        if (!(wakeup_valid_mask & (1UL << i))) {
+            continue;
+        }
+
+        if (!found ||
+            ((int32_t)(wakeup_deadlines[i] - *p_next_wakeup) < 0)) {
+            *p_next_wakeup = wakeup_deadlines[i];
+            found = true;
+        }
+    }
+    CRITICAL_SECTION_LEAVE(cs_idle);
+
+    return found;
+}
+
+__WEAK void tfm_hal_idle_enter(const uint32_t *p_next_wakeup)
+{
+    (void)p_next_wakeup;
+
+    __DSB();
+    __WFI();
+}
+#endif /* CONFIG_TFM_IDLE_LOW_POWER == 1 */
+
+#ifdef TFM_SP_LOG_DEFERRED
+/* Write a part of the deferred Secure Partition log, return the bytes left. */
+__attribute__((naked))
+static uint32_t drain_sp_log(void)
+{
+    __ASM volatile("SVC %0           \n"
+                   "BX LR            \n"
+                   : : "I" (TFM_SVC_DRAIN_SP_LOG));
+}
+#endif
+
+static void idle_sleep(void)
+{
+#ifdef TFM_SP_LOG_DEFERRED
+    /* Keep the core awake until the deferred log has been written out */
+    if (drain_sp_log() != 0) {
+        return;
+    }
+#endif
+
+#if CONFIG_TFM_IDLE_LOW_POWER == 1
+    uint32_t next_wakeup;
+
+    tfm_hal_idle_enter(get_next_wakeup(&next_wakeup) ? &next_wakeup : NULL);
+#else
+    __DSB();
+    __WFI();
+#endif
+}
 
 void tfm_idle_thread(void)
 {
@@ -21,8 +124,7 @@ void tfm_idle_thread(void)
          * It does not expect any signals.
          */
         if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0) {
-            __DSB();
-            __WFI();
+            idle_sleep();
         }
     }
 
@@ -36,8 +138,7 @@ void tfm_idle_thread(void)
          * It does not expect any signals.
          */
         if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0) {
-            __DSB();
-            __WFI();
+            idle_sleep();
         }
     }
 #endif
@@ -12,10 +12,10 @@
 #include "tfm_boot_status.h"
 #include "tfm_attest_iat_defs.h"
 #include "q_useful_buf.h"
+#include "psa/crypto.h"
 #ifdef TFM_PARTITION_MEASURED_BOOT
 #include "measured_boot_api.h"
 #include "boot_measurement.h"
-#include "psa/crypto.h"
 #endif /* TFM_PARTITION_MEASURED_BOOT */
 
 #ifndef TFM_PARTITION_MEASURED_BOOT
@@ -46,6 +46,27 @@ struct attest_boot_data {
  */
 __attribute__ ((aligned(4)))
 static struct attest_boot_data boot_data;
+
+/* The SW component entries of the boot data, plus the head of their array */
+#define SW_COMPONENTS_ENCODED_MAX_SIZE (MAX_BOOT_STATUS + 3)
+
+/*!
+ * \struct attest_sw_components
+ *
+ * \brief The SW components claim, encoded once from the boot data.
+ *
+ * \details The boot data cannot change after boot, so the CBOR array of the SW
+ *          components is encoded at initialisation, and its digest on first
+ *          request.
+ */
+static struct attest_sw_components {
+    enum psa_attest_err_t err;      /* Result of the encoding of the array */
+    uint32_t cnt;                   /* Number of SW components in the array */
+    struct q_useful_buf_c encoded;  /* The encoded array, NULL if cnt is 0 */
+    uint8_t buf[SW_COMPONENTS_ENCODED_MAX_SIZE];
+    size_t digest_len;              /* Length of the digest, 0 until computed */
+    uint8_t digest[PSA_HASH_LENGTH(PSA_ALG_SHA_256)];
+} sw_components;
 #endif
 
 #ifdef TFM_PARTITION_MEASURED_BOOT
@@ -206,6 +227,96 @@ static int32_t attest_get_tlv_by_module(uint8_t    module,
 }
 #endif /* TFM_PARTITION_MEASURED_BOOT */
 
+#ifndef TFM_PARTITION_MEASURED_BOOT
+/*!
+ * \brief Static function to encode the SW components from the boot status
+ *        information, see \ref attest_encode_sw_components_array.
+ */
+static enum psa_attest_err_t
+attest_encode_boot_records(QCBOREncodeContext *encode_ctx,
+                           const int32_t *map_label,
+                           uint32_t *cnt)
+{
+    struct q_useful_buf_c encoded_const = NULL_Q_USEFUL_BUF_C;
+    uint16_t tlv_len;
+    uint8_t *tlv_ptr;
+    uint8_t  tlv_id;
+    uint8_t module = 0;
+    int32_t found;
+
+    if ((encode_ctx == NULL) || (cnt == NULL)) {
+        return PSA_ATTEST_ERR_INVALID_INPUT;
+    }
+
+    *cnt = 0;
+
+    /* Extract all boot records (measurements) from the boot status information
+     * that was received from the secure bootloader.
+     */
+    for (module = 0; module < SW_MAX; ++module) {
+        /* Indicates to restart the look up from the beginning of the shared
+         * data section.
+         */
+        tlv_ptr = NULL;
+
+        /* Look up the first TLV entry which belongs to the SW module */
+        found = attest_get_tlv_by_module(module, &tlv_id,
+                                         &tlv_len, &tlv_ptr);
+        if (found == -1) {
+            /* Boot status area is malformed. */
+            return PSA_ATTEST_ERR_CLAIM_UNAVAILABLE;
+        } else if ((found == 1) && (tlv_id == SW_BOOT_RECORD)) {
+            (*cnt)++;
+            if (*cnt == 1) {
+                /* Open array which stores SW components claims. */
+                if (map_label != NULL) {
+                    QCBOREncode_OpenArrayInMapN(encode_ctx, *map_label);
+                } else {
+                    QCBOREncode_OpenArray(encode_ctx);
+                }
+            }
+
+            encoded_const.ptr = tlv_ptr + SHARED_DATA_ENTRY_HEADER_SIZE;
+            encoded_const.len = tlv_len;
+            QCBOREncode_AddEncoded(encode_ctx, encoded_const);
+        }
+    }
+
+    if (*cnt != 0) {
+        /* Close array which stores SW components claims. */
+        QCBOREncode_CloseArray(encode_ctx);
+    }
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+/*!
+ * \brief Static function to encode the SW components claim once, in
+ *        \ref sw_components.
+ */
+static void attest_encode_sw_components_once(void)
+{
+    QCBOREncodeContext encode_ctx;
+
+    QCBOREncode_Init(&encode_ctx, (struct q_useful_buf){sw_components.buf,
+                                                  sizeof(sw_components.buf)});
+
+    sw_components.encoded = NULL_Q_USEFUL_BUF_C;
+    sw_components.err = attest_encode_boot_records(&encode_ctx, NULL,
+                                                   &sw_components.cnt);
+    if (sw_components.err != PSA_ATTEST_ERR_SUCCESS ||
+        sw_components.cnt == 0) {
+        return;
+    }
+
+    if (QCBOREncode_Finish(&encode_ctx, &sw_components.encoded) !=
+        QCBOR_SUCCESS) {
+        sw_components.encoded = NULL_Q_USEFUL_BUF_C;
+        sw_components.err = PSA_ATTEST_ERR_GENERAL;
+    }
+}
+#endif /* !TFM_PARTITION_MEASURED_BOOT */
+
 enum psa_attest_err_t
 attest_encode_sw_components_array(QCBOREncodeContext *encode_ctx,
                                   const int32_t *map_label,
@@ -285,60 +396,88 @@ attest_encode_sw_components_array(QCBOREncodeContext *encode_ctx,
         }
     }
 
-#else /* TFM_PARTITION_MEASURED_BOOT */
-    struct q_useful_buf_c encoded_const = NULL_Q_USEFUL_BUF_C;
-    uint16_t tlv_len;
-    uint8_t *tlv_ptr;
-    uint8_t  tlv_id;
-    uint8_t module = 0;
-    int32_t found;
+    if (*cnt != 0) {
+        /* Close array which stores SW components claims. */
+        QCBOREncode_CloseArray(encode_ctx);
+    }
 
+    return PSA_ATTEST_ERR_SUCCESS;
+#else /* TFM_PARTITION_MEASURED_BOOT */
     if ((encode_ctx == NULL) || (cnt == NULL)) {
         return PSA_ATTEST_ERR_INVALID_INPUT;
     }
 
     *cnt = 0;
 
-    /* Extract all boot records (measurements) from the boot status information
-     * that was received from the secure bootloader.
-     */
-    for (module = 0; module < SW_MAX; ++module) {
-        /* Indicates to restart the look up from the beginning of the shared
-         * data section.
-         */
-        tlv_ptr = NULL;
-
-        /* Look up the first TLV entry which belongs to the SW module */
-        found = attest_get_tlv_by_module(module, &tlv_id,
-                                         &tlv_len, &tlv_ptr);
-        if (found == -1) {
-            /* Boot status area is malformed. */
-            return PSA_ATTEST_ERR_CLAIM_UNAVAILABLE;
-        } else if ((found == 1) && (tlv_id == SW_BOOT_RECORD)) {
-            (*cnt)++;
-            if (*cnt == 1) {
-                /* Open array which stores SW components claims. */
-                if (map_label != NULL) {
-                    QCBOREncode_OpenArrayInMapN(encode_ctx, *map_label);
-                } else {
-                    QCBOREncode_OpenArray(encode_ctx);
-                }
-            }
+    if (sw_components.err != PSA_ATTEST_ERR_SUCCESS) {
+        return sw_components.err;
+    }
 
-            encoded_const.ptr = tlv_ptr + SHARED_DATA_ENTRY_HEADER_SIZE;
-            encoded_const.len = tlv_len;
-            QCBOREncode_AddEncoded(encode_ctx, encoded_const);
+    *cnt = sw_components.cnt;
+    if (*cnt != 0) {
+        if (map_label != NULL) {
+            QCBOREncode_AddEncodedToMapN(encode_ctx, *map_label,
+                                         sw_components.encoded);
+        } else {
+            QCBOREncode_AddEncoded(encode_ctx, sw_components.encoded);
         }
     }
+
+    return PSA_ATTEST_ERR_SUCCESS;
 #endif /* TFM_PARTITION_MEASURED_BOOT */
+}
 
-    if (*cnt != 0) {
-        /* Close array which stores SW components claims. */
-        QCBOREncode_CloseArray(encode_ctx);
+#ifndef TFM_PARTITION_MEASURED_BOOT
+enum psa_attest_err_t
+attest_get_sw_components(struct q_useful_buf_c *encoded, uint32_t *cnt)
+{
+    if ((encoded == NULL) || (cnt == NULL)) {
+        return PSA_ATTEST_ERR_INVALID_INPUT;
+    }
+
+    if (sw_components.err != PSA_ATTEST_ERR_SUCCESS) {
+        return sw_components.err;
+    }
+
+    *encoded = sw_components.encoded;
+    *cnt = sw_components.cnt;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+enum psa_attest_err_t
+attest_get_sw_components_digest(struct q_useful_buf_c *digest)
+{
+    psa_status_t status;
+
+    if (digest == NULL) {
+        return PSA_ATTEST_ERR_INVALID_INPUT;
+    }
+
+    if (sw_components.err != PSA_ATTEST_ERR_SUCCESS) {
+        return sw_components.err;
     }
 
+    /* Needs to calculate only once */
+    if (sw_components.digest_len == 0) {
+        status = psa_hash_compute(PSA_ALG_SHA_256,
+                                  sw_components.encoded.ptr,
+                                  sw_components.encoded.len,
+                                  sw_components.digest,
+                                  sizeof(sw_components.digest),
+                                  &sw_components.digest_len);
+        if (status != PSA_SUCCESS) {
+            sw_components.digest_len = 0;
+            return PSA_ATTEST_ERR_GENERAL;
+        }
+    }
+
+    digest->ptr = sw_components.digest;
+    digest->len = sw_components.digest_len;
+
     return PSA_ATTEST_ERR_SUCCESS;
 }
+#endif /* !TFM_PARTITION_MEASURED_BOOT */
 
 enum psa_attest_err_t attest_boot_data_init(void)
 {
@@ -350,8 +489,17 @@ enum psa_attest_err_t attest_boot_data_init(void)
      */
     return PSA_ATTEST_ERR_SUCCESS;
 #else
-    return attest_get_boot_data(TLV_MAJOR_IAS,
-                                (struct tfm_boot_data *)&boot_data,
-                                MAX_BOOT_STATUS);
+    enum psa_attest_err_t res;
+
+    res = attest_get_boot_data(TLV_MAJOR_IAS,
+                               (struct tfm_boot_data *)&boot_data,
+                               MAX_BOOT_STATUS);
+    if (res != PSA_ATTEST_ERR_SUCCESS) {
+        return res;
+    }
+
+    attest_encode_sw_components_once();
+
+    return PSA_ATTEST_ERR_SUCCESS;
 #endif
 }
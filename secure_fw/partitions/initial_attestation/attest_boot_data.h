@@ -39,9 +39,35 @@ attest_encode_sw_components_array(QCBOREncodeContext *encode_ctx,
                                   const int32_t *map_label,
                                   uint32_t *cnt);
 
+#ifndef TFM_PARTITION_MEASURED_BOOT
+/*!
+ * \brief Gets the SW components claim, encoded once from the boot data at
+ *        initialisation, as a stand-alone CBOR array.
+ *
+ * \param[out]  encoded  The encoded array, NULL if there is no SW component
+ * \param[out]  cnt      Number of SW components in the encoded array
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+enum psa_attest_err_t
+attest_get_sw_components(struct q_useful_buf_c *encoded, uint32_t *cnt);
+
+/*!
+ * \brief Gets the SHA-256 digest of the encoded SW components array returned
+ *        by \ref attest_get_sw_components, computed on first call.
+ *
+ * \param[out]  digest  The digest
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+enum psa_attest_err_t
+attest_get_sw_components_digest(struct q_useful_buf_c *digest);
+#endif /* !TFM_PARTITION_MEASURED_BOOT */
+
 /*!
  * \brief Gets the IAS TLV entries (boot data coming from boot loader) from
- *        shared memory area to service memory area
+ *        shared memory area to service memory area, and encodes the SW
+ *        components claim from them
  *
  * \return Returns error code as specified in \ref psa_attest_err_t
  */
@@ -5,6 +5,7 @@
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <stddef.h>
@@ -25,6 +26,14 @@
 
 #define ARRAY_LENGTH(array) (sizeof(array) / sizeof(*(array)))
 
+/* Labels of the claims which change for each token, encoded at compile time */
+static const struct attest_token_label client_id_label =
+                                            ATTEST_TOKEN_LABEL(IAT_CLIENT_ID);
+static const struct attest_token_label security_lifecycle_label =
+                                    ATTEST_TOKEN_LABEL(IAT_SECURITY_LIFECYCLE);
+static const struct attest_token_label nonce_label =
+                                            ATTEST_TOKEN_LABEL(IAT_NONCE);
+
 /*!
  * \brief Static function to map return values between \ref psa_attest_err_t
  *        and \ref psa_status_t
@@ -213,9 +222,9 @@ attest_add_security_lifecycle_claim(struct attest_token_encode_ctx *token_ctx)
         return PSA_ATTEST_ERR_GENERAL;
     }
 
-    attest_token_encode_add_integer(token_ctx,
-                                    IAT_SECURITY_LIFECYCLE,
-                                    (int64_t)security_lifecycle);
+    attest_token_encode_add_integer_claim(token_ctx,
+                                          &security_lifecycle_label,
+                                          (int64_t)security_lifecycle);
 
     return PSA_ATTEST_ERR_SUCCESS;
 }
@@ -332,9 +341,9 @@ attest_add_caller_id_claim(struct attest_token_encode_ctx *token_ctx)
         return res;
     }
 
-    attest_token_encode_add_integer(token_ctx,
-                                    IAT_CLIENT_ID,
-                                    (int64_t)caller_id);
+    attest_token_encode_add_integer_claim(token_ctx,
+                                          &client_id_label,
+                                          (int64_t)caller_id);
 
     return PSA_ATTEST_ERR_SUCCESS;
 }
@@ -453,9 +462,9 @@ static enum psa_attest_err_t
 attest_add_nonce_claim(struct attest_token_encode_ctx   *token_ctx,
                        const struct q_useful_buf_c      *nonce)
 {
-    attest_token_encode_add_bstr(token_ctx,
-                                 IAT_NONCE,
-                                 nonce);
+    attest_token_encode_add_bstr_claim(token_ctx,
+                                       &nonce_label,
+                                       nonce);
 
     return PSA_ATTEST_ERR_SUCCESS;
 }
@@ -540,11 +549,19 @@ static void attest_get_option_flags(struct q_useful_buf_c *challenge,
 static enum psa_attest_err_t attest_get_t_cose_algorithm(
         int32_t *cose_algorithm_id)
 {
+    static int32_t iak_cose_algorithm_id;
+    static uint8_t iak_cose_algorithm_id_calculated;
     psa_status_t status;
     psa_key_attributes_t attr;
     psa_key_handle_t handle = TFM_BUILTIN_KEY_ID_IAK;
     psa_key_type_t key_type;
 
+    /* The IAK does not change at runtime, so it needs to be queried only once */
+    if (iak_cose_algorithm_id_calculated != 0) {
+        *cose_algorithm_id = iak_cose_algorithm_id;
+        return PSA_ATTEST_ERR_SUCCESS;
+    }
+
     status = psa_get_key_attributes(handle, &attr);
     if (status != PSA_SUCCESS) {
         return PSA_ATTEST_ERR_GENERAL;
@@ -589,41 +606,213 @@ static enum psa_attest_err_t attest_get_t_cose_algorithm(
         return PSA_ATTEST_ERR_GENERAL;
     }
 
+    iak_cose_algorithm_id = *cose_algorithm_id;
+    iak_cose_algorithm_id_calculated = 1;
+
     return PSA_ATTEST_ERR_SUCCESS;
 }
 
+/* With the Measured Boot partition, SW components can be extended at runtime */
+#ifdef TFM_PARTITION_MEASURED_BOOT
+#define ATTEST_SW_COMPONENTS_ARE_CONSTANT false
+#else
+#define ATTEST_SW_COMPONENTS_ARE_CONSTANT true
+#endif
+
+/*!
+ * \struct attest_claim_query
+ *
+ * \brief A function adding a claim to the token, and whether the value of the
+ *        claim is constant since boot.
+ */
+struct attest_claim_query {
+    enum psa_attest_err_t (*func)(struct attest_token_encode_ctx *);
+    bool is_constant;
+};
+
 #if ATTEST_TOKEN_PROFILE_PSA_IOT_1 || ATTEST_TOKEN_PROFILE_PSA_2_0_0
-    static enum psa_attest_err_t
-    (*claim_query_funcs[])(struct attest_token_encode_ctx *) = {
-        &attest_add_boot_seed_claim,
-        &attest_add_instance_id_claim,
-        &attest_add_implementation_id_claim,
-        &attest_add_caller_id_claim,
-        &attest_add_security_lifecycle_claim,
-        &attest_add_all_sw_components,
-        &attest_add_profile_definition,
+    static const struct attest_claim_query claim_queries[] = {
+        {&attest_add_boot_seed_claim,          true},
+        {&attest_add_instance_id_claim,        true},
+        {&attest_add_implementation_id_claim,  true},
+        {&attest_add_caller_id_claim,          false},
+        {&attest_add_security_lifecycle_claim, false},
+        {&attest_add_all_sw_components,        ATTEST_SW_COMPONENTS_ARE_CONSTANT},
+        {&attest_add_profile_definition,       true},
 #if ATTEST_INCLUDE_OPTIONAL_CLAIMS
-        &attest_add_verification_service,
-        &attest_add_cert_ref_claim
+        {&attest_add_verification_service,     true},
+        {&attest_add_cert_ref_claim,           true}
 #endif
     };
 #elif ATTEST_TOKEN_PROFILE_ARM_CCA
 
-    static enum psa_attest_err_t
-    (*claim_query_funcs[])(struct attest_token_encode_ctx *) = {
-        &attest_add_instance_id_claim,
-        &attest_add_implementation_id_claim,
-        &attest_add_security_lifecycle_claim,
-        &attest_add_all_sw_components,
-        &attest_add_profile_definition,
-        &attest_add_hash_algo_claim,
-        &attest_add_platform_config_claim,
+    static const struct attest_claim_query claim_queries[] = {
+        {&attest_add_instance_id_claim,        true},
+        {&attest_add_implementation_id_claim,  true},
+        {&attest_add_security_lifecycle_claim, false},
+        {&attest_add_all_sw_components,        ATTEST_SW_COMPONENTS_ARE_CONSTANT},
+        {&attest_add_profile_definition,       true},
+        {&attest_add_hash_algo_claim,          true},
+        {&attest_add_platform_config_claim,    true},
 #if ATTEST_INCLUDE_OPTIONAL_CLAIMS
-        &attest_add_verification_service,
+        {&attest_add_verification_service,     true},
 #endif
     };
 #endif
 
+#if ATTEST_TOKEN_TEMPLATE_SIZE
+/*!
+ * \struct attest_claim_template
+ *
+ * \brief The location of the pre-encoded label and value of a constant claim
+ *        in \ref template_buf.
+ */
+struct attest_claim_template {
+    uint16_t offset;     /* Offset of the encoded label */
+    uint16_t label_len;  /* Length of the encoded label */
+    uint16_t value_len;  /* Length of the encoded value, following the label */
+};
+
+enum attest_template_state {
+    ATTEST_TEMPLATE_NOT_ENCODED = 0,
+    ATTEST_TEMPLATE_READY,
+    ATTEST_TEMPLATE_UNAVAILABLE,
+};
+
+static uint8_t template_buf[ATTEST_TOKEN_TEMPLATE_SIZE];
+static struct attest_claim_template claim_templates[ARRAY_LENGTH(claim_queries)];
+static enum attest_template_state template_state = ATTEST_TEMPLATE_NOT_ENCODED;
+
+/*!
+ * \brief Static function to get the length of the head of an encoded CBOR
+ *        data item, which is the whole item for an integer.
+ *
+ * \param[in]  initial_byte  The first byte of the data item
+ *
+ * \return Returns the length of the head, 0 if it is not a definite length
+ */
+static size_t attest_cbor_head_len(uint8_t initial_byte)
+{
+    switch (initial_byte & 0x1F) {
+    case 24:
+        return 2;
+    case 25:
+        return 3;
+    case 26:
+        return 5;
+    case 27:
+        return 9;
+    default:
+        return ((initial_byte & 0x1F) < 24) ? 1 : 0;
+    }
+}
+
+/*!
+ * \brief Static function to encode the constant claims once in
+ *        \ref template_buf, so that they are copied to every token instead of
+ *        being queried and encoded again.
+ *
+ * Each claim is encoded alone in a map, to reuse the claim functions, and the
+ * one byte head of the map is then dropped.
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t attest_encode_claim_template(void)
+{
+    struct attest_token_encode_ctx claim_ctx;
+    QCBOREncodeContext *cbor_encode_ctx;
+    struct q_useful_buf_c encoded;
+    size_t offset = 0;
+    size_t label_len;
+    enum psa_attest_err_t attest_err;
+    int i;
+
+    cbor_encode_ctx = attest_token_encode_borrow_cbor_cntxt(&claim_ctx);
+
+    for (i = 0; i < ARRAY_LENGTH(claim_queries); ++i) {
+        if (!claim_queries[i].is_constant) {
+            continue;
+        }
+
+        QCBOREncode_Init(cbor_encode_ctx,
+                         (UsefulBuf){template_buf + offset,
+                                     sizeof(template_buf) - offset});
+        QCBOREncode_OpenMap(cbor_encode_ctx);
+        attest_err = claim_queries[i].func(&claim_ctx);
+        if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+            return attest_err;
+        }
+        QCBOREncode_CloseMap(cbor_encode_ctx);
+
+        if (QCBOREncode_Finish(cbor_encode_ctx, &encoded) != QCBOR_SUCCESS) {
+            return PSA_ATTEST_ERR_BUFFER_OVERFLOW;
+        }
+
+        /* A map of one pair, with a label and a value */
+        if (encoded.len < 3 || ((const uint8_t *)encoded.ptr)[0] != 0xA1) {
+            return PSA_ATTEST_ERR_GENERAL;
+        }
+        label_len = attest_cbor_head_len(((const uint8_t *)encoded.ptr)[1]);
+        if (label_len == 0 || label_len >= encoded.len - 1) {
+            return PSA_ATTEST_ERR_GENERAL;
+        }
+
+        (void)memmove(template_buf + offset,
+                      (const uint8_t *)encoded.ptr + 1, encoded.len - 1);
+        claim_templates[i].offset = (uint16_t)offset;
+        claim_templates[i].label_len = (uint16_t)label_len;
+        claim_templates[i].value_len = (uint16_t)(encoded.len - 1 - label_len);
+        offset += encoded.len - 1;
+    }
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+/*!
+ * \brief Static function to encode the constant claims on first use. If they
+ *        cannot be, for instance because \ref template_buf is too small, every
+ *        token is encoded from scratch.
+ */
+static void attest_prepare_claim_template(void)
+{
+    if (template_state != ATTEST_TEMPLATE_NOT_ENCODED) {
+        return;
+    }
+
+    if (attest_encode_claim_template() == PSA_ATTEST_ERR_SUCCESS) {
+        template_state = ATTEST_TEMPLATE_READY;
+    } else {
+        LOG_DBGFMT("Attestation: Claims are encoded for every token\r\n");
+        template_state = ATTEST_TEMPLATE_UNAVAILABLE;
+    }
+}
+
+/*!
+ * \brief Static function to add a constant claim from the template to the
+ *        attestation token.
+ *
+ * \param[in]  token_ctx  Token encoding context
+ * \param[in]  idx        Index of the claim in \ref claim_queries
+ */
+static void attest_add_claim_from_template(
+                                    struct attest_token_encode_ctx *token_ctx,
+                                    int idx)
+{
+    QCBOREncodeContext *cbor_encode_ctx;
+    const struct attest_claim_template *claim = &claim_templates[idx];
+
+    cbor_encode_ctx = attest_token_encode_borrow_cbor_cntxt(token_ctx);
+
+    QCBOREncode_AddEncoded(cbor_encode_ctx,
+                           (UsefulBufC){template_buf + claim->offset,
+                                        claim->label_len});
+    QCBOREncode_AddEncoded(cbor_encode_ctx,
+                           (UsefulBufC){template_buf + claim->offset +
+                                            claim->label_len,
+                                        claim->value_len});
+}
+#endif /* ATTEST_TOKEN_TEMPLATE_SIZE */
+
 /*!
  * \brief Static function to create the initial attestation token
  *
@@ -691,9 +880,16 @@ attest_create_token(struct q_useful_buf_c *challenge,
     }
 
     if (!(option_flags & TOKEN_OPT_OMIT_CLAIMS)) {
-        for (i = 0; i < ARRAY_LENGTH(claim_query_funcs); ++i) {
+        for (i = 0; i < ARRAY_LENGTH(claim_queries); ++i) {
+#if ATTEST_TOKEN_TEMPLATE_SIZE
+            if (template_state == ATTEST_TEMPLATE_READY &&
+                claim_queries[i].is_constant) {
+                attest_add_claim_from_template(&attest_token_ctx, i);
+                continue;
+            }
+#endif /* ATTEST_TOKEN_TEMPLATE_SIZE */
             /* Calling the attest_add_XXX_claim functions */
-            attest_err = claim_query_funcs[i](&attest_token_ctx);
+            attest_err = claim_queries[i].func(&attest_token_ctx);
             if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
                 goto error;
             }
@@ -710,6 +906,50 @@ error:
     return attest_err;
 }
 
+#if ATTEST_SW_COMPONENTS_ARE_CONSTANT
+/*!
+ * \struct attest_token_size_entry
+ *
+ * \brief The size of the token last computed for a challenge size. Only the
+ *        caller ID and the security lifecycle claims can change the size of a
+ *        token for a given challenge size, so it holds while they are the
+ *        same.
+ */
+struct attest_token_size_entry {
+    size_t token_size;  /* 0 if not computed yet */
+    int32_t caller_id;
+    enum tfm_security_lifecycle_t security_lifecycle;
+};
+
+/* Indexed by challenge size: 32, 48 and 64 bytes */
+#define ATTEST_TOKEN_SIZE_IDX(challenge_size) \
+    (((challenge_size) - PSA_INITIAL_ATTEST_CHALLENGE_SIZE_32) / 16)
+
+static struct attest_token_size_entry token_sizes[3];
+
+/*!
+ * \brief Static function to get the entry of \ref token_sizes for a challenge
+ *        size, and the values of the claims it depends on for the caller.
+ *
+ * \param[in]  challenge_size  Size of challenge object in bytes, verified
+ * \param[out] key             Caller ID and security lifecycle of the token
+ *
+ * \return Returns the entry, or NULL if the caller ID can't be obtained
+ */
+static struct attest_token_size_entry *
+attest_token_size_entry(size_t challenge_size,
+                        struct attest_token_size_entry *key)
+{
+    if (attest_get_caller_client_id(&key->caller_id) !=
+        PSA_ATTEST_ERR_SUCCESS) {
+        return NULL;
+    }
+    key->security_lifecycle = tfm_attest_hal_get_security_lifecycle();
+
+    return &token_sizes[ATTEST_TOKEN_SIZE_IDX(challenge_size)];
+}
+#endif /* ATTEST_SW_COMPONENTS_ARE_CONSTANT */
+
 psa_status_t
 initial_attest_get_token(const void *challenge_buf, size_t challenge_size,
                          void *token_buf, size_t token_buf_size,
@@ -735,6 +975,10 @@ initial_attest_get_token(const void *challenge_buf, size_t challenge_size,
         goto error;
     }
 
+#if ATTEST_TOKEN_TEMPLATE_SIZE
+    attest_prepare_claim_template();
+#endif
+
     attest_err = attest_create_token(&challenge, &token, &completed_token);
     if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
         goto error;
@@ -754,6 +998,10 @@ initial_attest_get_token_size(const size_t challenge_size,
     struct q_useful_buf_c challenge;
     struct q_useful_buf token;
     struct q_useful_buf_c completed_token;
+#if ATTEST_SW_COMPONENTS_ARE_CONSTANT
+    struct attest_token_size_entry *entry;
+    struct attest_token_size_entry key;
+#endif
 
     /* Only the size of the challenge is needed */
     challenge.ptr = NULL;
@@ -768,6 +1016,23 @@ initial_attest_get_token_size(const size_t challenge_size,
         goto error;
     }
 
+#if ATTEST_SW_COMPONENTS_ARE_CONSTANT
+    /* The token is encoded only for the first query of a challenge size, or
+     * when the caller or the security lifecycle differ from the last one.
+     */
+    entry = attest_token_size_entry(challenge_size, &key);
+    if ((entry != NULL) && (entry->token_size != 0) &&
+        (entry->caller_id == key.caller_id) &&
+        (entry->security_lifecycle == key.security_lifecycle)) {
+        *token_size = entry->token_size;
+        return PSA_SUCCESS;
+    }
+#endif
+
+#if ATTEST_TOKEN_TEMPLATE_SIZE
+    attest_prepare_claim_template();
+#endif
+
     attest_err = attest_create_token(&challenge, &token, &completed_token);
     if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
         goto error;
@@ -775,6 +1040,13 @@ initial_attest_get_token_size(const size_t challenge_size,
 
     *token_size = completed_token.len;
 
+#if ATTEST_SW_COMPONENTS_ARE_CONSTANT
+    if (entry != NULL) {
+        *entry = key;
+        entry->token_size = completed_token.len;
+    }
+#endif
+
 error:
     return error_mapping_to_psa_status_t(attest_err);
 }
@@ -129,6 +129,7 @@ struct attest_token_encode_ctx {
     int32_t                      key_select;
 #ifdef SYMMETRIC_INITIAL_ATTESTATION
     struct t_cose_mac0_sign_ctx  mac_ctx;
+    struct q_useful_buf          out_buf;
 #else
     struct t_cose_sign1_sign_ctx signer_ctx;
 #endif
@@ -235,6 +236,71 @@ void attest_token_encode_add_cbor(struct attest_token_encode_ctx *me,
                                   int32_t label,
                                   const struct q_useful_buf_c *encoded);
 
+/**
+ * \brief The label of a claim, encoded at compile time with
+ *        \ref ATTEST_TOKEN_LABEL
+ */
+struct attest_token_label {
+    uint8_t len;        /* Length of the encoded label */
+    uint8_t head[5];    /* The encoded label, of at most 32 bits */
+};
+
+/* Argument, major type and length of the CBOR head of an integer label */
+#define ATTEST_TOKEN_LABEL_ARG(l) \
+    ((uint32_t)(((l) < 0) ? (-1 - (int64_t)(l)) : (int64_t)(l)))
+#define ATTEST_TOKEN_LABEL_MT(l)  (((l) < 0) ? 0x20u : 0x00u)
+#define ATTEST_TOKEN_LABEL_LEN(l) \
+    ((ATTEST_TOKEN_LABEL_ARG(l) < 24u)     ? 1u : \
+     (ATTEST_TOKEN_LABEL_ARG(l) <= 0xFFu)   ? 2u : \
+     (ATTEST_TOKEN_LABEL_ARG(l) <= 0xFFFFu) ? 3u : 5u)
+
+/**
+ * \brief Initializer of a \ref attest_token_label, with the same preferred
+ *        serialization as QCBOR.
+ */
+#define ATTEST_TOKEN_LABEL(l) { \
+    .len = ATTEST_TOKEN_LABEL_LEN(l), \
+    .head = { \
+        (uint8_t)(ATTEST_TOKEN_LABEL_MT(l) | \
+                  ((ATTEST_TOKEN_LABEL_LEN(l) == 1u) ? ATTEST_TOKEN_LABEL_ARG(l) : \
+                   (ATTEST_TOKEN_LABEL_LEN(l) == 2u) ? 24u : \
+                   (ATTEST_TOKEN_LABEL_LEN(l) == 3u) ? 25u : 26u)), \
+        (uint8_t)((ATTEST_TOKEN_LABEL_LEN(l) == 2u) ? ATTEST_TOKEN_LABEL_ARG(l) : \
+                  (ATTEST_TOKEN_LABEL_LEN(l) == 3u) ? \
+                      (ATTEST_TOKEN_LABEL_ARG(l) >> 8) : \
+                      (ATTEST_TOKEN_LABEL_ARG(l) >> 24)), \
+        (uint8_t)((ATTEST_TOKEN_LABEL_LEN(l) == 3u) ? ATTEST_TOKEN_LABEL_ARG(l) : \
+                  (ATTEST_TOKEN_LABEL_ARG(l) >> 16)), \
+        (uint8_t)(ATTEST_TOKEN_LABEL_ARG(l) >> 8), \
+        (uint8_t)(ATTEST_TOKEN_LABEL_ARG(l)), \
+    }, \
+}
+
+/**
+ * \brief Add a 64-bit signed integer claim with a pre-encoded label
+ *
+ * \param[in] me     Token creation context.
+ * \param[in] label  The encoded label of the claim.
+ * \param[in] value  The integer claim data.
+ *
+ * The label is copied as it is and the head of the value is encoded directly,
+ * instead of both going through the generic QCBOR encoding.
+ */
+void attest_token_encode_add_integer_claim(struct attest_token_encode_ctx *me,
+                                           const struct attest_token_label *label,
+                                           int64_t value);
+
+/**
+ * \brief Add a binary string claim with a pre-encoded label
+ *
+ * \param[in] me     Token creation context.
+ * \param[in] label  The encoded label of the claim.
+ * \param[in] value  The binary claim data.
+ */
+void attest_token_encode_add_bstr_claim(struct attest_token_encode_ctx *me,
+                                        const struct attest_token_label *label,
+                                        const struct q_useful_buf_c *value);
+
 /**
  * \brief Finish the token, complete the signing and get the result
  *
@@ -2,7 +2,7 @@
  * attest_token_encode.c
  *
  * Copyright (c) 2018-2019, Laurence Lundblade. All rights reserved.
- * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -13,7 +13,10 @@
 #include "config_tfm.h"
 #include "qcbor/qcbor.h"
 #ifdef SYMMETRIC_INITIAL_ATTESTATION
+#include <string.h>
 #include "t_cose_mac0_sign.h"
+#include "t_cose_standard_constants.h"
+#include "t_cose_util.h"
 #else
 #include "t_cose_sign1_sign.h"
 #endif
@@ -90,6 +93,120 @@ static enum attest_token_err_t t_cose_err_to_attest_err(enum t_cose_err_t err)
  * - Close CBOR array holding the \c COSE_Mac0
  */
 
+#if ATTEST_MAC0_ONESHOT_ENABLED
+/**
+ * \brief Map a COSE HMAC algorithm to the PSA one.
+ *
+ * \param[in] cose_alg_id   The COSE algorithm ID.
+ *
+ * \return the PSA algorithm, or 0 if it is not supported.
+ */
+static psa_algorithm_t cose_hmac_alg_to_psa(int32_t cose_alg_id)
+{
+    switch (cose_alg_id) {
+    case T_COSE_ALGORITHM_HMAC256:
+        return PSA_ALG_HMAC(PSA_ALG_SHA_256);
+    case T_COSE_ALGORITHM_HMAC384:
+        return PSA_ALG_HMAC(PSA_ALG_SHA_384);
+    case T_COSE_ALGORITHM_HMAC512:
+        return PSA_ALG_HMAC(PSA_ALG_SHA_512);
+    default:
+        return 0;
+    }
+}
+
+/**
+ * \brief Compute the tag of the \c COSE_Mac0 and close it, as
+ *        t_cose_mac0_encode_tag() does, with a single request to the crypto
+ *        service.
+ *
+ * \param[in] me  The token creation context.
+ *
+ * \return one of the \ref attest_token_err_t errors.
+ *
+ * t_cose sets up a MAC operation, updates it with the first part of the
+ * \c MAC_structure and with the payload, then finishes it, which are four
+ * requests to the crypto service for each token. The payload is already in
+ * the output buffer, and is preceded by the COSE headers, which are longer
+ * than the first part of the \c MAC_structure when the key ID is included.
+ * The first part is then written over the end of the headers, so that the
+ * whole \c ToBeMaced is contiguous and is given to psa_mac_compute(), and
+ * the headers are restored. Otherwise the multi-part MAC is used.
+ */
+static enum attest_token_err_t
+attest_token_encode_mac0_tag(struct attest_token_encode_ctx *me)
+{
+    const struct t_cose_mac0_sign_ctx *mac_ctx = &(me->mac_ctx);
+    psa_key_id_t key_id = (psa_key_id_t)mac_ctx->signing_key.k.key_handle;
+    psa_algorithm_t alg = cose_hmac_alg_to_psa(mac_ctx->cose_algorithm_id);
+    psa_mac_operation_t mac_op = PSA_MAC_OPERATION_INIT;
+    Q_USEFUL_BUF_MAKE_STACK_UB(tbm_first_part_buf, T_COSE_SIZE_OF_TBM);
+    uint8_t saved_headers[T_COSE_SIZE_OF_TBM];
+    uint8_t tag_buf[PSA_MAC_MAX_SIZE];
+    struct q_useful_buf_c tbm_first_part;
+    struct q_useful_buf_c maced_payload;
+    uint8_t *tbm;
+    size_t tag_len;
+    psa_status_t status;
+
+    QCBOREncode_CloseBstrWrap(&(me->cbor_enc_ctx), &maced_payload);
+
+    /* The encoding errors are returned by QCBOREncode_Finish() */
+    if (QCBOREncode_GetErrorState(&(me->cbor_enc_ctx)) != QCBOR_SUCCESS) {
+        return ATTEST_TOKEN_ERR_SUCCESS;
+    }
+
+    if (alg == 0) {
+        return ATTEST_TOKEN_ERR_UNSUPPORTED_SIG_ALG;
+    }
+
+    if (create_tbm(tbm_first_part_buf, mac_ctx->protected_parameters,
+                   &tbm_first_part, T_COSE_TBM_PAYLOAD_IS_BSTR_WRAPPED,
+                   maced_payload) != T_COSE_SUCCESS) {
+        return ATTEST_TOKEN_ERR_GENERAL;
+    }
+
+    if ((size_t)((const uint8_t *)maced_payload.ptr -
+                 (const uint8_t *)me->out_buf.ptr) >= tbm_first_part.len) {
+        tbm = (uint8_t *)maced_payload.ptr - tbm_first_part.len;
+
+        memcpy(saved_headers, tbm, tbm_first_part.len);
+        memcpy(tbm, tbm_first_part.ptr, tbm_first_part.len);
+        status = psa_mac_compute(key_id, alg, tbm,
+                                 tbm_first_part.len + maced_payload.len,
+                                 tag_buf, sizeof(tag_buf), &tag_len);
+        memcpy(tbm, saved_headers, tbm_first_part.len);
+    } else {
+        status = psa_mac_sign_setup(&mac_op, key_id, alg);
+        if (status == PSA_SUCCESS) {
+            status = psa_mac_update(&mac_op, tbm_first_part.ptr,
+                                    tbm_first_part.len);
+        }
+        if (status == PSA_SUCCESS) {
+            status = psa_mac_update(&mac_op, maced_payload.ptr,
+                                    maced_payload.len);
+        }
+        if (status == PSA_SUCCESS) {
+            status = psa_mac_sign_finish(&mac_op, tag_buf, sizeof(tag_buf),
+                                         &tag_len);
+        }
+        if (status != PSA_SUCCESS) {
+            (void)psa_mac_abort(&mac_op);
+        }
+    }
+
+    if (status != PSA_SUCCESS) {
+        return ATTEST_TOKEN_ERR_GENERAL;
+    }
+
+    QCBOREncode_AddBytes(&(me->cbor_enc_ctx),
+                         (struct q_useful_buf_c){tag_buf, tag_len});
+    QCBOREncode_CloseArray(&(me->cbor_enc_ctx));
+
+    return ATTEST_TOKEN_ERR_SUCCESS;
+}
+#endif /* ATTEST_MAC0_ONESHOT_ENABLED */
+
 /*
  * Public function. See attest_token.h
  */
@@ -111,6 +228,7 @@ attest_token_encode_start(struct attest_token_encode_ctx *me,
     /* Remember some of the configuration values */
     me->opt_flags  = opt_flags;
     me->key_select = key_select;
+    me->out_buf    = *out_buf;
 
     if (opt_flags & TOKEN_OPT_SHORT_CIRCUIT_SIGN) {
         t_cose_options |= T_COSE_OPT_SHORT_CIRCUIT_TAG;
@@ -166,12 +284,24 @@ attest_token_encode_finish(struct attest_token_encode_ctx *me,
     QCBOREncode_CloseMap(&(me->cbor_enc_ctx));
 
     /* -- Finish up the COSE_Mac0. This is where the MAC happens -- */
-    cose_return_value = t_cose_mac0_encode_tag(&(me->mac_ctx),
-                                               &(me->cbor_enc_ctx));
-    if (cose_return_value) {
-        /* Main errors are invoking the tagging */
-        return_value = t_cose_err_to_attest_err(cose_return_value);
-        goto Done;
+#if ATTEST_MAC0_ONESHOT_ENABLED
+    /* The short-circuit tag and the size calculation are left to t_cose */
+    if (!(me->opt_flags & TOKEN_OPT_SHORT_CIRCUIT_SIGN) &&
+        (me->out_buf.ptr != NULL)) {
+        return_value = attest_token_encode_mac0_tag(me);
+        if (return_value != ATTEST_TOKEN_ERR_SUCCESS) {
+            goto Done;
+        }
+    } else
+#endif
+    {
+        cose_return_value = t_cose_mac0_encode_tag(&(me->mac_ctx),
+                                                   &(me->cbor_enc_ctx));
+        if (cose_return_value) {
+            /* Main errors are invoking the tagging */
+            return_value = t_cose_err_to_attest_err(cose_return_value);
+            goto Done;
+        }
     }
 
     /* Finally close off the CBOR formatting and get the pointer and length
@@ -373,3 +503,57 @@ void attest_token_encode_add_cbor(struct attest_token_encode_ctx *me,
 {
     QCBOREncode_AddEncodedToMapN(&(me->cbor_enc_ctx), label, *encoded);
 }
+
+
+/*
+ * Public function. See attest_token.h
+ */
+void attest_token_encode_add_integer_claim(struct attest_token_encode_ctx *me,
+                                           const struct attest_token_label *label,
+                                           int64_t value)
+{
+    /* The longest head of an integer, with a 64-bit argument */
+    uint8_t encoded[9];
+    uint64_t arg = (value < 0) ? (uint64_t)(-1 - value) : (uint64_t)value;
+    uint8_t major_type = (value < 0) ? 0x20 : 0x00;
+    size_t arg_len, i;
+
+    if (arg < 24) {
+        encoded[0] = major_type | (uint8_t)arg;
+        arg_len = 0;
+    } else if (arg <= UINT8_MAX) {
+        encoded[0] = major_type | 24;
+        arg_len = 1;
+    } else if (arg <= UINT16_MAX) {
+        encoded[0] = major_type | 25;
+        arg_len = 2;
+    } else if (arg <= UINT32_MAX) {
+        encoded[0] = major_type | 26;
+        arg_len = 4;
+    } else {
+        encoded[0] = major_type | 27;
+        arg_len = 8;
+    }
+
+    for (i = 0; i < arg_len; i++) {
+        encoded[arg_len - i] = (uint8_t)(arg >> (8 * i));
+    }
+
+    QCBOREncode_AddEncoded(&(me->cbor_enc_ctx),
+                           (UsefulBufC){label->head, label->len});
+    QCBOREncode_AddEncoded(&(me->cbor_enc_ctx),
+                           (UsefulBufC){encoded, arg_len + 1});
+}
+
+
+/*
+ * Public function. See attest_token.h
+ */
+void attest_token_encode_add_bstr_claim(struct attest_token_encode_ctx *me,
+                                        const struct attest_token_label *label,
+                                        const struct q_useful_buf_c *value)
+{
+    QCBOREncode_AddEncoded(&(me->cbor_enc_ctx),
+                           (UsefulBufC){label->head, label->len});
+    QCBOREncode_AddBytes(&(me->cbor_enc_ctx), *value);
+}
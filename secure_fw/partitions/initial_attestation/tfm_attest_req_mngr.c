@@ -14,6 +14,7 @@
 #include "attest.h"
 
 #include "array.h"
+#include "config_tfm.h"
 #include "psa/framework_feature.h"
 #include "psa/service.h"
 #include "psa_manifest/tfm_initial_attestation.h"
@@ -97,6 +98,100 @@ static psa_status_t psa_attest_get_token(const psa_msg_t *msg)
 }
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC == 1 */
 
+#if ATTEST_GET_TOKENS_ENABLED
+static psa_status_t psa_attest_get_tokens(const psa_msg_t *msg)
+{
+    psa_status_t status;
+    size_t token_sizes[TFM_ATTEST_GET_TOKENS_MAX_CHALLENGES];
+    size_t challenge_size;
+    size_t challenge_count;
+    size_t token_buff_size;
+    size_t tokens_size = 0;
+    size_t bytes_read;
+    size_t i;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    const uint8_t *challenge_buff;
+    uint8_t *tokens_buff;
+#else
+    uint8_t challenge_buff[PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64];
+#endif
+
+    if (msg->in_size[0] != sizeof(challenge_size)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    bytes_read = psa_read(msg->handle, 0,
+                          &challenge_size, sizeof(challenge_size));
+    if (bytes_read != sizeof(challenge_size)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (challenge_size > PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64
+        || challenge_size == 0 || msg->out_size[0] == 0
+        || msg->in_size[1] % challenge_size != 0) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    challenge_count = msg->in_size[1] / challenge_size;
+    if (challenge_count == 0
+        || challenge_count > TFM_ATTEST_GET_TOKENS_MAX_CHALLENGES
+        || msg->out_size[1] != challenge_count * sizeof(size_t)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* store the client ID here for later use in service */
+    g_attest_caller_id = msg->client_id;
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    challenge_buff = psa_map_invec(msg->handle, 1);
+    tokens_buff = psa_map_outvec(msg->handle, 0);
+#endif
+
+    /* The tokens are created one after the other in the output */
+    for (i = 0; i < challenge_count; i++) {
+        token_buff_size = msg->out_size[0] - tokens_size;
+        if (token_buff_size == 0) {
+            return PSA_ERROR_BUFFER_TOO_SMALL;
+        }
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        status = initial_attest_get_token(challenge_buff + i * challenge_size,
+                                          challenge_size,
+                                          tokens_buff + tokens_size,
+                                          token_buff_size, &token_sizes[i]);
+#else
+        if (token_buff_size > sizeof(token_buff)) {
+            token_buff_size = sizeof(token_buff);
+        }
+
+        bytes_read = psa_read(msg->handle, 1, challenge_buff, challenge_size);
+        if (bytes_read != challenge_size) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        status = initial_attest_get_token(challenge_buff, challenge_size,
+                                          token_buff, token_buff_size,
+                                          &token_sizes[i]);
+        if (status == PSA_SUCCESS) {
+            psa_write(msg->handle, 0, token_buff, token_sizes[i]);
+        }
+#endif
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        tokens_size += token_sizes[i];
+    }
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    psa_unmap_outvec(msg->handle, 0, tokens_size);
+#endif
+    psa_write(msg->handle, 1, token_sizes, challenge_count * sizeof(size_t));
+
+    return PSA_SUCCESS;
+}
+#endif /* ATTEST_GET_TOKENS_ENABLED */
+
 static psa_status_t psa_attest_get_token_size(const psa_msg_t *msg)
 {
     psa_status_t status = PSA_SUCCESS;
@@ -133,6 +228,10 @@ psa_status_t tfm_attestation_service_sfn(const psa_msg_t *msg)
         return psa_attest_get_token(msg);
     case TFM_ATTEST_GET_TOKEN_SIZE:
         return psa_attest_get_token_size(msg);
+#if ATTEST_GET_TOKENS_ENABLED
+    case TFM_ATTEST_GET_TOKENS:
+        return psa_attest_get_tokens(msg);
+#endif
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
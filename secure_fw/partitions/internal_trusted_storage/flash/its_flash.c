@@ -10,6 +10,11 @@
 #include "config_tfm.h"
 #include "flash_fs/its_flash_fs.h"
 
+#ifdef ITS_FLASH_IRQ_WAIT_ENABLED
+#include "psa/service.h"
+#include "psa_manifest/tfm_internal_trusted_storage.h"
+#endif
+
 #if ITS_RAM_FS
 #ifndef ITS_RAM_FS_SIZE
 #error "ITS_RAM_FS_SIZE must be defined by the target in flash_layout.h"
@@ -32,6 +37,25 @@ struct its_flash_nand_dev_t its_flash_nand_dev = {
 };
 #endif
 
+#if ITS_FLASH_CACHE
+#ifndef ITS_FLASH_CACHE_SIZE
+#error "ITS_FLASH_CACHE_SIZE must be defined by the target in flash_layout.h"
+#endif
+#ifndef ITS_FLASH_CACHE_ADDR
+#error "ITS_FLASH_CACHE_ADDR must be defined by the target in flash_layout.h, in RAM retained across a reset"
+#endif
+/* RAM provided by the target, retained across a reset */
+#define ITS_FLASH_CACHE_AREA ((uint8_t *)ITS_FLASH_CACHE_ADDR)
+static struct its_flash_fs_config_t its_flash_cache_flash_cfg;
+struct its_flash_cache_dev_t its_flash_cache_dev = {
+    .ops = &ITS_FLASH_OPS,
+    .flash_dev = &ITS_FLASH_DEV,
+    .area = ITS_FLASH_CACHE_AREA,
+    .area_size = ITS_FLASH_CACHE_SIZE,
+    .flash_cfg = &its_flash_cache_flash_cfg,
+};
+#endif /* ITS_FLASH_CACHE */
+
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
 #if PS_RAM_FS
 #ifndef PS_RAM_FS_SIZE
@@ -55,3 +79,34 @@ struct its_flash_nand_dev_t ps_flash_nand_dev = {
 };
 #endif
 #endif /* TFM_PARTITION_PROTECTED_STORAGE */
+
+#ifdef ITS_FLASH_IRQ_WAIT_ENABLED
+psa_status_t its_flash_wait_ready(ARM_DRIVER_FLASH *driver)
+{
+    ARM_FLASH_STATUS status;
+
+    if (!driver->GetCapabilities().event_ready) {
+        return PSA_SUCCESS;
+    }
+
+    /*
+     * The interrupt may come before it is enabled or while its signal is
+     * asserted, so the driver status is checked after each wake-up.
+     */
+    psa_irq_enable(ITS_FLASH_SIGNAL);
+
+    status = driver->GetStatus();
+    while (status.busy) {
+        (void)psa_wait(ITS_FLASH_SIGNAL, PSA_BLOCK);
+        psa_eoi(ITS_FLASH_SIGNAL);
+        status = driver->GetStatus();
+    }
+
+    if (psa_wait(ITS_FLASH_SIGNAL, PSA_POLL) & ITS_FLASH_SIGNAL) {
+        psa_eoi(ITS_FLASH_SIGNAL);
+    }
+    (void)psa_irq_disable(ITS_FLASH_SIGNAL);
+
+    return status.error ? PSA_ERROR_STORAGE_FAILURE : PSA_SUCCESS;
+}
+#endif /* ITS_FLASH_IRQ_WAIT_ENABLED */
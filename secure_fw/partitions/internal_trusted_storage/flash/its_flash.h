@@ -22,6 +22,9 @@
 #if ITS_RAM_FS
 /* RAM FS: use a buffer to emulate storage in RAM */
 #include "its_flash_ram.h"
+#if ITS_NUM_SHARDS
+#error "ITS_NUM_SHARDS is not supported by the RAM FS"
+#endif
 extern uint8_t its_block_data[];
 #define ITS_FLASH_DEV its_block_data
 #define ITS_FLASH_ALIGNMENT 1
@@ -32,6 +35,12 @@ extern uint8_t its_block_data[];
  * shot, so no filesystem data alignment is required.
  */
 #include "its_flash_nand.h"
+#if ITS_METADATA_LOG_RECORDS
+#error "ITS_METADATA_LOG_RECORDS requires the metadata block to be programmable more than once"
+#endif
+#if ITS_NUM_SHARDS
+#error "ITS_NUM_SHARDS is not supported on NAND flash"
+#endif
 extern struct its_flash_nand_dev_t its_flash_nand_dev;
 #define ITS_FLASH_DEV its_flash_nand_dev
 #define ITS_FLASH_ALIGNMENT 1
@@ -44,8 +53,33 @@ extern struct its_flash_nand_dev_t its_flash_nand_dev;
 #include "its_flash_nor.h"
 #define ITS_FLASH_DEV TFM_HAL_ITS_FLASH_DRIVER
 #define ITS_FLASH_ALIGNMENT TFM_HAL_ITS_PROGRAM_UNIT
+#ifdef TFM_HAL_ITS_FLASH_MAP_ADDR
+/* The flash is memory mapped, the file data is read in place */
+#define ITS_FLASH_MAP_ADDR TFM_HAL_ITS_FLASH_MAP_ADDR
+#define ITS_FLASH_OPS its_flash_fs_ops_nor_mapped
+#else
 #define ITS_FLASH_OPS its_flash_fs_ops_nor
 #endif
+#endif
+
+#if ITS_FLASH_CACHE
+/* Write-back cache: the ITS filesystem works on a RAM image of its flash area,
+ * which is written back to the device above by its_flash_cache_write_back().
+ */
+#include "its_flash_cache.h"
+#if ITS_RAM_FS
+#error "ITS_FLASH_CACHE requires the ITS area to be in flash"
+#endif
+#if ITS_NUM_SHARDS
+#error "ITS_FLASH_CACHE is not supported with ITS_NUM_SHARDS"
+#endif
+extern struct its_flash_cache_dev_t its_flash_cache_dev;
+#define ITS_FS_FLASH_DEV its_flash_cache_dev
+#define ITS_FS_FLASH_OPS its_flash_fs_ops_cache
+#else
+#define ITS_FS_FLASH_DEV ITS_FLASH_DEV
+#define ITS_FS_FLASH_OPS ITS_FLASH_OPS
+#endif /* ITS_FLASH_CACHE */
 
 /* Include the correct flash interface implementation for PS */
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
@@ -62,6 +96,9 @@ extern uint8_t ps_block_data[];
  * shot, so no filesystem data alignment is required.
  */
 #include "its_flash_nand.h"
+#if ITS_METADATA_LOG_RECORDS
+#error "ITS_METADATA_LOG_RECORDS requires the metadata block to be programmable more than once"
+#endif
 extern struct its_flash_nand_dev_t ps_flash_nand_dev;
 #define PS_FLASH_DEV ps_flash_nand_dev
 #define PS_FLASH_ALIGNMENT 1
@@ -74,12 +111,25 @@ extern struct its_flash_nand_dev_t ps_flash_nand_dev;
 #include "its_flash_nor.h"
 #define PS_FLASH_DEV TFM_HAL_PS_FLASH_DRIVER
 #define PS_FLASH_ALIGNMENT TFM_HAL_PS_PROGRAM_UNIT
+#ifdef TFM_HAL_PS_FLASH_MAP_ADDR
+/* The flash is memory mapped, the file data is read in place */
+#define PS_FLASH_MAP_ADDR TFM_HAL_PS_FLASH_MAP_ADDR
+#define PS_FLASH_OPS its_flash_fs_ops_nor_mapped
+#else
 #define PS_FLASH_OPS its_flash_fs_ops_nor
 #endif
+#endif
 #else /* TFM_PARTITION_PROTECTED_STORAGE */
 #define PS_FLASH_ALIGNMENT 1
 #endif /* TFM_PARTITION_PROTECTED_STORAGE */
 
+#ifndef ITS_FLASH_MAP_ADDR
+#define ITS_FLASH_MAP_ADDR 0
+#endif
+#ifndef PS_FLASH_MAP_ADDR
+#define PS_FLASH_MAP_ADDR 0
+#endif
+
 /**
  * \brief Provides a compile-time constant for the maximum program unit required
  *        by any flash device that can be accessed through this interface.
@@ -87,4 +137,22 @@ extern struct its_flash_nand_dev_t ps_flash_nand_dev;
 #define ITS_FLASH_MAX_ALIGNMENT ITS_UTILS_MAX(ITS_FLASH_ALIGNMENT, \
                                               PS_FLASH_ALIGNMENT)
 
+#ifdef ITS_FLASH_IRQ_WAIT_ENABLED
+#include "driver/Driver_Flash.h"
+
+/**
+ * \brief Waits for the end of the program or erase operation started on a
+ *        flash driver which completes them asynchronously. The partition waits
+ *        for the ITS_FLASH_SIGNAL interrupt, so that the others can run.
+ *
+ * \param[in] driver  CMSIS flash driver which started the operation
+ *
+ * \return Returns PSA_SUCCESS when the operation is complete, or
+ *         PSA_ERROR_STORAGE_FAILURE when it failed.
+ */
+psa_status_t its_flash_wait_ready(ARM_DRIVER_FLASH *driver);
+#else
+#define its_flash_wait_ready(driver)    (PSA_SUCCESS)
+#endif
+
 #endif /* __ITS_FLASH_H__ */
@@ -0,0 +1,529 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include "its_flash_cache.h"
+
+#include "flash_fs/its_flash_fs.h"
+#include "its_utils.h"
+
+#define ITS_FLASH_CACHE_MAGIC        0x43535449U   /* "ITSC" */
+#define ITS_FLASH_CACHE_BITMAP_WORDS ((ITS_FLASH_CACHE_MAX_BLOCKS + 31) / 32)
+
+/* Size of the chunks compared with the flash content on write-back */
+#define ITS_FLASH_CACHE_CMP_SIZE     32
+
+/* Size of the header at the start of a metadata block */
+#define ITS_FLASH_CACHE_META_HDR_SIZE \
+    sizeof(struct its_metadata_block_header_t)
+
+/**
+ * \brief Header of the cache, at the start of the RAM area and followed by the
+ *        image of the flash area. A block is sealed, its CRC updated, when the
+ *        filesystem commits it or erases it. A block modified since its last
+ *        commit is marked unsealed, so that a reset which interrupts the update
+ *        leaves it as a power failure leaves a flash block, and any other block
+ *        which fails the integrity check invalidates the cache.
+ */
+struct its_flash_cache_hdr_t {
+    uint32_t magic;
+    uint32_t flash_area_addr;    /* Geometry of the cached flash area */
+    uint32_t block_size;
+    uint32_t num_blocks;
+    uint32_t num_updates;        /* Blocks committed since the write-back */
+    uint32_t write_back_block;   /* Last block of the write-back in progress,
+                                  * ITS_BLOCK_INVALID_ID if none
+                                  */
+    uint32_t dirty[ITS_FLASH_CACHE_BITMAP_WORDS];    /* Blocks to write back */
+    uint32_t erased[ITS_FLASH_CACHE_BITMAP_WORDS];   /* Blocks erased since the
+                                                      * write-back
+                                                      */
+    uint32_t blank[ITS_FLASH_CACHE_BITMAP_WORDS];    /* Blocks erased in flash */
+    uint32_t unsealed[ITS_FLASH_CACHE_BITMAP_WORDS]; /* Blocks being updated */
+    uint32_t block_crc[ITS_FLASH_CACHE_MAX_BLOCKS];
+    uint32_t crc;                /* CRC of the fields above */
+};
+
+/**
+ * \brief Result of the comparison of a cached block with its copy in flash.
+ */
+struct its_flash_cache_cmp_t {
+    size_t start;     /* Offset of the first byte which differs */
+    size_t end;       /* Offset following the last byte which differs */
+    bool need_erase;  /* Whether a byte which differs is programmed in flash */
+};
+
+/* Nibble table of the CRC-32 polynomial 0xEDB88320 */
+static const uint32_t crc32_table[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+    0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+    0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+static uint32_t cache_crc32(const uint8_t *buf, size_t size)
+{
+    uint32_t crc = UINT32_MAX;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        crc ^= buf[i];
+        crc = (crc >> 4) ^ crc32_table[crc & 0xFU];
+        crc = (crc >> 4) ^ crc32_table[crc & 0xFU];
+    }
+
+    return ~crc;
+}
+
+static struct its_flash_cache_dev_t *get_dev(
+                                        const struct its_flash_fs_config_t *cfg)
+{
+    return (struct its_flash_cache_dev_t *)cfg->flash_dev;
+}
+
+static struct its_flash_cache_hdr_t *get_hdr(
+                                        const struct its_flash_fs_config_t *cfg)
+{
+    return (struct its_flash_cache_hdr_t *)get_dev(cfg)->area;
+}
+
+static uint8_t *get_block(const struct its_flash_fs_config_t *cfg,
+                          uint32_t block_id)
+{
+    return get_dev(cfg)->area
+           + ITS_UTILS_ALIGN(sizeof(struct its_flash_cache_hdr_t), 4)
+           + (block_id * cfg->block_size);
+}
+
+static bool bit_get(const uint32_t *bitmap, uint32_t idx)
+{
+    return (bitmap[idx / 32] & (1U << (idx % 32))) != 0;
+}
+
+static void bit_set(uint32_t *bitmap, uint32_t idx, bool val)
+{
+    if (val) {
+        bitmap[idx / 32] |= 1U << (idx % 32);
+    } else {
+        bitmap[idx / 32] &= ~(1U << (idx % 32));
+    }
+}
+
+static void seal_hdr(struct its_flash_cache_hdr_t *hdr)
+{
+    hdr->crc = cache_crc32((const uint8_t *)hdr,
+                           offsetof(struct its_flash_cache_hdr_t, crc));
+}
+
+static void seal_block(const struct its_flash_fs_config_t *cfg,
+                       uint32_t block_id)
+{
+    get_hdr(cfg)->block_crc[block_id] = cache_crc32(get_block(cfg, block_id),
+                                                    cfg->block_size);
+}
+
+static void set_bit_sealed(struct its_flash_cache_hdr_t *hdr, uint32_t *bitmap,
+                           uint32_t idx)
+{
+    if (!bit_get(bitmap, idx)) {
+        bit_set(bitmap, idx, true);
+        seal_hdr(hdr);
+    }
+}
+
+static bool block_is_blank(const struct its_flash_fs_config_t *cfg,
+                           uint32_t block_id)
+{
+    const uint8_t *block = get_block(cfg, block_id);
+    size_t i;
+
+    for (i = 0; i < cfg->block_size; i++) {
+        if (block[i] != cfg->erase_val) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static uint32_t get_last_block_id(const struct its_flash_fs_config_t *cfg)
+{
+    const uint32_t *last_block_id = get_dev(cfg)->last_block_id;
+
+    return (last_block_id != NULL) ? *last_block_id : ITS_BLOCK_INVALID_ID;
+}
+
+/**
+ * \brief Checks the cache kept in RAM across the reset, if any, matches the
+ *        flash area and is intact.
+ */
+static bool cache_is_valid(const struct its_flash_fs_config_t *cfg)
+{
+    const struct its_flash_cache_hdr_t *hdr = get_hdr(cfg);
+    uint32_t i;
+
+    if ((hdr->magic != ITS_FLASH_CACHE_MAGIC) ||
+        (hdr->flash_area_addr != cfg->flash_area_addr) ||
+        (hdr->block_size != cfg->block_size) ||
+        (hdr->num_blocks != cfg->num_blocks) ||
+        (hdr->crc != cache_crc32((const uint8_t *)hdr,
+                                 offsetof(struct its_flash_cache_hdr_t, crc)))) {
+        return false;
+    }
+
+    for (i = 0; i < cfg->num_blocks; i++) {
+        if (!bit_get(hdr->unsealed, i) &&
+            (hdr->block_crc[i] != cache_crc32(get_block(cfg, i),
+                                              cfg->block_size))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Fills the cache with the content of the flash area.
+ */
+static psa_status_t cache_load(const struct its_flash_fs_config_t *cfg)
+{
+    struct its_flash_cache_dev_t *dev = get_dev(cfg);
+    struct its_flash_cache_hdr_t *hdr = get_hdr(cfg);
+    psa_status_t err;
+    uint32_t i;
+
+    (void)memset(hdr, 0, sizeof(*hdr));
+
+    for (i = 0; i < cfg->num_blocks; i++) {
+        err = dev->ops->read(dev->flash_cfg, i, get_block(cfg, i), 0,
+                             cfg->block_size);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+        seal_block(cfg, i);
+        bit_set(hdr->blank, i, block_is_blank(cfg, i));
+    }
+
+    hdr->magic = ITS_FLASH_CACHE_MAGIC;
+    hdr->flash_area_addr = cfg->flash_area_addr;
+    hdr->block_size = cfg->block_size;
+    hdr->num_blocks = cfg->num_blocks;
+    hdr->write_back_block = ITS_BLOCK_INVALID_ID;
+    seal_hdr(hdr);
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Compares a cached block with its copy in flash.
+ */
+static psa_status_t block_compare(const struct its_flash_fs_config_t *cfg,
+                                  uint32_t block_id,
+                                  struct its_flash_cache_cmp_t *cmp)
+{
+    struct its_flash_cache_dev_t *dev = get_dev(cfg);
+    const uint8_t *block = get_block(cfg, block_id);
+    uint8_t buf[ITS_FLASH_CACHE_CMP_SIZE];
+    size_t offset;
+    size_t size;
+    size_t i;
+
+    cmp->start = cfg->block_size;
+    cmp->end = 0;
+    cmp->need_erase = false;
+
+    for (offset = 0; offset < cfg->block_size; offset += size) {
+        size = ITS_UTILS_MIN(sizeof(buf), cfg->block_size - offset);
+        if (dev->ops->read(dev->flash_cfg, block_id, buf, offset, size)
+            != PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+
+        for (i = 0; i < size; i++) {
+            if (buf[i] != block[offset + i]) {
+                cmp->start = ITS_UTILS_MIN(cmp->start, offset + i);
+                cmp->end = offset + i + 1;
+                if (buf[i] != cfg->erase_val) {
+                    cmp->need_erase = true;
+                }
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Writes a modified block back to flash. The bytes which differ are
+ *        programmed when they are erased in flash, as the filesystem does
+ *        when it appends to a block, and the block is erased and programmed
+ *        otherwise, if allowed. A block left modified stays dirty.
+ */
+static psa_status_t block_write_back(const struct its_flash_fs_config_t *cfg,
+                                     uint32_t block_id, bool allow_erase)
+{
+    struct its_flash_cache_dev_t *dev = get_dev(cfg);
+    struct its_flash_cache_hdr_t *hdr = get_hdr(cfg);
+    const uint8_t *block = get_block(cfg, block_id);
+    struct its_flash_cache_cmp_t cmp;
+    psa_status_t err;
+    size_t offset;
+
+    err = block_compare(cfg, block_id, &cmp);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (cmp.need_erase) {
+        if (!allow_erase) {
+            return PSA_SUCCESS;
+        }
+
+        err = dev->ops->erase(dev->flash_cfg, block_id);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+
+        /* Only program the block up to its last programmed byte */
+        cmp.start = 0;
+        cmp.end = cfg->block_size;
+        while ((cmp.end > 0) && (block[cmp.end - 1] == cfg->erase_val)) {
+            cmp.end--;
+        }
+    }
+
+    if (cmp.start < cmp.end) {
+        cmp.start -= cmp.start % cfg->program_unit;
+        cmp.end = ITS_UTILS_MIN(ITS_UTILS_ALIGN(cmp.end, cfg->program_unit),
+                                cfg->block_size);
+
+        /* The filesystem programs the header of a metadata block, which makes
+         * the block valid, after the rest of the block. Do the same.
+         */
+        err = PSA_SUCCESS;
+        if (cmp.end > ITS_FLASH_CACHE_META_HDR_SIZE) {
+            offset = ITS_UTILS_MAX(cmp.start, ITS_FLASH_CACHE_META_HDR_SIZE);
+            err = dev->ops->write(dev->flash_cfg, block_id, block + offset,
+                                  offset, cmp.end - offset);
+        }
+        if ((err == PSA_SUCCESS) && (cmp.start < ITS_FLASH_CACHE_META_HDR_SIZE)) {
+            err = dev->ops->write(dev->flash_cfg, block_id, block + cmp.start,
+                                  cmp.start,
+                                  ITS_UTILS_MIN(cmp.end,
+                                                ITS_FLASH_CACHE_META_HDR_SIZE)
+                                  - cmp.start);
+        }
+        if (err == PSA_SUCCESS) {
+            err = dev->ops->flush(dev->flash_cfg, block_id);
+        }
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+    }
+
+    bit_set(hdr->dirty, block_id, false);
+    bit_set(hdr->erased, block_id, false);
+    bit_set(hdr->blank, block_id, block_is_blank(cfg, block_id));
+    seal_hdr(hdr);
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Writes the modified blocks back to flash, in an order which keeps
+ *        the filesystem in flash consistent whenever it is interrupted: the
+ *        blocks which only need programming, then the last block, holding the
+ *        new metadata, and then the blocks which need an erase, which can only
+ *        be referenced by the previous metadata. The write-back in progress is
+ *        recorded in the header, to be resumed by the init function.
+ */
+static psa_status_t cache_write_back(const struct its_flash_fs_config_t *cfg,
+                                     uint32_t last_block_id)
+{
+    struct its_flash_cache_hdr_t *hdr = get_hdr(cfg);
+    psa_status_t err;
+    uint32_t i;
+
+    hdr->write_back_block = last_block_id;
+    seal_hdr(hdr);
+
+    for (i = 0; i < cfg->num_blocks; i++) {
+        if ((i != last_block_id) && bit_get(hdr->dirty, i)) {
+            err = block_write_back(cfg, i, false);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    if ((last_block_id < cfg->num_blocks) &&
+        bit_get(hdr->dirty, last_block_id)) {
+        err = block_write_back(cfg, last_block_id, false);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    for (i = 0; i < cfg->num_blocks; i++) {
+        if (bit_get(hdr->dirty, i)) {
+            err = block_write_back(cfg, i, true);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    hdr->write_back_block = ITS_BLOCK_INVALID_ID;
+    hdr->num_updates = 0;
+    seal_hdr(hdr);
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_flash_cache_init(const struct its_flash_fs_config_t *cfg)
+{
+    struct its_flash_cache_dev_t *dev = get_dev(cfg);
+    struct its_flash_cache_hdr_t *hdr = get_hdr(cfg);
+    psa_status_t err;
+    uint32_t i;
+
+    if ((cfg->num_blocks > ITS_FLASH_CACHE_MAX_BLOCKS) ||
+        (dev->area_size < ITS_UTILS_ALIGN(sizeof(struct its_flash_cache_hdr_t), 4)
+                          + ((size_t)cfg->num_blocks * cfg->block_size))) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    *dev->flash_cfg = *cfg;
+    dev->flash_cfg->flash_dev = dev->flash_dev;
+
+    err = dev->ops->init(dev->flash_cfg);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Keep the cache restored from retained RAM, with the blocks it has not
+     * written back yet, or start from the flash content.
+     */
+    if (!cache_is_valid(cfg)) {
+        return cache_load(cfg);
+    }
+
+    for (i = 0; i < cfg->num_blocks; i++) {
+        if (bit_get(hdr->unsealed, i)) {
+            seal_block(cfg, i);
+            bit_set(hdr->unsealed, i, false);
+        }
+    }
+    seal_hdr(hdr);
+
+    /* Resume the write-back which the reset interrupted */
+    if (hdr->write_back_block != ITS_BLOCK_INVALID_ID) {
+        return cache_write_back(cfg, hdr->write_back_block);
+    }
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_flash_cache_read(const struct its_flash_fs_config_t *cfg,
+                                         uint32_t block_id, uint8_t *buff,
+                                         size_t offset, size_t size)
+{
+    (void)memcpy(buff, get_block(cfg, block_id) + offset, size);
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_flash_cache_map(const struct its_flash_fs_config_t *cfg,
+                                        uint32_t block_id, const uint8_t **buff,
+                                        size_t offset, size_t size)
+{
+    (void)size;
+    *buff = get_block(cfg, block_id) + offset;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_flash_cache_write(const struct its_flash_fs_config_t *cfg,
+                                          uint32_t block_id, const uint8_t *buff,
+                                          size_t offset, size_t size)
+{
+    struct its_flash_cache_hdr_t *hdr = get_hdr(cfg);
+    psa_status_t err;
+
+    /* The flash copy of a block erased since the write-back can hold data the
+     * metadata in flash refers to, so it is only erased after the new
+     * metadata is written back. Write the cache back before the block is
+     * reused, as the new metadata would otherwise refer to it.
+     */
+    if (bit_get(hdr->erased, block_id) && !bit_get(hdr->blank, block_id)) {
+        err = cache_write_back(cfg, get_last_block_id(cfg));
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* The block CRC is updated when the block is committed */
+    set_bit_sealed(hdr, hdr->dirty, block_id);
+    set_bit_sealed(hdr, hdr->unsealed, block_id);
+    (void)memcpy(get_block(cfg, block_id) + offset, buff, size);
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_flash_cache_flush(const struct its_flash_fs_config_t *cfg,
+                                          uint32_t block_id)
+{
+    struct its_flash_cache_hdr_t *hdr = get_hdr(cfg);
+
+    seal_block(cfg, block_id);
+    bit_set(hdr->unsealed, block_id, false);
+    hdr->num_updates++;
+    seal_hdr(hdr);
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_flash_cache_erase(const struct its_flash_fs_config_t *cfg,
+                                          uint32_t block_id)
+{
+    struct its_flash_cache_hdr_t *hdr = get_hdr(cfg);
+
+    (void)memset(get_block(cfg, block_id), cfg->erase_val, cfg->block_size);
+    seal_block(cfg, block_id);
+    bit_set(hdr->unsealed, block_id, false);
+
+    if (bit_get(hdr->blank, block_id)) {
+        /* The block is equal to its copy in flash again */
+        bit_set(hdr->dirty, block_id, false);
+    } else {
+        bit_set(hdr->dirty, block_id, true);
+        bit_set(hdr->erased, block_id, true);
+    }
+    seal_hdr(hdr);
+
+    return PSA_SUCCESS;
+}
+
+uint32_t its_flash_cache_num_updates(const struct its_flash_fs_config_t *cfg)
+{
+    return get_hdr(cfg)->num_updates;
+}
+
+psa_status_t its_flash_cache_write_back(const struct its_flash_fs_config_t *cfg)
+{
+    return cache_write_back(cfg, get_last_block_id(cfg));
+}
+
+const struct its_flash_fs_ops_t its_flash_fs_ops_cache = {
+    .init = its_flash_cache_init,
+    .read = its_flash_cache_read,
+    .write = its_flash_cache_write,
+    .flush = its_flash_cache_flush,
+    .erase = its_flash_cache_erase,
+    .map = its_flash_cache_map,
+};
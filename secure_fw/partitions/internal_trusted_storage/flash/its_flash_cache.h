@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/**
+ * \file its_flash_cache.h
+ *
+ * \brief Implementations of the flash interface functions for a write-back
+ *        cache of a flash device in RAM. The filesystem works on a RAM image
+ *        of its flash area, and the modified blocks are only written back to
+ *        the flash device by its_flash_cache_write_back(). See
+ *        its_flash_fs_ops_t for full documentation of functions.
+ */
+
+#ifndef __ITS_FLASH_CACHE_H__
+#define __ITS_FLASH_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct its_flash_fs_config_t;
+struct its_flash_fs_ops_t;
+
+/* Maximum number of blocks of the cached flash area */
+#define ITS_FLASH_CACHE_MAX_BLOCKS 64
+
+struct its_flash_cache_dev_t {
+    const struct its_flash_fs_ops_t *ops; /* Operations of the flash device */
+    const void *flash_dev;                /* Flash device written back to */
+    uint8_t *area;     /* RAM holding the cache header and the image, which is
+                        * kept across a reset when it is retained RAM
+                        */
+    size_t area_size;  /* Size of the RAM area in bytes */
+    /* Configuration of the flash device, set by the init function */
+    struct its_flash_fs_config_t *flash_cfg;
+    /* Block holding the committed metadata of the filesystem, written back
+     * after the other programmed blocks. Set before the filesystem is
+     * initialised.
+     */
+    const uint32_t *last_block_id;
+};
+
+extern const struct its_flash_fs_ops_t its_flash_fs_ops_cache;
+
+/**
+ * \brief Gets the number of block updates committed to the cache since the
+ *        last write-back.
+ *
+ * \param[in] cfg  Filesystem configuration
+ *
+ * \return Returns the number of updates.
+ */
+uint32_t its_flash_cache_num_updates(const struct its_flash_fs_config_t *cfg);
+
+/**
+ * \brief Writes the modified blocks of the cache back to the flash device.
+ *        The blocks equal to their copy in flash are not erased again. The
+ *        blocks which only need programming are written first, then the block
+ *        pointed to by last_block_id of the device, and the erases are done
+ *        last, so that the metadata in flash only refers to blocks already
+ *        written back and the blocks it refers to are kept until the new
+ *        metadata is written. A write-back interrupted by a reset is resumed
+ *        by the init function. The cache also writes itself back when the
+ *        filesystem reuses a block the metadata in flash can refer to.
+ *
+ * \param[in] cfg  Filesystem configuration
+ *
+ * \return Returns PSA_SUCCESS if the function is executed correctly.
+ *         Otherwise, it returns PSA_ERROR_STORAGE_FAILURE, the blocks not
+ *         written back being kept modified.
+ */
+psa_status_t its_flash_cache_write_back(const struct its_flash_fs_config_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_FLASH_CACHE_H__ */
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "its_flash_nand.h"
+#include "its_flash.h"
 #include "flash_fs/its_flash_fs.h"
 
 /* Valid entries for data item width */
@@ -154,14 +155,20 @@ static psa_status_t its_flash_nand_write(
      */
     if (block_id == flash_dev->buf_block_id_0) {
         (void)memcpy(flash_dev->write_buf_0 + offset, buff, size);
+        flash_dev->buf_len_0 = ITS_UTILS_MAX(flash_dev->buf_len_0,
+                                             offset + size);
     } else if (block_id == flash_dev->buf_block_id_1) {
         (void)memcpy(flash_dev->write_buf_1 + offset, buff, size);
+        flash_dev->buf_len_1 = ITS_UTILS_MAX(flash_dev->buf_len_1,
+                                             offset + size);
     } else if (flash_dev->buf_block_id_0 == ITS_BLOCK_INVALID_ID) {
         flash_dev->buf_block_id_0 = block_id;
         (void)memcpy(flash_dev->write_buf_0 + offset, buff, size);
+        flash_dev->buf_len_0 = offset + size;
     } else if (flash_dev->buf_block_id_1 == ITS_BLOCK_INVALID_ID) {
         flash_dev->buf_block_id_1 = block_id;
         (void)memcpy(flash_dev->write_buf_1 + offset, buff, size);
+        flash_dev->buf_len_1 = offset + size;
     } else {
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
@@ -169,47 +176,100 @@ static psa_status_t its_flash_nand_write(
     return PSA_SUCCESS;
 }
 
-static psa_status_t its_flash_nand_flush(
+/**
+ * \brief Programs the pages of a block which hold the buffered write data.
+ *
+ * \details The pages are programmed in order, in as few driver calls as the
+ *          driver allows: the whole range is requested at once, and the
+ *          request is resumed if the driver programs fewer data items.
+ *
+ * \param[in] cfg       Flash FS configuration
+ * \param[in] block_id  Block ID
+ * \param[in] buf       Write buffer of the block
+ * \param[in] len       End of the data written to the buffer
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_nand_program(
                                     const struct its_flash_fs_config_t *cfg,
-                                    uint32_t block_id)
+                                    uint32_t block_id, const uint8_t *buf,
+                                    size_t len)
 {
-    int32_t err;
+    int32_t ret;
     struct its_flash_nand_dev_t *flash_dev =
         (struct its_flash_nand_dev_t *)cfg->flash_dev;
     uint32_t addr;
+    size_t offset = 0;
+    size_t page_size;
     ARM_FLASH_CAPABILITIES DriverCapabilities;
     uint8_t data_width;
 
     DriverCapabilities = flash_dev->driver->GetCapabilities();
     data_width = data_width_byte[DriverCapabilities.data_width];
-    if (block_id == flash_dev->buf_block_id_0) {
-        addr = get_phys_address(cfg, flash_dev->buf_block_id_0, 0);
 
-        /*
-         * Flush the buffered write data to flash. For NAND flash,
-         * cfg->block_size should always be a multiplier of data_width.
-         */
-        err = flash_dev->driver->ProgramData(addr, flash_dev->write_buf_0,
-                                             cfg->block_size / data_width);
-        if (err < 0) {
+    /* Only the pages which hold data are programmed, the others are left
+     * erased. For NAND flash, cfg->block_size should always be a multiplier
+     * of the page size, which is a multiplier of data_width.
+     */
+    page_size = flash_dev->driver->GetInfo()->page_size;
+    if (page_size == 0) {
+        page_size = cfg->block_size;
+    }
+    len = ITS_UTILS_MIN(((len + page_size - 1) / page_size) * page_size,
+                        cfg->block_size);
+
+    addr = get_phys_address(cfg, block_id, 0);
+    while (offset < len) {
+        ret = flash_dev->driver->ProgramData(addr + offset, buf + offset,
+                                             (len - offset) / data_width);
+        if (ret < 0) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
 
-        /* Clear the write buffer */
-        (void)memset(flash_dev->write_buf_0, 0, flash_dev->buf_size);
+        /* A driver which does not return the number of data items programmed
+         * has programmed all of them, or completes it asynchronously.
+         */
+        if (ret == ARM_DRIVER_OK) {
+            return its_flash_wait_ready(flash_dev->driver);
+        }
+
+        offset += (size_t)ret * data_width;
+    }
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_flash_nand_flush(
+                                    const struct its_flash_fs_config_t *cfg,
+                                    uint32_t block_id)
+{
+    psa_status_t err;
+    struct its_flash_nand_dev_t *flash_dev =
+        (struct its_flash_nand_dev_t *)cfg->flash_dev;
+
+    if (block_id == flash_dev->buf_block_id_0) {
+        /* Flush the buffered write data to flash */
+        err = its_flash_nand_program(cfg, block_id, flash_dev->write_buf_0,
+                                     flash_dev->buf_len_0);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        /* Clear the write buffer, which is only written up to buf_len_0 */
+        (void)memset(flash_dev->write_buf_0, 0, flash_dev->buf_len_0);
+        flash_dev->buf_len_0 = 0;
         flash_dev->buf_block_id_0 = ITS_BLOCK_INVALID_ID;
     } else if (block_id == flash_dev->buf_block_id_1) {
-        addr = get_phys_address(cfg, flash_dev->buf_block_id_1, 0);
-
-        /* Flush the buffered write data to flash*/
-        err = flash_dev->driver->ProgramData(addr, flash_dev->write_buf_1,
-                                             cfg->block_size / data_width);
-        if (err < 0) {
-            return PSA_ERROR_STORAGE_FAILURE;
+        /* Flush the buffered write data to flash */
+        err = its_flash_nand_program(cfg, block_id, flash_dev->write_buf_1,
+                                     flash_dev->buf_len_1);
+        if (err != PSA_SUCCESS) {
+            return err;
         }
 
-        /* Clear the write buffer */
-        (void)memset(flash_dev->write_buf_1, 0, flash_dev->buf_size);
+        /* Clear the write buffer, which is only written up to buf_len_1 */
+        (void)memset(flash_dev->write_buf_1, 0, flash_dev->buf_len_1);
+        flash_dev->buf_len_1 = 0;
         flash_dev->buf_block_id_1 = ITS_BLOCK_INVALID_ID;
     } else {
         return PSA_ERROR_GENERIC_ERROR;
@@ -234,6 +294,10 @@ static psa_status_t its_flash_nand_erase(const struct its_flash_fs_config_t *cfg
         if (err != ARM_DRIVER_OK) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
+
+        if (its_flash_wait_ready(flash_dev->driver) != PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
     }
 
     return PSA_SUCCESS;
@@ -33,6 +33,11 @@ struct its_flash_nand_dev_t {
     uint32_t buf_block_id_1;
     uint8_t *write_buf_0;
     uint8_t *write_buf_1;
+    /* End of the data written to each buffer, so that only the pages holding
+     * data are programmed on flush.
+     */
+    size_t buf_len_0;
+    size_t buf_len_1;
     size_t buf_size;
 };
 
@@ -7,6 +7,7 @@
  */
 #include <string.h>
 #include "its_flash_nor.h"
+#include "its_flash.h"
 
 #include "flash_fs/its_flash_fs.h"
 #include "driver/Driver_Flash.h"
@@ -134,6 +135,18 @@ static psa_status_t its_flash_nor_read(const struct its_flash_fs_config_t *cfg,
     return flash_read_unaligned(cfg, addr, buff, size);
 }
 
+static psa_status_t its_flash_nor_map(const struct its_flash_fs_config_t *cfg,
+                                      uint32_t block_id, const uint8_t **buff,
+                                      size_t offset, size_t size)
+{
+    uint32_t addr = get_phys_address(cfg, block_id, offset);
+
+    (void)size;
+    *buff = (const uint8_t *)(cfg->flash_map_addr + addr);
+
+    return PSA_SUCCESS;
+}
+
 static psa_status_t its_flash_nor_write(const struct its_flash_fs_config_t *cfg,
                                         uint32_t block_id, const uint8_t *buff,
                                         size_t offset, size_t size)
@@ -155,7 +168,7 @@ static psa_status_t its_flash_nor_write(const struct its_flash_fs_config_t *cfg,
         return PSA_ERROR_STORAGE_FAILURE;
     }
 
-    return PSA_SUCCESS;
+    return its_flash_wait_ready((ARM_DRIVER_FLASH *)cfg->flash_dev);
 }
 
 static psa_status_t its_flash_nor_flush(const struct its_flash_fs_config_t *cfg,
@@ -183,6 +196,11 @@ static psa_status_t its_flash_nor_erase(const struct its_flash_fs_config_t *cfg,
         if (err != ARM_DRIVER_OK) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
+
+        if (its_flash_wait_ready((ARM_DRIVER_FLASH *)cfg->flash_dev) !=
+            PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
     }
 
     return PSA_SUCCESS;
@@ -195,3 +213,12 @@ const struct its_flash_fs_ops_t its_flash_fs_ops_nor = {
     .flush = its_flash_nor_flush,
     .erase = its_flash_nor_erase,
 };
+
+const struct its_flash_fs_ops_t its_flash_fs_ops_nor_mapped = {
+    .init = its_flash_nor_init,
+    .read = its_flash_nor_read,
+    .write = its_flash_nor_write,
+    .flush = its_flash_nor_flush,
+    .erase = its_flash_nor_erase,
+    .map = its_flash_nor_map,
+};
@@ -21,6 +21,12 @@ extern "C" {
 
 extern const struct its_flash_fs_ops_t its_flash_fs_ops_nor;
 
+/**
+ * \brief Flash FS operations for NOR flash which is memory mapped for reads, at
+ *        the flash_map_addr of the filesystem configuration.
+ */
+extern const struct its_flash_fs_ops_t its_flash_fs_ops_nor_mapped;
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,18 @@ static psa_status_t its_flash_ram_read(const struct its_flash_fs_config_t *cfg,
     return PSA_SUCCESS;
 }
 
+static psa_status_t its_flash_ram_map(const struct its_flash_fs_config_t *cfg,
+                                      uint32_t block_id, const uint8_t **buff,
+                                      size_t offset, size_t size)
+{
+    uint32_t idx = get_phys_address(cfg, block_id, offset);
+
+    (void)size;
+    *buff = (const uint8_t *)cfg->flash_dev + idx;
+
+    return PSA_SUCCESS;
+}
+
 static psa_status_t its_flash_ram_write(const struct its_flash_fs_config_t *cfg,
                                         uint32_t block_id, const uint8_t *buff,
                                         size_t offset, size_t size)
@@ -82,4 +94,5 @@ const struct its_flash_fs_ops_t its_flash_fs_ops_ram = {
     .write = its_flash_ram_write,
     .flush = its_flash_ram_flush,
     .erase = its_flash_ram_erase,
+    .map = its_flash_ram_map,
 };
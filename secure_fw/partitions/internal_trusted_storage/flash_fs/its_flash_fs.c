@@ -15,14 +15,76 @@
 #include "its_flash_fs_dblock.h"
 #include "its_utils.h"
 
-/* Filesystem-internal flags, which cannot be passed by the caller */
-#define ITS_FLASH_FS_INTERNAL_FLAGS_MASK  (UINT32_MAX - ((1U << 24) - 1))
-/* Flag that indicates the file is to be deleted in the next block update */
-#define ITS_FLASH_FS_FLAG_DELETE          (1U << 24)
-
 static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
                                             uint32_t del_file_idx);
 
+#if ITS_DEFERRED_COMPACTION
+/**
+ * \brief Updates the metadata of a file, leaving its data untouched.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     idx        File's index in the metadata table
+ * \param[in]     file_meta  New file metadata
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_update_file_meta(
+                                        struct its_flash_fs_ctx_t *fs_ctx,
+                                        uint32_t idx,
+                                        const struct its_file_meta_t *file_meta)
+{
+    struct its_block_meta_t block_meta;
+    psa_status_t err;
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, file_meta->lblock,
+                                                  &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+#if ITS_METADATA_LOG_RECORDS
+    err = its_flash_fs_mblock_log_update(fs_ctx, idx, file_meta,
+                                         file_meta->lblock, &block_meta);
+    if (err != PSA_ERROR_INSUFFICIENT_STORAGE) {
+        return err;
+    }
+#endif
+
+    err = its_flash_fs_mblock_update_scratch_block_meta(fs_ctx,
+                                                        file_meta->lblock,
+                                                        &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, idx, file_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_cp_file_meta(fs_ctx, 0, idx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_cp_file_meta(fs_ctx, idx + 1,
+                                           fs_ctx->cfg->max_num_files);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* The file data in the logical block 0 is left untouched, so it has to be
+     * copied to the scratch metadata block.
+     */
+    err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+#endif /* ITS_DEFERRED_COMPACTION */
+
 static psa_status_t its_flash_fs_file_write_aligned_data(
                                       struct its_flash_fs_ctx_t *fs_ctx,
                                       const struct its_block_meta_t *block_meta,
@@ -56,6 +118,45 @@ static psa_status_t its_flash_fs_file_write_aligned_data(
                                           size, data);
 }
 
+#if ITS_INLINE_FILE_SIZE
+/**
+ * \brief Writes data of an inline file in its file metadata.
+ *
+ * \param[in,out] file_meta  File metadata
+ * \param[in]     offset     Offset in the file
+ * \param[in]     size       Size of the data
+ * \param[in]     data       Data to write
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_file_write_inline_data(
+                                              struct its_file_meta_t *file_meta,
+                                              size_t offset,
+                                              size_t size,
+                                              const uint8_t *data)
+{
+    /* It is not permitted to create gaps in the file */
+    if (offset > file_meta->cur_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Check that the new data is contained within the file's max size */
+    if (its_utils_check_contained_in(file_meta->max_size, offset, size)
+        != PSA_SUCCESS) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    memcpy(file_meta->inline_data + offset, data, size);
+
+    /* Update the file's current size if required */
+    if (offset + size > file_meta->cur_size) {
+        file_meta->cur_size = offset + size;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_INLINE_FILE_SIZE */
+
 /* TODO This is very similar to (static) its_num_active_dblocks() */
 static uint32_t its_flash_fs_num_active_dblocks(
                                         const struct its_flash_fs_config_t *cfg)
@@ -84,7 +185,8 @@ static size_t its_flash_fs_all_metadata_size(
     return sizeof(struct its_metadata_block_header_t)
            + (its_flash_fs_num_active_dblocks(cfg)
               * sizeof(struct its_block_meta_t))
-           + (cfg->max_num_files * sizeof(struct its_file_meta_t));
+           + (cfg->max_num_files * sizeof(struct its_file_meta_t))
+           + ITS_METADATA_LOG_SIZE;
 }
 
 /**
@@ -161,6 +263,15 @@ psa_status_t its_flash_fs_init_ctx(its_flash_fs_ctx_t *fs_ctx,
     fs_ctx->cfg = fs_cfg;
     fs_ctx->ops = fs_ops;
 
+#if ITS_RAM_FILE_INDEX
+    if (!fs_cfg->file_index) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    fs_ctx->file_tags = fs_cfg->file_index;
+    fs_ctx->scratch_file_tags = fs_cfg->file_index + fs_cfg->max_num_files;
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -175,14 +286,21 @@ psa_status_t its_flash_fs_prepare(its_flash_fs_ctx_t *fs_ctx)
         return err;
     }
 
-    /* Check if a file marked for deletion has been left behind by a power
-     * failure. If so, delete it.
+    /* Check if files marked for deletion, or staged files of a transaction
+     * that was never committed, have been left behind by a power failure. If
+     * so, delete them.
      */
-    err = its_flash_fs_mblock_get_file_idx_flag(fs_ctx,
-                                                ITS_FLASH_FS_FLAG_DELETE, &idx);
-    if (err == PSA_SUCCESS) {
-        return its_flash_fs_delete_idx(fs_ctx, idx);
-    } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
+    do {
+        err = its_flash_fs_mblock_get_file_idx_flag(fs_ctx,
+                                                    ITS_FLASH_FS_FLAG_DELETE |
+                                                    ITS_FLASH_FS_FLAG_STAGED,
+                                                    &idx);
+        if (err == PSA_SUCCESS) {
+            err = its_flash_fs_delete_idx(fs_ctx, idx);
+        }
+    } while (err == PSA_SUCCESS);
+
+    if (err != PSA_ERROR_DOES_NOT_EXIST) {
         return err;
     }
 
@@ -220,21 +338,80 @@ psa_status_t its_flash_fs_file_get_info(struct its_flash_fs_ctx_t *fs_ctx,
     return PSA_SUCCESS;
 }
 
-psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
-                                     const uint8_t *fid,
-                                     struct its_flash_fs_file_info_t *finfo,
-                                     size_t data_size,
-                                     size_t offset,
-                                     const uint8_t *data)
+#if ITS_WEAR_LEVELLING
+/**
+ * \brief Moves the data of the dedicated data block held by the least worn
+ *        physical block to the data scratch block, once the data scratch block
+ *        has been erased ITS_WEAR_LEVELLING_THRESHOLD more times than it. The
+ *        least worn block, which holds data that is rarely rewritten, then
+ *        takes its turn as data scratch block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_wear_level(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_block_meta_t block_meta;
+    psa_status_t err;
+    uint32_t lblock;
+
+    err = its_flash_fs_mblock_get_cold_block(fs_ctx, &lblock);
+    if (err != PSA_SUCCESS) {
+        return (err == PSA_ERROR_DOES_NOT_EXIST) ? PSA_SUCCESS : err;
+    }
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock, &block_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Copy the whole content of the block, leaving its layout unchanged */
+    err = its_flash_fs_dblock_compact_block(fs_ctx, lblock, 0,
+                                            block_meta.data_start,
+                                            block_meta.data_start,
+                                            fs_ctx->cfg->block_size
+                                            - block_meta.free_size
+                                            - block_meta.data_start);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_flash_fs_mblock_cp_file_meta(fs_ctx, 0,
+                                           fs_ctx->cfg->max_num_files);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+#endif /* ITS_WEAR_LEVELLING */
+
+static psa_status_t its_flash_fs_write_file(
+                                        struct its_flash_fs_ctx_t *fs_ctx,
+                                        const uint8_t *fid,
+                                        struct its_flash_fs_file_info_t *finfo,
+                                        size_t data_size,
+                                        size_t offset,
+                                        const uint8_t *data)
 {
     struct its_block_meta_t block_meta;
     struct its_file_meta_t file_meta = {0};
+    struct its_file_meta_t old_file_meta;
     uint32_t cur_phys_block;
     psa_status_t err;
     uint32_t idx;
     uint32_t old_idx = ITS_METADATA_INVALID_INDEX;
     uint32_t new_idx = ITS_METADATA_INVALID_INDEX;
     bool use_spare;
+    bool delete_old = false;
+    bool dblock_written = false;
+    size_t data_max_size;
 
     if (finfo == NULL) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -250,8 +427,18 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
     finfo->size_max = ITS_UTILS_ALIGN(finfo->size_max, fs_ctx->cfg->program_unit);
 #endif
 
-    /* Check if the file already exists */
-    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &old_idx, &file_meta);
+    /* Check if the file already exists. A staged write only looks for the
+     * staged copy of the file, as the committed file is replaced at commit
+     * time.
+     */
+    if (finfo->flags & ITS_FLASH_FS_FLAG_STAGED) {
+        err = its_flash_fs_mblock_get_staged_file_idx_meta(fs_ctx, fid,
+                                                           &old_idx,
+                                                           &file_meta);
+    } else {
+        err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &old_idx,
+                                                    &file_meta);
+    }
     if (err == PSA_SUCCESS) {
         if (finfo->flags & ITS_FLASH_FS_FLAG_TRUNCATE) {
             if (file_meta.max_size == finfo->size_max) {
@@ -259,21 +446,14 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
                  * correct size.
                  */
                 file_meta.cur_size = 0;
-                file_meta.flags = finfo->flags;
+                file_meta.flags = finfo->flags |
+                                  (file_meta.flags & ITS_FLASH_FS_FLAG_INLINE);
                 new_idx = old_idx;
             } else {
-                /* Mark the existing file to be deleted in this block update. It
-                 * will be deleted in a second block update, and if there is a
-                 * power failure before that block update completes, then
-                 * deletion will be re-attempted based on this flag.
+                /* The existing file is marked to be deleted in this block
+                 * update, once the new file has been reserved.
                  */
-                file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
-                err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx,
-                                                                   old_idx,
-                                                                   &file_meta);
-                if (err != PSA_SUCCESS) {
-                    return PSA_ERROR_GENERIC_ERROR;
-                }
+                delete_old = true;
             }
         } else {
             /* Write to existing file */
@@ -295,16 +475,73 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
             return PSA_ERROR_INVALID_ARGUMENT;
         }
 
-        /* Only use the spare file if there is an old file to be deleted */
+        /* Only use the spare file if there is an old file to be deleted. The
+         * first staged copy of a file replaces the committed file at commit
+         * time.
+         */
         use_spare = (old_idx != ITS_METADATA_INVALID_INDEX);
+        if (!use_spare && (finfo->flags & ITS_FLASH_FS_FLAG_STAGED)) {
+            use_spare = (its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid,
+                                                               &idx, NULL)
+                         == PSA_SUCCESS);
+        }
+
+        /* Small files are stored in their metadata, and take no space in the
+         * data blocks.
+         */
+        data_max_size = finfo->size_max;
+#if ITS_INLINE_FILE_SIZE
+        if (finfo->size_max <= ITS_INLINE_FILE_SIZE) {
+            data_max_size = 0;
+        }
+#endif
 
         /* Try to reserve a new file based on the input parameters */
         err = its_flash_fs_mblock_reserve_file(fs_ctx, fid, use_spare,
-                                               finfo->size_max, finfo->flags, &new_idx,
+                                               data_max_size, finfo->flags, &new_idx,
                                                &file_meta, &block_meta);
+#if ITS_DEFERRED_COMPACTION
+        /* Reclaim the space of the files marked for deletion on demand */
+        while ((err == PSA_ERROR_INSUFFICIENT_STORAGE) &&
+               (its_flash_fs_compact(fs_ctx) == PSA_SUCCESS)) {
+            err = its_flash_fs_mblock_reserve_file(fs_ctx, fid, use_spare,
+                                                   data_max_size,
+                                                   finfo->flags, &new_idx,
+                                                   &file_meta, &block_meta);
+        }
+#endif
         if (err != PSA_SUCCESS) {
             return err;
         }
+
+#if ITS_INLINE_FILE_SIZE
+        if (finfo->size_max <= ITS_INLINE_FILE_SIZE) {
+            file_meta.max_size = finfo->size_max;
+            file_meta.flags |= ITS_FLASH_FS_FLAG_INLINE;
+            memset(file_meta.inline_data, 0, sizeof(file_meta.inline_data));
+        }
+#endif
+
+        if (delete_old) {
+            /* Mark the existing file to be deleted in this block update. It
+             * will be deleted in a second block update, and if there is a
+             * power failure before that block update completes, then
+             * deletion will be re-attempted based on this flag.
+             */
+            err = its_flash_fs_mblock_read_file_meta(fs_ctx, old_idx,
+                                                     &old_file_meta);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+
+            old_file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
+            err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx,
+                                                               old_idx,
+                                                               &old_file_meta);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
     } else {
         /* Read existing block metadata */
         err = its_flash_fs_mblock_read_block_metadata(fs_ctx, file_meta.lblock,
@@ -314,7 +551,19 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         }
     }
 
+#if ITS_INLINE_FILE_SIZE
+    if (file_meta.flags & ITS_FLASH_FS_FLAG_INLINE) {
+        /* Only the file metadata is written */
+        err = its_flash_fs_file_write_inline_data(&file_meta, offset,
+                                                  data_size, data);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    } else
+#endif
     if (data_size != 0) {
+        dblock_written = true;
+
         /* Write the content into scratch data block */
         err = its_flash_fs_file_write_aligned_data(fs_ctx, &block_meta,
                                                    &file_meta, offset,
@@ -338,8 +587,32 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         /* Swap the scratch data block */
         its_flash_fs_mblock_set_data_scratch(fs_ctx, cur_phys_block,
                                              file_meta.lblock);
+#if ITS_WEAR_LEVELLING
+        its_flash_fs_mblock_swap_erase_count(fs_ctx, &block_meta,
+                                             file_meta.lblock);
+#endif
     }
 
+#ifdef ITS_ENCRYPTION
+    memcpy(file_meta.nonce, finfo->nonce, sizeof(finfo->nonce));
+    memcpy(file_meta.tag, finfo->tag, sizeof(finfo->tag));
+#endif
+
+#if ITS_METADATA_LOG_RECORDS
+    /* When a single file metadata entry changes and the file data in the
+     * logical block 0 is left untouched, the update is logged in the active
+     * metadata block instead of swapping the metadata blocks.
+     */
+    if (((old_idx == ITS_METADATA_INVALID_INDEX) || (old_idx == new_idx)) &&
+        ((file_meta.lblock != ITS_LOGICAL_DBLOCK0) || !dblock_written)) {
+        err = its_flash_fs_mblock_log_update(fs_ctx, new_idx, &file_meta,
+                                             file_meta.lblock, &block_meta);
+        if (err != PSA_ERROR_INSUFFICIENT_STORAGE) {
+            return err;
+        }
+    }
+#endif
+
     /* Update block metadata in scratch metadata block */
     err = its_flash_fs_mblock_update_scratch_block_meta(fs_ctx,
                                                         file_meta.lblock,
@@ -348,11 +621,6 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         return PSA_ERROR_GENERIC_ERROR;
     }
 
-#ifdef ITS_ENCRYPTION
-    memcpy(file_meta.nonce, finfo->nonce, sizeof(finfo->nonce));
-    memcpy(file_meta.tag, finfo->tag, sizeof(finfo->tag));
-#endif
-
     /* Write file metadata in the scratch metadata block */
     err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, new_idx,
                                                        &file_meta);
@@ -395,7 +663,7 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
      * located in the logical block 0, that copy has been done while processing
      * the file data.
      */
-    if ((file_meta.lblock != ITS_LOGICAL_DBLOCK0) || (data_size == 0)) {
+    if ((file_meta.lblock != ITS_LOGICAL_DBLOCK0) || !dblock_written) {
         err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
@@ -408,6 +676,7 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         return err;
     }
 
+#if !ITS_DEFERRED_COMPACTION
     /* Delete the old file in a second block update.
      * Note: A power failure after this point, but before the deletion has
      * completed, will leave the old file in the filesystem, so it is always
@@ -416,6 +685,31 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
     if (old_idx != ITS_METADATA_INVALID_INDEX && old_idx != new_idx) {
         err = its_flash_fs_delete_idx(fs_ctx, old_idx);
     }
+#endif
+
+    return err;
+}
+
+psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *fid,
+                                     struct its_flash_fs_file_info_t *finfo,
+                                     size_t data_size,
+                                     size_t offset,
+                                     const uint8_t *data)
+{
+    psa_status_t err;
+
+    err = its_flash_fs_write_file(fs_ctx, fid, finfo, data_size, offset, data);
+#if ITS_FLASH_STATS
+    if (err == PSA_SUCCESS) {
+        fs_ctx->stats.logical_bytes += data_size;
+    }
+#endif
+#if ITS_WEAR_LEVELLING
+    if (err == PSA_SUCCESS) {
+        err = its_flash_fs_wear_level(fs_ctx);
+    }
+#endif
 
     return err;
 }
@@ -442,10 +736,12 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
         return PSA_ERROR_DOES_NOT_EXIST;
     }
 
-    /* Save logical block, data_index and max_size to be used later on */
+    /* Save logical block, data_index and the size of the data in the data
+     * block to be used later on.
+     */
     del_file_lblock = file_meta.lblock;
     del_file_data_idx = file_meta.data_idx;
-    del_file_max_size = file_meta.max_size;
+    del_file_max_size = ITS_FILE_DATA_SIZE(&file_meta);
 
     /* Remove file metadata */
     file_meta = (struct its_file_meta_t){0};
@@ -492,7 +788,7 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
                 file_meta.data_idx -= del_file_max_size;
 
                 /* Increase number of bytes to move */
-                nbr_bytes_to_move += file_meta.max_size;
+                nbr_bytes_to_move += ITS_FILE_DATA_SIZE(&file_meta);
             }
         }
         /* Update file metadata in to the scratch block */
@@ -551,19 +847,224 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
     return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
 }
 
-psa_status_t its_flash_fs_file_delete(struct its_flash_fs_ctx_t *fs_ctx,
-                                      const uint8_t *fid)
+/**
+ * \brief Deletes the committed file or the staged copy of the file referenced
+ *        by the file ID.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     File ID
+ * \param[in]     staged  Whether to delete the staged copy of the file
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_delete_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                             const uint8_t *fid,
+                                             bool staged)
 {
     psa_status_t err;
     uint32_t del_file_idx;
+    struct its_file_meta_t file_meta;
 
-    /* Get the file index. */
-    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &del_file_idx, NULL);
+    /* Get the file index and meta data */
+    if (staged) {
+        err = its_flash_fs_mblock_get_staged_file_idx_meta(fs_ctx, fid,
+                                                           &del_file_idx,
+                                                           &file_meta);
+    } else {
+        err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &del_file_idx,
+                                                    &file_meta);
+    }
     if (err != PSA_SUCCESS) {
         return PSA_ERROR_DOES_NOT_EXIST;
     }
 
+#if ITS_DEFERRED_COMPACTION
+    /* Only mark the file for deletion, its space is reclaimed later by
+     * its_flash_fs_compact().
+     */
+    file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
+    return its_flash_fs_update_file_meta(fs_ctx, del_file_idx, &file_meta);
+#else
     return its_flash_fs_delete_idx(fs_ctx, del_file_idx);
+#endif
+}
+
+psa_status_t its_flash_fs_file_delete(struct its_flash_fs_ctx_t *fs_ctx,
+                                      const uint8_t *fid)
+{
+    return its_flash_fs_delete_file(fs_ctx, fid, false);
+}
+
+psa_status_t its_flash_fs_file_delete_staged(struct its_flash_fs_ctx_t *fs_ctx,
+                                             const uint8_t *fid)
+{
+    return its_flash_fs_delete_file(fs_ctx, fid, true);
+}
+
+psa_status_t its_flash_fs_compact(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+    uint32_t idx;
+
+    err = its_flash_fs_mblock_get_file_idx_flag(fs_ctx,
+                                                ITS_FLASH_FS_FLAG_DELETE, &idx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return its_flash_fs_delete_idx(fs_ctx, idx);
+}
+
+/**
+ * \brief Checks whether a committed file is replaced or deleted when the
+ *        staged files are committed.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     fid          File ID of the committed file
+ * \param[in]     remove_fids  Array of num_remove file IDs to delete
+ * \param[in]     num_remove   Number of file IDs in remove_fids
+ *
+ * \return Returns true if the file is replaced or deleted, false otherwise
+ */
+static bool its_flash_fs_is_superseded(struct its_flash_fs_ctx_t *fs_ctx,
+                                       const uint8_t *fid,
+                                       const uint8_t *remove_fids,
+                                       uint32_t num_remove)
+{
+    uint32_t i;
+    uint32_t idx;
+
+    for (i = 0; i < num_remove; i++) {
+        if (!memcmp(remove_fids + (i * ITS_FILE_ID_SIZE), fid,
+                    ITS_FILE_ID_SIZE)) {
+            return true;
+        }
+    }
+
+    return (its_flash_fs_mblock_get_staged_file_idx_meta(fs_ctx, fid, &idx,
+                                                         NULL)
+            == PSA_SUCCESS);
+}
+
+/**
+ * \brief Commits or discards all staged files in a single metadata block
+ *        update.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     commit       Whether to commit or discard the staged files
+ * \param[in]     remove_fids  Array of num_remove file IDs to delete on commit
+ * \param[in]     num_remove   Number of file IDs in remove_fids
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_update_staged(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             bool commit,
+                                             const uint8_t *remove_fids,
+                                             uint32_t num_remove)
+{
+    psa_status_t err;
+    uint32_t idx;
+    struct its_file_meta_t file_meta;
+    struct its_block_meta_t block_meta;
+
+    /* Avoid a metadata block update when there is nothing to do */
+    err = its_flash_fs_mblock_get_file_idx_flag(fs_ctx,
+                                                ITS_FLASH_FS_FLAG_STAGED, &idx);
+    if (err == PSA_ERROR_DOES_NOT_EXIST && (!commit || num_remove == 0)) {
+        return PSA_SUCCESS;
+    } else if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+
+    /* Every file metadata entry is rewritten in the scratch metadata block, so
+     * the whole batch becomes visible with a single swap. The replaced and
+     * removed files are only marked for deletion here.
+     */
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if ((its_utils_validate_fid(file_meta.id) == PSA_SUCCESS) &&
+            !(file_meta.flags & ITS_FLASH_FS_FLAG_DELETE)) {
+            if (file_meta.flags & ITS_FLASH_FS_FLAG_STAGED) {
+                if (commit) {
+                    file_meta.flags &= ~ITS_FLASH_FS_FLAG_STAGED;
+                } else {
+                    file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
+                }
+            } else if (commit &&
+                       its_flash_fs_is_superseded(fs_ctx, file_meta.id,
+                                                  remove_fids, num_remove)) {
+                file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
+            }
+        }
+
+        err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, idx,
+                                                           &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* The file data is left untouched, so the block metadata and the file
+     * data in the logical block 0 are copied to the scratch metadata block.
+     */
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, ITS_LOGICAL_DBLOCK0,
+                                                  &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_update_scratch_block_meta(fs_ctx,
+                                                        ITS_LOGICAL_DBLOCK0,
+                                                        &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+#if !ITS_DEFERRED_COMPACTION
+    /* Delete the marked files, each in a further block update. A power failure
+     * before they are all deleted is recovered at initialisation time.
+     */
+    do {
+        err = its_flash_fs_compact(fs_ctx);
+    } while (err == PSA_SUCCESS);
+
+    if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+#endif
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_commit_staged(struct its_flash_fs_ctx_t *fs_ctx,
+                                        const uint8_t *remove_fids,
+                                        uint32_t num_remove)
+{
+    if ((remove_fids == NULL) && (num_remove != 0)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return its_flash_fs_update_staged(fs_ctx, true, remove_fids, num_remove);
+}
+
+psa_status_t its_flash_fs_discard_staged(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return its_flash_fs_update_staged(fs_ctx, false, NULL, 0);
 }
 
 psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
@@ -588,6 +1089,13 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
         return err;
     }
 
+#if ITS_INLINE_FILE_SIZE
+    if (tmp_metadata.flags & ITS_FLASH_FS_FLAG_INLINE) {
+        memcpy(data, tmp_metadata.inline_data + offset, size);
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Read the file from flash */
     err = its_flash_fs_dblock_read_file(fs_ctx, &tmp_metadata, offset, size,
                                         data);
@@ -597,3 +1105,75 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
 
     return PSA_SUCCESS;
 }
+
+psa_status_t its_flash_fs_file_map(struct its_flash_fs_ctx_t *fs_ctx,
+                                   const uint8_t *fid,
+                                   size_t size,
+                                   size_t offset,
+                                   const uint8_t **data)
+{
+    psa_status_t err;
+    uint32_t idx;
+    struct its_file_meta_t tmp_metadata;
+
+    if (fs_ctx->ops->map == NULL) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    /* Get the file index and meta data */
+    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &idx, &tmp_metadata);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    /* Boundary check the incoming request */
+    err = its_utils_check_contained_in(tmp_metadata.cur_size, offset, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+#if ITS_INLINE_FILE_SIZE
+    /* The data of an inline file is read with its metadata */
+    if (tmp_metadata.flags & ITS_FLASH_FS_FLAG_INLINE) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+    err = its_flash_fs_dblock_map_file(fs_ctx, &tmp_metadata, offset, size,
+                                       data);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_get_erase_count(struct its_flash_fs_ctx_t *fs_ctx,
+                                          uint32_t block_id,
+                                          uint32_t *erase_count)
+{
+#if ITS_WEAR_LEVELLING
+    return its_flash_fs_mblock_get_erase_count(fs_ctx, block_id, erase_count);
+#else
+    (void)fs_ctx;
+    (void)block_id;
+    (void)erase_count;
+
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+psa_status_t its_flash_fs_get_stats(struct its_flash_fs_ctx_t *fs_ctx,
+                                    struct its_flash_fs_stats_t *stats)
+{
+#if ITS_FLASH_STATS
+    *stats = fs_ctx->stats;
+
+    return PSA_SUCCESS;
+#else
+    (void)fs_ctx;
+    (void)stats;
+
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
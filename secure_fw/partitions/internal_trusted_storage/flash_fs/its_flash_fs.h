@@ -20,6 +20,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "config_tfm.h"
 #include "its_flash_fs_mblock.h"
 #include "psa/error.h"
 
@@ -38,10 +39,24 @@ extern "C" {
 #define ITS_FLASH_FS_FLAG_CREATE       (1UL << 16)
 /* Remove existing file data if it exists */
 #define ITS_FLASH_FS_FLAG_TRUNCATE     (1UL << 17)
+/* Write a staged copy of the file, which stays invisible to lookups and
+ * replaces the file when the staged files are committed
+ */
+#define ITS_FLASH_FS_FLAG_STAGED       (1UL << 18)
+
+/* Filesystem-internal flags, which cannot be passed by the caller */
+#define ITS_FLASH_FS_INTERNAL_FLAGS_MASK  (UINT32_MAX - ((1U << 24) - 1))
+/* Flag that indicates the file is to be deleted in the next block update */
+#define ITS_FLASH_FS_FLAG_DELETE          (1U << 24)
+/* Flag that indicates the file data is stored in the file metadata */
+#define ITS_FLASH_FS_FLAG_INLINE          (1U << 25)
 
 /* Invalid block index */
 #define ITS_BLOCK_INVALID_ID 0xFFFFFFFFU
 
+/* Size of the RAM file index buffer for the given maximum number of files */
+#define ITS_FLASH_FS_FILE_INDEX_SIZE(max_num_files) (2 * (max_num_files))
+
 /**
  * \struct its_flash_fs_config_t
  *
@@ -50,6 +65,9 @@ extern "C" {
 struct its_flash_fs_config_t {
     const void *flash_dev;    /**< Pointer to the flash device */
     uint32_t flash_area_addr; /**< Base address of the flash region */
+    uintptr_t flash_map_addr; /**< Address at which the flash device is
+                               *   memory mapped, for devices read in place
+                               */
     uint32_t sector_size;     /**< Size of the flash device's physical erase
                                *   unit
                                */
@@ -61,6 +79,12 @@ struct its_flash_fs_config_t {
     uint16_t max_file_size;   /**< Maximum file size */
     uint16_t max_num_files;   /**< Maximum number of files */
     uint8_t erase_val;        /**< Value of a byte after erase (usually 0xFF) */
+#if ITS_RAM_FILE_INDEX
+    uint8_t *file_index;      /**< RAM buffer of
+                               *   ITS_FLASH_FS_FILE_INDEX_SIZE(max_num_files)
+                               *   bytes to hold the file index
+                               */
+#endif
 };
 
 /**
@@ -153,6 +177,28 @@ struct its_flash_fs_ops_t {
      */
     psa_status_t (*erase)(const struct its_flash_fs_config_t *cfg,
                           uint32_t block_id);
+
+    /**
+     * \brief Gets a pointer to block data at the position specified by block
+     *        ID and offset, for flash devices that are directly addressable.
+     *        Optional, may be NULL.
+     *
+     * \param[in]  cfg       Filesystem configuration
+     * \param[in]  block_id  Block ID
+     * \param[out] buf       Pointer to the block data
+     * \param[in]  offset    Offset position from the init of the block
+     * \param[in]  size      Number of bytes to be accessed
+     *
+     * \note This function assumes all input values are valid. That is, the
+     *       address range, based on block_id, offset and size, is a valid range
+     *       in flash.
+     *
+     * \return Returns PSA_SUCCESS if the function is executed correctly.
+     *         Otherwise, it returns PSA_ERROR_STORAGE_FAILURE.
+     */
+    psa_status_t (*map)(const struct its_flash_fs_config_t *cfg,
+                        uint32_t block_id, const uint8_t **buf, size_t offset,
+                        size_t size);
 };
 
 /**
@@ -166,6 +212,8 @@ struct its_flash_fs_ops_t {
  */
 typedef struct its_flash_fs_ctx_t its_flash_fs_ctx_t;
 
+struct its_flash_fs_stats_t;
+
 /*!
  * \struct its_flash_fs_file_info_t
  *
@@ -275,6 +323,28 @@ psa_status_t its_flash_fs_file_read(its_flash_fs_ctx_t *fs_ctx,
                                     size_t offset,
                                     uint8_t *data);
 
+/**
+ * \brief Gets a pointer to the data of an existing file, when the flash
+ *        device is directly addressable, so that it can be accessed without
+ *        copying it.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     File ID
+ * \param[in]     size    Size to be accessed
+ * \param[in]     offset  Offset in the file
+ * \param[out]    data    Pointer to the file data. It is only valid until the
+ *                        next filesystem operation that modifies the flash.
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the flash device is not directly
+ *         addressable. Otherwise, returns error code as specified in
+ *         \ref psa_status_t
+ */
+psa_status_t its_flash_fs_file_map(its_flash_fs_ctx_t *fs_ctx,
+                                   const uint8_t *fid,
+                                   size_t size,
+                                   size_t offset,
+                                   const uint8_t **data);
+
 /**
  * \brief Deletes file referenced by the file ID.
  *
@@ -286,6 +356,95 @@ psa_status_t its_flash_fs_file_read(its_flash_fs_ctx_t *fs_ctx,
 psa_status_t its_flash_fs_file_delete(its_flash_fs_ctx_t *fs_ctx,
                                       const uint8_t *fid);
 
+/**
+ * \brief Reclaims the space of one file marked for deletion, compacting the
+ *        data block which holds it.
+ *
+ * \details When ITS_DEFERRED_COMPACTION is enabled, deleting or replacing a
+ *          file only marks it for deletion, and this function must be called
+ *          to reclaim the space. Each call does a bounded amount of work.
+ *          The filesystem also calls it when a write does not find enough
+ *          free space.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns PSA_SUCCESS if a file has been deleted,
+ *         PSA_ERROR_DOES_NOT_EXIST if no file is marked for deletion.
+ *         Otherwise, returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_compact(its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Deletes the staged copy of the file referenced by the file ID.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     File ID
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_file_delete_staged(its_flash_fs_ctx_t *fs_ctx,
+                                             const uint8_t *fid);
+
+/**
+ * \brief Atomically publishes all staged files and deletes the given files, in
+ *        a single metadata block update.
+ *
+ * \details Each staged file replaces the file with the same file ID, if any.
+ *          Either all the changes are visible after a power failure, or none
+ *          of them.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     remove_fids  Array of num_remove file IDs to delete
+ * \param[in]     num_remove   Number of file IDs in remove_fids
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_commit_staged(its_flash_fs_ctx_t *fs_ctx,
+                                        const uint8_t *remove_fids,
+                                        uint32_t num_remove);
+
+/**
+ * \brief Discards all staged files, leaving the committed files untouched.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_discard_staged(its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Gets the number of times a physical data block has been erased since
+ *        the filesystem was wiped, when ITS_WEAR_LEVELLING is enabled.
+ *
+ * \note The metadata blocks are erased alternately on every metadata block
+ *       swap, and their erases are not counted.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     block_id     Physical block ID
+ * \param[out]    erase_count  Number of times the block has been erased
+ *
+ * \return Returns PSA_ERROR_INVALID_ARGUMENT if the block does not exist,
+ *         PSA_ERROR_NOT_SUPPORTED if the block is a metadata block or the
+ *         erases are not counted. Otherwise, returns error code as specified
+ *         in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_get_erase_count(its_flash_fs_ctx_t *fs_ctx,
+                                          uint32_t block_id,
+                                          uint32_t *erase_count);
+
+/**
+ * \brief Gets the flash operations issued by the filesystem since the context
+ *        was initialised, when ITS_FLASH_STATS is enabled.
+ *
+ * \param[in]  fs_ctx  Filesystem context
+ * \param[out] stats   Flash operation counters
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the operations are not counted.
+ *         Otherwise, returns PSA_SUCCESS
+ */
+psa_status_t its_flash_fs_get_stats(its_flash_fs_ctx_t *fs_ctx,
+                                    struct its_flash_fs_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -90,6 +90,9 @@ psa_status_t its_flash_fs_dblock_compact_block(
      * of finalization.
      */
     its_flash_fs_mblock_set_data_scratch(fs_ctx, block_meta.phy_id, lblock);
+#if ITS_WEAR_LEVELLING
+    its_flash_fs_mblock_swap_erase_count(fs_ctx, &block_meta, lblock);
+#endif
 
     /* Set scratch block ID as the one which contains the new data block */
     block_meta.phy_id = scratch_id;
@@ -100,6 +103,9 @@ psa_status_t its_flash_fs_dblock_compact_block(
     if (err != PSA_SUCCESS) {
         /* Swap back the data block as there was an issue in the process */
         its_flash_fs_mblock_set_data_scratch(fs_ctx, scratch_id, lblock);
+#if ITS_WEAR_LEVELLING
+        its_flash_fs_mblock_swap_erase_count(fs_ctx, &block_meta, lblock);
+#endif
         return err;
     }
 
@@ -131,7 +137,27 @@ psa_status_t its_flash_fs_dblock_read_file(
 
     pos = (file_meta->data_idx + offset);
 
-    return fs_ctx->ops->read(fs_ctx->cfg, phys_block, buf, pos, size);
+    return its_flash_fs_op_read(fs_ctx, phys_block, buf, pos, size);
+}
+
+psa_status_t its_flash_fs_dblock_map_file(
+                                        struct its_flash_fs_ctx_t *fs_ctx,
+                                        const struct its_file_meta_t *file_meta,
+                                        size_t offset,
+                                        size_t size,
+                                        const uint8_t **buf)
+{
+    uint32_t phys_block;
+    size_t pos;
+
+    phys_block = its_dblock_lo_to_phy(fs_ctx, file_meta->lblock);
+    if (phys_block == ITS_BLOCK_INVALID_ID) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    pos = (file_meta->data_idx + offset);
+
+    return fs_ctx->ops->map(fs_ctx->cfg, phys_block, buf, pos, size);
 }
 
 psa_status_t its_flash_fs_dblock_write_file(
@@ -164,7 +190,7 @@ psa_status_t its_flash_fs_dblock_write_file(
     }
 
     /* Write the new file data */
-    err = fs_ctx->ops->write(fs_ctx->cfg, scratch_id, data, pos, size);
+    err = its_flash_fs_op_write(fs_ctx, scratch_id, data, pos, size);
     if (err != PSA_SUCCESS) {
         return err;
     }
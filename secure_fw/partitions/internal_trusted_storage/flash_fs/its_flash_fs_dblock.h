@@ -58,6 +58,25 @@ psa_status_t its_flash_fs_dblock_read_file(
                                         size_t size,
                                         uint8_t *buf);
 
+/**
+ * \brief Gets a pointer to the file content in directly addressable flash.
+ *        The flash operations must provide the map function.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     file_meta  File metadata
+ * \param[in]     offset     Offset in the file
+ * \param[in]     size       Size to be accessed
+ * \param[out]    buf        Pointer to the file content
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_dblock_map_file(
+                                        struct its_flash_fs_ctx_t *fs_ctx,
+                                        const struct its_file_meta_t *file_meta,
+                                        size_t offset,
+                                        size_t size,
+                                        const uint8_t **buf);
+
 /**
  * \brief Writes scratch data block content with requested data and the rest of
  *        the data from the given logical block.
@@ -10,6 +10,7 @@
 #include "config_tfm.h"
 #include "its_flash_fs_mblock.h"
 #include "psa/storage_common.h"
+#include "service_api.h"
 
 #ifndef ITS_MAX_BLOCK_DATA_COPY
 #define ITS_MAX_BLOCK_DATA_COPY 256
@@ -35,6 +36,75 @@
 #define ITS_BLOCK_METADATA_SIZE     sizeof(struct its_block_meta_t)
 #define ITS_FILE_METADATA_SIZE      sizeof(struct its_file_meta_t)
 
+#if ITS_RAM_FILE_INDEX
+/*!
+ * \def ITS_FILE_TAG_FREE
+ *
+ * \brief Tag of a file metadata entry which holds an invalid (free) file ID.
+ */
+#define ITS_FILE_TAG_FREE  0x00U
+
+/**
+ * \brief Calculates the tag of a file ID kept in the RAM file index.
+ *
+ * \details Entries whose tag differs from the tag of a file ID cannot hold
+ *          that file ID, so only the entries with a matching tag need to be
+ *          read from flash.
+ *
+ * \param[in] fid  ID of the file
+ *
+ * \return ITS_FILE_TAG_FREE for an invalid file ID, a non-free tag otherwise
+ */
+static uint8_t its_mblock_file_tag(const uint8_t *fid)
+{
+    uint32_t hash = 2166136261U;
+    uint32_t i;
+
+    if (its_utils_validate_fid(fid) != PSA_SUCCESS) {
+        return ITS_FILE_TAG_FREE;
+    }
+
+    /* FNV-1a hash of the file ID folded into 8 bits */
+    for (i = 0; i < ITS_FILE_ID_SIZE; i++) {
+        hash ^= fid[i];
+        hash *= 16777619U;
+    }
+    hash ^= (hash >> 16);
+    hash ^= (hash >> 8);
+
+    return ((uint8_t)hash == ITS_FILE_TAG_FREE) ? 1U : (uint8_t)hash;
+}
+
+/**
+ * \brief Builds the RAM file index from the active metadata block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_build_file_index(
+                                              struct its_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+    uint32_t i;
+    struct its_file_meta_t tmp_metadata;
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        fs_ctx->file_tags[i] = its_mblock_file_tag(tmp_metadata.id);
+    }
+
+    memcpy(fs_ctx->scratch_file_tags, fs_ctx->file_tags,
+           fs_ctx->cfg->max_num_files);
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_RAM_FILE_INDEX */
+
 /* FIXME: Precompute these for each context */
 /**
  * \brief Gets the physical block ID of the initial position of the scratch
@@ -135,6 +205,117 @@ static size_t its_mblock_file_meta_offset(struct its_flash_fs_ctx_t *fs_ctx,
            + (idx * ITS_FILE_METADATA_SIZE);
 }
 
+/**
+ * \brief Gets offset of the file data area of logical block 0 in metadata
+ *        block, which follows all the metadata.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Return offset value in metadata block
+ */
+static size_t its_mblock_lb0_data_start(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return its_mblock_file_meta_offset(fs_ctx, fs_ctx->cfg->max_num_files)
+           + ITS_METADATA_LOG_SIZE;
+}
+
+#if ITS_METADATA_LOG_RECORDS
+#if (ITS_METADATA_LOG_RECORDS > 254)
+#error "ITS_METADATA_LOG_RECORDS must not be bigger than 254"
+#endif
+
+#define ITS_LOG_RECORD_SIZE  sizeof(struct its_mblock_log_record_t)
+
+/* Value of the seq field of the record stored at the given log position */
+#define ITS_LOG_RECORD_SEQ(pos)  ((uint8_t)((pos) + 1U))
+
+/* Log position returned when no record is found */
+#define ITS_LOG_POS_INVALID  ITS_METADATA_LOG_RECORDS
+
+/**
+ * \brief Gets offset of a metadata delta record in metadata block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     pos     Position of the record in the log
+ *
+ * \return Return offset value in metadata block
+ */
+static size_t its_mblock_log_record_offset(struct its_flash_fs_ctx_t *fs_ctx,
+                                           uint32_t pos)
+{
+    return its_mblock_file_meta_offset(fs_ctx, fs_ctx->cfg->max_num_files)
+           + (pos * ITS_LOG_RECORD_SIZE);
+}
+
+/**
+ * \brief Finds the most recent metadata delta record of a file metadata entry.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     idx     File metadata entry index
+ *
+ * \return Position of the record in the log, or ITS_LOG_POS_INVALID if the
+ *         entry is not in the log
+ */
+static uint32_t its_mblock_log_find_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                         uint32_t idx)
+{
+    uint32_t pos = fs_ctx->log_count;
+
+    while (pos > 0) {
+        pos--;
+        if (fs_ctx->log_file_idx[pos] == idx) {
+            return pos;
+        }
+    }
+
+    return ITS_LOG_POS_INVALID;
+}
+
+/**
+ * \brief Finds the most recent metadata delta record of a block metadata
+ *        entry.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     lblock  Logical block number
+ *
+ * \return Position of the record in the log, or ITS_LOG_POS_INVALID if the
+ *         entry is not in the log
+ */
+static uint32_t its_mblock_log_find_block(struct its_flash_fs_ctx_t *fs_ctx,
+                                          uint32_t lblock)
+{
+    uint32_t pos = fs_ctx->log_count;
+
+    while (pos > 0) {
+        pos--;
+        if (fs_ctx->log_lblock[pos] == lblock) {
+            return pos;
+        }
+    }
+
+    return ITS_LOG_POS_INVALID;
+}
+
+/**
+ * \brief Calculates the XOR on the metadata of a metadata delta record.
+ *
+ * \param[in] record  Pointer to the record
+ *
+ * \return XOR value based on the file and block metadata of the record
+ */
+static uint8_t its_mblock_log_record_xor(
+                                  const struct its_mblock_log_record_t *record)
+{
+    uint8_t xor_value;
+
+    xor_value = its_utils_xor(0, (const uint8_t *)&record->file_meta,
+                              ITS_FILE_METADATA_SIZE);
+
+    return its_utils_xor(xor_value, (const uint8_t *)&record->block_meta,
+                         ITS_BLOCK_METADATA_SIZE);
+}
+#endif /* ITS_METADATA_LOG_RECORDS */
+
 /**
  * \brief Swaps metablocks. Scratch becomes active and active becomes scratch.
  *
@@ -144,9 +325,34 @@ static void its_mblock_swap_metablocks(struct its_flash_fs_ctx_t *fs_ctx)
 {
     uint32_t tmp_block;
 
+#if ITS_RAM_FILE_INDEX
+    uint8_t *tmp_tags;
+#endif
+
     tmp_block = fs_ctx->scratch_metablock;
     fs_ctx->scratch_metablock = fs_ctx->active_metablock;
     fs_ctx->active_metablock = tmp_block;
+
+#if ITS_METADATA_LOG_RECORDS
+    /* The scratch metadata block holds all the logged updates, and its log
+     * is empty.
+     */
+    fs_ctx->log_count = 0;
+    fs_ctx->log_next = 0;
+#endif
+
+#if ITS_RAM_FILE_INDEX
+    /* The file index follows the metadata blocks */
+    tmp_tags = fs_ctx->scratch_file_tags;
+    fs_ctx->scratch_file_tags = fs_ctx->file_tags;
+    fs_ctx->file_tags = tmp_tags;
+
+    /* The next update of the scratch metadata block starts from the active
+     * metadata.
+     */
+    memcpy(fs_ctx->scratch_file_tags, fs_ctx->file_tags,
+           fs_ctx->cfg->max_num_files);
+#endif
 }
 
 /**
@@ -253,11 +459,17 @@ static psa_status_t its_mblock_validate_file_meta(
             return PSA_ERROR_DATA_CORRUPT;
         }
 
+#if ITS_INLINE_FILE_SIZE
+        /* The data of an inline file must fit in its metadata */
+        if ((file_meta->flags & ITS_FLASH_FS_FLAG_INLINE) &&
+            (file_meta->max_size > ITS_INLINE_FILE_SIZE)) {
+            return PSA_ERROR_DATA_CORRUPT;
+        }
+#endif
+
         if (file_meta->lblock == ITS_LOGICAL_DBLOCK0) {
             /* In block 0, data index must be located after the metadata */
-            if (file_meta->data_idx <
-                its_mblock_file_meta_offset(fs_ctx,
-                                            fs_ctx->cfg->max_num_files)) {
+            if (file_meta->data_idx < its_mblock_lb0_data_start(fs_ctx)) {
                 return PSA_ERROR_DATA_CORRUPT;
             }
         }
@@ -265,7 +477,7 @@ static psa_status_t its_mblock_validate_file_meta(
         /* Boundary check the incoming request */
         err = its_utils_check_contained_in(fs_ctx->cfg->block_size,
                                            file_meta->data_idx,
-                                           file_meta->max_size);
+                                           ITS_FILE_DATA_SIZE(file_meta));
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_DATA_CORRUPT;
         }
@@ -312,8 +524,7 @@ static psa_status_t its_mblock_validate_block_meta(
         /* For metadata + data block, data index must start after the
          * metadata area.
          */
-        valid_data_start_value =
-            its_mblock_file_meta_offset(fs_ctx, fs_ctx->cfg->max_num_files);
+        valid_data_start_value = its_mblock_lb0_data_start(fs_ctx);
     }
 
     if (block_meta->data_start != valid_data_start_value) {
@@ -388,10 +599,12 @@ static psa_status_t its_mblock_calculate_metadata_xor(
                                               uint32_t block_id,
                                               uint8_t *xor_value)
 {
-    uint32_t i, j;
     psa_status_t err;
-    uint8_t metadata[ITS_UTILS_MAX(ITS_BLOCK_METADATA_SIZE,
-                                   ITS_FILE_METADATA_SIZE)];
+    uint8_t metadata[ITS_MAX_BLOCK_DATA_COPY];
+    const uint8_t *data;
+    size_t offset;
+    size_t end;
+    size_t len;
     uint8_t xor_value_temp = 0;
 
     if ((block_id != ITS_METADATA_BLOCK0 && block_id != ITS_METADATA_BLOCK1) ||
@@ -399,37 +612,34 @@ static psa_status_t its_mblock_calculate_metadata_xor(
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-    /* Calculate the XOR value based on the block metadata. */
-    for (i = 0; i < its_num_active_dblocks(fs_ctx); i++) {
-        err = fs_ctx->ops->read(fs_ctx->cfg, block_id,
-                                metadata,
-                                its_mblock_block_meta_offset(i),
-                                ITS_BLOCK_METADATA_SIZE);
-        if (err != PSA_SUCCESS) {
-            return err;
-        }
-
-        /* Update the XOR value. */
-        for (j = 0; j < ITS_BLOCK_METADATA_SIZE; j++) {
-            xor_value_temp ^= metadata[j];
+    /* The block metadata entries are immediately followed by the file metadata
+     * entries, so the XOR value is calculated over a single contiguous range.
+     * When the flash is memory-mapped, the range is accessed in place.
+     * Otherwise, it is read in chunks, to keep the number of flash accesses
+     * during the filesystem mount low.
+     */
+    offset = its_mblock_block_meta_offset(0);
+    end = its_mblock_file_meta_offset(fs_ctx, fs_ctx->cfg->max_num_files);
+
+    while (offset < end) {
+        if (fs_ctx->ops->map != NULL) {
+            len = end - offset;
+            err = fs_ctx->ops->map(fs_ctx->cfg, block_id, &data, offset, len);
+        } else {
+            len = ITS_UTILS_MIN(end - offset, sizeof(metadata));
+            err = its_flash_fs_op_read(fs_ctx, block_id, metadata, offset,
+                                       len);
+            data = metadata;
         }
-    }
-
-    /* Calculate the XOR value based on the file metadata. */
-    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
-        err = fs_ctx->ops->read(fs_ctx->cfg, block_id,
-                                metadata,
-                                its_mblock_file_meta_offset(fs_ctx, i),
-                                ITS_FILE_METADATA_SIZE);
         if (err != PSA_SUCCESS) {
             return err;
         }
 
-        /* Update the XOR value. */
-        for (j = 0; j < ITS_FILE_METADATA_SIZE; j++) {
-            xor_value_temp ^= metadata[j];
-        }
+        xor_value_temp = its_utils_xor(xor_value_temp, data, len);
+
+        offset += len;
     }
+
     *xor_value = xor_value_temp;
     return PSA_SUCCESS;
 }
@@ -476,11 +686,17 @@ static psa_status_t its_mblock_validate_metadata_xor(
 static uint32_t its_get_free_file_index(struct its_flash_fs_ctx_t *fs_ctx,
                                         bool use_spare)
 {
-    psa_status_t err;
     uint32_t i;
+#if !ITS_RAM_FILE_INDEX
+    psa_status_t err;
     struct its_file_meta_t tmp_metadata;
+#endif
 
     for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+#if ITS_RAM_FILE_INDEX
+        /* Free entries are known from the file index */
+        if (fs_ctx->file_tags[i] == ITS_FILE_TAG_FREE) {
+#else
         err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
         if (err != PSA_SUCCESS) {
             return ITS_METADATA_INVALID_INDEX;
@@ -490,6 +706,7 @@ static uint32_t its_get_free_file_index(struct its_flash_fs_ctx_t *fs_ctx,
          * invalid ID.
          */
         if (its_utils_validate_fid(tmp_metadata.id) != PSA_SUCCESS) {
+#endif
             if (!use_spare) {
                 /* Keep the first free file index as a spare, indicate that the
                  * next free file index should be used and continue searching.
@@ -522,7 +739,7 @@ static psa_status_t its_mblock_erase_scratch_blocks(
      * and power-failure-safe operation, it is necessary that
      * metadata scratch block is erased before data block.
      */
-    err = fs_ctx->ops->erase(fs_ctx->cfg, fs_ctx->scratch_metablock);
+    err = its_flash_fs_op_erase(fs_ctx, fs_ctx->scratch_metablock);
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -536,7 +753,13 @@ static psa_status_t its_mblock_erase_scratch_blocks(
         scratch_datablock =
             its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
                                                     (ITS_LOGICAL_DBLOCK0 + 1));
-        err = fs_ctx->ops->erase(fs_ctx->cfg, scratch_datablock);
+        err = its_flash_fs_op_erase(fs_ctx, scratch_datablock);
+#if ITS_WEAR_LEVELLING
+        /* The erase is recorded in flash by the next metadata update */
+        if (err == PSA_SUCCESS) {
+            fs_ctx->meta_block_header.scratch_erase_count++;
+        }
+#endif
     }
 
     return err;
@@ -561,9 +784,63 @@ static psa_status_t its_mblock_update_scratch_block_meta(
 
     /* Calculate the position */
     pos = its_mblock_block_meta_offset(lblock);
-    return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
-                              (const uint8_t *)block_meta, pos,
-                              ITS_BLOCK_METADATA_SIZE);
+    return its_flash_fs_op_write(fs_ctx, fs_ctx->scratch_metablock,
+                                 (const uint8_t *)block_meta, pos,
+                                 ITS_BLOCK_METADATA_SIZE);
+}
+
+/**
+ * \brief Copies the block metadata entries between two logical blocks from the
+ *        active metadata block to the scratch metadata block.
+ *
+ * \param[in,out] fs_ctx        Filesystem context
+ * \param[in]     lblock_start  Logical block number to start copy, inclusive
+ * \param[in]     lblock_end    Logical block number to end copy, exclusive
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_cp_block_meta(struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t lblock_start,
+                                             uint32_t lblock_end)
+{
+    size_t pos = its_mblock_block_meta_offset(lblock_start);
+#if ITS_METADATA_LOG_RECORDS
+    struct its_block_meta_t block_meta;
+    psa_status_t err;
+    uint32_t i;
+
+    /* The entries updated by the log are taken from their latest record */
+    for (i = lblock_start; i < lblock_end; i++) {
+        if (its_mblock_log_find_block(fs_ctx, i) == ITS_LOG_POS_INVALID) {
+            continue;
+        }
+
+        err = its_flash_fs_block_to_block_move(fs_ctx,
+                                      fs_ctx->scratch_metablock, pos,
+                                      fs_ctx->active_metablock, pos,
+                                      its_mblock_block_meta_offset(i) - pos);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, &block_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_mblock_update_scratch_block_meta(fs_ctx, i, &block_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        pos = its_mblock_block_meta_offset(i + 1);
+    }
+#endif
+
+    return its_flash_fs_block_to_block_move(fs_ctx, fs_ctx->scratch_metablock,
+                                    pos, fs_ctx->active_metablock, pos,
+                                    its_mblock_block_meta_offset(lblock_end)
+                                    - pos);
 }
 
 /**
@@ -580,13 +857,9 @@ static psa_status_t its_mblock_copy_remaining_block_meta(
 {
     struct its_block_meta_t block_meta;
     psa_status_t err;
-    uint32_t meta_block;
-    size_t pos;
     uint32_t scratch_block;
-    size_t size;
 
     scratch_block = fs_ctx->scratch_metablock;
-    meta_block = fs_ctx->active_metablock;
 
     if (lblock != ITS_LOGICAL_DBLOCK0) {
         /* The file data in the logical block 0 is stored in same physical
@@ -618,14 +891,10 @@ static psa_status_t its_mblock_copy_remaining_block_meta(
          * the logical block provided in the function.
          */
         if (lblock > 1) {
-            pos = its_mblock_block_meta_offset(ITS_LOGICAL_DBLOCK0 + 1);
-
-            size = its_mblock_block_meta_offset(lblock) - pos;
-
             /* Copy rest of the block data from previous block */
             /* Data before updated content */
-            err = its_flash_fs_block_to_block_move(fs_ctx, scratch_block, pos,
-                                                   meta_block, pos, size);
+            err = its_mblock_cp_block_meta(fs_ctx, ITS_LOGICAL_DBLOCK0 + 1,
+                                           lblock);
             if (err != PSA_SUCCESS) {
                 return err;
             }
@@ -633,12 +902,8 @@ static psa_status_t its_mblock_copy_remaining_block_meta(
     }
 
     /* Move meta blocks data after updated content */
-    pos = its_mblock_block_meta_offset(lblock+1);
-
-    size = its_mblock_file_meta_offset(fs_ctx, 0) - pos;
-
-    return its_flash_fs_block_to_block_move(fs_ctx, scratch_block, pos,
-                                            meta_block, pos, size);
+    return its_mblock_cp_block_meta(fs_ctx, lblock + 1,
+                                    its_num_active_dblocks(fs_ctx));
 }
 
 /**
@@ -686,8 +951,15 @@ static inline psa_status_t its_mblock_validate_fs_version(uint8_t fs_version,
 {
     /* Looks for exact version number and the backward compatible version. */
     if (fs_version == ITS_BACKWARD_SUPPORTED_VERSION) {
+#if ITS_WEAR_LEVELLING
+        /* The erase counters change the layout of the metadata, which can not
+         * be upgraded in place from the backward compatible version.
+         */
+        return PSA_ERROR_GENERIC_ERROR;
+#else
         *backward_comp = true;
         return PSA_SUCCESS;
+#endif
     } else if (fs_version == ITS_SUPPORTED_VERSION) {
         *backward_comp = false;
         return PSA_SUCCESS;
@@ -771,9 +1043,9 @@ static psa_status_t its_mblock_write_scratch_meta_header(
 #endif
 
     /* Write the metadata block header */
-    return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
-                              (uint8_t *)(&fs_ctx->meta_block_header), 0,
-                              ITS_BLOCK_META_HEADER_SIZE);
+    return its_flash_fs_op_write(fs_ctx, fs_ctx->scratch_metablock,
+                                 (uint8_t *)(&fs_ctx->meta_block_header), 0,
+                                 ITS_BLOCK_META_HEADER_SIZE);
 }
 
 /**
@@ -849,9 +1121,9 @@ static psa_status_t its_mblock_read_meta_header(
 {
     psa_status_t err;
 
-    err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock,
-                            (uint8_t *)&fs_ctx->meta_block_header, 0,
-                            ITS_BLOCK_META_HEADER_SIZE);
+    err = its_flash_fs_op_read(fs_ctx, fs_ctx->active_metablock,
+                               (uint8_t *)&fs_ctx->meta_block_header, 0,
+                               ITS_BLOCK_META_HEADER_SIZE);
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -867,6 +1139,7 @@ static psa_status_t its_mblock_read_meta_header(
  * \param[in]     fid         File ID
  * \param[in]     size        Size of the file for which space is reserve
  * \param[in]     flags       Flags set when the file is created
+ * \param[in]     replace     Whether the file replaces an existing file
  * \param[out]    file_meta   File metadata entry
  * \param[out]    block_meta  Block metadata entry
  *
@@ -874,14 +1147,27 @@ static psa_status_t its_mblock_read_meta_header(
  */
 static psa_status_t its_mblock_reserve_file(struct its_flash_fs_ctx_t *fs_ctx,
                                             const uint8_t *fid, size_t size,
-                                            uint32_t flags,
+                                            uint32_t flags, bool replace,
                                             struct its_file_meta_t *file_meta,
                                             struct its_block_meta_t *block_meta)
 {
     psa_status_t err;
     uint32_t i;
-
-    for (i = 0; i < its_num_active_dblocks(fs_ctx); i++) {
+    uint32_t n;
+
+    for (n = 0; n < its_num_active_dblocks(fs_ctx); n++) {
+        i = n;
+#if ITS_WEAR_LEVELLING
+        /* Keep the files which are rewritten apart from the static ones, by
+         * filling the data blocks from the last one for the replacement copies
+         * and from the first one for the new files.
+         */
+        if (replace) {
+            i = its_num_active_dblocks(fs_ctx) - 1 - n;
+        }
+#else
+        (void)replace;
+#endif
         err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, block_meta);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
@@ -929,8 +1215,9 @@ static psa_status_t its_init_get_active_metablock(
      * attempt to validate the metadata header, otherwise assume that the block
      * update was incomplete
      */
-    err = fs_ctx->ops->read(fs_ctx->cfg, ITS_METADATA_BLOCK0,
-                            (uint8_t *)&h_meta0, 0, ITS_BLOCK_META_HEADER_SIZE);
+    err = its_flash_fs_op_read(fs_ctx, ITS_METADATA_BLOCK0,
+                               (uint8_t *)&h_meta0, 0,
+                               ITS_BLOCK_META_HEADER_SIZE);
     if (err == PSA_SUCCESS) {
         if (its_mblock_validate_header_meta(fs_ctx, &h_meta0,
                                         ITS_METADATA_BLOCK0) == PSA_SUCCESS) {
@@ -939,8 +1226,9 @@ static psa_status_t its_init_get_active_metablock(
         }
     }
 
-    err = fs_ctx->ops->read(fs_ctx->cfg, ITS_METADATA_BLOCK1,
-                            (uint8_t *)&h_meta1, 0, ITS_BLOCK_META_HEADER_SIZE);
+    err = its_flash_fs_op_read(fs_ctx, ITS_METADATA_BLOCK1,
+                               (uint8_t *)&h_meta1, 0,
+                               ITS_BLOCK_META_HEADER_SIZE);
     if (err == PSA_SUCCESS) {
         if (its_mblock_validate_header_meta(fs_ctx, &h_meta1,
                                         ITS_METADATA_BLOCK1) == PSA_SUCCESS) {
@@ -966,6 +1254,109 @@ static psa_status_t its_init_get_active_metablock(
     return PSA_SUCCESS;
 }
 
+#if ITS_METADATA_LOG_RECORDS
+/**
+ * \brief Checks if a metadata delta record is still erased.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     record  Pointer to the record
+ *
+ * \return true if all the bytes of the record have the erase value
+ */
+static bool its_mblock_log_record_is_erased(
+                                   struct its_flash_fs_ctx_t *fs_ctx,
+                                   const struct its_mblock_log_record_t *record)
+{
+    const uint8_t *p_record = (const uint8_t *)record;
+    uint32_t i;
+
+    for (i = 0; i < ITS_LOG_RECORD_SIZE; i++) {
+        if (p_record[i] != fs_ctx->cfg->erase_val) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Loads the metadata delta log of the active metadata block.
+ *
+ * \details The valid records are indexed in the context and the data scratch
+ *          block of the last one is restored. If the log ends with a record
+ *          which was not completely written, due to a power failure, no more
+ *          records are appended until the next metadata block swap.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_log_load(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+    uint32_t pos;
+    struct its_mblock_log_record_t record;
+
+    fs_ctx->log_count = 0;
+    fs_ctx->log_next = ITS_METADATA_LOG_RECORDS;
+
+    /* Metadata blocks in the backward compatible version have no log */
+    if (fs_ctx->meta_block_header.fs_version != ITS_SUPPORTED_VERSION) {
+        return PSA_SUCCESS;
+    }
+
+    for (pos = 0; pos < ITS_METADATA_LOG_RECORDS; pos++) {
+        err = its_flash_fs_op_read(fs_ctx, fs_ctx->active_metablock,
+                                   (uint8_t *)&record,
+                                   its_mblock_log_record_offset(fs_ctx, pos),
+                                   ITS_LOG_RECORD_SIZE);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (record.seq != ITS_LOG_RECORD_SEQ(pos)) {
+            if (its_mblock_log_record_is_erased(fs_ctx, &record)) {
+                fs_ctx->log_next = pos;
+            }
+            break;
+        }
+
+        if ((record.file_idx >= fs_ctx->cfg->max_num_files) ||
+            (record.lblock >= its_num_active_dblocks(fs_ctx)) ||
+            (record.scratch_dblock >= fs_ctx->cfg->num_blocks)) {
+            return PSA_ERROR_DATA_CORRUPT;
+        }
+
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+        if (record.metadata_xor != its_mblock_log_record_xor(&record)) {
+            return PSA_ERROR_DATA_CORRUPT;
+        }
+
+        err = its_mblock_validate_file_meta(fs_ctx, &record.file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_mblock_validate_block_meta(fs_ctx, &record.block_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+#endif
+
+        fs_ctx->log_file_idx[pos] = record.file_idx;
+        fs_ctx->log_lblock[pos] = record.lblock;
+        fs_ctx->meta_block_header.scratch_dblock = record.scratch_dblock;
+#if ITS_WEAR_LEVELLING
+        fs_ctx->meta_block_header.scratch_erase_count =
+                                                    record.scratch_erase_count;
+#endif
+        fs_ctx->log_count++;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_METADATA_LOG_RECORDS */
+
 psa_status_t its_flash_fs_mblock_cp_file_meta(struct its_flash_fs_ctx_t *fs_ctx,
                                               uint32_t idx_start,
                                               uint32_t idx_end)
@@ -973,6 +1364,47 @@ psa_status_t its_flash_fs_mblock_cp_file_meta(struct its_flash_fs_ctx_t *fs_ctx,
     /* Calculate the positions of the two indexes in the metadata block */
     size_t pos_start = its_mblock_file_meta_offset(fs_ctx, idx_start);
     size_t pos_end = its_mblock_file_meta_offset(fs_ctx, idx_end);
+#if ITS_METADATA_LOG_RECORDS
+    struct its_file_meta_t file_meta;
+    psa_status_t err;
+    uint32_t i;
+#endif
+
+#if ITS_RAM_FILE_INDEX
+    memcpy(&fs_ctx->scratch_file_tags[idx_start], &fs_ctx->file_tags[idx_start],
+           idx_end - idx_start);
+#endif
+
+#if ITS_METADATA_LOG_RECORDS
+    /* The entries updated by the log are taken from their latest record */
+    for (i = idx_start; i < idx_end; i++) {
+        if (its_mblock_log_find_file(fs_ctx, i) == ITS_LOG_POS_INVALID) {
+            continue;
+        }
+
+        err = its_flash_fs_block_to_block_move(fs_ctx,
+                                    fs_ctx->scratch_metablock, pos_start,
+                                    fs_ctx->active_metablock, pos_start,
+                                    its_mblock_file_meta_offset(fs_ctx, i)
+                                    - pos_start);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, i,
+                                                           &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        pos_start = its_mblock_file_meta_offset(fs_ctx, i + 1);
+    }
+#endif
 
     /* Copy all data between the two positions from the scratch metadata block
      * to the active metadata block.
@@ -994,21 +1426,54 @@ uint32_t its_flash_fs_mblock_cur_data_scratch_id(
     return fs_ctx->meta_block_header.scratch_dblock;
 }
 
-psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs_ctx,
-                                                   const uint8_t *fid,
-                                                   uint32_t *idx,
-                                                   struct its_file_meta_t *file_meta)
+/**
+ * \brief Finds the file metadata entry holding the given file ID.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     fid        ID of the file
+ * \param[in]     staged     Whether to look for the staged copy of the file
+ *                           instead of the committed one
+ * \param[out]    idx        Index of the file metadata in the file system
+ * \param[out]    file_meta  Pointer to file metadata structure, or NULL
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_find_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                         const uint8_t *fid,
+                                         bool staged,
+                                         uint32_t *idx,
+                                         struct its_file_meta_t *file_meta)
 {
     psa_status_t err;
     uint32_t i;
     struct its_file_meta_t tmp_metadata;
+#if ITS_RAM_FILE_INDEX
+    uint8_t tag = its_mblock_file_tag(fid);
+#endif
 
     for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+#if ITS_RAM_FILE_INDEX
+        /* Only entries with a matching tag can hold the file ID */
+        if (fs_ctx->file_tags[i] != tag) {
+            continue;
+        }
+#endif
+
         err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
         }
 
+        /* A file marked for deletion no longer exists for the caller */
+        if (tmp_metadata.flags & ITS_FLASH_FS_FLAG_DELETE) {
+            continue;
+        }
+
+        /* The staged copy of a file is only visible to staged operations */
+        if (((tmp_metadata.flags & ITS_FLASH_FS_FLAG_STAGED) != 0) != staged) {
+            continue;
+        }
+
         /* ID with value 0x00 means end of file meta section */
         if (!memcmp(tmp_metadata.id, fid, ITS_FILE_ID_SIZE)) {
             /* Found */
@@ -1023,6 +1488,23 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
     return PSA_ERROR_DOES_NOT_EXIST;
 }
 
+psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs_ctx,
+                                                   const uint8_t *fid,
+                                                   uint32_t *idx,
+                                                   struct its_file_meta_t *file_meta)
+{
+    return its_mblock_find_file(fs_ctx, fid, false, idx, file_meta);
+}
+
+psa_status_t its_flash_fs_mblock_get_staged_file_idx_meta(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             const uint8_t *fid,
+                                             uint32_t *idx,
+                                             struct its_file_meta_t *file_meta)
+{
+    return its_mblock_find_file(fs_ctx, fid, true, idx, file_meta);
+}
+
 psa_status_t its_flash_fs_mblock_get_file_idx_flag(
                                               struct its_flash_fs_ctx_t *fs_ctx,
                                               uint32_t flags,
@@ -1048,6 +1530,44 @@ psa_status_t its_flash_fs_mblock_get_file_idx_flag(
     return PSA_ERROR_DOES_NOT_EXIST;
 }
 
+psa_status_t its_flash_fs_op_read(struct its_flash_fs_ctx_t *fs_ctx,
+                                  uint32_t block_id,
+                                  uint8_t *buf,
+                                  size_t offset,
+                                  size_t size)
+{
+#if ITS_FLASH_STATS
+    fs_ctx->stats.read_ops++;
+    fs_ctx->stats.read_bytes += size;
+#endif
+
+    return fs_ctx->ops->read(fs_ctx->cfg, block_id, buf, offset, size);
+}
+
+psa_status_t its_flash_fs_op_write(struct its_flash_fs_ctx_t *fs_ctx,
+                                   uint32_t block_id,
+                                   const uint8_t *buf,
+                                   size_t offset,
+                                   size_t size)
+{
+#if ITS_FLASH_STATS
+    fs_ctx->stats.program_ops++;
+    fs_ctx->stats.program_bytes += size;
+#endif
+
+    return fs_ctx->ops->write(fs_ctx->cfg, block_id, buf, offset, size);
+}
+
+psa_status_t its_flash_fs_op_erase(struct its_flash_fs_ctx_t *fs_ctx,
+                                   uint32_t block_id)
+{
+#if ITS_FLASH_STATS
+    fs_ctx->stats.erase_ops++;
+#endif
+
+    return fs_ctx->ops->erase(fs_ctx->cfg, block_id);
+}
+
 psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
 {
     psa_status_t err;
@@ -1068,6 +1588,14 @@ psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
         return PSA_ERROR_GENERIC_ERROR;
     }
 
+#if ITS_METADATA_LOG_RECORDS
+    /* Apply the logged updates before the data scratch block is erased */
+    err = its_mblock_log_load(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+#endif
+
     /* Erase the other scratch metadata block. It can be used in the later
      * step.
      */
@@ -1077,7 +1605,16 @@ psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
     }
 
     /* Upgrade the metadata header if required. */
-    return its_mblock_upgrade_meta_header(fs_ctx);
+    err = its_mblock_upgrade_meta_header(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+#if ITS_RAM_FILE_INDEX
+    return its_mblock_build_file_index(fs_ctx);
+#else
+    return PSA_SUCCESS;
+#endif
 }
 
 psa_status_t its_flash_fs_mblock_meta_update_finalize(
@@ -1104,6 +1641,85 @@ psa_status_t its_flash_fs_mblock_meta_update_finalize(
     return its_mblock_erase_scratch_blocks(fs_ctx);
 }
 
+#if ITS_METADATA_LOG_RECORDS
+psa_status_t its_flash_fs_mblock_log_update(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t idx,
+                                      const struct its_file_meta_t *file_meta,
+                                      uint32_t lblock,
+                                      const struct its_block_meta_t *block_meta)
+{
+    struct its_block_meta_t cur_block_meta;
+    psa_status_t err;
+    struct its_mblock_log_record_t record = {0};
+
+    if (fs_ctx->log_next >= ITS_METADATA_LOG_RECORDS) {
+        /* The log is full, the metadata block must be compacted */
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock,
+                                                  &cur_block_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    record.file_meta = *file_meta;
+    record.block_meta = *block_meta;
+    record.lblock = lblock;
+    record.scratch_dblock = fs_ctx->meta_block_header.scratch_dblock;
+#if ITS_WEAR_LEVELLING
+    record.scratch_erase_count = fs_ctx->meta_block_header.scratch_erase_count;
+#endif
+    record.file_idx = (uint16_t)idx;
+    record.metadata_xor = its_mblock_log_record_xor(&record);
+    record.seq = ITS_LOG_RECORD_SEQ(fs_ctx->log_next);
+
+    /* The record is appended to the erased log area of the active metadata
+     * block. Whatever happens from now on, this position can not be reused
+     * before the next metadata block swap.
+     */
+    err = its_flash_fs_op_write(fs_ctx, fs_ctx->active_metablock,
+                                (const uint8_t *)&record,
+                                its_mblock_log_record_offset(fs_ctx,
+                                                             fs_ctx->log_next),
+                                ITS_LOG_RECORD_SIZE);
+    if (err == PSA_SUCCESS) {
+        err = fs_ctx->ops->flush(fs_ctx->cfg, fs_ctx->active_metablock);
+    }
+    if (err != PSA_SUCCESS) {
+        fs_ctx->log_next = ITS_METADATA_LOG_RECORDS;
+        return err;
+    }
+
+    fs_ctx->log_file_idx[fs_ctx->log_count] = (uint16_t)idx;
+    fs_ctx->log_lblock[fs_ctx->log_count] = (uint16_t)lblock;
+    fs_ctx->log_count++;
+    fs_ctx->log_next++;
+
+#if ITS_RAM_FILE_INDEX
+    fs_ctx->file_tags[idx] = its_mblock_file_tag(file_meta->id);
+    fs_ctx->scratch_file_tags[idx] = fs_ctx->file_tags[idx];
+#endif
+
+    /* If the file data has been written to the data scratch block, the
+     * previous data block is now the data scratch block and has to be erased.
+     */
+    if ((lblock != ITS_LOGICAL_DBLOCK0) &&
+        (cur_block_meta.phy_id != block_meta->phy_id)) {
+        err = its_flash_fs_op_erase(fs_ctx, 
+                                    fs_ctx->meta_block_header.scratch_dblock);
+#if ITS_WEAR_LEVELLING
+        if (err == PSA_SUCCESS) {
+            fs_ctx->meta_block_header.scratch_erase_count++;
+        }
+#endif
+    }
+
+    return err;
+}
+#endif /* ITS_METADATA_LOG_RECORDS */
+
 psa_status_t its_flash_fs_mblock_migrate_lb0_data_to_scratch(
                                               struct its_flash_fs_ctx_t *fs_ctx)
 {
@@ -1134,11 +1750,22 @@ psa_status_t its_flash_fs_mblock_read_file_meta(
 {
     psa_status_t err;
     size_t offset;
+#if ITS_METADATA_LOG_RECORDS
+    uint32_t pos;
+#endif
 
     offset = its_mblock_file_meta_offset(fs_ctx, idx);
-    err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock,
-                            (uint8_t *)file_meta, offset,
-                            ITS_FILE_METADATA_SIZE);
+#if ITS_METADATA_LOG_RECORDS
+    /* The latest record of the entry replaces the entry */
+    pos = its_mblock_log_find_file(fs_ctx, idx);
+    if (pos != ITS_LOG_POS_INVALID) {
+        offset = its_mblock_log_record_offset(fs_ctx, pos)
+                 + offsetof(struct its_mblock_log_record_t, file_meta);
+    }
+#endif
+    err = its_flash_fs_op_read(fs_ctx, fs_ctx->active_metablock,
+                               (uint8_t *)file_meta, offset,
+                               ITS_FILE_METADATA_SIZE);
 
 #if ITS_VALIDATE_METADATA_FROM_FLASH
     if (err == PSA_SUCCESS) {
@@ -1156,11 +1783,22 @@ psa_status_t its_flash_fs_mblock_read_block_metadata(
 {
     psa_status_t err;
     size_t pos;
+#if ITS_METADATA_LOG_RECORDS
+    uint32_t log_pos;
+#endif
 
     pos = its_mblock_block_meta_offset(lblock);
-    err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock,
-                            (uint8_t *)block_meta, pos,
-                            ITS_BLOCK_METADATA_SIZE);
+#if ITS_METADATA_LOG_RECORDS
+    /* The latest record of the entry replaces the entry */
+    log_pos = its_mblock_log_find_block(fs_ctx, lblock);
+    if (log_pos != ITS_LOG_POS_INVALID) {
+        pos = its_mblock_log_record_offset(fs_ctx, log_pos)
+              + offsetof(struct its_mblock_log_record_t, block_meta);
+    }
+#endif
+    err = its_flash_fs_op_read(fs_ctx, fs_ctx->active_metablock,
+                               (uint8_t *)block_meta, pos,
+                               ITS_BLOCK_METADATA_SIZE);
 
 #if ITS_VALIDATE_METADATA_FROM_FLASH
     if (err == PSA_SUCCESS) {
@@ -1182,9 +1820,9 @@ psa_status_t its_flash_fs_mblock_read_block_metadata_comp(
     pos = sizeof(struct its_metadata_block_header_comp_t) +
                                              (lblock * ITS_BLOCK_METADATA_SIZE);
 
-    err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock,
-                            (uint8_t *)block_meta, pos,
-                            ITS_BLOCK_METADATA_SIZE);
+    err = its_flash_fs_op_read(fs_ctx, fs_ctx->active_metablock,
+                               (uint8_t *)block_meta, pos,
+                               ITS_BLOCK_METADATA_SIZE);
 
 #if ITS_VALIDATE_METADATA_FROM_FLASH
     if (err == PSA_SUCCESS) {
@@ -1207,8 +1845,8 @@ psa_status_t its_flash_fs_mblock_reserve_file(
 {
     psa_status_t err;
 
-    err = its_mblock_reserve_file(fs_ctx, fid, size, flags, file_meta,
-                                  block_meta);
+    err = its_mblock_reserve_file(fs_ctx, fid, size, flags, use_spare,
+                                  file_meta, block_meta);
 
     *idx = its_get_free_file_index(fs_ctx, use_spare);
     if ((err != PSA_SUCCESS) ||
@@ -1236,13 +1874,13 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
         metablock_to_erase_first = fs_ctx->scratch_metablock;
     }
 
-    err = fs_ctx->ops->erase(fs_ctx->cfg, metablock_to_erase_first);
+    err = its_flash_fs_op_erase(fs_ctx, metablock_to_erase_first);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
-    err = fs_ctx->ops->erase(fs_ctx->cfg,
-                             ITS_OTHER_META_BLOCK(metablock_to_erase_first));
+    err = its_flash_fs_op_erase(fs_ctx, 
+                                ITS_OTHER_META_BLOCK(metablock_to_erase_first));
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -1251,6 +1889,10 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
                                     (fs_ctx->cfg->erase_val == 0x00U) ? 1U : 0U;
     fs_ctx->meta_block_header.scratch_dblock = its_init_scratch_dblock(fs_ctx);
     fs_ctx->meta_block_header.fs_version = ITS_SUPPORTED_VERSION;
+#if ITS_WEAR_LEVELLING
+    fs_ctx->meta_block_header.scratch_erase_count = 0;
+    block_meta.erase_count = 0;
+#endif
     fs_ctx->scratch_metablock = ITS_METADATA_BLOCK1;
     fs_ctx->active_metablock = ITS_METADATA_BLOCK0;
 
@@ -1260,8 +1902,7 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
      * datablock, the space available for data is from the end of the metadata
      * to the end of the block.
      */
-    block_meta.data_start =
-        its_mblock_file_meta_offset(fs_ctx, fs_ctx->cfg->max_num_files);
+    block_meta.data_start = its_mblock_lb0_data_start(fs_ctx);
     block_meta.free_size = fs_ctx->cfg->block_size - block_meta.data_start;
     block_meta.phy_id = fs_ctx->scratch_metablock;
     err = its_mblock_update_scratch_block_meta(fs_ctx, ITS_LOGICAL_DBLOCK0,
@@ -1281,8 +1922,8 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
         /* If a flash error is detected, the code erases the rest
          * of the blocks anyway to remove all data stored in them.
          */
-        err |= fs_ctx->ops->erase(fs_ctx->cfg,
-                                  i + its_init_dblock_start(fs_ctx));
+        err |= its_flash_fs_op_erase(fs_ctx, 
+                                     i + its_init_dblock_start(fs_ctx));
     }
 
     /* If an error is detected while erasing the flash, then return a
@@ -1338,6 +1979,93 @@ void its_flash_fs_mblock_set_data_scratch(struct its_flash_fs_ctx_t *fs_ctx,
     }
 }
 
+#if ITS_WEAR_LEVELLING
+void its_flash_fs_mblock_swap_erase_count(struct its_flash_fs_ctx_t *fs_ctx,
+                                          struct its_block_meta_t *block_meta,
+                                          uint32_t lblock)
+{
+    uint32_t erase_count;
+
+    /* The logical block 0 swaps with the metadata blocks, whose erases are
+     * not counted.
+     */
+    if (lblock != ITS_LOGICAL_DBLOCK0) {
+        erase_count = block_meta->erase_count;
+        block_meta->erase_count = fs_ctx->meta_block_header.scratch_erase_count;
+        fs_ctx->meta_block_header.scratch_erase_count = erase_count;
+    }
+}
+
+psa_status_t its_flash_fs_mblock_get_cold_block(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t *lblock)
+{
+    struct its_block_meta_t block_meta;
+    psa_status_t err;
+    uint32_t i;
+    uint32_t min_erase_count = fs_ctx->meta_block_header.scratch_erase_count;
+
+    *lblock = ITS_LOGICAL_DBLOCK0;
+    for (i = ITS_LOGICAL_DBLOCK0 + 1; i < its_num_active_dblocks(fs_ctx); i++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, &block_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (block_meta.erase_count < min_erase_count) {
+            min_erase_count = block_meta.erase_count;
+            *lblock = i;
+        }
+    }
+
+    if ((*lblock == ITS_LOGICAL_DBLOCK0) ||
+        (fs_ctx->meta_block_header.scratch_erase_count - min_erase_count <
+         ITS_WEAR_LEVELLING_THRESHOLD)) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_mblock_get_erase_count(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t block_id,
+                                              uint32_t *erase_count)
+{
+    struct its_block_meta_t block_meta;
+    psa_status_t err;
+    uint32_t i;
+
+    if (block_id >= fs_ctx->cfg->num_blocks) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((block_id == ITS_METADATA_BLOCK0) ||
+        (block_id == ITS_METADATA_BLOCK1)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    if (block_id == fs_ctx->meta_block_header.scratch_dblock) {
+        *erase_count = fs_ctx->meta_block_header.scratch_erase_count;
+        return PSA_SUCCESS;
+    }
+
+    for (i = ITS_LOGICAL_DBLOCK0 + 1; i < its_num_active_dblocks(fs_ctx); i++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, &block_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (block_meta.phy_id == block_id) {
+            *erase_count = block_meta.erase_count;
+            return PSA_SUCCESS;
+        }
+    }
+
+    return PSA_ERROR_DATA_CORRUPT;
+}
+#endif /* ITS_WEAR_LEVELLING */
+
 psa_status_t its_flash_fs_mblock_update_scratch_block_meta(
                                             struct its_flash_fs_ctx_t *fs_ctx,
                                             uint32_t lblock,
@@ -1368,11 +2096,15 @@ psa_status_t its_flash_fs_mblock_update_scratch_file_meta(
 {
     size_t pos;
 
+#if ITS_RAM_FILE_INDEX
+    fs_ctx->scratch_file_tags[idx] = its_mblock_file_tag(file_meta->id);
+#endif
+
     /* Calculate the position */
     pos = its_mblock_file_meta_offset(fs_ctx, idx);
-    return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
-                              (const uint8_t *)file_meta, pos,
-                              ITS_FILE_METADATA_SIZE);
+    return its_flash_fs_op_write(fs_ctx, fs_ctx->scratch_metablock,
+                                 (const uint8_t *)file_meta, pos,
+                                 ITS_FILE_METADATA_SIZE);
 }
 
 psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
@@ -1393,15 +2125,15 @@ psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
         /* Reads data from source block and store it in the in-memory copy of
          * destination content.
          */
-        status = fs_ctx->ops->read(fs_ctx->cfg, src_block, dst_block_data_copy,
-                                   src_offset, bytes_to_move);
+        status = its_flash_fs_op_read(fs_ctx, src_block, dst_block_data_copy,
+                                      src_offset, bytes_to_move);
         if (status != PSA_SUCCESS) {
             return status;
         }
 
         /* Writes in flash the in-memory block content after modification */
-        status = fs_ctx->ops->write(fs_ctx->cfg, dst_block, dst_block_data_copy,
-                                    dst_offset, bytes_to_move);
+        status = its_flash_fs_op_write(fs_ctx, dst_block, dst_block_data_copy,
+                                       dst_offset, bytes_to_move);
         if (status != PSA_SUCCESS) {
             return status;
         }
@@ -1412,6 +2144,9 @@ psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
 
         /* Decrement remaining size to move */
         size -= bytes_to_move;
+
+        /* Compaction moves whole blocks, let NS interrupts in between chunks */
+        tfm_preemption_point();
     }
 
     return PSA_SUCCESS;
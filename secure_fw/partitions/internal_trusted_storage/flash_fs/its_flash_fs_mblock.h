@@ -62,6 +62,7 @@ extern "C" {
  * \note This structure is programmed to flash, so its size must be padded
  *       to a multiple of the maximum required flash program unit.
  */
+#if ITS_WEAR_LEVELLING
 #define _T1 \
     uint32_t scratch_dblock;    /*!< Physical block ID of the data \
                                  *   section's scratch block \
@@ -70,9 +71,25 @@ extern "C" {
     uint8_t metadata_xor;       /*!< XOR value based on the whole metadata(not \
                                  *   including the metadata block header) \
                                  */ \
+    uint32_t scratch_erase_count; /*!< Number of times the data section's \
+                                   *   scratch block has been erased \
+                                   */ \
     uint8_t active_swap_count;  /*!< Number of times the metadata blocks have \
                                  *   been swapped \
                                  */
+#else
+#define _T1 \
+    uint32_t scratch_dblock;    /*!< Physical block ID of the data \
+                                 *   section's scratch block \
+                                 */ \
+    uint8_t fs_version;         /*!< Filesystem version */ \
+    uint8_t metadata_xor;       /*!< XOR value based on the whole metadata(not \
+                                 *   including the metadata block header) \
+                                 */ \
+    uint8_t active_swap_count;  /*!< Number of times the metadata blocks have \
+                                 *   been swapped \
+                                 */
+#endif
 
 struct its_metadata_block_header_t {
     _T1
@@ -124,6 +141,19 @@ struct its_metadata_block_header_comp_t {
  * \note This structure is programmed to flash, so its size must be padded
  *       to a multiple of the maximum required flash program unit.
  */
+#if ITS_WEAR_LEVELLING
+#define _T2 \
+    uint32_t phy_id;    /*!< Physical ID of this logical block */ \
+    size_t data_start;  /*!< Offset from the beginning of the block to the \
+                         *   location where the data starts \
+                         */ \
+    size_t free_size;   /*!< Number of bytes free at end of block (set during \
+                         *   block compaction for gap reuse) \
+                         */ \
+    uint32_t erase_count; /*!< Number of times the physical block has been \
+                           *   erased \
+                           */
+#else
 #define _T2 \
     uint32_t phy_id;    /*!< Physical ID of this logical block */ \
     size_t data_start;  /*!< Offset from the beginning of the block to the \
@@ -132,6 +162,7 @@ struct its_metadata_block_header_comp_t {
     size_t free_size;   /*!< Number of bytes free at end of block (set during \
                          *   block compaction for gap reuse) \
                          */
+#endif
 
 struct its_block_meta_t {
     _T2
@@ -150,6 +181,13 @@ struct its_block_meta_t {
  * \note This structure is programmed to flash, so its size must be padded
  *       to a multiple of the maximum required flash program unit.
  */
+#if ITS_INLINE_FILE_SIZE
+    #define _T3_INLINE \
+    ; uint8_t inline_data[ITS_INLINE_FILE_SIZE] /* Data of an inline file */
+#else
+    #define _T3_INLINE
+#endif
+
 #ifdef ITS_ENCRYPTION
     #define _T3 \
     uint32_t lblock;               /* Logical datablock where file is stored */ \
@@ -159,7 +197,8 @@ struct its_block_meta_t {
     uint32_t flags;                /* Flags set when the file was created */ \
     uint8_t id[ITS_FILE_ID_SIZE];  /* ID of this file */ \
     uint8_t nonce[TFM_ITS_ENC_NONCE_LENGTH]; \
-    uint8_t tag[TFM_ITS_AUTH_TAG_LENGTH]
+    uint8_t tag[TFM_ITS_AUTH_TAG_LENGTH] \
+    _T3_INLINE
 #else
     #define _T3 \
     uint32_t lblock;               /* Logical datablock where file is stored */ \
@@ -167,7 +206,8 @@ struct its_block_meta_t {
     size_t cur_size;               /* Size in storage system for this fragment */ \
     size_t max_size;               /* Maximum size of this file */ \
     uint32_t flags;                /* Flags set when the file was created */ \
-    uint8_t id[ITS_FILE_ID_SIZE]   /* ID of this file */
+    uint8_t id[ITS_FILE_ID_SIZE]   /* ID of this file */ \
+    _T3_INLINE
 #endif
 
 struct its_file_meta_t {
@@ -178,6 +218,96 @@ struct its_file_meta_t {
 #endif
 };
 #undef _T3
+#undef _T3_INLINE
+
+/* Size of the data of a file in its data block, 0 for an inline file */
+#if ITS_INLINE_FILE_SIZE
+#define ITS_FILE_DATA_SIZE(file_meta) \
+    (((file_meta)->flags & ITS_FLASH_FS_FLAG_INLINE) ? 0 : (file_meta)->max_size)
+#else
+#define ITS_FILE_DATA_SIZE(file_meta) ((file_meta)->max_size)
+#endif
+
+#if ITS_METADATA_LOG_RECORDS
+/*!
+ * \struct its_mblock_log_record_t
+ *
+ * \brief Structure to store a metadata delta record. The records are appended
+ *        to the active metadata block, after the file metadata, and replace
+ *        the file and block metadata entries they refer to until the metadata
+ *        block is compacted by the next swap.
+ *
+ * \note The seq must be the last member to allow it to be programmed last.
+ *
+ * \note This structure is programmed to flash, so its size must be padded
+ *       to a multiple of the maximum required flash program unit.
+ */
+#if ITS_WEAR_LEVELLING
+#define _T4_WEAR \
+    uint32_t scratch_erase_count;       /*!< New erase count of the data \
+                                         *   section's scratch block \
+                                         */
+#else
+#define _T4_WEAR
+#endif
+
+#define _T4 \
+    struct its_file_meta_t file_meta;   /*!< New file metadata */ \
+    struct its_block_meta_t block_meta; /*!< New block metadata */ \
+    uint32_t lblock;                    /*!< Logical block of block_meta */ \
+    uint32_t scratch_dblock;            /*!< New physical block ID of the \
+                                         *   data section's scratch block \
+                                         */ \
+    _T4_WEAR \
+    uint16_t file_idx;                  /*!< File index of file_meta */ \
+    uint8_t metadata_xor;               /*!< XOR value based on file_meta and \
+                                         *   block_meta \
+                                         */ \
+    uint8_t seq;                        /*!< Position of the record in the \
+                                         *   log, marks the record as valid \
+                                         */
+
+struct its_mblock_log_record_t {
+    _T4
+#if ((ITS_FLASH_MAX_ALIGNMENT) > 4)
+    uint8_t roundup[sizeof(struct __attribute__((__aligned__(ITS_FLASH_MAX_ALIGNMENT))) { _T4 }) -
+                    sizeof(struct { _T4 })];
+#endif
+};
+#undef _T4
+#undef _T4_WEAR
+
+/*!
+ * \def ITS_METADATA_LOG_SIZE
+ *
+ * \brief Size of the metadata delta log in the metadata block.
+ */
+#define ITS_METADATA_LOG_SIZE \
+    (ITS_METADATA_LOG_RECORDS * sizeof(struct its_mblock_log_record_t))
+#else
+#define ITS_METADATA_LOG_SIZE  0
+#endif /* ITS_METADATA_LOG_RECORDS */
+
+/*!
+ * \struct its_flash_fs_stats_t
+ *
+ * \brief Flash operations issued by a filesystem context since it was
+ *        initialised, counted when ITS_FLASH_STATS is enabled.
+ *
+ * \details program_bytes divided by logical_bytes gives the write
+ *          amplification of the filesystem, that is the number of bytes
+ *          programmed in flash for each byte written by the users of the
+ *          filesystem. Reads which are served by mapping the flash are not
+ *          counted.
+ */
+struct its_flash_fs_stats_t {
+    uint32_t read_ops;      /*!< Number of flash read operations */
+    uint32_t read_bytes;    /*!< Number of bytes read from flash */
+    uint32_t program_ops;   /*!< Number of flash program operations */
+    uint32_t program_bytes; /*!< Number of bytes programmed in flash */
+    uint32_t erase_ops;     /*!< Number of flash block erases */
+    uint32_t logical_bytes; /*!< Number of file data bytes written */
+};
 
 /**
  * \struct its_flash_fs_ctx_t
@@ -192,8 +322,80 @@ struct its_flash_fs_ctx_t {
                                                            */
     uint32_t active_metablock;  /**< Active metadata block */
     uint32_t scratch_metablock; /**< Scratch metadata block */
+#if ITS_RAM_FILE_INDEX
+    uint8_t *file_tags;         /**< File ID tag of each file metadata entry
+                                 *   in the active metadata block
+                                 */
+    uint8_t *scratch_file_tags; /**< File ID tag of each file metadata entry
+                                 *   in the scratch metadata block
+                                 */
+#endif
+#if ITS_METADATA_LOG_RECORDS
+    uint32_t log_count;         /**< Number of valid records in the metadata
+                                 *   delta log of the active metadata block
+                                 */
+    uint32_t log_next;          /**< Position of the next record to append */
+    uint16_t log_file_idx[ITS_METADATA_LOG_RECORDS]; /**< File index of each
+                                                      *   valid record
+                                                      */
+    uint16_t log_lblock[ITS_METADATA_LOG_RECORDS];   /**< Logical block of each
+                                                      *   valid record
+                                                      */
+#endif
+#if ITS_FLASH_STATS
+    struct its_flash_fs_stats_t stats; /**< Flash operation counters */
+#endif
 };
 
+/**
+ * \brief Reads data from a flash block, through the filesystem flash operations
+ *        of the context. Counts the read when ITS_FLASH_STATS is enabled.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Block ID
+ * \param[out]    buf       Buffer pointer to store the data read
+ * \param[in]     offset    Offset position from the init of the block
+ * \param[in]     size      Number of bytes to read
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_op_read(struct its_flash_fs_ctx_t *fs_ctx,
+                                  uint32_t block_id,
+                                  uint8_t *buf,
+                                  size_t offset,
+                                  size_t size);
+
+/**
+ * \brief Programs data to a flash block, through the filesystem flash
+ *        operations of the context. Counts the program operation when
+ *        ITS_FLASH_STATS is enabled.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Block ID
+ * \param[in]     buf       Buffer pointer to the write data
+ * \param[in]     offset    Offset position from the init of the block
+ * \param[in]     size      Number of bytes to write
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_op_write(struct its_flash_fs_ctx_t *fs_ctx,
+                                   uint32_t block_id,
+                                   const uint8_t *buf,
+                                   size_t offset,
+                                   size_t size);
+
+/**
+ * \brief Erases a flash block, through the filesystem flash operations of the
+ *        context. Counts the erase when ITS_FLASH_STATS is enabled.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Block ID
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_op_erase(struct its_flash_fs_ctx_t *fs_ctx,
+                                   uint32_t block_id);
+
 /**
  * \brief Initializes metadata block with the valid/active metablock.
  *
@@ -245,6 +447,26 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
                                                    const uint8_t *fid,
                                                    uint32_t *idx,
                                                    struct its_file_meta_t *file_meta);
+
+/**
+ * \brief Gets file metadata entry index and file metadata of the staged copy
+ *        of a file, written with ITS_FLASH_FS_FLAG_STAGED.
+ *
+ * \note  A NULL [file_meta] indicates ignoring file meta.
+ *
+ * \param[in,out]       fs_ctx      Filesystem context
+ * \param[in]           fid         ID of the file
+ * \param[out]          idx         Index of the file metadata in the file system
+ * \param[out]          file_meta   Pointer to file meta structure
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_get_staged_file_idx_meta(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             const uint8_t *fid,
+                                             uint32_t *idx,
+                                             struct its_file_meta_t *file_meta);
+
 /**
  * \brief Gets file metadata entry index of the first file with one of the
  *        provided flags set.
@@ -271,6 +493,35 @@ psa_status_t its_flash_fs_mblock_get_file_idx_flag(
 psa_status_t its_flash_fs_mblock_meta_update_finalize(
                                              struct its_flash_fs_ctx_t *fs_ctx);
 
+#if ITS_METADATA_LOG_RECORDS
+/**
+ * \brief Updates one file metadata entry and one block metadata entry in place
+ *        by appending a delta record to the active metadata block, without
+ *        swapping the metadata blocks. The current data scratch block is
+ *        committed with the record and the previous data block is erased.
+ *
+ * \note  The file data in logical block 0 is stored in the metadata block, so
+ *        the update must not have changed the data of logical block 0.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     idx         File's index in the metadata table
+ * \param[in]     file_meta   File metadata
+ * \param[in]     lblock      Logical block number
+ * \param[in]     block_meta  Block metadata
+ *
+ * \return Returns PSA_ERROR_INSUFFICIENT_STORAGE, without writing anything, if
+ *         the log is full and the update has to be done by a metadata block
+ *         swap. Otherwise, returns error code as specified in
+ *         \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_log_update(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t idx,
+                                      const struct its_file_meta_t *file_meta,
+                                      uint32_t lblock,
+                                      const struct its_block_meta_t *block_meta);
+#endif /* ITS_METADATA_LOG_RECORDS */
+
 /**
  * \brief Writes the files data area of logical block 0 into the scratch
  *        block.
@@ -376,6 +627,52 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
 void its_flash_fs_mblock_set_data_scratch(struct its_flash_fs_ctx_t *fs_ctx,
                                           uint32_t phy_id, uint32_t lblock);
 
+#if ITS_WEAR_LEVELLING
+/**
+ * \brief Exchanges the erase count of the logical block's physical block with
+ *        the erase count of the data scratch block, when the two blocks are
+ *        swapped. Calling it a second time undoes the exchange.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in,out] block_meta  Pointer to block's metadata
+ * \param[in]     lblock      Logical block number
+ */
+void its_flash_fs_mblock_swap_erase_count(struct its_flash_fs_ctx_t *fs_ctx,
+                                          struct its_block_meta_t *block_meta,
+                                          uint32_t lblock);
+
+/**
+ * \brief Gets the dedicated logical data block holding the least worn physical
+ *        block, if the data scratch block has been erased at least
+ *        ITS_WEAR_LEVELLING_THRESHOLD more times than it.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[out]    lblock  Logical block number
+ *
+ * \return Returns PSA_ERROR_DOES_NOT_EXIST if no data block has to be
+ *         relocated. Otherwise, returns error code as specified in
+ *         \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_get_cold_block(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t *lblock);
+
+/**
+ * \brief Gets the number of times a physical data block has been erased.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     block_id     Physical block ID
+ * \param[out]    erase_count  Number of times the block has been erased
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the block is a metadata block.
+ *         Otherwise, returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_get_erase_count(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t block_id,
+                                              uint32_t *erase_count);
+#endif
+
 /**
  * \brief Puts logical block's metadata in scratch metadata block
  *
@@ -7,6 +7,8 @@
 
 #include <string.h>
 
+#include "config_tfm.h"
+#include "its_crypto_interface.h"
 #include "flash_fs/its_flash_fs.h"
 #include "flash/its_flash.h"
 #include "its_utils.h"
@@ -164,3 +166,149 @@ psa_status_t tfm_its_crypt_file(struct its_flash_fs_file_info_t *finfo,
     return PSA_SUCCESS;
 }
 
+
+#if ITS_ENCRYPTION_CHUNK_SIZE
+/**
+ * \brief Fills the key derivation label of a chunk
+ *
+ * \details The label is the file ID followed by the big-endian chunk index,
+ *          so that every chunk of a file is encrypted with its own key and
+ *          chunks cannot be reordered without failing authentication. The
+ *          nonce of the file is used as is: the platform may keep a counter
+ *          in any of its bytes, so no part of it is free for the index.
+ *
+ * \param[out]  label       Derivation label of the chunk, fid_size + 4 bytes
+ * \param[in]   fid         File ID
+ * \param[in]   fid_size    Size of the file ID in bytes
+ * \param[in]   chunk_idx   Index of the chunk in the file
+ */
+static void tfm_its_chunk_label(uint8_t *label,
+                                const uint8_t *fid,
+                                const size_t fid_size,
+                                const uint32_t chunk_idx)
+{
+    memcpy(label, fid, fid_size);
+    label[fid_size]     = (uint8_t)(chunk_idx >> 24);
+    label[fid_size + 1] = (uint8_t)(chunk_idx >> 16);
+    label[fid_size + 2] = (uint8_t)(chunk_idx >> 8);
+    label[fid_size + 3] = (uint8_t)chunk_idx;
+}
+
+size_t tfm_its_enc_stored_size(const size_t data_size)
+{
+    /* An empty file still holds one chunk, to authenticate its data size */
+    size_t num_chunks = (data_size == 0) ? 1 :
+                        (data_size + ITS_ENCRYPTION_CHUNK_SIZE - 1) /
+                        ITS_ENCRYPTION_CHUNK_SIZE;
+
+    return ((num_chunks - 1) * ITS_ENC_CHUNK_STRIDE) +
+           (data_size - ((num_chunks - 1) * ITS_ENCRYPTION_CHUNK_SIZE)) +
+           TFM_ITS_AUTH_TAG_LENGTH;
+}
+
+size_t tfm_its_enc_data_size(const size_t stored_size)
+{
+    size_t num_full_chunks;
+
+    if (stored_size < TFM_ITS_AUTH_TAG_LENGTH) {
+        return 0;
+    }
+
+    /* Every chunk but the last one occupies a whole stride */
+    num_full_chunks = (stored_size - TFM_ITS_AUTH_TAG_LENGTH) /
+                      ITS_ENC_CHUNK_STRIDE;
+
+    return (num_full_chunks * ITS_ENCRYPTION_CHUNK_SIZE) +
+           (stored_size - (num_full_chunks * ITS_ENC_CHUNK_STRIDE) -
+            TFM_ITS_AUTH_TAG_LENGTH);
+}
+
+psa_status_t tfm_its_crypt_chunk(struct its_flash_fs_file_info_t *finfo,
+                                 uint8_t *fid,
+                                 const size_t fid_size,
+                                 const size_t data_size,
+                                 const uint32_t chunk_idx,
+                                 const uint8_t *input,
+                                 const size_t input_size,
+                                 uint8_t *output,
+                                 const size_t output_size,
+                                 const bool is_encrypt)
+{
+    struct tfm_hal_its_auth_crypt_ctx aead_ctx = {0};
+    uint8_t label[ITS_FILE_ID_SIZE + sizeof(uint32_t)];
+    uint8_t tag[TFM_ITS_AUTH_TAG_LENGTH];
+    enum tfm_hal_status_t err;
+    size_t text_size;
+
+    if (finfo == NULL || input == NULL || output == NULL ||
+        fid_size > ITS_FILE_ID_SIZE) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* A stored chunk is the ciphertext followed by its authentication tag */
+    if (is_encrypt) {
+        if (output_size < input_size + sizeof(tag)) {
+            return PSA_ERROR_BUFFER_TOO_SMALL;
+        }
+        text_size = input_size;
+    } else {
+        if (input_size < sizeof(tag)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        text_size = input_size - sizeof(tag);
+    }
+
+    err = tfm_its_fill_enc_add(finfo->add,
+                               sizeof(finfo->add),
+                               fid,
+                               fid_size,
+                               finfo->flags,
+                               data_size);
+    if (err != TFM_HAL_SUCCESS) {
+        return tfm_hal_to_psa_error(err);
+    }
+
+    /* A fresh file nonce is generated each time a file is written */
+    if (is_encrypt && chunk_idx == 0) {
+        err = tfm_hal_its_aead_generate_nonce(finfo->nonce,
+                                              sizeof(finfo->nonce));
+        if (err != TFM_HAL_SUCCESS) {
+            return tfm_hal_to_psa_error(err);
+        }
+    }
+
+    tfm_its_chunk_label(label, fid, fid_size, chunk_idx);
+
+    /* Set all required parameters for the aead operation context */
+    aead_ctx.nonce = finfo->nonce;
+    aead_ctx.nonce_size = sizeof(finfo->nonce);
+    aead_ctx.deriv_label = label;
+    aead_ctx.deriv_label_size = fid_size + sizeof(uint32_t);
+    aead_ctx.aad = finfo->add;
+    aead_ctx.add_size = sizeof(finfo->add);
+
+    if (is_encrypt) {
+        err = tfm_hal_its_aead_encrypt(&aead_ctx,
+                                       input,
+                                       text_size,
+                                       output,
+                                       output_size - sizeof(tag),
+                                       tag,
+                                       sizeof(tag));
+        if (err == TFM_HAL_SUCCESS) {
+            memcpy(output + text_size, tag, sizeof(tag));
+        }
+    } else {
+        memcpy(tag, input + text_size, sizeof(tag));
+        err = tfm_hal_its_aead_decrypt(&aead_ctx,
+                                       input,
+                                       text_size,
+                                       tag,
+                                       sizeof(tag),
+                                       output,
+                                       output_size);
+    }
+
+    return tfm_hal_to_psa_error(err);
+}
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
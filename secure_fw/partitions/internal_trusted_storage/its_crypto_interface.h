@@ -41,3 +41,71 @@ psa_status_t tfm_its_crypt_file(struct its_flash_fs_file_info_t *finfo,
                                 const size_t output_size,
                                 const bool is_encrypt);
 
+#if ITS_ENCRYPTION_CHUNK_SIZE
+/* Distance between the starts of two consecutive chunks of an encrypted file.
+ * Each chunk holds up to ITS_ENCRYPTION_CHUNK_SIZE bytes of ciphertext followed
+ * by its authentication tag, padded to the flash program unit.
+ */
+#define ITS_ENC_CHUNK_STRIDE \
+    ITS_UTILS_ALIGN(ITS_ENCRYPTION_CHUNK_SIZE + TFM_ITS_AUTH_TAG_LENGTH, \
+                    ITS_FLASH_MAX_ALIGNMENT)
+
+/* Upper bound of the size an encrypted file of data_size bytes occupies in the
+ * filesystem
+ */
+#define ITS_ENC_MAX_STORED_SIZE(data_size) \
+    (ITS_UTILS_MAX(((data_size) + ITS_ENCRYPTION_CHUNK_SIZE - 1) / \
+                   ITS_ENCRYPTION_CHUNK_SIZE, 1) * ITS_ENC_CHUNK_STRIDE)
+
+/**
+ * \brief Gets the size an encrypted file occupies in the filesystem
+ *
+ * \param[in]   data_size     Size of the plain file data in bytes
+ *
+ * \return Size of the stored file in bytes, including the chunk tags
+ */
+size_t tfm_its_enc_stored_size(const size_t data_size);
+
+/**
+ * \brief Gets the size of the plain data of an encrypted file
+ *
+ * \param[in]   stored_size   Size of the stored file in bytes
+ *
+ * \return Size of the plain file data in bytes
+ */
+size_t tfm_its_enc_data_size(const size_t stored_size);
+
+/**
+ * \brief Perform encryption/decryption of one chunk of a file using the
+ *        tfm_hal_its APIs
+ *
+ * \details The chunk is encrypted with the file nonce and a key derived from
+ *          the file ID and the chunk index, and authenticated with its own
+ *          tag, which is stored right after the ciphertext.
+ *
+ * \param[in]   finfo         Pointer to \ref its_flash_fs_file_info_t
+ * \param[in]   fid           File identifier
+ * \param[in]   fid_size      File identifier size in bytes
+ * \param[in]   data_size     Size of the plain file data in bytes
+ * \param[in]   chunk_idx     Index of the chunk in the file
+ * \param[in]   input         Input buffer, the stored chunk when decrypting
+ * \param[in]   input_size    Input size in bytes
+ * \param[out]  output        Output buffer, the stored chunk when encrypting
+ * \param[in]   output_size   Output size in bytes
+ * \param[in]   is_encrypt    Set the operation type (encryption/decryption)
+ *
+ * \return PSA_SUCCESS on successful operation or a valid PSA error code
+ *
+ */
+psa_status_t tfm_its_crypt_chunk(struct its_flash_fs_file_info_t *finfo,
+                                 uint8_t *fid,
+                                 const size_t fid_size,
+                                 const size_t data_size,
+                                 const uint32_t chunk_idx,
+                                 const uint8_t *input,
+                                 const size_t input_size,
+                                 uint8_t *output,
+                                 const size_t output_size,
+                                 const bool is_encrypt);
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
+
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,6 +7,8 @@
 
 #include "its_utils.h"
 
+#include <string.h>
+
 psa_status_t its_utils_check_contained_in(size_t superset_size,
                                           size_t subset_offset,
                                           size_t subset_size)
@@ -40,3 +42,33 @@ psa_status_t its_utils_validate_fid(const uint8_t *fid)
 
     return PSA_ERROR_DOES_NOT_EXIST;
 }
+
+uint8_t its_utils_xor(uint8_t xor_value, const uint8_t *data, size_t size)
+{
+    uint32_t word;
+    uint32_t xor_word = 0;
+
+    while ((size > 0) &&
+           !ITS_UTILS_IS_ALIGNED((uintptr_t)data, sizeof(uint32_t))) {
+        xor_value ^= *data++;
+        size--;
+    }
+
+    /* The XOR of the bytes is the XOR of the bytes of the XOR of the words */
+    while (size >= sizeof(uint32_t)) {
+        (void)memcpy(&word, data, sizeof(word));
+        xor_word ^= word;
+        data += sizeof(word);
+        size -= sizeof(word);
+    }
+
+    while (size > 0) {
+        xor_value ^= *data++;
+        size--;
+    }
+
+    xor_word ^= xor_word >> 16;
+    xor_word ^= xor_word >> 8;
+
+    return xor_value ^ (uint8_t)xor_word;
+}
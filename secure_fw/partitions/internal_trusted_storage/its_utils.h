@@ -94,6 +94,17 @@ psa_status_t its_utils_check_contained_in(size_t superset_size,
  */
 psa_status_t its_utils_validate_fid(const uint8_t *fid);
 
+/**
+ * \brief Calculates the XOR of all the bytes of a buffer, a word at a time.
+ *
+ * \param[in] xor_value  XOR value of the previous buffers, 0 for the first one
+ * \param[in] data       Buffer
+ * \param[in] size       Size of the buffer
+ *
+ * \return Returns xor_value XORed with all the bytes of the buffer
+ */
+uint8_t its_utils_xor(uint8_t xor_value, const uint8_t *data, size_t size);
+
 #ifdef __cplusplus
 }
 #endif
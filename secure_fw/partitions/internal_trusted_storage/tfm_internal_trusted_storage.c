@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2022 Cypress Semiconductor Corporation (an Infineon company)
  * or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
  *
@@ -35,6 +35,11 @@
 #ifndef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
 extern uint8_t *p_psa_src_data;
 extern uint8_t *p_psa_dest_data;
+#elif defined(TFM_PARTITION_PROTECTED_STORAGE) && defined(PS_ITS_DIRECT_ACCESS)
+/* The data of the calls made directly by PS, which have no message */
+uint8_t *p_psa_src_data;
+uint8_t *p_psa_dest_data;
+#define PS_DIRECT_CALL(client_id)   ((client_id) == TFM_SP_PS)
 #endif /* !TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
 static uint8_t g_fid[ITS_FILE_ID_SIZE];
@@ -51,24 +56,93 @@ static uint8_t __ALIGNED(4) asset_data[ITS_UTILS_ALIGN(ITS_BUF_SIZE,
 
 #ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
 static its_flash_fs_ctx_t fs_ctx_its;
+#if ITS_RAM_FILE_INDEX
+static uint8_t its_file_index[ITS_FLASH_FS_FILE_INDEX_SIZE(ITS_NUM_ASSETS + 1)];
+#endif
 static struct its_flash_fs_config_t fs_cfg_its = {
-    .flash_dev = &ITS_FLASH_DEV,
+    .flash_dev = &ITS_FS_FLASH_DEV,
+    .flash_map_addr = ITS_FLASH_MAP_ADDR,
     .program_unit = ITS_FLASH_ALIGNMENT,
+#if defined ITS_ENCRYPTION && ITS_ENCRYPTION_CHUNK_SIZE
+    /* Encrypted files also hold the authentication tag of each chunk */
+    .max_file_size = ITS_UTILS_ALIGN(
+                            ITS_ENC_MAX_STORED_SIZE(ITS_MAX_ASSET_SIZE),
+                            ITS_FLASH_ALIGNMENT),
+#else
     .max_file_size = ITS_UTILS_ALIGN(ITS_MAX_ASSET_SIZE, ITS_FLASH_ALIGNMENT),
+#endif
     .max_num_files = ITS_NUM_ASSETS + 1, /* Extra file for atomic replacement */
+#if ITS_RAM_FILE_INDEX
+    .file_index = its_file_index,
+#endif
 };
+
+#if ITS_NUM_SHARDS
+/* The filesystems of the client shards, each one in its own area of the ITS
+ * flash device. Their configuration is the one of the ITS filesystem, but for
+ * the flash area.
+ */
+static its_flash_fs_ctx_t fs_ctx_its_shard[ITS_NUM_SHARDS];
+#if ITS_RAM_FILE_INDEX
+static uint8_t its_shard_file_index[ITS_NUM_SHARDS]
+                        [ITS_FLASH_FS_FILE_INDEX_SIZE(ITS_NUM_ASSETS + 1)];
+#endif
+static struct its_flash_fs_config_t fs_cfg_its_shard[ITS_NUM_SHARDS];
+#endif /* ITS_NUM_SHARDS */
 #endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
 static its_flash_fs_ctx_t fs_ctx_ps;
+#if ITS_RAM_FILE_INDEX
+static uint8_t ps_file_index[ITS_FLASH_FS_FILE_INDEX_SIZE(PS_MAX_NUM_OBJECTS)];
+#endif
 static struct its_flash_fs_config_t fs_cfg_ps = {
     .flash_dev = &PS_FLASH_DEV,
+    .flash_map_addr = PS_FLASH_MAP_ADDR,
     .program_unit = PS_FLASH_ALIGNMENT,
     .max_file_size = ITS_UTILS_ALIGN(PS_MAX_OBJECT_SIZE, PS_FLASH_ALIGNMENT),
     .max_num_files = PS_MAX_NUM_OBJECTS,
+#if ITS_RAM_FILE_INDEX
+    .file_index = ps_file_index,
+#endif
 };
 #endif
 
+#if ITS_TRANSACTIONS
+/* The open transaction. The assets set in the transaction are staged files in
+ * the filesystem, the committed assets to remove are recorded here.
+ */
+static struct {
+    bool active;
+    int32_t client_id;
+    uint32_t num_remove;
+    uint8_t remove_fids[ITS_NUM_ASSETS][ITS_FILE_ID_SIZE];
+} g_transaction;
+
+static bool in_transaction(int32_t client_id)
+{
+    return g_transaction.active && (g_transaction.client_id == client_id);
+}
+#endif /* ITS_TRANSACTIONS */
+
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+static its_flash_fs_ctx_t *get_its_fs_ctx(int32_t client_id)
+{
+#if ITS_NUM_SHARDS
+    uint32_t shard = tfm_hal_its_client_shard(client_id);
+
+    /* Shard 0 is the ITS area itself */
+    if ((shard != 0) && (shard <= ITS_NUM_SHARDS)) {
+        return &fs_ctx_its_shard[shard - 1];
+    }
+#else
+    (void)client_id;
+#endif
+
+    return &fs_ctx_its;
+}
+#endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
+
 static its_flash_fs_ctx_t *get_fs_ctx(int32_t client_id)
 {
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
@@ -76,15 +150,159 @@ static its_flash_fs_ctx_t *get_fs_ctx(int32_t client_id)
     (void)client_id;
     return &fs_ctx_ps;
 #else
-    return (client_id == TFM_SP_PS) ? &fs_ctx_ps : &fs_ctx_its;
+    return (client_id == TFM_SP_PS) ? &fs_ctx_ps : get_its_fs_ctx(client_id);
 #endif /* !TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 #else
-    (void)client_id;
-    return &fs_ctx_its;
+    return get_its_fs_ctx(client_id);
 #endif
 }
 
 #ifdef ITS_ENCRYPTION
+#if ITS_ENCRYPTION_CHUNK_SIZE
+#if ITS_ENCRYPTION_CHUNK_SIZE > ITS_BUF_SIZE
+#error "ITS_ENCRYPTION_CHUNK_SIZE must not be larger than ITS_BUF_SIZE"
+#endif
+
+/* Buffer to store one encrypted chunk of asset data, followed by its tag,
+ * before it is stored in the filesystem.
+ */
+static uint8_t enc_asset_data[ITS_ENC_CHUNK_STRIDE];
+
+static bool is_encrypted_client(int32_t client_id)
+{
+/* With protected storage no encryption is used */
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    return client_id != TFM_SP_PS;
+#else
+    (void)client_id;
+    return true;
+#endif /* TFM_PARTITION_PROTECTED_STORAGE */
+}
+
+static psa_status_t tfm_its_set_encrypted(int32_t client_id,
+                                          size_t data_length)
+{
+    psa_status_t status;
+    const uint8_t *chunk;
+    size_t chunk_size;
+    size_t data_offset = 0;
+    size_t offset = 0;
+    uint32_t chunk_idx = 0;
+
+    if (data_length > ITS_MAX_ASSET_SIZE) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    g_file_info.size_max = tfm_its_enc_stored_size(data_length);
+
+    /* Iteratively read the data from the caller, encrypt it and write it to
+     * the filesystem, one chunk at a time. An empty asset is stored as one
+     * empty chunk, to authenticate its size.
+     */
+    do {
+        chunk_size = ITS_UTILS_MIN(data_length - data_offset,
+                                   ITS_ENCRYPTION_CHUNK_SIZE);
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        chunk = its_req_mngr_get_vec_base() + data_offset;
+#else
+        (void)its_req_mngr_read(asset_data, chunk_size);
+        chunk = asset_data;
+#endif
+
+        status = tfm_its_crypt_chunk(&g_file_info, g_fid, sizeof(g_fid),
+                                     data_length, chunk_idx,
+                                     chunk, chunk_size,
+                                     enc_asset_data, sizeof(enc_asset_data),
+                                     true);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        data_offset += chunk_size;
+
+        /* All chunks but the last one are padded to the chunk stride */
+        if (data_offset < data_length) {
+            chunk_size = sizeof(enc_asset_data);
+        } else {
+            chunk_size += TFM_ITS_AUTH_TAG_LENGTH;
+        }
+
+        status = its_flash_fs_file_write(get_fs_ctx(client_id), g_fid,
+                                         &g_file_info, chunk_size, offset,
+                                         enc_asset_data);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        /* Do not create or truncate after the first chunk */
+        g_file_info.flags &= ~(ITS_FLASH_FS_FLAG_CREATE |
+                               ITS_FLASH_FS_FLAG_TRUNCATE);
+
+        offset += chunk_size;
+        chunk_idx++;
+    } while (data_offset < data_length);
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t tfm_its_get_encrypted(int32_t client_id,
+                         size_t data_offset,
+                         size_t data_size,
+                         size_t *p_data_length)
+{
+    psa_status_t status;
+    uint32_t chunk_idx = data_offset / ITS_ENCRYPTION_CHUNK_SIZE;
+    size_t chunk_offset = data_offset % ITS_ENCRYPTION_CHUNK_SIZE;
+    size_t chunk_size;
+    size_t copy_size;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    uint8_t *dest = its_req_mngr_get_vec_base();
+#endif
+
+    /* Only the chunks holding the requested range are read and decrypted */
+    while (data_size > 0) {
+        chunk_size = ITS_UTILS_MIN(g_file_info.size_current -
+                                   (chunk_idx * ITS_ENCRYPTION_CHUNK_SIZE),
+                                   ITS_ENCRYPTION_CHUNK_SIZE);
+
+        status = its_flash_fs_file_read(get_fs_ctx(client_id), g_fid,
+                                        chunk_size + TFM_ITS_AUTH_TAG_LENGTH,
+                                        chunk_idx * ITS_ENC_CHUNK_STRIDE,
+                                        enc_asset_data);
+        if (status != PSA_SUCCESS) {
+            *p_data_length = 0;
+            return status;
+        }
+
+        status = tfm_its_crypt_chunk(&g_file_info, g_fid, sizeof(g_fid),
+                                     g_file_info.size_current, chunk_idx,
+                                     enc_asset_data,
+                                     chunk_size + TFM_ITS_AUTH_TAG_LENGTH,
+                                     asset_data, sizeof(asset_data),
+                                     false);
+        if (status != PSA_SUCCESS) {
+            *p_data_length = 0;
+            return status;
+        }
+
+        copy_size = ITS_UTILS_MIN(chunk_size - chunk_offset, data_size);
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        memcpy(dest, asset_data + chunk_offset, copy_size);
+        dest += copy_size;
+#else
+        its_req_mngr_write(asset_data + chunk_offset, copy_size);
+#endif
+
+        data_size -= copy_size;
+        chunk_offset = 0;
+        chunk_idx++;
+    }
+
+    return PSA_SUCCESS;
+}
+#else
 /* Buffer to store the encrypted asset data before it is stored in the
  * filesystem.
  */
@@ -182,6 +400,7 @@ static psa_status_t tfm_its_get_encrypted(int32_t client_id,
 
     return PSA_SUCCESS;
 }
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
 #endif /* ITS_ENCRYPTION */
 
 /**
@@ -233,6 +452,79 @@ static psa_status_t init_its_fs_cfg(void)
 
     return PSA_SUCCESS;
 }
+
+#if ITS_NUM_SHARDS
+static bool its_areas_overlap(const struct its_flash_fs_config_t *a,
+                              const struct its_flash_fs_config_t *b)
+{
+    return (a->flash_area_addr < b->flash_area_addr
+                                 + (b->block_size * b->num_blocks)) &&
+           (b->flash_area_addr < a->flash_area_addr
+                                 + (a->block_size * a->num_blocks));
+}
+
+/**
+ * \brief Initialise and prepare the filesystem of a client shard. Called after
+ *        the ITS filesystem and the shards before it are initialised.
+ *
+ * \param[in] shard  Index of the shard, from 0 to ITS_NUM_SHARDS - 1
+ *
+ * \return Returns PSA_ERROR_PROGRAMMER_ERROR if there is a configuration error,
+ *         and the status of the filesystem preparation otherwise.
+ */
+static psa_status_t init_its_shard_fs(uint32_t shard)
+{
+    struct tfm_hal_its_fs_info_t its_fs_info;
+    struct its_flash_fs_config_t *cfg = &fs_cfg_its_shard[shard];
+    its_flash_fs_ctx_t *fs_ctx = &fs_ctx_its_shard[shard];
+    psa_status_t status;
+    uint32_t i;
+
+    /* Retrieve the flash area of the shard from the ITS HAL */
+    if (tfm_hal_its_shard_fs_info(shard + 1, &its_fs_info) != TFM_HAL_SUCCESS) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    *cfg = fs_cfg_its;
+    cfg->flash_area_addr = its_fs_info.flash_area_addr;
+    cfg->block_size = cfg->sector_size * its_fs_info.sectors_per_block;
+    cfg->num_blocks = its_fs_info.flash_area_size / cfg->block_size;
+#if ITS_RAM_FILE_INDEX
+    cfg->file_index = its_shard_file_index[shard];
+#endif
+
+    /* The shards must not share flash with each other or with ITS */
+    if (its_areas_overlap(cfg, &fs_cfg_its)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+    for (i = 0; i < shard; i++) {
+        if (its_areas_overlap(cfg, &fs_cfg_its_shard[i])) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+    }
+
+    status = its_flash_fs_init_ctx(fs_ctx, cfg, &ITS_FLASH_OPS);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    status = its_flash_fs_prepare(fs_ctx);
+#if ITS_CREATE_FLASH_LAYOUT
+    /* Same as for the ITS area, see tfm_its_init() */
+    if (status != PSA_SUCCESS) {
+        LOG_INFFMT("Creating an empty ITS shard flash layout.\r\n");
+        status = its_flash_fs_wipe_all(fs_ctx);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        status = its_flash_fs_prepare(fs_ctx);
+    }
+#endif /* ITS_CREATE_FLASH_LAYOUT */
+
+    return status;
+}
+#endif /* ITS_NUM_SHARDS */
 #endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
@@ -273,6 +565,9 @@ static psa_status_t init_ps_fs_cfg(void)
 psa_status_t tfm_its_init(void)
 {
     psa_status_t status = PSA_SUCCESS;
+#if defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE) && ITS_NUM_SHARDS
+    uint32_t shard;
+#endif
 
 #ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
     status = init_its_fs_cfg();
@@ -280,8 +575,13 @@ psa_status_t tfm_its_init(void)
         return status;
     }
 
+#if ITS_FLASH_CACHE
+    /* The cache writes the active metadata block back after the others */
+    ITS_FS_FLASH_DEV.last_block_id = &fs_ctx_its.active_metablock;
+#endif
+
     /* Initialise the ITS filesystem context */
-    status = its_flash_fs_init_ctx(&fs_ctx_its, &fs_cfg_its, &ITS_FLASH_OPS);
+    status = its_flash_fs_init_ctx(&fs_ctx_its, &fs_cfg_its, &ITS_FS_FLASH_OPS);
     if (status != PSA_SUCCESS) {
         return status;
     }
@@ -314,6 +614,13 @@ psa_status_t tfm_its_init(void)
         status = its_flash_fs_prepare(&fs_ctx_its);
     }
 #endif /* ITS_CREATE_FLASH_LAYOUT */
+
+#if ITS_NUM_SHARDS
+    for (shard = 0; (status == PSA_SUCCESS) && (shard < ITS_NUM_SHARDS);
+         shard++) {
+        status = init_its_shard_fs(shard);
+    }
+#endif
 #endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
@@ -368,6 +675,10 @@ psa_status_t tfm_its_init(void)
 
 static psa_status_t get_file_info(psa_storage_uid_t uid, int32_t client_id)
 {
+#if defined ITS_ENCRYPTION && ITS_ENCRYPTION_CHUNK_SIZE
+    psa_status_t status;
+#endif
+
     /* Check that the UID is valid */
     if (uid == TFM_ITS_INVALID_UID) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -377,8 +688,21 @@ static psa_status_t get_file_info(psa_storage_uid_t uid, int32_t client_id)
     tfm_its_get_fid(client_id, uid, g_fid);
 
     /* Read file info */
+#if defined ITS_ENCRYPTION && ITS_ENCRYPTION_CHUNK_SIZE
+    status = its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
+                                        &g_file_info);
+    if (status == PSA_SUCCESS && is_encrypted_client(client_id)) {
+        /* Report the size of the plain data, without the chunk tags */
+        g_file_info.size_current =
+            tfm_its_enc_data_size(g_file_info.size_current);
+        g_file_info.size_max = g_file_info.size_current;
+    }
+
+    return status;
+#else
     return its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
                                       &g_file_info);
+#endif
 }
 
 
@@ -391,7 +715,7 @@ static psa_status_t tfm_its_write_data_to_fs(const int32_t client_id,
 {
     psa_status_t status;
     uint8_t *buffer_ptr = data;
-#ifdef ITS_ENCRYPTION /* ITS_ENCRYPTION */
+#if defined(ITS_ENCRYPTION) && !ITS_ENCRYPTION_CHUNK_SIZE
     /* If the data will be encrypted the whole file needs to be written */
     if (offset != 0) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -400,7 +724,7 @@ static psa_status_t tfm_its_write_data_to_fs(const int32_t client_id,
     if (status != PSA_SUCCESS) {
         return status;
     }
-#endif /* ITS_ENCRYPTION */
+#endif /* ITS_ENCRYPTION && !ITS_ENCRYPTION_CHUNK_SIZE */
     status = its_flash_fs_file_write(get_fs_ctx(client_id),
                                         fid,
                                         &g_file_info,
@@ -435,7 +759,8 @@ psa_status_t tfm_its_set(int32_t client_id,
         return PSA_ERROR_NOT_SUPPORTED;
     }
 
-#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE \
+    && !ITS_ENCRYPTION_CHUNK_SIZE
     status = buffer_size_check(client_id, data_length);
     if (status != PSA_SUCCESS) {
         return status;
@@ -462,6 +787,20 @@ psa_status_t tfm_its_set(int32_t client_id,
     g_file_info.flags = (uint32_t)create_flags |
                         ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE;
 
+#if ITS_TRANSACTIONS
+    /* Inside a transaction, write a staged copy that replaces the asset on
+     * commit.
+     */
+    if (in_transaction(client_id)) {
+        g_file_info.flags |= ITS_FLASH_FS_FLAG_STAGED;
+    }
+#endif
+
+#if defined ITS_ENCRYPTION && ITS_ENCRYPTION_CHUNK_SIZE
+    if (is_encrypted_client(client_id)) {
+        return tfm_its_set_encrypted(client_id, data_length);
+    }
+#endif
 
 #ifndef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
     /* Write to the file in the file system
@@ -470,7 +809,16 @@ psa_status_t tfm_its_set(int32_t client_id,
      */
     status = its_flash_fs_file_write(get_fs_ctx(client_id), g_fid, &g_file_info,
                                      data_length, 0, p_psa_src_data);
-#elif PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+#else
+#ifdef PS_DIRECT_CALL
+    /* PS data is not encrypted by ITS, write it straight from the PS buffer */
+    if (PS_DIRECT_CALL(client_id)) {
+        return its_flash_fs_file_write(get_fs_ctx(client_id), g_fid,
+                                       &g_file_info, data_length, 0,
+                                       p_psa_src_data);
+    }
+#endif
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
     status = tfm_its_write_data_to_fs(client_id,
                                       g_fid,
                                       &g_file_info,
@@ -501,7 +849,8 @@ psa_status_t tfm_its_set(int32_t client_id,
         offset += write_size;
         data_length -= write_size;
     } while (data_length > 0);
-#endif
+#endif /* PSA_FRAMEWORK_HAS_MM_IOVEC == 1 */
+#endif /* !TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
     return status;
 }
@@ -515,6 +864,7 @@ static psa_status_t tfm_its_get_plain(int32_t client_id,
 
 #if (PSA_FRAMEWORK_HAS_MM_IOVEC != 1) && defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
     size_t read_size;
+    const uint8_t *mapped_data;
 #endif
 
 #ifndef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
@@ -526,7 +876,20 @@ static psa_status_t tfm_its_get_plain(int32_t client_id,
         return status;
     }
 
-#elif (PSA_FRAMEWORK_HAS_MM_IOVEC == 1)
+#else
+#ifdef PS_DIRECT_CALL
+    /* Read the file data straight into the PS buffer */
+    if (PS_DIRECT_CALL(client_id)) {
+        status = its_flash_fs_file_read(get_fs_ctx(client_id), g_fid,
+                                        data_size, data_offset,
+                                        p_psa_dest_data);
+        if (status != PSA_SUCCESS) {
+            *p_data_length = 0;
+        }
+        return status;
+    }
+#endif
+#if (PSA_FRAMEWORK_HAS_MM_IOVEC == 1)
     /* Read file data from the filesystem */
     status = its_flash_fs_file_read(get_fs_ctx(client_id), g_fid, data_size,
                                     data_offset, its_req_mngr_get_vec_base());
@@ -537,6 +900,19 @@ static psa_status_t tfm_its_get_plain(int32_t client_id,
 
 #else
 
+    /* When the storage is directly addressable, write the file data to the
+     * caller straight from it, without staging it in the asset_data buffer.
+     */
+    status = its_flash_fs_file_map(get_fs_ctx(client_id), g_fid, data_size,
+                                   data_offset, &mapped_data);
+    if (status == PSA_SUCCESS) {
+        its_req_mngr_write(mapped_data, data_size);
+        return PSA_SUCCESS;
+    } else if (status != PSA_ERROR_NOT_SUPPORTED) {
+        *p_data_length = 0;
+        return status;
+    }
+
     /* Iteratively read data from the filesystem and write it to the caller, in
      * chunks no larger than the size of the asset_data buffer.
      */
@@ -558,7 +934,8 @@ static psa_status_t tfm_its_get_plain(int32_t client_id,
         data_offset += read_size;
         data_size -= read_size;
     } while (data_size > 0);
-#endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE & PSA_FRAMEWORK_HAS_MM_IOVEC */
+#endif /* PSA_FRAMEWORK_HAS_MM_IOVEC */
+#endif /* !TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
     return PSA_SUCCESS;
 }
@@ -585,7 +962,8 @@ psa_status_t tfm_its_get(int32_t client_id,
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE \
+    && !ITS_ENCRYPTION_CHUNK_SIZE
     status = buffer_size_check(client_id, data_offset + data_size);
     if (status != PSA_SUCCESS) {
         return status;
@@ -646,6 +1024,64 @@ psa_status_t tfm_its_get_info(int32_t client_id, psa_storage_uid_t uid,
     return PSA_SUCCESS;
 }
 
+#if ITS_TRANSACTIONS
+/**
+ * \brief Removes the asset whose file ID is in g_fid within the open
+ *        transaction.
+ *
+ * \param[in] client_id    Identifier of the asset's owner (client)
+ * \param[in] info_status  Status of reading the committed asset's file info
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+static psa_status_t tfm_its_transaction_remove(int32_t client_id,
+                                               psa_status_t info_status)
+{
+    psa_status_t status;
+    uint32_t i;
+
+    if (info_status == PSA_SUCCESS) {
+        /* If the object exists and has the write once flag set, then it
+         * cannot be deleted.
+         */
+        if (g_file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+            return PSA_ERROR_NOT_PERMITTED;
+        }
+    } else if (info_status != PSA_ERROR_DOES_NOT_EXIST) {
+        return info_status;
+    }
+
+    /* Drop the staged copy, if the asset was set earlier in the transaction */
+    status = its_flash_fs_file_delete_staged(get_fs_ctx(client_id), g_fid);
+    if ((status != PSA_SUCCESS) && (status != PSA_ERROR_DOES_NOT_EXIST)) {
+        return status;
+    }
+
+    /* Without a committed asset there is nothing else to remove */
+    if (info_status == PSA_ERROR_DOES_NOT_EXIST) {
+        return status;
+    }
+
+    /* The committed asset is removed on commit */
+    for (i = 0; i < g_transaction.num_remove; i++) {
+        if (!memcmp(g_transaction.remove_fids[i], g_fid, ITS_FILE_ID_SIZE)) {
+            return PSA_SUCCESS;
+        }
+    }
+
+    if (g_transaction.num_remove == ITS_NUM_ASSETS) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    memcpy(g_transaction.remove_fids[g_transaction.num_remove], g_fid,
+           ITS_FILE_ID_SIZE);
+    g_transaction.num_remove++;
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_TRANSACTIONS */
+
 psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
 {
     psa_status_t status;
@@ -661,6 +1097,11 @@ psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
 
     /* Validate and read file info */
     status = get_file_info(uid, client_id);
+#if ITS_TRANSACTIONS
+    if (in_transaction(client_id)) {
+        return tfm_its_transaction_remove(client_id, status);
+    }
+#endif
     if (status != PSA_SUCCESS) {
         return status;
     }
@@ -675,3 +1116,121 @@ psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
     /* Delete old file from the persistent area */
     return its_flash_fs_file_delete(get_fs_ctx(client_id), g_fid);
 }
+
+#if ITS_DEFERRED_COMPACTION
+psa_status_t tfm_its_compact(void)
+{
+    psa_status_t status = PSA_ERROR_DOES_NOT_EXIST;
+
+#if defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE) && ITS_NUM_SHARDS
+    uint32_t shard;
+#endif
+
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    status = its_flash_fs_compact(&fs_ctx_its);
+#if ITS_NUM_SHARDS
+    for (shard = 0; (status == PSA_ERROR_DOES_NOT_EXIST) &&
+                    (shard < ITS_NUM_SHARDS); shard++) {
+        status = its_flash_fs_compact(&fs_ctx_its_shard[shard]);
+    }
+#endif
+#endif
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (status == PSA_ERROR_DOES_NOT_EXIST) {
+        status = its_flash_fs_compact(&fs_ctx_ps);
+    }
+#endif
+
+    return status;
+}
+#endif /* ITS_DEFERRED_COMPACTION */
+
+#if ITS_FLASH_CACHE
+psa_status_t tfm_its_cache_write_back(bool force)
+{
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    if (!force && ((ITS_FLASH_CACHE_FLUSH_UPDATES == 0) ||
+                   (its_flash_cache_num_updates(&fs_cfg_its)
+                    < ITS_FLASH_CACHE_FLUSH_UPDATES))) {
+        return PSA_SUCCESS;
+    }
+
+    return its_flash_cache_write_back(&fs_cfg_its);
+#else
+    (void)force;
+
+    return PSA_SUCCESS;
+#endif
+}
+#endif /* ITS_FLASH_CACHE */
+
+#if ITS_TRANSACTIONS
+psa_status_t tfm_its_begin(int32_t client_id)
+{
+    if (g_transaction.active) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    g_transaction.active = true;
+    g_transaction.client_id = client_id;
+    g_transaction.num_remove = 0;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_its_commit(int32_t client_id)
+{
+    psa_status_t status;
+    its_flash_fs_ctx_t *fs_ctx = get_fs_ctx(client_id);
+
+    if (!in_transaction(client_id)) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    status = its_flash_fs_commit_staged(fs_ctx,
+                                        &g_transaction.remove_fids[0][0],
+                                        g_transaction.num_remove);
+    if (status != PSA_SUCCESS) {
+        /* Do not leave the staged files of a failed commit behind */
+        (void)its_flash_fs_discard_staged(fs_ctx);
+    }
+
+    g_transaction.active = false;
+
+    return status;
+}
+
+psa_status_t tfm_its_abort(int32_t client_id)
+{
+    if (!in_transaction(client_id)) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    g_transaction.active = false;
+
+    return its_flash_fs_discard_staged(get_fs_ctx(client_id));
+}
+#endif /* ITS_TRANSACTIONS */
+
+#if ITS_WEAR_LEVELLING
+psa_status_t tfm_its_erase_count(uint32_t block_id, uint32_t *erase_count)
+{
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    return its_flash_fs_get_erase_count(&fs_ctx_its, block_id, erase_count);
+#else
+    (void)block_id;
+    (void)erase_count;
+
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
+#endif /* ITS_WEAR_LEVELLING */
+
+#if ITS_FLASH_STATS
+psa_status_t tfm_its_flash_stats(int32_t client_id,
+                                 struct its_flash_fs_stats_t *stats)
+{
+    return its_flash_fs_get_stats(get_fs_ctx(client_id), stats);
+}
+#endif /* ITS_FLASH_STATS */
@@ -163,6 +163,118 @@ psa_status_t tfm_its_get_info(int32_t client_id, psa_storage_uid_t uid,
  */
 psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid);
 
+#if ITS_DEFERRED_COMPACTION
+/**
+ * \brief Reclaims the space of one removed or replaced asset
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                 The space of one asset has been reclaimed
+ * \retval PSA_ERROR_DOES_NOT_EXIST    There is no space left to reclaim
+ * \retval PSA_ERROR_STORAGE_FAILURE   The operation failed because the physical
+ *                                     storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_compact(void);
+#endif
+
+#if ITS_FLASH_CACHE
+/**
+ * \brief Writes the blocks modified in the RAM cache of the ITS area back to
+ *        flash, when the number of blocks updated since the last write-back
+ *        reaches ITS_FLASH_CACHE_FLUSH_UPDATES or when forced
+ *
+ * \param[in] force  Whether to write back whatever the number of updates
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                 The cache is written back, or does not
+ *                                     need to be yet
+ * \retval PSA_ERROR_STORAGE_FAILURE   The operation failed because the physical
+ *                                     storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_cache_write_back(bool force);
+#endif
+
+#if ITS_TRANSACTIONS
+/**
+ * \brief Begins a transaction. Until it is committed or aborted, the assets
+ *        set or removed by the client are only updated on commit.
+ *
+ * \param[in] client_id  Identifier of the transaction's owner (client)
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                 The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE         The operation failed because a
+ *                                     transaction is already open
+ */
+psa_status_t tfm_its_begin(int32_t client_id);
+
+/**
+ * \brief Commits the client's transaction, updating all its assets atomically
+ *
+ * \param[in] client_id  Identifier of the transaction's owner (client)
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                 The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE         The operation failed because the client
+ *                                     has no open transaction
+ * \retval PSA_ERROR_STORAGE_FAILURE   The operation failed because the physical
+ *                                     storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_commit(int32_t client_id);
+
+/**
+ * \brief Aborts the client's transaction, discarding all its changes
+ *
+ * \param[in] client_id  Identifier of the transaction's owner (client)
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                 The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE         The operation failed because the client
+ *                                     has no open transaction
+ * \retval PSA_ERROR_STORAGE_FAILURE   The operation failed because the physical
+ *                                     storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_abort(int32_t client_id);
+#endif
+
+#if ITS_WEAR_LEVELLING
+/**
+ * \brief Gets the number of times a flash block of the ITS area has been
+ *        erased
+ *
+ * \param[in]  block_id     Index of the flash block in the ITS area
+ * \param[out] erase_count  Number of times the block has been erased
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                 The operation completed successfully
+ * \retval PSA_ERROR_INVALID_ARGUMENT  The operation failed because the block
+ *                                     does not exist
+ * \retval PSA_ERROR_NOT_SUPPORTED     The operation failed because the block
+ *                                     is a metadata block
+ */
+psa_status_t tfm_its_erase_count(uint32_t block_id, uint32_t *erase_count);
+#endif
+
+#if ITS_FLASH_STATS
+/**
+ * \brief Gets the flash operations issued by the filesystem of the client
+ *
+ * \param[in]  client_id  Identifier of the asset's owner (client)
+ * \param[out] stats      Flash operation counters
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                 The operation completed successfully
+ */
+psa_status_t tfm_its_flash_stats(int32_t client_id,
+                                 struct its_flash_fs_stats_t *stats);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
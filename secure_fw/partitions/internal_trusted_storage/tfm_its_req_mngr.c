@@ -129,6 +129,170 @@ static psa_status_t tfm_its_get_info_req(const psa_msg_t *msg)
     return status;
 }
 
+#if ITS_WEAR_LEVELLING
+static psa_status_t tfm_its_get_erase_count_req(const psa_msg_t *msg)
+{
+    psa_status_t status;
+    uint32_t block_id;
+    uint32_t erase_count;
+    size_t num;
+
+    if (msg->in_size[0] != sizeof(block_id) ||
+        msg->out_size[0] != sizeof(erase_count)) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    num = psa_read(msg->handle, 0, &block_id, sizeof(block_id));
+    if (num != sizeof(block_id)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    status = tfm_its_erase_count(block_id, &erase_count);
+    if (status == PSA_SUCCESS) {
+        psa_write(msg->handle, 0, &erase_count, sizeof(erase_count));
+    }
+
+    return status;
+}
+#endif
+
+#if ITS_FLASH_STATS
+static psa_status_t tfm_its_get_flash_stats_req(const psa_msg_t *msg)
+{
+    psa_status_t status;
+    struct its_flash_fs_stats_t fs_stats;
+    struct tfm_its_flash_stats_t stats;
+
+    if (msg->out_size[0] != sizeof(stats)) {
+        /* The output argument size is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    status = tfm_its_flash_stats(msg->client_id, &fs_stats);
+    if (status == PSA_SUCCESS) {
+        stats.reads = fs_stats.read_ops;
+        stats.bytes_read = fs_stats.read_bytes;
+        stats.programs = fs_stats.program_ops;
+        stats.bytes_programmed = fs_stats.program_bytes;
+        stats.erases = fs_stats.erase_ops;
+        stats.bytes_written = fs_stats.logical_bytes;
+        psa_write(msg->handle, 0, &stats, sizeof(stats));
+    }
+
+    return status;
+}
+#endif
+
+#if ITS_MULTI_ASSET
+/*
+ * The data of each asset follows the data of the previous one in the data
+ * vector. The assets are accessed in one call, but each through the same path
+ * as a single asset.
+ */
+static psa_status_t tfm_its_get_multi_req(const psa_msg_t *msg)
+{
+    psa_status_t status = PSA_SUCCESS;
+    struct tfm_its_get_desc_t desc;
+    size_t count;
+    size_t data_length;
+    size_t data_left = msg->out_size[0];
+    size_t i;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    uint8_t *base = NULL;
+#endif
+
+    count = msg->in_size[0] / sizeof(desc);
+    if ((msg->in_size[0] % sizeof(desc) != 0) ||
+        (msg->out_size[1] != count * sizeof(data_length))) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    if (data_left) {
+        base = (uint8_t *)psa_map_outvec(msg->handle, 0);
+    }
+#else
+    handle = msg->handle;
+#endif
+
+    for (i = 0; i < count; i++) {
+        if ((psa_read(msg->handle, 0, &desc, sizeof(desc)) != sizeof(desc)) ||
+            (desc.data_size > data_left)) {
+            status = PSA_ERROR_PROGRAMMER_ERROR;
+            break;
+        }
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        p_data = desc.data_size ?
+                 base + (msg->out_size[0] - data_left) : NULL;
+#endif
+        status = tfm_its_get(msg->client_id, desc.uid, desc.data_offset,
+                             desc.data_size, &data_length);
+        if (status != PSA_SUCCESS) {
+            break;
+        }
+
+        psa_write(msg->handle, 1, &data_length, sizeof(data_length));
+        data_left -= data_length;
+    }
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    if (base != NULL) {
+        psa_unmap_outvec(msg->handle, 0, msg->out_size[0] - data_left);
+    }
+#endif
+
+    return status;
+}
+
+static psa_status_t tfm_its_set_multi_req(const psa_msg_t *msg)
+{
+    psa_status_t status;
+    struct tfm_its_set_desc_t desc;
+    size_t count;
+    size_t data_left = msg->in_size[1];
+    size_t i;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    uint8_t *base = NULL;
+#endif
+
+    count = msg->in_size[0] / sizeof(desc);
+    if (msg->in_size[0] % sizeof(desc) != 0) {
+        /* The size of the descriptors is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    if (data_left) {
+        base = (uint8_t *)psa_map_invec(msg->handle, 1);
+    }
+#else
+    handle = msg->handle;
+#endif
+
+    for (i = 0; i < count; i++) {
+        if ((psa_read(msg->handle, 0, &desc, sizeof(desc)) != sizeof(desc)) ||
+            (desc.data_length > data_left)) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        p_data = desc.data_length ?
+                 base + (msg->in_size[1] - data_left) : NULL;
+#endif
+        status = tfm_its_set(msg->client_id, desc.uid, desc.data_length,
+                             desc.create_flags);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        data_left -= desc.data_length;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif
+
 static psa_status_t tfm_its_remove_req(const psa_msg_t *msg)
 {
     psa_storage_uid_t uid;
@@ -152,7 +316,31 @@ psa_status_t tfm_its_entry(void)
     return tfm_its_init();
 }
 
+#if ITS_FLASH_CACHE
+static psa_status_t tfm_its_handle_req(const psa_msg_t *msg);
+
 psa_status_t tfm_internal_trusted_storage_service_sfn(const psa_msg_t *msg)
+{
+    psa_status_t status;
+
+    if (msg->type == TFM_ITS_CACHE_FLUSH) {
+        return tfm_its_cache_write_back(true);
+    }
+
+    status = tfm_its_handle_req(msg);
+
+    /* The request has been applied to the cache. A failed write-back leaves
+     * the blocks modified, to be written back again after the next request.
+     */
+    (void)tfm_its_cache_write_back(false);
+
+    return status;
+}
+
+static psa_status_t tfm_its_handle_req(const psa_msg_t *msg)
+#else
+psa_status_t tfm_internal_trusted_storage_service_sfn(const psa_msg_t *msg)
+#endif /* ITS_FLASH_CACHE */
 {
     switch (msg->type) {
     case TFM_ITS_SET:
@@ -163,6 +351,32 @@ psa_status_t tfm_internal_trusted_storage_service_sfn(const psa_msg_t *msg)
         return tfm_its_get_info_req(msg);
     case TFM_ITS_REMOVE:
         return tfm_its_remove_req(msg);
+#if ITS_DEFERRED_COMPACTION
+    case TFM_ITS_COMPACT:
+        return tfm_its_compact();
+#endif
+#if ITS_TRANSACTIONS
+    case TFM_ITS_TRANSACTION_BEGIN:
+        return tfm_its_begin(msg->client_id);
+    case TFM_ITS_TRANSACTION_COMMIT:
+        return tfm_its_commit(msg->client_id);
+    case TFM_ITS_TRANSACTION_ABORT:
+        return tfm_its_abort(msg->client_id);
+#endif
+#if ITS_WEAR_LEVELLING
+    case TFM_ITS_GET_ERASE_COUNT:
+        return tfm_its_get_erase_count_req(msg);
+#endif
+#if ITS_FLASH_STATS
+    case TFM_ITS_GET_FLASH_STATS:
+        return tfm_its_get_flash_stats_req(msg);
+#endif
+#if ITS_MULTI_ASSET
+    case TFM_ITS_GET_MULTI:
+        return tfm_its_get_multi_req(msg);
+    case TFM_ITS_SET_MULTI:
+        return tfm_its_set_multi_req(msg);
+#endif
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -7,6 +7,7 @@
 #ifndef __SERVICE_API_H__
 #define __SERVICE_API_H__
 
+#include <stddef.h>
 #include <stdint.h>
 #include "tfm_boot_status.h"
 #include "psa/error.h"
@@ -23,4 +24,41 @@ psa_status_t tfm_core_get_boot_data(uint8_t major_type,
                                     struct tfm_boot_data *boot_data,
                                     uint32_t len);
 
+/**
+ * \brief Lets the pending Non-Secure interrupts be taken, when they are masked
+ *        during Secure thread execution with
+ *        CONFIG_TFM_SECURE_THREAD_MASK_NS_INTERRUPT. Long operations call it
+ *        at points where they hold no lock and no hardware state that an
+ *        interrupt could disturb, so that the Non-Secure interrupt latency is
+ *        bound by the time between two calls. The Non-Secure exceptions of
+ *        the lowest priority, such as the PendSV of an OS, stay masked. It
+ *        does nothing in other configurations.
+ */
+void tfm_preemption_point(void);
+
+/**
+ * \brief Writes the data cache lines of a buffer back to memory before a DMA
+ *        master reads it. Requires CONFIG_TFM_CACHE_MAINTENANCE_API.
+ *
+ * \param[in] addr   Start of the buffer, which the partition can access.
+ * \param[in] size   Size of the buffer in bytes.
+ *
+ * \retval PSA_SUCCESS                 The buffer is in memory.
+ * \retval PSA_ERROR_INVALID_ARGUMENT  The platform rejected the range.
+ */
+psa_status_t tfm_cache_clean(const void *addr, size_t size);
+
+/**
+ * \brief Discards the data cache lines of a buffer after a DMA master wrote
+ *        it. The buffer must start and end on data cache line boundaries.
+ *        Requires CONFIG_TFM_CACHE_MAINTENANCE_API.
+ *
+ * \param[in] addr   Start of the buffer, which the partition can write.
+ * \param[in] size   Size of the buffer in bytes.
+ *
+ * \retval PSA_SUCCESS                 The CPU reads the buffer from memory.
+ * \retval PSA_ERROR_INVALID_ARGUMENT  The range is not cache line aligned.
+ */
+psa_status_t tfm_cache_invalidate(void *addr, size_t size);
+
 #endif /* __SERVICE_API_H__ */
@@ -6,6 +6,7 @@
  */
 
 #include "cmsis_compiler.h"
+#include "config_tfm.h"
 #include "service_api.h"
 #include "psa/service.h"
 #include "svc_num.h"
@@ -22,6 +23,43 @@ psa_status_t tfm_core_get_boot_data(uint8_t major_type,
         );
 }
 
+#if (CONFIG_TFM_SECURE_THREAD_MASK_NS_INTERRUPT == 1) && defined(CONFIG_TFM_USE_TRUSTZONE)
+/* The pending NS interrupts are taken between the two SVCs */
+__attribute__((naked))
+void tfm_preemption_point(void)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_PREEMPTION_POINT_OPEN)"       \n"
+        "SVC    "M2S(TFM_SVC_PREEMPTION_POINT_CLOSE)"      \n"
+        "BX     lr                                         \n"
+        );
+}
+#else
+void tfm_preemption_point(void)
+{
+}
+#endif
+
+#if CONFIG_TFM_CACHE_MAINTENANCE_API == 1
+__attribute__((naked))
+psa_status_t tfm_cache_clean(const void *addr, size_t size)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_CACHE_CLEAN)"                 \n"
+        "BX     lr                                         \n"
+        );
+}
+
+__attribute__((naked))
+psa_status_t tfm_cache_invalidate(void *addr, size_t size)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_CACHE_INVALIDATE)"            \n"
+        "BX     lr                                         \n"
+        );
+}
+#endif
+
 #if TFM_ISOLATION_LEVEL != 1
 /* Entry point when Partition FLIH functions return */
 __attribute__((naked))
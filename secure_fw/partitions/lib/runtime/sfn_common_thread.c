@@ -8,8 +8,10 @@
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "config_tfm.h"
 #include "runtime_defs.h"
 #include "sprt_partition_metadata_indicator.h"
 #include "tfm_sp_log.h"
@@ -17,26 +19,40 @@
 #include "psa/error.h"
 #include "psa/service.h"
 
-void common_sfn_thread(void *param)
+static void sfn_thread_loop(void *param, bool initialized)
 {
     psa_signal_t sig_asserted, signal_mask, sig;
     psa_msg_t msg;
     struct runtime_metadata_t *meta;
     service_fn_t *p_sfn_table;
     sfn_init_fn_t sfn_init;
+    bool init_pending;
 
     meta = PART_METADATA();
     sfn_init = (sfn_init_fn_t)meta->entry;
     p_sfn_table = (service_fn_t *)meta->sfn_table;
     signal_mask = (1UL << meta->n_sfn) - 1;
+    init_pending = (sfn_init != NULL) && !initialized;
 
-    if (sfn_init && sfn_init(param) != PSA_SUCCESS) {
-        LOG_ERRFMT("Partition initialization FAILED in 0x%x\r\n", sfn_init);
-        psa_panic();
+    /* A deferred initialization runs when the first signal is asserted */
+    if (init_pending && !meta->deferred_init) {
+        if (sfn_init(param) != PSA_SUCCESS) {
+            LOG_ERRFMT("Partition initialization FAILED in 0x%x\r\n", sfn_init);
+            psa_panic();
+        }
+        init_pending = false;
     }
 
     while (1) {
         sig_asserted = psa_wait(signal_mask, PSA_BLOCK);
+
+        if (init_pending) {
+            if (sfn_init(param) != PSA_SUCCESS) {
+                LOG_ERRFMT("Partition initialization FAILED in 0x%x\r\n", sfn_init);
+                psa_panic();
+            }
+            init_pending = false;
+        }
         /* Handle signals */
         for (int i = 0; sig_asserted != 0 && i < meta->n_sfn; i++) {
             sig = 1UL << i;
@@ -59,3 +75,20 @@ void common_sfn_thread(void *param)
         }
     }
 }
+
+void common_sfn_thread(void *param)
+{
+    sfn_thread_loop(param, false);
+}
+
+#if CONFIG_TFM_SPM_SHARED_STACKS == 1
+/*
+ * SPM restarts the thread here when another partition sharing the stack has
+ * overwritten its frames. The loop keeps nothing between messages, only the
+ * initialization must not run again.
+ */
+void common_sfn_thread_resume(void *param)
+{
+    sfn_thread_loop(param, true);
+}
+#endif
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Runs the command streams of the models in its Internal Trusted Storage on
+ * the NPU. The command stream, the weights and the scratch regions of the
+ * last model run stay in a secure arena, so the model is only read from
+ * storage again when another model is run. The tensors of the caller are
+ * mapped with MM-IOVEC and given to the NPU as they are, so they are not
+ * copied.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "config_tfm.h"
+#include "compiler_ext_defs.h"
+#include "psa/internal_trusted_storage.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_npu.h"
+#include "tfm_hal_npu.h"
+#include "tfm_npu_api.h"
+#include "tfm_sp_log.h"
+
+/* The NPU needs the command stream and the regions on 16 byte boundaries */
+#define NPU_ALIGN               16
+#define NPU_ALIGN_UP(x)         (((x) + NPU_ALIGN - 1) & ~(size_t)(NPU_ALIGN - 1))
+
+static uint8_t npu_arena[NPU_ARENA_SIZE] __aligned(NPU_ALIGN);
+
+/* The model in the arena */
+static struct {
+    bool loaded;
+    psa_storage_uid_t uid;
+    struct tfm_npu_model_header_t hdr;
+    /* Offset in the arena of the WEIGHTS and SCRATCH regions */
+    size_t region_off[TFM_NPU_MODEL_REGION_MAX];
+} model;
+
+/* Returns the size of the model described by the header, 0 if invalid. */
+static size_t model_header_check(const struct tfm_npu_model_header_t *hdr)
+{
+    size_t size = sizeof(*hdr);
+    uint32_t i, inputs = 0, outputs = 0;
+
+    if ((hdr->magic != TFM_NPU_MODEL_MAGIC) || (hdr->cmd_size == 0) ||
+        (hdr->cmd_size > NPU_ARENA_SIZE) ||
+        (hdr->region_count > TFM_NPU_MODEL_REGION_MAX)) {
+        return 0;
+    }
+    size += hdr->cmd_size;
+
+    for (i = 0; i < hdr->region_count; i++) {
+        switch (hdr->regions[i].type) {
+        case TFM_NPU_REGION_WEIGHTS:
+            if (hdr->regions[i].size > NPU_ARENA_SIZE) {
+                return 0;
+            }
+            size += hdr->regions[i].size;
+            break;
+        case TFM_NPU_REGION_SCRATCH:
+            break;
+        case TFM_NPU_REGION_INPUT:
+            inputs++;
+            break;
+        case TFM_NPU_REGION_OUTPUT:
+            outputs++;
+            break;
+        default:
+            return 0;
+        }
+    }
+
+    return ((inputs > 1) || (outputs > 1)) ? 0 : size;
+}
+
+static psa_status_t model_read(psa_storage_uid_t uid, size_t offset,
+                               void *buf, size_t size)
+{
+    size_t len;
+    psa_status_t status;
+
+    status = psa_its_get(uid, offset, size, buf, &len);
+    if ((status == PSA_SUCCESS) && (len != size)) {
+        status = PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return status;
+}
+
+/* Reads the command stream and the weights into the arena. */
+static psa_status_t model_load(psa_storage_uid_t uid)
+{
+    struct tfm_npu_model_header_t *hdr = &model.hdr;
+    size_t off, data_off, size;
+    psa_status_t status;
+    uint32_t i;
+
+    model.loaded = false;
+
+    status = model_read(uid, 0, hdr, sizeof(*hdr));
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+    if (model_header_check(hdr) == 0) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    status = model_read(uid, sizeof(*hdr), npu_arena, hdr->cmd_size);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+    off = NPU_ALIGN_UP(hdr->cmd_size);
+    data_off = sizeof(*hdr) + hdr->cmd_size;
+
+    for (i = 0; i < hdr->region_count; i++) {
+        if ((hdr->regions[i].type != TFM_NPU_REGION_WEIGHTS) &&
+            (hdr->regions[i].type != TFM_NPU_REGION_SCRATCH)) {
+            continue;
+        }
+
+        size = hdr->regions[i].size;
+        if ((off > sizeof(npu_arena)) || (size > sizeof(npu_arena) - off)) {
+            return PSA_ERROR_INSUFFICIENT_MEMORY;
+        }
+
+        if (hdr->regions[i].type == TFM_NPU_REGION_WEIGHTS) {
+            status = model_read(uid, data_off, &npu_arena[off], size);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+            data_off += size;
+        }
+
+        model.region_off[i] = off;
+        off = NPU_ALIGN_UP(off + size);
+    }
+
+    model.uid = uid;
+    model.loaded = true;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t npu_install_model(const psa_msg_t *msg)
+{
+    struct tfm_npu_model_header_t hdr;
+    psa_storage_uid_t uid;
+    const void *data;
+    psa_status_t status;
+
+    /* The command stream is trusted, it is only taken from secure clients. */
+    if (msg->client_id < 0) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    if ((msg->in_size[0] != sizeof(uid)) || (msg->in_size[1] < sizeof(hdr))) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+    (void)psa_read(msg->handle, 0, &uid, sizeof(uid));
+
+    data = psa_map_invec(msg->handle, 1);
+    memcpy(&hdr, data, sizeof(hdr));
+    if (model_header_check(&hdr) != msg->in_size[1]) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (model.loaded && (model.uid == uid)) {
+        model.loaded = false;
+    }
+
+    status = psa_its_set(uid, msg->in_size[1], data, PSA_STORAGE_FLAG_NONE);
+    psa_unmap_invec(msg->handle, 1);
+
+    return status;
+}
+
+static psa_status_t npu_run(const psa_msg_t *msg)
+{
+    const struct tfm_npu_model_header_t *hdr = &model.hdr;
+    void *base_addr[TFM_NPU_MODEL_REGION_MAX];
+    size_t base_size[TFM_NPU_MODEL_REGION_MAX];
+    psa_storage_uid_t uid;
+    size_t output_size = 0;
+    bool output_mapped = false;
+    uint32_t out_mask = 0;
+    psa_status_t status;
+    uint32_t i;
+
+    if (msg->in_size[0] != sizeof(uid)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+    (void)psa_read(msg->handle, 0, &uid, sizeof(uid));
+
+    if (!model.loaded || (model.uid != uid)) {
+        status = model_load(uid);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    for (i = 0; i < hdr->region_count; i++) {
+        base_size[i] = hdr->regions[i].size;
+
+        switch (hdr->regions[i].type) {
+        case TFM_NPU_REGION_INPUT:
+            if (msg->in_size[1] < base_size[i]) {
+                return PSA_ERROR_INVALID_ARGUMENT;
+            }
+            base_addr[i] = (void *)psa_map_invec(msg->handle, 1);
+            break;
+        case TFM_NPU_REGION_OUTPUT:
+            if (msg->out_size[0] < base_size[i]) {
+                return PSA_ERROR_INVALID_ARGUMENT;
+            }
+            base_addr[i] = psa_map_outvec(msg->handle, 0);
+            output_size = base_size[i];
+            output_mapped = true;
+            out_mask |= 1UL << i;
+            break;
+        default:
+            base_addr[i] = &npu_arena[model.region_off[i]];
+            break;
+        }
+    }
+
+    if (tfm_hal_npu_start(npu_arena, hdr->cmd_size, base_addr, base_size,
+                          hdr->region_count, out_mask) != TFM_HAL_SUCCESS) {
+        return PSA_ERROR_HARDWARE_FAILURE;
+    }
+
+    (void)psa_wait(NPU_SIGNAL, PSA_BLOCK);
+
+    status = (tfm_hal_npu_finish() == TFM_HAL_SUCCESS) ?
+             PSA_SUCCESS : PSA_ERROR_HARDWARE_FAILURE;
+    psa_eoi(NPU_SIGNAL);
+
+    if (output_mapped) {
+        psa_unmap_outvec(msg->handle, 0,
+                         (status == PSA_SUCCESS) ? output_size : 0);
+    }
+
+    return status;
+}
+
+void npu_sp_entry(void)
+{
+    psa_status_t status;
+    psa_msg_t msg;
+
+    if (tfm_hal_npu_init() != TFM_HAL_SUCCESS) {
+        LOG_ERRFMT("[NPU] NPU initialisation failed\r\n");
+        psa_panic();
+    }
+    psa_irq_enable(NPU_SIGNAL);
+
+    while (1) {
+        (void)psa_wait(TFM_NPU_SERVICE_SIGNAL, PSA_BLOCK);
+        if (psa_get(TFM_NPU_SERVICE_SIGNAL, &msg) != PSA_SUCCESS) {
+            continue;
+        }
+
+        switch (msg.type) {
+        case TFM_NPU_API_ID_RUN:
+            status = npu_run(&msg);
+            break;
+        case TFM_NPU_API_ID_INSTALL_MODEL:
+            status = npu_install_model(&msg);
+            break;
+        default:
+            status = PSA_ERROR_NOT_SUPPORTED;
+            break;
+        }
+
+        psa_reply(msg.handle, status);
+    }
+}
@@ -8,7 +8,9 @@
  */
 
 #include "async.h"
+#include "cmsis_compiler.h"
 #include "config_tfm.h"
+#include "internal_status_code.h"
 #include "psa/service.h"
 #include "psa_manifest/ns_agent_mailbox.h"
 #include "tfm_hal_mailbox.h"
@@ -17,6 +19,9 @@
 #include "tfm_multi_core.h"
 #include "tfm_rpc.h"
 #include "tfm_sp_log.h"
+#if MAILBOX_EVENT_POLL_SPIN > 0
+#include "tfm_spe_mailbox.h"
+#endif
 
 static void boot_ns_core(void)
 {
@@ -27,10 +32,65 @@ static void boot_ns_core(void)
     tfm_hal_wait_for_ns_cpu_ready();
 }
 
+static void handle_signals(psa_signal_t signals)
+{
+    if (MAILBOX_SIGNAL_IS_ACTIVE(signals)) {
+        psa_eoi(MAILBOX_SIGNAL_GET_ACTIVE(signals));
+        tfm_rpc_client_call_handler();
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    } else if (signals & ASYNC_MSG_REPLY) {
+        tfm_rpc_client_call_reply();
+#endif
+    } else {
+        psa_panic();
+    }
+}
+
+#if MAILBOX_EVENT_POLL_SPIN > 0
+/*
+ * After a burst of messages, poll for the next ones with WFE. NSPE signals them
+ * with an event instead of the mailbox interrupt, which saves the interrupt
+ * handling on each of them. The mailbox interrupt takes over again after
+ * MAILBOX_EVENT_POLL_SPIN wake-ups without any message or reply.
+ */
+static void poll_burst(void)
+{
+    psa_signal_t signals;
+    uint32_t idle = 0;
+
+    tfm_mailbox_set_polling(true);
+
+    while (idle < MAILBOX_EVENT_POLL_SPIN) {
+        signals = psa_wait(PSA_WAIT_ANY, PSA_POLL);
+        if (signals) {
+            handle_signals(signals);
+            idle = 0;
+            continue;
+        }
+
+        if (tfm_mailbox_handle_msg() == MAILBOX_SUCCESS) {
+            idle = 0;
+        } else {
+            idle++;
+        }
+
+        /* Woken up by an event from NSPE, or by an exception */
+        __WFE();
+    }
+
+    tfm_mailbox_set_polling(false);
+}
+#endif
+
 void ns_agent_mailbox_entry(void)
 {
     psa_signal_t signals = 0;
 
+    if (tfm_multi_core_mem_check_init() != SPM_SUCCESS) {
+        LOG_ERRFMT("Memory regions of the access check overlap\r\n");
+        psa_panic();
+    }
+
     boot_ns_core();
 
     if (tfm_inter_core_comm_init()) {
@@ -42,15 +102,10 @@ void ns_agent_mailbox_entry(void)
 
     while (1) {
         signals = psa_wait(PSA_WAIT_ANY, PSA_BLOCK);
-        if (MAILBOX_SIGNAL_IS_ACTIVE(signals)) {
-            psa_eoi(MAILBOX_SIGNAL_GET_ACTIVE(signals));
-            tfm_rpc_client_call_handler();
-#if CONFIG_TFM_SPM_BACKEND_IPC == 1
-        } else if (signals & ASYNC_MSG_REPLY) {
-            tfm_rpc_client_call_reply();
+        handle_signals(signals);
+
+#if MAILBOX_EVENT_POLL_SPIN > 0
+        poll_burst();
 #endif
-        } else {
-            psa_panic();
-        }
     }
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2022 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -23,35 +23,29 @@
 #error TFM_ISOLATION_LEVEL is not defined!
 #endif
 
-void tfm_get_mem_region_security_attr(const void *p, size_t s,
-                                      struct security_attr_info_t *p_attr)
-{
-    p_attr->is_valid = true;
-
-    if (check_address_range(p, s, NS_DATA_START,
-                            NS_DATA_LIMIT) == SPM_SUCCESS) {
-        p_attr->is_secure = false;
-        return;
-    }
-
-    if (check_address_range(p, s, NS_CODE_START,
-                            NS_CODE_LIMIT) == SPM_SUCCESS) {
-        p_attr->is_secure = false;
-        return;
-    }
-
-    if (check_address_range(p, s, S_DATA_START, S_DATA_LIMIT) == SPM_SUCCESS) {
-        p_attr->is_secure = true;
-        return;
-    }
-
-    if (check_address_range(p, s, S_CODE_START, S_CODE_LIMIT) == SPM_SUCCESS) {
-        p_attr->is_secure = true;
-        return;
-    }
+/*
+ * Non-secure buffer pool registered by the mailbox client. Its access
+ * permissions are checked once at registration.
+ */
+static bool ns_shm_registered = false;
+static uintptr_t ns_shm_base;
+static uintptr_t ns_shm_limit;
+
+/* A memory region of the static memory layout and its attributes */
+struct mem_region_t {
+    uintptr_t base;
+    uintptr_t limit;
+    bool is_secure;
+    struct mem_attr_info_t attr;
+};
 
-    p_attr->is_valid = false;
-}
+/*
+ * The code and data sections of both worlds. They don't overlap, and are kept
+ * sorted by base address to be searched by binary search.
+ */
+#define MEM_LAYOUT_REGION_NUM       4
+static struct mem_region_t layout_regions[MEM_LAYOUT_REGION_NUM];
+static size_t layout_region_num;
 
 #if TFM_ISOLATION_LEVEL == 2
 REGION_DECLARE(Image$$, TFM_UNPRIV_CODE_START, $$RO$$Base);
@@ -64,149 +58,227 @@ REGION_DECLARE(Image$$, TFM_APP_CODE_START, $$Base);
 REGION_DECLARE(Image$$, TFM_APP_CODE_END, $$Base);
 REGION_DECLARE(Image$$, TFM_APP_RW_STACK_START, $$Base);
 REGION_DECLARE(Image$$, TFM_APP_RW_STACK_END, $$Base);
+
+/*
+ * The unprivileged regions inside the secure sections. A range inside one of
+ * them takes its attributes, instead of the ones of the secure section.
+ */
+#define MEM_UNPRIV_REGION_NUM       4
+static struct mem_region_t unpriv_regions[MEM_UNPRIV_REGION_NUM];
+static size_t unpriv_region_num;
 #endif
 
-void tfm_get_secure_mem_region_attr(const void *p, size_t s,
-                                    struct mem_attr_info_t *p_attr)
+static bool mem_regions_ready = false;
+
+/**
+ * \brief Insert a region into a table sorted by base address. Empty regions
+ *        are skipped.
+ */
+static void mem_region_insert(struct mem_region_t *regions, size_t *num,
+                              uintptr_t base, uintptr_t limit, bool is_secure,
+                              bool is_wr_allow, bool is_unpriv_allow,
+                              bool is_xn)
 {
-#if TFM_ISOLATION_LEVEL == 1
-    p_attr->is_mpu_enabled = false;
-    p_attr->is_valid = true;
+    size_t i;
 
-    if (check_address_range(p, s, S_DATA_START, S_DATA_LIMIT) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = true;
-        p_attr->is_xn = true;
+    if (limit < base) {
         return;
     }
 
-    if (check_address_range(p, s, S_CODE_START, S_CODE_LIMIT) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
-        return;
+    for (i = *num; (i > 0) && (regions[i - 1].base > base); i--) {
+        regions[i] = regions[i - 1];
     }
 
-    p_attr->is_valid = false;
-#elif TFM_ISOLATION_LEVEL == 2
-    uintptr_t base, limit;
+    regions[i].base = base;
+    regions[i].limit = limit;
+    regions[i].is_secure = is_secure;
+    regions[i].attr.is_mpu_enabled = false;
+    regions[i].attr.is_valid = true;
+    regions[i].attr.is_xn = is_xn;
+    regions[i].attr.is_priv_rd_allow = true;
+    regions[i].attr.is_priv_wr_allow = is_wr_allow;
+    regions[i].attr.is_unpriv_rd_allow = is_unpriv_allow;
+    regions[i].attr.is_unpriv_wr_allow = is_unpriv_allow && is_wr_allow;
+    (*num)++;
+}
 
-    p_attr->is_mpu_enabled = false;
-    p_attr->is_valid = true;
+static bool mem_regions_overlap(const struct mem_region_t *regions, size_t num)
+{
+    size_t i;
 
-    /* TFM Core unprivileged code region */
-    base = (uintptr_t)&REGION_NAME(Image$$, TFM_UNPRIV_CODE_START, $$RO$$Base);
-    limit = (uintptr_t)&REGION_NAME(Image$$, TFM_UNPRIV_CODE_END, $$RO$$Limit) - 1;
-    if (check_address_range(p, s, base, limit) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
-        return;
+    for (i = 1; i < num; i++) {
+        if (regions[i].base <= regions[i - 1].limit) {
+            return true;
+        }
     }
 
+    return false;
+}
+
+int32_t tfm_multi_core_mem_check_init(void)
+{
+    /* The secure sections are only accessible to privileged code in level 2 */
+    bool is_s_unpriv_allow = (TFM_ISOLATION_LEVEL == 1);
+
+    if (mem_regions_ready) {
+        return SPM_SUCCESS;
+    }
+
+    layout_region_num = 0;
+    mem_region_insert(layout_regions, &layout_region_num,
+                      NS_DATA_START, NS_DATA_LIMIT, false, true, true, true);
+    mem_region_insert(layout_regions, &layout_region_num,
+                      NS_CODE_START, NS_CODE_LIMIT, false, false, true, false);
+    mem_region_insert(layout_regions, &layout_region_num,
+                      S_DATA_START, S_DATA_LIMIT, true, true,
+                      is_s_unpriv_allow, true);
+    mem_region_insert(layout_regions, &layout_region_num,
+                      S_CODE_START, S_CODE_LIMIT, true, false,
+                      is_s_unpriv_allow, false);
+    if (mem_regions_overlap(layout_regions, layout_region_num)) {
+        return SPM_ERROR_GENERIC;
+    }
+
+#if TFM_ISOLATION_LEVEL == 2
+    unpriv_region_num = 0;
+
+    /* TFM Core unprivileged code region */
+    mem_region_insert(unpriv_regions, &unpriv_region_num,
+        (uintptr_t)&REGION_NAME(Image$$, TFM_UNPRIV_CODE_START, $$RO$$Base),
+        (uintptr_t)&REGION_NAME(Image$$, TFM_UNPRIV_CODE_END, $$RO$$Limit) - 1,
+        true, false, true, false);
+
 #ifdef CONFIG_TFM_PARTITION_META
     /* TFM partition metadata pointer region */
-    base = (uintptr_t)&REGION_NAME(Image$$, TFM_SP_META_PTR, $$ZI$$Base);
-    limit = (uintptr_t)&REGION_NAME(Image$$, TFM_SP_META_PTR, $$ZI$$Limit) - 1;
-    if (check_address_range(p, s, base, limit) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = true;
-        p_attr->is_xn = true;
-        return;
-    }
+    mem_region_insert(unpriv_regions, &unpriv_region_num,
+        (uintptr_t)&REGION_NAME(Image$$, TFM_SP_META_PTR, $$ZI$$Base),
+        (uintptr_t)&REGION_NAME(Image$$, TFM_SP_META_PTR, $$ZI$$Limit) - 1,
+        true, true, true, true);
 #endif
 
     /* APP RoT partition RO region */
-    base = (uintptr_t)&REGION_NAME(Image$$, TFM_APP_CODE_START, $$Base);
-    limit = (uintptr_t)&REGION_NAME(Image$$, TFM_APP_CODE_END, $$Base) - 1;
-    if (check_address_range(p, s, base, limit) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
-        return;
-    }
+    mem_region_insert(unpriv_regions, &unpriv_region_num,
+        (uintptr_t)&REGION_NAME(Image$$, TFM_APP_CODE_START, $$Base),
+        (uintptr_t)&REGION_NAME(Image$$, TFM_APP_CODE_END, $$Base) - 1,
+        true, false, true, false);
 
     /* RW, ZI and stack as one region */
-    base = (uintptr_t)&REGION_NAME(Image$$, TFM_APP_RW_STACK_START, $$Base);
-    limit = (uintptr_t)&REGION_NAME(Image$$, TFM_APP_RW_STACK_END, $$Base) - 1;
-    if (check_address_range(p, s, base, limit) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = true;
-        p_attr->is_xn = true;
+    mem_region_insert(unpriv_regions, &unpriv_region_num,
+        (uintptr_t)&REGION_NAME(Image$$, TFM_APP_RW_STACK_START, $$Base),
+        (uintptr_t)&REGION_NAME(Image$$, TFM_APP_RW_STACK_END, $$Base) - 1,
+        true, true, true, true);
+
+    if (mem_regions_overlap(unpriv_regions, unpriv_region_num)) {
+        return SPM_ERROR_GENERIC;
+    }
+#endif
+
+    mem_regions_ready = true;
+
+    return SPM_SUCCESS;
+}
+
+/* The tables may be needed before the mailbox is initialized */
+static void mem_regions_check_ready(void)
+{
+    if (!mem_regions_ready &&
+        (tfm_multi_core_mem_check_init() != SPM_SUCCESS)) {
+        tfm_core_panic();
+    }
+}
+
+/**
+ * \brief Find the region of a sorted table which contains the whole range.
+ *
+ * \return The region, or NULL if no region contains the range.
+ */
+static const struct mem_region_t *mem_region_find(
+                                        const struct mem_region_t *regions,
+                                        size_t num, const void *p, size_t s)
+{
+    size_t low = 0, high = num, mid;
+
+    /* Find the last region whose base is not above the range */
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (regions[mid].base <= (uintptr_t)p) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if ((low == 0) ||
+        (check_address_range(p, s, regions[low - 1].base,
+                             regions[low - 1].limit) != SPM_SUCCESS)) {
+        return NULL;
+    }
+
+    return &regions[low - 1];
+}
+
+void tfm_get_mem_region_security_attr(const void *p, size_t s,
+                                      struct security_attr_info_t *p_attr)
+{
+    const struct mem_region_t *region;
+
+    mem_regions_check_ready();
+
+    region = mem_region_find(layout_regions, layout_region_num, p, s);
+    if (region == NULL) {
+        p_attr->is_valid = false;
         return;
     }
 
+    p_attr->is_valid = true;
+    p_attr->is_secure = region->is_secure;
+}
+
+void tfm_get_secure_mem_region_attr(const void *p, size_t s,
+                                    struct mem_attr_info_t *p_attr)
+{
+    const struct mem_region_t *region = NULL;
+
+    mem_regions_check_ready();
+
+#if TFM_ISOLATION_LEVEL == 2
+    region = mem_region_find(unpriv_regions, unpriv_region_num, p, s);
+#elif TFM_ISOLATION_LEVEL != 1
+#error "Cannot support current TF-M isolation level"
+#endif
+
     /*
      * Treat the remaining parts in secure data section and secure code section
-     * as privileged regions
+     * as privileged regions in level 2
      */
-    base = (uintptr_t)S_DATA_START;
-    limit = (uintptr_t)S_DATA_LIMIT;
-    if (check_address_range(p, s, base, limit) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = false;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = true;
-        return;
+    if (region == NULL) {
+        region = mem_region_find(layout_regions, layout_region_num, p, s);
     }
 
-    base = (uintptr_t)S_CODE_START;
-    limit = (uintptr_t)S_CODE_LIMIT;
-    if (check_address_range(p, s, base, limit) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = false;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
+    if ((region == NULL) || !region->is_secure) {
+        p_attr->is_mpu_enabled = false;
+        p_attr->is_valid = false;
         return;
     }
 
-    p_attr->is_valid = false;
-#else
-#error "Cannot support current TF-M isolation level"
-#endif
+    *p_attr = region->attr;
 }
 
 void tfm_get_ns_mem_region_attr(const void *p, size_t s,
                                 struct mem_attr_info_t *p_attr)
 {
-    p_attr->is_mpu_enabled = false;
-    p_attr->is_valid = true;
+    const struct mem_region_t *region;
 
-    if (check_address_range(p, s, NS_DATA_START,
-                            NS_DATA_LIMIT) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = true;
-        p_attr->is_xn = true;
-        return;
-    }
+    mem_regions_check_ready();
 
-    if (check_address_range(p, s, NS_CODE_START,
-                            NS_CODE_LIMIT) == SPM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
+    region = mem_region_find(layout_regions, layout_region_num, p, s);
+    if ((region == NULL) || region->is_secure) {
+        p_attr->is_mpu_enabled = false;
+        p_attr->is_valid = false;
         return;
     }
 
-    p_attr->is_valid = false;
+    *p_attr = region->attr;
 }
 
 static void security_attr_init(struct security_attr_info_t *p_attr)
@@ -401,6 +473,12 @@ int32_t tfm_has_access_to_region(const void *p, size_t s, uint32_t flags)
         tfm_core_panic();
     }
 
+    /* Ranges inside the registered buffer pool are validated already */
+    if (ns_shm_registered && (flags & MEM_CHECK_NONSECURE) &&
+        (check_address_range(p, s, ns_shm_base, ns_shm_limit) == SPM_SUCCESS)) {
+        return SPM_SUCCESS;
+    }
+
     security_attr_init(&security_attr);
 
     /* Retrieve security attributes of target memory region */
@@ -430,6 +508,26 @@ int32_t tfm_has_access_to_region(const void *p, size_t s, uint32_t flags)
     return mem_attr_check(mem_attr, flags);
 }
 
+int32_t tfm_multi_core_register_ns_shm(const void *base, size_t size)
+{
+    /* Only one buffer pool can be registered */
+    if (ns_shm_registered || (size == 0)) {
+        return SPM_ERROR_GENERIC;
+    }
+
+    if (tfm_has_access_to_region(base, size,
+                                 MEM_CHECK_NONSECURE |
+                                 MEM_CHECK_MPU_READWRITE) != SPM_SUCCESS) {
+        return SPM_ERROR_GENERIC;
+    }
+
+    ns_shm_base = (uintptr_t)base;
+    ns_shm_limit = ns_shm_base + size - 1;
+    ns_shm_registered = true;
+
+    return SPM_SUCCESS;
+}
+
 int32_t check_address_range(const void *p, size_t s,
                             uintptr_t region_start,
                             uintptr_t region_limit)
@@ -26,8 +26,22 @@
 #include "tfm_hal_multi_core.h"
 #include "tfm_multi_core.h"
 #include "ffm/mailbox_agent_api.h"
+#include "psa/service.h"
 
-static struct secure_mailbox_queue_t spe_mailbox_queue;
+/*
+ * One queue per NSPE peer. Each peer has its own SPE slots, NSPE status and
+ * notification, so the peers do not share slots or critical sections.
+ */
+static struct secure_mailbox_queue_t spe_mailbox_queue[NUM_MAILBOX_PEERS];
+
+/*
+ * Bitmask of the peers which have been written replies but whose notification
+ * has been held back, so that it can be merged with the next one.
+ */
+static uint32_t reply_notify_deferred;
+
+/* Peer whose requests are handled first by the next tfm_mailbox_handle_msg() */
+static uint32_t next_peer;
 
 /*
  * Local copies of invecs and outvecs associated with each mailbox message
@@ -40,36 +54,81 @@ struct vectors {
     size_t out_len;
     bool in_use;
 };
-static struct vectors vectors[NUM_MAILBOX_QUEUE_SLOT] = {0};
+static struct vectors vectors[NUM_MAILBOX_PEERS][NUM_MAILBOX_QUEUE_SLOT] = {0};
+
+#if NUM_MAILBOX_PEERS > 1
+#define mailbox_hal_init(peer, s_queue) tfm_mailbox_hal_peer_init(peer, s_queue)
+#define mailbox_hal_notify(peer)        tfm_mailbox_hal_peer_notify(peer)
+#define mailbox_hal_enter_critical(peer) \
+                                        tfm_mailbox_hal_peer_enter_critical(peer)
+#define mailbox_hal_exit_critical(peer) tfm_mailbox_hal_peer_exit_critical(peer)
+#else
+#define mailbox_hal_init(peer, s_queue) tfm_mailbox_hal_init(s_queue)
+#define mailbox_hal_notify(peer)        tfm_mailbox_hal_notify_peer()
+#define mailbox_hal_enter_critical(peer) \
+                                        tfm_mailbox_hal_enter_critical()
+#define mailbox_hal_exit_critical(peer) tfm_mailbox_hal_exit_critical()
+#endif
 
+/* Notifies a peer, with an event as well for a peer waiting with WFE */
+static void mailbox_notify_peer(uint32_t peer)
+{
+    mailbox_hal_notify(peer);
+
+#if MAILBOX_EVENT_POLL_SPIN > 0
+    __DSB();
+    __SEV();
+#endif
+}
 
-__STATIC_INLINE void set_spe_queue_empty_status(uint8_t idx)
+__STATIC_INLINE void set_spe_queue_empty_status(uint32_t peer, uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        spe_mailbox_queue.empty_slots |= (1 << idx);
+        spe_mailbox_queue[peer].empty_slots |= (1 << idx);
     }
 }
 
-__STATIC_INLINE void clear_spe_queue_empty_status(uint8_t idx)
+__STATIC_INLINE void clear_spe_queue_empty_status(uint32_t peer, uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        spe_mailbox_queue.empty_slots &= ~(1 << idx);
+        spe_mailbox_queue[peer].empty_slots &= ~(1 << idx);
     }
 }
 
-__STATIC_INLINE bool get_spe_queue_empty_status(uint8_t idx)
+__STATIC_INLINE bool get_spe_queue_empty_status(uint32_t peer, uint8_t idx)
 {
     if ((idx < NUM_MAILBOX_QUEUE_SLOT) &&
-        (spe_mailbox_queue.empty_slots & (1 << idx))) {
+        (spe_mailbox_queue[peer].empty_slots & (1 << idx))) {
         return true;
     }
 
     return false;
 }
 
+/* Search for an empty SPE mailbox queue slot */
+__STATIC_INLINE int32_t get_spe_queue_empty_slot(uint32_t peer, uint8_t *idx)
+{
+    uint8_t i;
+
+    for (i = 0; i < NUM_MAILBOX_QUEUE_SLOT; i++) {
+        if (spe_mailbox_queue[peer].empty_slots & (1 << i)) {
+            *idx = i;
+            return MAILBOX_SUCCESS;
+        }
+    }
+
+    return MAILBOX_QUEUE_FULL;
+}
+
+/*
+ * The NSPE status words are accessed in the critical section of the mailbox,
+ * in which NSPE neither reads nor writes them.
+ */
 __STATIC_INLINE mailbox_queue_status_t get_nspe_queue_pend_status(
-                                    const struct mailbox_status_t *ns_status)
+                                          struct mailbox_status_t *ns_status)
 {
+    tfm_mailbox_hal_cache_invalidate(ns_status->pend_lines,
+                                     sizeof(ns_status->pend_lines));
     return ns_status->pend_slots;
 }
 
@@ -77,52 +136,74 @@ __STATIC_INLINE void set_nspe_queue_replied_status(
                                             struct mailbox_status_t *ns_status,
                                             mailbox_queue_status_t mask)
 {
+    if (!mask) {
+        return;
+    }
+
+    tfm_mailbox_hal_cache_invalidate(ns_status->replied_lines,
+                                     sizeof(ns_status->replied_lines));
     ns_status->replied_slots |= mask;
+    tfm_mailbox_hal_cache_clean(ns_status->replied_lines,
+                                sizeof(ns_status->replied_lines));
 }
 
 __STATIC_INLINE void clear_nspe_queue_pend_status(
                                             struct mailbox_status_t *ns_status,
                                             mailbox_queue_status_t mask)
 {
+    if (!mask) {
+        return;
+    }
+
+    tfm_mailbox_hal_cache_invalidate(ns_status->pend_lines,
+                                     sizeof(ns_status->pend_lines));
     ns_status->pend_slots &= ~mask;
+    tfm_mailbox_hal_cache_clean(ns_status->pend_lines,
+                                sizeof(ns_status->pend_lines));
 }
 
-__STATIC_INLINE int32_t get_spe_mailbox_msg_handle(uint8_t idx,
+/* The handles of all the peers are numbered from 1, slot by slot */
+__STATIC_INLINE int32_t get_spe_mailbox_msg_handle(uint32_t peer, uint8_t idx,
                                                    mailbox_msg_handle_t *handle)
 {
-    if ((idx >= NUM_MAILBOX_QUEUE_SLOT) || !handle) {
+    if ((peer >= NUM_MAILBOX_PEERS) || (idx >= NUM_MAILBOX_QUEUE_SLOT) ||
+        !handle) {
         return MAILBOX_INVAL_PARAMS;
     }
 
-    *handle = (mailbox_msg_handle_t)(idx + 1);
+    *handle = (mailbox_msg_handle_t)(peer * NUM_MAILBOX_QUEUE_SLOT + idx + 1);
 
     return MAILBOX_SUCCESS;
 }
 
 __STATIC_INLINE int32_t get_spe_mailbox_msg_idx(mailbox_msg_handle_t handle,
-                                                uint8_t *idx)
+                                                uint32_t *peer, uint8_t *idx)
 {
-    if ((handle == MAILBOX_MSG_NULL_HANDLE) || !idx) {
+    if ((handle <= MAILBOX_MSG_NULL_HANDLE) ||
+        (handle > NUM_MAILBOX_PEERS * NUM_MAILBOX_QUEUE_SLOT) ||
+        !peer || !idx) {
         return MAILBOX_INVAL_PARAMS;
     }
 
-    *idx = (uint8_t)(handle - 1);
+    *peer = (uint32_t)(handle - 1) / NUM_MAILBOX_QUEUE_SLOT;
+    *idx = (uint8_t)((uint32_t)(handle - 1) % NUM_MAILBOX_QUEUE_SLOT);
 
     return MAILBOX_SUCCESS;
 }
 
-static void mailbox_clean_queue_slot(uint8_t idx)
+static void mailbox_clean_queue_slot(uint32_t peer, uint8_t idx)
 {
     if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
         return;
     }
 
-    spm_memset(&spe_mailbox_queue.queue[idx], 0,
-                         sizeof(spe_mailbox_queue.queue[idx]));
-    set_spe_queue_empty_status(idx);
+    spm_memset(&spe_mailbox_queue[peer].queue[idx], 0,
+                         sizeof(spe_mailbox_queue[peer].queue[idx]));
+    set_spe_queue_empty_status(peer, idx);
 }
 
-__STATIC_INLINE struct mailbox_reply_t *get_nspe_reply_addr(uint8_t idx)
+__STATIC_INLINE struct mailbox_slot_t *get_nspe_slot_addr(uint32_t peer,
+                                                          uint8_t idx)
 {
     uint8_t ns_slot_idx;
 
@@ -130,38 +211,51 @@ __STATIC_INLINE struct mailbox_reply_t *get_nspe_reply_addr(uint8_t idx)
         psa_panic();
     }
 
-    ns_slot_idx = spe_mailbox_queue.queue[idx].ns_slot_idx;
-    if ((ns_slot_idx >= NUM_MAILBOX_QUEUE_SLOT) || (ns_slot_idx >= spe_mailbox_queue.ns_slot_count)) {
+    ns_slot_idx = spe_mailbox_queue[peer].queue[idx].ns_slot_idx;
+    if (ns_slot_idx >= spe_mailbox_queue[peer].ns_slot_count) {
         psa_panic();
     }
 
-    return &spe_mailbox_queue.ns_slots[ns_slot_idx].reply;
+    return &spe_mailbox_queue[peer].ns_slots[ns_slot_idx];
 }
 
-static void mailbox_direct_reply(uint8_t idx, uint32_t result)
+/*
+ * Writes the result into the NSPE slot and releases the SPE slot.
+ * Returns the NSPE queue status bit of the replied slot.
+ */
+static mailbox_queue_status_t mailbox_direct_reply(uint32_t peer, uint8_t idx,
+                                                   uint32_t result)
 {
-    struct mailbox_reply_t *reply_ptr;
+    struct mailbox_slot_t *ns_slot;
     uint32_t ret_result = result;
+    mailbox_queue_status_t ns_mask;
+    struct vectors *vecs = &vectors[peer][idx];
 
     /* Copy outvec lengths back if necessary */
-    if (vectors[idx].in_use) {
-        for (int i = 0; i < vectors[idx].out_len; i++) {
-            vectors[idx].original_out_vec[i].len = vectors[idx].out_vec[i].len;
+    if (vecs->in_use) {
+        for (int i = 0; i < vecs->out_len; i++) {
+            vecs->original_out_vec[i].len = vecs->out_vec[i].len;
         }
-        vectors[idx].in_use = false;
+        vecs->in_use = false;
     }
 
     /* Get reply address */
-    reply_ptr = get_nspe_reply_addr(idx);
-    spm_memcpy(&reply_ptr->return_val, &ret_result,
-               sizeof(reply_ptr->return_val));
+    ns_slot = get_nspe_slot_addr(peer, idx);
+    spm_memcpy(&ns_slot->reply.return_val, &ret_result,
+               sizeof(ns_slot->reply.return_val));
+    tfm_mailbox_hal_cache_clean(ns_slot->reply_lines,
+                                sizeof(ns_slot->reply_lines));
+
+    ns_mask = (mailbox_queue_status_t)(1UL <<
+                                spe_mailbox_queue[peer].queue[idx].ns_slot_idx);
 
-    mailbox_clean_queue_slot(idx);
+    mailbox_clean_queue_slot(peer, idx);
 
     /*
      * Skip NSPE queue status update after single reply.
      * Update NSPE queue status after all the mailbox messages are completed
      */
+    return ns_mask;
 }
 
 __STATIC_INLINE int32_t check_mailbox_msg(const struct mailbox_msg_t *msg)
@@ -175,11 +269,11 @@ __STATIC_INLINE int32_t check_mailbox_msg(const struct mailbox_msg_t *msg)
 }
 
 /* Passes the request from the mailbox message into SPM.
- * idx indicates the slot used to use for any immediate reply.
+ * peer and idx indicate the slot used to use for any immediate reply.
  * If it queues the reply immediately, updates reply_slots accordingly.
  */
 static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
-                                    uint8_t idx,
+                                    uint32_t peer, uint8_t idx,
                                     mailbox_queue_status_t *reply_slots)
 {
     const struct psa_client_params_t *params = &msg_ptr->params;
@@ -190,7 +284,8 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
     int32_t client_id;
     psa_status_t psa_ret = PSA_ERROR_GENERIC_ERROR;
     mailbox_msg_handle_t *mb_msg_handle =
-        &spe_mailbox_queue.queue[idx].msg_handle;
+        &spe_mailbox_queue[peer].queue[idx].msg_handle;
+    struct vectors *vecs = &vectors[peer][idx];
 
 #if CONFIG_TFM_SPM_BACKEND_IPC == 1
     /* Assume asynchronous. Set to synchronous when an error happens. */
@@ -216,15 +311,15 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
     case MAILBOX_PSA_CALL:
         /* TODO check vector validity before use */
         /* Make local copy of invecs and outvecs */
-        vectors[idx].in_use = true;
-        vectors[idx].out_len = params->psa_call_params.out_len;
-        vectors[idx].original_out_vec = params->psa_call_params.out_vec;
+        vecs->in_use = true;
+        vecs->out_len = params->psa_call_params.out_len;
+        vecs->original_out_vec = params->psa_call_params.out_vec;
         for (int i = 0; i < PSA_MAX_IOVEC; i++) {
             if (i < params->psa_call_params.in_len) {
-                vectors[idx].in_vec[i] = params->psa_call_params.in_vec[i];
+                vecs->in_vec[i] = params->psa_call_params.in_vec[i];
             } else {
-                vectors[idx].in_vec[i].base = 0;
-                vectors[idx].in_vec[i].len = 0;
+                vecs->in_vec[i].base = 0;
+                vecs->in_vec[i].len = 0;
             }
         }
 
@@ -232,10 +327,10 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
 
         for (int i = 0; i < PSA_MAX_IOVEC; i++) {
             if (i < params->psa_call_params.out_len) {
-                vectors[idx].out_vec[i] = params->psa_call_params.out_vec[i];
+                vecs->out_vec[i] = params->psa_call_params.out_vec[i];
             } else {
-                vectors[idx].out_vec[i].base = 0;
-                vectors[idx].out_vec[i].len = 0;
+                vecs->out_vec[i].base = 0;
+                vecs->out_vec[i].len = 0;
             }
         }
 
@@ -249,8 +344,8 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
             break;
         }
         client_params.ns_client_id_stateless = client_id;
-        client_params.p_invecs = vectors[idx].in_vec;
-        client_params.p_outvecs = vectors[idx].out_vec;
+        client_params.p_invecs = vecs->in_vec;
+        client_params.p_outvecs = vecs->out_vec;
         psa_ret = tfm_rpc_psa_call(params->psa_call_params.handle,
                                    control, &client_params, mb_msg_handle);
         if (psa_ret != PSA_SUCCESS) {
@@ -298,121 +393,275 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
 
     /* Any synchronous result should be returned immediately */
     if (sync) {
-        *reply_slots |= (1 << idx);
-        mailbox_direct_reply(idx, (uint32_t)psa_ret);
+        *reply_slots |= mailbox_direct_reply(peer, idx, (uint32_t)psa_ret);
     }
 
     return MAILBOX_SUCCESS;
 }
 
-int32_t tfm_mailbox_handle_msg(void)
+/* Sorts the pending NSPE slots of a peer by the priority of their calls */
+static void mailbox_sort_peer_msg(const struct secure_mailbox_queue_t *queue,
+                                  mailbox_queue_status_t pend_slots,
+                                  mailbox_queue_status_t *prio_slots)
 {
-    uint8_t idx;
+    uint8_t ns_idx;
+    uint32_t prio;
+
+    for (prio = 0; prio < MAILBOX_PRIO_NUM; prio++) {
+        prio_slots[prio] = 0;
+    }
+
+    for (ns_idx = 0; ns_idx < queue->ns_slot_count; ns_idx++) {
+        if (!(pend_slots & (1UL << ns_idx))) {
+            continue;
+        }
+
+        tfm_mailbox_hal_cache_invalidate(queue->ns_slots[ns_idx].msg_lines,
+                                sizeof(queue->ns_slots[ns_idx].msg_lines));
+
+        /* An unknown class is served as a normal one */
+        prio = queue->ns_slots[ns_idx].msg.priority;
+        if (prio >= MAILBOX_PRIO_NUM) {
+            prio = MAILBOX_PRIO_NORMAL;
+        }
+
+        prio_slots[prio] |= (1UL << ns_idx);
+    }
+}
+
+/*
+ * Handles the requests pending in the NSPE queue of one peer, the ones of a
+ * higher priority class first.
+ */
+static int32_t mailbox_handle_peer_msg(uint32_t peer)
+{
+    uint8_t idx, ns_idx;
+    int32_t prio;
     mailbox_queue_status_t mask_bits, pend_slots, reply_slots = 0;
-    struct mailbox_status_t *ns_status = spe_mailbox_queue.ns_status;
+    mailbox_queue_status_t taken_slots = 0;
+    mailbox_queue_status_t prio_slots[MAILBOX_PRIO_NUM];
+    struct secure_mailbox_queue_t *queue = &spe_mailbox_queue[peer];
+    struct mailbox_status_t *ns_status = queue->ns_status;
     struct mailbox_msg_t *msg_ptr;
 
     SPM_ASSERT(ns_status != NULL);
 
-    tfm_mailbox_hal_enter_critical();
+    mailbox_hal_enter_critical(peer);
 
     pend_slots = get_nspe_queue_pend_status(ns_status);
 
-    tfm_mailbox_hal_exit_critical();
+    mailbox_hal_exit_critical(peer);
 
     /* Check if NSPE mailbox did assert a PSA client call request */
     if (!pend_slots) {
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    for (idx = 0; idx < spe_mailbox_queue.ns_slot_count; idx++) {
-        mask_bits = (1 << idx);
-        /* Check if current NSPE mailbox queue slot is pending for handling */
-        if (!(pend_slots & mask_bits)) {
-            continue;
-        }
+    mailbox_sort_peer_msg(queue, pend_slots, prio_slots);
 
-        /*
-         * TODO
-         * The operations are simplified here. Use the SPE mailbox queue
-         * slot with the same idx as that of the NSPE mailbox queue slot.
-         * A more general implementation should dynamically search and
-         * select an empty SPE mailbox queue slot.
-         */
-        clear_spe_queue_empty_status(idx);
-        spe_mailbox_queue.queue[idx].ns_slot_idx = idx;
+    for (prio = MAILBOX_PRIO_NUM - 1; prio >= 0; prio--) {
+        for (ns_idx = 0; ns_idx < queue->ns_slot_count; ns_idx++) {
+            mask_bits = (1UL << ns_idx);
+            /* Check if the NSPE mailbox queue slot is pending in this class */
+            if (!(prio_slots[prio] & mask_bits)) {
+                continue;
+            }
 
-        msg_ptr = &spe_mailbox_queue.queue[idx].msg;
-        spm_memcpy(msg_ptr, &spe_mailbox_queue.ns_slots[idx].msg, sizeof(*msg_ptr));
+            /*
+             * NSPE may allocate more slots than SPE. Requests which cannot get
+             * an SPE slot are left pending in NSPE queue and are picked up
+             * when an SPE slot is released in tfm_mailbox_reply_msg().
+             */
+            if (get_spe_queue_empty_slot(peer, &idx) != MAILBOX_SUCCESS) {
+                break;
+            }
 
-        if (check_mailbox_msg(msg_ptr) != MAILBOX_SUCCESS) {
-            mailbox_clean_queue_slot(idx);
-            continue;
-        }
+            taken_slots |= mask_bits;
 
-        get_spe_mailbox_msg_handle(idx,
-                                   &spe_mailbox_queue.queue[idx].msg_handle);
+            clear_spe_queue_empty_status(peer, idx);
+            queue->queue[idx].ns_slot_idx = ns_idx;
 
-        if (tfm_mailbox_dispatch(msg_ptr, idx, &reply_slots) != MAILBOX_SUCCESS) {
-            mailbox_clean_queue_slot(idx);
-            continue;
+            msg_ptr = &queue->queue[idx].msg;
+            spm_memcpy(msg_ptr, &queue->ns_slots[ns_idx].msg,
+                       sizeof(*msg_ptr));
+
+            if (check_mailbox_msg(msg_ptr) != MAILBOX_SUCCESS) {
+                mailbox_clean_queue_slot(peer, idx);
+                continue;
+            }
+
+            get_spe_mailbox_msg_handle(peer, idx,
+                                       &queue->queue[idx].msg_handle);
+
+            if (tfm_mailbox_dispatch(msg_ptr, peer, idx,
+                                     &reply_slots) != MAILBOX_SUCCESS) {
+                mailbox_clean_queue_slot(peer, idx);
+                continue;
+            }
+        }
+
+        /* The SPE slots are all taken, the lower classes stay pending */
+        if (ns_idx < queue->ns_slot_count) {
+            break;
         }
     }
 
-    tfm_mailbox_hal_enter_critical();
+    mailbox_hal_enter_critical(peer);
 
-    /* Clean the NSPE mailbox pending status. */
-    clear_nspe_queue_pend_status(ns_status, pend_slots);
+    /* Clean the NSPE mailbox pending status of the slots taken by SPE. */
+    clear_nspe_queue_pend_status(ns_status, taken_slots);
 
     /* Set the NSPE mailbox replied status */
     set_nspe_queue_replied_status(ns_status, reply_slots);
 
-    tfm_mailbox_hal_exit_critical();
+    mailbox_hal_exit_critical(peer);
 
-    if (reply_slots) {
-        tfm_mailbox_hal_notify_peer();
+    /* A single notification covers the deferred replies as well */
+    if (reply_slots || (reply_notify_deferred & (1UL << peer))) {
+        reply_notify_deferred &= ~(1UL << peer);
+        mailbox_notify_peer(peer);
     }
 
     return MAILBOX_SUCCESS;
 }
 
+int32_t tfm_mailbox_handle_msg(void)
+{
+    uint32_t i, peer;
+    int32_t ret = MAILBOX_NO_PEND_EVENT;
+
+    /*
+     * Each peer has its own SPE slots, so a busy peer cannot hold back the
+     * others. The peer served first rotates so that all the peers see the
+     * same latency.
+     */
+    peer = next_peer;
+    next_peer = (next_peer + 1) % NUM_MAILBOX_PEERS;
+
+    for (i = 0; i < NUM_MAILBOX_PEERS; i++) {
+        if (mailbox_handle_peer_msg(peer) == MAILBOX_SUCCESS) {
+            ret = MAILBOX_SUCCESS;
+        }
+        peer = (peer + 1) % NUM_MAILBOX_PEERS;
+    }
+
+    return ret;
+}
+
+#if MAILBOX_EVENT_POLL_SPIN > 0
+void tfm_mailbox_set_polling(bool polling)
+{
+    uint32_t peer;
+    struct mailbox_status_t *ns_status;
+
+    for (peer = 0; peer < NUM_MAILBOX_PEERS; peer++) {
+        ns_status = spe_mailbox_queue[peer].ns_status;
+        ns_status->spe_polling = polling ? 1 : 0;
+        tfm_mailbox_hal_cache_clean(ns_status->polling_lines,
+                                    sizeof(ns_status->polling_lines));
+    }
+
+    if (!polling) {
+        /*
+         * A request queued before NSPE saw the flag cleared is only signalled
+         * with an event. The flag is written before the last check of the
+         * pending status, so that the request is either seen here or
+         * notified with the mailbox interrupt.
+         */
+        __DMB();
+        (void)tfm_mailbox_handle_msg();
+    }
+}
+#endif
+
+/* Notifies all the peers whose notification was held back */
+static void mailbox_notify_deferred(void)
+{
+    uint32_t peer;
+
+    for (peer = 0; peer < NUM_MAILBOX_PEERS; peer++) {
+        if (reply_notify_deferred & (1UL << peer)) {
+            reply_notify_deferred &= ~(1UL << peer);
+            mailbox_notify_peer(peer);
+        }
+    }
+}
+
 int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply)
 {
+    uint32_t peer;
     uint8_t idx;
     int32_t ret;
-    struct mailbox_status_t *ns_status = spe_mailbox_queue.ns_status;
-
-    SPM_ASSERT(ns_status != NULL);
+    bool urgent;
+    mailbox_queue_status_t reply_slots, pend_slots;
+    struct mailbox_status_t *ns_status;
 
     /*
      * If handle == MAILBOX_MSG_NULL_HANDLE, reply to the mailbox message
-     * in the first slot.
+     * in the first slot of the first peer.
      * When multiple ongoing PSA client calls from NSPE are supported,
      * additional check might be necessary to avoid spoofing the first slot.
      */
     if (handle == MAILBOX_MSG_NULL_HANDLE) {
+        peer = 0;
         idx = 0;
     } else {
-        ret = get_spe_mailbox_msg_idx(handle, &idx);
+        ret = get_spe_mailbox_msg_idx(handle, &peer, &idx);
         if (ret != MAILBOX_SUCCESS) {
             return ret;
         }
     }
 
-    if (get_spe_queue_empty_status(idx)) {
+    ns_status = spe_mailbox_queue[peer].ns_status;
+    SPM_ASSERT(ns_status != NULL);
+
+    if (get_spe_queue_empty_status(peer, idx)) {
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    mailbox_direct_reply(idx, (uint32_t)reply);
+    urgent = (spe_mailbox_queue[peer].queue[idx].msg.priority ==
+              MAILBOX_PRIO_HIGH);
+
+    reply_slots = mailbox_direct_reply(peer, idx, (uint32_t)reply);
 
-    tfm_mailbox_hal_enter_critical();
+    mailbox_hal_enter_critical(peer);
 
     /* Set the NSPE mailbox replied status */
-    set_nspe_queue_replied_status(ns_status, (1 << idx));
+    set_nspe_queue_replied_status(ns_status, reply_slots);
+
+    pend_slots = get_nspe_queue_pend_status(ns_status);
+
+    mailbox_hal_exit_critical(peer);
+
+    reply_notify_deferred |= (1UL << peer);
+
+    /*
+     * Requests left pending for lack of an SPE slot can be taken now that
+     * a slot is released. mailbox_handle_peer_msg() notifies the peer once
+     * for both this reply and any synchronous replies it produces.
+     */
+    if (pend_slots) {
+        (void)mailbox_handle_peer_msg(peer);
+        if (!reply_notify_deferred) {
+            return MAILBOX_SUCCESS;
+        }
+    }
 
-    tfm_mailbox_hal_exit_critical();
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    /*
+     * More asynchronous replies are queued. Hold back the notification
+     * until the last of them is written so that each peer gets one interrupt
+     * for the whole batch. The reply to a high priority call is not held
+     * back.
+     */
+    if (!urgent && (psa_wait(ASYNC_MSG_REPLY, PSA_POLL) & ASYNC_MSG_REPLY)) {
+        return MAILBOX_SUCCESS;
+    }
+#else
+    (void)urgent;
+#endif
 
-    tfm_mailbox_hal_notify_peer();
+    mailbox_notify_deferred();
 
     return MAILBOX_SUCCESS;
 }
@@ -445,13 +694,17 @@ static const struct tfm_rpc_ops_t mailbox_rpc_ops = {
 static int32_t tfm_mailbox_init(void)
 {
     int32_t ret;
+    uint32_t peer;
+    struct secure_mailbox_queue_t *queue;
 
-    spm_memset(&spe_mailbox_queue, 0, sizeof(spe_mailbox_queue));
+    spm_memset(spe_mailbox_queue, 0, sizeof(spe_mailbox_queue));
 
-    spe_mailbox_queue.empty_slots =
+    for (peer = 0; peer < NUM_MAILBOX_PEERS; peer++) {
+        spe_mailbox_queue[peer].empty_slots =
             (mailbox_queue_status_t)((1UL << (NUM_MAILBOX_QUEUE_SLOT - 1)) - 1);
-    spe_mailbox_queue.empty_slots +=
+        spe_mailbox_queue[peer].empty_slots +=
             (mailbox_queue_status_t)(1UL << (NUM_MAILBOX_QUEUE_SLOT - 1));
+    }
 
     /* Register RPC callbacks */
     ret = tfm_rpc_register_ops(&mailbox_rpc_ops);
@@ -459,16 +712,45 @@ static int32_t tfm_mailbox_init(void)
         return MAILBOX_CALLBACK_REG_ERROR;
     }
 
+    for (peer = 0; peer < NUM_MAILBOX_PEERS; peer++) {
+        queue = &spe_mailbox_queue[peer];
+
+        /*
+         * Platform specific initialization.
+         * Initialize Inter-Processor Communication and achieve the base
+         * address of the NSPE mailbox queue of the peer
+         */
+        ret = mailbox_hal_init(peer, queue);
+        if (ret != MAILBOX_SUCCESS) {
+            tfm_rpc_unregister_ops();
+
+            return ret;
+        }
+
+#if MAILBOX_CACHE_LINE_SIZE > 0
+        /* Cache maintenance of a slot must not touch the neighbouring data */
+        if ((((uintptr_t)queue->ns_status |
+              (uintptr_t)queue->ns_slots) &
+             (MAILBOX_CACHE_LINE_SIZE - 1)) != 0) {
+            tfm_rpc_unregister_ops();
+
+            return MAILBOX_INIT_ERROR;
+        }
+#endif
+    }
+
     /*
-     * Platform specific initialization.
-     * Initialize Inter-Processor Communication and achieve the base address of
-     * NSPE mailbox queue
+     * Validate the optional NS buffer pool once, instead of on every call.
+     * The pool is shared by all the peers and is set in the queue of peer 0.
      */
-    ret = tfm_mailbox_hal_init(&spe_mailbox_queue);
-    if (ret != MAILBOX_SUCCESS) {
-        tfm_rpc_unregister_ops();
+    queue = &spe_mailbox_queue[0];
+    if (queue->ns_shm_size != 0) {
+        if (tfm_multi_core_register_ns_shm(queue->ns_shm_base,
+                                   queue->ns_shm_size) != SPM_SUCCESS) {
+            tfm_rpc_unregister_ops();
 
-        return ret;
+            return MAILBOX_INIT_ERROR;
+        }
     }
 
     return MAILBOX_SUCCESS;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -31,4 +31,18 @@ int32_t tfm_mailbox_handle_msg(void);
  */
 int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply);
 
+#if MAILBOX_EVENT_POLL_SPIN > 0
+/**
+ * \brief Tell NSPE whether SPE polls for mailbox messages with WFE, in which
+ *        case NSPE signals new messages with an event instead of the mailbox
+ *        interrupt.
+ *
+ * \param[in] polling           Whether SPE polls for mailbox messages.
+ *
+ * \note Messages queued while the polling stops are handled before it
+ *       returns.
+ */
+void tfm_mailbox_set_polling(bool polling);
+#endif
+
 #endif /* __TFM_SPE_MAILBOX_H__ */
@@ -30,8 +30,8 @@
  *
  * - The non-secure context is pushed in the stack. When SPM API returns,
  *   the pushed non-secure context is popped and overrides the returned
- *   context before returning to NSPE. Therefore it is unnecessary to
- *   explicitly clean up the context.
+ *   context before returning to NSPE. Therefore only the caller-saved
+ *   registers which are not popped are cleared, inline in each veneer.
  */
 
 #if defined(__ICCARM__)
@@ -48,38 +48,38 @@
 
 #endif
 
-__attribute__((naked, used))
-static void clear_caller_context(void)
-{
-    __ASM volatile(
+/*
+ * Clears the caller-saved registers which can hold secure data when the SPM API
+ * returns. R0 is the result, and R1 and R2 are overwritten by the pushed
+ * non-secure context afterwards. The FP registers are always cleared: with the
+ * IPC backend they can hold the values of another secure partition after a
+ * context switch, even when CONTROL_S.SFPA is clear.
+ */
 #if (CONFIG_TFM_FLOAT_ABI >= 1)
-        "   vmov.f32   s0, #1.0                               \n"
-        "   vmov.f32   s1, #1.0                               \n"
-        "   vmov.f32   s2, #1.0                               \n"
-        "   vmov.f32   s3, #1.0                               \n"
-        "   vmov.f32   s4, #1.0                               \n"
-        "   vmov.f32   s5, #1.0                               \n"
-        "   vmov.f32   s6, #1.0                               \n"
-        "   vmov.f32   s7, #1.0                               \n"
-        "   vmov.f32   s8, #1.0                               \n"
-        "   vmov.f32   s9, #1.0                               \n"
-        "   vmov.f32   s10, #1.0                              \n"
-        "   vmov.f32   s11, #1.0                              \n"
-        "   vmov.f32   s12, #1.0                              \n"
-        "   vmov.f32   s13, #1.0                              \n"
-        "   vmov.f32   s14, #1.0                              \n"
-        "   vmov.f32   s15, #1.0                              \n"
-        "   vmrs   r12, fpscr                                 \n"
-        "   movw   r1, #0x009f                                \n"
-        "   movt   r1, #0xf000                                \n"
-        "   bics   r12, r1                                    \n"
+#define CLEAR_CALLER_FP_CONTEXT()                                 \
+        "   movs   r3, #0x0                                   \n" \
+        "   vmov   s0, s1, r3, r3                             \n" \
+        "   vmov   s2, s3, r3, r3                             \n" \
+        "   vmov   s4, s5, r3, r3                             \n" \
+        "   vmov   s6, s7, r3, r3                             \n" \
+        "   vmov   s8, s9, r3, r3                             \n" \
+        "   vmov   s10, s11, r3, r3                           \n" \
+        "   vmov   s12, s13, r3, r3                           \n" \
+        "   vmov   s14, s15, r3, r3                           \n" \
+        "   vmrs   r12, fpscr                                 \n" \
+        "   movw   r1, #0x009f                                \n" \
+        "   movt   r1, #0xf000                                \n" \
+        "   bics   r12, r1                                    \n" \
         "   vmsr   fpscr, r12                                 \n"
+#else
+#define CLEAR_CALLER_FP_CONTEXT()
 #endif
-        "   movs    r3, #0x0                                  \n"
+
+#define CLEAR_CALLER_CONTEXT()                                    \
+        CLEAR_CALLER_FP_CONTEXT()                                 \
+        "   movs   r3, #0x0                                   \n" \
+        "   mov    r12, r3                                    \n" \
         "   msr    APSR_nzcvq, r3                             \n"
-        "   bx     lr                                         \n"
-    );
-}
 
 __tz_naked_veneer
 uint32_t tfm_psa_framework_version_veneer(void)
@@ -96,7 +96,7 @@ uint32_t tfm_psa_framework_version_veneer(void)
         "   bne    reent_panic1                               \n"
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(psa_framework_version)"               \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT()
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -127,7 +127,7 @@ uint32_t tfm_psa_version_veneer(uint32_t sid)
 
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(psa_version)"                         \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT()
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -164,7 +164,7 @@ psa_status_t tfm_psa_call_veneer(psa_handle_t handle,
         "   pop    {r2, r3}                                   \n"
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(tfm_psa_call_pack)"                   \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT()
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -197,7 +197,7 @@ psa_handle_t tfm_psa_connect_veneer(uint32_t sid, uint32_t version)
         "   bne    reent_panic3                               \n"
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(psa_connect)"                         \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT()
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -228,7 +228,8 @@ void tfm_psa_close_veneer(psa_handle_t handle)
 
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(psa_close)"                           \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT()
+        "   movs   r0, #0x0                                   \n"
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
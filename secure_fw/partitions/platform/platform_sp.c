@@ -174,6 +174,135 @@ static psa_status_t platform_sp_nv_increment_psa_api(const psa_msg_t *msg)
 
     return TFM_PLATFORM_ERR_SUCCESS;
 }
+
+/*
+ * Reads the counter IDs of a batched request from the first in_vec, and checks
+ * the permissions of all of them before any counter is accessed.
+ */
+static psa_status_t nv_counters_read_ids(const psa_msg_t *msg,
+                                         bool is_read,
+                                         enum tfm_nv_counter_t *counter_ids,
+                                         size_t *num)
+{
+    uint32_t ids[TFM_PLATFORM_NV_COUNTER_BATCH_MAX];
+    size_t i;
+
+    if ((msg->in_size[0] == 0) ||
+        (msg->in_size[0] > sizeof(ids)) ||
+        (msg->in_size[0] % sizeof(ids[0]) != 0)) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+    *num = msg->in_size[0] / sizeof(ids[0]);
+
+    if (psa_read(msg->handle, 0, ids, msg->in_size[0]) != msg->in_size[0]) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    for (i = 0; i < *num; i++) {
+        counter_ids[i] = (enum tfm_nv_counter_t)ids[i];
+        if (msg->client_id < 0) {
+            counter_ids[i] += PLAT_NV_COUNTER_NS_0;
+        }
+
+        if (nv_counter_permissions_check(msg->client_id, counter_ids[i],
+                                         is_read)
+            != TFM_PLATFORM_ERR_SUCCESS) {
+            return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+        }
+    }
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+
+static psa_status_t platform_sp_nv_read_multi_psa_api(const psa_msg_t *msg)
+{
+    enum tfm_nv_counter_t counter_ids[TFM_PLATFORM_NV_COUNTER_BATCH_MAX];
+    uint32_t vals[TFM_PLATFORM_NV_COUNTER_BATCH_MAX] = {0};
+    size_t num, i;
+
+    if (nv_counters_read_ids(msg, true, counter_ids, &num)
+        != TFM_PLATFORM_ERR_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    if (msg->out_size[0] != num * sizeof(vals[0])) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    for (i = 0; i < num; i++) {
+        if (tfm_plat_read_nv_counter(counter_ids[i], sizeof(vals[i]),
+                                     (uint8_t *)&vals[i])
+            != TFM_PLAT_ERR_SUCCESS) {
+            return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+        }
+    }
+
+    psa_write(msg->handle, 0, vals, num * sizeof(vals[0]));
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+
+static enum tfm_plat_err_t nv_counter_add(enum tfm_nv_counter_t counter_id,
+                                          uint32_t count)
+{
+    enum tfm_plat_err_t err;
+    uint32_t val;
+
+    if (count == 0) {
+        return TFM_PLAT_ERR_SUCCESS;
+    }
+
+    /* Set the final value in one access where the platform supports it. */
+    err = tfm_plat_read_nv_counter(counter_id, sizeof(val), (uint8_t *)&val);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+    if (val > UINT32_MAX - count) {
+        return TFM_PLAT_ERR_MAX_VALUE;
+    }
+
+    err = tfm_plat_set_nv_counter(counter_id, val + count);
+    if (err != TFM_PLAT_ERR_UNSUPPORTED) {
+        return err;
+    }
+
+    for (; count > 0; count--) {
+        err = tfm_plat_increment_nv_counter(counter_id);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+    }
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+static psa_status_t platform_sp_nv_increment_multi_psa_api(
+                                                        const psa_msg_t *msg)
+{
+    enum tfm_nv_counter_t counter_ids[TFM_PLATFORM_NV_COUNTER_BATCH_MAX];
+    uint32_t counts[TFM_PLATFORM_NV_COUNTER_BATCH_MAX];
+    size_t num, i;
+
+    if (nv_counters_read_ids(msg, false, counter_ids, &num)
+        != TFM_PLATFORM_ERR_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    if ((msg->in_size[1] != num * sizeof(counts[0])) ||
+        (psa_read(msg->handle, 1, counts, msg->in_size[1])
+         != msg->in_size[1])) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    for (i = 0; i < num; i++) {
+        if (nv_counter_add(counter_ids[i], counts[i])
+            != TFM_PLAT_ERR_SUCCESS) {
+            return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+        }
+    }
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
 #endif /* !PLATFORM_NV_COUNTER_MODULE_DISABLED*/
 
 static psa_status_t platform_sp_ioctl_psa_api(const psa_msg_t *msg)
@@ -249,6 +378,10 @@ psa_status_t tfm_platform_service_sfn(const psa_msg_t *msg)
         return platform_sp_nv_read_psa_api(msg);
     case TFM_PLATFORM_API_ID_NV_INCREMENT:
         return platform_sp_nv_increment_psa_api(msg);
+    case TFM_PLATFORM_API_ID_NV_READ_MULTI:
+        return platform_sp_nv_read_multi_psa_api(msg);
+    case TFM_PLATFORM_API_ID_NV_INCREMENT_MULTI:
+        return platform_sp_nv_increment_multi_psa_api(msg);
 #endif /* PLATFORM_NV_COUNTER_MODULE_DISABLED */
     case TFM_PLATFORM_API_ID_SYSTEM_RESET:
         return platform_sp_system_reset_psa_api(msg);
@@ -24,6 +24,14 @@
 #error "Invalid config: NOT PS_ROLLBACK_PROTECTION and PS_ENCRYPTION and PSA_ALG_GCM or PSA_ALG_CCM!"
 #endif
 
+#if PS_ROLLBACK_PROTECTION && (PS_ROLLBACK_EPOCH_SAVES == 0)
+#error "Invalid config: PS_ROLLBACK_PROTECTION and PS_ROLLBACK_EPOCH_SAVES is 0!"
+#endif
+
+#if PS_PACKED_OBJECT_MAX_SIZE && (PS_PACKED_OBJECT_NUM == 0)
+#error "Invalid config: PS_PACKED_OBJECT_MAX_SIZE and PS_PACKED_OBJECT_NUM is 0!"
+#endif
+
 /*
  * ITS_VALIDATE_METADATA_FROM_FLASH shall be enabled when PS_VALIDATE_METADATA_FROM_FLASH is
  * enabled
@@ -39,6 +39,103 @@ typedef char PS_ERROR_NOT_AEAD_ALG[(PSA_ALG_IS_AEAD(PS_CRYPTO_ALG)) ? 1 : -1];
 static psa_key_id_t ps_key;
 static uint8_t ps_crypto_iv_buf[PS_IV_LEN_BYTES];
 
+#if PS_CRYPTO_KEY_CACHE_ENTRIES
+/* The maximum length of the key labels of the cached keys */
+#define PS_KEY_LABEL_LEN_MAX  16
+
+/*!
+ * \struct ps_crypto_key_cache_entry_t
+ *
+ * \brief Entry of the cache of derived keys.
+ */
+struct ps_crypto_key_cache_entry_t {
+    psa_key_id_t key;                       /*!< Derived key, PSA_KEY_ID_NULL
+                                             *   if the entry is free
+                                             */
+    uint32_t last_use;                      /*!< Value of ps_key_cache_clock
+                                             *   when the key was last set
+                                             */
+    size_t label_len;                       /*!< Length of the key label */
+    uint8_t label[PS_KEY_LABEL_LEN_MAX];    /*!< Key label */
+};
+
+static struct ps_crypto_key_cache_entry_t
+                                    ps_key_cache[PS_CRYPTO_KEY_CACHE_ENTRIES];
+static uint32_t ps_key_cache_clock;
+
+/* Whether ps_key is owned by the cache, and must not be destroyed */
+static bool ps_key_cached;
+
+/**
+ * \brief Looks up the key derived from a key label in the cache.
+ *
+ * \param[in] key_label      Pointer to the key label
+ * \param[in] key_label_len  Length of the key label
+ *
+ * \return Returns true and sets ps_key if the key is cached, false otherwise
+ */
+static bool ps_crypto_key_cache_get(const uint8_t *key_label,
+                                    size_t key_label_len)
+{
+    uint32_t i;
+
+    for (i = 0; i < PS_CRYPTO_KEY_CACHE_ENTRIES; i++) {
+        if (ps_key_cache[i].key != PSA_KEY_ID_NULL &&
+            ps_key_cache[i].label_len == key_label_len &&
+            memcmp(ps_key_cache[i].label, key_label, key_label_len) == 0) {
+            ps_key_cache[i].last_use = ++ps_key_cache_clock;
+            ps_key = ps_key_cache[i].key;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * \brief Adds ps_key, derived from a key label, to the cache, in a free entry
+ *        or in place of the least recently used key, which is destroyed.
+ *
+ * \param[in] key_label      Pointer to the key label
+ * \param[in] key_label_len  Length of the key label
+ *
+ * \return Returns true if the key has been cached, false otherwise
+ */
+static bool ps_crypto_key_cache_add(const uint8_t *key_label,
+                                    size_t key_label_len)
+{
+    struct ps_crypto_key_cache_entry_t *entry = &ps_key_cache[0];
+    uint32_t i;
+
+    if (key_label_len > PS_KEY_LABEL_LEN_MAX) {
+        return false;
+    }
+
+    for (i = 0; i < PS_CRYPTO_KEY_CACHE_ENTRIES; i++) {
+        if (ps_key_cache[i].key == PSA_KEY_ID_NULL) {
+            entry = &ps_key_cache[i];
+            break;
+        }
+
+        if ((ps_key_cache_clock - ps_key_cache[i].last_use) >
+            (ps_key_cache_clock - entry->last_use)) {
+            entry = &ps_key_cache[i];
+        }
+    }
+
+    if (entry->key != PSA_KEY_ID_NULL) {
+        (void)psa_destroy_key(entry->key);
+    }
+
+    entry->key = ps_key;
+    entry->last_use = ++ps_key_cache_clock;
+    entry->label_len = key_label_len;
+    (void)memcpy(entry->label, key_label, key_label_len);
+
+    return true;
+}
+#endif /* PS_CRYPTO_KEY_CACHE_ENTRIES */
+
 psa_status_t ps_crypto_init(void)
 {
     /* For GCM and CCM it is essential that nonce doesn't get repeated. If there
@@ -67,6 +164,14 @@ psa_status_t ps_crypto_setkey(const uint8_t *key_label, size_t key_label_len)
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#if PS_CRYPTO_KEY_CACHE_ENTRIES
+    /* Reuse the key if it has already been derived from this label */
+    ps_key_cached = ps_crypto_key_cache_get(key_label, key_label_len);
+    if (ps_key_cached) {
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Set the key attributes for the storage key */
     psa_set_key_usage_flags(&attributes, PS_KEY_USAGE);
     psa_set_key_algorithm(&attributes, PS_CRYPTO_ALG);
@@ -105,6 +210,10 @@ psa_status_t ps_crypto_setkey(const uint8_t *key_label, size_t key_label_len)
         goto err_release_key;
     }
 
+#if PS_CRYPTO_KEY_CACHE_ENTRIES
+    ps_key_cached = ps_crypto_key_cache_add(key_label, key_label_len);
+#endif
+
     return PSA_SUCCESS;
 
 err_release_key:
@@ -120,6 +229,14 @@ psa_status_t ps_crypto_destroykey(void)
 {
     psa_status_t status;
 
+#if PS_CRYPTO_KEY_CACHE_ENTRIES
+    /* Cached keys are kept until they are replaced in the cache */
+    if (ps_key_cached) {
+        ps_key_cached = false;
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Destroy the transient key */
     status = psa_destroy_key(ps_key);
     if (status != PSA_SUCCESS) {
@@ -279,3 +396,17 @@ psa_status_t ps_crypto_authenticate(const union ps_crypto_t *crypto,
 
     return PSA_SUCCESS;
 }
+
+psa_status_t ps_crypto_hash(const uint8_t *in, size_t in_len, uint8_t *digest)
+{
+    psa_status_t status;
+    size_t out_len;
+
+    status = psa_hash_compute(PSA_ALG_SHA_256, in, in_len,
+                              digest, PS_DIGEST_LEN_BYTES, &out_len);
+    if (status != PSA_SUCCESS || out_len != PS_DIGEST_LEN_BYTES) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
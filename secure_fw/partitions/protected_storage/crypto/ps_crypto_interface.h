@@ -20,6 +20,7 @@ extern "C" {
 #define PS_KEY_LEN_BYTES  16
 #define PS_TAG_LEN_BYTES  16
 #define PS_IV_LEN_BYTES   12
+#define PS_DIGEST_LEN_BYTES 32
 
 /* Union containing crypto policy implementations. The ref member provides the
  * reference implementation. Further members can be added to the union to
@@ -130,6 +131,17 @@ psa_status_t ps_crypto_authenticate(const union ps_crypto_t *crypto,
                                     const uint8_t *add,
                                     uint32_t add_len);
 
+/**
+ * \brief Computes the SHA-256 digest of the given data.
+ *
+ * \param[in]  in      Pointer to the data to digest
+ * \param[in]  in_len  Length of the data to digest
+ * \param[out] digest  Pointer to the PS_DIGEST_LEN_BYTES long output buffer
+ *
+ * \return Returns values as described in \ref psa_status_t
+ */
+psa_status_t ps_crypto_hash(const uint8_t *in, size_t in_len, uint8_t *digest);
+
 /**
  * \brief Provides current IV value to crypto layer.
  *
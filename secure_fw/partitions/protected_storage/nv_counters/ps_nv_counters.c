@@ -39,3 +39,32 @@ psa_status_t ps_increment_nv_counter(enum tfm_nv_counter_t counter_id)
 
     return PSA_SUCCESS;
 }
+
+psa_status_t ps_read_nv_counters(const uint32_t *counter_ids, uint32_t *vals,
+                                 uint32_t num)
+{
+    enum tfm_platform_err_t err;
+
+    err = tfm_platform_nv_counter_read_multi(counter_ids, vals, num);
+    if (err != TFM_PLATFORM_ERR_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_increment_nv_counters(const uint32_t *counter_ids,
+                                      const uint32_t *counts, uint32_t num)
+{
+    enum tfm_platform_err_t err;
+
+    /* NOTE: As for ps_increment_nv_counter, reaching the maximum value of a
+     *       counter is an error.
+     */
+    err = tfm_platform_nv_counter_increment_multi(counter_ids, counts, num);
+    if (err != TFM_PLATFORM_ERR_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
@@ -52,6 +52,32 @@ psa_status_t ps_read_nv_counter(enum tfm_nv_counter_t counter_id,
  */
 psa_status_t ps_increment_nv_counter(enum tfm_nv_counter_t counter_id);
 
+/**
+ * \brief Reads several non-volatile (NV) counters in one request.
+ *
+ * \param[in]  counter_ids  NV counter IDs.
+ * \param[out] vals         Values of the counters, in the order of the IDs.
+ * \param[in]  num          Number of counters.
+ *
+ * \return  PSA_SUCCESS if the values are read correctly, otherwise
+ *          PSA_ERROR_GENERIC_ERROR
+ */
+psa_status_t ps_read_nv_counters(const uint32_t *counter_ids, uint32_t *vals,
+                                 uint32_t num);
+
+/**
+ * \brief Increments several non-volatile (NV) counters in one request.
+ *
+ * \param[in] counter_ids  NV counter IDs.
+ * \param[in] counts       Number of increments of each counter.
+ * \param[in] num          Number of counters.
+ *
+ * \return  If the counters are incremented correctly, it returns
+ *          PSA_SUCCESS. Otherwise, PSA_ERROR_GENERIC_ERROR.
+ */
+psa_status_t ps_increment_nv_counters(const uint32_t *counter_ids,
+                                      const uint32_t *counts, uint32_t num);
+
 #ifdef __cplusplus
 }
 #endif
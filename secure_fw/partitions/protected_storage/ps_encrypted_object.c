@@ -7,20 +7,71 @@
 
 #include "ps_encrypted_object.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
 #include "crypto/ps_crypto_interface.h"
-#include "psa/internal_trusted_storage.h"
+#include "ps_filesystem_interface.h"
 #include "ps_object_defs.h"
 #include "ps_utils.h"
 
+#define PS_OBJECT_START_POSITION  0
+
+#if (PS_ENCRYPTION_CHUNK_SIZE > 0)
+/*!
+ * \struct ps_obj_chunk_meta_t
+ *
+ * \brief Crypto metadata of an object chunk.
+ */
+struct ps_obj_chunk_meta_t {
+    uint8_t iv[PS_IV_LEN_BYTES];   /*!< IV value of the chunk */
+    uint8_t tag[PS_TAG_LEN_BYTES]; /*!< MAC value of the chunk */
+};
+
+/*!
+ * \struct ps_obj_chunk_auth_t
+ *
+ * \brief Associated data authenticated by the object tag. It binds the object
+ *        information and the tags of its chunks to the file ID.
+ */
+struct ps_obj_chunk_auth_t {
+    uint32_t fid;                                        /*!< File ID */
+    struct ps_object_info_t info;                        /*!< Object
+                                                          *   information
+                                                          */
+    struct ps_obj_chunk_meta_t chunk[PS_OBJ_CHUNKS_MAX]; /*!< Chunk metadata */
+};
+
+/* Gets the number of chunks of the given object data size */
+#define PS_OBJ_NUM_CHUNKS(size) (((size) + PS_ENCRYPTION_CHUNK_SIZE - 1) / \
+                                 PS_ENCRYPTION_CHUNK_SIZE)
+
+/* Gets the size of the associated data authenticated by the object tag */
+#define PS_OBJ_CHUNK_AUTH_SIZE(num_chunks) \
+    (offsetof(struct ps_obj_chunk_auth_t, chunk) + \
+     ((num_chunks) * sizeof(struct ps_obj_chunk_meta_t)))
+
+/* Gets the stored size of an object: the IV, the rest of the object header,
+ * which is not encrypted, the encrypted data and the chunk metadata.
+ */
+#define PS_OBJ_CHUNKED_STORED_SIZE(size) \
+    (PS_IV_LEN_BYTES + PS_OBJECT_HEADER_SIZE - sizeof(union ps_crypto_t) + \
+     (size) + (PS_OBJ_NUM_CHUNKS(size) * sizeof(struct ps_obj_chunk_meta_t)))
+
+PS_UTILS_BOUND_CHECK(CHUNK_META_NOT_FIT_IN_OBJ_CHUNK_META,
+                     sizeof(struct ps_obj_chunk_meta_t),
+                     PS_OBJ_CHUNK_META_SIZE);
+
+static struct ps_obj_chunk_auth_t ps_obj_chunk_auth;
+
+/* Buffer for one chunk, and its tag appended by the crypto layer */
+static uint8_t ps_obj_chunk_buf[PS_ENCRYPTION_CHUNK_SIZE + PS_TAG_LEN_BYTES];
+#else
 /* Gets the size of data to encrypt */
 #define PS_ENCRYPT_SIZE(plaintext_size) \
     ((plaintext_size) + PS_OBJECT_HEADER_SIZE - sizeof(union ps_crypto_t))
 
-#define PS_OBJECT_START_POSITION  0
-
 /* Buffer to store the maximum encrypted object */
 /* FIXME: Do partial encrypt/decrypt to reduce the size of internal buffer */
 #define PS_MAX_ENCRYPTED_OBJ_SIZE PS_ENCRYPT_SIZE(PS_MAX_OBJECT_DATA_SIZE)
@@ -31,6 +82,7 @@
 #define PS_TAG_IV_LEN_MAX   ((PS_TAG_LEN_BYTES > PS_IV_LEN_BYTES) ? \
                              PS_TAG_LEN_BYTES : PS_IV_LEN_BYTES)
 #define PS_CRYPTO_BUF_LEN (PS_MAX_ENCRYPTED_OBJ_SIZE + PS_TAG_IV_LEN_MAX)
+#endif /* PS_ENCRYPTION_CHUNK_SIZE > 0 */
 
 static psa_status_t fill_key_label(struct ps_object_t *obj, uint8_t *label)
 {
@@ -43,6 +95,242 @@ static psa_status_t fill_key_label(struct ps_object_t *obj, uint8_t *label)
     return PSA_SUCCESS;
 }
 
+#if (PS_ENCRYPTION_CHUNK_SIZE > 0)
+/**
+ * \brief Encrypts or decrypts, and authenticates, the chunks of the object data
+ *        which hold bytes of the given range. The chunk index is used as the
+ *        associated data, so that chunks can not be moved within the object.
+ *
+ * \param[in]     encrypt  Whether to encrypt or decrypt the chunks
+ * \param[in]     offset   Offset of the range in the object data
+ * \param[in]     size     Size of the range
+ * \param[in,out] obj      Pointer to the object structure. The chunks are
+ *                         processed in place and their metadata is kept in
+ *                         ps_obj_chunk_auth.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_crypt_chunks(bool encrypt, uint32_t offset,
+                                           uint32_t size,
+                                           struct ps_object_t *obj)
+{
+    psa_status_t err;
+    union ps_crypto_t crypto;
+    struct ps_obj_chunk_meta_t *meta;
+    uint32_t cur_size = obj->header.info.current_size;
+    uint32_t num_chunks = PS_OBJ_NUM_CHUNKS(cur_size);
+    uint32_t idx = offset / PS_ENCRYPTION_CHUNK_SIZE;
+    uint32_t last;
+    uint32_t len;
+    uint8_t *data;
+    size_t out_len;
+
+    if (size == 0 || idx >= num_chunks) {
+        return PSA_SUCCESS;
+    }
+
+    last = (uint32_t)((((uint64_t)offset + size) - 1) /
+                      PS_ENCRYPTION_CHUNK_SIZE);
+    if (last >= num_chunks) {
+        last = num_chunks - 1;
+    }
+
+    for (; idx <= last; idx++) {
+        meta = &ps_obj_chunk_auth.chunk[idx];
+        data = obj->data + (idx * PS_ENCRYPTION_CHUNK_SIZE);
+        len = PS_UTILS_MIN(PS_ENCRYPTION_CHUNK_SIZE,
+                           cur_size - (idx * PS_ENCRYPTION_CHUNK_SIZE));
+
+        if (encrypt) {
+            /* Get a new IV for each chunk encryption */
+            err = ps_crypto_get_iv(&crypto);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            err = ps_crypto_encrypt_and_tag(&crypto,
+                                            (const uint8_t *)&idx, sizeof(idx),
+                                            data, len,
+                                            ps_obj_chunk_buf,
+                                            sizeof(ps_obj_chunk_buf),
+                                            &out_len);
+            if (err != PSA_SUCCESS || out_len != len) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+
+            (void)memcpy(data, ps_obj_chunk_buf, len);
+            (void)memcpy(meta->iv, crypto.ref.iv, PS_IV_LEN_BYTES);
+            (void)memcpy(meta->tag, crypto.ref.tag, PS_TAG_LEN_BYTES);
+        } else {
+            (void)memcpy(crypto.ref.iv, meta->iv, PS_IV_LEN_BYTES);
+            (void)memcpy(crypto.ref.tag, meta->tag, PS_TAG_LEN_BYTES);
+
+            /* The crypto layer appends the tag to the input data */
+            (void)memcpy(ps_obj_chunk_buf, data, len);
+
+            err = ps_crypto_auth_and_decrypt(&crypto,
+                                             (const uint8_t *)&idx,
+                                             sizeof(idx),
+                                             ps_obj_chunk_buf, len,
+                                             data, len, &out_len);
+            if (err != PSA_SUCCESS || out_len != len) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Reads a chunked object, authenticates it and decrypts the chunks
+ *        which hold bytes of the given range.
+ *
+ * \param[in]     fid     File ID
+ * \param[in]     offset  Offset of the range in the object data
+ * \param[in]     size    Size of the range
+ * \param[in,out] obj     Pointer to the object structure to fill in. The tag
+ *                        of the object is the one stored in the object table
+ *                        for the given File ID.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_chunked_read(uint32_t fid, uint32_t offset,
+                                           uint32_t size,
+                                           struct ps_object_t *obj)
+{
+    psa_status_t err;
+    size_t data_length;
+    uint32_t cur_size;
+    uint32_t num_chunks;
+    uint8_t label[sizeof(int32_t) + sizeof(psa_storage_uid_t)];
+
+    /* The stored object is the IV, the object information, the encrypted
+     * data and the chunk metadata, which are read in one go after the IV
+     * array of the crypto union.
+     */
+    err = ps_its_get(fid, PS_OBJECT_START_POSITION,
+                     PS_OBJ_CHUNKED_STORED_SIZE(PS_MAX_OBJECT_DATA_SIZE),
+                     (void *)obj->header.crypto.ref.iv,
+                     &data_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (data_length < PS_OBJ_CHUNKED_STORED_SIZE(0)) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    cur_size = obj->header.info.current_size;
+    if (cur_size > PS_MAX_OBJECT_DATA_SIZE ||
+        data_length != PS_OBJ_CHUNKED_STORED_SIZE(cur_size)) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    num_chunks = PS_OBJ_NUM_CHUNKS(cur_size);
+    ps_obj_chunk_auth.fid = fid;
+    (void)memcpy(&ps_obj_chunk_auth.info, &obj->header.info,
+                 sizeof(ps_obj_chunk_auth.info));
+    (void)memcpy(ps_obj_chunk_auth.chunk, obj->data + cur_size,
+                 num_chunks * sizeof(struct ps_obj_chunk_meta_t));
+
+    err = fill_key_label(obj, label);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_crypto_setkey(label, sizeof(label));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Authenticate the object information and the chunk tags with the File
+     * ID, against the tag stored in the object table.
+     */
+    err = ps_crypto_authenticate(&obj->header.crypto,
+                                 (const uint8_t *)&ps_obj_chunk_auth,
+                                 PS_OBJ_CHUNK_AUTH_SIZE(num_chunks));
+    if (err == PSA_SUCCESS) {
+        err = ps_object_crypt_chunks(false, offset, size, obj);
+    }
+
+    if (err != PSA_SUCCESS) {
+        (void)ps_crypto_destroykey();
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return ps_crypto_destroykey();
+}
+
+/**
+ * \brief Encrypts the chunks of the object data which hold bytes of the given
+ *        range, generates the object tag and writes the chunked object.
+ *
+ * \param[in]     fid     File ID
+ * \param[in]     offset  Offset of the range in the object data
+ * \param[in]     size    Size of the range
+ * \param[in,out] obj     Pointer to the object structure to write. The chunks
+ *                        out of the range must hold the encrypted data read
+ *                        by \ref ps_object_chunked_read.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_chunked_write(uint32_t fid, uint32_t offset,
+                                            uint32_t size,
+                                            struct ps_object_t *obj)
+{
+    psa_status_t err;
+    uint32_t cur_size = obj->header.info.current_size;
+    uint32_t num_chunks = PS_OBJ_NUM_CHUNKS(cur_size);
+    uint8_t label[sizeof(int32_t) + sizeof(psa_storage_uid_t)];
+
+    err = fill_key_label(obj, label);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_crypto_setkey(label, sizeof(label));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_object_crypt_chunks(true, offset, size, obj);
+    if (err == PSA_SUCCESS) {
+        /* Get a new IV for each object tag */
+        err = ps_crypto_get_iv(&obj->header.crypto);
+    }
+
+    if (err == PSA_SUCCESS) {
+        ps_obj_chunk_auth.fid = fid;
+        (void)memcpy(&ps_obj_chunk_auth.info, &obj->header.info,
+                     sizeof(ps_obj_chunk_auth.info));
+
+        /* The tag will be stored in the object table and not as a part of the
+         * object's data stored in the FS.
+         */
+        err = ps_crypto_generate_auth_tag(&obj->header.crypto,
+                                          (const uint8_t *)&ps_obj_chunk_auth,
+                                          PS_OBJ_CHUNK_AUTH_SIZE(num_chunks));
+    }
+
+    if (err != PSA_SUCCESS) {
+        (void)ps_crypto_destroykey();
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = ps_crypto_destroykey();
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    (void)memcpy(obj->data + cur_size, ps_obj_chunk_auth.chunk,
+                 num_chunks * sizeof(struct ps_obj_chunk_meta_t));
+
+    return ps_its_set(fid, PS_OBJ_CHUNKED_STORED_SIZE(cur_size),
+                      (const void *)obj->header.crypto.ref.iv,
+                      PSA_STORAGE_FLAG_NONE);
+}
+#else
 /**
  * \brief Performs authenticated decryption on object data, with the header as
  *        the associated data.
@@ -152,9 +440,13 @@ static psa_status_t ps_object_auth_encrypt(uint32_t fid,
 
     return ps_crypto_destroykey();
 }
+#endif /* PS_ENCRYPTION_CHUNK_SIZE > 0 */
 
 psa_status_t ps_encrypted_object_read(uint32_t fid, struct ps_object_t *obj)
 {
+#if (PS_ENCRYPTION_CHUNK_SIZE > 0)
+    return ps_object_chunked_read(fid, 0, PS_MAX_OBJECT_DATA_SIZE, obj);
+#else
     psa_status_t err;
     uint32_t decrypt_size;
     size_t data_length;
@@ -165,10 +457,10 @@ psa_status_t ps_encrypted_object_read(uint32_t fid, struct ps_object_t *obj)
      * In the psa_its_get, the buffer size is not checked. Check the buffer size
      * here.
      */
-    err = psa_its_get(fid, PS_OBJECT_START_POSITION,
-                      PS_MAX_ENCRYPTED_OBJ_SIZE + PS_IV_LEN_BYTES,
-                      (void *)obj->header.crypto.ref.iv,
-                      &data_length);
+    err = ps_its_get(fid, PS_OBJECT_START_POSITION,
+                     PS_MAX_ENCRYPTED_OBJ_SIZE + PS_IV_LEN_BYTES,
+                     (void *)obj->header.crypto.ref.iv,
+                     &data_length);
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -187,10 +479,28 @@ psa_status_t ps_encrypted_object_read(uint32_t fid, struct ps_object_t *obj)
     }
 
     return PSA_SUCCESS;
+#endif /* PS_ENCRYPTION_CHUNK_SIZE > 0 */
+}
+
+psa_status_t ps_encrypted_object_read_range(uint32_t fid,
+                                            struct ps_object_t *obj,
+                                            uint32_t offset, uint32_t size)
+{
+#if (PS_ENCRYPTION_CHUNK_SIZE > 0)
+    return ps_object_chunked_read(fid, offset, size, obj);
+#else
+    (void)offset;
+    (void)size;
+
+    return ps_encrypted_object_read(fid, obj);
+#endif
 }
 
 psa_status_t ps_encrypted_object_write(uint32_t fid, struct ps_object_t *obj)
 {
+#if (PS_ENCRYPTION_CHUNK_SIZE > 0)
+    return ps_object_chunked_write(fid, 0, obj->header.info.current_size, obj);
+#else
     psa_status_t err;
     uint32_t wrt_size;
 
@@ -212,6 +522,21 @@ psa_status_t ps_encrypted_object_write(uint32_t fid, struct ps_object_t *obj)
     /* Write the encrypted object to the persistent area. The tag values is not
      * copied as it is stored in the object table.
      */
-    return psa_its_set(fid, wrt_size, (const void *)obj->header.crypto.ref.iv,
-                       PSA_STORAGE_FLAG_NONE);
+    return ps_its_set(fid, wrt_size, (const void *)obj->header.crypto.ref.iv,
+                      PSA_STORAGE_FLAG_NONE);
+#endif /* PS_ENCRYPTION_CHUNK_SIZE > 0 */
+}
+
+psa_status_t ps_encrypted_object_write_range(uint32_t fid,
+                                             struct ps_object_t *obj,
+                                             uint32_t offset, uint32_t size)
+{
+#if (PS_ENCRYPTION_CHUNK_SIZE > 0)
+    return ps_object_chunked_write(fid, offset, size, obj);
+#else
+    (void)offset;
+    (void)size;
+
+    return ps_encrypted_object_write(fid, obj);
+#endif
 }
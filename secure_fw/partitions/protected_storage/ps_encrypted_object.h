@@ -27,6 +27,26 @@ extern "C" {
 psa_status_t ps_encrypted_object_read(uint32_t fid,
                                       struct ps_object_t *obj);
 
+/**
+ * \brief Reads object referenced by the object File ID, and only decrypts the
+ *        part of its data needed to access the given range.
+ *
+ * \param[in]  fid      File ID
+ * \param[out] obj      Pointer to the object structure to fill in
+ * \param[in]  offset   Offset of the range in the object data
+ * \param[in]  size     Size of the range
+ *
+ * Note: With PS_ENCRYPTION_CHUNK_SIZE, only the chunks which hold bytes of the
+ *       range are decrypted, and the other ones are left encrypted in obj.
+ *       The object header is always authenticated and available. Otherwise,
+ *       the whole object is decrypted.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_read_range(uint32_t fid,
+                                            struct ps_object_t *obj,
+                                            uint32_t offset, uint32_t size);
+
 /**
  * \brief Creates and writes a new encrypted object based on the given
  *        ps_object_t structure data.
@@ -44,6 +64,27 @@ psa_status_t ps_encrypted_object_read(uint32_t fid,
 psa_status_t ps_encrypted_object_write(uint32_t fid,
                                        struct ps_object_t *obj);
 
+/**
+ * \brief Writes an object read by \ref ps_encrypted_object_read_range, of
+ *        which only the given range of the data has been modified.
+ *
+ * \param[in]     fid      File ID
+ * \param[in,out] obj      Pointer to the object structure to write.
+ * \param[in]     offset   Offset of the modified range in the object data
+ * \param[in]     size     Size of the modified range
+ *
+ * Note: With PS_ENCRYPTION_CHUNK_SIZE, only the chunks which hold bytes of the
+ *       range are encrypted again, and the other ones are written as they
+ *       were read. The range must be contained in the range given to the
+ *       read, apart from the bytes beyond the previous object size.
+ *       Otherwise, the whole object is encrypted again.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_write_range(uint32_t fid,
+                                             struct ps_object_t *obj,
+                                             uint32_t offset, uint32_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2023-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -9,26 +9,33 @@
 #include "psa_manifest/sid.h"
 #include "tfm_its_defs.h"
 #include "psa_manifest/pid.h"
+#include "ps_filesystem_interface.h"
 #include "tfm_internal_trusted_storage.h"
 
+#ifdef PS_ITS_DIRECT_ACCESS
+/* Owned by the ITS partition, which takes the data of PS calls from them */
+extern uint8_t *p_psa_src_data;
+extern uint8_t *p_psa_dest_data;
+#else
 uint8_t *p_psa_src_data;
 uint8_t *p_psa_dest_data;
+#endif
 
-psa_status_t psa_its_set(psa_storage_uid_t uid,
-                         size_t data_length,
-                         void *p_data,
-                         psa_storage_create_flags_t create_flags)
+psa_status_t ps_its_set(psa_storage_uid_t uid,
+                        size_t data_length,
+                        const void *p_data,
+                        psa_storage_create_flags_t create_flags)
 {
-    p_psa_src_data = p_data;
+    p_psa_src_data = (uint8_t *)p_data;
 
     return tfm_its_set(TFM_SP_PS, uid, data_length, create_flags);
 }
 
-psa_status_t psa_its_get(psa_storage_uid_t uid,
-                         size_t data_offset,
-                         size_t data_size,
-                         void *p_data,
-                         size_t *p_data_length)
+psa_status_t ps_its_get(psa_storage_uid_t uid,
+                        size_t data_offset,
+                        size_t data_size,
+                        void *p_data,
+                        size_t *p_data_length)
 {
     if (p_data_length == NULL) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -39,13 +46,13 @@ psa_status_t psa_its_get(psa_storage_uid_t uid,
     return tfm_its_get(TFM_SP_PS, uid, data_offset, data_size, p_data_length);
 }
 
-psa_status_t psa_its_get_info(psa_storage_uid_t uid,
-                              struct psa_storage_info_t *p_info)
+psa_status_t ps_its_get_info(psa_storage_uid_t uid,
+                             struct psa_storage_info_t *p_info)
 {
     return tfm_its_get_info(TFM_SP_PS, uid, p_info);
 }
 
-psa_status_t psa_its_remove(psa_storage_uid_t uid)
+psa_status_t ps_its_remove(psa_storage_uid_t uid)
 {
     return tfm_its_remove(TFM_SP_PS, uid);
 }
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PS_FILESYSTEM_INTERFACE_H__
+#define __PS_FILESYSTEM_INTERFACE_H__
+
+#include <stddef.h>
+
+#include "psa/internal_trusted_storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * PS stores its objects in its own area of the ITS filesystem. It is reached
+ * through the PSA ITS API, unless PS_ITS_DIRECT_ACCESS is defined. Then PS
+ * calls the filesystem code of the ITS partition directly, without a message
+ * to the ITS partition, and the object data is copied only once, between the
+ * PS buffers and the flash.
+ */
+#ifdef PS_ITS_DIRECT_ACCESS
+psa_status_t ps_its_set(psa_storage_uid_t uid,
+                        size_t data_length,
+                        const void *p_data,
+                        psa_storage_create_flags_t create_flags);
+
+psa_status_t ps_its_get(psa_storage_uid_t uid,
+                        size_t data_offset,
+                        size_t data_size,
+                        void *p_data,
+                        size_t *p_data_length);
+
+psa_status_t ps_its_get_info(psa_storage_uid_t uid,
+                             struct psa_storage_info_t *p_info);
+
+psa_status_t ps_its_remove(psa_storage_uid_t uid);
+#else
+#define ps_its_set      psa_its_set
+#define ps_its_get      psa_its_get
+#define ps_its_get_info psa_its_get_info
+#define ps_its_remove   psa_its_remove
+#endif /* PS_ITS_DIRECT_ACCESS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PS_FILESYSTEM_INTERFACE_H__ */
@@ -49,6 +49,16 @@ struct ps_obj_header_t {
 #ifdef PS_ENCRYPTION
 #define PS_TAG_IV_LEN_MAX   ((PS_TAG_LEN_BYTES > PS_IV_LEN_BYTES) ? \
                              PS_TAG_LEN_BYTES : PS_IV_LEN_BYTES)
+
+#if (PS_ENCRYPTION_CHUNK_SIZE > 0)
+/* Maximum number of chunks the object data is encrypted in */
+#define PS_OBJ_CHUNKS_MAX  ((PS_MAX_OBJECT_DATA_SIZE + \
+                             PS_ENCRYPTION_CHUNK_SIZE - 1) / \
+                            PS_ENCRYPTION_CHUNK_SIZE)
+
+/* Size of the IV and tag of a chunk, stored after the object data */
+#define PS_OBJ_CHUNK_META_SIZE  (PS_IV_LEN_BYTES + PS_TAG_LEN_BYTES)
+#endif
 #endif
 
 /*!
@@ -61,8 +71,15 @@ struct ps_object_t {
     struct ps_obj_header_t header;         /*!< Object header */
     uint8_t data[PS_MAX_OBJECT_DATA_SIZE]; /*!< Object data */
 #ifdef PS_ENCRYPTION
+#if (PS_ENCRYPTION_CHUNK_SIZE > 0)
+    /* IVs and tags of the chunks, placed after the object data when the
+     * object is stored.
+     */
+    uint8_t chunk_meta[PS_OBJ_CHUNKS_MAX * PS_OBJ_CHUNK_META_SIZE];
+#else
     uint8_t tag_iv[PS_TAG_IV_LEN_MAX];
 #endif
+#endif
 };
 
 
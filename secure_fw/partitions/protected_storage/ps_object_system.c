@@ -7,17 +7,19 @@
 
 #include "ps_object_system.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
 #include "cmsis_compiler.h"
-#include "psa/internal_trusted_storage.h"
+#include "ps_filesystem_interface.h"
 #ifdef PS_ENCRYPTION
 #include "ps_encrypted_object.h"
 #endif
 #include "ps_object_defs.h"
 #include "ps_object_table.h"
 #include "ps_utils.h"
+#include "tfm_ps_defs.h"
 #include "tfm_ps_req_mngr.h"
 
 #ifndef PS_ENCRYPTION
@@ -30,6 +32,113 @@
 static struct ps_object_t g_ps_object;
 static struct ps_obj_table_info_t g_obj_tbl_info;
 
+#if PS_OBJ_CACHE_ENTRIES
+/*!
+ * \struct ps_obj_cache_entry_t
+ *
+ * \brief Entry of the cache of authenticated plaintext objects.
+ */
+struct ps_obj_cache_entry_t {
+    psa_storage_uid_t uid;           /*!< Object UID, TFM_PS_INVALID_UID if
+                                      *   the entry is free
+                                      */
+    int32_t client_id;               /*!< Client ID */
+    uint32_t last_use;               /*!< Value of ps_obj_cache_clock when
+                                      *   the entry was last used
+                                      */
+    struct ps_object_info_t info;    /*!< Object information */
+    uint8_t data[PS_OBJ_CACHE_MAX_SIZE]; /*!< Object data */
+};
+
+static struct ps_obj_cache_entry_t ps_obj_cache[PS_OBJ_CACHE_ENTRIES];
+static uint32_t ps_obj_cache_clock;
+
+/**
+ * \brief Gets the cache entry of an object.
+ *
+ * \param[in] uid        Object UID
+ * \param[in] client_id  Client ID
+ *
+ * \return Returns the cache entry, or NULL if the object is not cached
+ */
+static struct ps_obj_cache_entry_t *ps_obj_cache_find(psa_storage_uid_t uid,
+                                                      int32_t client_id)
+{
+    uint32_t i;
+
+    for (i = 0; i < PS_OBJ_CACHE_ENTRIES; i++) {
+        if (ps_obj_cache[i].uid == uid &&
+            ps_obj_cache[i].client_id == client_id) {
+            ps_obj_cache[i].last_use = ++ps_obj_cache_clock;
+            return &ps_obj_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Adds an authenticated and decrypted object to the cache, in a free
+ *        entry or in place of the least recently used one.
+ *
+ * \param[in] uid        Object UID
+ * \param[in] client_id  Client ID
+ * \param[in] obj        Pointer to the object. Objects bigger than
+ *                       PS_OBJ_CACHE_MAX_SIZE are not cached.
+ */
+static void ps_obj_cache_insert(psa_storage_uid_t uid, int32_t client_id,
+                                const struct ps_object_t *obj)
+{
+    struct ps_obj_cache_entry_t *entry = &ps_obj_cache[0];
+    uint32_t i;
+
+    if (obj->header.info.current_size > PS_OBJ_CACHE_MAX_SIZE) {
+        return;
+    }
+
+    for (i = 0; i < PS_OBJ_CACHE_ENTRIES; i++) {
+        if (ps_obj_cache[i].uid == TFM_PS_INVALID_UID) {
+            entry = &ps_obj_cache[i];
+            break;
+        }
+
+        if ((ps_obj_cache_clock - ps_obj_cache[i].last_use) >
+            (ps_obj_cache_clock - entry->last_use)) {
+            entry = &ps_obj_cache[i];
+        }
+    }
+
+    entry->uid = uid;
+    entry->client_id = client_id;
+    entry->last_use = ++ps_obj_cache_clock;
+    entry->info = obj->header.info;
+    (void)memcpy(entry->data, obj->data, obj->header.info.current_size);
+}
+
+/**
+ * \brief Removes an object from the cache, before the object is modified.
+ *
+ * \param[in] uid        Object UID
+ * \param[in] client_id  Client ID
+ */
+static void ps_obj_cache_invalidate(psa_storage_uid_t uid, int32_t client_id)
+{
+    struct ps_obj_cache_entry_t *entry = ps_obj_cache_find(uid, client_id);
+
+    if (entry != NULL) {
+        (void)memset(entry, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(*entry));
+    }
+}
+
+/**
+ * \brief Removes all the objects from the cache.
+ */
+static void ps_obj_cache_flush(void)
+{
+    (void)memset(ps_obj_cache, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(ps_obj_cache));
+}
+#endif /* PS_OBJ_CACHE_ENTRIES */
+
 /**
  * \brief Initialize g_ps_object based on the input parameters and empty data.
  *
@@ -75,7 +184,7 @@ static psa_status_t ps_remove_old_data(uint32_t old_fid)
     }
 
     /* Delete old file from the persistent area */
-    return psa_its_remove(old_fid);
+    return ps_its_remove(old_fid);
 }
 
 #ifndef PS_ENCRYPTION
@@ -98,11 +207,11 @@ static psa_status_t ps_read_object(enum read_type_t type)
     size_t data_length;
 
     /* Read object header */
-    err = psa_its_get(g_obj_tbl_info.fid,
-                      PS_OBJECT_START_POSITION,
-                      PS_OBJECT_HEADER_SIZE,
-                      (void *)&g_ps_object.header,
-                      &data_length);
+    err = ps_its_get(g_obj_tbl_info.fid,
+                     PS_OBJECT_START_POSITION,
+                     PS_OBJECT_HEADER_SIZE,
+                     (void *)&g_ps_object.header,
+                     &data_length);
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -117,11 +226,11 @@ static psa_status_t ps_read_object(enum read_type_t type)
 
     /* Read object data if any */
     if (type == READ_ALL_OBJECT && g_ps_object.header.info.current_size > 0) {
-        err = psa_its_get(g_obj_tbl_info.fid,
-                          PS_OBJECT_HEADER_SIZE,
-                          g_ps_object.header.info.current_size,
-                          (void *)g_ps_object.data,
-                          &data_length);
+        err = ps_its_get(g_obj_tbl_info.fid,
+                         PS_OBJECT_HEADER_SIZE,
+                         g_ps_object.header.info.current_size,
+                         (void *)g_ps_object.data,
+                         &data_length);
         if (err != PSA_SUCCESS) {
             return err;
         }
@@ -147,13 +256,558 @@ static psa_status_t ps_write_object(uint32_t wrt_size)
     /* Save object version to be stored in the object table */
     g_obj_tbl_info.version = g_ps_object.header.version;
 
-    return psa_its_set(g_obj_tbl_info.fid, wrt_size,
-                       (const void *)&g_ps_object,
-                       PSA_STORAGE_FLAG_NONE);
+    return ps_its_set(g_obj_tbl_info.fid, wrt_size,
+                      (const void *)&g_ps_object,
+                      PSA_STORAGE_FLAG_NONE);
 }
 
 #endif /* !PS_ENCRYPTION */
 
+#if PS_PACKED_OBJECT_MAX_SIZE
+/* UID and client ID of the container object. No client has the client ID 0,
+ * so the container can not be accessed through the PS interface.
+ */
+#define PS_PACK_UID        1
+#define PS_PACK_CLIENT_ID  0
+
+/* Index of an object which is not in the container */
+#define PS_PACK_NO_ENTRY   UINT32_MAX
+
+/*!
+ * \struct ps_pack_entry_t
+ *
+ * \brief Directory entry of an object packed in the container.
+ */
+struct ps_pack_entry_t {
+    psa_storage_uid_t uid;        /*!< Object UID */
+    int32_t client_id;            /*!< Client ID */
+    struct ps_object_info_t info; /*!< Object information */
+};
+
+/*!
+ * \struct ps_pack_dir_t
+ *
+ * \brief Directory of the container. The data of the objects follows it, in
+ *        the order of their entries, and each object takes its maximum size.
+ */
+struct ps_pack_dir_t {
+    uint32_t num_entries;                               /*!< Number of objects
+                                                         *   in the container
+                                                         */
+    struct ps_pack_entry_t entry[PS_PACKED_OBJECT_NUM]; /*!< Objects */
+};
+
+PS_UTILS_BOUND_CHECK(PACK_DIR_NOT_FIT_IN_STATIC_OBJ_DATA_BUF,
+                     sizeof(struct ps_pack_dir_t) + PS_PACKED_OBJECT_MAX_SIZE,
+                     PS_MAX_OBJECT_DATA_SIZE);
+
+#define PS_PACK_DATA_SIZE (PS_MAX_OBJECT_DATA_SIZE - \
+                           sizeof(struct ps_pack_dir_t))
+
+/*!
+ * \struct ps_pack_t
+ *
+ * \brief The container of the small objects, as it is stored in the data of
+ *        the container object. It is kept decrypted in RAM, and written again
+ *        as a whole each time one of its objects is modified.
+ */
+struct ps_pack_t {
+    struct ps_pack_dir_t dir;          /*!< Directory */
+    uint8_t data[PS_PACK_DATA_SIZE];   /*!< Data of the objects */
+};
+
+static struct ps_pack_t ps_pack;
+static bool ps_pack_loaded;
+
+/**
+ * \brief Gets the offset of the data of a packed object in the container.
+ *        The index of the entry after the last one gives the used data size.
+ *
+ * \param[in] idx  Index of the entry
+ *
+ * \return Returns the offset in ps_pack.data
+ */
+static uint32_t ps_pack_data_offset(uint32_t idx)
+{
+    uint32_t offset = 0;
+    uint32_t i;
+
+    for (i = 0; i < idx; i++) {
+        offset += ps_pack.dir.entry[i].info.max_size;
+    }
+
+    return offset;
+}
+
+/**
+ * \brief Reads and validates the container object into ps_pack. The container
+ *        is empty if the object does not exist.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_pack_load(void)
+{
+    psa_status_t err;
+    struct ps_pack_entry_t *entry;
+    uint32_t size;
+    uint32_t used = 0;
+    uint32_t i;
+
+    (void)memset(&ps_pack, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(ps_pack));
+
+    err = ps_object_table_get_obj_tbl_info(PS_PACK_UID, PS_PACK_CLIENT_ID,
+                                           &g_obj_tbl_info);
+    if (err == PSA_ERROR_DOES_NOT_EXIST) {
+        ps_pack_loaded = true;
+        return PSA_SUCCESS;
+    } else if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+#ifdef PS_ENCRYPTION
+    g_ps_object.header.crypto.ref.uid = PS_PACK_UID;
+    g_ps_object.header.crypto.ref.client_id = PS_PACK_CLIENT_ID;
+
+    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+#else
+    err = ps_read_object(READ_ALL_OBJECT);
+#endif
+    if (err != PSA_SUCCESS) {
+        goto clear_data_and_return;
+    }
+
+    size = g_ps_object.header.info.current_size;
+    if (size < sizeof(struct ps_pack_dir_t) || size > sizeof(ps_pack)) {
+        err = PSA_ERROR_DATA_CORRUPT;
+        goto clear_data_and_return;
+    }
+
+    (void)memcpy(&ps_pack, g_ps_object.data, size);
+
+    /* Check the directory against the size of the stored data */
+    if (ps_pack.dir.num_entries > PS_PACKED_OBJECT_NUM) {
+        err = PSA_ERROR_DATA_CORRUPT;
+        goto clear_data_and_return;
+    }
+
+    for (i = 0; i < ps_pack.dir.num_entries; i++) {
+        entry = &ps_pack.dir.entry[i];
+        if (entry->info.max_size > PS_PACKED_OBJECT_MAX_SIZE ||
+            entry->info.current_size > entry->info.max_size) {
+            err = PSA_ERROR_DATA_CORRUPT;
+            goto clear_data_and_return;
+        }
+        used += entry->info.max_size;
+    }
+
+    if (used != size - sizeof(struct ps_pack_dir_t)) {
+        err = PSA_ERROR_DATA_CORRUPT;
+        goto clear_data_and_return;
+    }
+
+    ps_pack_loaded = true;
+
+clear_data_and_return:
+    if (err != PSA_SUCCESS) {
+        (void)memset(&ps_pack, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(ps_pack));
+    }
+
+    /* Remove data stored in the object before leaving the function */
+    (void)memset(&g_ps_object, PS_DEFAULT_EMPTY_BUFF_VAL, PS_MAX_OBJECT_SIZE);
+
+    return err;
+}
+
+/**
+ * \brief Writes ps_pack as the new version of the container object, in the
+ *        same way as ps_object_create() replaces an object.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_pack_save(void)
+{
+    psa_status_t err;
+    uint32_t old_fid = PS_INVALID_FID;
+    uint32_t fid_am_reserved = 2;
+    uint32_t size = sizeof(struct ps_pack_dir_t) +
+                    ps_pack_data_offset(ps_pack.dir.num_entries);
+#ifndef PS_ENCRYPTION
+    uint32_t version = 0;
+#endif
+
+    err = ps_object_table_get_obj_tbl_info(PS_PACK_UID, PS_PACK_CLIENT_ID,
+                                           &g_obj_tbl_info);
+    if (err == PSA_SUCCESS) {
+        old_fid = g_obj_tbl_info.fid;
+        fid_am_reserved = 1;
+#ifndef PS_ENCRYPTION
+        version = g_obj_tbl_info.version;
+#endif
+    } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+
+    ps_init_empty_object(PSA_STORAGE_FLAG_NONE, size, &g_ps_object);
+#ifndef PS_ENCRYPTION
+    g_ps_object.header.version = version;
+#endif
+
+    (void)memcpy(g_ps_object.data, &ps_pack, size);
+    g_ps_object.header.info.current_size = size;
+
+    /* Get new file ID */
+    err = ps_object_table_get_free_fid(fid_am_reserved, &g_obj_tbl_info.fid);
+    if (err != PSA_SUCCESS) {
+        goto clear_data_and_return;
+    }
+
+#ifdef PS_ENCRYPTION
+    g_ps_object.header.crypto.ref.uid = PS_PACK_UID;
+    g_ps_object.header.crypto.ref.client_id = PS_PACK_CLIENT_ID;
+
+    err = ps_encrypted_object_write(g_obj_tbl_info.fid, &g_ps_object);
+#else
+    err = ps_write_object(PS_OBJECT_SIZE(size));
+#endif
+    if (err != PSA_SUCCESS) {
+        goto clear_data_and_return;
+    }
+
+    err = ps_object_table_set_obj_tbl_info(PS_PACK_UID, PS_PACK_CLIENT_ID,
+                                           &g_obj_tbl_info);
+    if (err != PSA_SUCCESS) {
+        (void)ps_its_remove(g_obj_tbl_info.fid);
+
+        goto clear_data_and_return;
+    }
+
+    if (old_fid == PS_INVALID_FID) {
+        err = ps_object_table_delete_old_table();
+    } else {
+        err = ps_remove_old_data(old_fid);
+    }
+
+clear_data_and_return:
+    /* Remove data stored in the object before leaving the function */
+    (void)memset(&g_ps_object, PS_DEFAULT_EMPTY_BUFF_VAL, PS_MAX_OBJECT_SIZE);
+
+    return err;
+}
+
+/**
+ * \brief Stores the modified ps_pack. If that fails, ps_pack is read again
+ *        from the stored container, so that it does not keep the
+ *        modification.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_pack_commit(psa_status_t err)
+{
+    if (err == PSA_SUCCESS) {
+        err = ps_pack_save();
+    }
+
+    if (err != PSA_SUCCESS) {
+        /* Loaded again on the next request if it fails now */
+        ps_pack_loaded = false;
+        (void)ps_pack_load();
+    }
+
+    return err;
+}
+
+/**
+ * \brief Gets the directory entry of a packed object.
+ *
+ * \param[in]  uid        Object UID
+ * \param[in]  client_id  Client ID
+ * \param[out] p_idx      Index of the entry
+ *
+ * \return Returns PSA_SUCCESS if the object is in the container,
+ *         PSA_ERROR_DOES_NOT_EXIST if it is not, or another error code as
+ *         specified in \ref psa_status_t if the container can not be read.
+ */
+static psa_status_t ps_pack_find(psa_storage_uid_t uid, int32_t client_id,
+                                 uint32_t *p_idx)
+{
+    psa_status_t err;
+    uint32_t i;
+
+    if (!ps_pack_loaded) {
+        err = ps_pack_load();
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    for (i = 0; i < ps_pack.dir.num_entries; i++) {
+        if (ps_pack.dir.entry[i].uid == uid &&
+            ps_pack.dir.entry[i].client_id == client_id) {
+            *p_idx = i;
+            return PSA_SUCCESS;
+        }
+    }
+
+    return PSA_ERROR_DOES_NOT_EXIST;
+}
+
+/**
+ * \brief Checks whether an object of the given size can be packed, in place
+ *        of a packed object if any.
+ *
+ * \param[in] idx   Index of the packed object to replace, or PS_PACK_NO_ENTRY
+ * \param[in] size  Object size
+ *
+ * \return Returns true if there is room for the object in the container
+ */
+static bool ps_pack_fits(uint32_t idx, uint32_t size)
+{
+    uint32_t num = ps_pack.dir.num_entries;
+    uint32_t free_size = PS_PACK_DATA_SIZE - ps_pack_data_offset(num);
+
+    if (size > PS_PACKED_OBJECT_MAX_SIZE) {
+        return false;
+    }
+
+    if (idx != PS_PACK_NO_ENTRY) {
+        num--;
+        free_size += ps_pack.dir.entry[idx].info.max_size;
+    }
+
+    return (num < PS_PACKED_OBJECT_NUM) && (size <= free_size);
+}
+
+/**
+ * \brief Removes a packed object from ps_pack, and moves the data of the next
+ *        objects down.
+ *
+ * \param[in] idx  Index of the entry
+ */
+static void ps_pack_remove_entry(uint32_t idx)
+{
+    uint32_t offset = ps_pack_data_offset(idx);
+    uint32_t size = ps_pack.dir.entry[idx].info.max_size;
+    uint32_t used = ps_pack_data_offset(ps_pack.dir.num_entries);
+    uint32_t last = ps_pack.dir.num_entries - 1;
+
+    (void)memmove(ps_pack.data + offset, ps_pack.data + offset + size,
+                  used - offset - size);
+    (void)memset(ps_pack.data + used - size, PS_DEFAULT_EMPTY_BUFF_VAL, size);
+
+    (void)memmove(&ps_pack.dir.entry[idx], &ps_pack.dir.entry[idx + 1],
+                  (last - idx) * sizeof(struct ps_pack_entry_t));
+    (void)memset(&ps_pack.dir.entry[last], PS_DEFAULT_EMPTY_BUFF_VAL,
+                 sizeof(struct ps_pack_entry_t));
+
+    ps_pack.dir.num_entries = last;
+}
+
+/**
+ * \brief Reads a packed object.
+ *
+ * \param[in]  idx            Index of the entry
+ * \param[in]  offset         Offset in the object data
+ * \param[in]  size           Size of the data to read
+ * \param[out] p_data_length  Size of the data read
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_pack_read(uint32_t idx, uint32_t offset, uint32_t size,
+                                 size_t *p_data_length)
+{
+    const struct ps_pack_entry_t *entry = &ps_pack.dir.entry[idx];
+
+    /* Boundary check the incoming request */
+    if (offset > entry->info.current_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    size = PS_UTILS_MIN(size, entry->info.current_size - offset);
+
+    ps_req_mngr_write_asset_data(ps_pack.data + ps_pack_data_offset(idx) +
+                                 offset, size);
+
+    *p_data_length = size;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Creates or replaces an object in the container. An object of the
+ *        same UID stored in its own file is removed once the container is
+ *        stored, so that it is kept if the container can not be stored.
+ *
+ * \param[in] idx           Index of the packed object to replace, or
+ *                          PS_PACK_NO_ENTRY
+ * \param[in] uid           Object UID
+ * \param[in] client_id     Client ID
+ * \param[in] create_flags  Object create flags
+ * \param[in] size          Object size, which fits in the container
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_pack_create(uint32_t idx, psa_storage_uid_t uid,
+                                   int32_t client_id,
+                                   psa_storage_create_flags_t create_flags,
+                                   uint32_t size)
+{
+    psa_status_t err;
+    struct ps_pack_entry_t *entry;
+    uint32_t old_fid = PS_INVALID_FID;
+    uint32_t offset;
+
+    if (idx == PS_PACK_NO_ENTRY) {
+        err = ps_object_table_get_obj_tbl_info(uid, client_id,
+                                               &g_obj_tbl_info);
+        if (err == PSA_SUCCESS) {
+#if PS_OBJ_CACHE_ENTRIES
+            ps_obj_cache_invalidate(uid, client_id);
+#endif
+
+#ifdef PS_ENCRYPTION
+            g_ps_object.header.crypto.ref.uid = uid;
+            g_ps_object.header.crypto.ref.client_id = client_id;
+
+            err = ps_encrypted_object_read_range(g_obj_tbl_info.fid,
+                                                 &g_ps_object, 0, 0);
+#else
+            err = ps_read_object(READ_HEADER_ONLY);
+#endif
+            if (err == PSA_SUCCESS && (g_ps_object.header.info.create_flags &
+                                       PSA_STORAGE_FLAG_WRITE_ONCE)) {
+                err = PSA_ERROR_NOT_PERMITTED;
+            }
+
+            (void)memset(&g_ps_object, PS_DEFAULT_EMPTY_BUFF_VAL,
+                         PS_MAX_OBJECT_SIZE);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            old_fid = g_obj_tbl_info.fid;
+        } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
+            return err;
+        }
+    } else {
+        ps_pack_remove_entry(idx);
+    }
+
+    /* Add the object after the last one */
+    entry = &ps_pack.dir.entry[ps_pack.dir.num_entries];
+    entry->uid = uid;
+    entry->client_id = client_id;
+    entry->info.current_size = size;
+    entry->info.max_size = size;
+    entry->info.create_flags = create_flags;
+
+    offset = ps_pack_data_offset(ps_pack.dir.num_entries);
+    ps_pack.dir.num_entries++;
+
+    err = ps_req_mngr_read_asset_data(ps_pack.data + offset, size);
+
+    err = ps_pack_commit(err);
+    if (err != PSA_SUCCESS || old_fid == PS_INVALID_FID) {
+        return err;
+    }
+
+    /* Remove the file of the object which is now packed */
+    err = ps_object_table_delete_object(uid, client_id);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return ps_remove_old_data(old_fid);
+}
+
+/**
+ * \brief Writes data in a packed object.
+ *
+ * \param[in] idx     Index of the entry
+ * \param[in] offset  Offset in the object data
+ * \param[in] size    Size of the data to write
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_pack_write(uint32_t idx, uint32_t offset, uint32_t size)
+{
+    psa_status_t err;
+    struct ps_pack_entry_t *entry = &ps_pack.dir.entry[idx];
+
+    /* If the object has the write once flag set, then it cannot be modified. */
+    if (entry->info.create_flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    /* Offset must not be larger than the object's current size to prevent gaps
+     * being created in the object data.
+     */
+    if (offset > entry->info.current_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Boundary check the incoming request */
+    err = ps_utils_check_contained_in(entry->info.max_size, offset, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_req_mngr_read_asset_data(ps_pack.data + ps_pack_data_offset(idx) +
+                                      offset, size);
+
+    /* Update the current object size if necessary */
+    if ((offset + size) > entry->info.current_size) {
+        entry->info.current_size = offset + size;
+    }
+
+    return ps_pack_commit(err);
+}
+
+/**
+ * \brief Removes objects stored both in the container and in their own file,
+ *        which is left by a reset before an object moved in or out of the
+ *        container was removed from its former place. The packed object is
+ *        the one kept, as it is either the new object or the one a failed
+ *        create did not replace.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_pack_prepare(void)
+{
+    psa_status_t err;
+    uint32_t i;
+
+    ps_pack_loaded = false;
+    err = ps_pack_load();
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    for (i = 0; i < ps_pack.dir.num_entries; i++) {
+        err = ps_object_table_get_obj_tbl_info(ps_pack.dir.entry[i].uid,
+                                               ps_pack.dir.entry[i].client_id,
+                                               &g_obj_tbl_info);
+        if (err == PSA_ERROR_DOES_NOT_EXIST) {
+            continue;
+        } else if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = ps_object_table_delete_object(ps_pack.dir.entry[i].uid,
+                                            ps_pack.dir.entry[i].client_id);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = ps_remove_old_data(g_obj_tbl_info.fid);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* PS_PACKED_OBJECT_MAX_SIZE */
+
 psa_status_t ps_system_prepare(void)
 {
     psa_status_t err;
@@ -165,10 +819,20 @@ psa_status_t ps_system_prepare(void)
      */
     err = ps_object_table_init(g_ps_object.data);
 
+#if PS_OBJ_CACHE_ENTRIES
+    ps_obj_cache_flush();
+#endif
+
 #ifdef PS_ENCRYPTION
     g_obj_tbl_info.tag = g_ps_object.header.crypto.ref.tag;
 #endif
 
+#if PS_PACKED_OBJECT_MAX_SIZE
+    if (err == PSA_SUCCESS) {
+        err = ps_pack_prepare();
+    }
+#endif
+
     return err;
 }
 
@@ -177,6 +841,23 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
                             size_t *p_data_length)
 {
     psa_status_t err;
+#if PS_OBJ_CACHE_ENTRIES
+    struct ps_obj_cache_entry_t *entry;
+#ifdef PS_ENCRYPTION
+    uint32_t read_size;
+#endif
+#endif
+#if PS_PACKED_OBJECT_MAX_SIZE
+    uint32_t pack_idx;
+
+    err = ps_pack_find(uid, client_id, &pack_idx);
+    if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        if (err == PSA_SUCCESS) {
+            err = ps_pack_read(pack_idx, offset, size, p_data_length);
+        }
+        return err;
+    }
+#endif
 
     /* Retrieve the object information from the object table if the object
      * exists.
@@ -186,12 +867,46 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
         return err;
     }
 
+#if PS_OBJ_CACHE_ENTRIES
+    entry = ps_obj_cache_find(uid, client_id);
+    if (entry != NULL) {
+        /* Boundary check the incoming request */
+        if (offset > entry->info.current_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        size = PS_UTILS_MIN(size, entry->info.current_size - offset);
+
+        /* Copy the cached object data to the output buffer */
+        ps_req_mngr_write_asset_data(entry->data + offset, size);
+
+        *p_data_length = size;
+
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Read object */
 #ifdef PS_ENCRYPTION
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+#if PS_OBJ_CACHE_ENTRIES
+    /* Decrypt from the start of the object, and at least the number of bytes
+     * that can be cached, so that small objects are decrypted entirely.
+     */
+    read_size = PS_UTILS_MIN(offset, PS_MAX_OBJECT_DATA_SIZE) +
+                PS_UTILS_MIN(size, PS_MAX_OBJECT_DATA_SIZE);
+    if (read_size < PS_OBJ_CACHE_MAX_SIZE) {
+        read_size = PS_OBJ_CACHE_MAX_SIZE;
+    }
+
+    err = ps_encrypted_object_read_range(g_obj_tbl_info.fid, &g_ps_object,
+                                         0, read_size);
+#else
+    err = ps_encrypted_object_read_range(g_obj_tbl_info.fid, &g_ps_object,
+                                         offset, size);
+#endif
 #else
     /* Read object header */
     err = ps_read_object(READ_ALL_OBJECT);
@@ -200,6 +915,10 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
         goto clear_data_and_return;
     }
 
+#if PS_OBJ_CACHE_ENTRIES
+    ps_obj_cache_insert(uid, client_id, &g_ps_object);
+#endif
+
     /* Boundary check the incoming request */
     if (offset > g_ps_object.header.info.current_size) {
        err = PSA_ERROR_INVALID_ARGUMENT;
@@ -233,23 +952,50 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
 #ifndef PS_ENCRYPTION
     uint32_t wrt_size;
 #endif
+#if PS_PACKED_OBJECT_MAX_SIZE
+    uint32_t pack_idx;
+#endif
 
     /* Boundary check the incoming request */
     if (size > PS_MAX_ASSET_SIZE) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#if PS_PACKED_OBJECT_MAX_SIZE
+    err = ps_pack_find(uid, client_id, &pack_idx);
+    if (err == PSA_SUCCESS) {
+        if (ps_pack.dir.entry[pack_idx].info.create_flags
+            & PSA_STORAGE_FLAG_WRITE_ONCE) {
+            return PSA_ERROR_NOT_PERMITTED;
+        }
+    } else if (err == PSA_ERROR_DOES_NOT_EXIST) {
+        pack_idx = PS_PACK_NO_ENTRY;
+    } else {
+        return err;
+    }
+
+    /* Small objects are packed, unless the container is full */
+    if (ps_pack_fits(pack_idx, size)) {
+        return ps_pack_create(pack_idx, uid, client_id, create_flags, size);
+    }
+#endif
+
     /* Retrieve the object information from the object table if the object
      * exists.
      */
     err = ps_object_table_get_obj_tbl_info(uid, client_id, &g_obj_tbl_info);
     if (err == PSA_SUCCESS) {
+#if PS_OBJ_CACHE_ENTRIES
+        ps_obj_cache_invalidate(uid, client_id);
+#endif
+
 #ifdef PS_ENCRYPTION
         /* Read the object */
         g_ps_object.header.crypto.ref.uid = uid;
         g_ps_object.header.crypto.ref.client_id = client_id;
 
-        err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+        err = ps_encrypted_object_read_range(g_obj_tbl_info.fid,
+                                             &g_ps_object, 0, 0);
 #else
         /* Read the object header */
         err = ps_read_object(READ_HEADER_ONLY);
@@ -322,7 +1068,7 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
         /* Remove new object as object table is not persistent and propagate
          * object table manipulation error.
          */
-        (void)psa_its_remove(g_obj_tbl_info.fid);
+        (void)ps_its_remove(g_obj_tbl_info.fid);
 
         goto clear_data_and_return;
     }
@@ -339,6 +1085,17 @@ clear_data_and_return:
     /* Remove data stored in the object before leaving the function */
     (void)memset(&g_ps_object, PS_DEFAULT_EMPTY_BUFF_VAL, PS_MAX_OBJECT_SIZE);
 
+#if PS_PACKED_OBJECT_MAX_SIZE
+    /* The object is too big for the container now. It is only removed from
+     * the container once its file is stored, as the packed object is kept
+     * over the file if both exist.
+     */
+    if (err == PSA_SUCCESS && pack_idx != PS_PACK_NO_ENTRY) {
+        ps_pack_remove_entry(pack_idx);
+        err = ps_pack_commit(PSA_SUCCESS);
+    }
+#endif
+
     return err;
 }
 
@@ -351,6 +1108,17 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
 #ifndef PS_ENCRYPTION
     uint32_t wrt_size;
 #endif
+#if PS_PACKED_OBJECT_MAX_SIZE
+    uint32_t pack_idx;
+
+    err = ps_pack_find(uid, client_id, &pack_idx);
+    if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        if (err == PSA_SUCCESS) {
+            err = ps_pack_write(pack_idx, offset, size);
+        }
+        return err;
+    }
+#endif
 
     /* Retrieve the object information from the object table if the object
      * exists.
@@ -360,12 +1128,17 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
         return err;
     }
 
+#if PS_OBJ_CACHE_ENTRIES
+    ps_obj_cache_invalidate(uid, client_id);
+#endif
+
     /* Read the object */
 #ifdef PS_ENCRYPTION
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_read_range(g_obj_tbl_info.fid, &g_ps_object,
+                                         offset, size);
 #else
     err = ps_read_object(READ_ALL_OBJECT);
 #endif
@@ -418,7 +1191,8 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_write(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_write_range(g_obj_tbl_info.fid, &g_ps_object,
+                                          offset, size);
 #else
     wrt_size = PS_OBJECT_SIZE(g_ps_object.header.info.current_size);
 
@@ -437,7 +1211,7 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
         /* Remove new object as object table is not persistent and propagate
          * object table manipulation error.
          */
-        (void)psa_its_remove(g_obj_tbl_info.fid);
+        (void)ps_its_remove(g_obj_tbl_info.fid);
 
         goto clear_data_and_return;
     }
@@ -457,6 +1231,22 @@ psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
                                 struct psa_storage_info_t *info)
 {
     psa_status_t err;
+#if PS_OBJ_CACHE_ENTRIES
+    struct ps_obj_cache_entry_t *entry;
+#endif
+#if PS_PACKED_OBJECT_MAX_SIZE
+    uint32_t pack_idx;
+
+    err = ps_pack_find(uid, client_id, &pack_idx);
+    if (err == PSA_SUCCESS) {
+        info->size = ps_pack.dir.entry[pack_idx].info.current_size;
+        info->flags = ps_pack.dir.entry[pack_idx].info.create_flags;
+
+        return PSA_SUCCESS;
+    } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+#endif
 
     /* Retrieve the object information from the object table if the object
      * exists.
@@ -466,11 +1256,22 @@ psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
         return err;
     }
 
+#if PS_OBJ_CACHE_ENTRIES
+    entry = ps_obj_cache_find(uid, client_id);
+    if (entry != NULL) {
+        info->size = entry->info.current_size;
+        info->flags = entry->info.create_flags;
+
+        return PSA_SUCCESS;
+    }
+#endif
+
 #ifdef PS_ENCRYPTION
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_read_range(g_obj_tbl_info.fid, &g_ps_object,
+                                         0, 0);
 #else
     err = ps_read_object(READ_HEADER_ONLY);
 #endif
@@ -493,6 +1294,24 @@ clear_data_and_return:
 psa_status_t ps_object_delete(psa_storage_uid_t uid, int32_t client_id)
 {
     psa_status_t err;
+#if PS_PACKED_OBJECT_MAX_SIZE
+    uint32_t pack_idx;
+
+    err = ps_pack_find(uid, client_id, &pack_idx);
+    if (err == PSA_SUCCESS) {
+        /* Check that the write once flag is not set */
+        if (ps_pack.dir.entry[pack_idx].info.create_flags
+            & PSA_STORAGE_FLAG_WRITE_ONCE) {
+            return PSA_ERROR_NOT_PERMITTED;
+        }
+
+        ps_pack_remove_entry(pack_idx);
+
+        return ps_pack_commit(PSA_SUCCESS);
+    } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+#endif
 
     /* Retrieve the object information from the object table if the object
      * exists.
@@ -502,11 +1321,16 @@ psa_status_t ps_object_delete(psa_storage_uid_t uid, int32_t client_id)
         return err;
     }
 
+#if PS_OBJ_CACHE_ENTRIES
+    ps_obj_cache_invalidate(uid, client_id);
+#endif
+
 #ifdef PS_ENCRYPTION
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_read_range(g_obj_tbl_info.fid, &g_ps_object,
+                                         0, 0);
 #else
     err = ps_read_object(READ_HEADER_ONLY);
 #endif
@@ -548,5 +1372,20 @@ psa_status_t ps_system_wipe_all(void)
      * this function doesn't block on the lock and directly
      * moves to erasing the flash instead.
      */
+#if PS_OBJ_CACHE_ENTRIES
+    ps_obj_cache_flush();
+#endif
+
+#if PS_PACKED_OBJECT_MAX_SIZE
+    /* The container object is removed with the object table */
+    (void)memset(&ps_pack, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(ps_pack));
+    ps_pack_loaded = true;
+#endif
+
     return ps_object_table_create();
 }
+
+psa_status_t ps_system_close_epoch(void)
+{
+    return ps_object_table_close_epoch();
+}
@@ -99,6 +99,13 @@ psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
  */
 psa_status_t ps_system_wipe_all(void);
 
+/**
+ * \brief Closes the rollback protection epoch of the object table.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_system_close_epoch(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,14 +7,16 @@
 
 #include "ps_object_table.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
+#include "array.h"
 #include "cmsis_compiler.h"
 #include "config_tfm.h"
 #include "crypto/ps_crypto_interface.h"
 #include "nv_counters/ps_nv_counters.h"
-#include "psa/internal_trusted_storage.h"
+#include "ps_filesystem_interface.h"
 #include "ps_utils.h"
 #include "tfm_ps_defs.h"
 
@@ -28,6 +30,12 @@
  */
 #define PS_OBJECT_SYSTEM_VERSION  0x01
 
+#if PS_ROLLBACK_PROTECTION && (PS_ROLLBACK_EPOCH_SAVES > 1)
+#define PS_ROLLBACK_EPOCH 1
+#else
+#define PS_ROLLBACK_EPOCH 0
+#endif
+
 /*!
  * \struct ps_obj_table_info_t
  *
@@ -67,6 +75,12 @@ struct ps_obj_table_t {
                                   */
 #endif /* PS_ROLLBACK_PROTECTION */
 
+#if PS_ROLLBACK_EPOCH
+  uint32_t epoch_save;           /*!< Number of saves of the table since PS
+                                  *   NV counter 1 was last incremented
+                                  */
+#endif
+
   struct ps_obj_table_entry_t obj_db[PS_OBJ_TABLE_ENTRIES]; /*!< Table's
                                                              *   entries
                                                              */
@@ -124,6 +138,56 @@ static uint8_t ps_table_key_label[] = "table_key_label";
 #define PS_OBJECT_FS_ID_TO_IDX(fid) ((fid - 1) - \
                                       PS_TABLE_FS_ID(PS_OBJ_TABLE_IDX_1))
 
+#if PS_OBJ_TABLE_INDEX
+/* Number of slots of the object table index. It is twice the number of table
+ * entries to keep the probe sequences short.
+ */
+#define PS_OBJ_INDEX_SLOTS  (2 * PS_OBJ_TABLE_ENTRIES)
+
+/* Value of an empty slot of the object table index */
+#define PS_OBJ_INDEX_EMPTY  0xFFFFU
+
+/* Number of words of the bitmap of the free table entries */
+#define PS_OBJ_FREE_MAP_WORDS  ((PS_OBJ_TABLE_ENTRIES + 31) / 32)
+#endif /* PS_OBJ_TABLE_INDEX */
+
+#if defined(PS_ENCRYPTION) && (PS_OBJ_TABLE_SEGMENT_ENTRIES > 0)
+#define PS_OBJ_TABLE_SEG_AUTH 1
+#else
+#define PS_OBJ_TABLE_SEG_AUTH 0
+#endif
+
+#if PS_OBJ_TABLE_SEG_AUTH
+/* Number of segments of table entries digested separately */
+#define PS_OBJ_TABLE_SEGMENTS  ((PS_OBJ_TABLE_ENTRIES + \
+                                 PS_OBJ_TABLE_SEGMENT_ENTRIES - 1) / \
+                                PS_OBJ_TABLE_SEGMENT_ENTRIES)
+
+/* Number of words of the bitmap of the segments to digest again */
+#define PS_OBJ_SEG_DIRTY_WORDS  ((PS_OBJ_TABLE_SEGMENTS + 31) / 32)
+
+/* Size of the table header placed between the crypto data and the entries */
+#define PS_OBJ_TABLE_HEADER_SIZE  (offsetof(struct ps_obj_table_t, obj_db) - \
+                                   sizeof(union ps_crypto_t))
+
+/*!
+ * \struct ps_obj_table_seg_auth_t
+ *
+ * \brief Associated data of the table tag when the table entries are digested
+ *        by segments.
+ */
+struct ps_obj_table_seg_auth_t {
+    uint8_t header[PS_OBJ_TABLE_HEADER_SIZE]; /*!< Table header */
+    uint8_t digest[PS_OBJ_TABLE_SEGMENTS][PS_DIGEST_LEN_BYTES]; /*!< Digests
+                                                                 *   of the
+                                                                 *   segments
+                                                                 */
+#if PS_ROLLBACK_PROTECTION
+    uint32_t nv_counter;                      /*!< PS NV counter 1 value */
+#endif
+};
+#endif /* PS_OBJ_TABLE_SEG_AUTH */
+
 /*!
  * \struct ps_obj_table_ctx_t
  *
@@ -133,6 +197,34 @@ struct ps_obj_table_ctx_t {
     struct ps_obj_table_t obj_table;  /*!< Object tables */
     uint8_t active_table;             /*!< Active object table */
     uint8_t scratch_table;            /*!< Scratch object table */
+#if PS_OBJ_TABLE_INDEX
+    uint16_t index[PS_OBJ_INDEX_SLOTS]; /*!< Hash index of the used table
+                                         *   entries, keyed by UID and client
+                                         *   ID, with linear probing
+                                         */
+    uint32_t free_map[PS_OBJ_FREE_MAP_WORDS]; /*!< Bitmap of the free table
+                                               *   entries
+                                               */
+    uint32_t free_count;              /*!< Number of free table entries */
+#endif
+#if PS_OBJ_TABLE_SEG_AUTH
+    struct ps_obj_table_seg_auth_t seg_auth; /*!< Associated data of the
+                                              *   table tag
+                                              */
+    uint32_t seg_dirty[PS_OBJ_SEG_DIRTY_WORDS]; /*!< Bitmap of the segments
+                                                 *   modified since their
+                                                 *   digest was computed
+                                                 */
+#endif
+#if PS_ROLLBACK_EPOCH
+    bool epoch_open;                  /*!< Indicates that a table has been
+                                       *   saved with the current value of PS
+                                       *   NV counter 1 since initialization
+                                       */
+    uint32_t epoch_nvc_1;             /*!< PS NV counter 1 value of the
+                                       *   current epoch
+                                       */
+#endif
 };
 
 /* Object table context */
@@ -154,7 +246,11 @@ static struct ps_obj_table_ctx_t ps_obj_table_ctx;
 #define PS_CRYPTO_ASSOCIATED_DATA(crypto) ((uint8_t *)crypto + \
                                             PS_NON_AUTH_OBJ_TABLE_SIZE)
 
-#if PS_ROLLBACK_PROTECTION
+#if PS_OBJ_TABLE_SEG_AUTH
+/* The associated data is the header and the digests of the table segments */
+#define PS_CRYPTO_ASSOCIATED_DATA_LEN  sizeof(struct ps_obj_table_seg_auth_t)
+
+#elif PS_ROLLBACK_PROTECTION
 #define PS_OBJ_TABLE_AUTH_DATA_SIZE (PS_OBJ_TABLE_SIZE - \
                                      PS_NON_AUTH_OBJ_TABLE_SIZE)
 
@@ -170,7 +266,7 @@ struct ps_crypto_assoc_data_t {
 /* The associated data is the header, minus the the tag data */
 #define PS_CRYPTO_ASSOCIATED_DATA_LEN (PS_OBJ_TABLE_SIZE - \
                                        PS_NON_AUTH_OBJ_TABLE_SIZE)
-#endif /* PS_ROLLBACK_PROTECTION */
+#endif /* PS_OBJ_TABLE_SEG_AUTH */
 
 /* The ps_object_table_init function uses the static memory allocated for
  * the object data manipulation, in ps_object_table.c (g_ps_object), to load a
@@ -230,21 +326,21 @@ __STATIC_INLINE void ps_object_table_fs_read_table(
 
     /* Read file with the table 0 data */
 
-    err = psa_its_get(PS_TABLE_FS_ID(PS_OBJ_TABLE_IDX_0),
-                      PS_OBJECT_TABLE_OBJECT_OFFSET,
-                      PS_OBJ_TABLE_SIZE,
-                      (void *)init_ctx->p_table[PS_OBJ_TABLE_IDX_0],
-                      &data_length);
+    err = ps_its_get(PS_TABLE_FS_ID(PS_OBJ_TABLE_IDX_0),
+                     PS_OBJECT_TABLE_OBJECT_OFFSET,
+                     PS_OBJ_TABLE_SIZE,
+                     (void *)init_ctx->p_table[PS_OBJ_TABLE_IDX_0],
+                     &data_length);
     if (err != PSA_SUCCESS) {
         init_ctx->table_state[PS_OBJ_TABLE_IDX_0] = PS_OBJ_TABLE_INVALID;
     }
 
     /* Read file with the table 1 data */
-    err = psa_its_get(PS_TABLE_FS_ID(PS_OBJ_TABLE_IDX_1),
-                      PS_OBJECT_TABLE_OBJECT_OFFSET,
-                      PS_OBJ_TABLE_SIZE,
-                      (void *)init_ctx->p_table[PS_OBJ_TABLE_IDX_1],
-                      &data_length);
+    err = ps_its_get(PS_TABLE_FS_ID(PS_OBJ_TABLE_IDX_1),
+                     PS_OBJECT_TABLE_OBJECT_OFFSET,
+                     PS_OBJ_TABLE_SIZE,
+                     (void *)init_ctx->p_table[PS_OBJ_TABLE_IDX_1],
+                     &data_length);
     if (err != PSA_SUCCESS) {
         init_ctx->table_state[PS_OBJ_TABLE_IDX_1] = PS_OBJ_TABLE_INVALID;
     }
@@ -267,10 +363,10 @@ __STATIC_INLINE psa_status_t ps_object_table_fs_write_table(
     uint8_t swap_table_idxs = ps_obj_table_ctx.scratch_table;
 
     /* Create file to store object table in the FS */
-    err = psa_its_set(obj_table_id,
-                      PS_OBJ_TABLE_SIZE,
-                      (const void *)obj_table,
-                      PSA_STORAGE_FLAG_NONE);
+    err = ps_its_set(obj_table_id,
+                     PS_OBJ_TABLE_SIZE,
+                     (const void *)obj_table,
+                     PSA_STORAGE_FLAG_NONE);
 
     if (err != PSA_SUCCESS) {
         return err;
@@ -283,47 +379,103 @@ __STATIC_INLINE psa_status_t ps_object_table_fs_write_table(
     return PSA_SUCCESS;
 }
 
-#ifdef PS_ENCRYPTION
-#if PS_ROLLBACK_PROTECTION
+#if PS_OBJ_TABLE_SEG_AUTH
 /**
- * \brief Aligns all PS non-volatile counters.
+ * \brief Marks the segment of a table entry to be digested again.
  *
- * \param[in] nvc_1  Value of PS non-volatile counter 1
+ * \param[in] idx  Index of the modified entry
+ */
+static void ps_table_seg_mark_dirty(uint32_t idx)
+{
+    uint32_t seg = idx / PS_OBJ_TABLE_SEGMENT_ENTRIES;
+
+    ps_obj_table_ctx.seg_dirty[seg / 32] |= (1UL << (seg % 32));
+}
+
+/**
+ * \brief Marks all the table segments to be digested again.
+ */
+static void ps_table_seg_mark_all_dirty(void)
+{
+    (void)memset(ps_obj_table_ctx.seg_dirty, 0xFF,
+                 sizeof(ps_obj_table_ctx.seg_dirty));
+}
+
+/**
+ * \brief Updates the associated data of the table tag: digests the modified
+ *        segments again and copies the table header.
+ *
+ * \param[in] obj_table  Pointer to the object table
  *
  * \return Returns error code as specified in \ref psa_status_t
  */
-static psa_status_t ps_object_table_align_nv_counters(uint32_t nvc_1)
+static psa_status_t ps_table_seg_auth_update(
+                                        const struct ps_obj_table_t *obj_table)
 {
     psa_status_t err;
-    uint32_t nvc_x_val = 0;
+    uint32_t seg;
+    uint32_t first;
+    uint32_t num;
 
-    /* Align PS NVC 2 with NVC 1 */
-    err = ps_read_nv_counter(TFM_PS_NV_COUNTER_2, &nvc_x_val);
-    if (err != PSA_SUCCESS) {
-        return PSA_ERROR_GENERIC_ERROR;
-    }
+    for (seg = 0; seg < PS_OBJ_TABLE_SEGMENTS; seg++) {
+        if ((ps_obj_table_ctx.seg_dirty[seg / 32] & (1UL << (seg % 32))) == 0) {
+            continue;
+        }
+
+        first = seg * PS_OBJ_TABLE_SEGMENT_ENTRIES;
+        num = PS_OBJ_TABLE_ENTRIES - first;
+        if (num > PS_OBJ_TABLE_SEGMENT_ENTRIES) {
+            num = PS_OBJ_TABLE_SEGMENT_ENTRIES;
+        }
 
-    for (; nvc_x_val < nvc_1; nvc_x_val++) {
-        err = ps_increment_nv_counter(TFM_PS_NV_COUNTER_2);
+        err = ps_crypto_hash((const uint8_t *)&obj_table->obj_db[first],
+                             num * PS_OBJECTS_TABLE_ENTRY_SIZE,
+                             ps_obj_table_ctx.seg_auth.digest[seg]);
         if (err != PSA_SUCCESS) {
             return err;
         }
+
+        ps_obj_table_ctx.seg_dirty[seg / 32] &= ~(1UL << (seg % 32));
     }
 
-    /* Align PS NVC 3 with NVC 1 */
-    err = ps_read_nv_counter(TFM_PS_NV_COUNTER_3, &nvc_x_val);
+    (void)memcpy(ps_obj_table_ctx.seg_auth.header,
+                 PS_CRYPTO_ASSOCIATED_DATA(&obj_table->crypto),
+                 PS_OBJ_TABLE_HEADER_SIZE);
+
+    return PSA_SUCCESS;
+}
+#endif /* PS_OBJ_TABLE_SEG_AUTH */
+
+#ifdef PS_ENCRYPTION
+#if PS_ROLLBACK_PROTECTION
+/**
+ * \brief Aligns all PS non-volatile counters.
+ *
+ * \param[in] nvc_1  Value of PS non-volatile counter 1
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_align_nv_counters(uint32_t nvc_1)
+{
+    /* Align PS NVC 2 and NVC 3 with NVC 1. NVC 2 is incremented before NVC 3
+     * as the counters are incremented in order.
+     */
+    const uint32_t counter_ids[] = {TFM_PS_NV_COUNTER_2, TFM_PS_NV_COUNTER_3};
+    uint32_t counts[ARRAY_SIZE(counter_ids)];
+    uint32_t i;
+    psa_status_t err;
+
+    err = ps_read_nv_counters(counter_ids, counts, ARRAY_SIZE(counter_ids));
     if (err != PSA_SUCCESS) {
         return PSA_ERROR_GENERIC_ERROR;
     }
 
-    for (; nvc_x_val < nvc_1; nvc_x_val++) {
-        err = ps_increment_nv_counter(TFM_PS_NV_COUNTER_3);
-        if (err != PSA_SUCCESS) {
-            return err;
-        }
+    for (i = 0; i < ARRAY_SIZE(counter_ids); i++) {
+        counts[i] = (counts[i] < nvc_1) ? (nvc_1 - counts[i]) : 0;
     }
 
-    return PSA_SUCCESS;
+    return ps_increment_nv_counters(counter_ids, counts,
+                                    ARRAY_SIZE(counter_ids));
 }
 
 /**
@@ -340,7 +492,12 @@ __STATIC_INLINE psa_status_t ps_object_table_nvc_generate_auth_tag(
                                               uint32_t nvc_1,
                                               struct ps_obj_table_t *obj_table)
 {
-    struct ps_crypto_assoc_data_t assoc_data;
+#if PS_OBJ_TABLE_SEG_AUTH
+    struct ps_obj_table_seg_auth_t *assoc_data = &ps_obj_table_ctx.seg_auth;
+#else
+    struct ps_crypto_assoc_data_t table_assoc_data;
+    struct ps_crypto_assoc_data_t *assoc_data = &table_assoc_data;
+#endif
     union ps_crypto_t *crypto = &obj_table->crypto;
     psa_status_t err;
 
@@ -350,12 +507,20 @@ __STATIC_INLINE psa_status_t ps_object_table_nvc_generate_auth_tag(
         return err;
     }
 
-    assoc_data.nv_counter = nvc_1;
-    (void)memcpy(assoc_data.obj_table_data,
+#if PS_OBJ_TABLE_SEG_AUTH
+    /* Only the segments modified since the last save are digested again */
+    err = ps_table_seg_auth_update(obj_table);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#else
+    (void)memcpy(assoc_data->obj_table_data,
                  PS_CRYPTO_ASSOCIATED_DATA(crypto),
                  PS_OBJ_TABLE_AUTH_DATA_SIZE);
+#endif
+    assoc_data->nv_counter = nvc_1;
 
-    return ps_crypto_generate_auth_tag(crypto, (const uint8_t *)&assoc_data,
+    return ps_crypto_generate_auth_tag(crypto, (const uint8_t *)assoc_data,
                                        PS_CRYPTO_ASSOCIATED_DATA_LEN);
 }
 
@@ -369,17 +534,33 @@ __STATIC_INLINE psa_status_t ps_object_table_nvc_generate_auth_tag(
 static void ps_object_table_authenticate(uint8_t table_idx,
                                        struct ps_obj_table_init_ctx_t *init_ctx)
 {
-    struct ps_crypto_assoc_data_t assoc_data;
+#if PS_OBJ_TABLE_SEG_AUTH
+    struct ps_obj_table_seg_auth_t *assoc_data = &ps_obj_table_ctx.seg_auth;
+#else
+    struct ps_crypto_assoc_data_t table_assoc_data;
+    struct ps_crypto_assoc_data_t *assoc_data = &table_assoc_data;
+#endif
     union ps_crypto_t *crypto = &init_ctx->p_table[table_idx]->crypto;
     psa_status_t err;
 
-    /* Init associated data with NVC 1 */
-    assoc_data.nv_counter = init_ctx->nvc_1;
-    (void)memcpy(assoc_data.obj_table_data,
+#if PS_OBJ_TABLE_SEG_AUTH
+    /* Digest all the segments of the table */
+    ps_table_seg_mark_all_dirty();
+    err = ps_table_seg_auth_update(init_ctx->p_table[table_idx]);
+    if (err != PSA_SUCCESS) {
+        init_ctx->table_state[table_idx] = PS_OBJ_TABLE_INVALID;
+        return;
+    }
+#else
+    (void)memcpy(assoc_data->obj_table_data,
                  PS_CRYPTO_ASSOCIATED_DATA(crypto),
                  PS_OBJ_TABLE_AUTH_DATA_SIZE);
+#endif
+
+    /* Init associated data with NVC 1 */
+    assoc_data->nv_counter = init_ctx->nvc_1;
 
-    err = ps_crypto_authenticate(crypto, (const uint8_t *)&assoc_data,
+    err = ps_crypto_authenticate(crypto, (const uint8_t *)assoc_data,
                                  PS_CRYPTO_ASSOCIATED_DATA_LEN);
     if (err == PSA_SUCCESS) {
         init_ctx->table_state[table_idx] = PS_OBJ_TABLE_NVC_1_VALID;
@@ -392,9 +573,9 @@ static void ps_object_table_authenticate(uint8_t table_idx,
     }
 
     /* Check with NVC 3 */
-    assoc_data.nv_counter = init_ctx->nvc_3;
+    assoc_data->nv_counter = init_ctx->nvc_3;
 
-    err = ps_crypto_authenticate(crypto, (const uint8_t *)&assoc_data,
+    err = ps_crypto_authenticate(crypto, (const uint8_t *)assoc_data,
                                  PS_CRYPTO_ASSOCIATED_DATA_LEN);
     if (err != PSA_SUCCESS) {
         init_ctx->table_state[table_idx] = PS_OBJ_TABLE_INVALID;
@@ -414,23 +595,19 @@ __attribute__ ((always_inline))
 __STATIC_INLINE psa_status_t ps_object_table_nvc_authenticate(
                                       struct ps_obj_table_init_ctx_t *init_ctx)
 {
+    const uint32_t counter_ids[] = {TFM_PS_NV_COUNTER_1, TFM_PS_NV_COUNTER_2,
+                                    TFM_PS_NV_COUNTER_3};
+    uint32_t nvc[ARRAY_SIZE(counter_ids)];
     psa_status_t err;
     uint32_t nvc_2;
 
-    err = ps_read_nv_counter(TFM_PS_NV_COUNTER_1, &init_ctx->nvc_1);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
-
-    err = ps_read_nv_counter(TFM_PS_NV_COUNTER_2, &nvc_2);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
-
-    err = ps_read_nv_counter(TFM_PS_NV_COUNTER_3, &init_ctx->nvc_3);
+    err = ps_read_nv_counters(counter_ids, nvc, ARRAY_SIZE(counter_ids));
     if (err != PSA_SUCCESS) {
         return err;
     }
+    init_ctx->nvc_1 = nvc[0];
+    nvc_2 = nvc[1];
+    init_ctx->nvc_3 = nvc[2];
 
     /* Check if NVC 3 value can be used to validate an object table */
     if (init_ctx->nvc_3 != nvc_2) {
@@ -478,9 +655,52 @@ __STATIC_INLINE psa_status_t ps_object_table_generate_auth_tag(
         return err;
     }
 
+#if PS_OBJ_TABLE_SEG_AUTH
+    /* Only the segments modified since the last save are digested again */
+    err = ps_table_seg_auth_update(obj_table);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return ps_crypto_generate_auth_tag(crypto,
+                                 (const uint8_t *)&ps_obj_table_ctx.seg_auth,
+                                 PS_CRYPTO_ASSOCIATED_DATA_LEN);
+#else
     return ps_crypto_generate_auth_tag(crypto,
                                        PS_CRYPTO_ASSOCIATED_DATA(crypto),
                                        PS_CRYPTO_ASSOCIATED_DATA_LEN);
+#endif
+}
+
+/**
+ * \brief Authenticates a table of objects.
+ *
+ * \param[in] obj_table  Pointer to the object table to authenticate
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_authenticate(
+                                        const struct ps_obj_table_t *obj_table)
+{
+    const union ps_crypto_t *crypto = &obj_table->crypto;
+#if PS_OBJ_TABLE_SEG_AUTH
+    psa_status_t err;
+
+    /* Digest all the segments of the table */
+    ps_table_seg_mark_all_dirty();
+    err = ps_table_seg_auth_update(obj_table);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return ps_crypto_authenticate(crypto,
+                                  (const uint8_t *)&ps_obj_table_ctx.seg_auth,
+                                  PS_CRYPTO_ASSOCIATED_DATA_LEN);
+#else
+    return ps_crypto_authenticate(crypto,
+                                  PS_CRYPTO_ASSOCIATED_DATA(crypto),
+                                  PS_CRYPTO_ASSOCIATED_DATA_LEN);
+#endif
 }
 
 /**
@@ -494,14 +714,11 @@ __STATIC_INLINE void ps_object_table_authenticate_ctx_tables(
                                       struct ps_obj_table_init_ctx_t *init_ctx)
 {
     psa_status_t err;
-    union ps_crypto_t *crypto =
-                                &init_ctx->p_table[PS_OBJ_TABLE_IDX_0]->crypto;
 
     /* Authenticate table 0 if data is valid */
     if (init_ctx->table_state[PS_OBJ_TABLE_IDX_0] != PS_OBJ_TABLE_INVALID) {
-        err = ps_crypto_authenticate(crypto,
-                                     PS_CRYPTO_ASSOCIATED_DATA(crypto),
-                                     PS_CRYPTO_ASSOCIATED_DATA_LEN);
+        err = ps_object_table_authenticate(
+                                         init_ctx->p_table[PS_OBJ_TABLE_IDX_0]);
         if (err != PSA_SUCCESS) {
             init_ctx->table_state[PS_OBJ_TABLE_IDX_0] = PS_OBJ_TABLE_INVALID;
         }
@@ -509,11 +726,8 @@ __STATIC_INLINE void ps_object_table_authenticate_ctx_tables(
 
     /* Authenticate table 1 if data is valid */
     if (init_ctx->table_state[PS_OBJ_TABLE_IDX_1] != PS_OBJ_TABLE_INVALID) {
-        crypto = &init_ctx->p_table[PS_OBJ_TABLE_IDX_1]->crypto;
-
-        err = ps_crypto_authenticate(crypto,
-                                     PS_CRYPTO_ASSOCIATED_DATA(crypto),
-                                     PS_CRYPTO_ASSOCIATED_DATA_LEN);
+        err = ps_object_table_authenticate(
+                                         init_ctx->p_table[PS_OBJ_TABLE_IDX_1]);
         if (err != PSA_SUCCESS) {
             init_ctx->table_state[PS_OBJ_TABLE_IDX_1] = PS_OBJ_TABLE_INVALID;
         }
@@ -536,15 +750,37 @@ static psa_status_t ps_object_table_save_table(
 
 #if PS_ROLLBACK_PROTECTION
     uint32_t nvc_1 = 0;
-
-    err = ps_increment_nv_counter(TFM_PS_NV_COUNTER_1);
-    if (err != PSA_SUCCESS) {
-        return err;
+    bool new_epoch = true;
+
+#if PS_ROLLBACK_EPOCH
+    /* Within an epoch, the saves are told apart by the authenticated save
+     * count of the table, and PS NV counter 1 keeps its value. A new epoch
+     * starts with the first save after initialization, so that the tables
+     * left in the persistent area by a previous boot can not be replayed
+     * any more once a table has been saved.
+     */
+    if (ps_obj_table_ctx.epoch_open &&
+        (obj_table->epoch_save < (PS_ROLLBACK_EPOCH_SAVES - 1))) {
+        new_epoch = false;
+        obj_table->epoch_save++;
+        nvc_1 = ps_obj_table_ctx.epoch_nvc_1;
+    } else {
+        /* The epoch stays closed until the save completes */
+        ps_obj_table_ctx.epoch_open = false;
+        obj_table->epoch_save = 0;
     }
+#endif /* PS_ROLLBACK_EPOCH */
 
-    err = ps_read_nv_counter(TFM_PS_NV_COUNTER_1, &nvc_1);
-    if (err != PSA_SUCCESS) {
-        return err;
+    if (new_epoch) {
+        err = ps_increment_nv_counter(TFM_PS_NV_COUNTER_1);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = ps_read_nv_counter(TFM_PS_NV_COUNTER_1, &nvc_1);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
     }
 #else
     obj_table->swap_count++;
@@ -595,10 +831,22 @@ static psa_status_t ps_object_table_save_table(
         return err;
     }
 
+    if (!new_epoch) {
+        /* The NV counters are already aligned for this epoch */
+        return PSA_SUCCESS;
+    }
+
     /* Align PS NV counters to have the same value */
     err = ps_object_table_align_nv_counters(nvc_1);
 #endif /* PS_ROLLBACK_PROTECTION */
 
+#if PS_ROLLBACK_EPOCH
+    if (err == PSA_SUCCESS) {
+        ps_obj_table_ctx.epoch_open = true;
+        ps_obj_table_ctx.epoch_nvc_1 = nvc_1;
+    }
+#endif
+
     return err;
 }
 
@@ -678,6 +926,22 @@ static psa_status_t ps_set_active_object_table(
     }
 
 #if PS_ROLLBACK_PROTECTION
+#if PS_ROLLBACK_EPOCH
+    if (init_ctx->table_state[PS_OBJ_TABLE_IDX_0] ==
+        init_ctx->table_state[PS_OBJ_TABLE_IDX_1]) {
+        /* Both tables were saved in the same epoch, the latest one has the
+         * highest save count.
+         */
+        if (init_ctx->p_table[PS_OBJ_TABLE_IDX_1]->epoch_save >
+            init_ctx->p_table[PS_OBJ_TABLE_IDX_0]->epoch_save) {
+            ps_obj_table_ctx.active_table  = PS_OBJ_TABLE_IDX_1;
+            ps_obj_table_ctx.scratch_table = PS_OBJ_TABLE_IDX_0;
+        } else {
+            ps_obj_table_ctx.active_table  = PS_OBJ_TABLE_IDX_0;
+            ps_obj_table_ctx.scratch_table = PS_OBJ_TABLE_IDX_1;
+        }
+    } else
+#endif /* PS_ROLLBACK_EPOCH */
     if (init_ctx->table_state[PS_OBJ_TABLE_IDX_1] ==
                                                     PS_OBJ_TABLE_NVC_1_VALID) {
         /* Table 0 is invalid, the active one is table 1 */
@@ -739,6 +1003,117 @@ static psa_status_t ps_set_active_object_table(
     return PSA_SUCCESS;
 }
 
+#if PS_OBJ_TABLE_INDEX
+/**
+ * \brief Gets the home slot of an object in the object table index.
+ *
+ * \param[in] uid        Object UID
+ * \param[in] client_id  Client UID
+ *
+ * \return Returns the slot where the probe sequence of the object starts
+ */
+static uint32_t ps_table_index_slot(psa_storage_uid_t uid, int32_t client_id)
+{
+    uint32_t hash;
+
+    hash = (uint32_t)uid ^ (uint32_t)(uid >> 32) ^ (uint32_t)client_id;
+    hash *= 0x9E3779B1U;
+
+    return (hash ^ (hash >> 16)) % PS_OBJ_INDEX_SLOTS;
+}
+
+/**
+ * \brief Adds a used table entry to the object table index.
+ *
+ * \param[in] idx  Entry index to add
+ */
+static void ps_table_index_insert(uint32_t idx)
+{
+    struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+    uint32_t slot = ps_table_index_slot(p_table->obj_db[idx].uid,
+                                        p_table->obj_db[idx].client_id);
+
+    while (ps_obj_table_ctx.index[slot] != PS_OBJ_INDEX_EMPTY) {
+        slot = (slot + 1) % PS_OBJ_INDEX_SLOTS;
+    }
+    ps_obj_table_ctx.index[slot] = (uint16_t)idx;
+
+    ps_obj_table_ctx.free_map[idx / 32] &= ~(1UL << (idx % 32));
+    ps_obj_table_ctx.free_count--;
+}
+
+/**
+ * \brief Removes a used table entry from the object table index, before the
+ *        entry is cleared.
+ *
+ * \param[in] idx  Entry index to remove
+ */
+static void ps_table_index_remove(uint32_t idx)
+{
+    struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+    struct ps_obj_table_entry_t *entry;
+    uint32_t slot;
+    uint32_t next;
+    uint32_t home;
+
+    entry = &p_table->obj_db[idx];
+    slot = ps_table_index_slot(entry->uid, entry->client_id);
+    while (ps_obj_table_ctx.index[slot] != idx) {
+        if (ps_obj_table_ctx.index[slot] == PS_OBJ_INDEX_EMPTY) {
+            return;
+        }
+        slot = (slot + 1) % PS_OBJ_INDEX_SLOTS;
+    }
+
+    /* Shift back the following slots of the probe sequence which can not be
+     * found any more once this slot is emptied.
+     */
+    next = slot;
+    for (;;) {
+        next = (next + 1) % PS_OBJ_INDEX_SLOTS;
+        if (ps_obj_table_ctx.index[next] == PS_OBJ_INDEX_EMPTY) {
+            break;
+        }
+
+        entry = &p_table->obj_db[ps_obj_table_ctx.index[next]];
+        home = ps_table_index_slot(entry->uid, entry->client_id);
+        if (((next - home + PS_OBJ_INDEX_SLOTS) % PS_OBJ_INDEX_SLOTS) >=
+            ((next - slot + PS_OBJ_INDEX_SLOTS) % PS_OBJ_INDEX_SLOTS)) {
+            ps_obj_table_ctx.index[slot] = ps_obj_table_ctx.index[next];
+            slot = next;
+        }
+    }
+    ps_obj_table_ctx.index[slot] = PS_OBJ_INDEX_EMPTY;
+
+    ps_obj_table_ctx.free_map[idx / 32] |= (1UL << (idx % 32));
+    ps_obj_table_ctx.free_count++;
+}
+
+/**
+ * \brief Builds the object table index from the table entries.
+ */
+static void ps_table_index_build(void)
+{
+    uint32_t i;
+
+    (void)memset(ps_obj_table_ctx.index, 0xFF, sizeof(ps_obj_table_ctx.index));
+    (void)memset(ps_obj_table_ctx.free_map, 0,
+                 sizeof(ps_obj_table_ctx.free_map));
+    ps_obj_table_ctx.free_count = 0;
+
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        ps_obj_table_ctx.free_map[i / 32] |= (1UL << (i % 32));
+        ps_obj_table_ctx.free_count++;
+    }
+
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        if (ps_obj_table_ctx.obj_table.obj_db[i].uid != TFM_PS_INVALID_UID) {
+            ps_table_index_insert(i);
+        }
+    }
+}
+#endif /* PS_OBJ_TABLE_INDEX */
+
 /**
  * \brief Gets table's entry index based on the given object UID and client ID.
  *
@@ -756,6 +1131,19 @@ static psa_status_t ps_get_object_entry_idx(psa_storage_uid_t uid,
     uint32_t i;
     struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
 
+#if PS_OBJ_TABLE_INDEX
+    uint32_t slot = ps_table_index_slot(uid, client_id);
+
+    while (ps_obj_table_ctx.index[slot] != PS_OBJ_INDEX_EMPTY) {
+        i = ps_obj_table_ctx.index[slot];
+        if (p_table->obj_db[i].uid == uid
+            && p_table->obj_db[i].client_id == client_id) {
+            *idx = i;
+            return PSA_SUCCESS;
+        }
+        slot = (slot + 1) % PS_OBJ_INDEX_SLOTS;
+    }
+#else
     for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
         if (p_table->obj_db[i].uid == uid
             && p_table->obj_db[i].client_id == client_id) {
@@ -763,6 +1151,7 @@ static psa_status_t ps_get_object_entry_idx(psa_storage_uid_t uid,
             return PSA_SUCCESS;
         }
     }
+#endif
 
     return PSA_ERROR_DOES_NOT_EXIST;
 }
@@ -787,18 +1176,39 @@ __STATIC_INLINE psa_status_t ps_table_free_idx(uint32_t idx_num,
 {
     uint32_t i;
     uint32_t last_free = 0;
+#if PS_OBJ_TABLE_INDEX
+    uint32_t word;
+#else
     struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+#endif
 
     if (idx_num == 0) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#if PS_OBJ_TABLE_INDEX
+    if (ps_obj_table_ctx.free_count < idx_num) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES && idx_num > 0; i++) {
+        word = ps_obj_table_ctx.free_map[i / 32];
+        if (word == 0U) {
+            /* Skip the entries of a word without free entries */
+            i |= 31U;
+        } else if (word & (1UL << (i % 32))) {
+            last_free = i;
+            idx_num--;
+        }
+    }
+#else
     for (i = 0; i < PS_OBJ_TABLE_ENTRIES && idx_num > 0; i++) {
         if (p_table->obj_db[i].uid == TFM_PS_INVALID_UID) {
             last_free = i;
             idx_num--;
         }
     }
+#endif
 
     if (idx_num != 0) {
         return PSA_ERROR_INSUFFICIENT_STORAGE;
@@ -816,6 +1226,13 @@ __STATIC_INLINE psa_status_t ps_table_free_idx(uint32_t idx_num,
  */
 static void ps_table_delete_entry(uint32_t idx)
 {
+#if PS_OBJ_TABLE_INDEX
+    ps_table_index_remove(idx);
+#endif
+#if PS_OBJ_TABLE_SEG_AUTH
+    ps_table_seg_mark_dirty(idx);
+#endif
+
     /* Initialise object table entry structure */
     (void)memset(&ps_obj_table_ctx.obj_table.obj_db[idx],
                  PS_DEFAULT_EMPTY_BUFF_VAL, PS_OBJECTS_TABLE_ENTRY_SIZE);
@@ -837,6 +1254,18 @@ psa_status_t ps_object_table_create(void)
 
     p_table->version = PS_OBJECT_SYSTEM_VERSION;
 
+#if PS_ROLLBACK_EPOCH
+    /* The new table starts a new epoch */
+    ps_obj_table_ctx.epoch_open = false;
+#endif
+
+#if PS_OBJ_TABLE_INDEX
+    ps_table_index_build();
+#endif
+#if PS_OBJ_TABLE_SEG_AUTH
+    ps_table_seg_mark_all_dirty();
+#endif
+
     /* Save object table contents */
     return ps_object_table_save_table(p_table);
 }
@@ -897,7 +1326,7 @@ psa_status_t ps_object_table_init(uint8_t *obj_data)
     }
 
     /* Remove the old object table file */
-    err = psa_its_remove(PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table));
+    err = ps_its_remove(PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table));
     if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
         return err;
     }
@@ -914,6 +1343,14 @@ psa_status_t ps_object_table_init(uint8_t *obj_data)
     ps_crypto_set_iv(&ps_obj_table_ctx.obj_table.crypto);
 #endif
 
+#if PS_OBJ_TABLE_INDEX
+    ps_table_index_build();
+#endif
+#if PS_OBJ_TABLE_SEG_AUTH
+    /* The digests left by the authentication may belong to the other table */
+    ps_table_seg_mark_all_dirty();
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -946,7 +1383,7 @@ psa_status_t ps_object_table_get_free_fid(uint32_t fid_num,
      * That can happen when the system is rebooted (e.g. power cut, ...) in the
      * middle of a create, write or delete operation.
      */
-    err = psa_its_remove(fid);
+    err = ps_its_remove(fid);
     if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
         return err;
     }
@@ -989,6 +1426,12 @@ psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
     idx = PS_OBJECT_FS_ID_TO_IDX(obj_tbl_info->fid);
     p_table->obj_db[idx].uid = uid;
     p_table->obj_db[idx].client_id = client_id;
+#if PS_OBJ_TABLE_INDEX
+    ps_table_index_insert(idx);
+#endif
+#if PS_OBJ_TABLE_SEG_AUTH
+    ps_table_seg_mark_dirty(idx);
+#endif
 
     /* Add new object information */
 #ifdef PS_ENCRYPTION
@@ -1004,6 +1447,12 @@ psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
             /* Rollback the change in the table */
             (void)memcpy(&p_table->obj_db[backup_idx], &backup_entry,
                          PS_OBJECTS_TABLE_ENTRY_SIZE);
+#if PS_OBJ_TABLE_INDEX
+            ps_table_index_insert(backup_idx);
+#endif
+#if PS_OBJ_TABLE_SEG_AUTH
+            ps_table_seg_mark_dirty(backup_idx);
+#endif
         }
 
         ps_table_delete_entry(idx);
@@ -1068,6 +1517,12 @@ psa_status_t ps_object_table_delete_object(psa_storage_uid_t uid,
        /* Rollback the change in the table */
        (void)memcpy(&p_table->obj_db[backup_idx], &backup_entry,
                     PS_OBJECTS_TABLE_ENTRY_SIZE);
+#if PS_OBJ_TABLE_INDEX
+       ps_table_index_insert(backup_idx);
+#endif
+#if PS_OBJ_TABLE_SEG_AUTH
+       ps_table_seg_mark_dirty(backup_idx);
+#endif
     }
 
     return err;
@@ -1077,5 +1532,31 @@ psa_status_t ps_object_table_delete_old_table(void)
 {
     uint32_t table_id = PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table);
 
-    return psa_its_remove(table_id);
+    return ps_its_remove(table_id);
+}
+
+psa_status_t ps_object_table_close_epoch(void)
+{
+#if PS_ROLLBACK_EPOCH
+    psa_status_t err;
+
+    /* A table saved first in its epoch is the only one which authenticates
+     * with the current PS NV counter 1 value, so there is nothing to replay.
+     */
+    if (ps_obj_table_ctx.obj_table.epoch_save == 0) {
+        return PSA_SUCCESS;
+    }
+
+    /* Save the table again in a new epoch */
+    ps_obj_table_ctx.epoch_open = false;
+
+    err = ps_object_table_save_table(&ps_obj_table_ctx.obj_table);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return ps_object_table_delete_old_table();
+#else
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif /* PS_ROLLBACK_EPOCH */
 }
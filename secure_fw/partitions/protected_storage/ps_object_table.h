@@ -130,6 +130,19 @@ psa_status_t ps_object_table_delete_object(psa_storage_uid_t uid,
  */
 psa_status_t ps_object_table_delete_old_table(void);
 
+/**
+ * \brief Closes the rollback protection epoch of the object table, so that
+ *        none of the tables saved in the epoch can be replayed. The table is
+ *        saved again with a new PS NV counter 1 value, unless it is the first
+ *        table saved in the epoch.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ *
+ * \retval PSA_ERROR_NOT_SUPPORTED  If the table is saved with a new PS NV
+ *                                  counter 1 value every time
+ */
+psa_status_t ps_object_table_close_epoch(void);
+
 #ifdef __cplusplus
 }
 #endif
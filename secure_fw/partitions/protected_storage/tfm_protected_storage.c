@@ -149,3 +149,8 @@ uint32_t tfm_ps_get_support(void)
 
     return 0;
 }
+
+psa_status_t tfm_ps_close_rollback_epoch(void)
+{
+    return ps_system_close_epoch();
+}
@@ -173,6 +173,25 @@ psa_status_t tfm_ps_remove(int32_t client_id, psa_storage_uid_t uid);
  */
 uint32_t tfm_ps_get_support(void);
 
+/**
+ * \brief Closes the current rollback protection epoch, so that the object
+ *        tables saved since PS NV counter 1 was last incremented can no
+ *        longer be replayed.
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ *
+ * \retval PSA_SUCCESS                    The operation completed successfully
+ * \retval PSA_ERROR_NOT_SUPPORTED        The service is not built with
+ *                                        PS_ROLLBACK_EPOCH_SAVES
+ * \retval PSA_ERROR_STORAGE_FAILURE      The operation failed because the
+ *                                        physical storage has failed (fatal
+ *                                        error)
+ * \retval PSA_ERROR_GENERIC_ERROR        The operation failed because of an
+ *                                        unspecified internal failure
+ */
+psa_status_t tfm_ps_close_rollback_epoch(void);
+
 #ifdef __cplusplus
 }
 #endif
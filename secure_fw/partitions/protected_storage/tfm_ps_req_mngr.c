@@ -151,6 +151,8 @@ psa_status_t tfm_protected_storage_service_sfn(const psa_msg_t *msg)
         return tfm_ps_remove_req(msg);
     case TFM_PS_GET_SUPPORT:
         return tfm_ps_get_support_req(msg);
+    case TFM_PS_CLOSE_EPOCH:
+        return tfm_ps_close_rollback_epoch();
     default:
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Multiplexes the timers of the Secure Partitions on one secure hardware timer.
+ * The timers are kept in a timing wheel, and the alarm of the hardware timer
+ * is set when the wheel has to advance next. A Secure Partition is notified
+ * with its PSA_DOORBELL signal when one of its timers expires.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config_tfm.h"
+#include "config_spm.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_secure_timer.h"
+#include "tfm_hal_timer.h"
+#include "tfm_secure_timer_api.h"
+#include "tfm_sp_log.h"
+#include "timer_wheel.h"
+#if CONFIG_TFM_IDLE_LOW_POWER == 1
+#include "tfm_idle.h"
+#endif
+
+#if CONFIG_TFM_DOORBELL_API != 1
+#error "The Secure Timer partition needs CONFIG_TFM_DOORBELL_API"
+#endif
+
+#define TIMER_FREE              0
+#define TIMER_RUNNING           1
+#define TIMER_EXPIRED           2
+
+struct secure_timer_t {
+    struct timer_wheel_node_t node;         /* First for the expiry callback */
+    int32_t client_id;
+    uint32_t timer_id;
+    uint32_t state;
+};
+
+static struct secure_timer_t timers[SECURE_TIMER_NUM];
+static struct timer_wheel_t wheel;
+
+/*
+ * The hardware counter and the time of the wheel it was last read at. The time
+ * of the wheel extends the counter, its low 32 bits are the counter.
+ */
+static uint32_t last_ticks;
+static uint64_t last_time;
+
+static struct secure_timer_t *timer_find(int32_t client_id, uint32_t timer_id)
+{
+    uint32_t i;
+
+    for (i = 0; i < SECURE_TIMER_NUM; i++) {
+        if ((timers[i].state != TIMER_FREE) &&
+            (timers[i].client_id == client_id) &&
+            (timers[i].timer_id == timer_id)) {
+            return &timers[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct secure_timer_t *timer_alloc(int32_t client_id, uint32_t timer_id)
+{
+    uint32_t i;
+
+    for (i = 0; i < SECURE_TIMER_NUM; i++) {
+        if (timers[i].state == TIMER_FREE) {
+            timers[i].client_id = client_id;
+            timers[i].timer_id = timer_id;
+            return &timers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Extends the 32-bit hardware counter to the 64-bit time of the wheel. */
+static uint64_t timer_now(void)
+{
+    uint32_t ticks = tfm_hal_timer_get_ticks();
+
+    last_time += (uint32_t)(ticks - last_ticks);
+    last_ticks = ticks;
+
+    return last_time;
+}
+
+static void timer_expire(struct timer_wheel_node_t *node)
+{
+    struct secure_timer_t *timer = (struct secure_timer_t *)node;
+
+    timer->state = TIMER_EXPIRED;
+    psa_notify(timer->client_id);
+}
+
+/*
+ * Expires the timers which are due and sets the alarm for the next ones. The
+ * alarm is set at most 2^31 ticks ahead, so that the counter is read before it
+ * wraps around.
+ */
+static void timer_update(void)
+{
+    uint64_t next, now;
+
+    while (1) {
+        now = timer_now();
+        timer_wheel_advance(&wheel, now, timer_expire);
+
+        if (!timer_wheel_next(&wheel, &next)) {
+            next = now + TIMER_WHEEL_MAX_TICKS;
+        } else if (next - now > TIMER_WHEEL_MAX_TICKS) {
+            next = now + TIMER_WHEEL_MAX_TICKS;
+        }
+
+        tfm_hal_timer_set_alarm((uint32_t)next);
+
+        /* The alarm may be set too late if the counter passed it meanwhile */
+        if (timer_now() < next) {
+            break;
+        }
+    }
+
+#if CONFIG_TFM_IDLE_LOW_POWER == 1
+    if (timer_wheel_next(&wheel, &next)) {
+        tfm_idle_set_wakeup(TFM_IDLE_WAKEUP_SRC_PARTITION, (uint32_t)next);
+    } else {
+        tfm_idle_clear_wakeup(TFM_IDLE_WAKEUP_SRC_PARTITION);
+    }
+#endif
+}
+
+static psa_status_t timer_start(const psa_msg_t *msg)
+{
+    struct secure_timer_t *timer;
+    uint32_t timer_id, ticks;
+
+    if ((msg->in_size[0] != sizeof(timer_id)) ||
+        (msg->in_size[1] != sizeof(ticks))) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+    (void)psa_read(msg->handle, 0, &timer_id, sizeof(timer_id));
+    (void)psa_read(msg->handle, 1, &ticks, sizeof(ticks));
+
+    if ((timer_id >= TFM_SECURE_TIMER_ID_NUM) || (ticks == 0) ||
+        (ticks > TIMER_WHEEL_MAX_TICKS)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    timer = timer_find(msg->client_id, timer_id);
+    if (timer != NULL) {
+        timer_wheel_remove(&wheel, &timer->node);
+    } else {
+        timer = timer_alloc(msg->client_id, timer_id);
+        if (timer == NULL) {
+            return PSA_ERROR_INSUFFICIENT_MEMORY;
+        }
+    }
+
+    /* Bring the wheel to the current time, so that the timeout starts now */
+    timer_wheel_advance(&wheel, timer_now(), timer_expire);
+    timer_wheel_insert(&wheel, &timer->node, ticks);
+    timer->state = TIMER_RUNNING;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t timer_cancel(const psa_msg_t *msg)
+{
+    struct secure_timer_t *timer;
+    uint32_t timer_id;
+
+    if (msg->in_size[0] != sizeof(timer_id)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+    (void)psa_read(msg->handle, 0, &timer_id, sizeof(timer_id));
+
+    if (timer_id >= TFM_SECURE_TIMER_ID_NUM) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    timer = timer_find(msg->client_id, timer_id);
+    if ((timer != NULL) && (timer->state == TIMER_RUNNING)) {
+        timer_wheel_remove(&wheel, &timer->node);
+        timer->state = TIMER_FREE;
+    }
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t timer_get_expired(const psa_msg_t *msg)
+{
+    uint32_t expired = 0;
+    uint32_t i;
+
+    if (msg->out_size[0] != sizeof(expired)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < SECURE_TIMER_NUM; i++) {
+        if ((timers[i].state == TIMER_EXPIRED) &&
+            (timers[i].client_id == msg->client_id)) {
+            expired |= 1UL << timers[i].timer_id;
+            timers[i].state = TIMER_FREE;
+        }
+    }
+
+    psa_write(msg->handle, 0, &expired, sizeof(expired));
+
+    return PSA_SUCCESS;
+}
+
+void secure_timer_sp_entry(void)
+{
+    psa_signal_t signals;
+    psa_status_t status;
+    psa_msg_t msg;
+
+    if (tfm_hal_timer_init() != TFM_HAL_SUCCESS) {
+        LOG_ERRFMT("[Secure Timer] Timer initialisation failed\r\n");
+        psa_panic();
+    }
+
+    last_ticks = tfm_hal_timer_get_ticks();
+    last_time = last_ticks;
+    timer_wheel_init(&wheel, last_time);
+    psa_irq_enable(SECURE_TIMER_SIGNAL);
+
+    while (1) {
+        signals = psa_wait(TFM_SECURE_TIMER_SERVICE_SIGNAL | SECURE_TIMER_SIGNAL,
+                           PSA_BLOCK);
+
+        if (signals & SECURE_TIMER_SIGNAL) {
+            tfm_hal_timer_clear_alarm();
+            psa_eoi(SECURE_TIMER_SIGNAL);
+        }
+
+        if ((signals & TFM_SECURE_TIMER_SERVICE_SIGNAL) &&
+            (psa_get(TFM_SECURE_TIMER_SERVICE_SIGNAL, &msg) == PSA_SUCCESS)) {
+            switch (msg.type) {
+            case TFM_SECURE_TIMER_API_ID_START:
+                status = timer_start(&msg);
+                break;
+            case TFM_SECURE_TIMER_API_ID_CANCEL:
+                status = timer_cancel(&msg);
+                break;
+            case TFM_SECURE_TIMER_API_ID_GET_EXPIRED:
+                status = timer_get_expired(&msg);
+                break;
+            default:
+                status = PSA_ERROR_NOT_SUPPORTED;
+                break;
+            }
+
+            psa_reply(msg.handle, status);
+        }
+
+        timer_update();
+    }
+}
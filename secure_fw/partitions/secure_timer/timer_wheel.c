@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "timer_wheel.h"
+
+#define SLOT_MASK               (TIMER_WHEEL_SLOTS - 1)
+#define LEVEL_SHIFT(level)      ((level) * TIMER_WHEEL_LEVEL_BITS)
+
+/* Rotates a bitmap of slots right, so that the slot 'n' becomes bit 0 */
+static uint32_t slots_rotate_right(uint32_t bits, uint32_t n)
+{
+    n &= SLOT_MASK;
+    bits = (bits >> n) | (bits << (TIMER_WHEEL_SLOTS - n));
+
+    return bits & ((1u << TIMER_WHEEL_SLOTS) - 1);
+}
+
+static uint32_t slots_first(uint32_t bits)
+{
+    uint32_t n = 0;
+
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        n++;
+    }
+
+    return n;
+}
+
+/*
+ * Puts a timer in the lowest level where its slot is less than a turn ahead of
+ * the wheel. It is never the current slot of the level, as the expiry is later
+ * than the time of the wheel and the timer would be in a lower level otherwise.
+ */
+static void wheel_put(struct timer_wheel_t *wheel,
+                      struct timer_wheel_node_t *node)
+{
+    struct timer_wheel_node_t **head;
+    uint32_t level, slot;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+        if (((node->expiry >> LEVEL_SHIFT(level)) -
+             (wheel->now >> LEVEL_SHIFT(level))) < TIMER_WHEEL_SLOTS) {
+            break;
+        }
+    }
+
+    slot = (uint32_t)(node->expiry >> LEVEL_SHIFT(level)) & SLOT_MASK;
+    head = &wheel->slots[level][slot];
+
+    node->next = *head;
+    if (*head != NULL) {
+        (*head)->pprev = &node->next;
+    }
+    *head = node;
+    node->pprev = head;
+
+    wheel->occupied[level] |= 1u << slot;
+}
+
+void timer_wheel_init(struct timer_wheel_t *wheel, uint64_t now)
+{
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now = now;
+}
+
+void timer_wheel_insert(struct timer_wheel_t *wheel,
+                        struct timer_wheel_node_t *node, uint32_t ticks)
+{
+    if (ticks == 0) {
+        ticks = 1;
+    } else if (ticks > TIMER_WHEEL_MAX_TICKS) {
+        ticks = TIMER_WHEEL_MAX_TICKS;
+    }
+
+    node->expiry = wheel->now + ticks;
+    wheel_put(wheel, node);
+}
+
+void timer_wheel_remove(struct timer_wheel_t *wheel,
+                        struct timer_wheel_node_t *node)
+{
+    struct timer_wheel_node_t **first = &wheel->slots[0][0];
+    uintptr_t idx;
+
+    if (node->pprev == NULL) {
+        return;
+    }
+
+    *node->pprev = node->next;
+    if (node->next != NULL) {
+        node->next->pprev = node->pprev;
+    }
+
+    /* The timer was the last one of its slot */
+    if ((node->pprev >= first) &&
+        (node->pprev < first + (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)) &&
+        (*node->pprev == NULL)) {
+        idx = (uintptr_t)(node->pprev - first);
+        wheel->occupied[idx / TIMER_WHEEL_SLOTS] &=
+                                        ~(1u << (idx % TIMER_WHEEL_SLOTS));
+    }
+
+    node->next = NULL;
+    node->pprev = NULL;
+}
+
+void timer_wheel_advance(struct timer_wheel_t *wheel, uint64_t now,
+                         timer_wheel_expire_fn expire)
+{
+    struct timer_wheel_node_t *due = NULL, *node, *next;
+    uint64_t from, to;
+    uint32_t level, slot, passed;
+
+    if (now <= wheel->now) {
+        return;
+    }
+
+    /*
+     * Take out the timers of the slots the wheel passes on each level. The
+     * higher levels move slower, and stop moving at the first one which stays
+     * on its slot.
+     */
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        from = wheel->now >> LEVEL_SHIFT(level);
+        to = now >> LEVEL_SHIFT(level);
+        if (from == to) {
+            break;
+        }
+
+        if (to - from >= TIMER_WHEEL_SLOTS) {
+            passed = wheel->occupied[level];
+        } else {
+            passed = (1u << (uint32_t)(to - from)) - 1;
+            passed = slots_rotate_right(passed,
+                                        TIMER_WHEEL_SLOTS - (uint32_t)(from + 1));
+            passed &= wheel->occupied[level];
+        }
+        wheel->occupied[level] &= ~passed;
+
+        for (slot = 0; passed != 0; slot++, passed >>= 1) {
+            if (!(passed & 1u)) {
+                continue;
+            }
+
+            for (node = wheel->slots[level][slot]; node != NULL; node = next) {
+                next = node->next;
+                node->next = due;
+                node->pprev = NULL;
+                due = node;
+            }
+            wheel->slots[level][slot] = NULL;
+        }
+    }
+
+    wheel->now = now;
+
+    /* Expire the timers which are due and move the others down */
+    for (node = due; node != NULL; node = next) {
+        next = node->next;
+        node->next = NULL;
+
+        if (node->expiry <= now) {
+            expire(node);
+        } else {
+            wheel_put(wheel, node);
+        }
+    }
+}
+
+bool timer_wheel_next(const struct timer_wheel_t *wheel, uint64_t *next)
+{
+    uint64_t from, at;
+    uint32_t level, ahead;
+    bool found = false;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (wheel->occupied[level] == 0) {
+            continue;
+        }
+
+        /* The first used slot after the current one of the level */
+        from = wheel->now >> LEVEL_SHIFT(level);
+        ahead = slots_first(slots_rotate_right(wheel->occupied[level],
+                                               (uint32_t)(from + 1)));
+        at = (from + 1 + ahead) << LEVEL_SHIFT(level);
+
+        if (!found || (at < *next)) {
+            *next = at;
+            found = true;
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Hierarchical timing wheel. Level n has TIMER_WHEEL_SLOTS slots of
+ * TIMER_WHEEL_SLOTS^n ticks, so the levels cover 32 bits of ticks. A timer is
+ * put in the lowest level where its slot is less than a turn ahead, and moves
+ * down a level when the wheel reaches its slot. Inserting and removing a timer
+ * take a constant time, and a timer moves down TIMER_WHEEL_LEVELS - 1 times at
+ * most before it expires.
+ */
+#define TIMER_WHEEL_LEVEL_BITS      4
+#define TIMER_WHEEL_SLOTS           (1u << TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_LEVELS          (32 / TIMER_WHEEL_LEVEL_BITS)
+
+/* The longest timeout, so that the expiries can be compared across a wrap */
+#define TIMER_WHEEL_MAX_TICKS       (0x7FFFFFFFu)
+
+struct timer_wheel_node_t {
+    struct timer_wheel_node_t *next;
+    struct timer_wheel_node_t **pprev;     /* NULL when not in the wheel */
+    uint64_t expiry;
+};
+
+struct timer_wheel_t {
+    uint64_t now;                           /* Ticks the wheel is at */
+    uint16_t occupied[TIMER_WHEEL_LEVELS];  /* Bitmap of the used slots */
+    struct timer_wheel_node_t *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+};
+
+/**
+ * \brief Called for each timer which expires when the wheel advances. The timer
+ *        is out of the wheel and can be inserted again.
+ */
+typedef void (*timer_wheel_expire_fn)(struct timer_wheel_node_t *node);
+
+/**
+ * \brief Initializes an empty wheel.
+ *
+ * \param[out] wheel      The wheel.
+ * \param[in]  now        The current time in ticks.
+ */
+void timer_wheel_init(struct timer_wheel_t *wheel, uint64_t now);
+
+/**
+ * \brief Inserts a timer to expire after a number of ticks, one at least.
+ *
+ * \param[in,out] wheel   The wheel.
+ * \param[in,out] node    The timer, which is not in the wheel.
+ * \param[in]     ticks   The timeout, TIMER_WHEEL_MAX_TICKS at most.
+ */
+void timer_wheel_insert(struct timer_wheel_t *wheel,
+                        struct timer_wheel_node_t *node, uint32_t ticks);
+
+/**
+ * \brief Removes a timer from the wheel if it is in it.
+ *
+ * \param[in,out] wheel   The wheel.
+ * \param[in,out] node    The timer.
+ */
+void timer_wheel_remove(struct timer_wheel_t *wheel,
+                        struct timer_wheel_node_t *node);
+
+/**
+ * \brief Advances the wheel and expires the timers which are due.
+ *
+ * \param[in,out] wheel   The wheel.
+ * \param[in]     now     The current time in ticks, not before the time of the
+ *                        wheel.
+ * \param[in]     expire  Called for each expired timer.
+ */
+void timer_wheel_advance(struct timer_wheel_t *wheel, uint64_t now,
+                         timer_wheel_expire_fn expire);
+
+/**
+ * \brief Gets when the wheel has to advance next, which is the expiry of the
+ *        next timer, or the start of the slot it is in when it has to move
+ *        down a level first.
+ *
+ * \param[in]  wheel      The wheel.
+ * \param[out] next       The time in ticks.
+ *
+ * \retval true           There is a timer in the wheel.
+ * \retval false          The wheel is empty.
+ */
+bool timer_wheel_next(const struct timer_wheel_t *wheel, uint64_t *next);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMER_WHEEL_H__ */
@@ -7,24 +7,70 @@
 
 #include "crt_impl_private.h"
 
+/*
+ * Compose a destination word from two adjacent aligned source words, when the
+ * source is 'shift' bits ahead of the word boundary.
+ */
+#ifdef __ARM_BIG_ENDIAN
+#define MERGE_WORDS(prev, next, shift) \
+                    (((prev) << (shift)) | ((next) >> (32 - (shift))))
+#else
+#define MERGE_WORDS(prev, next, shift) \
+                    (((prev) >> (shift)) | ((next) << (32 - (shift))))
+#endif
+
 void *memcpy(void *dest, const void *src, size_t n)
 {
     union composite_addr_t p_dst, p_src;
+    uint32_t offset, shift, prev, next;
 
     p_dst.uint_addr = (uintptr_t)dest;
     p_src.uint_addr = (uintptr_t)src;
 
-    /* Byte copy for unaligned address. check the last bit of address. */
-    while (n && (ADDR_WORD_UNALIGNED(p_dst.uint_addr) ||
-                 ADDR_WORD_UNALIGNED(p_src.uint_addr))) {
+    /* Byte copy until the destination address is word aligned. */
+    while (n && ADDR_WORD_UNALIGNED(p_dst.uint_addr)) {
         *p_dst.p_byte++ = *p_src.p_byte++;
         n--;
     }
 
-    /* Quad byte copy for aligned address. */
-    while (n >= sizeof(uint32_t)) {
-        *(p_dst.p_word)++ = *(p_src.p_word)++;
-        n -= sizeof(uint32_t);
+    if (!ADDR_WORD_UNALIGNED(p_src.uint_addr)) {
+        /* Burst copy for aligned address. */
+        while (n >= BYTES_PER_BURST) {
+            p_dst.p_word[0] = p_src.p_word[0];
+            p_dst.p_word[1] = p_src.p_word[1];
+            p_dst.p_word[2] = p_src.p_word[2];
+            p_dst.p_word[3] = p_src.p_word[3];
+            p_dst.p_word += WORDS_PER_BURST;
+            p_src.p_word += WORDS_PER_BURST;
+            n -= BYTES_PER_BURST;
+        }
+
+        /* Quad byte copy for the remaining words. */
+        while (n >= sizeof(uint32_t)) {
+            *(p_dst.p_word)++ = *(p_src.p_word)++;
+            n -= sizeof(uint32_t);
+        }
+    } else if (n >= sizeof(uint32_t)) {
+        /*
+         * Source is not aligned the same way as destination. Read aligned
+         * words from source and merge adjacent ones, so that neither side
+         * falls back to byte copy. An aligned word read never crosses a
+         * memory region boundary, even if it covers bytes beyond the source.
+         */
+        offset = ADDR_WORD_UNALIGNED(p_src.uint_addr);
+        shift = offset * 8;
+        p_src.uint_addr -= offset;
+        prev = *(p_src.p_word)++;
+
+        while (n >= sizeof(uint32_t)) {
+            next = *(p_src.p_word)++;
+            *(p_dst.p_word)++ = MERGE_WORDS(prev, next, shift);
+            prev = next;
+            n -= sizeof(uint32_t);
+        }
+
+        /* Point back to the first source byte not copied yet. */
+        p_src.uint_addr = p_src.uint_addr - sizeof(uint32_t) + offset;
     }
 
     /* Byte copy for the remaining bytes. */
@@ -21,6 +21,15 @@ void *memset(void *s, int c, size_t n)
         n--;
     }
 
+    while (n >= BYTES_PER_BURST) {
+        p_mem.p_word[0] = pattern_word;
+        p_mem.p_word[1] = pattern_word;
+        p_mem.p_word[2] = pattern_word;
+        p_mem.p_word[3] = pattern_word;
+        p_mem.p_word += WORDS_PER_BURST;
+        n -= BYTES_PER_BURST;
+    }
+
     while (n >= sizeof(uint32_t)) {
         *p_mem.p_word++ = pattern_word;
         n -= sizeof(uint32_t);
@@ -27,6 +27,10 @@
 #error "Unsupported ARM Architecture."
 #endif
 
+#if (CONFIG_TFM_SPM_RAM_CODE == 1) && !defined(S_RAM_CODE_START)
+#error "CONFIG_TFM_SPM_RAM_CODE requires S_RAM_CODE_START in region_defs.h"
+#endif
+
 /* Delcaraction flag to control the scheduling logic in PendSV. */
 uint32_t scheduler_lock = SCHEDULER_UNLOCKED;
 
@@ -96,7 +100,7 @@ void tfm_arch_thread_fn_call(uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1*/
 
 #if CONFIG_TFM_SPM_BACKEND_IPC == 1
-__attribute__((naked)) void PendSV_Handler(void)
+__attribute__((naked)) SPM_RAM_CODE void PendSV_Handler(void)
 {
     __ASM volatile(
         SYNTAX_UNIFIED
@@ -147,7 +151,7 @@ __attribute__((naked)) void PendSV_Handler(void)
 }
 #endif
 
-__attribute__((naked)) void SVC_Handler(void)
+__attribute__((naked)) SPM_RAM_CODE void SVC_Handler(void)
 {
     __ASM volatile(
     SYNTAX_UNIFIED
@@ -14,6 +14,7 @@
 #include "config_spm.h"
 #include "critical_section.h"
 #include "compiler_ext_defs.h"
+#include "cycle_counter.h"
 #include "ffm/psa_api.h"
 #include "fih.h"
 #include "runtime_defs.h"
@@ -22,6 +23,7 @@
 #include "tfm_hal_isolation.h"
 #include "tfm_hal_platform.h"
 #include "tfm_nspm.h"
+#include "tfm_spm_trace.h"
 #include "ffm/backend.h"
 #include "utilities.h"
 #include "private/assert.h"
@@ -57,6 +59,140 @@ struct context_ctrl_t *p_spm_thread_context = &spm_thread_context;
 static bool basepri_set_by_ipc_schedule;
 #endif
 
+extern void common_sfn_thread(void *param);
+
+#if CONFIG_TFM_SPM_SHARED_STACKS == 1
+/* States of a partition on a stack shared with other partitions */
+#define STACK_NOT_STARTED   0   /* Entry not run yet                        */
+#define STACK_HOLDING       1   /* Handling messages on the stack           */
+#define STACK_IDLE          2   /* Waiting for messages, frames intact      */
+#define STACK_CLOBBERED     3   /* Waiting for messages, frames overwritten */
+
+extern void common_sfn_thread_resume(void *param);
+
+/*
+ * Let a partition take its shared stack if it has something to do and no
+ * other partition holds the stack. A partition whose frames are gone starts
+ * its thread again at the top of the stack.
+ *
+ * Returns THRD_STATE_BLOCK if the partition has to wait for the stack,
+ * THRD_STATE_RUNNABLE if its thread has been started again, otherwise
+ * THRD_STATE_INVALID to let the signals decide.
+ */
+static uint32_t shared_stack_acquire(struct partition_t *p_pt)
+{
+    struct partition_t *p_iter;
+    uintptr_t stack_addr = LOAD_ALLOCED_STACK_ADDR(p_pt->p_ldinf);
+    thrd_fn_t thrd_entry;
+
+    if ((p_pt->stack_state != STACK_NOT_STARTED) &&
+        ((p_pt->signals_waiting & p_pt->signals_asserted) == 0)) {
+        return THRD_STATE_INVALID;
+    }
+
+    for (p_iter = p_pt->p_stack_next; p_iter != p_pt;
+         p_iter = p_iter->p_stack_next) {
+        if (p_iter->stack_state == STACK_HOLDING) {
+            return THRD_STATE_BLOCK;
+        }
+    }
+
+    for (p_iter = p_pt->p_stack_next; p_iter != p_pt;
+         p_iter = p_iter->p_stack_next) {
+        if (p_iter->stack_state == STACK_IDLE) {
+            p_iter->stack_state = STACK_CLOBBERED;
+        }
+    }
+
+    if (p_pt->stack_state == STACK_IDLE) {
+        p_pt->stack_state = STACK_HOLDING;
+        return THRD_STATE_INVALID;
+    }
+
+    if (p_pt->stack_state == STACK_NOT_STARTED) {
+        thrd_entry = (thrd_fn_t)common_sfn_thread;
+    } else {
+        thrd_entry = (thrd_fn_t)common_sfn_thread_resume;
+    }
+
+    /*
+     * The thread leaving the stack saves its registers below its own frames,
+     * which lie below the initial context built here at the top of the stack.
+     */
+    ARCH_CTXCTRL_INIT(&p_pt->ctx_ctrl, stack_addr,
+                      p_pt->thrd_sp_base - stack_addr);
+    tfm_arch_init_context(&p_pt->ctx_ctrl, (uintptr_t)thrd_entry, NULL,
+                          (uintptr_t)THRD_GENERAL_EXIT);
+
+    /* The loop calls psa_wait() again and gets the asserted signals at once */
+    p_pt->signals_waiting = 0;
+    p_pt->stack_state = STACK_HOLDING;
+
+    return THRD_STATE_RUNNABLE;
+}
+
+/* The partition waits for messages, the other sharers may take the stack. */
+static void shared_stack_release(struct partition_t *p_pt)
+{
+    struct partition_t *p_iter;
+
+    p_pt->stack_state = STACK_IDLE;
+
+    for (p_iter = p_pt->p_stack_next; p_iter != p_pt;
+         p_iter = p_iter->p_stack_next) {
+        thrd_mark_ready(&p_iter->thrd);
+    }
+}
+
+/*
+ * Link the partition with the ones initialized before on the same stack.
+ * Their runtime metadata stays on top of the stack, so the metadata of the
+ * partition goes below. Returns false for the first partition of the stack.
+ */
+static bool shared_stack_join(struct partition_t *p_pt)
+{
+    struct partition_t *p_iter;
+    uintptr_t stack_addr = LOAD_ALLOCED_STACK_ADDR(p_pt->p_ldinf);
+
+    p_pt->p_stack_next = p_pt;
+    p_pt->stack_state = STACK_NOT_STARTED;
+
+    UNI_LIST_FOREACH(p_iter, PARTITION_LIST_ADDR, next) {
+        if ((p_iter != p_pt) && (p_iter->p_metadata != NULL) &&
+            IS_SHARED_STACK(p_iter->p_ldinf) &&
+            (LOAD_ALLOCED_STACK_ADDR(p_iter->p_ldinf) == stack_addr)) {
+            break;
+        }
+    }
+
+    if (p_iter == NULL) {
+        return false;
+    }
+
+    p_pt->p_stack_next = p_iter->p_stack_next;
+    p_iter->p_stack_next = p_pt;
+
+    ARCH_CTXCTRL_INIT(&p_pt->ctx_ctrl, stack_addr,
+                      p_iter->thrd_sp_base - stack_addr);
+
+    return true;
+}
+
+/*
+ * All the partitions run their threads below the metadata of all of them,
+ * the contexts built at init are built again when they take the stack.
+ */
+static void shared_stack_set_base(struct partition_t *p_pt, uintptr_t sp_base)
+{
+    struct partition_t *p_iter = p_pt;
+
+    do {
+        p_iter->thrd_sp_base = sp_base;
+        p_iter = p_iter->p_stack_next;
+    } while (p_iter != p_pt);
+}
+#endif /* CONFIG_TFM_SPM_SHARED_STACKS == 1 */
+
 /*
  * Query the state of current thread.
  */
@@ -73,6 +209,17 @@ static uint32_t query_state(struct thread_t *p_thrd, uint32_t *p_retval)
 
     CRITICAL_SECTION_ENTER(cs_signal);
 
+#if CONFIG_TFM_SPM_SHARED_STACKS == 1
+    if (IS_SHARED_STACK(p_pt->p_ldinf) &&
+        (p_pt->stack_state != STACK_HOLDING)) {
+        state = shared_stack_acquire(p_pt);
+        if (state != THRD_STATE_INVALID) {
+            CRITICAL_SECTION_LEAVE(cs_signal);
+            return state;
+        }
+    }
+#endif
+
     retval_signals = p_pt->signals_waiting & p_pt->signals_asserted;
 
     if (retval_signals) {
@@ -159,6 +306,7 @@ static void prv_process_metadata(struct partition_t *p_pt)
 
     p_rt_meta->entry = p_pt_ldi->entry;
     p_rt_meta->n_sfn = 0;
+    p_rt_meta->deferred_init = IS_DEFERRED_INIT(p_pt_ldi);
     p_sfn_table = p_rt_meta->sfn_table;
 
     if (!IS_IPC_MODEL(p_pt_ldi)) {
@@ -173,11 +321,155 @@ static void prv_process_metadata(struct partition_t *p_pt)
     p_pt->p_metadata = p_rt_meta;
 }
 
+#if CONFIG_TFM_PRIORITY_INHERITANCE == 1
+/*
+ * Let the partition thread run at the highest priority among its own one and
+ * the ones of the clients whose messages are still queued to the partition.
+ */
+static void update_inherited_priority(struct partition_t *p_pt)
+{
+    struct bi_list_node_t *p_node;
+    struct connection_t *p_conn;
+    uint8_t priority = (uint8_t)TO_THREAD_PRIORITY(
+                                    PARTITION_PRIORITY(p_pt->p_ldinf->flags));
+
+    BI_LIST_FOR_EACH(p_node, &p_pt->msg_list) {
+        p_conn = GET_LIST_CONNECTION(p_node);
+        if (p_conn->p_client->thrd.priority < priority) {
+            priority = p_conn->p_client->thrd.priority;
+        }
+    }
+
+    thrd_set_priority(&p_pt->thrd, priority);
+}
+#endif
+
+#if CONFIG_TFM_PARTITION_STATS == 1
+static void update_service_stats(struct spm_service_stats_t *p_stats,
+                                 uint32_t cycles)
+{
+    p_stats->total_cycles += cycles;
+    if (cycles > p_stats->max_cycles) {
+        p_stats->max_cycles = cycles;
+    }
+}
+
+#if CONFIG_TFM_PARTITION_PMU == 1
+/* PMU event counts at the last partition switch */
+static uint32_t pmu_switch_events[SPM_PMU_EVENT_NUM];
+#endif
+
+/* Account the running and blocked time of the partitions being switched. */
+static void update_switch_stats(struct partition_t *p_prev,
+                                struct partition_t *p_next)
+{
+    uint32_t now = SPM_GET_CYCLES();
+#if CONFIG_TFM_PARTITION_PMU == 1
+    uint32_t i, events;
+
+    for (i = 0; i < SPM_PMU_EVENT_NUM; i++) {
+        events = SPM_PMU_GET_EVENT(i);
+        p_prev->stats.pmu_events[i] += events - pmu_switch_events[i];
+        pmu_switch_events[i] = events;
+    }
+#endif
+
+    p_prev->stats.run_cycles += now - p_prev->stats.switch_cycles;
+    p_prev->stats.blocked = (p_prev->signals_waiting != 0);
+    p_prev->stats.switch_cycles = now;
+
+    if (p_next->stats.blocked) {
+        p_next->stats.blocked_cycles += now - p_next->stats.switch_cycles;
+        p_next->stats.blocked = false;
+    }
+    p_next->stats.switch_cycles = now;
+    p_next->stats.switches++;
+
+#if CONFIG_TFM_CALL_LATENCY == 1
+    if (p_next->lat_service) {
+        spm_record_call_latency(p_next->lat_service, SPM_CALL_PHASE_RETURN,
+                                now - p_next->lat_reply_cycles);
+        p_next->lat_service = NULL;
+    }
+#endif
+}
+
+psa_status_t spm_get_partition_stats(int32_t partition_id,
+                                     struct spm_partition_stats_t *p_stats)
+{
+    struct critical_section_t cs_stats = CRITICAL_SECTION_STATIC_INIT;
+    struct partition_t *p_pt = tfm_spm_get_partition_by_id(partition_id);
+
+    if (!p_pt) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_stats);
+    *p_stats = p_pt->stats;
+    CRITICAL_SECTION_LEAVE(cs_stats);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t spm_get_service_stats(uint32_t sid,
+                                   struct spm_service_stats_t *p_stats)
+{
+    struct critical_section_t cs_stats = CRITICAL_SECTION_STATIC_INIT;
+    const struct service_t *p_service = tfm_spm_get_service_by_sid(sid);
+
+    if (!p_service) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_stats);
+    *p_stats = p_service->stats;
+    CRITICAL_SECTION_LEAVE(cs_stats);
+
+    return PSA_SUCCESS;
+}
+#endif /* CONFIG_TFM_PARTITION_STATS == 1 */
+
+#if CONFIG_TFM_CALL_LATENCY == 1
+#define CALL_LATENCY_SAMPLE_MASK ((1UL << CONFIG_TFM_CALL_LATENCY_SAMPLE_SHIFT) - 1)
+
+void spm_record_call_latency(const struct service_t *p_service,
+                             uint32_t phase, uint32_t cycles)
+{
+    uint32_t bucket = 0;
+
+    /* The service latencies are only updated by the SPM, like the stats. */
+    cycles >>= SPM_CALL_LATENCY_BUCKET_SHIFT;
+    while ((cycles != 0) && (bucket < SPM_CALL_LATENCY_BUCKET_NUM - 1)) {
+        cycles >>= 1;
+        bucket++;
+    }
+
+    ((struct service_t *)p_service)->latency.buckets[phase][bucket]++;
+}
+
+psa_status_t spm_get_call_latency(uint32_t sid,
+                                  struct spm_call_latency_t *p_latency)
+{
+    struct critical_section_t cs_stats = CRITICAL_SECTION_STATIC_INIT;
+    const struct service_t *p_service = tfm_spm_get_service_by_sid(sid);
+
+    if (!p_service) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_stats);
+    *p_latency = p_service->latency;
+    CRITICAL_SECTION_LEAVE(cs_stats);
+
+    return PSA_SUCCESS;
+}
+#endif /* CONFIG_TFM_CALL_LATENCY == 1 */
+
 /*
  * Send message and wake up the SP who is waiting on message queue, block the
  * current thread and trigger scheduler.
  */
-psa_status_t backend_messaging(struct connection_t *p_connection)
+SPM_RAM_CODE psa_status_t backend_messaging(struct connection_t *p_connection)
 {
     struct partition_t *p_owner = NULL;
     psa_signal_t signal = 0;
@@ -192,7 +484,31 @@ psa_status_t backend_messaging(struct connection_t *p_connection)
     p_owner = p_connection->service->partition;
     signal = p_connection->service->p_ldinf->signal;
 
-    UNI_LIST_INSERT_AFTER(p_owner, p_connection, p_handles);
+    BI_LIST_INSERT_BEFORE(&p_owner->msg_list, &p_connection->msg_node);
+
+#if CONFIG_TFM_PARTITION_STATS == 1
+    p_connection->msg_cycles = SPM_GET_CYCLES();
+    p_owner->stats.msgs.calls++;
+    /* The statistics are the only part of a service updated at runtime. */
+    ((struct service_t *)p_connection->service)->stats.calls++;
+#endif
+
+#if CONFIG_TFM_CALL_LATENCY == 1
+    /* The client API took the cycle count at the SPM entry of the call. */
+    p_connection->lat_sampled = (p_connection->msg.type >= PSA_IPC_CALL) &&
+        (((p_connection->service->stats.calls - 1) &
+          CALL_LATENCY_SAMPLE_MASK) == 0);
+    if (p_connection->lat_sampled) {
+        spm_record_call_latency(p_connection->service, SPM_CALL_PHASE_VALIDATE,
+                                p_connection->msg_cycles -
+                                p_connection->lat_cycles);
+    }
+#endif
+
+#if CONFIG_TFM_PRIORITY_INHERITANCE == 1
+    /* Before asserting the signal, as it decides on scheduling by priority. */
+    update_inherited_priority(p_owner);
+#endif
 
     /* Messages put. Update signals */
     ret = backend_assert_signal(p_owner, signal);
@@ -215,20 +531,70 @@ psa_status_t backend_messaging(struct connection_t *p_connection)
     return ret;
 }
 
-psa_status_t backend_replying(struct connection_t *handle, int32_t status)
+SPM_RAM_CODE psa_status_t backend_replying(struct connection_t *handle, int32_t status)
 {
     struct partition_t *client = handle->p_client;
 
+#if CONFIG_TFM_PARTITION_STATS == 1
+    if (handle->service && handle->service->partition) {
+        uint32_t cycles = SPM_GET_CYCLES() - handle->msg_cycles;
+
+        update_service_stats(&handle->service->partition->stats.msgs, cycles);
+        update_service_stats(
+                    &((struct service_t *)handle->service)->stats, cycles);
+
+#if CONFIG_TFM_SERVICE_LATENCY_BUDGET == 1
+        if (handle->service->latency_budget &&
+            (cycles > handle->service->latency_budget)) {
+            handle->service->partition->stats.msgs.overruns++;
+            ((struct service_t *)handle->service)->stats.overruns++;
+            SPM_TRACE(SPM_TRACE_EVENT_LATENCY_OVERRUN,
+                      handle->service->partition->p_ldinf->pid,
+                      handle->service->p_ldinf->sid);
+        }
+#endif
+    }
+#endif
+
+#if CONFIG_TFM_CALL_LATENCY == 1
+    if (handle->lat_sampled) {
+        uint32_t now = SPM_GET_CYCLES();
+
+        spm_record_call_latency(handle->service, SPM_CALL_PHASE_SERVICE,
+                                now - handle->lat_cycles);
+        ((struct service_t *)handle->service)->latency.samples++;
+
+        /*
+         * The return ends when the mailbox agent gets the reply, or when the
+         * client is switched in again. A client waits for one reply at once.
+         */
+        if (tfm_spm_is_rpc_msg(handle)) {
+            handle->lat_cycles = now;
+        } else {
+            handle->lat_sampled = false;
+            client->lat_service = handle->service;
+            client->lat_reply_cycles = now;
+        }
+    }
+#endif
+
+#if CONFIG_TFM_PRIORITY_INHERITANCE == 1
+    /* The message is done, drop the priority inherited from its client. */
+    if (handle->service && handle->service->partition) {
+        update_inherited_priority(handle->service->partition);
+    }
+#endif
+
     if (tfm_spm_is_rpc_msg(handle)) {
         /*
          * Add to the list of outstanding responses.
-         * Note that we use the partition's p_handles pointer.
+         * Note that we use the partition's message list.
          * This assumes that partitions using the agent API will process all requests
          * asynchronously and will not also provide services of their own.
          */
         handle->reply_value = (uintptr_t)status;
         handle->msg.rhandle = handle;
-        UNI_LIST_INSERT_AFTER(client, handle, p_handles);
+        BI_LIST_INSERT_BEFORE(&client->msg_list, &handle->msg_node);
         return backend_assert_signal(handle->p_client, ASYNC_MSG_REPLY);
     } else {
         handle->p_client->reply_value = (uintptr_t)status;
@@ -236,8 +602,6 @@ psa_status_t backend_replying(struct connection_t *handle, int32_t status)
     }
 }
 
-extern void common_sfn_thread(void *param);
-
 static thrd_fn_t partition_init(struct partition_t *p_pt,
                                 uint32_t service_setting, uint32_t *param)
 {
@@ -257,8 +621,6 @@ static thrd_fn_t partition_init(struct partition_t *p_pt,
         p_pt->signals_allowed |= ASYNC_MSG_REPLY;
     }
 
-    UNI_LISI_INIT_NODE(p_pt, p_handles);
-
     if (IS_IPC_MODEL(p_pt->p_ldinf)) {
         /* IPC Partition */
         thrd_entry = POSITION_TO_ENTRY(p_pt->p_ldinf->entry, thrd_fn_t);
@@ -316,15 +678,30 @@ void backend_init_comp_assuredly(struct partition_t *p_pt, uint32_t service_sett
                       LOAD_ALLOCED_STACK_ADDR(p_pldi),
                       p_pldi->stack_size);
 
+#if CONFIG_TFM_SPM_SHARED_STACKS == 1
+    /* A shared stack is watermarked once, before any metadata is put on it */
+    if (!IS_SHARED_STACK(p_pldi) || !shared_stack_join(p_pt)) {
+        watermark_stack(p_pt);
+    }
+#else
     watermark_stack(p_pt);
+#endif
 
     THRD_INIT(&p_pt->thrd, &p_pt->ctx_ctrl,
               TO_THREAD_PRIORITY(PARTITION_PRIORITY(p_pldi->flags)));
 
+    BI_LIST_INIT_NODE(&p_pt->msg_list);
+
     thrd_entry = (comp_init_fns[index])(p_pt, service_setting, &param);
 
     prv_process_metadata(p_pt);
 
+#if CONFIG_TFM_SPM_SHARED_STACKS == 1
+    if (IS_SHARED_STACK(p_pldi)) {
+        shared_stack_set_base(p_pt, p_pt->ctx_ctrl.sp);
+    }
+#endif
+
     thrd_start(&p_pt->thrd, thrd_entry, THRD_GENERAL_EXIT, (void *)param);
 }
 
@@ -350,6 +727,10 @@ uint32_t backend_system_run(void)
     /* Init thread callback function. */
     thrd_set_query_callback(query_state);
 
+#if CONFIG_TFM_PARTITION_PMU == 1
+    SPM_PMU_INIT();
+#endif
+
     control = thrd_start_scheduler(&CURRENT_THREAD);
 
     p_cur_pt = TO_CONTAINER(CURRENT_THREAD->p_context_ctrl,
@@ -377,6 +758,14 @@ psa_signal_t backend_wait_signals(struct partition_t *p_pt, psa_signal_t signals
     ret = p_pt->signals_asserted & signals;
     if (ret == (psa_signal_t)0) {
         p_pt->signals_waiting = signals;
+
+#if CONFIG_TFM_SPM_SHARED_STACKS == 1
+        /* Only waiting for a reply keeps the frames in use */
+        if (IS_SHARED_STACK(p_pt->p_ldinf) &&
+            ((signals & ASYNC_MSG_REPLY) == 0)) {
+            shared_stack_release(p_pt);
+        }
+#endif
     }
 
     CRITICAL_SECTION_LEAVE(cs_signal);
@@ -393,11 +782,23 @@ psa_status_t backend_assert_signal(struct partition_t *p_pt, psa_signal_t signal
         tfm_core_panic();
     }
 
+    SPM_TRACE(SPM_TRACE_EVENT_ASSERT_SIGNAL, p_pt->p_ldinf->pid, signal);
+
     CRITICAL_SECTION_ENTER(cs_signal);
     p_pt->signals_asserted |= signal;
 
     if (p_pt->signals_asserted & p_pt->signals_waiting) {
-        ret = STATUS_NEED_SCHEDULE;
+        /* Thread turns runnable, let the scheduler check its priority */
+        thrd_mark_ready(&p_pt->thrd);
+
+        /*
+         * A thread of lower priority than the current one cannot preempt it,
+         * so scheduling can wait until the current thread blocks.
+         */
+        if ((CURRENT_THREAD == NULL) ||
+            (p_pt->thrd.priority <= CURRENT_THREAD->priority)) {
+            ret = STATUS_NEED_SCHEDULE;
+        }
     }
     CRITICAL_SECTION_LEAVE(cs_signal);
 
@@ -453,7 +854,7 @@ uint32_t backend_abi_leaving_spm(uint32_t result)
     return result;
 }
 
-uint64_t ipc_schedule(uint32_t exc_return)
+SPM_RAM_CODE uint64_t ipc_schedule(uint32_t exc_return)
 {
     fih_int fih_rc = FIH_FAILURE;
     FIH_RET_TYPE(bool) fih_bool;
@@ -476,6 +877,12 @@ uint64_t ipc_schedule(uint32_t exc_return)
         SPM_ASSERT(!basepri_set_by_ipc_schedule);
         basepri_set_by_ipc_schedule = true;
         __set_BASEPRI(SECURE_THREAD_EXECUTION_PRIORITY);
+    } else if (__get_BASEPRI() == SECURE_THREAD_PREEMPTION_PRIORITY) {
+        /*
+         * A secure thread was interrupted at a preemption point. Close it
+         * before scheduling, the thread closing it again has no effect.
+         */
+        __set_BASEPRI(SECURE_THREAD_EXECUTION_PRIORITY);
     }
 #endif
 
@@ -516,7 +923,15 @@ uint64_t ipc_schedule(uint32_t exc_return)
                 tfm_core_panic();
             }
         }
-        ARCH_FLUSH_FP_CONTEXT();
+
+        /*
+         * A lazy preservation of the FP context can only be pending for a
+         * thread whose stack frame has FP space allocated. Threads which do
+         * not use the FPU do not need the flush.
+         */
+        if (is_stack_alloc_fp_space(exc_return)) {
+            ARCH_FLUSH_FP_CONTEXT();
+        }
 
 #if (CONFIG_TFM_SECURE_THREAD_MASK_NS_INTERRUPT == 1) && defined(CONFIG_TFM_USE_TRUSTZONE)
         if (IS_NS_AGENT_TZ(p_part_next->p_ldinf)) {
@@ -539,6 +954,13 @@ uint64_t ipc_schedule(uint32_t exc_return)
 
         AAPCS_DUAL_U32_SET_A1(ctx_ctrls, (uint32_t)pth_next->p_context_ctrl);
 
+        SPM_TRACE(SPM_TRACE_EVENT_THREAD_SWITCH, p_part_curr->p_ldinf->pid,
+                  p_part_next->p_ldinf->pid);
+
+#if CONFIG_TFM_PARTITION_STATS == 1
+        update_switch_stats(p_part_curr, p_part_next);
+#endif
+
         CURRENT_THREAD = pth_next;
     }
 
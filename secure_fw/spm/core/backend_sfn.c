@@ -14,6 +14,7 @@
 #include "runtime_defs.h"
 #include "tfm_hal_platform.h"
 #include "tfm_nspm.h"
+#include "tfm_spm_trace.h"
 #include "ffm/backend.h"
 #include "stack_watermark.h"
 #include "load/partition_defs.h"
@@ -106,6 +107,11 @@ static uint32_t spm_init_function(uint32_t param)
             continue;
         }
 
+        /* Initialized by backend_messaging() on the first request instead */
+        if (IS_DEFERRED_INIT(p_part->p_ldinf)) {
+            continue;
+        }
+
         SET_CURRENT_COMPONENT(p_part);
 
         if (p_part->p_ldinf->entry != 0) {
@@ -194,6 +200,8 @@ psa_signal_t backend_wait_signals(struct partition_t *p_pt, psa_signal_t signals
 
 psa_status_t backend_assert_signal(struct partition_t *p_pt, psa_signal_t signal)
 {
+    SPM_TRACE(SPM_TRACE_EVENT_ASSERT_SIGNAL, p_pt->p_ldinf->pid, signal);
+
     p_pt->signals_asserted |= signal;
 
     return PSA_SUCCESS;
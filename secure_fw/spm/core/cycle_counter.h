@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __CYCLE_COUNTER_H__
+#define __CYCLE_COUNTER_H__
+
+#include <stdint.h>
+
+/*
+ * Free running cycle counter used by the SPM trace and statistics. It is the
+ * DWT cycle counter on Armv7-M / Armv8-M Mainline cores, which only counts in
+ * the Secure state if Secure non-invasive debug is allowed. A platform can
+ * provide another source by defining SPM_GET_CYCLES().
+ */
+#ifndef SPM_GET_CYCLES
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+/* Architectural addresses of the debug registers used for the cycle counter */
+#define SPM_CYCLES_DEMCR        (*(volatile uint32_t *)0xE000EDFCUL)
+#define SPM_CYCLES_DWT_CTRL     (*(volatile uint32_t *)0xE0001000UL)
+#define SPM_CYCLES_DWT_CYCCNT   (*(volatile uint32_t *)0xE0001004UL)
+
+static inline uint32_t spm_get_cycles(void)
+{
+    if (!(SPM_CYCLES_DWT_CTRL & 0x1UL)) {
+        SPM_CYCLES_DEMCR |= 0x1UL << 24;
+        SPM_CYCLES_DWT_CTRL |= 0x1UL;
+    }
+
+    return SPM_CYCLES_DWT_CYCCNT;
+}
+#define SPM_GET_CYCLES()        spm_get_cycles()
+#else
+#define SPM_GET_CYCLES()        0U
+#endif
+#endif /* !SPM_GET_CYCLES */
+
+#endif /* __CYCLE_COUNTER_H__ */
@@ -17,6 +17,7 @@
 #include "tfm_arch.h"
 #include "tfm_hal_interrupt.h"
 #include "tfm_hal_isolation.h"
+#include "tfm_spm_trace.h"
 #include "tfm_svcalls.h"
 #include "thread.h"
 #include "utilities.h"
@@ -167,8 +168,20 @@ void spm_handle_interrupt(void *p_pt, const struct irq_load_info_t *p_ildi)
         tfm_core_panic();
     }
 
+    SPM_TRACE(SPM_TRACE_EVENT_INTERRUPT, p_ildi->pid, p_ildi->source);
+
     if (p_ildi->flih_func == NULL) {
         /* SLIH Model Handling */
+#if CONFIG_TFM_SLIH_COALESCE_NUM > 0
+        /*
+         * A coalesced IRQ stays enabled until it has happened the number of
+         * times set in the manifest, and only the last time is signalled.
+         */
+        if ((p_ildi->coalesce > 1) &&
+            (++p_part->irq_events[p_ildi->coalesce_idx] < p_ildi->coalesce)) {
+            return;
+        }
+#endif
         tfm_hal_irq_disable(p_ildi->source);
         flih_result = PSA_FLIH_SIGNAL;
     } else {
@@ -176,6 +189,16 @@ void spm_handle_interrupt(void *p_pt, const struct irq_load_info_t *p_ildi)
 #if TFM_ISOLATION_LEVEL == 1
         flih_result = p_ildi->flih_func();
         (void)fih_bool;
+#elif defined(SPM_FLIH_BOUNDARY_AT_INIT)
+        (void)fih_bool;
+        if (p_part->flih_in_spm_boundary) {
+            flih_result = p_ildi->flih_func();
+        } else {
+            flih_result = tfm_flih_deprivileged_handling(
+                                                p_part,
+                                                (uintptr_t)p_ildi->flih_func,
+                                                GET_CURRENT_COMPONENT());
+        }
 #else
         FIH_CALL(tfm_hal_boundary_need_switch, fih_bool,
                  spm_boundary, p_part->boundary);
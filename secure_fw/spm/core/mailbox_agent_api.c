@@ -8,6 +8,7 @@
  */
 
 #include "current.h"
+#include "cycle_counter.h"
 #include "fih.h"
 #include "internal_status_code.h"
 #include "spm.h"
@@ -27,6 +28,9 @@ psa_status_t tfm_spm_agent_psa_call(psa_handle_t handle,
     struct partition_t *curr_partition = GET_CURRENT_COMPONENT();
     fih_int fih_rc = FIH_FAILURE;
     psa_status_t status;
+#if CONFIG_TFM_CALL_LATENCY == 1
+    uint32_t entry_cycles = SPM_GET_CYCLES();
+#endif
 
     FIH_CALL(tfm_hal_memory_check, fih_rc,
              curr_partition->boundary, (uintptr_t)params,
@@ -41,6 +45,10 @@ psa_status_t tfm_spm_agent_psa_call(psa_handle_t handle,
         return status;
     }
 
+#if CONFIG_TFM_CALL_LATENCY == 1
+    p_connection->lat_cycles = entry_cycles;
+#endif
+
     status = spm_associate_call_params(p_connection, control, params->p_invecs, params->p_outvecs);
     if (status != PSA_SUCCESS) {
         return status;
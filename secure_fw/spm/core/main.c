@@ -9,6 +9,7 @@
 #include "internal_status_code.h"
 #include "fih.h"
 #include "tfm_boot_data.h"
+#include "tfm_boot_timeline.h"
 #include "memory_symbols.h"
 #include "spm.h"
 #include "tfm_hal_isolation.h"
@@ -25,11 +26,44 @@
 
 uintptr_t spm_boundary = (uintptr_t)NULL;
 
+#ifdef TFM_BOOT_TIMELINE
+static void tfm_core_log_boot_timeline(void)
+{
+    const struct boot_timeline *timeline =
+                                (const struct boot_timeline *)BOOT_TIMELINE_BASE;
+    const struct boot_timeline_record *record;
+    uint32_t first = 0;
+    uint32_t idx;
+
+    /* Only the most recent records are kept once the ring has wrapped */
+    if (timeline->record_cnt > BOOT_TIMELINE_CAPACITY) {
+        first = timeline->record_cnt - BOOT_TIMELINE_CAPACITY;
+    }
+
+    SPMLOG_INFMSGVAL("[Boot timeline] Records: ", timeline->record_cnt);
+
+    for (idx = first; idx < timeline->record_cnt; idx++) {
+        record = &timeline->records[idx % BOOT_TIMELINE_CAPACITY];
+        SPMLOG_INFMSGVAL("[Boot timeline] Stage/event/param: ",
+                         ((uint32_t)record->stage << 24) |
+                         ((uint32_t)record->event << 16) | record->param);
+        SPMLOG_INFMSGVAL("[Boot timeline] Timestamp: ", record->timestamp);
+    }
+}
+#endif /* TFM_BOOT_TIMELINE */
+
 static fih_int tfm_core_init(void)
 {
     enum tfm_plat_err_t plat_err = TFM_PLAT_ERR_SYSTEM_ERR;
     fih_int fih_rc = FIH_FAILURE;
 
+#if !defined(BL1) && !defined(BL2)
+    /* The SPM is the first stage which records the boot timeline */
+    BOOT_TIMELINE_RESET();
+#endif
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_SPM,
+                         BOOT_TIMELINE_EVENT_STAGE_START, 0);
+
     /*
      * Access to any peripheral should be performed after programming
      * the necessary security components such as PPC/SAU.
@@ -49,6 +83,8 @@ static fih_int tfm_core_init(void)
     if (fih_not_eq(fih_rc, fih_int_encode(TFM_HAL_SUCCESS))) {
         FIH_RET(fih_int_encode(SPM_ERROR_GENERIC));
     }
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_SPM,
+                         BOOT_TIMELINE_EVENT_PLATFORM_INIT_DONE, 0);
 
     /*
      * Print the TF-M version now that the platform has initialized
@@ -89,6 +125,12 @@ static fih_int tfm_core_init(void)
 
     tfm_core_validate_boot_data();
 
+    BOOT_TIMELINE_RECORD(BOOT_TIMELINE_STAGE_SPM,
+                         BOOT_TIMELINE_EVENT_STAGE_END, 0);
+#ifdef TFM_BOOT_TIMELINE
+    tfm_core_log_boot_timeline();
+#endif
+
     FIH_RET(fih_int_encode(SPM_SUCCESS));
 }
 
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PMU_COUNTER_H__
+#define __PMU_COUNTER_H__
+
+#include <stdint.h>
+#include "config_impl.h"
+
+/* Number of PMU events accounted per partition */
+#define SPM_PMU_EVENT_NUM       4
+
+#if CONFIG_TFM_PARTITION_PMU == 1
+/*
+ * Event counters of the Armv8.1-M PMU used by the partition statistics. The
+ * architectural counters are 16 bits wide, so each event uses a pair of
+ * counters, the odd one counting the overflows of the even one through the
+ * CHAIN event. Like the DWT cycle counter, the PMU only counts in the Secure
+ * state if Secure non-invasive debug is allowed.
+ *
+ * A platform can provide another source by defining SPM_PMU_INIT() and
+ * SPM_PMU_GET_EVENT(idx).
+ */
+#ifndef SPM_PMU_GET_EVENT
+#if defined(__ARM_ARCH_8_1M_MAIN__)
+/* Architectural addresses of the PMU registers */
+#define SPM_PMU_DEMCR           (*(volatile uint32_t *)0xE000EDFCUL)
+#define SPM_PMU_EVCNTR(n)       (*(volatile uint32_t *)(0xE0003000UL + 4 * (n)))
+#define SPM_PMU_EVTYPER(n)      (*(volatile uint32_t *)(0xE0003400UL + 4 * (n)))
+#define SPM_PMU_CNTENSET        (*(volatile uint32_t *)0xE0003C00UL)
+#define SPM_PMU_CTRL            (*(volatile uint32_t *)0xE0003E04UL)
+
+#define SPM_PMU_CTRL_E          (0x1UL << 0)
+#define SPM_PMU_CTRL_P          (0x1UL << 1)
+#define SPM_PMU_EVENT_CHAIN     0x001EUL
+
+static inline void spm_pmu_init(void)
+{
+    static const uint32_t events[SPM_PMU_EVENT_NUM] = {
+        CONFIG_TFM_PMU_EVENT_0, CONFIG_TFM_PMU_EVENT_1,
+        CONFIG_TFM_PMU_EVENT_2, CONFIG_TFM_PMU_EVENT_3,
+    };
+    uint32_t i;
+
+    SPM_PMU_DEMCR |= 0x1UL << 24;
+
+    for (i = 0; i < SPM_PMU_EVENT_NUM; i++) {
+        SPM_PMU_EVTYPER(2 * i) = events[i];
+        SPM_PMU_EVTYPER(2 * i + 1) = SPM_PMU_EVENT_CHAIN;
+    }
+
+    SPM_PMU_CTRL |= SPM_PMU_CTRL_P;
+    SPM_PMU_CNTENSET = (0x1UL << (2 * SPM_PMU_EVENT_NUM)) - 1;
+    SPM_PMU_CTRL |= SPM_PMU_CTRL_E;
+}
+
+static inline uint32_t spm_pmu_get_event(uint32_t idx)
+{
+    uint32_t high, low;
+
+    /* Read the high half again if the low half wrapped in between */
+    do {
+        high = SPM_PMU_EVCNTR(2 * idx + 1);
+        low = SPM_PMU_EVCNTR(2 * idx);
+    } while (high != SPM_PMU_EVCNTR(2 * idx + 1));
+
+    return ((high & 0xFFFFUL) << 16) | (low & 0xFFFFUL);
+}
+#define SPM_PMU_INIT()          spm_pmu_init()
+#define SPM_PMU_GET_EVENT(idx)  spm_pmu_get_event(idx)
+#else
+#error "CONFIG_TFM_PARTITION_PMU requires an Armv8.1-M PMU or platform defined SPM_PMU_GET_EVENT()"
+#endif
+#endif /* !SPM_PMU_GET_EVENT */
+#endif /* CONFIG_TFM_PARTITION_PMU == 1 */
+
+#endif /* __PMU_COUNTER_H__ */
@@ -14,10 +14,12 @@
 #include "config_impl.h"
 #include "config_spm.h"
 #include "critical_section.h"
+#include "cycle_counter.h"
 #include "internal_status_code.h"
 #include "psa/lifecycle.h"
 #include "psa/service.h"
 #include "spm.h"
+#include "stack_watermark.h"
 #include "tfm_arch.h"
 #include "load/partition_defs.h"
 #include "load/service_defs.h"
@@ -29,6 +31,7 @@
 #include "tfm_plat_otp.h"
 #include "tfm_psa_call_pack.h"
 #include "tfm_hal_isolation.h"
+#include "tfm_spm_trace.h"
 
 void spm_handle_programmer_errors(psa_status_t status)
 {
@@ -158,26 +161,28 @@ psa_status_t tfm_spm_partition_psa_get(psa_signal_t signal, psa_msg_t *msg)
     }
 
     if (signal == ASYNC_MSG_REPLY) {
-        struct connection_t **pr_handle_iter, **prev = NULL;
         struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
 
-        /* Remove tail of the list, which is the first item added */
+        /* Remove head of the list, which is the first item added */
         CRITICAL_SECTION_ENTER(cs_assert);
-        if (!partition->p_handles) {
+        if (BI_LIST_IS_EMPTY(&partition->msg_list)) {
             tfm_core_panic();
         }
-        UNI_LIST_FOREACH_NODE_PNODE(pr_handle_iter, handle,
-                                    partition, p_handles) {
-            prev = pr_handle_iter;
-        }
-        handle = *prev;
-        UNI_LIST_REMOVE_NODE_BY_PNODE(prev, p_handles);
+        handle = GET_LIST_CONNECTION(BI_LIST_NEXT_NODE(&partition->msg_list));
+        BI_LIST_REMOVE_NODE(&handle->msg_node);
         ret = handle->reply_value;
         /* Clear the signal if there are no more asynchronous responses waiting */
-        if (!partition->p_handles) {
+        if (BI_LIST_IS_EMPTY(&partition->msg_list)) {
             partition->signals_asserted &= ~ASYNC_MSG_REPLY;
         }
         CRITICAL_SECTION_LEAVE(cs_assert);
+#if CONFIG_TFM_CALL_LATENCY == 1
+        if (handle->lat_sampled) {
+            spm_record_call_latency(handle->service, SPM_CALL_PHASE_RETURN,
+                                    SPM_GET_CYCLES() - handle->lat_cycles);
+            handle->lat_sampled = false;
+        }
+#endif
     } else {
         /*
          * Get message by signal from partition. It is a fatal error if getting
@@ -189,6 +194,13 @@ psa_status_t tfm_spm_partition_psa_get(psa_signal_t signal, psa_msg_t *msg)
         } else {
             return PSA_ERROR_DOES_NOT_EXIST;
         }
+#if CONFIG_TFM_CALL_LATENCY == 1
+        if (handle->lat_sampled) {
+            handle->lat_cycles = SPM_GET_CYCLES();
+            spm_record_call_latency(handle->service, SPM_CALL_PHASE_QUEUE,
+                                    handle->lat_cycles - handle->msg_cycles);
+        }
+#endif
     }
 
     spm_memcpy(msg, &handle->msg, sizeof(psa_msg_t));
@@ -197,13 +209,14 @@ psa_status_t tfm_spm_partition_psa_get(psa_signal_t signal, psa_msg_t *msg)
 }
 #endif
 
-psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
-                                         psa_status_t status)
+SPM_RAM_CODE psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
+                                                      psa_status_t status)
 {
-    const struct service_t *service;
     struct connection_t *handle;
-    psa_status_t ret = PSA_SUCCESS;
-    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    psa_status_t ret;
+
+    SPM_TRACE(SPM_TRACE_EVENT_PSA_REPLY_ENTER,
+              tfm_spm_partition_get_running_partition_id(), msg_handle);
 
     /* It is a fatal error if message handle is invalid */
     handle = spm_msg_handle_to_connection(msg_handle);
@@ -211,6 +224,24 @@ psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
         tfm_core_panic();
     }
 
+    ret = spm_reply_connection(handle, status);
+
+    /* The service has just served a request, its stack use is at a peak */
+    report_usage_growth(GET_CURRENT_COMPONENT());
+
+    SPM_TRACE(SPM_TRACE_EVENT_PSA_REPLY_EXIT,
+              tfm_spm_partition_get_running_partition_id(), ret);
+
+    return ret;
+}
+
+psa_status_t spm_reply_connection(struct connection_t *handle,
+                                  psa_status_t status)
+{
+    const struct service_t *service;
+    psa_status_t ret = PSA_SUCCESS;
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+
     /*
      * RoT Service information is needed in this function, stored it in message
      * body structure. Only two parameters are passed in this function: handle
@@ -229,7 +260,7 @@ psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
          * input status.
          */
         if (status == PSA_SUCCESS) {
-            ret = msg_handle;
+            ret = handle->msg.handle;
         } else if (status == PSA_ERROR_CONNECTION_REFUSED) {
             /* Refuse the client connection, indicating a permanent error. */
             ret = PSA_ERROR_CONNECTION_REFUSED;
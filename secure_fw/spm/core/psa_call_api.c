@@ -8,14 +8,93 @@
  *
  */
 
+#include <stdint.h>
 #include "config_impl.h"
+#include "config_spm.h"
 #include "critical_section.h"
+#include "cycle_counter.h"
 #include "ffm/backend.h"
 #include "ffm/psa_api.h"
 #include "tfm_hal_isolation.h"
 #include "tfm_psa_call_pack.h"
+#include "tfm_spm_trace.h"
 #include "utilities.h"
 
+/*
+ * Checks the client payload vectors of one direction. Vectors which are
+ * adjacent or overlap are checked as one combined range, which saves the
+ * checks of the individual vectors. A combined range can span several
+ * protection regions, which makes the check fail although each vector is
+ * valid, so the vectors are checked individually in that case.
+ */
+static psa_status_t spm_check_client_vectors(uintptr_t boundary,
+                                             const uintptr_t *bases,
+                                             const size_t *lens,
+                                             size_t num,
+                                             uint32_t access_type)
+{
+    size_t order[PSA_MAX_IOVEC];
+    size_t n_order = 0;
+    size_t i, j, first;
+    uintptr_t start, end;
+    fih_int fih_rc = FIH_FAILURE;
+
+    /*
+     * Empty vectors always pass, and the ones wrapping around the address
+     * space are left to fail the individual check. Sort the others by base.
+     */
+    for (i = 0; i < num; i++) {
+        if (lens[i] == 0) {
+            continue;
+        }
+        if (bases[i] > UINTPTR_MAX - lens[i]) {
+            FIH_CALL(tfm_hal_memory_check, fih_rc,
+                     boundary, bases[i], lens[i], access_type);
+            if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+                return PSA_ERROR_PROGRAMMER_ERROR;
+            }
+            continue;
+        }
+        for (j = n_order; j > 0 && bases[order[j - 1]] > bases[i]; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+        n_order++;
+    }
+
+    for (first = 0; first < n_order; first = j) {
+        start = bases[order[first]];
+        end = start + lens[order[first]];
+
+        /* Gather the vectors which are adjacent to or overlap the range */
+        for (j = first + 1; j < n_order && bases[order[j]] <= end; j++) {
+            if (bases[order[j]] + lens[order[j]] > end) {
+                end = bases[order[j]] + lens[order[j]];
+            }
+        }
+
+        FIH_CALL(tfm_hal_memory_check, fih_rc,
+                 boundary, start, end - start, access_type);
+        if (fih_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+            continue;
+        }
+
+        if (j == first + 1) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+
+        for (i = first; i < j; i++) {
+            FIH_CALL(tfm_hal_memory_check, fih_rc,
+                     boundary, bases[order[i]], lens[order[i]], access_type);
+            if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+                return PSA_ERROR_PROGRAMMER_ERROR;
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
 psa_status_t spm_associate_call_params(struct connection_t *p_connection,
                                        uint32_t            ctrl_param,
                                        const psa_invec     *inptr,
@@ -23,7 +102,12 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
 {
     psa_invec  ivecs_local[PSA_MAX_IOVEC];
     psa_outvec ovecs_local[PSA_MAX_IOVEC];
+    uintptr_t  vec_bases[PSA_MAX_IOVEC];
+    size_t     vec_lens[PSA_MAX_IOVEC];
+    uintptr_t  desc_base;
+    size_t     desc_len;
     int        i, j;
+    psa_status_t status;
     fih_int    fih_rc      = FIH_FAILURE;
     uint32_t   ns_access   = 0;
     size_t     ivec_num    = PARAM_UNPACK_IN_LEN(ctrl_param);
@@ -58,9 +142,26 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
      * if the memory reference for the wrap input vector is invalid or not
      * readable.
      */
+    desc_base = (uintptr_t)inptr;
+    desc_len = ivec_num * sizeof(psa_invec);
+
+#if CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX > 0
+    /*
+     * The payload of an inline input vector is right before the wrap input
+     * vector, and is checked together with it.
+     */
+    if (PARAM_IS_INLINE_INVEC(ctrl_param)) {
+        if ((ivec_num == 0) || (desc_base < TFM_PSA_CALL_INLINE_OFFSET)) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+        desc_base -= TFM_PSA_CALL_INLINE_OFFSET;
+        desc_len += TFM_PSA_CALL_INLINE_OFFSET;
+    }
+#endif
+
     FIH_CALL(tfm_hal_memory_check, fih_rc,
-             curr_partition->boundary, (uintptr_t)inptr,
-             ivec_num * sizeof(psa_invec), TFM_HAL_ACCESS_READABLE | ns_access);
+             curr_partition->boundary, desc_base,
+             desc_len, TFM_HAL_ACCESS_READABLE | ns_access);
     if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
@@ -68,6 +169,15 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
     spm_memset(ivecs_local, 0, sizeof(ivecs_local));
     spm_memcpy(ivecs_local, inptr, ivec_num * sizeof(psa_invec));
 
+#if CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX > 0
+    if (PARAM_IS_INLINE_INVEC(ctrl_param)) {
+        if (ivecs_local[0].len > CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+        ivecs_local[0].base = (const void *)desc_base;
+    }
+#endif
+
     /*
      * Read client outvecs from the wrap output vector and will update the
      * actual length later. It is a PROGRAMMER ERROR if the memory reference for
@@ -113,13 +223,25 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
      * memory reference was invalid or not readable.
      */
     for (i = 0; i < ivec_num; i++) {
-        FIH_CALL(tfm_hal_memory_check, fih_rc,
-                 curr_partition->boundary, (uintptr_t)ivecs_local[i].base,
-                 ivecs_local[i].len, TFM_HAL_ACCESS_READABLE | ns_access);
-        if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
-            return PSA_ERROR_PROGRAMMER_ERROR;
-        }
+        vec_bases[i] = (uintptr_t)ivecs_local[i].base;
+        vec_lens[i] = ivecs_local[i].len;
+    }
 
+#if CONFIG_TFM_PSA_CALL_INLINE_INVEC_MAX > 0
+    /* The inline payload is already checked with the wrap input vector */
+    if (PARAM_IS_INLINE_INVEC(ctrl_param)) {
+        vec_lens[0] = 0;
+    }
+#endif
+
+    status = spm_check_client_vectors(curr_partition->boundary, vec_bases,
+                                      vec_lens, ivec_num,
+                                      TFM_HAL_ACCESS_READABLE | ns_access);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    for (i = 0; i < ivec_num; i++) {
         p_connection->msg.in_size[i]    = ivecs_local[i].len;
         p_connection->invec_base[i]     = ivecs_local[i].base;
         p_connection->invec_accessed[i] = 0;
@@ -136,13 +258,18 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
      * payload memory reference was invalid or not read-write.
      */
     for (i = 0; i < ovec_num; i++) {
-        FIH_CALL(tfm_hal_memory_check, fih_rc,
-                 curr_partition->boundary, (uintptr_t)ovecs_local[i].base,
-                 ovecs_local[i].len, TFM_HAL_ACCESS_READWRITE | ns_access);
-        if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
-            return PSA_ERROR_PROGRAMMER_ERROR;
-        }
+        vec_bases[i] = (uintptr_t)ovecs_local[i].base;
+        vec_lens[i] = ovecs_local[i].len;
+    }
+
+    status = spm_check_client_vectors(curr_partition->boundary, vec_bases,
+                                      vec_lens, ovec_num,
+                                      TFM_HAL_ACCESS_READWRITE | ns_access);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
 
+    for (i = 0; i < ovec_num; i++) {
         p_connection->msg.out_size[i]   = ovecs_local[i].len;
         p_connection->outvec_base[i]    = ovecs_local[i].base;
         p_connection->outvec_written[i] = 0;
@@ -153,30 +280,45 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
     return PSA_SUCCESS;
 }
 
-psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
-                                     uint32_t ctrl_param,
-                                     const psa_invec *inptr,
-                                     psa_outvec *outptr)
+SPM_RAM_CODE psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
+                                                  uint32_t ctrl_param,
+                                                  const psa_invec *inptr,
+                                                  psa_outvec *outptr)
 {
     struct connection_t *p_connection;
     int32_t client_id;
     bool ns_caller = tfm_spm_is_ns_caller();
     psa_status_t status;
+#if CONFIG_TFM_CALL_LATENCY == 1
+    uint32_t entry_cycles = SPM_GET_CYCLES();
+#endif
 
     client_id = tfm_spm_get_client_id(ns_caller);
 
+    SPM_TRACE(SPM_TRACE_EVENT_PSA_CALL_ENTER, client_id, handle);
+
     status = spm_get_idle_connection(&p_connection, handle, client_id);
     if (status != PSA_SUCCESS) {
+        SPM_TRACE(SPM_TRACE_EVENT_PSA_CALL_EXIT, client_id, status);
         return status;
     }
 
+#if CONFIG_TFM_CALL_LATENCY == 1
+    p_connection->lat_cycles = entry_cycles;
+#endif
+
     status = spm_associate_call_params(p_connection, ctrl_param, inptr, outptr);
     if (status != PSA_SUCCESS) {
         if (IS_STATIC_HANDLE(handle)) {
             spm_free_connection(p_connection);
         }
+        SPM_TRACE(SPM_TRACE_EVENT_PSA_CALL_EXIT, client_id, status);
         return status;
     }
 
-    return backend_messaging(p_connection);
+    status = backend_messaging(p_connection);
+
+    SPM_TRACE(SPM_TRACE_EVENT_PSA_CALL_EXIT, client_id, status);
+
+    return status;
 }
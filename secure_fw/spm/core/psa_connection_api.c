@@ -8,11 +8,11 @@
  *
  */
 
-#include "critical_section.h"
 #include "ffm/backend.h"
 #include "ffm/psa_api.h"
 #include "load/service_defs.h"
 #include "spm.h"
+#include "tfm_spm_trace.h"
 #include "utilities.h"
 
 /* PSA APIs only needed by connection-based services */
@@ -26,12 +26,20 @@ psa_status_t tfm_spm_client_psa_connect(uint32_t sid, uint32_t version)
     bool ns_caller = tfm_spm_is_ns_caller();
 
     client_id = tfm_spm_get_client_id(ns_caller);
+
+    SPM_TRACE(SPM_TRACE_EVENT_PSA_CONNECT_ENTER, client_id, sid);
+
     status = spm_psa_connect_client_id_associated(&p_connection, sid, version, client_id);
     if (status != PSA_SUCCESS) {
+        SPM_TRACE(SPM_TRACE_EVENT_PSA_CONNECT_EXIT, client_id, status);
         return status;
     }
 
-    return backend_messaging(p_connection);
+    status = backend_messaging(p_connection);
+
+    SPM_TRACE(SPM_TRACE_EVENT_PSA_CONNECT_EXIT, client_id, status);
+
+    return status;
 }
 
 psa_status_t spm_psa_connect_client_id_associated(struct connection_t **p_connection,
@@ -39,7 +47,6 @@ psa_status_t spm_psa_connect_client_id_associated(struct connection_t **p_connec
 {
     const struct service_t *service;
     struct connection_t *connection;
-    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
     bool ns_caller = (client_id < 0) ? true : false;
 
     /*
@@ -76,9 +83,7 @@ psa_status_t spm_psa_connect_client_id_associated(struct connection_t **p_connec
      * Create connection handle here since it is possible to return the error
      * code to client when creation fails.
      */
-    CRITICAL_SECTION_ENTER(cs_assert);
-    connection = spm_allocate_connection();
-    CRITICAL_SECTION_LEAVE(cs_assert);
+    connection = spm_allocate_connection(service);
     if (!connection) {
         return PSA_ERROR_CONNECTION_BUSY;
     }
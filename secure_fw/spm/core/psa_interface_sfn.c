@@ -14,6 +14,24 @@
 #include "ffm/psa_api.h"
 #include "psa/client.h"
 
+/*
+ * The Secure Partition APIs are called by the RoT Services, which run in the
+ * call chain of psa_call(), so in Thread mode as checked there, unless they are
+ * called from a First-Level Interrupt Handler. Without any FLIH in the build,
+ * the Thread mode check of these APIs is not needed on the call path.
+ */
+#if CONFIG_TFM_FLIH_API == 1
+#define PARTITION_API_THREAD_MODE_CHECK()                        \
+    do {                                                         \
+        if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {     \
+            /* PSA APIs must be called from Thread mode */       \
+            tfm_core_panic();                                    \
+        }                                                        \
+    } while (0)
+#else
+#define PARTITION_API_THREAD_MODE_CHECK()
+#endif
+
 uint32_t psa_framework_version(void)
 {
     if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
@@ -52,8 +70,7 @@ psa_status_t tfm_psa_call_pack(psa_handle_t handle, uint32_t ctrl_param,
     p_target = GET_CURRENT_COMPONENT();
     if (p_client != p_target) {
         /* Execution is returned from RoT Service */
-        stat = tfm_spm_partition_psa_reply(p_target->p_handles->msg.handle,
-                                           stat);
+        stat = spm_reply_connection(p_target->p_handles, stat);
     } else {
         /* Execution is returned from SPM */
         spm_handle_programmer_errors(stat);
@@ -65,10 +82,7 @@ psa_status_t tfm_psa_call_pack(psa_handle_t handle, uint32_t ctrl_param,
 size_t psa_read(psa_handle_t msg_handle, uint32_t invec_idx,
                 void *buffer, size_t num_bytes)
 {
-    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
-        /* PSA APIs must be called from Thread mode */
-        tfm_core_panic();
-    }
+    PARTITION_API_THREAD_MODE_CHECK();
 
     return tfm_spm_partition_psa_read(msg_handle, invec_idx,
                                        buffer, num_bytes);
@@ -77,10 +91,7 @@ size_t psa_read(psa_handle_t msg_handle, uint32_t invec_idx,
 size_t psa_skip(psa_handle_t msg_handle, uint32_t invec_idx,
                 size_t num_bytes)
 {
-    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
-        /* PSA APIs must be called from Thread mode */
-        tfm_core_panic();
-    }
+    PARTITION_API_THREAD_MODE_CHECK();
 
     return tfm_spm_partition_psa_skip(msg_handle, invec_idx, num_bytes);
 }
@@ -88,20 +99,14 @@ size_t psa_skip(psa_handle_t msg_handle, uint32_t invec_idx,
 void psa_write(psa_handle_t msg_handle, uint32_t outvec_idx,
                const void *buffer, size_t num_bytes)
 {
-    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
-        /* PSA APIs must be called from Thread mode */
-        tfm_core_panic();
-    }
+    PARTITION_API_THREAD_MODE_CHECK();
 
     tfm_spm_partition_psa_write(msg_handle, outvec_idx, buffer, num_bytes);
 }
 
 void psa_panic(void)
 {
-    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
-        /* PSA APIs must be called from Thread mode */
-        tfm_core_panic();
-    }
+    PARTITION_API_THREAD_MODE_CHECK();
 
     tfm_spm_partition_psa_panic();
 }
@@ -126,8 +131,7 @@ psa_handle_t psa_connect(uint32_t sid, uint32_t version)
     p_target = GET_CURRENT_COMPONENT();
     if (p_client != p_target) {
         /* Execution is returned from RoT Service */
-        stat = tfm_spm_partition_psa_reply(p_target->p_handles->msg.handle,
-                                           stat);
+        stat = spm_reply_connection(p_target->p_handles, stat);
     } else {
         /* Execution is returned from SPM */
         spm_handle_programmer_errors(stat);
@@ -153,8 +157,7 @@ void psa_close(psa_handle_t handle)
     p_target = GET_CURRENT_COMPONENT();
     if (p_client != p_target) {
         /* Execution is returned from RoT Service */
-        stat = tfm_spm_partition_psa_reply(p_target->p_handles->msg.handle,
-                                           PSA_SUCCESS);
+        stat = spm_reply_connection(p_target->p_handles, PSA_SUCCESS);
     } else {
         /* Execution is returned from SPM */
         spm_handle_programmer_errors(stat);
@@ -223,40 +226,28 @@ void psa_reset_signal(psa_signal_t irq_signal)
 
 const void *psa_map_invec(psa_handle_t msg_handle, uint32_t invec_idx)
 {
-    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
-        /* PSA APIs must be called from Thread mode */
-        tfm_core_panic();
-    }
+    PARTITION_API_THREAD_MODE_CHECK();
 
     return tfm_spm_partition_psa_map_invec(msg_handle, invec_idx);
 }
 
 void psa_unmap_invec(psa_handle_t msg_handle, uint32_t invec_idx)
 {
-    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
-        /* PSA APIs must be called from Thread mode */
-        tfm_core_panic();
-    }
+    PARTITION_API_THREAD_MODE_CHECK();
 
     tfm_spm_partition_psa_unmap_invec(msg_handle, invec_idx);
 }
 
 void *psa_map_outvec(psa_handle_t msg_handle, uint32_t outvec_idx)
 {
-    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
-        /* PSA APIs must be called from Thread mode */
-        tfm_core_panic();
-    }
+    PARTITION_API_THREAD_MODE_CHECK();
 
     return tfm_spm_partition_psa_map_outvec(msg_handle, outvec_idx);
 }
 
 void psa_unmap_outvec(psa_handle_t msg_handle, uint32_t outvec_idx, size_t len)
 {
-    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
-        /* PSA APIs must be called from Thread mode */
-        tfm_core_panic();
-    }
+    PARTITION_API_THREAD_MODE_CHECK();
 
     tfm_spm_partition_psa_unmap_outvec(msg_handle, outvec_idx, len);
 }
@@ -283,8 +274,7 @@ psa_status_t agent_psa_call(psa_handle_t handle,
     p_target = GET_CURRENT_COMPONENT();
     if (p_client != p_target) {
         /* Execution is returned from RoT Service */
-        stat = tfm_spm_partition_psa_reply(p_target->p_handles->msg.handle,
-                                           stat);
+        stat = spm_reply_connection(p_target->p_handles, stat);
     } else {
         /* Execution is returned from SPM */
         spm_handle_programmer_errors(stat);
@@ -312,8 +302,7 @@ psa_handle_t agent_psa_connect(uint32_t sid, uint32_t version,
     p_target = GET_CURRENT_COMPONENT();
     if (p_client != p_target) {
         /* Execution is returned from RoT Service */
-        stat = tfm_spm_partition_psa_reply(p_target->p_handles->msg.handle,
-                                           stat);
+        stat = spm_reply_connection(p_target->p_handles, stat);
     } else {
         /* Execution is returned from SPM */
         spm_handle_programmer_errors(stat);
@@ -339,8 +328,7 @@ psa_status_t agent_psa_close(psa_handle_t handle, int32_t ns_client_id)
     p_target = GET_CURRENT_COMPONENT();
     if (p_client != p_target) {
         /* Execution is returned from RoT Service */
-        stat = tfm_spm_partition_psa_reply(p_target->p_handles->msg.handle,
-                                           PSA_SUCCESS);
+        stat = spm_reply_connection(p_target->p_handles, PSA_SUCCESS);
     } else {
         /* Execution is returned from SPM */
         spm_handle_programmer_errors(stat);
@@ -112,6 +112,13 @@ psa_status_t tfm_spm_partition_psa_eoi(psa_signal_t irq_signal)
     partition->signals_asserted &= ~irq_signal;
     CRITICAL_SECTION_LEAVE(cs_assert);
 
+#if CONFIG_TFM_SLIH_COALESCE_NUM > 0
+    /* The IRQ is disabled, so the events are counted again from now */
+    if (irq_info->coalesce > 1) {
+        partition->irq_events[irq_info->coalesce_idx] = 0;
+    }
+#endif
+
     tfm_hal_irq_clear_pending(irq_info->source);
     tfm_hal_irq_enable(irq_info->source);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2022-2023 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -11,6 +11,28 @@
 #include "spm.h"
 #include "utilities.h"
 #include "tfm_hal_isolation.h"
+#if CONFIG_TFM_SPM_DMA_COPY_THRESHOLD > 0
+#include "tfm_hal_dma.h"
+#endif
+
+/* Copy between a client vector and a partition buffer. */
+static void copy_iovec(const struct connection_t *handle, void *dst,
+                       const void *src, size_t size)
+{
+#if CONFIG_TFM_SPM_DMA_COPY_THRESHOLD > 0
+    /* Large copies go to the DMA, the CPU takes the rest or a failed one */
+    if ((size >= CONFIG_TFM_SPM_DMA_COPY_THRESHOLD) &&
+        (tfm_hal_dma_copy(dst, src, size,
+                          TFM_CLIENT_ID_IS_NS(handle->msg.client_id))
+         == TFM_HAL_SUCCESS)) {
+        return;
+    }
+#else
+    (void)handle;
+#endif
+
+    spm_memcpy(dst, src, size);
+}
 
 size_t tfm_spm_partition_psa_read(psa_handle_t msg_handle, uint32_t invec_idx,
                                   void *buffer, size_t num_bytes)
@@ -73,7 +95,7 @@ size_t tfm_spm_partition_psa_read(psa_handle_t msg_handle, uint32_t invec_idx,
 
     bytes = num_bytes < remaining ? num_bytes : remaining;
 
-    spm_memcpy(buffer, (char *)handle->invec_base[invec_idx] +
+    copy_iovec(handle, buffer, (char *)handle->invec_base[invec_idx] +
                                handle->invec_accessed[invec_idx], bytes);
 
     /* Update the data size read */
@@ -202,7 +224,7 @@ psa_status_t tfm_spm_partition_psa_write(psa_handle_t msg_handle, uint32_t outve
         tfm_core_panic();
     }
 
-    spm_memcpy((char *)handle->outvec_base[outvec_idx] +
+    copy_iovec(handle, (char *)handle->outvec_base[outvec_idx] +
                handle->outvec_written[outvec_idx], buffer, num_bytes);
 
     /* Update the data size written */
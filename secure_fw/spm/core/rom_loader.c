@@ -14,6 +14,7 @@
 #include "memory_symbols.h"
 #include "region_defs.h"
 #include "spm.h"
+#include "spm_partition_index.h"
 #include "tfm_hal_interrupt.h"
 #include "tfm_plat_defs.h"
 #include "utilities.h"
@@ -30,6 +31,26 @@ static uintptr_t part_pool_ea = PART_INFORAM_END;
 static uintptr_t serv_pool_sa = SERV_INFORAM_START;
 static uintptr_t serv_pool_ea = SERV_INFORAM_END;
 
+#if SPM_PARTITION_INDEX_NUM > 0
+/* Loaded partitions indexed by the generated partition index */
+static struct partition_t *partition_index_tbl[SPM_PARTITION_INDEX_NUM];
+#endif
+
+/* Get the generated index of a partition ID. */
+static uint32_t get_partition_index(int32_t pid)
+{
+#if SPM_PARTITION_INDEX_NUM > 0
+    if ((pid >= SPM_PARTITION_INDEX_PID_BASE) &&
+        (pid - SPM_PARTITION_INDEX_PID_BASE < SPM_PARTITION_INDEX_PID_RANGE)) {
+        return spm_pid_to_partition_index[pid - SPM_PARTITION_INDEX_PID_BASE];
+    }
+#else
+    (void)pid;
+#endif
+
+    return SPM_PARTITION_INDEX_INVALID;
+}
+
 /* Allocate runtime space for partition. Panic if pool runs out. */
 static struct partition_t *tfm_allocate_partition_assuredly(void)
 {
@@ -66,6 +87,7 @@ struct partition_t *load_a_partition_assuredly(struct partition_head_t *head)
     struct partition_t           *partition;
     int32_t client_id_base;
     int32_t client_id_limit;
+    uint32_t idx;
 
     if (!head) {
         tfm_core_panic();
@@ -121,6 +143,19 @@ struct partition_t *load_a_partition_assuredly(struct partition_head_t *head)
     partition = tfm_allocate_partition_assuredly();
     partition->p_ldinf = p_ptldinf;
 
+    /* Partitions not described by manifests are not indexed. */
+    idx = get_partition_index(p_ptldinf->pid);
+#if SPM_PARTITION_INDEX_NUM > 0
+    if (idx != SPM_PARTITION_INDEX_INVALID) {
+        if ((idx >= SPM_PARTITION_INDEX_NUM) || partition_index_tbl[idx]) {
+            tfm_core_panic();
+        }
+        partition_index_tbl[idx] = partition;
+    }
+#else
+    (void)idx;
+#endif
+
     ldinf_sa += LOAD_INFSZ_BYTES(p_ptldinf);
 
     UNI_LIST_INSERT_AFTER(head, partition, next);
@@ -128,6 +163,21 @@ struct partition_t *load_a_partition_assuredly(struct partition_head_t *head)
     return partition;
 }
 
+struct partition_t *load_get_indexed_partition(int32_t pid)
+{
+#if SPM_PARTITION_INDEX_NUM > 0
+    uint32_t idx = get_partition_index(pid);
+
+    if (idx < SPM_PARTITION_INDEX_NUM) {
+        return partition_index_tbl[idx];
+    }
+#else
+    (void)pid;
+#endif
+
+    return NULL;
+}
+
 uint32_t load_services_assuredly(struct partition_t *p_partition,
                                  struct service_head_t *services_listhead,
                                  struct service_t **stateless_services_ref_tbl,
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include "tfm_hal_spm_logdev.h"
+#include "tfm_sp_log_deferred.h"
+
+#if (SP_LOG_DEFERRED_BUF_SIZE & (SP_LOG_DEFERRED_BUF_SIZE - 1)) != 0
+#error "SP_LOG_DEFERRED_BUF_SIZE must be a power of two!"
+#endif
+
+#define SP_LOG_RING_MASK    (SP_LOG_DEFERRED_BUF_SIZE - 1)
+
+static char log_ring[SP_LOG_DEFERRED_BUF_SIZE];
+/* Free running positions, the ring holds the bytes between tail and head */
+static uint32_t log_head;
+static uint32_t log_tail;
+/* Number of strings dropped since the last drain */
+static uint32_t log_dropped;
+
+int32_t tfm_sp_log_deferred_write(const char *str, uint32_t len)
+{
+    uint32_t i;
+
+    if (len > SP_LOG_DEFERRED_BUF_SIZE - (log_head - log_tail)) {
+        log_dropped++;
+        return (int32_t)len;
+    }
+
+    for (i = 0; i < len; i++) {
+        log_ring[(log_head + i) & SP_LOG_RING_MASK] = str[i];
+    }
+    log_head += len;
+
+    return (int32_t)len;
+}
+
+static void output_dropped(void)
+{
+    static const char hex_digits[] = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                      '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+    char msg[] = "\r\n[SP log] dropped 0x00000000\r\n";
+    char *digit = &msg[sizeof(msg) - 4];
+    uint32_t value = log_dropped;
+
+    for (; value != 0; value >>= 4) {
+        *digit-- = hex_digits[value & 0xF];
+    }
+
+    tfm_hal_output_spm_log(msg, sizeof(msg) - 1);
+    log_dropped = 0;
+}
+
+uint32_t tfm_sp_log_deferred_drain(void)
+{
+    uint32_t pos = log_tail & SP_LOG_RING_MASK;
+    uint32_t len = log_head - log_tail;
+
+    if (log_dropped != 0) {
+        output_dropped();
+    }
+
+    /* Write the contiguous part of the ring, up to the drain size */
+    if (len > SP_LOG_DEFERRED_BUF_SIZE - pos) {
+        len = SP_LOG_DEFERRED_BUF_SIZE - pos;
+    }
+    if (len > SP_LOG_DEFERRED_DRAIN_SIZE) {
+        len = SP_LOG_DEFERRED_DRAIN_SIZE;
+    }
+
+    if (len != 0) {
+        tfm_hal_output_spm_log(&log_ring[pos], len);
+        log_tail += len;
+    }
+
+    return log_head - log_tail;
+}
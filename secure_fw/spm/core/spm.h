@@ -18,9 +18,11 @@
 #include "current.h"
 #include "tfm_arch.h"
 #include "lists.h"
+#include "pmu_counter.h"
 #include "runtime_defs.h"
 #include "thread.h"
 #include "psa/service.h"
+#include "tfm_spm_call_latency.h"
 #include "load/partition_defs.h"
 #include "load/interrupt_defs.h"
 
@@ -66,11 +68,15 @@
 #define GET_THRD_OWNER(x)        TO_CONTAINER(x, struct partition_t, thrd)
 #define GET_CTX_OWNER(x)         TO_CONTAINER(x, struct partition_t, ctx_ctrl)
 
+/* Get connection by its node in the message list of a partition */
+#define GET_LIST_CONNECTION(x)   TO_CONTAINER(x, struct connection_t, msg_node)
+
 /* Checks if the provided client ID is a non-secure client ID */
 #define TFM_CLIENT_ID_IS_NS(client_id)        ((client_id) < 0)
 
 /* RoT connection handle list */
 struct connection_t {
+    /* Read on every call, reply and scheduling of the message */
     uint32_t status;                         /*
                                               * Status of handle, three valid
                                               * options:
@@ -80,12 +86,23 @@ struct connection_t {
                                               */
     struct partition_t *p_client;            /* Caller partition               */
     const struct service_t *service;         /* RoT service pointer            */
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    struct bi_list_node_t msg_node;          /* Node in a partition msg list   */
+    uintptr_t reply_value;                   /* Result of this operation, if aynchronous */
+#endif
     psa_msg_t msg;                           /* PSA message body               */
+
+    /*
+     * Read by psa_read/skip/write, next to the vector sizes at the end of
+     * the message body.
+     */
     const void *invec_base[PSA_MAX_IOVEC];   /* Base addresses of invec from client */
     size_t invec_accessed[PSA_MAX_IOVEC];    /* Size of data accessed by psa_read/skip */
     void *outvec_base[PSA_MAX_IOVEC];        /* Base addresses of outvec from client */
     size_t outvec_written[PSA_MAX_IOVEC];    /* Size of data written by psa_write */
     psa_outvec *caller_outvec;               /* Save caller outvec pointer for write length update*/
+
+    /* Read on some paths only */
 #ifdef TFM_PARTITION_NS_AGENT_MAILBOX
     const void *client_data;                 /*
                                               * Pointer to the private data of the
@@ -96,16 +113,68 @@ struct connection_t {
 #if PSA_FRAMEWORK_HAS_MM_IOVEC
     uint32_t iovec_status;                   /* MM-IOVEC status                */
 #endif
-#if CONFIG_TFM_SPM_BACKEND_IPC == 1
-    struct connection_t *p_handles;          /* Handle(s) link                 */
-    uintptr_t reply_value;                   /* Result of this operation, if aynchronous */
+#if CONFIG_TFM_PARTITION_STATS == 1
+    uint32_t msg_cycles;                     /* Cycle count when the message was sent */
+#endif
+#if CONFIG_TFM_CALL_LATENCY == 1
+    bool     lat_sampled;                    /* Latency breakdown recorded     */
+    uint32_t lat_cycles;                     /*
+                                              * Cycle count at the SPM entry of
+                                              * the call, then at psa_get(),
+                                              * then at psa_reply() for RPC
+                                              */
+#endif
+};
+
+#if CONFIG_TFM_PARTITION_STATS == 1
+/* Statistics of the messages serviced by a service or a partition */
+struct spm_service_stats_t {
+    uint32_t calls;                 /* Messages received                  */
+    uint32_t max_cycles;            /* Longest time from message to reply */
+    uint64_t total_cycles;          /* Total time from message to reply   */
+#if CONFIG_TFM_SERVICE_LATENCY_BUDGET == 1
+    uint32_t overruns;              /* Replies later than the budget      */
+#endif
+};
+
+/* Runtime statistics of a partition */
+struct spm_partition_stats_t {
+    struct spm_service_stats_t msgs;        /* All the partition services  */
+    uint32_t switches;                      /* Times switched in           */
+    uint32_t switch_cycles;                 /* Cycle count at last switch  */
+    uint64_t run_cycles;                    /* Total time running          */
+    uint64_t blocked_cycles;                /*
+                                             * Total time from being switched
+                                             * out while waiting for signals to
+                                             * being switched in again
+                                             */
+    bool     blocked;                       /* Switched out while waiting  */
+#if CONFIG_TFM_PARTITION_PMU == 1
+    uint64_t pmu_events[SPM_PMU_EVENT_NUM]; /*
+                                             * PMU events counted while running,
+                                             * CONFIG_TFM_PMU_EVENT_0..3
+                                             */
 #endif
 };
+#endif
+
+/*
+ * The boundaries do not change after init, so whether the FLIH functions of a
+ * partition can run in the SPM boundary is decided once at init. Builds with
+ * FIH hardening keep checking it on each interrupt instead.
+ */
+#if (TFM_ISOLATION_LEVEL != 1) && (CONFIG_TFM_FLIH_API == 1) && \
+    !defined(TFM_FIH_PROFILE_ON)
+#define SPM_FLIH_BOUNDARY_AT_INIT
+#endif
 
 /* Partition runtime type */
 struct partition_t {
     const struct partition_load_info_t *p_ldinf;
     uintptr_t                          boundary;
+#ifdef SPM_FLIH_BOUNDARY_AT_INIT
+    bool                               flih_in_spm_boundary;
+#endif
     uint32_t                           signals_allowed;
     uint32_t                           signals_waiting;
     volatile uint32_t                  signals_asserted;
@@ -114,10 +183,29 @@ struct partition_t {
     struct context_ctrl_t              ctx_ctrl;
     struct thread_t                    thrd;            /* IPC model */
     uintptr_t                          reply_value;
+#if CONFIG_TFM_SPM_SHARED_STACKS == 1
+    struct partition_t                 *p_stack_next;   /* Ring of sharers */
+    uintptr_t                          thrd_sp_base;    /* Below metadata */
+    uint32_t                           stack_state;
+#endif
 #else
     uint32_t                           state;           /* SFN model */
 #endif
+#if CONFIG_TFM_PARTITION_STATS == 1
+    struct spm_partition_stats_t       stats;
+#endif
+#if CONFIG_TFM_CALL_LATENCY == 1
+    const struct service_t             *lat_service;    /* Replied, sampled */
+    uint32_t                           lat_reply_cycles;
+#endif
+#if CONFIG_TFM_SLIH_COALESCE_NUM > 0
+    uint32_t                           irq_events[CONFIG_TFM_SLIH_COALESCE_NUM];
+#endif
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    struct bi_list_node_t              msg_list;        /* Oldest first */
+#else
     struct connection_t                *p_handles;
+#endif
     struct partition_t                 *next;
 };
 
@@ -126,6 +214,15 @@ struct service_t {
     const struct service_load_info_t *p_ldinf;     /* Service load info      */
     struct partition_t *partition;                 /* Owner of the service   */
     struct service_t *next;                        /* For list operation     */
+#if CONFIG_TFM_PARTITION_STATS == 1
+    struct spm_service_stats_t stats;              /* Message statistics     */
+#endif
+#if CONFIG_TFM_SERVICE_LATENCY_BUDGET == 1
+    uint32_t latency_budget;                       /* Cycles, 0 for none     */
+#endif
+#if CONFIG_TFM_CALL_LATENCY == 1
+    struct spm_call_latency_t latency;             /* Sampled call phases    */
+#endif
 };
 
 /**
@@ -135,16 +232,53 @@ struct service_t {
  */
 int32_t tfm_spm_partition_get_running_partition_id(void);
 
+/* Usage statistics of a connection pool */
+struct spm_conn_pool_stats_t {
+    uint32_t in_use;                         /* Connections allocated now     */
+    uint32_t high_water;                     /* Peak of allocated connections */
+    uint32_t alloc_failures;                 /* Allocations failed for empty  */
+};
+
 /******************** Service handle management functions ********************/
 void spm_init_connection_space(void);
 
-struct connection_t *spm_allocate_connection(void);
+/*
+ * Allocate a connection for the given service. The connection comes from the
+ * dedicated slab of the service if it has one, or from the shared pool.
+ * It does not need to be called within a critical section.
+ */
+struct connection_t *spm_allocate_connection(const struct service_t *service);
 
 psa_status_t spm_validate_connection(const struct connection_t *p_connection);
 
 /* Panic if invalid connection is given. */
 void spm_free_connection(struct connection_t *p_connection);
 
+/* The cache replaces connections on the stack, which only SFN calls use */
+#if (CONFIG_TFM_SFN_CONN_CACHE_NUM > 0) && \
+    (CONFIG_TFM_SPM_BACKEND_IPC != 1) && \
+    (CONFIG_TFM_CONNECTION_BASED_SERVICE_API != 1)
+/*
+ * Get the cached connection of the current partition to the given service,
+ * ready for a stateless call by client_id. Returns NULL if the connection is
+ * in use, a connection then has to be allocated.
+ */
+struct connection_t *spm_get_cached_connection(const struct service_t *service,
+                                               int32_t client_id);
+#else
+#define spm_get_cached_connection(service, client_id)  NULL
+#endif
+
+/*
+ * Get the usage statistics of a connection pool. Index 0 is the shared pool,
+ * dedicated slabs follow in ascending order of their owner SIDs. The owner SID
+ * is 0 for the shared pool.
+ * Returns SPM_ERROR_BAD_PARAMETERS if 'idx' is out of range.
+ */
+psa_status_t spm_get_connection_pool_stats(uint32_t idx,
+                                           uint32_t *p_sid,
+                                           struct spm_conn_pool_stats_t *p_stats);
+
 /******************** Partition management functions *************************/
 
 #if CONFIG_TFM_SPM_BACKEND_IPC == 1
@@ -163,7 +297,7 @@ struct connection_t *spm_get_handle_by_signal(struct partition_t *p_ptn,
                                               psa_signal_t signal);
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC */
 
-#if CONFIG_TFM_DOORBELL_API == 1
+#if (CONFIG_TFM_DOORBELL_API == 1) || (CONFIG_TFM_PARTITION_STATS == 1)
 /**
  * \brief                   Get partition by Partition ID.
  *
@@ -174,7 +308,46 @@ struct connection_t *spm_get_handle_by_signal(struct partition_t *p_ptn,
  *                          \ref partition_t structures
  */
 struct partition_t *tfm_spm_get_partition_by_id(int32_t partition_id);
-#endif /* CONFIG_TFM_DOORBELL_API == 1 */
+#endif /* (CONFIG_TFM_DOORBELL_API == 1) || (CONFIG_TFM_PARTITION_STATS == 1) */
+
+#if CONFIG_TFM_PARTITION_STATS == 1
+/**
+ * \brief                   Get a snapshot of the statistics of a partition.
+ *
+ * \param[in]  partition_id The Partition ID of the partition
+ * \param[out] p_stats      Buffer to hold the statistics
+ *
+ * \retval PSA_SUCCESS              Success
+ * \retval PSA_ERROR_DOES_NOT_EXIST No partition with this ID
+ */
+psa_status_t spm_get_partition_stats(int32_t partition_id,
+                                     struct spm_partition_stats_t *p_stats);
+
+/**
+ * \brief                   Get a snapshot of the statistics of a service.
+ *
+ * \param[in]  sid          RoT Service identity
+ * \param[out] p_stats      Buffer to hold the statistics
+ *
+ * \retval PSA_SUCCESS              Success
+ * \retval PSA_ERROR_DOES_NOT_EXIST No service with this SID
+ */
+psa_status_t spm_get_service_stats(uint32_t sid,
+                                   struct spm_service_stats_t *p_stats);
+#endif /* CONFIG_TFM_PARTITION_STATS == 1 */
+
+#if CONFIG_TFM_CALL_LATENCY == 1
+/**
+ * \brief                   Count the duration of a phase of a sampled call in
+ *                          the histogram of its service.
+ *
+ * \param[in] p_service     The service called
+ * \param[in] phase         One of SPM_CALL_PHASE_*
+ * \param[in] cycles        Duration of the phase
+ */
+void spm_record_call_latency(const struct service_t *p_service,
+                             uint32_t phase, uint32_t cycles);
+#endif /* CONFIG_TFM_CALL_LATENCY == 1 */
 
 /**
  * \brief                   Get the service context by service ID.
@@ -251,6 +424,20 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
                                        const psa_invec     *inptr,
                                        psa_outvec          *outptr);
 
+/**
+ * \brief                   Reply to the message of a connection, as
+ *                          \ref tfm_spm_partition_psa_reply does, without
+ *                          converting and verifying a message handle.
+ *
+ * \param[in] p_connection  Connection of the message, which must be owned by
+ *                          the running partition.
+ * \param[in] status        Message result value to be reported to the client.
+ *
+ * \return                  The value to be returned to the client.
+ */
+psa_status_t spm_reply_connection(struct connection_t *p_connection,
+                                  psa_status_t status);
+
 /**
  * \brief                   Check the client version according to
  *                          version policy
@@ -5,9 +5,9 @@
  *
  */
 
-#include "critical_section.h"
 #include "internal_status_code.h"
 #include "spm.h"
+#include "tfm_hal_device_header.h"
 #include "tfm_pools.h"
 #include "load/service_defs.h"
 #include "private/assert.h"
@@ -16,127 +16,337 @@
 #error "CONFIG_TFM_CONN_HANDLE_MAX_NUM must be defined and not zero."
 #endif
 
-/* Pools */
-TFM_POOL_DECLARE(connection_pool, sizeof(struct connection_t),
-                 CONFIG_TFM_CONN_HANDLE_MAX_NUM);
+#if CONFIG_TFM_CONNECTION_SLABS == 1
+#include "spm_connection_slabs.h"
+#else
+#define SPM_CONNECTION_SLAB_NUM         0
+#define SPM_CONNECTION_SLAB_CONN_NUM    0
+#endif
+
+/*
+ * With a data cache, each connection starts on a cache line and takes whole
+ * lines, so that the fields read on every call share as few lines as possible
+ * and no line is shared by two connections.
+ */
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U) && \
+    defined(__SCB_DCACHE_LINE_SIZE)
+#define CONNECTION_ALIGNMENT            __SCB_DCACHE_LINE_SIZE
+#else
+#define CONNECTION_ALIGNMENT            4
+#endif
+#define CONNECTION_ALIGN_UP(x)                                              \
+    (((x) + CONNECTION_ALIGNMENT - 1) & ~(CONNECTION_ALIGNMENT - 1))
+
+/* Bytes taken by a pool holding 'num' connections */
+#define CONNECTION_CHUNK_SIZE                                               \
+    CONNECTION_ALIGN_UP(sizeof(struct connection_t) +                       \
+                        sizeof(struct tfm_pool_chunk_t))
+#define CONNECTION_DATA_SIZE                                                \
+    (CONNECTION_CHUNK_SIZE - sizeof(struct tfm_pool_chunk_t))
+#define CONNECTION_POOL_BUF_SIZE(num)                                       \
+    ((CONNECTION_CHUNK_SIZE * (num)) + sizeof(struct tfm_pool_instance_t))
+/* Pools follow each other in the buffer, each one on an aligned address */
+#define CONNECTION_POOL_SPACE(num)                                          \
+    CONNECTION_ALIGN_UP(CONNECTION_POOL_BUF_SIZE(num))
+
+/* Index of the pool shared by services without a dedicated slab */
+#define SHARED_POOL_IDX                 0
+#define CONNECTION_POOL_NUM             (SPM_CONNECTION_SLAB_NUM + 1)
+
+/*
+ * Pools
+ * The shared pool and the dedicated slabs are placed in one buffer so that
+ * any connection can be converted into a user handle by the same formula.
+ */
+static uint8_t connection_pool_buf[
+        CONNECTION_POOL_SPACE(CONFIG_TFM_CONN_HANDLE_MAX_NUM) +
+        (CONNECTION_CHUNK_SIZE * SPM_CONNECTION_SLAB_CONN_NUM) +
+        (CONNECTION_ALIGN_UP(sizeof(struct tfm_pool_instance_t)) *
+         SPM_CONNECTION_SLAB_NUM)]
+        __aligned(CONNECTION_ALIGNMENT);
+static struct tfm_pool_instance_t *connection_pool =
+                            (struct tfm_pool_instance_t *)connection_pool_buf;
+
+struct connection_pool_t {
+    struct tfm_pool_instance_t *pool;
+    uint32_t sid;                         /* Owner SID, unused by shared pool */
+    uint32_t first_slot;                  /* Slot of the first connection   */
+};
+
+static struct connection_pool_t connection_pools[CONNECTION_POOL_NUM];
+
+/*
+ * Slots
+ * Each connection of the pools has a slot, numbered across the pools in the
+ * order of the buffer. The slot keeps the address of the connection and a
+ * generation, which is incremented when the connection is allocated and when
+ * it is freed, so that it is odd while the connection is in use.
+ */
+#define CONNECTION_SLOT_NUM                                                 \
+    (CONFIG_TFM_CONN_HANDLE_MAX_NUM + SPM_CONNECTION_SLAB_CONN_NUM)
+
+struct connection_slot_t {
+    struct connection_t *p_connection;
+    uint32_t generation;
+};
+
+static struct connection_slot_t connection_slots[CONNECTION_SLOT_NUM];
 
 /*********************** Connection handle conversion APIs *******************/
 
-#define CONVERSION_FACTOR_BITOFFSET    3
-#define CONVERSION_FACTOR_VALUE        (1 << CONVERSION_FACTOR_BITOFFSET)
-/* Set 32 as the maximum */
-#define CONVERSION_FACTOR_VALUE_MAX    0x20
+/*
+ * A user handle holds the slot of the connection in its low bits and the
+ * generation of the slot at the allocation of the connection above them. It
+ * does not expose the address of the connection to the clients.
+ */
+#define HANDLE_SLOT_BIT_WIDTH          10
+#define HANDLE_SLOT_MASK               ((1UL << HANDLE_SLOT_BIT_WIDTH) - 1)
+/* Keep handles positive and clear of the static handle indicator */
+#define HANDLE_GEN_BIT_WIDTH           (STATIC_HANDLE_INDICATOR_OFFSET - 1 -  \
+                                        HANDLE_SLOT_BIT_WIDTH)
+#define HANDLE_GEN_MASK                ((1UL << HANDLE_GEN_BIT_WIDTH) - 1)
 
-#if CONVERSION_FACTOR_VALUE > CONVERSION_FACTOR_VALUE_MAX
-#error "CONVERSION FACTOR OUT OF RANGE"
+#if CONNECTION_SLOT_NUM > (1 << HANDLE_SLOT_BIT_WIDTH)
+#error "Too many connections for the connection handle slot bits."
 #endif
 
-static uint32_t loop_index;
+static struct connection_slot_t *get_slot_by_connection(
+                                    const struct connection_t *p_connection);
 
 /*
- * A connection instance connection_t allocated inside SPM is actually a memory
- * address among the connection pool. Return this connection to the client directly
- * exposes information of secure memory address. In this case, converting the
- * connection into another handle value does not represent the memory address
- * to avoid exposing secure memory directly to clients.
- *
- * This function converts the connection instance into another value by scaling
- * the connection in pool offset, the converted value is named as a user handle.
+ * This function converts the connection instance into a user handle.
  *
  * The formula:
- *  handle =      (p_connection - POOL_START) * CONVERSION_FACTOR_VALUE +
- *                CLIENT_HANDLE_VALUE_MIN + loop_index
+ *  handle =      ((generation << HANDLE_SLOT_BIT_WIDTH) | slot) +
+ *                CLIENT_HANDLE_VALUE_MIN
  * where:
- *  CONVERSION_FACTOR_VALUE = 1 << CONVERSION_FACTOR_BITOFFSET, and should not
- *  exceed CONVERSION_FACTOR_VALUE_MAX.
- *
- *  p_connection    in RANGE[POOL_START, POOL_END]
+ *  slot            in RANGE[0, CONNECTION_SLOT_NUM - 1]
+ *  generation      in RANGE[0, HANDLE_GEN_MASK], odd
  *  handle          in RANGE[CLIENT_HANDLE_VALUE_MIN, 0x3FFFFFFF]
- *  loop_index      in RANGE[0, CONVERSION_FACTOR_VALUE - 1]
  *
  *  note:
- *  loop_index is used to promise same connection instance is converted into
- *  different user handles in short time.
+ *  The generation changes each time the connection is allocated again, so
+ *  the handles of its previous uses are not valid any more.
  */
 psa_handle_t connection_to_handle(struct connection_t *p_connection)
 {
-    psa_handle_t handle;
+    const struct connection_slot_t *p_slot;
 
-    loop_index = (loop_index + 1) % CONVERSION_FACTOR_VALUE;
-    handle = (psa_handle_t)((((uintptr_t)p_connection -
-                  (uintptr_t)connection_pool) << CONVERSION_FACTOR_BITOFFSET) +
-                  CLIENT_HANDLE_VALUE_MIN + loop_index);
+    p_slot = get_slot_by_connection(p_connection);
+    if (!p_slot) {
+        tfm_core_panic();
+    }
 
-    return handle;
+    return (psa_handle_t)(((p_slot->generation << HANDLE_SLOT_BIT_WIDTH) |
+                           (uint32_t)(p_slot - connection_slots)) +
+                          CLIENT_HANDLE_VALUE_MIN);
 }
 
 /*
  * This function converts a user handle into a corresponded connection instance.
- * The converted value is validated before returning, an invalid handle instance
- * is returned as NULL.
- *
- * The formula:
- *  p_connection =    ((handle - CLIENT_HANDLE_VALUE_MIN) /
- *                    CONVERSION_FACTOR_VALUE) + POOL_START
- * where:
- *  CONVERSION_FACTOR_VALUE = 1 << CONVERSION_FACTOR_BITOFFSET, and should not
- *  exceed CONVERSION_FACTOR_VALUE_MAX.
- *
- *  p_connection    in RANGE[POOL_START, POOL_END]
- *  handle          in RANGE[CLIENT_HANDLE_VALUE_MIN, 0x3FFFFFFF]
- *  loop_index      in RANGE[0, CONVERSION_FACTOR_VALUE - 1]
+ * The handle is valid if its generation is the current one of its slot, which
+ * is odd only while the connection is allocated. An invalid handle, including
+ * the handle of a freed connection, is returned as NULL.
  */
 struct connection_t *handle_to_connection(psa_handle_t handle)
 {
-    struct connection_t *p_connection;
+    uint32_t value = (uint32_t)handle - CLIENT_HANDLE_VALUE_MIN;
+    uint32_t slot = value & HANDLE_SLOT_MASK;
+    uint32_t generation = value >> HANDLE_SLOT_BIT_WIDTH;
 
-    if (handle == PSA_NULL_HANDLE) {
+    if ((handle < CLIENT_HANDLE_VALUE_MIN) || (slot >= CONNECTION_SLOT_NUM) ||
+        ((generation & 1U) == 0) ||
+        (connection_slots[slot].generation != generation)) {
         return NULL;
     }
 
-    p_connection = (struct connection_t *)((((uintptr_t)handle -
-                    CLIENT_HANDLE_VALUE_MIN) >> CONVERSION_FACTOR_BITOFFSET) +
-                    (uintptr_t)connection_pool);
+    return connection_slots[slot].p_connection;
+}
 
-    return p_connection;
+/* Find the pool holding the given connection, NULL if none. */
+static struct connection_pool_t *get_pool_by_connection(
+                                    const struct connection_t *p_connection)
+{
+    uintptr_t addr = (uintptr_t)p_connection;
+    uintptr_t start;
+    uint32_t i;
+
+    for (i = 0; i < CONNECTION_POOL_NUM; i++) {
+        start = (uintptr_t)connection_pools[i].pool;
+        if ((addr >= start) && (addr < start + connection_pools[i].pool->pool_sz)) {
+            return &connection_pools[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Find the slot of the given connection, NULL if none. */
+static struct connection_slot_t *get_slot_by_connection(
+                                    const struct connection_t *p_connection)
+{
+    struct connection_pool_t *p_pool = get_pool_by_connection(p_connection);
+    uintptr_t offset;
+
+    if (!p_pool) {
+        return NULL;
+    }
+
+    offset = (uintptr_t)p_connection - (uintptr_t)p_pool->pool->chunks -
+             sizeof(struct tfm_pool_chunk_t);
+
+    return &connection_slots[p_pool->first_slot +
+                             (offset / CONNECTION_CHUNK_SIZE)];
+}
+
+/* Find the pool serving connections of the given service. */
+static struct connection_pool_t *get_pool_by_service(
+                                    const struct service_t *service)
+{
+#if SPM_CONNECTION_SLAB_NUM > 0
+    uint32_t i;
+
+    for (i = SHARED_POOL_IDX + 1; i < CONNECTION_POOL_NUM; i++) {
+        if (connection_pools[i].sid == service->p_ldinf->sid) {
+            return &connection_pools[i];
+        }
+    }
+#else
+    (void)service;
+#endif
+
+    return &connection_pools[SHARED_POOL_IDX];
+}
+
+static void init_pool_assuredly(struct connection_pool_t *p_pool,
+                                uint8_t *buf, uint32_t sid, size_t num,
+                                uint32_t first_slot)
+{
+    uint32_t i;
+
+    p_pool->pool = (struct tfm_pool_instance_t *)buf;
+    p_pool->sid = sid;
+    p_pool->first_slot = first_slot;
+
+    /* The first connection of the pool is on an aligned address */
+    SPM_ASSERT(((uintptr_t)buf + POOL_HEAD_SIZE) % CONNECTION_ALIGNMENT == 0);
+
+    if (tfm_pool_init(p_pool->pool, CONNECTION_POOL_BUF_SIZE(num),
+                      CONNECTION_DATA_SIZE, num) != PSA_SUCCESS) {
+        tfm_core_panic();
+    }
+
+    for (i = 0; i < num; i++) {
+        connection_slots[first_slot + i].p_connection =
+            (struct connection_t *)(p_pool->pool->chunks +
+                                    (i * CONNECTION_CHUNK_SIZE) +
+                                    sizeof(struct tfm_pool_chunk_t));
+    }
 }
 
 /* Service handle management functions */
 void spm_init_connection_space(void)
 {
-    if (tfm_pool_init(connection_pool,
-                      POOL_BUFFER_SIZE(connection_pool),
-                      sizeof(struct connection_t),
-                      CONFIG_TFM_CONN_HANDLE_MAX_NUM) != PSA_SUCCESS) {
+    uint8_t *buf = connection_pool_buf;
+    uint32_t slot = 0;
+#if SPM_CONNECTION_SLAB_NUM > 0
+    uint32_t i;
+#endif
+
+    init_pool_assuredly(&connection_pools[SHARED_POOL_IDX], buf, 0,
+                        CONFIG_TFM_CONN_HANDLE_MAX_NUM, slot);
+    buf += CONNECTION_POOL_SPACE(CONFIG_TFM_CONN_HANDLE_MAX_NUM);
+    slot += CONFIG_TFM_CONN_HANDLE_MAX_NUM;
+
+#if SPM_CONNECTION_SLAB_NUM > 0
+    for (i = 0; i < SPM_CONNECTION_SLAB_NUM; i++) {
+        init_pool_assuredly(&connection_pools[SHARED_POOL_IDX + 1 + i], buf,
+                            spm_conn_slab_sids[i], spm_conn_slab_sizes[i],
+                            slot);
+        buf += CONNECTION_POOL_SPACE(spm_conn_slab_sizes[i]);
+        slot += spm_conn_slab_sizes[i];
+    }
+#endif
+
+    if ((buf != connection_pool_buf + sizeof(connection_pool_buf)) ||
+        (slot != CONNECTION_SLOT_NUM)) {
         tfm_core_panic();
     }
 }
 
-struct connection_t *spm_allocate_connection(void)
+/* Move the slot to its next generation, odd when allocated, even when free */
+static void next_generation(struct connection_slot_t *p_slot)
 {
+    p_slot->generation = (p_slot->generation + 1) & HANDLE_GEN_MASK;
+}
+
+struct connection_t *spm_allocate_connection(const struct service_t *service)
+{
+    struct connection_t *p_connection;
+
+    SPM_ASSERT(service != NULL);
+
     /* Get buffer for handle list structure from handle pool */
-    return (struct connection_t *)tfm_pool_alloc(connection_pool);
+    p_connection = (struct connection_t *)
+                        tfm_pool_alloc(get_pool_by_service(service)->pool);
+    if (p_connection) {
+        next_generation(get_slot_by_connection(p_connection));
+    }
+
+    return p_connection;
 }
 
 psa_status_t spm_validate_connection(const struct connection_t *p_connection)
 {
-    /* Check the handle address is valid */
-    if (is_valid_chunk_data_in_pool(connection_pool,
-                                    (uint8_t *)p_connection) != true) {
+    /*
+     * The connections come from handle_to_connection(), which has checked the
+     * generation of the handle against the one of the connection slot.
+     */
+    if (p_connection == NULL) {
         return SPM_ERROR_GENERIC;
     }
 
+    SPM_ASSERT(is_valid_chunk_data_in_pool(
+                   get_pool_by_connection(p_connection)->pool,
+                   (uint8_t *)p_connection));
+
     return PSA_SUCCESS;
 }
 
 void spm_free_connection(struct connection_t *p_connection)
 {
-    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    struct connection_pool_t *p_pool;
 
     SPM_ASSERT(p_connection != NULL);
 
-    CRITICAL_SECTION_ENTER(cs_assert);
+    p_pool = get_pool_by_connection(p_connection);
+    if (!p_pool) {
+        tfm_core_panic();
+    }
+
+    /* Invalidate the handles of the connection before it can be reused */
+    next_generation(get_slot_by_connection(p_connection));
+
     /* Back handle buffer to pool */
-    tfm_pool_free(connection_pool, p_connection);
-    CRITICAL_SECTION_LEAVE(cs_assert);
+    tfm_pool_free(p_pool->pool, p_connection);
+}
+
+psa_status_t spm_get_connection_pool_stats(uint32_t idx,
+                                           uint32_t *p_sid,
+                                           struct spm_conn_pool_stats_t *p_stats)
+{
+    const struct tfm_pool_instance_t *pool;
+
+    if ((idx >= CONNECTION_POOL_NUM) || !p_sid || !p_stats) {
+        return SPM_ERROR_BAD_PARAMETERS;
+    }
+
+    pool = connection_pools[idx].pool;
+
+    *p_sid = connection_pools[idx].sid;
+    p_stats->in_use = pool->in_use;
+    p_stats->high_water = pool->high_water;
+    p_stats->alloc_failures = pool->alloc_failures;
+
+    return PSA_SUCCESS;
 }
@@ -32,6 +32,10 @@
 #include "lists.h"
 #include "tfm_pools.h"
 #include "region.h"
+#include "spm_service_index.h"
+#if CONFIG_TFM_SERVICE_LATENCY_BUDGET == 1
+#include "spm_latency_budgets.h"
+#endif
 #include "psa_manifest/pid.h"
 #include "ffm/backend.h"
 #include "load/partition_defs.h"
@@ -45,6 +49,17 @@
 static struct service_head_t services_listhead;
 struct service_t *stateless_services_ref_tbl[STATIC_HANDLE_NUM_LIMIT];
 
+#define SPM_INVALID_SERVICE_IDX         (~0U)
+
+#ifdef SPM_FLIH_BOUNDARY_AT_INIT
+extern uintptr_t spm_boundary;
+#endif
+
+#if SPM_SERVICE_NUM > 0
+/* Services ordered as the SIDs in the generated sorted SID list. */
+static struct service_t *sorted_services_ref_tbl[SPM_SERVICE_NUM];
+#endif
+
 /* Partition management functions */
 
 /* This API is only used in IPC backend. */
@@ -52,52 +67,123 @@ struct service_t *stateless_services_ref_tbl[STATIC_HANDLE_NUM_LIMIT];
 struct connection_t *spm_get_handle_by_signal(struct partition_t *p_ptn,
                                               psa_signal_t signal)
 {
-    struct connection_t *p_handle_iter;
-    struct connection_t **pr_handle_iter, **last_found_handle_holder = NULL;
+    struct bi_list_node_t *p_node;
+    struct connection_t *p_handle = NULL;
     struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
-    uint32_t nr_found_msgs = 0;
 
     CRITICAL_SECTION_ENTER(cs_assert);
 
-    /* Return the last found message which applies a FIFO mechanism. */
-    UNI_LIST_FOREACH_NODE_PNODE(pr_handle_iter, p_handle_iter,
-                                p_ptn, p_handles) {
-        if (p_handle_iter->service->p_ldinf->signal == signal) {
-            last_found_handle_holder = pr_handle_iter;
-            nr_found_msgs++;
+    /* Messages are queued in order, the first found is the oldest one. */
+    BI_LIST_FOR_EACH(p_node, &p_ptn->msg_list) {
+        if (GET_LIST_CONNECTION(p_node)->service->p_ldinf->signal == signal) {
+            break;
         }
     }
 
-    if (last_found_handle_holder) {
-        p_handle_iter = *last_found_handle_holder;
-        UNI_LIST_REMOVE_NODE_BY_PNODE(last_found_handle_holder, p_handles);
+    if (p_node != &p_ptn->msg_list) {
+        p_handle = GET_LIST_CONNECTION(p_node);
+        p_node = BI_LIST_NEXT_NODE(p_node);
+        BI_LIST_REMOVE_NODE(&p_handle->msg_node);
 
-        if (nr_found_msgs == 1) {
+        /* Keep the signal asserted while another message of it is queued */
+        while ((p_node != &p_ptn->msg_list) &&
+               (GET_LIST_CONNECTION(p_node)->service->p_ldinf->signal != signal)) {
+            p_node = BI_LIST_NEXT_NODE(p_node);
+        }
+
+        if (p_node == &p_ptn->msg_list) {
             p_ptn->signals_asserted &= ~signal;
         }
     }
 
     CRITICAL_SECTION_LEAVE(cs_assert);
 
-    return p_handle_iter;
+    return p_handle;
 }
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
 
-const struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
+/* Binary search the index of the given SID in the sorted SID list. */
+static uint32_t spm_get_service_index(uint32_t sid)
+{
+#if SPM_SERVICE_NUM > 0
+    uint32_t low = 0, high = SPM_SERVICE_NUM, mid;
+
+    while (low < high) {
+        mid = low + ((high - low) >> 1);
+
+        if (spm_sorted_sids[mid] == sid) {
+            return mid;
+        } else if (spm_sorted_sids[mid] < sid) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+#else
+    (void)sid;
+#endif
+
+    return SPM_INVALID_SERVICE_IDX;
+}
+
+/* Index the loaded services by SID. Panic if a SID is unknown or duplicated. */
+static void spm_index_services_assuredly(void)
+{
+    struct service_t *p_service;
+    uint32_t idx;
+
+    UNI_LIST_FOREACH(p_service, &services_listhead, next) {
+        idx = spm_get_service_index(p_service->p_ldinf->sid);
+        if (idx == SPM_INVALID_SERVICE_IDX) {
+            tfm_core_panic();
+        }
+
+#if SPM_SERVICE_NUM > 0
+        if (sorted_services_ref_tbl[idx]) {
+            tfm_core_panic();
+        }
+        sorted_services_ref_tbl[idx] = p_service;
+#endif
+    }
+}
+
+#if CONFIG_TFM_SERVICE_LATENCY_BUDGET == 1
+/* Set the latency budgets from the manifests. Panic if a SID is unknown. */
+static void spm_set_latency_budgets_assuredly(void)
 {
-    struct service_t *p_prev, *p_curr;
+#if SPM_LATENCY_BUDGET_NUM > 0
+    struct service_t *p_service;
+    uint32_t i;
 
-    UNI_LIST_FOREACH_NODE_PREV(p_prev, p_curr, &services_listhead, next) {
-        if (p_curr->p_ldinf->sid == sid) {
-            UNI_LIST_MOVE_AFTER(&services_listhead, p_prev, p_curr, next);
-            return p_curr;
+    for (i = 0; i < SPM_LATENCY_BUDGET_NUM; i++) {
+        p_service = (struct service_t *)tfm_spm_get_service_by_sid(
+                                                spm_latency_budget_sids[i]);
+        if (!p_service) {
+            tfm_core_panic();
         }
+        /* Like the statistics, the budget is set in the runtime data. */
+        p_service->latency_budget = spm_latency_budget_cycles[i];
     }
+#endif
+}
+#endif /* CONFIG_TFM_SERVICE_LATENCY_BUDGET == 1 */
+
+const struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
+{
+#if SPM_SERVICE_NUM > 0
+    uint32_t idx = spm_get_service_index(sid);
+
+    if (idx != SPM_INVALID_SERVICE_IDX) {
+        return sorted_services_ref_tbl[idx];
+    }
+#else
+    (void)sid;
+#endif
 
     return NULL;
 }
 
-#if CONFIG_TFM_DOORBELL_API == 1
+#if (CONFIG_TFM_DOORBELL_API == 1) || (CONFIG_TFM_PARTITION_STATS == 1)
 /**
  * \brief                   Get the partition context by partition ID.
  *
@@ -111,6 +197,12 @@ struct partition_t *tfm_spm_get_partition_by_id(int32_t partition_id)
 {
     struct partition_t *p_part;
 
+    p_part = load_get_indexed_partition(partition_id);
+    if (p_part) {
+        return p_part;
+    }
+
+    /* Partitions not described by manifests are not indexed. */
     UNI_LIST_FOREACH(p_part, PARTITION_LIST_ADDR, next) {
         if (p_part->p_ldinf->pid == partition_id) {
             return p_part;
@@ -119,7 +211,7 @@ struct partition_t *tfm_spm_get_partition_by_id(int32_t partition_id)
 
     return NULL;
 }
-#endif /* CONFIG_TFM_DOORBELL_API == 1 */
+#endif /* (CONFIG_TFM_DOORBELL_API == 1) || (CONFIG_TFM_PARTITION_STATS == 1) */
 
 int32_t tfm_spm_check_client_version(const struct service_t *service,
                                      uint32_t version)
@@ -185,7 +277,6 @@ psa_status_t spm_get_idle_connection(struct connection_t **p_connection,
     struct connection_t *connection;
     const struct service_t *service;
     uint32_t sid, version, index;
-    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
     bool ns_caller = tfm_spm_is_ns_caller();
 
     SPM_ASSERT(p_connection);
@@ -220,14 +311,15 @@ psa_status_t spm_get_idle_connection(struct connection_t **p_connection,
             return PSA_ERROR_PROGRAMMER_ERROR;
         }
 
-        CRITICAL_SECTION_ENTER(cs_assert);
-        connection = spm_allocate_connection();
-        CRITICAL_SECTION_LEAVE(cs_assert);
+        connection = spm_get_cached_connection(service, client_id);
         if (!connection) {
-            return PSA_ERROR_CONNECTION_BUSY;
-        }
+            connection = spm_allocate_connection(service);
+            if (!connection) {
+                return PSA_ERROR_CONNECTION_BUSY;
+            }
 
-        spm_init_idle_connection(connection, service, client_id);
+            spm_init_idle_connection(connection, service, client_id);
+        }
     } else {
 #if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
         connection = handle_to_connection(handle);
@@ -365,6 +457,9 @@ uint32_t tfm_spm_init(void)
     struct partition_t *partition;
     uint32_t service_setting;
     fih_int fih_rc = FIH_FAILURE;
+#ifdef SPM_FLIH_BOUNDARY_AT_INIT
+    FIH_RET_TYPE(bool) fih_bool;
+#endif
 
     spm_init_connection_space();
 
@@ -395,9 +490,22 @@ uint32_t tfm_spm_init(void)
             tfm_core_panic();
         }
 
+#ifdef SPM_FLIH_BOUNDARY_AT_INIT
+        FIH_CALL(tfm_hal_boundary_need_switch, fih_bool,
+                 spm_boundary, partition->boundary);
+        partition->flih_in_spm_boundary =
+                                    fih_eq(fih_bool, fih_int_encode(false));
+#endif
+
         backend_init_comp_assuredly(partition, service_setting);
     }
 
+    spm_index_services_assuredly();
+
+#if CONFIG_TFM_SERVICE_LATENCY_BUDGET == 1
+    spm_set_latency_budgets_assuredly();
+#endif
+
     return backend_system_run();
 }
 
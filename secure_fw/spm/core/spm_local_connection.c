@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
 #include "compiler_ext_defs.h"
+#include "critical_section.h"
 #include "internal_status_code.h"
 #include "spm.h"
 #include "tfm_arch.h"
@@ -21,6 +22,29 @@
 #define CONNECTION_SIZE        ((sizeof(struct connection_t) + 7) & ~0x7)
 #define FIXED_STATIC_HANDLE    ((psa_handle_t)0x1000)
 
+#if CONFIG_TFM_SFN_CONN_CACHE_NUM > 0
+/*
+ * Connections kept initialized for the latest pairs of client partition and
+ * service. Their handles follow the fixed one and do not change, so a call
+ * through a cached connection only writes the client ID and the parameters.
+ */
+#define CACHED_HANDLE_BASE     (FIXED_STATIC_HANDLE + 1)
+
+#define CONN_CACHE_INDEX(service, client)                                  \
+            ((((uintptr_t)(service) >> 2) ^ ((uintptr_t)(client) >> 2)) %  \
+             CONFIG_TFM_SFN_CONN_CACHE_NUM)
+
+static struct connection_t conn_cache[CONFIG_TFM_SFN_CONN_CACHE_NUM];
+/* A cached connection in use is not taken by nested calls or interrupts */
+static bool conn_cache_busy[CONFIG_TFM_SFN_CONN_CACHE_NUM];
+
+static inline bool is_cached_connection(const struct connection_t *p_connection)
+{
+    return (p_connection >= &conn_cache[0]) &&
+           (p_connection < &conn_cache[CONFIG_TFM_SFN_CONN_CACHE_NUM]);
+}
+#endif
+
 static inline struct connection_t *alloc_conn_from_stack_top(void)
 {
     uint32_t stack_top = tfm_arch_get_psplim();
@@ -50,7 +74,13 @@ static inline void free_conn_from_stack_top(void)
  */
 psa_handle_t connection_to_handle(struct connection_t *p_connection)
 {
+#if CONFIG_TFM_SFN_CONN_CACHE_NUM > 0
+    if (is_cached_connection(p_connection)) {
+        return CACHED_HANDLE_BASE + (psa_handle_t)(p_connection - conn_cache);
+    }
+#else
     (void)p_connection;
+#endif
 
     return FIXED_STATIC_HANDLE;
 }
@@ -59,6 +89,13 @@ struct connection_t *handle_to_connection(psa_handle_t handle)
 {
     struct connection_t *p_connection;
 
+#if CONFIG_TFM_SFN_CONN_CACHE_NUM > 0
+    if ((handle >= CACHED_HANDLE_BASE) &&
+        (handle < CACHED_HANDLE_BASE + CONFIG_TFM_SFN_CONN_CACHE_NUM)) {
+        return &conn_cache[handle - CACHED_HANDLE_BASE];
+    }
+#endif
+
     if (handle != FIXED_STATIC_HANDLE) {
         return NULL;
     }
@@ -79,20 +116,67 @@ void spm_init_connection_space(void)
      */
 }
 
-struct connection_t *spm_allocate_connection(void)
+struct connection_t *spm_allocate_connection(const struct service_t *service)
 {
+    (void)service;
+
     return alloc_conn_from_stack_top();
 }
 
+#if CONFIG_TFM_SFN_CONN_CACHE_NUM > 0
+struct connection_t *spm_get_cached_connection(const struct service_t *service,
+                                               int32_t client_id)
+{
+    struct partition_t *p_client = GET_CURRENT_COMPONENT();
+    uint32_t idx = CONN_CACHE_INDEX(service, p_client);
+    struct connection_t *p_connection = &conn_cache[idx];
+    struct critical_section_t cs_cache = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_cache);
+    if (conn_cache_busy[idx]) {
+        CRITICAL_SECTION_LEAVE(cs_cache);
+        return NULL;
+    }
+    conn_cache_busy[idx] = true;
+    CRITICAL_SECTION_LEAVE(cs_cache);
+
+    if ((p_connection->service != service) ||
+        (p_connection->p_client != p_client)) {
+        spm_init_idle_connection(p_connection, service, client_id);
+        return p_connection;
+    }
+
+    /*
+     * The service, the client and the handle are still the ones set by the
+     * previous call, the vectors are written by the call itself.
+     */
+    p_connection->msg.client_id = client_id;
+    p_connection->msg.rhandle = NULL;
+    p_connection->status = TFM_HANDLE_STATUS_IDLE;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC
+    p_connection->iovec_status = 0;
+#endif
+
+    return p_connection;
+}
+#endif /* CONFIG_TFM_SFN_CONN_CACHE_NUM > 0 */
+
 psa_status_t spm_validate_connection(const struct connection_t *p_connection)
 {
-    /* Connection address is always calculated from PSPLIM. No need to validate here. */
+    /* Connection address is always calculated from PSPLIM or the cache index. No need to validate here. */
     return PSA_SUCCESS;
 }
 
 void spm_free_connection(struct connection_t *p_connection)
 {
+#if CONFIG_TFM_SFN_CONN_CACHE_NUM > 0
+    if (is_cached_connection(p_connection)) {
+        conn_cache_busy[p_connection - conn_cache] = false;
+        return;
+    }
+#else
     (void)p_connection;
+#endif
 
     free_conn_from_stack_top();
 }
@@ -54,3 +54,38 @@ int32_t spm_log_msgval(const char *msg, size_t len, uint32_t value)
     }
     return (result_msg + result_val);
 }
+
+#ifdef TFM_SPM_LOG_TOKENIZED
+#define TOKEN_RECORD_MSG    0x1E
+#define TOKEN_RECORD_MSGVAL 0x1F
+
+static void put_le32(uint32_t value, char buf[])
+{
+    int i;
+
+    for (i = 0; i < 4; i++, value >>= 8) {
+        buf[i] = (char)(value & 0xFF);
+    }
+}
+
+int32_t spm_log_token(uint32_t token)
+{
+    char record[5];
+
+    record[0] = TOKEN_RECORD_MSG;
+    put_le32(token, &record[1]);
+
+    return tfm_hal_output_spm_log(record, sizeof(record));
+}
+
+int32_t spm_log_token_val(uint32_t token, uint32_t value)
+{
+    char record[9];
+
+    record[0] = TOKEN_RECORD_MSGVAL;
+    put_le32(token, &record[1]);
+    put_le32(value, &record[5]);
+
+    return tfm_hal_output_spm_log(record, sizeof(record));
+}
+#endif /* TFM_SPM_LOG_TOKENIZED */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "critical_section.h"
+#include "cycle_counter.h"
+#include "tfm_spm_trace.h"
+
+#ifndef SPM_TRACE_GET_TIMESTAMP
+#define SPM_TRACE_GET_TIMESTAMP() SPM_GET_CYCLES()
+#endif
+
+static struct spm_trace_event_t trace_events[SPM_TRACE_EVENT_NUM];
+static uint32_t trace_event_cnt;
+
+void spm_trace_record(uint16_t event, int32_t partition_id, uint32_t param)
+{
+    struct critical_section_t cs_trace = CRITICAL_SECTION_STATIC_INIT;
+    struct spm_trace_event_t *p_event;
+
+    CRITICAL_SECTION_ENTER(cs_trace);
+
+    p_event = &trace_events[trace_event_cnt % SPM_TRACE_EVENT_NUM];
+    p_event->timestamp = SPM_TRACE_GET_TIMESTAMP();
+    p_event->event = event;
+    p_event->partition_id = (uint16_t)partition_id;
+    p_event->param = param;
+
+    trace_event_cnt++;
+
+    CRITICAL_SECTION_LEAVE(cs_trace);
+}
+
+size_t spm_trace_read(uint32_t seq, struct spm_trace_event_t *p_events,
+                      size_t num, uint32_t *p_seq)
+{
+    struct critical_section_t cs_trace = CRITICAL_SECTION_STATIC_INIT;
+    size_t i;
+
+    CRITICAL_SECTION_ENTER(cs_trace);
+
+    /* Skip the events which were overwritten already. */
+    if ((trace_event_cnt - seq) > SPM_TRACE_EVENT_NUM) {
+        seq = trace_event_cnt - SPM_TRACE_EVENT_NUM;
+    }
+
+    for (i = 0; (i < num) && (seq != trace_event_cnt); i++, seq++) {
+        p_events[i] = trace_events[seq % SPM_TRACE_EVENT_NUM];
+    }
+
+    CRITICAL_SECTION_LEAVE(cs_trace);
+
+    if (p_seq) {
+        *p_seq = seq;
+    }
+
+    return i;
+}
@@ -7,10 +7,12 @@
 
 #include <stdint.h>
 #include "ffm/backend.h"
+#include "psa/error.h"
 #include "stack_watermark.h"
 #include "lists.h"
 #include "load/spm_load_api.h"
 #include "spm.h"
+#include "spm_partition_index.h"
 #include "tfm_spm_log.h"
 
 /* Always output, regardless of log level.
@@ -59,3 +61,65 @@ void dump_used_stacks(void)
         SPMLOG_VAL("    Stack bytes used: ", used_stack(p_pt));
     }
 }
+
+psa_status_t get_stack_watermark(int32_t partition_id, uint32_t *p_size,
+                                 uint32_t *p_used)
+{
+    struct partition_t *p_pt;
+
+    if (!p_size || !p_used) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    UNI_LIST_FOREACH(p_pt, PARTITION_LIST_ADDR, next) {
+        if (p_pt->p_ldinf->pid == partition_id) {
+            *p_size = p_pt->p_ldinf->stack_size;
+            *p_used = used_stack(p_pt);
+            return PSA_SUCCESS;
+        }
+    }
+
+    return PSA_ERROR_DOES_NOT_EXIST;
+}
+
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+#if SPM_PARTITION_INDEX_NUM > 0
+/* Largest stack use printed so far for each partition with a manifest */
+static uint32_t reported_stack_used[SPM_PARTITION_INDEX_NUM];
+#endif
+static uint32_t reported_conn_high_water;
+
+void report_usage_growth(const struct partition_t *p_pt)
+{
+    struct spm_conn_pool_stats_t conn_stats;
+    uint32_t sid;
+
+#if SPM_PARTITION_INDEX_NUM > 0
+    uint32_t pid = (uint32_t)p_pt->p_ldinf->pid;
+    uint32_t idx = SPM_PARTITION_INDEX_INVALID;
+    uint32_t used;
+
+    /* Built-in partitions have no manifest to size their stack */
+    if ((pid >= SPM_PARTITION_INDEX_PID_BASE) &&
+        (pid - SPM_PARTITION_INDEX_PID_BASE < SPM_PARTITION_INDEX_PID_RANGE)) {
+        idx = spm_pid_to_partition_index[pid - SPM_PARTITION_INDEX_PID_BASE];
+    }
+
+    if (idx != SPM_PARTITION_INDEX_INVALID) {
+        used = used_stack((struct partition_t *)p_pt);
+        if (used > reported_stack_used[idx]) {
+            reported_stack_used[idx] = used;
+            SPMLOG_VAL("[Sizing] Partition id: ", pid);
+            SPMLOG_VAL("[Sizing]   Stack bytes used: ", used);
+        }
+    }
+#endif
+
+    /* Only the shared pool is sized by CONFIG_TFM_CONN_HANDLE_MAX_NUM */
+    if ((spm_get_connection_pool_stats(0, &sid, &conn_stats) == PSA_SUCCESS) &&
+        (conn_stats.high_water > reported_conn_high_water)) {
+        reported_conn_high_water = conn_stats.high_water;
+        SPMLOG_VAL("[Sizing] Connections used: ", conn_stats.high_water);
+    }
+}
+#endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
@@ -13,9 +13,37 @@
 #ifdef CONFIG_TFM_STACK_WATERMARKS
 void watermark_stack(struct partition_t *p_pt);
 void dump_used_stacks(void);
+
+/*
+ * Get the stack high-water mark of a partition, computed from the watermark
+ * the same way as the dump. Callable at runtime from privileged code.
+ *
+ * Parameters:
+ *      partition_id - The Partition ID of the partition
+ *      p_size       - Returns the stack size in bytes
+ *      p_used       - Returns the bytes of stack used so far
+ *
+ * Returns PSA_SUCCESS, PSA_ERROR_INVALID_ARGUMENT for NULL outputs, or
+ * PSA_ERROR_DOES_NOT_EXIST if no partition has this ID.
+ */
+psa_status_t get_stack_watermark(int32_t partition_id, uint32_t *p_size,
+                                 uint32_t *p_used);
+
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+/*
+ * Print the stack use of a partition and the peak of allocated connections
+ * when they exceed the values printed before, with the "[Sizing]" prefix
+ * that tools/tfm_config_autosize.py looks for. Called when a partition
+ * replies to a message, after it served the request.
+ */
+void report_usage_growth(const struct partition_t *p_pt);
+#else
+#define report_usage_growth(p_pt)
+#endif
 #else
 #define watermark_stack(p_pt)
 #define dump_used_stacks()
+#define report_usage_growth(p_pt)
 #endif
 
 #endif /* __STACK_WATERMARK_H__ */
@@ -43,6 +43,28 @@
  */
 static uint32_t is_boot_data_valid = BOOT_DATA_INVALID;
 
+#ifdef BOOT_DATA_AVAILABLE
+/*!
+ * \struct boot_data_index_entry
+ *
+ * \brief Locates the TLVs of a major type in the shared data area, so that a
+ *        request only walks the part of the area holding them.
+ */
+struct boot_data_index_entry {
+    uint16_t first;     /* Offset of the first TLV, 0 if there is none */
+    uint16_t end;       /* Offset of the end of the last TLV */
+    uint16_t len;       /* Size of the TLVs, including their headers */
+};
+
+/*!
+ * \var boot_data_index
+ *
+ * \brief Index of the shared data area by major type, built once when the
+ *        area is validated.
+ */
+static struct boot_data_index_entry boot_data_index[MAJOR_MASK + 1];
+#endif /* BOOT_DATA_AVAILABLE */
+
 /*!
  * \struct boot_data_access_policy
  *
@@ -129,12 +151,38 @@ void tfm_core_validate_boot_data(void)
 {
 #ifdef BOOT_DATA_AVAILABLE
     struct tfm_boot_data *boot_data;
+    struct shared_data_tlv_entry tlv_entry;
+    struct boot_data_index_entry *index;
+    uint32_t offset, next_offset;
 
     boot_data = (struct tfm_boot_data *)BOOT_TFM_SHARED_DATA_BASE;
 
-    if (boot_data->header.tlv_magic == SHARED_DATA_TLV_INFO_MAGIC) {
-        is_boot_data_valid = BOOT_DATA_VALID;
+    if (boot_data->header.tlv_magic != SHARED_DATA_TLV_INFO_MAGIC) {
+        return;
+    }
+
+    for (offset = SHARED_DATA_HEADER_SIZE;
+         offset + SHARED_DATA_ENTRY_HEADER_SIZE <= boot_data->header.tlv_tot_len;
+         offset = next_offset) {
+        /* Create local copy to avoid unaligned access */
+        (void)spm_memcpy(&tlv_entry,
+                         (const void *)(BOOT_TFM_SHARED_DATA_BASE + offset),
+                         SHARED_DATA_ENTRY_HEADER_SIZE);
+
+        next_offset = offset + SHARED_DATA_ENTRY_HEADER_SIZE + tlv_entry.tlv_len;
+        if (next_offset > boot_data->header.tlv_tot_len) {
+            break;
+        }
+
+        index = &boot_data_index[GET_MAJOR(tlv_entry.tlv_type) & MAJOR_MASK];
+        if (index->first == 0) {
+            index->first = (uint16_t)offset;
+        }
+        index->end = (uint16_t)next_offset;
+        index->len += (uint16_t)(next_offset - offset);
     }
+
+    is_boot_data_valid = BOOT_DATA_VALID;
 #else
     is_boot_data_valid = BOOT_DATA_VALID;
 #endif /* BOOT_DATA_AVAILABLE */
@@ -149,6 +197,7 @@ void tfm_core_get_boot_data_handler(uint32_t args[])
 #ifdef BOOT_DATA_AVAILABLE
     uint8_t *ptr;
     struct shared_data_tlv_entry tlv_entry;
+    const struct boot_data_index_entry *index;
     uintptr_t tlv_end, offset;
     size_t next_tlv_offset;
 #endif /* BOOT_DATA_AVAILABLE */
@@ -175,10 +224,16 @@ void tfm_core_get_boot_data_handler(uint32_t args[])
     }
 
 #ifdef BOOT_DATA_AVAILABLE
-    /* Get the boundaries of TLV section */
-    boot_data = (struct tfm_boot_data *)BOOT_TFM_SHARED_DATA_BASE;
-    tlv_end = BOOT_TFM_SHARED_DATA_BASE + boot_data->header.tlv_tot_len;
-    offset  = BOOT_TFM_SHARED_DATA_BASE + SHARED_DATA_HEADER_SIZE;
+    /* Get the boundaries of the TLVs of the major type */
+    index = &boot_data_index[tlv_major & MAJOR_MASK];
+    tlv_end = BOOT_TFM_SHARED_DATA_BASE + index->end;
+    offset  = BOOT_TFM_SHARED_DATA_BASE + index->first;
+
+    /* Check buffer overflow */
+    if (SHARED_DATA_HEADER_SIZE + (size_t)index->len > buf_size) {
+        args[0] = (uint32_t)PSA_ERROR_INVALID_ARGUMENT;
+        return;
+    }
 #endif /* BOOT_DATA_AVAILABLE */
 
     /* Add header to output buffer as well */
@@ -193,8 +248,15 @@ void tfm_core_get_boot_data_handler(uint32_t args[])
 
 #ifdef BOOT_DATA_AVAILABLE
     ptr = boot_data->data;
-    /* Iterates over the TLV section and copy TLVs with requested major
-     * type to the provided buffer.
+    if (index->len == index->end - index->first) {
+        /* The TLVs of the major type are contiguous, copy them at once */
+        (void)spm_memcpy(ptr, (const void *)offset, index->len);
+        boot_data->header.tlv_tot_len += index->len;
+        offset = tlv_end;
+    }
+
+    /* Iterates over the part of the TLV section holding the requested major
+     * type and copy its TLVs to the provided buffer.
      */
     for (; offset < tlv_end; offset += next_tlv_offset) {
         /* Create local copy to avoid unaligned access */
@@ -204,12 +266,6 @@ void tfm_core_get_boot_data_handler(uint32_t args[])
         next_tlv_offset = SHARED_DATA_ENTRY_HEADER_SIZE + tlv_entry.tlv_len;
 
         if (GET_MAJOR(tlv_entry.tlv_type) == tlv_major) {
-            /* Check buffer overflow */
-            if (((ptr - buf_start) + next_tlv_offset) > buf_size) {
-                args[0] = (uint32_t)PSA_ERROR_INVALID_ARGUMENT;
-                return;
-            }
-
             (void)spm_memcpy(ptr, (const void *)offset, next_tlv_offset);
             ptr += next_tlv_offset;
             boot_data->header.tlv_tot_len += next_tlv_offset;
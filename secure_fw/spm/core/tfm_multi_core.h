@@ -90,6 +90,18 @@ void tfm_get_secure_mem_region_attr(const void *p, size_t s,
 void tfm_get_ns_mem_region_attr(const void *p, size_t s,
                                 struct mem_attr_info_t *p_attr);
 
+/**
+ * \brief Build the tables of the memory regions searched by the memory access
+ *        checks, from the system memory region layout and symbol addresses.
+ *
+ * \return SPM_SUCCESS if the tables are built, or were built already,
+ *         SPM_ERROR_GENERIC if the regions of a table overlap.
+ *
+ * \note The tables are built by the first memory access check if this function
+ *       is not called before.
+ */
+int32_t tfm_multi_core_mem_check_init(void);
+
 /**
  * \brief Check whether a memory access is allowed to access to a memory range
  *
@@ -128,6 +140,21 @@ int32_t check_address_range(const void *p, size_t s,
                             uintptr_t region_start,
                             uintptr_t region_limit);
 
+/**
+ * \brief Register a non-secure buffer pool for PSA client call payloads.
+ *
+ * \param[in] base            The base address of the buffer pool.
+ * \param[in] size            The size of the buffer pool in bytes.
+ *
+ * \return SPM_SUCCESS if the pool is non-secure read-write memory and no pool
+ *         has been registered before, SPM_ERROR_GENERIC otherwise.
+ *
+ * \note Memory ranges inside the registered pool pass
+ *       \ref tfm_has_access_to_region for non-secure access without
+ *       retrieving the memory region attributes again.
+ */
+int32_t tfm_multi_core_register_ns_shm(const void *base, size_t size);
+
 /**
  * \brief Register a non-secure client ID range.
  *
@@ -13,6 +13,7 @@
 #include "psa/service.h"
 #include "internal_status_code.h"
 #include "cmsis_compiler.h"
+#include "critical_section.h"
 #include "utilities.h"
 #include "private/assert.h"
 #include "lists.h"
@@ -56,6 +57,107 @@ psa_status_t tfm_pool_init(struct tfm_pool_instance_t *pool, size_t poolsz,
     return PSA_SUCCESS;
 }
 
+#if TFM_POOL_LOCK_FREE == 1
+/* Pop the first free chunk. The monitor is cleared by any exception taken. */
+static struct tfm_pool_chunk_t *pop_free_chunk(struct tfm_pool_instance_t *pool)
+{
+    volatile uint32_t *p_head = (volatile uint32_t *)&pool->next;
+    struct tfm_pool_chunk_t *node;
+
+    do {
+        node = (struct tfm_pool_chunk_t *)__LDREXW(p_head);
+        if (node == NULL) {
+            __CLREX();
+            return NULL;
+        }
+    } while (__STREXW((uint32_t)node->next, p_head) != 0);
+
+    return node;
+}
+
+static void push_free_chunk(struct tfm_pool_instance_t *pool,
+                            struct tfm_pool_chunk_t *node)
+{
+    volatile uint32_t *p_head = (volatile uint32_t *)&pool->next;
+
+    do {
+        node->next = (struct tfm_pool_chunk_t *)__LDREXW(p_head);
+    } while (__STREXW((uint32_t)node, p_head) != 0);
+}
+
+/* Add 'delta' to the counter and return the new value. */
+static uint32_t counter_add(volatile uint32_t *p_cnt, int32_t delta)
+{
+    uint32_t val;
+
+    do {
+        val = __LDREXW(p_cnt) + (uint32_t)delta;
+    } while (__STREXW(val, p_cnt) != 0);
+
+    return val;
+}
+
+/* Raise the counter to 'val' if it is smaller. */
+static void counter_max(volatile uint32_t *p_cnt, uint32_t val)
+{
+    do {
+        if (__LDREXW(p_cnt) >= val) {
+            __CLREX();
+            return;
+        }
+    } while (__STREXW(val, p_cnt) != 0);
+}
+#else /* TFM_POOL_LOCK_FREE == 1 */
+static struct tfm_pool_chunk_t *pop_free_chunk(struct tfm_pool_instance_t *pool)
+{
+    struct critical_section_t cs_pool = CRITICAL_SECTION_STATIC_INIT;
+    struct tfm_pool_chunk_t *node = NULL;
+
+    CRITICAL_SECTION_ENTER(cs_pool);
+    if (!UNI_LIST_IS_EMPTY(pool, next)) {
+        node = UNI_LIST_NEXT_NODE(pool, next);
+        UNI_LIST_REMOVE_NODE(pool, node, next);
+    }
+    CRITICAL_SECTION_LEAVE(cs_pool);
+
+    return node;
+}
+
+static void push_free_chunk(struct tfm_pool_instance_t *pool,
+                            struct tfm_pool_chunk_t *node)
+{
+    struct critical_section_t cs_pool = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_pool);
+    UNI_LIST_INSERT_AFTER(pool, node, next);
+    CRITICAL_SECTION_LEAVE(cs_pool);
+}
+
+static uint32_t counter_add(volatile uint32_t *p_cnt, int32_t delta)
+{
+    struct critical_section_t cs_pool = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t val;
+
+    CRITICAL_SECTION_ENTER(cs_pool);
+    val = *p_cnt + (uint32_t)delta;
+    *p_cnt = val;
+    CRITICAL_SECTION_LEAVE(cs_pool);
+
+    return val;
+}
+
+static void counter_max(volatile uint32_t *p_cnt, uint32_t val)
+{
+    struct critical_section_t cs_pool = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_pool);
+    if (*p_cnt < val) {
+        *p_cnt = val;
+    }
+    CRITICAL_SECTION_LEAVE(cs_pool);
+}
+#endif /* TFM_POOL_LOCK_FREE == 1 */
+
 void *tfm_pool_alloc(struct tfm_pool_instance_t *pool)
 {
     struct tfm_pool_chunk_t *node;
@@ -64,15 +166,16 @@ void *tfm_pool_alloc(struct tfm_pool_instance_t *pool)
         return NULL;
     }
 
-    if (UNI_LIST_IS_EMPTY(pool, next)) {
+    node = pop_free_chunk(pool);
+    if (node == NULL) {
+        (void)counter_add(&pool->alloc_failures, 1);
         return NULL;
     }
 
-    node = UNI_LIST_NEXT_NODE(pool, next);
-    UNI_LIST_REMOVE_NODE(pool, node, next);
-
     node->magic = POOL_MAGIC_ALLOCATED;
 
+    counter_max(&pool->high_water, counter_add(&pool->in_use, 1));
+
     return &(((struct tfm_pool_chunk_t *)node)->data);
 }
 
@@ -87,12 +190,17 @@ void tfm_pool_free(struct tfm_pool_instance_t *pool, void *ptr)
 
     pchunk->magic = 0;
 
-    UNI_LIST_INSERT_AFTER(pool, pchunk, next);
-
-    /* In debug builds, overwrite the data to catch use-after-free bugs. */
+    /*
+     * In debug builds, overwrite the data to catch use-after-free bugs. Do it
+     * before the chunk gets back to the list as others may allocate it then.
+     */
 #ifndef NDEBUG
     spm_memset(pchunk->data, 0xFF, pool->chunksz);
 #endif
+
+    (void)counter_add(&pool->in_use, -1);
+
+    push_free_chunk(pool, pchunk);
 }
 
 bool is_valid_chunk_data_in_pool(struct tfm_pool_instance_t *pool,
@@ -26,9 +26,25 @@ struct tfm_pool_instance_t {
     struct tfm_pool_chunk_t *next;        /* Point to the first free node   */
     size_t chunksz;                       /* Chunks size of pool member     */
     size_t pool_sz;                       /* Pool size in bytes             */
+    volatile uint32_t in_use;             /* Number of allocated chunks     */
+    volatile uint32_t high_water;         /* Peak number of allocated chunks */
+    volatile uint32_t alloc_failures;     /* Allocations failed for no chunk */
     uint8_t chunks[];                     /* Data indicator                 */
 };
 
+/*
+ * Pool operations are safe to be called from both thread and interrupt
+ * contexts without holding a critical section. Exclusive accesses keep the
+ * free list consistent on architectures supporting them, the others mask
+ * interrupts only for the few instructions updating the free list.
+ */
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+#define TFM_POOL_LOCK_FREE                    1
+#else
+#define TFM_POOL_LOCK_FREE                    0
+#endif
+
 /*
  * This will declares a static memory pool variable with chunk memory.
  * Parameters:
@@ -17,9 +17,11 @@
 #include "tfm_arch.h"
 #include "tfm_svcalls.h"
 #include "tfm_boot_data.h"
+#include "tfm_hal_cache.h"
 #include "tfm_hal_platform.h"
 #include "tfm_hal_isolation.h"
 #include "tfm_hal_spm_logdev.h"
+#include "tfm_sp_log_deferred.h"
 #include "tfm_core_trustzone.h"
 #include "utilities.h"
 #include "ffm/backend.h"
@@ -142,6 +144,66 @@ static void init_spm_func_context(psa_api_svc_func_t svc_func, uint32_t *ctx)
     arch_update_process_sp(sp, sp_limit);
 }
 
+#if CONFIG_TFM_SVC_HANDLER_MODE_API == 1
+#define HANDLER_MODE_API(svc_number)    (1UL << ((svc_number) & TFM_SVC_NUM_INDEX_MSK))
+
+/*
+ * The PSA APIs which never block and don't wake another partition up. They
+ * finish in the SVC handler, without the context of thread mode SPM.
+ */
+static const uint32_t handler_mode_api_mask =
+    HANDLER_MODE_API(TFM_SVC_PSA_FRAMEWORK_VERSION) |
+    HANDLER_MODE_API(TFM_SVC_PSA_VERSION)           |
+    HANDLER_MODE_API(TFM_SVC_PSA_GET)               |
+    HANDLER_MODE_API(TFM_SVC_PSA_SET_RHANDLE)       |
+    HANDLER_MODE_API(TFM_SVC_PSA_SKIP)              |
+    HANDLER_MODE_API(TFM_SVC_PSA_CLEAR)             |
+    HANDLER_MODE_API(TFM_SVC_PSA_EOI)               |
+    HANDLER_MODE_API(TFM_SVC_PSA_LIFECYCLE)         |
+    HANDLER_MODE_API(TFM_SVC_PSA_IRQ_ENABLE)        |
+    HANDLER_MODE_API(TFM_SVC_PSA_IRQ_DISABLE)       |
+    HANDLER_MODE_API(TFM_SVC_PSA_RESET_SIGNAL);
+
+static bool is_handler_mode_api(uint8_t svc_number, const uint32_t *ctx)
+{
+    /*
+     * psa_read() and psa_write() only when the copy is short, as the
+     * interrupts of lower priority than SVC wait for it.
+     */
+    if ((svc_number == TFM_SVC_PSA_READ) || (svc_number == TFM_SVC_PSA_WRITE)) {
+        return ctx[3] <= CONFIG_TFM_SVC_HANDLER_MODE_COPY_MAX;
+    }
+
+    return (handler_mode_api_mask & HANDLER_MODE_API(svc_number)) != 0;
+}
+
+static uint32_t handler_mode_spm_call(psa_api_svc_func_t svc_func, uint32_t *ctx,
+                                      uint32_t exc_return)
+{
+    fih_int fih_rc = FIH_FAILURE;
+    FIH_RET_TYPE(bool) fih_bool;
+    struct partition_t *p_curr_sp = GET_CURRENT_COMPONENT();
+    uint32_t result;
+
+    (void)backend_abi_entering_spm();
+
+    result = (uint32_t)svc_func(ctx[0], ctx[1], ctx[2], ctx[3]);
+
+    FIH_CALL(tfm_hal_boundary_need_switch, fih_bool, spm_boundary, p_curr_sp->boundary);
+    if (fih_not_eq(fih_bool, fih_int_encode(false))) {
+        FIH_CALL(tfm_hal_activate_boundary, fih_rc,
+                 p_curr_sp->p_ldinf, p_curr_sp->boundary);
+        if (fih_not_eq(fih_rc, fih_int_encode(TFM_HAL_SUCCESS))) {
+            tfm_core_panic();
+        }
+    }
+
+    ctx[0] = backend_abi_leaving_spm(result);
+
+    return exc_return;
+}
+#endif /* CONFIG_TFM_SVC_HANDLER_MODE_API == 1 */
+
 static int32_t prepare_to_thread_mode_spm(uint8_t svc_number, uint32_t *ctx, uint32_t exc_return)
 {
     fih_int fih_rc = FIH_FAILURE;
@@ -179,6 +241,12 @@ static int32_t prepare_to_thread_mode_spm(uint8_t svc_number, uint32_t *ctx, uin
         }
     }
 
+#if CONFIG_TFM_SVC_HANDLER_MODE_API == 1
+    if (is_handler_mode_api(svc_number, ctx)) {
+        return handler_mode_spm_call(svc_func, ctx, exc_return);
+    }
+#endif
+
     init_spm_func_context(svc_func, ctx);
 
     ctx[0] = PSA_SUCCESS;
@@ -195,10 +263,13 @@ bool tfm_svc_thread_mode_spm_active(void)
 static uint32_t handle_spm_svc_requests(uint32_t svc_number, uint32_t exc_return,
                                         uint32_t *svc_args, uint32_t *msp)
 {
-#if TFM_SP_LOG_RAW_ENABLED
+#if TFM_SP_LOG_RAW_ENABLED || (CONFIG_TFM_CACHE_MAINTENANCE_API == 1)
     struct partition_t *curr_partition;
     fih_int fih_rc = FIH_FAILURE;
 #endif
+#if CONFIG_TFM_CACHE_MAINTENANCE_API == 1
+    enum tfm_hal_status_t hal_status;
+#endif
 
     switch (svc_number) {
     case TFM_SVC_SPM_INIT:
@@ -228,12 +299,52 @@ static uint32_t handle_spm_svc_requests(uint32_t svc_number, uint32_t exc_return
         FIH_CALL(tfm_hal_memory_check, fih_rc, curr_partition->boundary, (uintptr_t)svc_args[0],
                 svc_args[1], TFM_HAL_ACCESS_READABLE);
         if (fih_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+#ifdef TFM_SP_LOG_DEFERRED
+            svc_args[0] = tfm_sp_log_deferred_write((const char *)svc_args[0], svc_args[1]);
+#else
             svc_args[0] = tfm_hal_output_spm_log((const char *)svc_args[0], svc_args[1]);
+#endif
         } else {
             tfm_core_panic();
         }
         break;
 #endif
+#ifdef TFM_SP_LOG_DEFERRED
+    case TFM_SVC_DRAIN_SP_LOG:
+        svc_args[0] = tfm_sp_log_deferred_drain();
+        break;
+#endif
+#if (CONFIG_TFM_SECURE_THREAD_MASK_NS_INTERRUPT == 1) && defined(CONFIG_TFM_USE_TRUSTZONE)
+    case TFM_SVC_PREEMPTION_POINT_OPEN:
+        /* The pending NS interrupts are taken on the return to the caller */
+        if (__get_BASEPRI() == SECURE_THREAD_EXECUTION_PRIORITY) {
+            __set_BASEPRI(SECURE_THREAD_PREEMPTION_PRIORITY);
+        }
+        break;
+    case TFM_SVC_PREEMPTION_POINT_CLOSE:
+        if (__get_BASEPRI() == SECURE_THREAD_PREEMPTION_PRIORITY) {
+            __set_BASEPRI(SECURE_THREAD_EXECUTION_PRIORITY);
+        }
+        break;
+#endif
+#if CONFIG_TFM_CACHE_MAINTENANCE_API == 1
+    case TFM_SVC_CACHE_CLEAN:
+    case TFM_SVC_CACHE_INVALIDATE:
+        /* A partition maintains the cache over its own buffers only */
+        curr_partition = GET_CURRENT_COMPONENT();
+        FIH_CALL(tfm_hal_memory_check, fih_rc, curr_partition->boundary, (uintptr_t)svc_args[0],
+                svc_args[1], TFM_HAL_ACCESS_READWRITE);
+        if (!fih_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+            tfm_core_panic();
+        }
+        if (svc_number == TFM_SVC_CACHE_CLEAN) {
+            hal_status = tfm_hal_cache_clean((uintptr_t)svc_args[0], svc_args[1]);
+        } else {
+            hal_status = tfm_hal_cache_invalidate((uintptr_t)svc_args[0], svc_args[1]);
+        }
+        svc_args[0] = (hal_status == TFM_HAL_SUCCESS) ? PSA_SUCCESS : PSA_ERROR_INVALID_ARGUMENT;
+        break;
+#endif
 #if TFM_ISOLATION_LEVEL > 1
     case TFM_SVC_THREAD_MODE_SPM_RETURN:
         exc_return = thread_mode_spm_return(svc_args[0]);
@@ -247,7 +358,7 @@ static uint32_t handle_spm_svc_requests(uint32_t svc_number, uint32_t exc_return
     return exc_return;
 }
 
-uint32_t spm_svc_handler(uint32_t *msp, uint32_t exc_return, uint32_t *psp)
+SPM_RAM_CODE uint32_t spm_svc_handler(uint32_t *msp, uint32_t exc_return, uint32_t *psp)
 {
     uint8_t svc_number = TFM_SVC_PSA_FRAMEWORK_VERSION;
     uint32_t *svc_args = msp;
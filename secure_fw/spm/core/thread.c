@@ -8,7 +8,9 @@
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
+#include "config_spm.h"
 #include "thread.h"
 #include "tfm_arch.h"
 #include "utilities.h"
@@ -20,53 +22,120 @@ struct thread_t *p_curr_thrd;
 
 /* Force ZERO in case ZI(bss) clear is missing. */
 static struct thread_t *p_thrd_head = NULL; /* Point to the first thread. */
-static struct thread_t *p_rnbl_head = NULL; /* Point to the first runnable. */
+
+/*
+ * Priority buckets. Each bucket covers a range of priority values and points
+ * to the first (highest priority) thread of that range in the sorted thread
+ * list. A set bit in the ready bitmap means the bucket may contain runnable
+ * threads. The most significant bit represents the highest priority bucket,
+ * so the next bucket to check is given by counting the leading zeros.
+ */
+static struct thread_t *p_bkt_head[THRD_PRIOR_BUCKET_NUM];
+/* The link pointing to the first thread of each bucket, in the list */
+static struct thread_t **pp_bkt_link[THRD_PRIOR_BUCKET_NUM];
+static uint32_t rdy_bitmap = 0;
 
 /* Define Macro to fetch global to support future expansion (PERCPU e.g.) */
 #define LIST_HEAD   p_thrd_head
-#define RNBL_HEAD   p_rnbl_head
+#define BKT_HEAD    p_bkt_head
+#define BKT_LINK    pp_bkt_link
+#define RDY_BITMAP  rdy_bitmap
+
+#define BUCKET_BIT(bkt)     (1UL << (THRD_PRIOR_BUCKET_NUM - 1 - (bkt)))
 
 /* Callback function pointer for thread to query current state. */
 static thrd_query_state_t query_state_cb = (thrd_query_state_t)NULL;
 
+#if CONFIG_TFM_THRD_ROUND_ROBIN == 1
+static void rotate_by_prior(struct thread_t **pp_link, struct thread_t *node);
+#endif
+
 void thrd_set_query_callback(thrd_query_state_t fn)
 {
     query_state_cb = fn;
 }
 
-struct thread_t *thrd_next(void)
+SPM_RAM_CODE struct thread_t *thrd_next(void)
 {
-    struct thread_t *p_thrd = RNBL_HEAD;
+    struct thread_t *p_thrd = NULL;
+    struct thread_t **pp_link;
     uint32_t retval = 0;
+    uint32_t bkt;
     struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
 
     CRITICAL_SECTION_ENTER(cs_signal);
-    /*
-     * First runnable thread has highest priority since threads are
-     * sorted by priority.
-     */
-    while (p_thrd) {
-        /* Change thread state if any signal changed */
-        p_thrd->state = query_state_cb(p_thrd, &retval);
-
-        if (p_thrd->state == THRD_STATE_RET_VAL_AVAIL) {
-            tfm_arch_set_context_ret_code(p_thrd->p_context_ctrl, retval);
-            p_thrd->state = THRD_STATE_RUNNABLE;
+
+    while (RDY_BITMAP != 0) {
+        bkt = __CLZ(RDY_BITMAP);
+        p_thrd = BKT_HEAD[bkt];
+        pp_link = BKT_LINK[bkt];
+
+        /* Threads inside one bucket are still sorted by priority. */
+        while (p_thrd && (THRD_PRIOR_TO_BUCKET(p_thrd->priority) == bkt)) {
+            /*
+             * Change thread state if any signal changed. A blocked thread
+             * can only turn runnable once woken by thrd_mark_ready().
+             */
+            if ((p_thrd->state != THRD_STATE_BLOCK) ||
+                (p_thrd->flags & THRD_FLAG_WOKEN)) {
+                p_thrd->flags &= ~THRD_FLAG_WOKEN;
+                p_thrd->state = query_state_cb(p_thrd, &retval);
+            }
+
+            if (p_thrd->state == THRD_STATE_RET_VAL_AVAIL) {
+                tfm_arch_set_context_ret_code(p_thrd->p_context_ctrl, retval);
+                p_thrd->state = THRD_STATE_RUNNABLE;
+            }
+
+            if (p_thrd->state == THRD_STATE_RUNNABLE) {
+                break;
+            }
+
+            pp_link = &p_thrd->next;
+            p_thrd = p_thrd->next;
         }
 
-        if (p_thrd->state == THRD_STATE_RUNNABLE) {
+        if (p_thrd && (THRD_PRIOR_TO_BUCKET(p_thrd->priority) == bkt)) {
+#if CONFIG_TFM_THRD_ROUND_ROBIN == 1
+            /*
+             * Let the other threads with the same priority go first at the
+             * next scheduling.
+             */
+            rotate_by_prior(pp_link, p_thrd);
+#endif
             break;
         }
 
-        p_thrd = p_thrd->next;
+        /*
+         * None of the threads in this bucket is runnable. Skip the bucket
+         * until a thread inside it is marked as ready again.
+         */
+        RDY_BITMAP &= ~BUCKET_BIT(bkt);
+        p_thrd = NULL;
     }
+
     CRITICAL_SECTION_LEAVE(cs_signal);
 
     return p_thrd;
 }
 
+/* Set the link pointing to the first thread of each bucket. */
+static void update_bucket_links(void)
+{
+    struct thread_t **pp_iter = &LIST_HEAD;
+
+    while (*pp_iter) {
+        if (BKT_HEAD[THRD_PRIOR_TO_BUCKET((*pp_iter)->priority)] == *pp_iter) {
+            BKT_LINK[THRD_PRIOR_TO_BUCKET((*pp_iter)->priority)] = pp_iter;
+        }
+        pp_iter = &(*pp_iter)->next;
+    }
+}
+
 static void insert_by_prior(struct thread_t **head, struct thread_t *node)
 {
+    uint32_t bkt = THRD_PRIOR_TO_BUCKET(node->priority);
+
     if (*head == NULL || (node->priority <= (*head)->priority)) {
         node->next = *head;
         *head = node;
@@ -80,8 +149,80 @@ static void insert_by_prior(struct thread_t **head, struct thread_t *node)
         node->next = iter->next;
         iter->next = node;
     }
+
+    /* The new node goes before any thread with the same priority. */
+    if ((BKT_HEAD[bkt] == NULL) ||
+        (node->priority <= BKT_HEAD[bkt]->priority)) {
+        BKT_HEAD[bkt] = node;
+    }
+
+    update_bucket_links();
+}
+
+/* Unlink a node from the list, return false if it is not in the list. */
+static bool remove_from_list(struct thread_t *node)
+{
+    struct thread_t **pp_iter = &LIST_HEAD;
+    uint32_t bkt = THRD_PRIOR_TO_BUCKET(node->priority);
+
+    while (*pp_iter && (*pp_iter != node)) {
+        pp_iter = &(*pp_iter)->next;
+    }
+
+    if (*pp_iter == NULL) {
+        return false;
+    }
+
+    *pp_iter = node->next;
+
+    if (BKT_HEAD[bkt] == node) {
+        if (node->next &&
+            (THRD_PRIOR_TO_BUCKET(node->next->priority) == bkt)) {
+            BKT_HEAD[bkt] = node->next;
+        } else {
+            BKT_HEAD[bkt] = NULL;
+        }
+    }
+
+    update_bucket_links();
+
+    return true;
 }
 
+#if CONFIG_TFM_THRD_ROUND_ROBIN == 1
+/*
+ * Move a node behind the other nodes with the same priority. The node is
+ * unlinked through the link pointing to it, the scan of thrd_next() having
+ * just passed it.
+ */
+static void rotate_by_prior(struct thread_t **pp_link, struct thread_t *node)
+{
+    struct thread_t *iter = node->next;
+    uint32_t bkt = THRD_PRIOR_TO_BUCKET(node->priority);
+
+    if (!iter || (iter->priority != node->priority)) {
+        return;
+    }
+
+    while (iter->next && (iter->next->priority == node->priority)) {
+        iter = iter->next;
+    }
+
+    *pp_link = node->next;
+    if (BKT_HEAD[bkt] == node) {
+        BKT_HEAD[bkt] = node->next;
+    }
+
+    node->next = iter->next;
+    iter->next = node;
+
+    /* The first node of the following bucket is now linked by this node. */
+    if (node->next && (THRD_PRIOR_TO_BUCKET(node->next->priority) != bkt)) {
+        BKT_LINK[THRD_PRIOR_TO_BUCKET(node->next->priority)] = &node->next;
+    }
+}
+#endif
+
 void thrd_start(struct thread_t *p_thrd, thrd_fn_t fn, thrd_fn_t exit_fn, void *param)
 {
     SPM_ASSERT(p_thrd != NULL);
@@ -102,18 +243,47 @@ void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state)
 
     p_thrd->state = new_state;
 
-    /*
-     * Set first runnable thread as head to reduce enumerate
-     * depth while searching for a first runnable thread.
-     */
-    if ((p_thrd->state == THRD_STATE_RUNNABLE) &&
-        ((RNBL_HEAD == NULL) || (p_thrd->priority < RNBL_HEAD->priority))) {
-        RNBL_HEAD = p_thrd;
-    } else {
-        RNBL_HEAD = LIST_HEAD;
+    if (p_thrd->state == THRD_STATE_RUNNABLE) {
+        thrd_mark_ready(p_thrd);
     }
 }
 
+void thrd_mark_ready(struct thread_t *p_thrd)
+{
+    SPM_ASSERT(p_thrd != NULL);
+
+    p_thrd->flags |= THRD_FLAG_WOKEN;
+    RDY_BITMAP |= BUCKET_BIT(THRD_PRIOR_TO_BUCKET(p_thrd->priority));
+}
+
+void thrd_set_priority(struct thread_t *p_thrd, uint8_t priority)
+{
+    struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
+
+    SPM_ASSERT(p_thrd != NULL);
+
+    if (p_thrd->priority == priority) {
+        return;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_signal);
+
+    if (!remove_from_list(p_thrd)) {
+        /* Not started yet, thrd_start() inserts it with the new priority. */
+        p_thrd->priority = priority;
+        CRITICAL_SECTION_LEAVE(cs_signal);
+        return;
+    }
+
+    p_thrd->priority = priority;
+    insert_by_prior(&LIST_HEAD, p_thrd);
+
+    /* The thread may be runnable, let thrd_next() check its new bucket. */
+    thrd_mark_ready(p_thrd);
+
+    CRITICAL_SECTION_LEAVE(cs_signal);
+}
+
 uint32_t thrd_start_scheduler(struct thread_t **ppth)
 {
     struct thread_t *pth = thrd_next();
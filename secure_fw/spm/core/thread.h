@@ -24,6 +24,9 @@
 #define THRD_STATE_INVALID        4
 #define THRD_STATE_RET_VAL_AVAIL  5
 
+/* Flags */
+#define THRD_FLAG_WOKEN           0x1 /* Blocked thread to be queried again */
+
 /* Priorities. Lower value has higher priority */
 #define THRD_PRIOR_HIGHEST        0x0
 #define THRD_PRIOR_HIGH           0xF
@@ -31,6 +34,15 @@
 #define THRD_PRIOR_LOW            0x7F
 #define THRD_PRIOR_LOWEST         0xFF
 
+/*
+ * Priority buckets for the ready bitmap. Priority values are grouped into 32
+ * buckets, each covering 8 consecutive values, so that the predefined
+ * priorities above fall into different buckets.
+ */
+#define THRD_PRIOR_BUCKET_NUM     32
+#define THRD_PRIOR_BUCKET_SHIFT   3
+#define THRD_PRIOR_TO_BUCKET(p)   ((uint32_t)(p) >> THRD_PRIOR_BUCKET_SHIFT)
+
 /* Error codes */
 #define THRD_SUCCESS              0
 #define THRD_ERR_GENERIC          1
@@ -106,7 +118,7 @@ extern struct thread_t *p_curr_thrd;
 void thrd_set_query_callback(thrd_query_state_t fn);
 
 /*
- * Set thread state, and updates the runnable head.
+ * Set thread state, and updates the ready bitmap.
  *
  * Parameters :
  *  p_thrd         -     Pointer of thread_t struct
@@ -114,6 +126,32 @@ void thrd_set_query_callback(thrd_query_state_t fn);
  */
 void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state);
 
+/*
+ * Mark the given thread, and its priority bucket, as possibly runnable, so
+ * that it is checked by the next thrd_next() call. The state of a blocked
+ * thread is only queried again after it is marked.
+ *
+ * Parameters :
+ *  p_thrd         -     Pointer of thread_t struct
+ *
+ * Note :
+ *  - Call it whenever a thread may turn runnable, like when any of the signals
+ *    it is waiting for gets asserted.
+ *  - The caller needs to ensure it is called within a critical section.
+ */
+void thrd_mark_ready(struct thread_t *p_thrd);
+
+/*
+ * Change the priority of a thread and move it to its new position in the
+ * schedulable list. Unlike THRD_SET_PRIORITY, the new priority takes effect
+ * at the next thrd_next() call.
+ *
+ * Parameters :
+ *  p_thrd         -     Pointer of thread_t struct
+ *  priority       -     Priority value (0~255)
+ */
+void thrd_set_priority(struct thread_t *p_thrd, uint8_t priority);
+
 /*
  * Prepare thread context with given info and insert it into schedulable list.
  *
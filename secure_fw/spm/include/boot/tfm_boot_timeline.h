@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_BOOT_TIMELINE_H__
+#define __TFM_BOOT_TIMELINE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The boot timeline is a ring of (stage, event, timestamp) records which is
+ * written by every boot stage (BL1_1, BL1_2, BL2) and by the SPM while it
+ * initialises. It is stored in a RAM region which is preserved across the boot
+ * stages and is defined by the platform in region_defs.h:
+ *  - BOOT_TIMELINE_BASE: start address of the region, 4 bytes aligned.
+ *  - BOOT_TIMELINE_SIZE: size of the region in bytes.
+ *
+ * The timestamps are taken from the DWT cycle counter on Armv7-M / Armv8-M
+ * Mainline cores. A platform can provide its own timestamp source by defining
+ * BOOT_TIMELINE_GET_TIMESTAMP() in region_defs.h.
+ *
+ * All the recording macros compile to nothing unless TFM_BOOT_TIMELINE is
+ * defined.
+ */
+
+/* Boot stages */
+#define BOOT_TIMELINE_STAGE_BL1_1   0x01
+#define BOOT_TIMELINE_STAGE_BL1_2   0x02
+#define BOOT_TIMELINE_STAGE_BL2     0x03
+#define BOOT_TIMELINE_STAGE_SPM     0x04
+
+/* Events recorded by the boot stages */
+#define BOOT_TIMELINE_EVENT_STAGE_START         0x00
+#define BOOT_TIMELINE_EVENT_PLATFORM_INIT_DONE  0x01
+/* The parameter of the image load events is the image ID */
+#define BOOT_TIMELINE_EVENT_IMAGE_LOAD_START    0x02
+#define BOOT_TIMELINE_EVENT_IMAGE_LOAD_DONE     0x03
+#define BOOT_TIMELINE_EVENT_STAGE_END           0x04
+
+/* Magic value which marks a valid boot timeline header */
+#define BOOT_TIMELINE_MAGIC 0xB007714E
+
+/**
+ * Boot timeline record. All fields in little endian.
+ *
+ *    ---------------------------------------------
+ *    | stage(8) | event(8) |      param(16)      |
+ *    ---------------------------------------------
+ *    |               timestamp(32)               |
+ *    ---------------------------------------------
+ */
+struct boot_timeline_record {
+    uint8_t  stage;
+    uint8_t  event;
+    uint16_t param;
+    uint32_t timestamp;
+};
+
+/**
+ * \struct boot_timeline
+ *
+ * \brief Header of the boot timeline region, followed by the records.
+ *
+ * \note record_cnt is the total number of records written since the timeline
+ *       was reset. Once it exceeds the capacity of the region the oldest
+ *       records are overwritten, and the record with index
+ *       (record_cnt % capacity) is the oldest one still available.
+ */
+struct boot_timeline {
+    uint32_t magic;
+    uint32_t record_cnt;
+    struct boot_timeline_record records[];
+};
+
+#ifdef TFM_BOOT_TIMELINE
+#include "region_defs.h"
+
+#if !defined(BOOT_TIMELINE_BASE) || !defined(BOOT_TIMELINE_SIZE)
+#error "TFM_BOOT_TIMELINE requires the platform to define BOOT_TIMELINE_BASE and BOOT_TIMELINE_SIZE"
+#endif
+
+#define BOOT_TIMELINE_CAPACITY \
+    ((BOOT_TIMELINE_SIZE - sizeof(struct boot_timeline)) / \
+     sizeof(struct boot_timeline_record))
+
+#ifndef BOOT_TIMELINE_GET_TIMESTAMP
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+/* Architectural addresses of the debug registers used for the cycle counter */
+#define BOOT_TIMELINE_DEMCR      (*(volatile uint32_t *)0xE000EDFCUL)
+#define BOOT_TIMELINE_DWT_CTRL   (*(volatile uint32_t *)0xE0001000UL)
+#define BOOT_TIMELINE_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004UL)
+
+static inline uint32_t boot_timeline_get_timestamp(void)
+{
+    /* Enable the DWT and its cycle counter, which keeps running across the
+     * boot stages once enabled.
+     */
+    if (!(BOOT_TIMELINE_DWT_CTRL & 0x1UL)) {
+        BOOT_TIMELINE_DEMCR |= 0x1UL << 24;
+        BOOT_TIMELINE_DWT_CTRL |= 0x1UL;
+    }
+
+    return BOOT_TIMELINE_DWT_CYCCNT;
+}
+#define BOOT_TIMELINE_GET_TIMESTAMP() boot_timeline_get_timestamp()
+#else
+#define BOOT_TIMELINE_GET_TIMESTAMP() 0U
+#endif
+#endif /* !BOOT_TIMELINE_GET_TIMESTAMP */
+
+/**
+ * \brief Discards all the records of the boot timeline. Called by the first
+ *        boot stage of the chain.
+ */
+static inline void boot_timeline_reset(void)
+{
+    struct boot_timeline *timeline = (struct boot_timeline *)BOOT_TIMELINE_BASE;
+
+    timeline->record_cnt = 0;
+    timeline->magic = BOOT_TIMELINE_MAGIC;
+}
+
+/**
+ * \brief Appends a record to the boot timeline.
+ *
+ * \param[in] stage  Boot stage, one of BOOT_TIMELINE_STAGE_*
+ * \param[in] event  Event, one of BOOT_TIMELINE_EVENT_*
+ * \param[in] param  Event specific parameter
+ */
+static inline void boot_timeline_record(uint8_t stage, uint8_t event,
+                                        uint16_t param)
+{
+    struct boot_timeline *timeline = (struct boot_timeline *)BOOT_TIMELINE_BASE;
+    struct boot_timeline_record *record;
+
+    if (timeline->magic != BOOT_TIMELINE_MAGIC) {
+        boot_timeline_reset();
+    }
+
+    record = &timeline->records[timeline->record_cnt % BOOT_TIMELINE_CAPACITY];
+    record->timestamp = BOOT_TIMELINE_GET_TIMESTAMP();
+    record->stage = stage;
+    record->event = event;
+    record->param = param;
+
+    timeline->record_cnt++;
+}
+
+#define BOOT_TIMELINE_RESET()                     boot_timeline_reset()
+#define BOOT_TIMELINE_RECORD(stage, event, param) \
+                                     boot_timeline_record(stage, event, param)
+#else
+#define BOOT_TIMELINE_RESET()
+#define BOOT_TIMELINE_RECORD(stage, event, param)
+#endif /* TFM_BOOT_TIMELINE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_BOOT_TIMELINE_H__ */
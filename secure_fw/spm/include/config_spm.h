@@ -27,9 +27,62 @@
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
 #endif /* !CONFIG_TFM_DOORBELL_API */
 
+/*
+ * Functions of the IPC hot path, copied at boot to the code RAM of the
+ * platform with the functions of the flash drivers.
+ */
+#if CONFIG_TFM_SPM_RAM_CODE == 1
+#if defined(__ICCARM__)
+#define SPM_RAM_CODE __ramfunc
+#else
+#define SPM_RAM_CODE __attribute__((section(".ramfunc")))
+#endif
+#else
+#define SPM_RAM_CODE
+#endif
+
 /* Check invalid configs */
 #if (CONFIG_TFM_SPM_BACKEND_SFN == 1) && CONFIG_TFM_DOORBELL_API
 #error "Invalid config: CONFIG_TFM_SPM_BACKEND_SFN AND CONFIG_TFM_DOORBELL_API!"
 #endif
 
+#if (CONFIG_TFM_SPM_BACKEND_SFN == 1) && (CONFIG_TFM_PRIORITY_INHERITANCE == 1)
+#error "Invalid config: CONFIG_TFM_SPM_BACKEND_SFN AND CONFIG_TFM_PRIORITY_INHERITANCE!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_SFN == 1) && (CONFIG_TFM_THRD_ROUND_ROBIN == 1)
+#error "Invalid config: CONFIG_TFM_SPM_BACKEND_SFN AND CONFIG_TFM_THRD_ROUND_ROBIN!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_SFN == 1) && (CONFIG_TFM_PARTITION_STATS == 1)
+#error "Invalid config: CONFIG_TFM_SPM_BACKEND_SFN AND CONFIG_TFM_PARTITION_STATS!"
+#endif
+
+#if (CONFIG_TFM_PARTITION_PMU == 1) && (CONFIG_TFM_PARTITION_STATS != 1)
+#error "Invalid config: CONFIG_TFM_PARTITION_PMU AND NOT CONFIG_TFM_PARTITION_STATS!"
+#endif
+
+#if (CONFIG_TFM_SERVICE_LATENCY_BUDGET == 1) && (CONFIG_TFM_PARTITION_STATS != 1)
+#error "Invalid config: CONFIG_TFM_SERVICE_LATENCY_BUDGET AND NOT CONFIG_TFM_PARTITION_STATS!"
+#endif
+
+#if (CONFIG_TFM_CALL_LATENCY == 1) && (CONFIG_TFM_PARTITION_STATS != 1)
+#error "Invalid config: CONFIG_TFM_CALL_LATENCY AND NOT CONFIG_TFM_PARTITION_STATS!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_SFN == 1) && (CONFIG_TFM_SPM_RAM_CODE == 1)
+#error "Invalid config: CONFIG_TFM_SPM_BACKEND_SFN AND CONFIG_TFM_SPM_RAM_CODE!"
+#endif
+
+/* Shared stacks rely on the partitions running in one boundary */
+#if (CONFIG_TFM_SPM_SHARED_STACKS == 1) && \
+    ((CONFIG_TFM_SPM_BACKEND_IPC != 1) || (TFM_ISOLATION_LEVEL != 1))
+#error "Invalid config: CONFIG_TFM_SPM_SHARED_STACKS needs IPC backend AND TFM_ISOLATION_LEVEL 1!"
+#endif
+
+/* The idle partition is unprivileged and cannot access the wakeup deadlines */
+#if (TFM_ISOLATION_LEVEL == 3) && (CONFIG_TFM_IDLE_LOW_POWER == 1)
+#error "Invalid config: TFM_ISOLATION_LEVEL 3 AND CONFIG_TFM_IDLE_LOW_POWER!"
+#endif
+
 #endif /* __CONFIG_PARTITION_SPM_H__ */
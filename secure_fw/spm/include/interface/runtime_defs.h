@@ -83,6 +83,7 @@ struct runtime_metadata_t {
     uintptr_t            entry;      /* Entry function */
     struct psa_api_tbl_t *psa_fns;   /* PSA API entry table */
     uint32_t             n_sfn;      /* Number of Secure FuNctions */
+    uint32_t             deferred_init;/* Entry runs on the first signal */
     service_fn_t         sfn_table[];/* Secure FuNctions Table */
 };
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
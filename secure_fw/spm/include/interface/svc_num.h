@@ -73,6 +73,11 @@
 #define TFM_SVC_OUTPUT_UNPRIV_STRING    TFM_SVC_NUM_SPM_THREAD(2)
 #define TFM_SVC_GET_BOOT_DATA           TFM_SVC_NUM_SPM_THREAD(3)
 #define TFM_SVC_THREAD_MODE_SPM_RETURN  TFM_SVC_NUM_SPM_THREAD(4)
+#define TFM_SVC_DRAIN_SP_LOG            TFM_SVC_NUM_SPM_THREAD(5)
+#define TFM_SVC_PREEMPTION_POINT_OPEN   TFM_SVC_NUM_SPM_THREAD(6)
+#define TFM_SVC_PREEMPTION_POINT_CLOSE  TFM_SVC_NUM_SPM_THREAD(7)
+#define TFM_SVC_CACHE_CLEAN             TFM_SVC_NUM_SPM_THREAD(8)
+#define TFM_SVC_CACHE_INVALIDATE        TFM_SVC_NUM_SPM_THREAD(9)
 
 /* TF-M SPM and for Handler mode */
 #define TFM_SVC_PREPARE_DEPRIV_FLIH     TFM_SVC_NUM_SPM_HANDLER(0)
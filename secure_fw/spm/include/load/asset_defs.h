@@ -19,6 +19,8 @@
 #define ASSET_ATTR_MMIO             (ASSET_ATTR_NAMED_MMIO | \
                                      ASSET_ATTR_NUMBERED_MMIO)
 
+#define ASSET_ATTR_CACHEABLE        (1U << 5)  /* 1: Cacheable normal memory */
+
 struct asset_desc_t {
     union {
         struct {                            /* Memory-based asset type  */
@@ -28,6 +28,10 @@ struct irq_load_info_t {
     psa_signal_t signal;                      /* The signal assigned for IRQ  */
     int32_t     client_id_base;               /* The min translated client ID */
     int32_t     client_id_limit;              /* The max translated client ID */
+#if CONFIG_TFM_SLIH_COALESCE_NUM > 0
+    uint32_t     coalesce;                    /* SLIH events per signal       */
+    uint32_t     coalesce_idx;                /* Index of the event counter   */
+#endif
 };
 
 /* IRQ runtime data */
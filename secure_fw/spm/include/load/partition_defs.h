@@ -53,6 +53,12 @@
 #define PARTITION_NS_AGENT_MB                   (1UL << 10)
 #define PARTITION_NS_AGENT_TZ                   (1UL << 11)
 
+/* Initialization is run on the first request instead of before NSPE boots */
+#define PARTITION_DEFERRED_INIT                 (1UL << 12)
+
+/* The stack is shared with the other partitions it is mutually exclusive with */
+#define PARTITION_SHARED_STACK                  (1UL << 13)
+
 #define PARTITION_PRIORITY(flag)                ((flag) & PARTITION_PRI_MASK)
 #define TO_THREAD_PRIORITY(x)                   (x)
 
@@ -66,6 +72,10 @@
                                                      & PARTITION_MODEL_PSA_ROT))
 #define IS_IPC_MODEL(pldi)                      (!!((pldi)->flags \
                                                      & PARTITION_MODEL_IPC))
+#define IS_DEFERRED_INIT(pldi)                  (!!((pldi)->flags \
+                                                     & PARTITION_DEFERRED_INIT))
+#define IS_SHARED_STACK(pldi)                   (!!((pldi)->flags \
+                                                     & PARTITION_SHARED_STACK))
 #define IS_NS_AGENT(pldi)                       (!!((pldi)->flags \
                                                      & (PARTITION_NS_AGENT_MB | PARTITION_NS_AGENT_TZ)))
 #ifdef CONFIG_TFM_USE_TRUSTZONE
@@ -66,6 +66,13 @@ struct service_head_t {
  */
 struct partition_t *load_a_partition_assuredly(struct partition_head_t *head);
 
+/*
+ * Get a loaded partition by partition ID with the index generated from the
+ * manifests. Return NULL if the partition is not loaded or is not described
+ * by a manifest, such as the partitions provided by SPM.
+ */
+struct partition_t *load_get_indexed_partition(int32_t pid);
+
 /*
  * Load numbers of service objects to linked list based on given partition.
  * It loads connection based services and stateless services that partition
@@ -80,6 +80,13 @@
  * execution, set the priority of Secure thread mode execution to this value.
  */
 #define SECURE_THREAD_EXECUTION_PRIORITY 0x80
+/*
+ * Priority of Secure thread mode execution at a preemption point: only the
+ * exceptions of the lowest priority stay masked, which is where Non-Secure
+ * OSes put PendSV and their thread switches.
+ */
+#define SECURE_THREAD_PREEMPTION_PRIORITY \
+    ((0xFFUL << (8U - __NVIC_PRIO_BITS)) & 0xFFUL)
 #endif /* CONFIG_TFM_SECURE_THREAD_MASK_NS_INTERRUPT == 1 */
 #else /* CONFIG_TFM_USE_TRUSTZONE */
 /* If TZ is not in use, we have the full priority range available */
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_IDLE_H__
+#define __TFM_IDLE_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Sources of the wakeup deadlines aggregated by the idle partition. Each source
+ * has one deadline registered at most, a new one replaces the previous one.
+ */
+#define TFM_IDLE_WAKEUP_SRC_NS          0   /* Next wakeup of the NSPE       */
+#define TFM_IDLE_WAKEUP_SRC_PLATFORM    1   /* Platform drivers and timers   */
+#define TFM_IDLE_WAKEUP_SRC_PARTITION   2   /* Deferred work of partitions   */
+#define TFM_IDLE_WAKEUP_SRC_NUM         3
+
+/**
+ * \brief Register the next wakeup deadline of a source.
+ *
+ * \param[in] source    One of TFM_IDLE_WAKEUP_SRC_*
+ * \param[in] deadline  Absolute time in ticks of the platform timer which is
+ *                      used by tfm_hal_idle_enter().
+ *
+ * \note Deadlines are compared by their distance so that the timer can wrap
+ *       around, all the registered ones must be within 2^31 ticks.
+ * \note It accesses SPM data, only privileged code can call it.
+ */
+void tfm_idle_set_wakeup(uint32_t source, uint32_t deadline);
+
+/**
+ * \brief Remove the wakeup deadline of a source.
+ *
+ * \param[in] source    One of TFM_IDLE_WAKEUP_SRC_*
+ */
+void tfm_idle_clear_wakeup(uint32_t source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_IDLE_H__ */
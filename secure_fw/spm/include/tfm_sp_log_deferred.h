@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_SP_LOG_DEFERRED_H__
+#define __TFM_SP_LOG_DEFERRED_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * When TFM_SP_LOG_DEFERRED is defined, the strings which the Secure Partitions
+ * output through TFM_SVC_OUTPUT_UNPRIV_STRING are copied into a ring in SPM
+ * memory instead of being written to the log device in the SVC. A string
+ * which does not fit in the free space of the ring is dropped and counted.
+ * The ring is drained by the idle partition, or by the platform from a low
+ * priority context, with tfm_sp_log_deferred_drain().
+ *
+ * Both the writes and the drain run in the SVC handler, or with the SVC
+ * handler not able to preempt them, so the ring needs no lock.
+ */
+
+/* Size of the ring in bytes, a power of two */
+#ifndef SP_LOG_DEFERRED_BUF_SIZE
+#define SP_LOG_DEFERRED_BUF_SIZE    1024
+#endif
+
+/* Maximum number of bytes written to the log device by one drain */
+#ifndef SP_LOG_DEFERRED_DRAIN_SIZE
+#define SP_LOG_DEFERRED_DRAIN_SIZE  64
+#endif
+
+/**
+ * \brief Copies a string output by a Secure Partition into the ring.
+ *
+ * \param[in] str  The string to output
+ * \param[in] len  Length of the string in bytes
+ *
+ * \return Number of chars accepted, which is len even if the string is
+ *         dropped, as the caller can't do anything about it.
+ */
+int32_t tfm_sp_log_deferred_write(const char *str, uint32_t len);
+
+/**
+ * \brief Writes up to SP_LOG_DEFERRED_DRAIN_SIZE bytes of the ring to the log
+ *        device. If strings have been dropped since the last drain, a line
+ *        with their number is written first.
+ *
+ * \return Number of bytes left in the ring.
+ */
+uint32_t tfm_sp_log_deferred_drain(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_SP_LOG_DEFERRED_H__ */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_SPM_CALL_LATENCY_H__
+#define __TFM_SPM_CALL_LATENCY_H__
+
+#include <stdint.h>
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * With CONFIG_TFM_CALL_LATENCY, the SPM splits the latency of one psa_call()
+ * in 2^CONFIG_TFM_CALL_LATENCY_SAMPLE_SHIFT to each service into the phases
+ * below, and counts the duration of each phase in a histogram of the service.
+ * The durations are in SPM_GET_CYCLES() cycles, see cycle_counter.h.
+ *
+ * The histograms are read through spm_get_call_latency(), which platforms can
+ * expose to the NSPE with a platform IOCTL request.
+ */
+
+/* Phases of a call */
+#define SPM_CALL_PHASE_VALIDATE         0   /* SPM entry to message queued    */
+#define SPM_CALL_PHASE_QUEUE            1   /* Message queued to psa_get()    */
+#define SPM_CALL_PHASE_SERVICE          2   /* psa_get() to psa_reply()       */
+#define SPM_CALL_PHASE_RETURN           3   /*
+                                             * psa_reply() to the client
+                                             * running again, or to the
+                                             * mailbox agent getting the reply
+                                             */
+#define SPM_CALL_PHASE_NUM              4
+
+/*
+ * Bucket 0 counts the durations below 2^SPM_CALL_LATENCY_BUCKET_SHIFT cycles,
+ * bucket n the ones from 2^(SPM_CALL_LATENCY_BUCKET_SHIFT + n - 1) cycles up
+ * to twice that, and the last bucket all the longer ones.
+ */
+#define SPM_CALL_LATENCY_BUCKET_NUM     20
+#define SPM_CALL_LATENCY_BUCKET_SHIFT   6
+
+/* Platform IOCTL request suggested for reading the histograms */
+#define SPM_CALL_LATENCY_IOCTL_REQ_READ 0x5350434C
+
+/**
+ * Call latency histograms of a service. All fields in little endian.
+ */
+struct spm_call_latency_t {
+    uint32_t samples;       /* Calls sampled and replied */
+    uint32_t buckets[SPM_CALL_PHASE_NUM][SPM_CALL_LATENCY_BUCKET_NUM];
+};
+
+/**
+ * \brief                   Get a snapshot of the call latency histograms of a
+ *                          service.
+ *
+ * \param[in]  sid          RoT Service identity
+ * \param[out] p_latency    Buffer to hold the histograms
+ *
+ * \retval PSA_SUCCESS              Success
+ * \retval PSA_ERROR_DOES_NOT_EXIST No service with this SID
+ */
+psa_status_t spm_get_call_latency(uint32_t sid,
+                                  struct spm_call_latency_t *p_latency);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_SPM_CALL_LATENCY_H__ */
@@ -34,25 +34,46 @@
 #error "Incorrect TFM_SPM_LOG_LEVEL value!"
 #endif
 
+#ifdef TFM_SPM_LOG_TOKENIZED
+#include "tfm_spm_log_token.h"
+
+/*
+ * Constant messages are replaced by their token, which tools/tfm_log_token.py
+ * decodes on the host. Messages which are not known at build time fall back to
+ * the plain text output.
+ */
+#define SPMLOG_OUTPUT_MSG(msg)                               \
+    (__builtin_constant_p((msg)[0]) ?                        \
+     spm_log_token(TFM_LOG_TOKEN_HASH(msg)) :                \
+     tfm_hal_output_spm_log(msg, sizeof(msg)))
+#define SPMLOG_OUTPUT_MSGVAL(msg, val)                       \
+    (__builtin_constant_p((msg)[0]) ?                        \
+     spm_log_token_val(TFM_LOG_TOKEN_HASH(msg), val) :       \
+     spm_log_msgval(msg, sizeof(msg), val))
+#else
+#define SPMLOG_OUTPUT_MSG(msg)         tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_OUTPUT_MSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
+#endif /* TFM_SPM_LOG_TOKENIZED */
+
 #if (TFM_SPM_LOG_LEVEL == TFM_SPM_LOG_LEVEL_DEBUG)
-#define SPMLOG_DBGMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_DBGMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_DBGMSGVAL(msg, val) SPMLOG_OUTPUT_MSGVAL(msg, val)
+#define SPMLOG_DBGMSG(msg) SPMLOG_OUTPUT_MSG(msg)
 #else
 #define SPMLOG_DBGMSGVAL(msg, val)
 #define SPMLOG_DBGMSG(msg)
 #endif
 
 #if (TFM_SPM_LOG_LEVEL >= TFM_SPM_LOG_LEVEL_INFO)
-#define SPMLOG_INFMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_INFMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_INFMSGVAL(msg, val) SPMLOG_OUTPUT_MSGVAL(msg, val)
+#define SPMLOG_INFMSG(msg) SPMLOG_OUTPUT_MSG(msg)
 #else
 #define SPMLOG_INFMSGVAL(msg, val)
 #define SPMLOG_INFMSG(msg)
 #endif
 
 #if (TFM_SPM_LOG_LEVEL >= TFM_SPM_LOG_LEVEL_ERROR)
-#define SPMLOG_ERRMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_ERRMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_ERRMSGVAL(msg, val) SPMLOG_OUTPUT_MSGVAL(msg, val)
+#define SPMLOG_ERRMSG(msg) SPMLOG_OUTPUT_MSG(msg)
 #else
 #define SPMLOG_ERRMSGVAL(msg, val)
 #define SPMLOG_ERRMSG(msg)
@@ -71,4 +92,29 @@
  */
 int32_t spm_log_msgval(const char *msg, size_t len, uint32_t value);
 
+#ifdef TFM_SPM_LOG_TOKENIZED
+/**
+ * \brief Outputs the token of a message as a 0x1E byte followed by the token
+ *        in little endian.
+ *
+ * \param[in]  token  The token of the message
+ *
+ * \retval >=0        Number of bytes output.
+ * \retval <0         TFM HAL error code.
+ */
+int32_t spm_log_token(uint32_t token);
+
+/**
+ * \brief Outputs the token of a message and a value as a 0x1F byte followed by
+ *        the token and the value, both in little endian.
+ *
+ * \param[in]  token  The token of the message
+ * \param[in]  value  A value need to be output
+ *
+ * \retval >=0        Number of bytes output.
+ * \retval <0         TFM HAL error code.
+ */
+int32_t spm_log_token_val(uint32_t token, uint32_t value);
+#endif /* TFM_SPM_LOG_TOKENIZED */
+
 #endif /* __TFM_SPM_LOG_H__ */
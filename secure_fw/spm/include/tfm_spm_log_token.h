@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* This file is generated by tools/tfm_log_token.py --header, do not edit. */
+
+#ifndef __TFM_SPM_LOG_TOKEN_H__
+#define __TFM_SPM_LOG_TOKEN_H__
+
+#include <stdint.h>
+
+/*
+ * Hash of a string literal used as the token of a log message. It is the
+ * length of the string plus the sum of its first 80 characters multiplied
+ * by the powers of 65599, modulo 2^32, and is folded into a constant by the
+ * compiler so that the string itself is not kept in the image.
+ */
+#define TFM_LOG_TOKEN_CHAR(str, i, coeff) \
+    (((i) < sizeof(str) - 1) ? (uint32_t)(uint8_t)(str)[i] * (coeff) : 0U)
+
+#define TFM_LOG_TOKEN_HASH(str) ((uint32_t)(sizeof(str) - 1) + \
+    TFM_LOG_TOKEN_CHAR(str, 0, 0x0001003FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 1, 0x007E0F81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 2, 0x2E86D0BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 3, 0x43EC5F01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 4, 0x162C613FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 5, 0xD62AEE81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 6, 0xA311B1BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 7, 0xD319BE01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 8, 0xB156C23FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 9, 0x6698CD81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 10, 0x0D1B92BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 11, 0xCC881D01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 12, 0x7280233FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 13, 0x50C7AC81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 14, 0x8DA473BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 15, 0x4F377C01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 16, 0xFAA8843FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 17, 0x33B78B81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 18, 0x45AC54BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 19, 0x7A27DB01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 20, 0xEACFE53FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 21, 0xAE686A81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 22, 0x563335BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 23, 0x6C593A01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 24, 0xE3F6463FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 25, 0x5FDA4981U) + \
+    TFM_LOG_TOKEN_CHAR(str, 26, 0xE03916BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 27, 0x44CB9901U) + \
+    TFM_LOG_TOKEN_CHAR(str, 28, 0x871BA73FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 29, 0xE70D2881U) + \
+    TFM_LOG_TOKEN_CHAR(str, 30, 0x04BDF7BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 31, 0x227EF801U) + \
+    TFM_LOG_TOKEN_CHAR(str, 32, 0x7540083FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 33, 0xE3010781U) + \
+    TFM_LOG_TOKEN_CHAR(str, 34, 0xE4C1D8BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 35, 0x24735701U) + \
+    TFM_LOG_TOKEN_CHAR(str, 36, 0x4F63693FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 37, 0xF2B5E681U) + \
+    TFM_LOG_TOKEN_CHAR(str, 38, 0xA144B9BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 39, 0x69A8B601U) + \
+    TFM_LOG_TOKEN_CHAR(str, 40, 0xB685CA3FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 41, 0xB52BC581U) + \
+    TFM_LOG_TOKEN_CHAR(str, 42, 0x5B469ABFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 43, 0x111F1501U) + \
+    TFM_LOG_TOKEN_CHAR(str, 44, 0x4BA72B3FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 45, 0xC962A481U) + \
+    TFM_LOG_TOKEN_CHAR(str, 46, 0x33C77BBFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 47, 0x39D67401U) + \
+    TFM_LOG_TOKEN_CHAR(str, 48, 0xAFC78C3FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 49, 0xCE5A8381U) + \
+    TFM_LOG_TOKEN_CHAR(str, 50, 0x4BC75CBFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 51, 0x02CED301U) + \
+    TFM_LOG_TOKEN_CHAR(str, 52, 0x83E6ED3FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 53, 0x63136281U) + \
+    TFM_LOG_TOKEN_CHAR(str, 54, 0xC4463DBFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 55, 0x8B083201U) + \
+    TFM_LOG_TOKEN_CHAR(str, 56, 0x69054E3FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 57, 0x268D4181U) + \
+    TFM_LOG_TOKEN_CHAR(str, 58, 0xBE441EBFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 59, 0xF1829101U) + \
+    TFM_LOG_TOKEN_CHAR(str, 60, 0x0022AF3FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 61, 0xB7C82081U) + \
+    TFM_LOG_TOKEN_CHAR(str, 62, 0x5AC0FFBFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 63, 0x553DF001U) + \
+    TFM_LOG_TOKEN_CHAR(str, 64, 0xEA3F103FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 65, 0xB5C3FF81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 66, 0xBABCE0BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 67, 0xD53A4F01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 68, 0xC85A713FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 69, 0xBF80DE81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 70, 0xFF37C1BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 71, 0x9077AE01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 72, 0x3B74D23FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 73, 0x73FEBD81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 74, 0x4931A2BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 75, 0xA5F60D01U) + \
+    TFM_LOG_TOKEN_CHAR(str, 76, 0xE48E333FU) + \
+    TFM_LOG_TOKEN_CHAR(str, 77, 0x723D9C81U) + \
+    TFM_LOG_TOKEN_CHAR(str, 78, 0xB9AA83BFU) + \
+    TFM_LOG_TOKEN_CHAR(str, 79, 0x34B56C01U))
+
+#endif /* __TFM_SPM_LOG_TOKEN_H__ */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_SPM_TRACE_H__
+#define __TFM_SPM_TRACE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The SPM trace is a ring of fixed size events recorded by the SPM at the
+ * entry and exit of the client and reply APIs, on thread switches, on secure
+ * interrupts and on signal assertion. It is kept in SPM RAM and read through
+ * spm_trace_read(), which platforms can expose to the NSPE with a platform
+ * IOCTL request.
+ *
+ * The timestamps are taken from SPM_GET_CYCLES(), see cycle_counter.h. A
+ * platform can provide a trace specific source by defining
+ * SPM_TRACE_GET_TIMESTAMP().
+ *
+ * The recording macro compiles to nothing unless TFM_SPM_TRACE is defined.
+ */
+
+/* Events. The parameter of each event is given in the comment. */
+#define SPM_TRACE_EVENT_PSA_CONNECT_ENTER   0x01    /* SID                   */
+#define SPM_TRACE_EVENT_PSA_CONNECT_EXIT    0x02    /* Status or handle      */
+#define SPM_TRACE_EVENT_PSA_CALL_ENTER      0x03    /* Handle                */
+#define SPM_TRACE_EVENT_PSA_CALL_EXIT       0x04    /* Status                */
+#define SPM_TRACE_EVENT_PSA_REPLY_ENTER     0x05    /* Message handle        */
+#define SPM_TRACE_EVENT_PSA_REPLY_EXIT      0x06    /* Status                */
+#define SPM_TRACE_EVENT_THREAD_SWITCH       0x07    /* Next partition ID     */
+#define SPM_TRACE_EVENT_INTERRUPT           0x08    /* IRQ source            */
+#define SPM_TRACE_EVENT_ASSERT_SIGNAL       0x09    /* Signal                */
+#define SPM_TRACE_EVENT_LATENCY_OVERRUN     0x0A    /* SID                   */
+
+/* Default number of events kept in the ring */
+#ifndef SPM_TRACE_EVENT_NUM
+#define SPM_TRACE_EVENT_NUM                 64
+#endif
+
+/* Platform IOCTL request suggested for reading the trace */
+#define SPM_TRACE_IOCTL_REQ_READ            0x53505454
+
+/**
+ * SPM trace event. All fields in little endian.
+ *
+ *    ---------------------------------------------
+ *    |               timestamp(32)               |
+ *    ---------------------------------------------
+ *    |      event(16)      |   partition ID(16)  |
+ *    ---------------------------------------------
+ *    |                 param(32)                 |
+ *    ---------------------------------------------
+ *
+ * \note The partition ID field holds the client ID of the caller for
+ *       psa_connect() and psa_call(), the replying partition for psa_reply(),
+ *       the partition switched from for thread switches, and the partition
+ *       owning the interrupt or receiving the signal. It is truncated to 16
+ *       bits.
+ */
+struct spm_trace_event_t {
+    uint32_t timestamp;
+    uint16_t event;
+    uint16_t partition_id;
+    uint32_t param;
+};
+
+#ifdef TFM_SPM_TRACE
+/**
+ * \brief Appends an event to the SPM trace.
+ *
+ * \param[in] event         Event, one of SPM_TRACE_EVENT_*
+ * \param[in] partition_id  ID of the partition the event applies to
+ * \param[in] param         Event specific parameter
+ */
+void spm_trace_record(uint16_t event, int32_t partition_id, uint32_t param);
+
+/**
+ * \brief Copies events of the SPM trace.
+ *
+ * \param[in]  seq       Sequence number of the first event to copy. Events
+ *                       which were already overwritten are skipped.
+ * \param[out] p_events  Buffer to hold the events
+ * \param[in]  num       Maximum number of events to copy
+ * \param[out] p_seq     Sequence number of the event following the last
+ *                       copied one, to pass as \p seq on the next read
+ *
+ * \return Number of events copied.
+ *
+ * \note The sequence number of an event is the number of events recorded
+ *       before it.
+ */
+size_t spm_trace_read(uint32_t seq, struct spm_trace_event_t *p_events,
+                      size_t num, uint32_t *p_seq);
+
+#define SPM_TRACE(event, partition_id, param) \
+                    spm_trace_record(event, (int32_t)(partition_id), \
+                                     (uint32_t)(param))
+#else
+#define SPM_TRACE(event, partition_id, param)
+#endif /* TFM_SPM_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_SPM_TRACE_H__ */
@@ -19,6 +19,19 @@ static struct tfm_ns_ctx_t ns_ctx_data[TFM_NS_CONTEXT_MAX] = {0};
 /* Current active NS context index. Default is invalid index */
 static uint8_t active_ns_ctx_index = TFM_NS_CONTEXT_MAX;
 
+/*
+ * Context index plus one of each group ID which has a context, 0 otherwise,
+ * so that a group finds its context without scanning the contexts.
+ */
+static uint8_t gid_ctx_slot[UINT8_MAX + 1];
+
+/*
+ * Unused contexts, chained by index plus one from the head, 0 ending the
+ * chain.
+ */
+static uint8_t free_ctx_next[TFM_NS_CONTEXT_MAX];
+static uint8_t free_ctx_head;
+
 bool init_ns_ctx(void)
 {
     uint32_t i;
@@ -26,65 +39,66 @@ bool init_ns_ctx(void)
     for (i = 0; i < TFM_NS_CONTEXT_MAX; i++) {
         /* Only need to ensure the reference counter is 0 */
         ns_ctx_data[i].ref_cnt = 0;
+        free_ctx_next[i] = (uint8_t)((i + 1 < TFM_NS_CONTEXT_MAX) ? i + 2 : 0);
+    }
+    free_ctx_head = 1;
+
+    for (i = 0; i <= UINT8_MAX; i++) {
+        gid_ctx_slot[i] = 0;
     }
 
     active_ns_ctx_index = TFM_NS_CONTEXT_MAX;
     return true;
 }
 
+/* Drop a reference to a context, which is freed with its last reference */
+static void put_ns_ctx(uint8_t idx)
+{
+    if (ns_ctx_data[idx].ref_cnt == 0) {
+        return;
+    }
+
+    ns_ctx_data[idx].ref_cnt--;
+    if (ns_ctx_data[idx].ref_cnt == 0) {
+        gid_ctx_slot[ns_ctx_data[idx].gid] = 0;
+        free_ctx_next[idx] = free_ctx_head;
+        free_ctx_head = idx + 1;
+    }
+}
+
 bool acquire_ns_ctx(uint8_t gid, uint8_t *idx)
 {
-    /* Only support one context slot for now */
-    uint32_t i;
-    uint32_t empty_ctx_idx = TFM_NS_CONTEXT_MAX; /* default is invalid */
+    uint32_t slot;
 
     __disable_irq();
-    /*
-     * Go through all context slots to get the context for the given group ID.
-     * It will not take a long time as the context number should be limited.
-     */
-    for (i = 0; i < TFM_NS_CONTEXT_MAX; i++) {
-        if (ns_ctx_data[i].ref_cnt > 0) {  /* This context has been taken */
-            if (ns_ctx_data[i].gid == gid) {
-                /*
-                 * Found the context associated with the input group ID.
-                 * Check if the thread number reached the limit.
-                 */
-                if (ns_ctx_data[i].ref_cnt < TFM_NS_CONTEXT_MAX_TID) {
-                    /* Reuse this context and increase the reference number */
-                    ns_ctx_data[i].ref_cnt++;
-                    *idx = i;
-                    __enable_irq();
-                    return true;
-                } else {
-                    /* No more thread for this group */
-                    __enable_irq();
-                    return false;
-                }
-            }
-        } else {    /* Found an empty context slot */
-            /* Save the first unused context index and continue */
-            if (empty_ctx_idx == TFM_NS_CONTEXT_MAX) {
-                empty_ctx_idx = i;
-            }
-            /*
-             * Still need to go through the remaining slots to check if there
-             * is an existing context assigned to the given group ID.
-             */
-        }
-    }
 
-    /* No existing context for the group ID, use the first free context */
-    if (empty_ctx_idx < TFM_NS_CONTEXT_MAX) {
-        ns_ctx_data[empty_ctx_idx].ref_cnt++;
-        ns_ctx_data[empty_ctx_idx].gid = gid;
-        *idx = empty_ctx_idx;
-        __enable_irq();
-        return true;
+    slot = gid_ctx_slot[gid];
+    if (slot != 0) {
+        /*
+         * Reuse the context associated with the input group ID, unless the
+         * thread number reached the limit.
+         */
+        if (ns_ctx_data[slot - 1].ref_cnt >= TFM_NS_CONTEXT_MAX_TID) {
+            __enable_irq();
+            return false;
+        }
     } else {
-        __enable_irq();
-        return false;   /* No available context */
+        /* No existing context for the group ID, use the first free context */
+        slot = free_ctx_head;
+        if (slot == 0) {
+            __enable_irq();
+            return false;   /* No available context */
+        }
+        free_ctx_head = free_ctx_next[slot - 1];
+        gid_ctx_slot[gid] = (uint8_t)slot;
+        ns_ctx_data[slot - 1].gid = gid;
     }
+
+    ns_ctx_data[slot - 1].ref_cnt++;
+    __enable_irq();
+
+    *idx = (uint8_t)(slot - 1);
+    return true;
 }
 
 bool release_ns_ctx(uint8_t gid, uint8_t tid, uint8_t idx)
@@ -110,9 +124,7 @@ bool release_ns_ctx(uint8_t gid, uint8_t tid, uint8_t idx)
     if (idx == active_ns_ctx_index) {
         if (ns_ctx_data[idx].tid == tid) {
             /* Release the currrent active thread */
-            if (ns_ctx_data[idx].ref_cnt > 0) {
-                ns_ctx_data[idx].ref_cnt--;
-            }
+            put_ns_ctx(idx);
             active_ns_ctx_index = TFM_NS_CONTEXT_MAX;
         } else {
             /*
@@ -126,9 +138,7 @@ bool release_ns_ctx(uint8_t gid, uint8_t tid, uint8_t idx)
         }
     } else {
         /* Release in the non-active context */
-        if (ns_ctx_data[idx].ref_cnt > 0) {
-            ns_ctx_data[idx].ref_cnt--;
-        }
+        put_ns_ctx(idx);
     }
 
     __enable_irq();
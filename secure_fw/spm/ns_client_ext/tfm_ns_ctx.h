@@ -10,8 +10,18 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-/* Supported maximum context for NS. Only support single context for now. */
+/*
+ * Supported maximum context for NS. Single context by default. The context
+ * index is carried in 8 bits of the client token and the value is used as the
+ * invalid index.
+ */
+#ifndef TFM_NS_CONTEXT_MAX
 #define TFM_NS_CONTEXT_MAX                  1
+#endif
+
+#if (TFM_NS_CONTEXT_MAX < 1) || (TFM_NS_CONTEXT_MAX > 0xFF)
+#error "TFM_NS_CONTEXT_MAX must be between 1 and 255."
+#endif
 
 #define TFM_NS_CONTEXT_MAX_TID              0xFF
 
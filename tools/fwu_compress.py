@@ -0,0 +1,183 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Compresses and decompresses the images written to the Firmware Update
+partition (FWU_LZ4_UPDATE). The format is described in
+secure_fw/partitions/firmware_update/fwu_lz4.h.
+"""
+
+import sys
+import struct
+import argparse
+
+# Header of the compressed image, which must match fwu_lz4.h
+LZ4_MAGIC = 0x49345A4C
+
+# Parameters of the LZ4 block format
+MIN_MATCH = 4
+MAX_OFFSET = 0xFFFF
+# The last match starts at least MF_LIMIT bytes before the end of the block
+# and the block ends with at least LAST_LITERALS literals.
+MF_LIMIT = 12
+LAST_LITERALS = 5
+LEN_MASK = 0x0F
+
+# Candidates kept per key of the match finder
+MAX_CANDIDATES = 16
+
+def length_bytes(length):
+    out = bytearray()
+    while length >= 0xFF:
+        out.append(0xFF)
+        length -= 0xFF
+    out.append(length)
+    return bytes(out)
+
+def sequence(literals, offset, match_len):
+    """
+    Encodes a sequence, match_len being 0 for the last one
+    """
+    lit_len = len(literals)
+    token = min(lit_len, LEN_MASK) << 4
+    if match_len:
+        token |= min(match_len - MIN_MATCH, LEN_MASK)
+    out = bytearray([token])
+    if lit_len >= LEN_MASK:
+        out += length_bytes(lit_len - LEN_MASK)
+    out += literals
+    if match_len:
+        out += struct.pack('<H', offset)
+        if match_len - MIN_MATCH >= LEN_MASK:
+            out += length_bytes(match_len - MIN_MATCH - LEN_MASK)
+    return bytes(out)
+
+def compress(image):
+    """
+    Greedy LZ4 block encoder: the longest match among the last positions of
+    the same MIN_MATCH bytes within the window.
+    """
+    out = bytearray(struct.pack('<II', LZ4_MAGIC, len(image)))
+    index = {}
+    anchor = 0
+    pos = 0
+    match_limit = len(image) - MF_LIMIT
+    end_limit = len(image) - LAST_LITERALS
+
+    while pos < match_limit:
+        key = image[pos:pos + MIN_MATCH]
+        candidates = index.setdefault(key, [])
+        best_len, best_off = 0, 0
+        for cand in reversed(candidates):
+            if pos - cand > MAX_OFFSET:
+                break
+            length = 0
+            while (pos + length < end_limit and
+                   image[cand + length] == image[pos + length]):
+                length += 1
+            if length > best_len:
+                best_len, best_off = length, pos - cand
+        candidates.append(pos)
+        if len(candidates) > MAX_CANDIDATES:
+            del candidates[0]
+
+        if best_len < MIN_MATCH:
+            pos += 1
+            continue
+
+        out += sequence(image[anchor:pos], best_off, best_len)
+        for i in range(pos + 1, min(pos + best_len, match_limit)):
+            entries = index.setdefault(image[i:i + MIN_MATCH], [])
+            entries.append(i)
+            if len(entries) > MAX_CANDIDATES:
+                del entries[0]
+        pos += best_len
+        anchor = pos
+
+    out += sequence(image[anchor:], 0, 0)
+    return bytes(out)
+
+def read_length(data, pos, length):
+    if length == LEN_MASK:
+        while True:
+            byte = data[pos]
+            pos += 1
+            length += byte
+            if byte != 0xFF:
+                break
+    return length, pos
+
+def decompress(data):
+    """
+    Reference implementation of the decompressor, to check an image on the
+    host.
+    """
+    magic, size = struct.unpack_from('<II', data)
+    if magic != LZ4_MAGIC:
+        raise ValueError('Not a compressed image')
+    out = bytearray()
+    pos = 8
+    while True:
+        token = data[pos]
+        pos += 1
+        lit_len, pos = read_length(data, pos, token >> 4)
+        out += data[pos:pos + lit_len]
+        pos += lit_len
+        if len(out) >= size:
+            break
+        offset = struct.unpack_from('<H', data, pos)[0]
+        pos += 2
+        match_len, pos = read_length(data, pos, token & LEN_MASK)
+        if offset == 0 or offset > len(out):
+            raise ValueError('Bad match offset')
+        for _ in range(match_len + MIN_MATCH):
+            out.append(out[-offset])
+    if len(out) != size or pos != len(data):
+        raise ValueError('Bad image size')
+    return bytes(out)
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='Compress or decompress FWU images')
+
+    parser.add_argument('command'
+                        , choices=['compress', 'decompress']
+                        , help='compress: image -> compressed image, decompress: compressed image -> image')
+
+    parser.add_argument('-i', '--input'
+                        , dest='input'
+                        , required=True
+                        , metavar='input'
+                        , help='The signed image, or the compressed image')
+
+    parser.add_argument('-o', '--output'
+                        , dest='output'
+                        , required=True
+                        , metavar='output'
+                        , help='The compressed image, or the signed image')
+
+    return parser.parse_args()
+
+def main():
+    args = parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    if args.command == 'compress':
+        output = compress(data)
+        if decompress(output) != data:
+            sys.exit('Compressed image check failed')
+        print('Compressed image of {} bytes for an image of {} bytes'.format(
+              len(output), len(data)))
+    else:
+        output = decompress(data)
+
+    with open(args.output, 'wb') as f:
+        f.write(output)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,207 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Creates and applies the delta patches of the Firmware Update partition
+(FWU_DELTA_UPDATE). The format is described in
+secure_fw/partitions/firmware_update/fwu_delta.h.
+"""
+
+import sys
+import struct
+import argparse
+
+# Patch format, which must match fwu_delta.h
+DELTA_MAGIC = 0x544C4544
+OP_END = 0x00
+OP_COPY = 0x01
+OP_LITERAL = 0x02
+
+# Shortest match of the source encoded as a copy
+MIN_MATCH = 12
+# Longest run of changed bytes between two copies at the same source distance
+MAX_GAP = 16
+# Candidates kept per key of the source index
+MAX_CANDIDATES = 8
+
+def varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+def zigzag(value):
+    return (value << 1) ^ (value >> 31) if value < 0 else value << 1
+
+class PatchWriter:
+    def __init__(self, target_size):
+        self.out = bytearray(struct.pack('<II', DELTA_MAGIC, target_size))
+        self.src_pos = 0
+        self.literal = bytearray()
+
+    def flush_literal(self):
+        if self.literal:
+            self.out += bytes([OP_LITERAL]) + varint(len(self.literal))
+            self.out += self.literal
+            self.literal = bytearray()
+
+    def copy(self, src_off, length):
+        self.flush_literal()
+        self.out += bytes([OP_COPY]) + varint(length)
+        self.out += varint(zigzag(src_off - self.src_pos) & 0xFFFFFFFF)
+        self.src_pos = src_off + length
+
+    def end(self):
+        self.flush_literal()
+        self.out.append(OP_END)
+        return bytes(self.out)
+
+def index_source(source):
+    index = {}
+    for i in range(len(source) - MIN_MATCH + 1):
+        entries = index.setdefault(source[i:i + MIN_MATCH], [])
+        if len(entries) < MAX_CANDIDATES:
+            entries.append(i)
+    return index
+
+def match_length(source, src, target, dst):
+    length = 0
+    limit = min(len(source) - src, len(target) - dst)
+    while length < limit and source[src + length] == target[dst + length]:
+        length += 1
+    return length
+
+def create(source, target):
+    """
+    Greedy encoder: the longest match of the source at each position of the
+    target is a copy. After a copy ends, the copy at the same distance is
+    resumed when it matches again after a few changed bytes, which is how code
+    whose addresses changed looks.
+    """
+    index = index_source(source)
+    patch = PatchWriter(len(target))
+    dst = 0
+    while dst < len(target):
+        best_len, best_src = 0, 0
+        for src in index.get(target[dst:dst + MIN_MATCH], []):
+            length = match_length(source, src, target, dst)
+            if length > best_len:
+                best_len, best_src = length, src
+        if best_len < MIN_MATCH:
+            patch.literal.append(target[dst])
+            dst += 1
+            continue
+
+        patch.copy(best_src, best_len)
+        dst += best_len
+        src = best_src + best_len
+        while dst < len(target):
+            for gap in range(1, MAX_GAP + 1):
+                length = match_length(source, src + gap, target, dst + gap)
+                if length >= MIN_MATCH // 2:
+                    break
+            else:
+                break
+            patch.literal += target[dst:dst + gap]
+            patch.copy(src + gap, length)
+            dst += gap + length
+            src += gap + length
+    return patch.end()
+
+def read_varint(patch, pos):
+    value, shift = 0, 0
+    while True:
+        byte = patch[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+def apply(source, patch):
+    """
+    Reference implementation of the patcher, to check a patch on the host.
+    """
+    magic, size = struct.unpack_from('<II', patch)
+    if magic != DELTA_MAGIC:
+        raise ValueError('Not a delta patch')
+    out = bytearray()
+    pos, src_pos = 8, 0
+    while True:
+        op = patch[pos]
+        pos += 1
+        if op == OP_END:
+            break
+        length, pos = read_varint(patch, pos)
+        if op == OP_COPY:
+            adjust, pos = read_varint(patch, pos)
+            src_pos += (adjust >> 1) ^ -(adjust & 1)
+            out += source[src_pos:src_pos + length]
+            src_pos += length
+        elif op == OP_LITERAL:
+            out += patch[pos:pos + length]
+            pos += length
+        else:
+            raise ValueError('Bad command 0x{:02x}'.format(op))
+    if len(out) != size:
+        raise ValueError('Bad target size')
+    return bytes(out)
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='Create or apply FWU delta patches')
+
+    parser.add_argument('command'
+                        , choices=['create', 'apply']
+                        , help='create: source target -> patch, apply: source patch -> target')
+
+    parser.add_argument('-s', '--source'
+                        , dest='source'
+                        , required=True
+                        , metavar='source'
+                        , help='The image in the active slot, as staged')
+
+    parser.add_argument('-i', '--input'
+                        , dest='input'
+                        , required=True
+                        , metavar='input'
+                        , help='The new image to create a patch for, or the patch to apply')
+
+    parser.add_argument('-o', '--output'
+                        , dest='output'
+                        , required=True
+                        , metavar='output'
+                        , help='The patch, or the new image')
+
+    return parser.parse_args()
+
+def main():
+    args = parse_args()
+
+    with open(args.source, 'rb') as f:
+        source = f.read()
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    if args.command == 'create':
+        output = create(source, data)
+        if apply(source, output) != data:
+            sys.exit('Patch check failed')
+        print('Patch of {} bytes for an image of {} bytes'.format(
+              len(output), len(data)))
+    else:
+        output = apply(source, data)
+
+    with open(args.output, 'wb') as f:
+        f.write(output)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,226 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Sizes the pools and stacks of TF-M from the usage recorded by an instrumented
+run, and writes a config header overlay setting them with a margin.
+
+The instrumented image is built with CONFIG_TFM_STACK_WATERMARKS and the IPC
+backend. The SPM prints "[Sizing]" lines each time the stack use of a
+partition or the peak of allocated connections grows. Builds with
+CRYPTO_STATS_ENTRIES print the peaks of the crypto operation context pools,
+and CRYPTO_ENGINE_HEAP_POOLS the one of the crypto engine heap, with the
+statistics report of the crypto service.
+
+The partition IDs are mapped to the stack size macros of their manifests
+through the manifest lists. Partitions whose manifest gives a literal stack
+size are reported but not sized. The overlay includes the original project
+config header, if any, then redefines the sized macros, and is passed to the
+shipping build as PROJECT_CONFIG_HEADER_FILE.
+"""
+
+import os
+import re
+import sys
+import argparse
+import yaml
+
+# Prefix of the lines printed by the SPM, see report_usage_growth()
+SPM_PID_RE = re.compile(r'\[Sizing\] Partition id: (0x[0-9A-Fa-f]+)')
+SPM_STACK_RE = re.compile(r'\[Sizing\]\s+Stack bytes used: (0x[0-9A-Fa-f]+)')
+SPM_CONN_RE = re.compile(r'\[Sizing\] Connections used: (0x[0-9A-Fa-f]+)')
+
+# Lines of the statistics report of the crypto service
+CRYPTO_HEAP_RE = re.compile(r'\[Crypto\] heap size (\d+) in_use \d+ high_water (\d+)')
+CRYPTO_OPER_RE = re.compile(r'\[Crypto\] operations (\d+) num \d+ high_water (\d+)')
+
+# Pools of operation contexts, in the order of tfm_crypto_operation_type
+CRYPTO_OPER_MACROS = [
+    'CRYPTO_CONC_OPER_NUM',
+    'CRYPTO_CONC_CIPHER_OPER_NUM',
+    'CRYPTO_CONC_MAC_OPER_NUM',
+    'CRYPTO_CONC_HASH_OPER_NUM',
+    'CRYPTO_CONC_KEY_DERIVATION_OPER_NUM',
+    'CRYPTO_CONC_AEAD_OPER_NUM',
+]
+
+# Stacks are kept 8-byte aligned as required by the AAPCS
+STACK_ALIGN = 8
+HEAP_ALIGN = 8
+
+def load_stack_macros(manifest_lists):
+    """
+    Maps the partition IDs of the manifest lists to the stack size of their
+    manifests, a macro name or a literal value.
+    """
+    stacks = {}
+    for item in manifest_lists:
+        with open(item) as f:
+            manifest_list = yaml.safe_load(f)['manifest_list']
+        for entry in manifest_list:
+            if 'pid' not in entry:
+                continue
+            path = os.path.expandvars(entry['manifest']).replace('\\', '/')
+            relative = os.path.join(os.path.dirname(item), path)
+            if os.path.isfile(relative):
+                path = relative
+            if not os.path.isfile(path):
+                continue
+            with open(path) as f:
+                manifest = yaml.safe_load(f)
+            stacks[int(entry['pid'])] = (manifest['name'],
+                                         str(manifest['stack_size']))
+    return stacks
+
+def parse_logs(logs):
+    """
+    Returns the largest stack use of each partition ID, the peak of allocated
+    connections, the crypto heap peak and the peak of each crypto pool.
+    """
+    stack_used = {}
+    conn_used = None
+    heap_used = None
+    oper_used = {}
+
+    for log in logs:
+        pid = None
+        with open(log, errors='replace') as f:
+            for line in f:
+                m = SPM_PID_RE.search(line)
+                if m:
+                    pid = int(m.group(1), 16)
+                    continue
+                m = SPM_STACK_RE.search(line)
+                if m and pid is not None:
+                    stack_used[pid] = max(stack_used.get(pid, 0),
+                                          int(m.group(1), 16))
+                    pid = None
+                    continue
+                m = SPM_CONN_RE.search(line)
+                if m:
+                    conn_used = max(conn_used or 0, int(m.group(1), 16))
+                    continue
+                m = CRYPTO_HEAP_RE.search(line)
+                if m:
+                    heap_used = max(heap_used or 0, int(m.group(2)))
+                    continue
+                m = CRYPTO_OPER_RE.search(line)
+                if m and int(m.group(1)) < len(CRYPTO_OPER_MACROS):
+                    macro = CRYPTO_OPER_MACROS[int(m.group(1))]
+                    oper_used[macro] = max(oper_used.get(macro, 0),
+                                           int(m.group(2)))
+
+    return stack_used, conn_used, heap_used, oper_used
+
+def with_margin(value, margin, align=1):
+    """
+    Adds the margin in percent to a used size or count, rounded up to the
+    alignment. Counts are at least 1.
+    """
+    sized = (value * (100 + margin) + 99) // 100
+    sized = (sized + align - 1) // align * align
+    return max(sized, align)
+
+def write_overlay(out, args, sizes, notes):
+    out.write('/*\n')
+    out.write(' * Generated by tools/tfm_config_autosize.py with a margin of '
+              '{}%\n'.format(args.margin))
+    for log in args.logs:
+        out.write(' * from {}\n'.format(os.path.basename(log)))
+    out.write(' */\n\n')
+    out.write('#ifndef __CONFIG_AUTOSIZE_H__\n')
+    out.write('#define __CONFIG_AUTOSIZE_H__\n\n')
+    if args.base:
+        out.write('#include "{}"\n\n'.format(os.path.abspath(args.base)
+                                            .replace('\\', '/')))
+    for note in notes:
+        out.write('/* {} */\n'.format(note))
+    if notes:
+        out.write('\n')
+    for macro, value, used in sizes:
+        out.write('/* Used: {} */\n'.format(used))
+        out.write('#undef {}\n'.format(macro))
+        out.write('#define {:<39} {}\n\n'.format(macro, value))
+    out.write('#endif /* __CONFIG_AUTOSIZE_H__ */\n')
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='Size the TF-M pools and stacks from an instrumented run')
+
+    parser.add_argument('-l', '--log'
+                        , dest='logs'
+                        , required=True
+                        , action='append'
+                        , metavar='log'
+                        , help='The secure log of an instrumented run, can be given several times')
+
+    parser.add_argument('-m', '--manifest-list'
+                        , dest='manifest_lists'
+                        , required=True
+                        , action='append'
+                        , metavar='manifest-list'
+                        , help='The manifest lists of the build, to find the stack size macros')
+
+    parser.add_argument('-b', '--base'
+                        , dest='base'
+                        , metavar='base'
+                        , help='The project config header of the build, included by the overlay')
+
+    parser.add_argument('-p', '--margin'
+                        , dest='margin'
+                        , type=int
+                        , default=25
+                        , help='Margin added to the recorded usage, in percent')
+
+    parser.add_argument('-o', '--output'
+                        , dest='output'
+                        , metavar='output'
+                        , help='The config header overlay, printed if not given')
+
+    return parser.parse_args()
+
+def main():
+    args = parse_args()
+
+    stacks = load_stack_macros(args.manifest_lists)
+    stack_used, conn_used, heap_used, oper_used = parse_logs(args.logs)
+
+    sizes = []
+    notes = []
+    for pid in sorted(stack_used):
+        if pid not in stacks:
+            notes.append('Partition {} is in no manifest list'.format(pid))
+            continue
+        name, stack_size = stacks[pid]
+        if not re.match(r'^[A-Za-z_]\w*$', stack_size):
+            notes.append('{} uses {} bytes of its literal stack size {}'
+                         .format(name, stack_used[pid], stack_size))
+            continue
+        sizes.append((stack_size,
+                      hex(with_margin(stack_used[pid], args.margin,
+                                      STACK_ALIGN)),
+                      stack_used[pid]))
+
+    if conn_used is not None:
+        sizes.append(('CONFIG_TFM_CONN_HANDLE_MAX_NUM',
+                      with_margin(conn_used, args.margin), conn_used))
+    if heap_used is not None:
+        sizes.append(('CRYPTO_ENGINE_BUF_SIZE',
+                      with_margin(heap_used, args.margin, HEAP_ALIGN),
+                      heap_used))
+    for macro in CRYPTO_OPER_MACROS:
+        if macro in oper_used:
+            sizes.append((macro, with_margin(oper_used[macro], args.margin),
+                          oper_used[macro]))
+
+    if args.output:
+        with open(args.output, 'w') as out:
+            write_overlay(out, args, sizes, notes)
+    else:
+        write_overlay(sys.stdout, args, sizes, notes)
+
+if __name__ == '__main__':
+    main()
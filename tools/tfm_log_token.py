@@ -0,0 +1,223 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Host side of the tokenized SPM log (TFM_SPM_LOG_TOKENIZED).
+
+The device replaces the constant messages of the SPMLOG_* macros with the hash
+of the message, computed at build time by TFM_LOG_TOKEN_HASH(). This script
+collects the messages from the sources, computes the same hashes and decodes
+the log captured from the device. It also generates the header which defines
+TFM_LOG_TOKEN_HASH().
+"""
+
+import os
+import re
+import sys
+import argparse
+
+# Parameters of the hash, which must match tfm_spm_log_token.h
+TOKEN_HASH_COEFF = 65599
+TOKEN_HASH_LEN = 80
+
+# Log record markers, which must match spm_log.c
+RECORD_MSG = 0x1E
+RECORD_MSGVAL = 0x1F
+
+# Log macros taking a message, with the suffix they append to it
+LOG_MACROS = {
+    'SPMLOG_DBGMSG': b'',
+    'SPMLOG_DBGMSGVAL': b'',
+    'SPMLOG_INFMSG': b'',
+    'SPMLOG_INFMSGVAL': b'',
+    'SPMLOG_ERRMSG': b'',
+    'SPMLOG_ERRMSGVAL': b'',
+    'ERROR_MSG': b'\r\n',
+}
+
+SOURCE_EXTENSIONS = ('.c', '.h')
+
+C_STRING = r'"(?:[^"\\\n]|\\.)*"'
+LOG_CALL = re.compile(r'\b(' + '|'.join(LOG_MACROS) + r')\s*\(\s*((?:' +
+                      C_STRING + r'\s*)+)[,)]')
+C_ESCAPES = {'n': 10, 'r': 13, 't': 9, 'a': 7, 'b': 8, 'f': 12, 'v': 11,
+             '\\': 92, '\'': 39, '"': 34, '?': 63}
+
+def token_hash(msg):
+    """
+    Hashes a message as TFM_LOG_TOKEN_HASH() does, msg being the bytes of the
+    message without the terminating NUL.
+    """
+    value = len(msg)
+    coeff = 1
+    for char in msg[:TOKEN_HASH_LEN]:
+        coeff = (coeff * TOKEN_HASH_COEFF) % (1 << 32)
+        value = (value + char * coeff) % (1 << 32)
+    return value
+
+def unescape(literal):
+    """
+    Converts the body of a C string literal to bytes
+    """
+    out = bytearray()
+    i = 0
+    while i < len(literal):
+        char = literal[i]
+        i += 1
+        if char != '\\':
+            out += char.encode()
+            continue
+        char = literal[i]
+        i += 1
+        if char in C_ESCAPES:
+            out.append(C_ESCAPES[char])
+        elif char == 'x':
+            digits = re.match(r'[0-9a-fA-F]+', literal[i:]).group(0)
+            out.append(int(digits, 16) & 0xFF)
+            i += len(digits)
+        elif char in '01234567':
+            digits = re.match(r'[0-7]{1,3}', literal[i - 1:]).group(0)
+            out.append(int(digits, 8) & 0xFF)
+            i += len(digits) - 1
+        else:
+            out += char.encode()
+    return bytes(out)
+
+def collect_messages(source_dirs):
+    """
+    Finds the constant messages of the log macros in the source trees, and
+    returns a dictionary from token to message.
+    """
+    tokens = {}
+    for source_dir in source_dirs:
+        for root, _, files in os.walk(source_dir):
+            for name in files:
+                if not name.endswith(SOURCE_EXTENSIONS):
+                    continue
+                path = os.path.join(root, name)
+                with open(path, encoding='utf-8', errors='replace') as f:
+                    text = f.read()
+                for match in LOG_CALL.finditer(text):
+                    msg = b''.join(unescape(s[1:-1]) for s in
+                                   re.findall(C_STRING, match.group(2)))
+                    msg += LOG_MACROS[match.group(1)]
+                    token = token_hash(msg)
+                    if token in tokens and tokens[token] != msg:
+                        print('Token collision 0x{:08x}: {} / {}'.format(
+                              token, tokens[token], msg), file=sys.stderr)
+                    tokens[token] = msg
+    return tokens
+
+def decode(tokens, data, out):
+    """
+    Decodes a captured log, passing through the bytes which are not part of a
+    token record
+    """
+    i = 0
+    while i < len(data):
+        marker = data[i]
+        size = {RECORD_MSG: 5, RECORD_MSGVAL: 9}.get(marker)
+        if size is None or i + size > len(data):
+            if marker != 0:
+                out.write(bytes([marker]))
+            i += 1
+            continue
+        token = int.from_bytes(data[i + 1:i + 5], 'little')
+        msg = tokens.get(token, '<unknown token 0x{:08x}>'.format(token)
+                         .encode())
+        out.write(msg)
+        if marker == RECORD_MSGVAL:
+            value = int.from_bytes(data[i + 5:i + 9], 'little')
+            out.write('0x{:08X}\r\n'.format(value).encode())
+        i += size
+
+def generate_header(path):
+    """
+    Generates the header defining TFM_LOG_TOKEN_HASH()
+    """
+    terms = []
+    coeff = 1
+    for i in range(TOKEN_HASH_LEN):
+        coeff = (coeff * TOKEN_HASH_COEFF) % (1 << 32)
+        terms.append('    TFM_LOG_TOKEN_CHAR(str, {}, 0x{:08X}U)'
+                     .format(i, coeff))
+
+    with open(path, 'w') as f:
+        f.write(HEADER_TEMPLATE.format(len=TOKEN_HASH_LEN,
+                                       coeff=TOKEN_HASH_COEFF,
+                                       terms=' + \\\n'.join(terms)))
+
+HEADER_TEMPLATE = '''/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* This file is generated by tools/tfm_log_token.py --header, do not edit. */
+
+#ifndef __TFM_SPM_LOG_TOKEN_H__
+#define __TFM_SPM_LOG_TOKEN_H__
+
+#include <stdint.h>
+
+/*
+ * Hash of a string literal used as the token of a log message. It is the
+ * length of the string plus the sum of its first {len} characters multiplied
+ * by the powers of {coeff}, modulo 2^32, and is folded into a constant by the
+ * compiler so that the string itself is not kept in the image.
+ */
+#define TFM_LOG_TOKEN_CHAR(str, i, coeff) \\
+    (((i) < sizeof(str) - 1) ? (uint32_t)(uint8_t)(str)[i] * (coeff) : 0U)
+
+#define TFM_LOG_TOKEN_HASH(str) ((uint32_t)(sizeof(str) - 1) + \\
+{terms})
+
+#endif /* __TFM_SPM_LOG_TOKEN_H__ */
+'''
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='Decode the tokenized SPM log')
+
+    parser.add_argument('-s', '--source-dirs'
+                        , nargs='+'
+                        , dest='source_dirs'
+                        , default=[]
+                        , metavar='source-dirs'
+                        , help='The source trees to collect the messages from')
+
+    parser.add_argument('-i', '--input'
+                        , dest='input'
+                        , metavar='input'
+                        , help='The captured log to decode, stdin if omitted')
+
+    parser.add_argument('--header'
+                        , dest='header'
+                        , metavar='header'
+                        , help='Generate the header defining TFM_LOG_TOKEN_HASH()')
+
+    return parser.parse_args()
+
+def main():
+    args = parse_args()
+
+    if args.header:
+        generate_header(args.header)
+        return
+
+    tokens = collect_messages(args.source_dirs)
+
+    if args.input:
+        with open(args.input, 'rb') as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    decode(tokens, data, sys.stdout.buffer)
+
+if __name__ == '__main__':
+    main()
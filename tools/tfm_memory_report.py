@@ -0,0 +1,196 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Reports the memory layout of the secure image (TFM_MEMORY_REPORT).
+
+The sections of the ELF image are listed by address with the padding before
+them, which at isolation level 3 is mostly due to the MPU alignment of the
+partition regions, and the padding at their end, after their last symbol.
+The largest objects of each section, such as the partition stacks and pools,
+are listed with them. For each run of contiguous sections, the order by
+decreasing alignment is suggested when it needs less padding. The order is
+only suggested, the linker scripts place the partitions in the order of the
+manifest list.
+"""
+
+import sys
+import struct
+import argparse
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+STT_OBJECT = 1
+
+# A gap larger than this between two sections starts another run of sections
+RUN_GAP_MAX = 0x10000
+
+class Section:
+    def __init__(self, index, name, addr, size, align, flags, nobits):
+        self.index = index
+        self.name = name
+        self.addr = addr
+        self.size = size
+        self.align = max(align, 1)
+        self.flags = flags
+        self.nobits = nobits
+        self.symbols = []
+
+    def used_end(self):
+        """
+        End of the last symbol of the section, the rest being padding
+        """
+        end = self.addr
+        for _, addr, size in self.symbols:
+            end = max(end, addr + size)
+        return min(end, self.addr + self.size) if self.symbols else \
+               self.addr + self.size
+
+def cstring(data, off):
+    return data[off:data.index(b'\0', off)].decode('ascii', 'replace')
+
+def read_elf(data):
+    """
+    Reads the allocated sections of a little endian ELF32 image and the
+    objects in them.
+    """
+    if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+        raise ValueError('Not a little endian ELF32 image')
+
+    (shoff,) = struct.unpack_from('<I', data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 0x2E)
+
+    headers = [struct.unpack_from('<IIIIIIIIII', data, shoff + i * shentsize)
+               for i in range(shnum)]
+    shstr_off = headers[shstrndx][4]
+
+    sections = {}
+    for i, (name, sh_type, flags, addr, off, size, link, _, align, _) \
+            in enumerate(headers):
+        if flags & SHF_ALLOC and size:
+            sections[i] = Section(i, cstring(data, shstr_off + name), addr,
+                                  size, align, flags, sh_type == SHT_NOBITS)
+
+    for name, sh_type, _, _, off, size, link, _, _, entsize in headers:
+        if sh_type != SHT_SYMTAB or not entsize:
+            continue
+        str_off = headers[link][4]
+        for i in range(size // entsize):
+            st_name, value, st_size, info, _, shndx = struct.unpack_from(
+                '<IIIBBH', data, off + i * entsize)
+            if (info & 0xF) == STT_OBJECT and st_size and shndx in sections:
+                sections[shndx].symbols.append(
+                    (cstring(data, str_off + st_name), value, st_size))
+
+    return sorted(sections.values(), key=lambda s: s.addr)
+
+def split_runs(sections):
+    """
+    Splits the sections into runs of contiguous sections of the same kind,
+    code or data, which the linker places in the same memory.
+    """
+    runs = []
+    for sec in sections:
+        if runs:
+            last = runs[-1][-1]
+            if ((sec.flags & SHF_WRITE) == (last.flags & SHF_WRITE) and
+                    0 <= sec.addr - (last.addr + last.size) <= RUN_GAP_MAX):
+                runs[-1].append(sec)
+                continue
+        runs.append([sec])
+    return runs
+
+def align_up(addr, align):
+    return (addr + align - 1) // align * align
+
+def place(run, order):
+    """
+    Returns the padding between the sections of the run placed in order.
+    """
+    addr = run[0].addr
+    padding = 0
+    for sec in order:
+        start = align_up(addr, sec.align)
+        padding += start - addr
+        addr = start + sec.size
+    return padding
+
+def report(sections, top, out):
+    total_pad = 0
+    total_tail = 0
+
+    out.write('{:<40} {:>10} {:>8} {:>8} {:>8} {:>8}\n'.format(
+              'Section', 'Address', 'Size', 'Align', 'Pad', 'Tail'))
+
+    runs = split_runs(sections)
+    for run in runs:
+        prev_end = None
+        for sec in run:
+            pad = 0 if prev_end is None else sec.addr - prev_end
+            tail = sec.addr + sec.size - sec.used_end()
+            total_pad += pad
+            total_tail += tail
+            prev_end = sec.addr + sec.size
+
+            out.write('{:<40} 0x{:08x} {:>8} {:>8} {:>8} {:>8}\n'.format(
+                      sec.name[:40], sec.addr, sec.size, sec.align, pad, tail))
+            for name, _, size in sorted(sec.symbols, key=lambda s: -s[2])[:top]:
+                out.write('    {:<36} {:>21}\n'.format(name[:36], size))
+
+        current = place(run, run)
+        # Zero initialised sections stay after the initialised ones
+        order = sorted(run, key=lambda s: (s.nobits, -s.align))
+        best = place(run, order)
+        if best < current:
+            out.write('\nOrdering the sections by decreasing alignment saves '
+                      '{} bytes of padding:\n'.format(current - best))
+            for sec in order:
+                out.write('    {}\n'.format(sec.name))
+        out.write('\n')
+
+    out.write('Padding between sections: {} bytes\n'.format(total_pad))
+    out.write('Padding after the last symbol of sections: {} bytes\n'.format(
+              total_tail))
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='Report the memory layout of an ELF image')
+
+    parser.add_argument('-i', '--input'
+                        , dest='input'
+                        , required=True
+                        , metavar='input'
+                        , help='The ELF image, for example tfm_s.axf')
+
+    parser.add_argument('-o', '--output'
+                        , dest='output'
+                        , metavar='output'
+                        , help='The report file, printed if not given')
+
+    parser.add_argument('-n', '--top'
+                        , dest='top'
+                        , type=int
+                        , default=4
+                        , help='Number of the largest objects listed per section')
+
+    return parser.parse_args()
+
+def main():
+    args = parse_args()
+
+    with open(args.input, 'rb') as f:
+        sections = read_elf(f.read())
+
+    if args.output:
+        with open(args.output, 'w') as out:
+            report(sections, args.top, out)
+    else:
+        report(sections, args.top, sys.stdout)
+
+if __name__ == '__main__':
+    main()
@@ -149,6 +149,19 @@ def manifest_validation(manifest, pid):
     else:
         raise Exception('Invalid "model" of {}'.format(manifest['name']))
 
+    # Optional TF-M specific attribute to defer the initialization of a
+    # Partition to the first request to one of its services
+    deferred_init = manifest.get('deferred_init', False)
+    if not isinstance(deferred_init, bool):
+        raise Exception('Invalid "deferred_init" of {}'.format(manifest['name']))
+    if deferred_init and model == 'IPC':
+        # IPC Partitions own their entry point, which can't be deferred
+        logging.warning('"deferred_init" of {} is ignored for IPC model'.format(manifest['name']))
+        deferred_init = False
+    if deferred_init and len(irq_list) > 0:
+        raise Exception('{} cannot use "deferred_init" as it has IRQs'.format(manifest['name']))
+    manifest['deferred_init'] = deferred_init
+
     # Service FF-M manifest validation
     for service in service_list:
         if manifest['psa_framework_version'] == 1.0:
@@ -161,6 +174,20 @@ def manifest_validation(manifest, pid):
         if 'version_policy' not in service.keys():
             service['version_policy'] = 'STRICT'
 
+        # Optional TF-M specific attribute for a dedicated connection slab
+        if 'connection_pool_size' in service:
+            pool_size = service['connection_pool_size']
+            if (isinstance(pool_size, int) and pool_size <= 0) or \
+               not isinstance(pool_size, (int, str)):
+                raise Exception('Invalid connection_pool_size of {}'.format(service['name']))
+
+        # Optional TF-M specific attribute for the latency budget in cycles
+        if 'latency_budget' in service:
+            budget = service['latency_budget']
+            if (isinstance(budget, int) and budget <= 0) or \
+               not isinstance(budget, (int, str)):
+                raise Exception('Invalid latency_budget of {}'.format(service['name']))
+
         # SID duplication check
         if service['sid'] in sid_list:
             raise Exception('Service ID: {} has duplications!'.format(service['sid']))
@@ -169,6 +196,34 @@ def manifest_validation(manifest, pid):
 
     return manifest
 
+def filter_conditional_irqs(manifest, configs):
+    """
+    Removes the IRQs of the manifest whose optional "conditional" attribute
+    names a build configuration which is disabled.
+    """
+    if 'irqs' not in manifest:
+        return
+
+    irqs = []
+    for irq in manifest['irqs']:
+        condition = irq.get('conditional', None)
+        if condition is None:
+            irqs.append(irq)
+            continue
+
+        if condition not in configs.keys():
+            logging.error('Configuration "{}" is not defined!'.format(condition))
+            exit(1)
+
+        is_enabled = configs[condition].lower()
+        if is_enabled in ['1', 'on', 'true', 'enabled']:
+            irqs.append(irq)
+        elif is_enabled not in ['0', 'off', 'false', 'disabled', '']:
+            raise Exception('Invalid "conditional" attribute: "{}" for IRQ {} of {}.'
+                            .format(condition, irq['name'], manifest['name']))
+
+    manifest['irqs'] = irqs
+
 def check_circular_dependency(partitions, service_partition_map):
     """
     This function detects if there is any circular partition dependency chain.
@@ -222,6 +277,78 @@ def validate_dependency_chain(partition,
         validate_dependency_chain(dependency, dependency_table, dependency_chain)
     dependency_table[partition]['validated'] = True
 
+def group_shared_stacks(partitions, service_partition_map):
+    """
+    Groups the SFN Partitions which can share one stack under the IPC backend.
+    Partitions in a group never call each other, directly or through other
+    Partitions, so the one handling a message never waits for another member.
+    Each member gets a 'shared_stack' attribute describing the stack of its
+    group, used by the templates when CONFIG_TFM_SPM_SHARED_STACKS is enabled.
+
+    Inputs:
+        - partitions:            list of partitions with their manifests
+        - service_partition_map: map between services and their owner Partitions
+    """
+
+    callees = {}
+    for partition in partitions:
+        manifest = partition['manifest']
+        dependencies = manifest.get('dependencies', []) + \
+                       manifest.get('weak_dependencies', [])
+        callees[manifest['name']] = set([service_partition_map[dependency]
+                                         for dependency in dependencies
+                                         if dependency in service_partition_map])
+
+    # Partitions reachable from each Partition through the call graph
+    reachable = {}
+    for name in callees.keys():
+        visited = set()
+        pending = list(callees[name])
+        while pending:
+            callee = pending.pop()
+            if callee not in visited:
+                visited.add(callee)
+                pending.extend(callees[callee])
+        reachable[name] = visited
+
+    # Partitions restarted on the stack must have nothing to keep between messages
+    candidates = [partition['manifest'] for partition in partitions
+                  if partition['manifest']['model'] == 'SFN'
+                  and not partition['manifest']['ns_agent']
+                  and not partition['manifest'].get('deferred_init', False)
+                  and len(partition['manifest'].get('irqs', [])) == 0]
+
+    groups = []
+    for manifest in candidates:
+        for group in groups:
+            if all(manifest['name'] not in reachable[member['name']] and
+                   member['name'] not in reachable[manifest['name']]
+                   for member in group):
+                group.append(manifest)
+                break
+        else:
+            groups.append([manifest])
+
+    shared_stacks = []
+    for group in [group for group in groups if len(group) > 1]:
+        # Stack sizes are usually macros, so the size is resolved at build time
+        shared_stack = {
+            'name': 'shared_stack_{}'.format(len(shared_stacks)),
+            'members': [{'name': member['name'],
+                         'stack_size': member['stack_size'],
+                         # Runtime metadata kept on top of the stack
+                         'metadata_size': (16 + 4 * len(member.get('services', [])) + 7) & ~7}
+                        for member in group]
+        }
+        shared_stack['metadata_size'] = sum(member['metadata_size']
+                                            for member in shared_stack['members'])
+        for idx, member in enumerate(group):
+            member['shared_stack'] = shared_stack.copy()
+            member['shared_stack']['owner'] = (idx == 0)
+        logging.info('{} shared by {}'.format(shared_stack['name'],
+                     ', '.join([member['name'] for member in group])))
+        shared_stacks.append(shared_stack)
+
 def manifest_attribute_check(manifest, manifest_item):
     """
     Check whether Non-FF-M compliant attributes are explicitly registered in manifest lists.
@@ -264,7 +391,8 @@ def process_partition_manifests(manifest_lists, configs):
         'ipc_partitions': [],
         'mmio_region_num': 0,
         'flih_num': 0,
-        'slih_num': 0
+        'slih_num': 0,
+        'slih_coalesce_num': 0
     }
     config_impl = {
         'CONFIG_TFM_SPM_BACKEND_SFN'              : '0',
@@ -272,7 +400,8 @@ def process_partition_manifests(manifest_lists, configs):
         'CONFIG_TFM_CONNECTION_BASED_SERVICE_API' : '0',
         'CONFIG_TFM_MMIO_REGION_ENABLE'           : '0',
         'CONFIG_TFM_FLIH_API'                     : '0',
-        'CONFIG_TFM_SLIH_API'                     : '0'
+        'CONFIG_TFM_SLIH_API'                     : '0',
+        'CONFIG_TFM_SLIH_COALESCE_NUM'            : '0'
     }
     priority_map = {
         'LOWEST'              : '00',
@@ -357,6 +486,7 @@ def process_partition_manifests(manifest_lists, configs):
             manifest = yaml.safe_load(manifest_file)
             # Check manifest attribute validity
             manifest_attribute_check(manifest, manifest_item)
+            filter_conditional_irqs(manifest, configs)
 
             if manifest.get('model', None) == 'dual':
                 # If a Partition supports both models, it can set the "model" to "backend".
@@ -396,6 +526,7 @@ def process_partition_manifests(manifest_lists, configs):
         # Set initial value to -1 to make (irq + 1) reflect the correct
         # number (0) when there are no irqs.
         irq_idx = -1
+        coalesce_idx = 0
         for irq_idx, irq in enumerate(manifest.get('irqs', [])):
             # Assign signal value, from the most significant bit
             irq['signal_value'] = (1 << (31 - irq_idx))
@@ -403,6 +534,17 @@ def process_partition_manifests(manifest_lists, configs):
                 partition_statistics['flih_num'] += 1
             else:
                 partition_statistics['slih_num'] += 1
+
+            # Assign the event counter of the coalesced SLIH IRQs
+            if 'coalesce' in irq:
+                if irq.get('handling', None) == 'FLIH' or \
+                   not isinstance(irq['coalesce'], int) or irq['coalesce'] < 1:
+                    raise Exception('Invalid coalesce of IRQ {} in {}'
+                                    .format(irq['name'], manifest['name']))
+                irq['coalesce_idx'] = coalesce_idx
+                coalesce_idx += 1
+        partition_statistics['slih_coalesce_num'] = \
+            max(partition_statistics['slih_coalesce_num'], coalesce_idx)
         logging.debug('{} has {} IRQS'.format(manifest['name'], irq_idx +1))
 
         if ((srv_idx + 1) + (irq_idx + 1)) > 28:
@@ -439,6 +581,10 @@ def process_partition_manifests(manifest_lists, configs):
 
     check_circular_dependency(partition_list, service_partition_map)
 
+    # Only SFN Partitions with their own threads can share the stacks
+    if backend == 'IPC':
+        group_shared_stacks(partition_list, service_partition_map)
+
     # Automatically assign PIDs for partitions without 'pid' attribute
     pid = max(pid_list, default = TFM_PID_BASE - 1)
     for idx in no_pid_manifest_idx:
@@ -471,10 +617,18 @@ def process_partition_manifests(manifest_lists, configs):
         config_impl['CONFIG_TFM_FLIH_API'] = 1
     if partition_statistics['slih_num'] > 0:
         config_impl['CONFIG_TFM_SLIH_API'] = 1
+    config_impl['CONFIG_TFM_SLIH_COALESCE_NUM'] = \
+        partition_statistics['slih_coalesce_num']
 
     context['partitions'] = partition_list
     context['config_impl'] = config_impl
     context['stateless_services'] = process_stateless_services(partition_list)
+    context['sorted_services'] = sort_services_by_sid(partition_list)
+    context['partition_index'] = build_partition_index(partition_list)
+    context['connection_slabs'] = [service for service in context['sorted_services']
+                                   if 'connection_pool_size' in service]
+    context['latency_budgets'] = [service for service in context['sorted_services']
+                                  if 'latency_budget' in service]
 
     return context
 
@@ -662,6 +816,47 @@ def process_stateless_services(partitions):
 
     return reordered_stateless_services
 
+def sort_services_by_sid(partitions):
+    """
+    This function collects the services of all the partitions and sorts them
+    by SID in ascending order, so that SPM can look up a service by a binary
+    search on the SIDs instead of walking through all the services.
+    """
+
+    services = []
+
+    for partition in partitions:
+        services.extend(partition['manifest'].get('services', []))
+
+    return sorted(services, key=lambda service: int(str(service['sid']), 0))
+
+def build_partition_index(partitions):
+    """
+    This function assigns a dense index to each partition and builds the table
+    mapping partition IDs to the index, so that SPM can find a partition by ID
+    without walking through the partition list.
+    The table covers the IDs from the smallest to the largest partition ID.
+    Unused IDs in between are left None.
+    """
+
+    pids = [partition['attr']['pid'] for partition in partitions]
+
+    if len(pids) == 0:
+        return {'pid_base': 0, 'table': [], 'names': []}
+
+    if len(pids) > 0xFF:
+        raise Exception('Partition numbers exceed the index limit (255).')
+
+    pid_base = min(pids)
+    table = [None] * (max(pids) - pid_base + 1)
+    names = []
+
+    for index, partition in enumerate(partitions):
+        table[partition['attr']['pid'] - pid_base] = index
+        names.append(partition['manifest']['name'])
+
+    return {'pid_base': pid_base, 'table': table, 'names': names}
+
 def parse_args():
     parser = argparse.ArgumentParser(description='Parse secure partition manifest list and generate files listed by the file list',
                                      epilog='Note that environment variables in template files will be replaced with their values')